@@ -25,6 +25,7 @@
 #include "bytecode_helpers.h"
 #include "bytecode_interpreter.h"
 #include "floyd_runtime.h"
+#include "value_features.h"
 #include "compiler_basics.h"
 #include "semantic_ast.h"
 #include "types.h"
@@ -1418,12 +1419,89 @@ static expression_gen_t bcgen_construct_value_expression(bcgenerator_t& gen_acc,
 	return { body_acc, target_reg2, target_type };
 }
 
+/*
+	Same sampling policy as the LLVM backend: k_min_run_count, k_max_run_time_ns, k_max_samples_count.
+
+	end_time = get_profile_time + k_max_run_time_ns
+	index = 0
+	samples = []
+
+	COND1:
+	k_branch_smaller_int index, min_count, LOOP
+	now = get_profile_time
+	k_branch_smaller_int now, end_time, LOOP
+	k_branch_always JOIN
+
+	LOOP:
+	a = get_profile_time
+	BENCHMARK-BODY-INSTRUCTIONS
+	b = get_profile_time
+	dur = b - a
+	samples = push_back(samples, dur)
+	index = index + 1
+	k_branch_smaller_int index, max_count, COND1
+
+	JOIN:
+	target = analyse_benchmark_samples(samples)
+*/
 static expression_gen_t bcgen_benchmark_expression(bcgenerator_t& gen_acc, const symbol_pos_t& target_reg, const expression_t& e, const expression_t::benchmark_expr_t& details, const bcgen_body_t& body){
 	QUARK_ASSERT(gen_acc.check_invariant());
 	QUARK_ASSERT(e.check_invariant());
 	QUARK_ASSERT(body.check_invariant());
 
-	return bcgen_expression(gen_acc, target_reg, expression_t::make_literal_int(404), body);
+	auto body_acc = body;
+	const auto& types = gen_acc._ast_imm->_tree._types;
+
+	//	Semantic analyser interns [int] for each benchmark expression.
+	const auto samples_type = make_vector(types, type_t::make_int());
+
+	const auto max_samples_reg = add_local_const(types, body_acc, value_t::make_int(k_max_samples_count), "benchmark max samples");
+	const auto max_run_time_reg = add_local_const(types, body_acc, value_t::make_int(k_max_run_time_ns), "benchmark max run time");
+	const auto min_count_reg = add_local_const(types, body_acc, value_t::make_int(k_min_run_count), "benchmark min run count");
+	const auto const0_reg = add_local_const(types, body_acc, value_t::make_int(0), "integer 0, to reset index with");
+	const auto const1_reg = add_local_const(types, body_acc, value_t::make_int(1), "integer 1, to increment with");
+	const auto empty_samples_reg = add_local_const(types, body_acc, value_t::make_vector_value(types, type_t::make_int(), {}), "benchmark empty samples");
+
+	const auto end_time_reg = add_local_temp(types, body_acc, type_t::make_int(), "temp: benchmark end time");
+	const auto index_reg = add_local_temp(types, body_acc, type_t::make_int(), "temp: benchmark index");
+	const auto now_reg = add_local_temp(types, body_acc, type_t::make_int(), "temp: benchmark now");
+	const auto start_reg = add_local_temp(types, body_acc, type_t::make_int(), "temp: benchmark sample start");
+	const auto dur_reg = add_local_temp(types, body_acc, type_t::make_int(), "temp: benchmark sample duration");
+	const auto samples_reg = add_local_temp(types, body_acc, samples_type, "temp: benchmark samples");
+	const auto target_reg2 = target_reg.is_empty() ? add_local_temp(types, body_acc, type_t::make_int(), "temp: benchmark result") : target_reg;
+
+	//	Registers are reused if the benchmark expression itself is inside a loop: reset them.
+	body_acc._instrs.push_back(bcgen_instruction_t(bc_opcode::k_copy_reg_inplace_value, index_reg, const0_reg, {}));
+	body_acc = copy_value(gen_acc, samples_type, samples_reg, empty_samples_reg, body_acc);
+	body_acc._instrs.push_back(bcgen_instruction_t(bc_opcode::k_get_profile_time, end_time_reg, {}, {}));
+	body_acc._instrs.push_back(bcgen_instruction_t(bc_opcode::k_add_int, end_time_reg, end_time_reg, max_run_time_reg));
+
+	const auto& loop_body = bcgen_body_block(gen_acc, *details.body);
+	const auto loop_body_count = get_count(loop_body._instrs);
+
+	const auto cond1_pc = get_count(body_acc._instrs);
+	const auto loop_pc = cond1_pc + 4;
+	const auto join_pc = loop_pc + 1 + loop_body_count + 5;
+
+	body_acc._instrs.push_back(bcgen_instruction_t(bc_opcode::k_branch_smaller_int, index_reg, min_count_reg, make_imm_int(loop_pc - get_count(body_acc._instrs))));
+	body_acc._instrs.push_back(bcgen_instruction_t(bc_opcode::k_get_profile_time, now_reg, {}, {}));
+	body_acc._instrs.push_back(bcgen_instruction_t(bc_opcode::k_branch_smaller_int, now_reg, end_time_reg, make_imm_int(loop_pc - get_count(body_acc._instrs))));
+	body_acc._instrs.push_back(bcgen_instruction_t(bc_opcode::k_branch_always, make_imm_int(join_pc - get_count(body_acc._instrs)), {}, {}));
+
+	QUARK_ASSERT(get_count(body_acc._instrs) == loop_pc);
+	body_acc._instrs.push_back(bcgen_instruction_t(bc_opcode::k_get_profile_time, start_reg, {}, {}));
+	body_acc = flatten_body(gen_acc, body_acc, loop_body);
+	body_acc._instrs.push_back(bcgen_instruction_t(bc_opcode::k_get_profile_time, now_reg, {}, {}));
+	body_acc._instrs.push_back(bcgen_instruction_t(bc_opcode::k_subtract_int, dur_reg, now_reg, start_reg));
+	body_acc._instrs.push_back(bcgen_instruction_t(bc_opcode::k_pushback_vector_w_inplace_elements, samples_reg, samples_reg, dur_reg));
+	body_acc._instrs.push_back(bcgen_instruction_t(bc_opcode::k_add_int, index_reg, index_reg, const1_reg));
+	body_acc._instrs.push_back(bcgen_instruction_t(bc_opcode::k_branch_smaller_int, index_reg, max_samples_reg, make_imm_int(cond1_pc - get_count(body_acc._instrs))));
+
+	QUARK_ASSERT(get_count(body_acc._instrs) == join_pc);
+	body_acc._instrs.push_back(bcgen_instruction_t(bc_opcode::k_analyse_benchmark_samples, target_reg2, samples_reg, {}));
+
+	QUARK_ASSERT(body_acc.check_invariant());
+	return { body_acc, target_reg2, type_t::make_int() };
 }
 
 
@@ -162,7 +162,7 @@ bc_value_t value_to_bc(const types_t& types, const value_t& value){
 	else if(basetype == base_type::k_vector){
 		const auto element_type = peek.get_vector_element_type(types);
 
-		if(encode_as_vector_w_inplace_elements(types, element_type)){
+		if(encode_as_vector_w_inplace_elements(types, type)){
 			const auto& vec = value.get_vector_value();
 			immer::vector<bc_inplace_value_t> vec2;
 			for(const auto& e: vec){
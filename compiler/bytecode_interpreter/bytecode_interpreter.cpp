@@ -14,6 +14,7 @@
 #include "ast_value.h"
 #include "bytecode_helpers.h"
 #include "types.h"
+#include "value_features.h"
 
 #include <algorithm>
 
@@ -562,6 +563,21 @@ bool encode_as_external(const bc_value_t& value){
 	return value._encode_as_external;
 }
 
+#if DEBUG
+static std::atomic<int> g_bc_live_external_values { 0 };
+
+bc_debug_live_counter_t::bc_debug_live_counter_t(){
+	g_bc_live_external_values++;
+}
+bc_debug_live_counter_t::~bc_debug_live_counter_t(){
+	g_bc_live_external_values--;
+}
+
+int bc_count_live_external_values(){
+	return g_bc_live_external_values;
+}
+#endif
+
 #if DEBUG
 bool bc_external_value_t::check_invariant() const{
 //	QUARK_ASSERT(encode_as_external(_debug_type));
@@ -934,6 +950,7 @@ bc_value_t make_vector(const types_t& types, const type_t& element_type, const i
 
 		bc_value_t temp;
 		temp._type = vector_type;
+		temp._encode_as_external = true;
 		temp._pod._external = new bc_external_value_t{vector_type, elements2};
 		QUARK_ASSERT(temp.check_invariant());
 		return temp;
@@ -946,6 +963,7 @@ bc_value_t make_vector(const types_t& types, const type_t& element_type, const i
 
 		bc_value_t temp;
 		temp._type = vector_type;
+		temp._encode_as_external = true;
 		temp._pod._external = new bc_external_value_t{vector_type, elements2};
 		QUARK_ASSERT(temp.check_invariant());
 		return temp;
@@ -966,6 +984,7 @@ bc_value_t make_vector(const types_t& types, const type_t& element_type, const i
 
 	bc_value_t temp;
 	temp._type = vector_type;
+	temp._encode_as_external = true;
 	temp._pod._external = new bc_external_value_t{vector_type, elements};
 	QUARK_ASSERT(temp.check_invariant());
 	return temp;
@@ -980,6 +999,7 @@ bc_value_t make_vector(const types_t& types, const type_t& element_type, const i
 
 	bc_value_t temp;
 	temp._type = vector_type;
+	temp._encode_as_external = true;
 	temp._pod._external = new bc_external_value_t{vector_type, elements};
 	QUARK_ASSERT(temp.check_invariant());
 	return temp;
@@ -1011,6 +1031,7 @@ bc_value_t make_dict(const types_t& types, const type_t& value_type, const immer
 
 	bc_value_t temp;
 	temp._type = make_dict(types, value_type);
+	temp._encode_as_external = true;
 	temp._pod._external = new bc_external_value_t{ temp._type, entries };
 	QUARK_ASSERT(temp.check_invariant());
 	return temp;
@@ -1021,6 +1042,7 @@ bc_value_t make_dict(const types_t& types, const type_t& value_type, const immer
 
 	bc_value_t temp;
 	temp._type = make_dict(types, value_type);
+	temp._encode_as_external = true;
 	temp._pod._external = new bc_external_value_t{ temp._type, entries };
 	QUARK_ASSERT(temp.check_invariant());
 	return temp;
@@ -1932,6 +1954,9 @@ extern const std::map<bc_opcode, opcode_info_t> k_opcode_info = {
 	{ bc_opcode::k_push_external_value, { "push_external_value", opcode_info_t::encoding::k_p_0r00 } },
 	{ bc_opcode::k_popn, { "popn", opcode_info_t::encoding::k_n_0ii0 } },
 
+	{ bc_opcode::k_get_profile_time, { "get_profile_time", opcode_info_t::encoding::k_p_0r00 } },
+	{ bc_opcode::k_analyse_benchmark_samples, { "analyse_benchmark_samples", opcode_info_t::encoding::k_q_0rr0 } },
+
 	{ bc_opcode::k_branch_false_bool, { "branch_false_bool", opcode_info_t::encoding::k_k_0ri0 } },
 	{ bc_opcode::k_branch_true_bool, { "branch_true_bool", opcode_info_t::encoding::k_k_0ri0 } },
 	{ bc_opcode::k_branch_zero_int, { "branch_zero_int", opcode_info_t::encoding::k_k_0ri0 } },
@@ -2015,11 +2040,50 @@ bool bc_instruction_t::check_invariant() const {
 #endif
 
 
+//////////////////////////////////////////		bc_linked_instruction_t
+
+
+static std::pair<bc_typeid_t, bc_value_t> execute_linked_instructions(interpreter_t* vm_ptr, const bc_linked_instruction_t* instructions, const void* const** handlers_out);
+
+#if DEBUG
+bool bc_linked_instruction_t::check_invariant() const {
+	QUARK_ASSERT(k_opcode_info.find(_opcode) != k_opcode_info.end());
+#if FLOYD_BC_COMPUTED_GOTO
+	QUARK_ASSERT(_handler != nullptr);
+#endif
+	return true;
+}
+#endif
+
+std::vector<bc_linked_instruction_t> link_instructions(const std::vector<bc_instruction_t>& instructions){
+#if FLOYD_BC_COMPUTED_GOTO
+	const void* const* handlers = nullptr;
+	execute_linked_instructions(nullptr, nullptr, &handlers);
+	QUARK_ASSERT(handlers != nullptr);
+#endif
+
+	std::vector<bc_linked_instruction_t> result;
+	result.reserve(instructions.size());
+	for(const auto& e: instructions){
+		QUARK_ASSERT(e.check_invariant());
+
+#if FLOYD_BC_COMPUTED_GOTO
+		const void* handler = handlers[static_cast<int>(e._opcode)];
+#else
+		const void* handler = nullptr;
+#endif
+		result.push_back(bc_linked_instruction_t{ handler, e._opcode, e._a, e._b, e._c });
+	}
+	return result;
+}
+
+
 //////////////////////////////////////////		bc_static_frame_t
 
 
 bc_static_frame_t::bc_static_frame_t(const types_t& types, const std::vector<bc_instruction_t>& instrs2, const std::vector<std::pair<std::string, bc_symbol_t>>& symbols, const std::vector<type_t>& args) :
 	_instructions(instrs2),
+	_linked_instructions(link_instructions(instrs2)),
 	_symbols(symbols),
 	_args(args)
 {
@@ -2238,11 +2302,78 @@ json_t interpreter_stack_t::stack_to_json(const types_t& types) const{
 //////////////////////////////////////////		GLOBAL FUNCTIONS
 
 
-const bc_function_definition_t& get_function_def(const interpreter_t& vm, function_id_t function_id){
-	QUARK_ASSERT(vm.check_invariant());
+static bc_call_target_t make_call_target(
+	const types_t& types,
+	const function_id_t& function_id,
+	const type_t& function_type,
+	const bc_function_definition_t* function_def,
+	const std::map<function_id_t, BC_NATIVE_FUNCTION_PTR>& native_functions
+){
+	const auto function_type_peek = peek2(types, function_type);
+	const auto arg_types = function_type_peek.get_function_args(types);
+	const auto return_type = function_type_peek.get_function_return(types);
+	const auto dyn_arg_count = std::count_if(arg_types.begin(), arg_types.end(), [&](const auto& e){ return peek2(types, e).is_any(); } );
+
+	const auto native_it = native_functions.find(function_id);
+
+	return bc_call_target_t {
+		function_id,
+		function_type,
+		function_def,
+		function_def != nullptr ? function_def->_frame_ptr.get() : nullptr,
+		native_it != native_functions.end() ? native_it->second : nullptr,
+		arg_types,
+		static_cast<int>(dyn_arg_count),
+		peek2(types, return_type).is_void(),
+		encode_as_external(types, return_type)
+	};
+}
+
+//	Resolves all functions of the program, in a fixed order, so all interpreters running the same program
+//	agree on the call target indexes cached inside function values.
+static void make_call_targets(interpreter_imm_t& imm){
+	const auto& program = imm._program;
+	const auto& types = program._types;
+
+	std::vector<bc_call_target_t> targets;
+	std::map<function_id_t, int> indexes;
+	for(const auto& e: program._function_defs){
+		const auto& function_def = e.second;
+		indexes.insert({ e.first, static_cast<int>(targets.size()) });
+		targets.push_back(make_call_target(types, e.first, function_def._function_type, &function_def, imm._native_functions));
+	}
+
+	//	Intrinsics have no function definition.
+	for(const auto& e: program.intrinsic_signatures.vec){
+		const auto function_id = function_id_t { e.name };
+		if(indexes.find(function_id) == indexes.end()){
+			indexes.insert({ function_id, static_cast<int>(targets.size()) });
+			targets.push_back(make_call_target(types, function_id, e._function_type, nullptr, imm._native_functions));
+		}
+	}
+
+	imm._call_targets = targets;
+	imm._call_target_indexes = indexes;
+}
+
+//	Only the first call via a function value looks up the callee by name, then the index is cached in the value.
+static const bc_call_target_t& resolve_call_target(const interpreter_t& vm, const bc_external_value_t& function_value){
+	const auto& imm = *vm._imm;
 
-	const auto& function_def = vm._imm->_program._function_defs.at(function_id);
-	return function_def;
+	int index = function_value._call_target_index.load(std::memory_order_relaxed);
+	if(index < 0){
+		const auto it = imm._call_target_indexes.find(function_value._function_id);
+		if(it == imm._call_target_indexes.end()){
+			quark::throw_runtime_error("Attempting to calling unimplemented function.");
+		}
+		index = it->second;
+		function_value._call_target_index.store(index, std::memory_order_relaxed);
+	}
+
+	QUARK_ASSERT(index >= 0 && index < imm._call_targets.size());
+	const auto& target = imm._call_targets[index];
+	QUARK_ASSERT(target._function_id == function_value._function_id);
+	return target;
 }
 
 
@@ -2256,16 +2387,16 @@ bc_value_t call_function_bc(interpreter_t& vm, const bc_value_t& f, const bc_val
 	QUARK_ASSERT(peek2(types, f._type).is_function());
 #endif
 
-	const auto& function_def = get_function_def(vm, f.get_function_value());
-	if(function_def._frame_ptr == nullptr){
-		const auto function_id = function_def._function_id;
-
-		const auto& native_function_ptr = vm._imm->_native_functions.at(function_id);
+	const auto& target = resolve_call_target(vm, *f._pod._external);
+	if(target._frame_ptr == nullptr){
+		if(target._native_ptr == nullptr){
+			quark::throw_runtime_error("Attempting to calling unimplemented function.");
+		}
 
 		//	arity
 	//	QUARK_ASSERT(args.size() == host_function._function_type.get_function_args().size());
 
-		const auto& result = (native_function_ptr)(vm, &args[0], arg_count);
+		const auto& result = (target._native_ptr)(vm, &args[0], arg_count);
 		return result;
 	}
 	else{
@@ -2299,9 +2430,9 @@ bc_value_t call_function_bc(interpreter_t& vm, const bc_value_t& f, const bc_val
 			}
 		}
 
-		vm._stack.open_frame(*function_def._frame_ptr, arg_count);
-		const auto& result = execute_instructions(vm, function_def._frame_ptr->_instructions);
-		vm._stack.close_frame(*function_def._frame_ptr);
+		vm._stack.open_frame(*target._frame_ptr, arg_count);
+		const auto& result = execute_instructions(vm, target._frame_ptr->_linked_instructions);
+		vm._stack.close_frame(*target._frame_ptr);
 		vm._stack.pop_batch(exts);
 		vm._stack.restore_frame();
 
@@ -2462,7 +2593,8 @@ interpreter_t::interpreter_t(const bc_program_t& program, runtime_handler_i* han
 	host_functions.insert(corelib_calls.begin(), corelib_calls.end());
 
 
-	_imm = std::make_shared<interpreter_imm_t>(interpreter_imm_t{start_time, program, host_functions });
+	_imm = std::make_shared<interpreter_imm_t>(interpreter_imm_t{start_time, program, host_functions, {}, {} });
+	make_call_targets(*_imm);
 
 	interpreter_stack_t temp(program._types, &_imm->_program._globals);
 	temp.swap(_stack);
@@ -2470,7 +2602,7 @@ interpreter_t::interpreter_t(const bc_program_t& program, runtime_handler_i* han
 	_stack.open_frame(_imm->_program._globals, 0);
 
 	//	Run static intialization (basically run global instructions before calling main()).
-	/*const auto& r =*/ execute_instructions(*this, _imm->_program._globals._instructions);
+	/*const auto& r =*/ execute_instructions(*this, _imm->_program._globals._linked_instructions);
 	QUARK_ASSERT(check_invariant());
 }
 interpreter_t::interpreter_t(const bc_program_t& program) : interpreter_t(program, nullptr) {}
@@ -2480,6 +2612,7 @@ void interpreter_t::swap(interpreter_t& other) throw(){
 	std::swap(other._handler, this->_handler);
 	other._stack.swap(this->_stack);
 	other._print_output.swap(this->_print_output);
+	other._benchmark_stats_log.swap(this->_benchmark_stats_log);
 }
 
 #if DEBUG
@@ -2671,42 +2804,33 @@ void execute_new_struct(interpreter_t& vm, int16_t dest_reg, int16_t target_ityp
 /*
 	??? Make stub bc_static_frame_t for each host function to make call conventions same as Floyd functions.
 */
-//	??? Very slow
 //	Notice: host calls and floyd calls have the same type -- we cannot detect host calls until we have a callee value.
-static void call_native(interpreter_t& vm, const bc_instruction_t& i, const type_t& function_type){
+static void call_native(interpreter_t& vm, const bc_linked_instruction_t& i, const bc_call_target_t& target){
 	QUARK_ASSERT(vm.check_invariant());
 	QUARK_ASSERT(i.check_invariant());
-	QUARK_ASSERT(function_type.check_invariant());
+	QUARK_ASSERT(target._frame_ptr == nullptr);
 
-	const auto& types = vm._imm->_program._types;
 	interpreter_stack_t& stack = vm._stack;
-	bc_pod_value_t* regs = stack._current_frame_entry_ptr;
 
 	QUARK_ASSERT(stack.check_reg_function(i._b));
 
-	const function_id_t function_id = regs[i._b]._external->_function_id;
 	const int callee_arg_count = i._c;
 
-	const auto native_it = vm._imm->_native_functions.find(function_id);
-	if(native_it == vm._imm->_native_functions.end()){
+	if(target._native_ptr == nullptr){
 		quark::throw_runtime_error("Attempting to calling unimplemented function.");
 	}
-	const auto& host_function_ptr = native_it->second;
-
-	const auto function_type_peek = peek2(types, function_type);
-
-	const auto temp_args = function_type_peek.get_function_args(types);
-	const auto function_def_dynamic_arg_count = std::count_if(temp_args.begin(), temp_args.end(), [&](const auto& e){ return peek2(types, e).is_any(); } );
 
-	const int arg0_stack_pos = stack.size() - (function_def_dynamic_arg_count + callee_arg_count);
+	const int arg0_stack_pos = stack.size() - (target._dyn_arg_count + callee_arg_count);
 	int stack_pos = arg0_stack_pos;
 
 	//	Notice that dynamic functions will have each DYN argument with a leading itype as an extra argument.
-	const auto function_def_arg_count = temp_args.size();
+	const auto& arg_types = target._arg_types;
+	const auto function_def_arg_count = arg_types.size();
 	std::vector<bc_value_t> arg_values;
+	arg_values.reserve(function_def_arg_count);
 	for(int a = 0 ; a < function_def_arg_count ; a++){
-		const auto func_arg_type = temp_args[a];
-		if(peek2(types, func_arg_type).is_any()){
+		const auto& func_arg_type = arg_types[a];
+		if(peek2(vm._imm->_program._types, func_arg_type).is_any()){
 			const auto arg_itype = stack.load_intq(stack_pos);
 			const auto& arg_type = lookup_full_type(vm, static_cast<int16_t>(arg_itype));
 			const auto arg_value = stack.load_value(stack_pos + 1, arg_type);
@@ -2720,95 +2844,178 @@ static void call_native(interpreter_t& vm, const bc_instruction_t& i, const type
 		}
 	}
 
-	const auto& result = (host_function_ptr)(vm, &arg_values[0], static_cast<int>(arg_values.size()));
-	const auto bc_result = result;
-
-	const auto& function_return_type = function_type_peek.get_function_return(types);
-	const auto function_return_type_peek = peek2(types, function_return_type);
-	if(function_return_type_peek.is_void() == true){
-	}
-	else if(function_return_type_peek.is_any()){
-		stack.write_register(i._a, bc_result);
-	}
-	else{
-		stack.write_register(i._a, bc_result);
+	const auto& result = (target._native_ptr)(vm, &arg_values[0], static_cast<int>(arg_values.size()));
+	if(target._return_is_void == false){
+		stack.write_register(i._a, result);
 	}
 }
 
 //	We need to examine the callee, since we support magic argument lists of varying size.
-static void do_call(interpreter_t& vm, const bc_instruction_t& i){
+static void do_call(interpreter_t& vm, const bc_linked_instruction_t& i){
 	QUARK_ASSERT(vm.check_invariant());
 	QUARK_ASSERT(i.check_invariant());
 
 	interpreter_stack_t& stack = vm._stack;
 	bc_pod_value_t* regs = stack._current_frame_entry_ptr;
 
-
 	QUARK_ASSERT(stack.check_reg_function(i._b));
 
-	const function_id_t function_id = regs[i._b]._external->_function_id;
+	const auto& target = resolve_call_target(vm, *regs[i._b]._external);
 	const int callee_arg_count = i._c;
 
-	const auto function_def_it = vm._imm->_program._function_defs.find(function_id);
-
-	//	Can't find this functions -- it could be an intrinsic.
-	if(function_def_it != vm._imm->_program._function_defs.end() == false){
-		const auto& intrinsics = vm._imm->_program.intrinsic_signatures;
-
-		//	Find function
-		const auto it = std::find_if(intrinsics.vec.begin(), intrinsics.vec.end(), [&](const intrinsic_signature_t& e) { return e.name == function_id.name; } );
-		QUARK_ASSERT(it != intrinsics.vec.end());
-		const auto& function_type = it->_function_type;
-		call_native(vm, i, function_type);
+	//	Intrinsic or a function def without frame_ptr: this is a native function.
+	if(target._frame_ptr == nullptr){
+		call_native(vm, i, target);
 	}
+
+	//	This is a floyd function, with a frame_ptr to execute.
 	else{
-		const auto& function_def = function_def_it->second;
+		QUARK_ASSERT(target._function_def->_args.size() == callee_arg_count);
+		QUARK_ASSERT(target._dyn_arg_count == 0);
 
-		//	There is a function def but it has no frame_ptr: this is a native function.
-		if(function_def._frame_ptr == nullptr){
-			call_native(vm, i, function_def._function_type);
-		}
+		//	We need to remember the global pos where to store return value, since we're switching frame to call function.
+		int result_reg_pos = static_cast<int>(stack._current_frame_entry_ptr - &stack._entries[0]) + i._a;
 
-		//	This is a floyd function, with a frame_ptr to execute.
-		else{
-			QUARK_ASSERT(function_def._args.size() == callee_arg_count);
+		stack.open_frame(*target._frame_ptr, callee_arg_count);
+		const auto& result = execute_instructions(vm, target._frame_ptr->_linked_instructions);
+		stack.close_frame(*target._frame_ptr);
 
-			const auto& types = vm._imm->_program._types;
+		if(target._return_is_void == false){
 
-			const int function_def_dynamic_arg_count = function_def._dyn_arg_count;
-			const auto& function_return_type = peek2(types, function_def._function_type).get_function_return(types);
-
-			QUARK_ASSERT(function_def_dynamic_arg_count == 0);
+			//	Cannot store via register, we have not yet executed k_pop_frame_ptr that restores our frame.
+			if(target._return_is_ext){
+				stack.replace_external_value(result_reg_pos, result.second);
+			}
+			else{
+				stack.replace_inplace_value(result_reg_pos, result.second);
+			}
+		}
+	}
+}
 
-			//	We need to remember the global pos where to store return value, since we're switching frame to call function.
-			int result_reg_pos = static_cast<int>(stack._current_frame_entry_ptr - &stack._entries[0]) + i._a;
 
-			stack.open_frame(*function_def._frame_ptr, callee_arg_count);
-			const auto& result = execute_instructions(vm, function_def._frame_ptr->_instructions);
-			stack.close_frame(*function_def._frame_ptr);
+/*
+	Computed-goto: every handler ends at the one shared dispatch site, next_instruction, which jumps to the
+	next instruction's pre-resolved _handler. That is still a single indirect jump for all opcodes, like the
+	switch, so branch prediction is no better. What it saves is the switch's bounds check and jump table load.
+*/
+#if DEBUG
+	#define BC_CHECK_INSTRUCTION() \
+		QUARK_ASSERT(pc >= 0); \
+		QUARK_ASSERT(vm.check_invariant()); \
+		QUARK_ASSERT(i.check_invariant()); \
+		QUARK_ASSERT(frame_ptr == stack._current_frame_ptr); \
+		QUARK_ASSERT(regs == stack._current_frame_entry_ptr);
+#else
+	#define BC_CHECK_INSTRUCTION()
+#endif
 
-			//	Update our cached pointers.
+#if FLOYD_BC_COMPUTED_GOTO
+	#define BC_OP(opcode) op_##opcode:
+	#define BC_DISPATCH() { i = instructions[pc]; BC_CHECK_INSTRUCTION() goto *i._handler; }
 
-			const auto function_return_type_peek = peek2(types, function_return_type);
+	//	Leaves the handler with a plain goto: a computed goto out of a block doesn't run the destructors
+	//	of the handler's locals, which leaks every bc_value_t a handler makes.
+	#define BC_NEXT() { goto next_instruction; }
+#else
+	#define BC_OP(opcode) case bc_opcode::opcode:
+	#define BC_NEXT() { pc++; continue; }
+#endif
 
-			if(function_return_type_peek.is_void() == false){
+/*
+	Runs linked instructions until k_return or k_stop.
+	Called with handlers_out != nullptr it runs nothing, it returns the table of handler addresses, in
+	bc_opcode order. This is how link_instructions() gets at the labels inside this function.
+*/
+static std::pair<bc_typeid_t, bc_value_t> execute_linked_instructions(interpreter_t* vm_ptr, const bc_linked_instruction_t* instructions, const void* const** handlers_out){
+#if FLOYD_BC_COMPUTED_GOTO
+	static const void* const k_handlers[] = {
+		&&op_k_nop,
+		&&op_k_load_global_external_value,
+		&&op_k_load_global_inplace_value,
+		&&op_k_store_global_external_value,
+		&&op_k_store_global_inplace_value,
+		&&op_k_copy_reg_inplace_value,
+		&&op_k_copy_reg_external_value,
+		&&op_k_get_struct_member,
+		&&op_k_lookup_element_string,
+		&&op_k_lookup_element_json,
+		&&op_k_lookup_element_vector_w_external_elements,
+		&&op_k_lookup_element_vector_w_inplace_elements,
+		&&op_k_lookup_element_dict_w_external_values,
+		&&op_k_lookup_element_dict_w_inplace_values,
+		&&op_k_get_size_vector_w_external_elements,
+		&&op_k_get_size_vector_w_inplace_elements,
+		&&op_k_get_size_dict_w_external_values,
+		&&op_k_get_size_dict_w_inplace_values,
+		&&op_k_get_size_string,
+		&&op_k_get_size_jsonvalue,
+		&&op_k_pushback_vector_w_external_elements,
+		&&op_k_pushback_vector_w_inplace_elements,
+		&&op_k_pushback_string,
+		&&op_k_call,
+		&&op_k_add_bool,
+		&&op_k_add_int,
+		&&op_k_add_double,
+		&&op_k_concat_strings,
+		&&op_k_concat_vectors_w_external_elements,
+		&&op_k_concat_vectors_w_inplace_elements,
+		&&op_k_subtract_double,
+		&&op_k_subtract_int,
+		&&op_k_multiply_double,
+		&&op_k_multiply_int,
+		&&op_k_divide_double,
+		&&op_k_divide_int,
+		&&op_illegal,
+		&&op_k_remainder_int,
+		&&op_k_logical_and_bool,
+		&&op_k_logical_and_int,
+		&&op_k_logical_and_double,
+		&&op_k_logical_or_bool,
+		&&op_k_logical_or_int,
+		&&op_k_logical_or_double,
+		&&op_k_comparison_smaller_or_equal,
+		&&op_k_comparison_smaller_or_equal_int,
+		&&op_k_comparison_smaller,
+		&&op_k_comparison_smaller_int,
+		&&op_k_logical_equal,
+		&&op_k_logical_equal_int,
+		&&op_k_logical_nonequal,
+		&&op_k_logical_nonequal_int,
+		&&op_k_new_1,
+		&&op_k_new_vector_w_external_elements,
+		&&op_k_new_vector_w_inplace_elements,
+		&&op_k_new_dict_w_external_values,
+		&&op_k_new_dict_w_inplace_values,
+		&&op_k_new_struct,
+		&&op_k_return,
+		&&op_k_stop,
+		&&op_k_push_frame_ptr,
+		&&op_k_pop_frame_ptr,
+		&&op_k_push_inplace_value,
+		&&op_k_push_external_value,
+		&&op_k_popn,
+		&&op_k_get_profile_time,
+		&&op_k_analyse_benchmark_samples,
+		&&op_k_branch_false_bool,
+		&&op_k_branch_true_bool,
+		&&op_k_branch_zero_int,
+		&&op_k_branch_notzero_int,
+		&&op_k_branch_smaller_int,
+		&&op_k_branch_smaller_or_equal_int,
+		&&op_k_branch_always,
+	};
+	static_assert(sizeof(k_handlers) / sizeof(k_handlers[0]) == static_cast<int>(bc_opcode::k_branch_always) + 1, "Missing opcode handler");
 
-				//	Cannot store via register, we have not yet executed k_pop_frame_ptr that restores our frame.
-				if(function_def._return_is_ext){
-					stack.replace_external_value(result_reg_pos, result.second);
-				}
-				else{
-					stack.replace_inplace_value(result_reg_pos, result.second);
-				}
-			}
-		}
+	if(handlers_out != nullptr){
+		*handlers_out = k_handlers;
+		return { false, bc_value_t::make_undefined() };
 	}
-}
-
+#endif
 
-std::pair<bc_typeid_t, bc_value_t> execute_instructions(interpreter_t& vm, const std::vector<bc_instruction_t>& instructions){
+	QUARK_ASSERT(vm_ptr != nullptr && instructions != nullptr);
+	interpreter_t& vm = *vm_ptr;
 	QUARK_ASSERT(vm.check_invariant());
-	QUARK_ASSERT(instructions.empty() == true || (instructions.back()._opcode == bc_opcode::k_return || instructions.back()._opcode == bc_opcode::k_stop));
 
 	const auto& types = vm._imm->_program._types;
 	interpreter_stack_t& stack = vm._stack;
@@ -2816,35 +3023,35 @@ std::pair<bc_typeid_t, bc_value_t> execute_instructions(interpreter_t& vm, const
 	bc_pod_value_t* regs = stack._current_frame_entry_ptr;
 	bc_pod_value_t* globals = &stack._entries[k_frame_overhead];
 
-//	const type_t* type_lookup = &types[0];
-//	const auto type_count = types.size();
-
 //	QUARK_TRACE_SS("STACK:  " << json_to_pretty_string(stack.stack_to_json()));
 
 	int pc = 0;
-	while(true){
-		QUARK_ASSERT(pc >= 0);
-		QUARK_ASSERT(pc < instructions.size());
-		const auto i = instructions[pc];
+	bc_linked_instruction_t i;
 
-		QUARK_ASSERT(vm.check_invariant());
-		QUARK_ASSERT(i.check_invariant());
+#if FLOYD_BC_COMPUTED_GOTO
+	BC_DISPATCH();
 
-		QUARK_ASSERT(frame_ptr == stack._current_frame_ptr);
-		QUARK_ASSERT(regs == stack._current_frame_entry_ptr);
+	next_instruction:
+	pc++;
+	BC_DISPATCH();
 
+	{
+#else
+	while(true){
+		i = instructions[pc];
+		BC_CHECK_INSTRUCTION()
 
-		const auto opcode = i._opcode;
-		switch(opcode){
+		switch(i._opcode){
+#endif
 
-		case bc_opcode::k_nop:
-			break;
+		BC_OP(k_nop)
+			BC_NEXT();
 
 
 		//////////////////////////////////////////		ACCESS GLOBALS
 
 
-		case bc_opcode::k_load_global_external_value: {
+		BC_OP(k_load_global_external_value) {
 			QUARK_ASSERT(stack.check_reg__external_value(i._a));
 			QUARK_ASSERT(stack.check_global_access_obj(i._b));
 
@@ -2852,17 +3059,17 @@ std::pair<bc_typeid_t, bc_value_t> execute_instructions(interpreter_t& vm, const
 			const auto& new_value_pod = globals[i._b];
 			regs[i._a] = new_value_pod;
 			new_value_pod._external->_rc++;
-			break;
+			BC_NEXT();
 		}
-		case bc_opcode::k_load_global_inplace_value: {
+		BC_OP(k_load_global_inplace_value) {
 			QUARK_ASSERT(stack.check_reg__inplace_value(i._a));
 
 			regs[i._a] = globals[i._b];
-			break;
+			BC_NEXT();
 		}
 
 
-		case bc_opcode::k_store_global_external_value: {
+		BC_OP(k_store_global_external_value) {
 			QUARK_ASSERT(stack.check_global_access_obj(i._a));
 			QUARK_ASSERT(stack.check_reg__external_value(i._b));
 
@@ -2870,28 +3077,28 @@ std::pair<bc_typeid_t, bc_value_t> execute_instructions(interpreter_t& vm, const
 			const auto& new_value_pod = regs[i._b];
 			globals[i._a] = new_value_pod;
 			new_value_pod._external->_rc++;
-			break;
+			BC_NEXT();
 		}
-		case bc_opcode::k_store_global_inplace_value: {
+		BC_OP(k_store_global_inplace_value) {
 			QUARK_ASSERT(stack.check_global_access_intern(i._a));
 			QUARK_ASSERT(stack.check_reg__inplace_value(i._b));
 
 			globals[i._a] = regs[i._b];
-			break;
+			BC_NEXT();
 		}
 
 
 		//////////////////////////////////////////		ACCESS LOCALS
 
 
-		case bc_opcode::k_copy_reg_inplace_value: {
+		BC_OP(k_copy_reg_inplace_value) {
 			QUARK_ASSERT(stack.check_reg__inplace_value(i._a));
 			QUARK_ASSERT(stack.check_reg__inplace_value(i._b));
 
 			regs[i._a] = regs[i._b];
-			break;
+			BC_NEXT();
 		}
-		case bc_opcode::k_copy_reg_external_value: {
+		BC_OP(k_copy_reg_external_value) {
 			QUARK_ASSERT(stack.check_reg__external_value(i._a));
 			QUARK_ASSERT(stack.check_reg__external_value(i._b));
 
@@ -2899,14 +3106,14 @@ std::pair<bc_typeid_t, bc_value_t> execute_instructions(interpreter_t& vm, const
 			const auto& new_value_pod = regs[i._b];
 			regs[i._a] = new_value_pod;
 			new_value_pod._external->_rc++;
-			break;
+			BC_NEXT();
 		}
 
 
 		//////////////////////////////////////////		STACK
 
 
-		case bc_opcode::k_return: {
+		BC_OP(k_return) {
 			bool is_ext = frame_ptr->_exts[i._a];
 			QUARK_ASSERT(
 				(is_ext && stack.check_reg__external_value(i._a))
@@ -2916,11 +3123,11 @@ std::pair<bc_typeid_t, bc_value_t> execute_instructions(interpreter_t& vm, const
 			return { true, bc_value_t(frame_ptr->_symbols[i._a].second._value_type, regs[i._a], is_ext) };
 		}
 
-		case bc_opcode::k_stop: {
+		BC_OP(k_stop) {
 			return { false, bc_value_t::make_undefined() };
 		}
 
-		case bc_opcode::k_push_frame_ptr: {
+		BC_OP(k_push_frame_ptr) {
 			QUARK_ASSERT(vm.check_invariant());
 			QUARK_ASSERT((stack._stack_size + k_frame_overhead) < stack._allocated_count)
 
@@ -2932,10 +3139,10 @@ std::pair<bc_typeid_t, bc_value_t> execute_instructions(interpreter_t& vm, const
 			stack._debug_types.push_back(type_t::make_void());
 #endif
 			QUARK_ASSERT(vm.check_invariant());
-			break;
+			BC_NEXT();
 		}
 
-		case bc_opcode::k_pop_frame_ptr: {
+		BC_OP(k_pop_frame_ptr) {
 			QUARK_ASSERT(vm.check_invariant());
 			QUARK_ASSERT(stack._stack_size >= k_frame_overhead);
 
@@ -2957,10 +3164,10 @@ std::pair<bc_typeid_t, bc_value_t> execute_instructions(interpreter_t& vm, const
 			QUARK_ASSERT(frame_ptr == stack._current_frame_ptr);
 			QUARK_ASSERT(regs == stack._current_frame_entry_ptr);
 			QUARK_ASSERT(vm.check_invariant());
-			break;
+			BC_NEXT();
 		}
 
-		case bc_opcode::k_push_inplace_value: {
+		BC_OP(k_push_inplace_value) {
 			QUARK_ASSERT(stack.check_reg__inplace_value(i._a));
 #if DEBUG
 			const auto debug_type = stack._debug_types[stack.get_current_frame_start() + i._a];
@@ -2972,9 +3179,9 @@ std::pair<bc_typeid_t, bc_value_t> execute_instructions(interpreter_t& vm, const
 			stack._debug_types.push_back(debug_type);
 #endif
 			QUARK_ASSERT(stack.check_invariant());
-			break;
+			BC_NEXT();
 		}
-		case bc_opcode::k_push_external_value: {
+		BC_OP(k_push_external_value) {
 			QUARK_ASSERT(stack.check_reg__external_value(i._a));
 
 #if DEBUG
@@ -2988,10 +3195,10 @@ std::pair<bc_typeid_t, bc_value_t> execute_instructions(interpreter_t& vm, const
 #if DEBUG
 			stack._debug_types.push_back(debug_type);
 #endif
-			break;
+			BC_NEXT();
 		}
 
-		case bc_opcode::k_popn: {
+		BC_OP(k_popn) {
 			QUARK_ASSERT(vm.check_invariant());
 
 			const uint32_t n = i._a;
@@ -3019,61 +3226,91 @@ std::pair<bc_typeid_t, bc_value_t> execute_instructions(interpreter_t& vm, const
 			stack._stack_size -= n;
 
 			QUARK_ASSERT(vm.check_invariant());
-			break;
+			BC_NEXT();
+		}
+
+
+		//////////////////////////////////////////		BENCHMARK
+
+
+		BC_OP(k_get_profile_time) {
+			QUARK_ASSERT(stack.check_reg_int(i._a));
+
+			regs[i._a]._inplace.int64_value = get_profile_time();
+			BC_NEXT();
+		}
+		BC_OP(k_analyse_benchmark_samples) {
+			QUARK_ASSERT(vm.check_invariant());
+			QUARK_ASSERT(stack.check_reg_int(i._a));
+			QUARK_ASSERT(stack.check_reg_vector_w_inplace_elements(i._b));
+
+			const auto& elements = regs[i._b]._external->_vector_w_inplace_elements;
+			QUARK_ASSERT(elements.size() >= k_min_run_count);
+
+			std::vector<int64_t> samples;
+			samples.reserve(elements.size());
+			for(const auto& e: elements){
+				samples.push_back(e.int64_value);
+			}
+			const auto stats = analyse_samples_stats(&samples[0], static_cast<int64_t>(samples.size()));
+			vm._benchmark_stats_log.push_back(stats);
+			regs[i._a]._inplace.int64_value = stats.min;
+			QUARK_ASSERT(vm.check_invariant());
+			BC_NEXT();
 		}
 
 
 		//////////////////////////////////////////		BRANCHING
 
 
-		case bc_opcode::k_branch_false_bool: {
+		BC_OP(k_branch_false_bool) {
 			QUARK_ASSERT(stack.check_reg_bool(i._a));
 
 			//	Notice that pc will be incremented too, hence the - 1.
 			pc = regs[i._a]._inplace.bool_value ? pc : pc + i._b - 1;
-			break;
+			BC_NEXT();
 		}
-		case bc_opcode::k_branch_true_bool: {
+		BC_OP(k_branch_true_bool) {
 			QUARK_ASSERT(stack.check_reg_bool(i._a));
 
 			//	Notice that pc will be incremented too, hence the - 1.
 			pc = regs[i._a]._inplace.bool_value ? pc + i._b - 1: pc;
-			break;
+			BC_NEXT();
 		}
-		case bc_opcode::k_branch_zero_int: {
+		BC_OP(k_branch_zero_int) {
 			QUARK_ASSERT(stack.check_reg_int(i._a));
 
 			//	Notice that pc will be incremented too, hence the - 1.
 			pc = regs[i._a]._inplace.int64_value == 0 ? pc + i._b - 1 : pc;
-			break;
+			BC_NEXT();
 		}
-		case bc_opcode::k_branch_notzero_int: {
+		BC_OP(k_branch_notzero_int) {
 			QUARK_ASSERT(stack.check_reg_int(i._a));
 
 			//	Notice that pc will be incremented too, hence the - 1.
 			pc = regs[i._a]._inplace.int64_value == 0 ? pc : pc + i._b - 1;
-			break;
+			BC_NEXT();
 		}
-		case bc_opcode::k_branch_smaller_int: {
+		BC_OP(k_branch_smaller_int) {
 			QUARK_ASSERT(stack.check_reg_int(i._a));
 			QUARK_ASSERT(stack.check_reg_int(i._b));
 
 			//	Notice that pc will be incremented too, hence the - 1.
 			pc = regs[i._a]._inplace.int64_value < regs[i._b]._inplace.int64_value ? pc + i._c - 1 : pc;
-			break;
+			BC_NEXT();
 		}
-		case bc_opcode::k_branch_smaller_or_equal_int: {
+		BC_OP(k_branch_smaller_or_equal_int) {
 			QUARK_ASSERT(stack.check_reg_int(i._a));
 			QUARK_ASSERT(stack.check_reg_int(i._b));
 
 			//	Notice that pc will be incremented too, hence the - 1.
 			pc = regs[i._a]._inplace.int64_value <= regs[i._b]._inplace.int64_value ? pc + i._c - 1 : pc;
-			break;
+			BC_NEXT();
 		}
-		case bc_opcode::k_branch_always: {
+		BC_OP(k_branch_always) {
 			//	Notice that pc will be incremented too, hence the - 1.
 			pc = pc + i._a - 1;
-			break;
+			BC_NEXT();
 		}
 
 
@@ -3081,7 +3318,7 @@ std::pair<bc_typeid_t, bc_value_t> execute_instructions(interpreter_t& vm, const
 
 
 		//??? Make obj/intern version.
-		case bc_opcode::k_get_struct_member: {
+		BC_OP(k_get_struct_member) {
 			QUARK_ASSERT(vm.check_invariant());
 			QUARK_ASSERT(stack.check_reg_any(i._a));
 			QUARK_ASSERT(stack.check_reg_struct(i._b));
@@ -3094,10 +3331,10 @@ std::pair<bc_typeid_t, bc_value_t> execute_instructions(interpreter_t& vm, const
 			}
 			regs[i._a] = value_pod;
 			QUARK_ASSERT(vm.check_invariant());
-			break;
+			BC_NEXT();
 		}
 
-		case bc_opcode::k_lookup_element_string: {
+		BC_OP(k_lookup_element_string) {
 			QUARK_ASSERT(vm.check_invariant());
 			QUARK_ASSERT(stack.check_reg_int(i._a));
 			QUARK_ASSERT(stack.check_reg_string(i._b));
@@ -3112,11 +3349,11 @@ std::pair<bc_typeid_t, bc_value_t> execute_instructions(interpreter_t& vm, const
 				regs[i._a]._inplace.int64_value = s[lookup_index];
 			}
 			QUARK_ASSERT(vm.check_invariant());
-			break;
+			BC_NEXT();
 		}
 
 		//	??? Simple JSON-values should not require ext. null, int, bool, empty object, empty array.
-		case bc_opcode::k_lookup_element_json: {
+		BC_OP(k_lookup_element_json) {
 			QUARK_ASSERT(vm.check_invariant());
 			QUARK_ASSERT(stack.check_reg_json(i._a));
 			QUARK_ASSERT(stack.check_reg_json(i._b));
@@ -3164,10 +3401,10 @@ std::pair<bc_typeid_t, bc_value_t> execute_instructions(interpreter_t& vm, const
 				quark::throw_runtime_error("Lookup using [] on json only works on objects and arrays.");
 			}
 			QUARK_ASSERT(vm.check_invariant());
-			break;
+			BC_NEXT();
 		}
 
-		case bc_opcode::k_lookup_element_vector_w_external_elements: {
+		BC_OP(k_lookup_element_vector_w_external_elements) {
 			QUARK_ASSERT(vm.check_invariant());
 			QUARK_ASSERT(stack.check_reg__external_value(i._a));
 			QUARK_ASSERT(stack.check_reg_vector_w_external_elements(i._b));
@@ -3185,9 +3422,9 @@ std::pair<bc_typeid_t, bc_value_t> execute_instructions(interpreter_t& vm, const
 				regs[i._a]._external = handle._external;
 			}
 			QUARK_ASSERT(vm.check_invariant());
-			break;
+			BC_NEXT();
 		}
-		case bc_opcode::k_lookup_element_vector_w_inplace_elements: {
+		BC_OP(k_lookup_element_vector_w_inplace_elements) {
 			QUARK_ASSERT(vm.check_invariant());
 			QUARK_ASSERT(stack.check_reg_int(i._a));
 			QUARK_ASSERT(stack.check_reg_vector_w_inplace_elements(i._b));
@@ -3202,10 +3439,10 @@ std::pair<bc_typeid_t, bc_value_t> execute_instructions(interpreter_t& vm, const
 				regs[i._a]._inplace = vec[lookup_index];
 			}
 			QUARK_ASSERT(vm.check_invariant());
-			break;
+			BC_NEXT();
 		}
 
-		case bc_opcode::k_lookup_element_dict_w_external_values: {
+		BC_OP(k_lookup_element_dict_w_external_values) {
 			QUARK_ASSERT(stack.check_reg__external_value(i._a));
 			QUARK_ASSERT(stack.check_reg_dict_w_external_values(i._b));
 			QUARK_ASSERT(stack.check_reg_string(i._c));
@@ -3222,9 +3459,9 @@ std::pair<bc_typeid_t, bc_value_t> execute_instructions(interpreter_t& vm, const
 				release_pod_external(regs[i._a]);
 				regs[i._a]._external = handle._external;
 			}
-			break;
+			BC_NEXT();
 		}
-		case bc_opcode::k_lookup_element_dict_w_inplace_values: {
+		BC_OP(k_lookup_element_dict_w_inplace_values) {
 			QUARK_ASSERT(stack.check_reg_any(i._a));
 			QUARK_ASSERT(stack.check_reg_dict_w_inplace_values(i._b));
 			QUARK_ASSERT(stack.check_reg_string(i._c));
@@ -3238,11 +3475,11 @@ std::pair<bc_typeid_t, bc_value_t> execute_instructions(interpreter_t& vm, const
 			else{
 				regs[i._a]._inplace = *found_ptr;
 			}
-			break;
+			BC_NEXT();
 		}
 
 
-		case bc_opcode::k_get_size_vector_w_external_elements: {
+		BC_OP(k_get_size_vector_w_external_elements) {
 			QUARK_ASSERT(vm.check_invariant());
 			QUARK_ASSERT(stack.check_reg_int(i._a));
 			QUARK_ASSERT(stack.check_reg_vector_w_external_elements(i._b));
@@ -3250,9 +3487,9 @@ std::pair<bc_typeid_t, bc_value_t> execute_instructions(interpreter_t& vm, const
 
 			regs[i._a]._inplace.int64_value = regs[i._b]._external->_vector_w_external_elements.size();
 			QUARK_ASSERT(vm.check_invariant());
-			break;
+			BC_NEXT();
 		}
-		case bc_opcode::k_get_size_vector_w_inplace_elements: {
+		BC_OP(k_get_size_vector_w_inplace_elements) {
 			QUARK_ASSERT(vm.check_invariant());
 			QUARK_ASSERT(stack.check_reg_int(i._a));
 			QUARK_ASSERT(stack.check_reg_vector_w_inplace_elements(i._b));
@@ -3260,11 +3497,11 @@ std::pair<bc_typeid_t, bc_value_t> execute_instructions(interpreter_t& vm, const
 
 			regs[i._a]._inplace.int64_value = regs[i._b]._external->_vector_w_inplace_elements.size();
 			QUARK_ASSERT(vm.check_invariant());
-			break;
+			BC_NEXT();
 		}
 
 
-		case bc_opcode::k_get_size_dict_w_external_values: {
+		BC_OP(k_get_size_dict_w_external_values) {
 			QUARK_ASSERT(vm.check_invariant());
 			QUARK_ASSERT(stack.check_reg_int(i._a));
 			QUARK_ASSERT(stack.check_reg_dict_w_external_values(i._b));
@@ -3272,9 +3509,9 @@ std::pair<bc_typeid_t, bc_value_t> execute_instructions(interpreter_t& vm, const
 
 			regs[i._a]._inplace.int64_value = regs[i._b]._external->_dict_w_external_values.size();
 			QUARK_ASSERT(vm.check_invariant());
-			break;
+			BC_NEXT();
 		}
-		case bc_opcode::k_get_size_dict_w_inplace_values: {
+		BC_OP(k_get_size_dict_w_inplace_values) {
 			QUARK_ASSERT(vm.check_invariant());
 			QUARK_ASSERT(stack.check_reg_int(i._a));
 			QUARK_ASSERT(stack.check_reg_dict_w_inplace_values(i._b));
@@ -3282,11 +3519,11 @@ std::pair<bc_typeid_t, bc_value_t> execute_instructions(interpreter_t& vm, const
 
 			regs[i._a]._inplace.int64_value = regs[i._b]._external->_dict_w_inplace_values.size();
 			QUARK_ASSERT(vm.check_invariant());
-			break;
+			BC_NEXT();
 		}
 
 
-		case bc_opcode::k_get_size_string: {
+		BC_OP(k_get_size_string) {
 			QUARK_ASSERT(vm.check_invariant());
 			QUARK_ASSERT(stack.check_reg_int(i._a));
 			QUARK_ASSERT(stack.check_reg_string(i._b));
@@ -3294,9 +3531,9 @@ std::pair<bc_typeid_t, bc_value_t> execute_instructions(interpreter_t& vm, const
 
 			regs[i._a]._inplace.int64_value = regs[i._b]._external->_string.size();
 			QUARK_ASSERT(vm.check_invariant());
-			break;
+			BC_NEXT();
 		}
-		case bc_opcode::k_get_size_jsonvalue: {
+		BC_OP(k_get_size_jsonvalue) {
 			QUARK_ASSERT(vm.check_invariant());
 			QUARK_ASSERT(stack.check_reg_int(i._a));
 			QUARK_ASSERT(stack.check_reg_json(i._b));
@@ -3316,16 +3553,24 @@ std::pair<bc_typeid_t, bc_value_t> execute_instructions(interpreter_t& vm, const
 				quark::throw_runtime_error("Calling size() on unsupported type of value.");
 			}
 			QUARK_ASSERT(vm.check_invariant());
-			break;
+			BC_NEXT();
 		}
 
 
-		case bc_opcode::k_pushback_vector_w_external_elements: {
+		BC_OP(k_pushback_vector_w_external_elements) {
 			QUARK_ASSERT(vm.check_invariant());
 			QUARK_ASSERT(stack.check_reg_vector_w_external_elements(i._a));
 			QUARK_ASSERT(stack.check_reg_vector_w_external_elements(i._b));
 			QUARK_ASSERT(stack.check_reg__external_value(i._c));
 
+			//	a = push_back(a, x) and nobody else holds a: append in place.
+			if(i._a == i._b && regs[i._b]._external->_rc == 1){
+				auto& ext = const_cast<bc_external_value_t&>(*regs[i._b]._external);
+				ext._vector_w_external_elements = std::move(ext._vector_w_external_elements).push_back(bc_external_handle_t(regs[i._c]._external));
+				QUARK_ASSERT(vm.check_invariant());
+				BC_NEXT();
+			}
+
 			const auto peek = peek2(types, frame_ptr->_symbols[i._a].second._value_type);
 			const auto& element_type = peek.get_vector_element_type(types);
 
@@ -3334,14 +3579,21 @@ std::pair<bc_typeid_t, bc_value_t> execute_instructions(interpreter_t& vm, const
 			const auto vec2 = make_vector(types, element_type, elements2);
 			vm._stack.write_register__external_value(i._a, vec2);
 			QUARK_ASSERT(vm.check_invariant());
-			break;
+			BC_NEXT();
 		}
-		case bc_opcode::k_pushback_vector_w_inplace_elements: {
+		BC_OP(k_pushback_vector_w_inplace_elements) {
 			QUARK_ASSERT(vm.check_invariant());
 			QUARK_ASSERT(stack.check_reg_vector_w_inplace_elements(i._a));
 			QUARK_ASSERT(stack.check_reg_vector_w_inplace_elements(i._b));
 			QUARK_ASSERT(stack.check_reg(i._c));
 
+			if(i._a == i._b && regs[i._b]._external->_rc == 1){
+				auto& ext = const_cast<bc_external_value_t&>(*regs[i._b]._external);
+				ext._vector_w_inplace_elements = std::move(ext._vector_w_inplace_elements).push_back(regs[i._c]._inplace);
+				QUARK_ASSERT(vm.check_invariant());
+				BC_NEXT();
+			}
+
 			const auto& peek = peek2(types, frame_ptr->_symbols[i._a].second._value_type);
 			const auto& element_type = peek.get_vector_element_type(types);
 
@@ -3351,17 +3603,23 @@ std::pair<bc_typeid_t, bc_value_t> execute_instructions(interpreter_t& vm, const
 			const auto vec = make_vector(types, element_type, elements2);
 			vm._stack.write_register__external_value(i._a, vec);
 			QUARK_ASSERT(vm.check_invariant());
-			break;
+			BC_NEXT();
 		}
 
-		case bc_opcode::k_pushback_string: {
+		BC_OP(k_pushback_string) {
 			QUARK_ASSERT(vm.check_invariant());
 			QUARK_ASSERT(stack.check_reg_string(i._a));
 			QUARK_ASSERT(stack.check_reg_string(i._b));
 			QUARK_ASSERT(stack.check_reg_int(i._c));
 
-			std::string str2 = regs[i._b]._external->_string;
 			const auto ch = regs[i._c]._inplace.int64_value;
+			if(i._a == i._b && regs[i._b]._external->_rc == 1){
+				const_cast<bc_external_value_t&>(*regs[i._b]._external)._string.push_back(static_cast<char>(ch));
+				QUARK_ASSERT(vm.check_invariant());
+				BC_NEXT();
+			}
+
+			std::string str2 = regs[i._b]._external->_string;
 			str2.push_back(static_cast<char>(ch));
 
 			//??? optimize - bypass bc_value_t
@@ -3369,11 +3627,11 @@ std::pair<bc_typeid_t, bc_value_t> execute_instructions(interpreter_t& vm, const
 			const auto str3 = bc_value_t::make_string(str2);
 			vm._stack.write_register__external_value(i._a, str3);
 			QUARK_ASSERT(vm.check_invariant());
-			break;
+			BC_NEXT();
 		}
 
 
-		case bc_opcode::k_call: {
+		BC_OP(k_call) {
 			QUARK_ASSERT(vm.check_invariant());
 			QUARK_ASSERT(stack.check_reg_function(i._b));
 
@@ -3385,10 +3643,10 @@ std::pair<bc_typeid_t, bc_value_t> execute_instructions(interpreter_t& vm, const
 			QUARK_ASSERT(frame_ptr == stack._current_frame_ptr);
 			QUARK_ASSERT(regs == stack._current_frame_entry_ptr);
 			QUARK_ASSERT(vm.check_invariant());
-			break;
+			BC_NEXT();
 		}
 
-		case bc_opcode::k_new_1: {
+		BC_OP(k_new_1) {
 			QUARK_ASSERT(stack.check_reg(i._a));
 
 			const auto dest_reg = i._a;
@@ -3397,10 +3655,10 @@ std::pair<bc_typeid_t, bc_value_t> execute_instructions(interpreter_t& vm, const
 			const auto& target_type = lookup_full_type(vm, target_itype);
 			QUARK_ASSERT(peek2(types, target_type).is_vector() == false && peek2(types, target_type).is_dict() == false && peek2(types, target_type).is_struct() == false);
 			execute_new_1(vm, dest_reg, target_itype, source_itype);
-			break;
+			BC_NEXT();
 		}
 
-		case bc_opcode::k_new_vector_w_external_elements: {
+		BC_OP(k_new_vector_w_external_elements) {
 			QUARK_ASSERT(stack.check_reg_vector_w_external_elements(i._a));
 			QUARK_ASSERT(i._b >= 0);
 			QUARK_ASSERT(i._c >= 0);
@@ -3413,10 +3671,10 @@ std::pair<bc_typeid_t, bc_value_t> execute_instructions(interpreter_t& vm, const
 			QUARK_ASSERT(encode_as_vector_w_inplace_elements(types, vector_type) == false);
 
 			execute_new_vector_obj(vm, dest_reg, target_itype, arg_count);
-			break;
+			BC_NEXT();
 		}
 
-		case bc_opcode::k_new_vector_w_inplace_elements: {
+		BC_OP(k_new_vector_w_inplace_elements) {
 			QUARK_ASSERT(vm.check_invariant());
 			QUARK_ASSERT(stack.check_reg_vector_w_inplace_elements(i._a));
 			QUARK_ASSERT(i._b == 0);
@@ -3440,10 +3698,10 @@ std::pair<bc_typeid_t, bc_value_t> execute_instructions(interpreter_t& vm, const
 			vm._stack.write_register__external_value(dest_reg, result);
 
 			QUARK_ASSERT(vm.check_invariant());
-			break;
+			BC_NEXT();
 		}
 
-		case bc_opcode::k_new_dict_w_external_values: {
+		BC_OP(k_new_dict_w_external_values) {
 			const auto dest_reg = i._a;
 			const auto target_itype = i._b;
 			const auto arg_count = i._c;
@@ -3451,32 +3709,32 @@ std::pair<bc_typeid_t, bc_value_t> execute_instructions(interpreter_t& vm, const
 			const auto peek = peek2(types, target_type);
 			QUARK_ASSERT(peek.is_dict());
 			execute_new_dict_obj(vm, dest_reg, target_itype, arg_count);
-			break;
+			BC_NEXT();
 		}
-		case bc_opcode::k_new_dict_w_inplace_values: {
+		BC_OP(k_new_dict_w_inplace_values) {
 			const auto dest_reg = i._a;
 			const auto target_itype = i._b;
 			const auto arg_count = i._c;
 			const auto& target_type = lookup_full_type(vm, target_itype);
 			QUARK_ASSERT(peek2(types, target_type).is_dict());
 			execute_new_dict_pod64(vm, dest_reg, target_itype, arg_count);
-			break;
+			BC_NEXT();
 		}
-		case bc_opcode::k_new_struct: {
+		BC_OP(k_new_struct) {
 			const auto dest_reg = i._a;
 			const auto target_itype = i._b;
 			const auto arg_count = i._c;
 			const auto& target_type = lookup_full_type(vm, target_itype);
 			QUARK_ASSERT(peek2(types, target_type).is_struct());
 			execute_new_struct(vm, dest_reg, target_itype, arg_count);
-			break;
+			BC_NEXT();
 		}
 
 
 		//////////////////////////////		COMPARISON
 
 
-		case bc_opcode::k_comparison_smaller_or_equal: {
+		BC_OP(k_comparison_smaller_or_equal) {
 			QUARK_ASSERT(stack.check_reg_bool(i._a));
 			QUARK_ASSERT(stack.check_reg_any(i._b));
 			QUARK_ASSERT(stack.check_reg_any(i._c));
@@ -3489,18 +3747,18 @@ std::pair<bc_typeid_t, bc_value_t> execute_instructions(interpreter_t& vm, const
 			long diff = bc_compare_value_true_deep(types, left, right, type);
 
 			regs[i._a]._inplace.bool_value = diff <= 0;
-			break;
+			BC_NEXT();
 		}
-		case bc_opcode::k_comparison_smaller_or_equal_int: {
+		BC_OP(k_comparison_smaller_or_equal_int) {
 			QUARK_ASSERT(stack.check_reg_bool(i._a));
 			QUARK_ASSERT(stack.check_reg_int(i._b));
 			QUARK_ASSERT(stack.check_reg_int(i._c));
 
 			regs[i._a]._inplace.bool_value = regs[i._b]._inplace.int64_value <= regs[i._c]._inplace.int64_value;
-			break;
+			BC_NEXT();
 		}
 
-		case bc_opcode::k_comparison_smaller: {
+		BC_OP(k_comparison_smaller) {
 			QUARK_ASSERT(stack.check_reg_bool(i._a));
 			QUARK_ASSERT(stack.check_reg_any(i._b));
 			QUARK_ASSERT(stack.check_reg_any(i._c));
@@ -3512,17 +3770,17 @@ std::pair<bc_typeid_t, bc_value_t> execute_instructions(interpreter_t& vm, const
 			long diff = bc_compare_value_true_deep(types, left, right, type);
 
 			regs[i._a]._inplace.bool_value = diff < 0;
-			break;
+			BC_NEXT();
 		}
-		case bc_opcode::k_comparison_smaller_int:
+		BC_OP(k_comparison_smaller_int)
 			QUARK_ASSERT(stack.check_reg_bool(i._a));
 			QUARK_ASSERT(stack.check_reg_int(i._b));
 			QUARK_ASSERT(stack.check_reg_int(i._c));
 
 			regs[i._a]._inplace.bool_value = regs[i._b]._inplace.int64_value < regs[i._c]._inplace.int64_value;
-			break;
+			BC_NEXT();
 
-		case bc_opcode::k_logical_equal: {
+		BC_OP(k_logical_equal) {
 			QUARK_ASSERT(stack.check_reg_bool(i._a));
 			QUARK_ASSERT(stack.check_reg_any(i._b));
 			QUARK_ASSERT(stack.check_reg_any(i._c));
@@ -3534,18 +3792,18 @@ std::pair<bc_typeid_t, bc_value_t> execute_instructions(interpreter_t& vm, const
 			long diff = bc_compare_value_true_deep(types, left, right, type);
 
 			regs[i._a]._inplace.bool_value = diff == 0;
-			break;
+			BC_NEXT();
 		}
-		case bc_opcode::k_logical_equal_int: {
+		BC_OP(k_logical_equal_int) {
 			QUARK_ASSERT(stack.check_reg_bool(i._a));
 			QUARK_ASSERT(stack.check_reg_int(i._b));
 			QUARK_ASSERT(stack.check_reg_int(i._c));
 
 			regs[i._a]._inplace.bool_value = regs[i._b]._inplace.int64_value == regs[i._c]._inplace.int64_value;
-			break;
+			BC_NEXT();
 		}
 
-		case bc_opcode::k_logical_nonequal: {
+		BC_OP(k_logical_nonequal) {
 			QUARK_ASSERT(stack.check_reg_bool(i._a));
 			QUARK_ASSERT(stack.check_reg_any(i._b));
 			QUARK_ASSERT(stack.check_reg_any(i._c));
@@ -3557,15 +3815,15 @@ std::pair<bc_typeid_t, bc_value_t> execute_instructions(interpreter_t& vm, const
 			long diff = bc_compare_value_true_deep(types, left, right, type);
 
 			regs[i._a]._inplace.bool_value = diff != 0;
-			break;
+			BC_NEXT();
 		}
-		case bc_opcode::k_logical_nonequal_int: {
+		BC_OP(k_logical_nonequal_int) {
 			QUARK_ASSERT(stack.check_reg_bool(i._a));
 			QUARK_ASSERT(stack.check_reg_int(i._b));
 			QUARK_ASSERT(stack.check_reg_int(i._c));
 
 			regs[i._a]._inplace.bool_value = regs[i._b]._inplace.int64_value != regs[i._c]._inplace.int64_value;
-			break;
+			BC_NEXT();
 		}
 
 
@@ -3573,35 +3831,42 @@ std::pair<bc_typeid_t, bc_value_t> execute_instructions(interpreter_t& vm, const
 
 
 		//??? Replace by a | b opcode.
-		case bc_opcode::k_add_bool: {
+		BC_OP(k_add_bool) {
 			QUARK_ASSERT(stack.check_reg_bool(i._a));
 			QUARK_ASSERT(stack.check_reg_bool(i._b));
 			QUARK_ASSERT(stack.check_reg_bool(i._c));
 
 			regs[i._a]._inplace.bool_value = regs[i._b]._inplace.bool_value + regs[i._c]._inplace.bool_value;
-			break;
+			BC_NEXT();
 		}
-		case bc_opcode::k_add_int: {
+		BC_OP(k_add_int) {
 			QUARK_ASSERT(stack.check_reg_int(i._a));
 			QUARK_ASSERT(stack.check_reg_int(i._b));
 			QUARK_ASSERT(stack.check_reg_int(i._c));
 
 			regs[i._a]._inplace.int64_value = regs[i._b]._inplace.int64_value + regs[i._c]._inplace.int64_value;
-			break;
+			BC_NEXT();
 		}
-		case bc_opcode::k_add_double: {
+		BC_OP(k_add_double) {
 			QUARK_ASSERT(stack.check_reg_double(i._a));
 			QUARK_ASSERT(stack.check_reg_double(i._b));
 			QUARK_ASSERT(stack.check_reg_double(i._c));
 
 			regs[i._a]._inplace.double_value = regs[i._b]._inplace.double_value + regs[i._c]._inplace.double_value;
-			break;
+			BC_NEXT();
 		}
-		case bc_opcode::k_concat_strings: {
+		BC_OP(k_concat_strings) {
 			QUARK_ASSERT(stack.check_reg_string(i._a));
 			QUARK_ASSERT(stack.check_reg_string(i._b));
 			QUARK_ASSERT(stack.check_reg_string(i._c));
 
+			//	a = a + x and nobody else holds a: append in place, std::string grows geometrically.
+			if(i._a == i._b && regs[i._b]._external->_rc == 1){
+				auto& ext = const_cast<bc_external_value_t&>(*regs[i._b]._external);
+				ext._string.append(regs[i._c]._external->_string);
+				BC_NEXT();
+			}
+
 			//	??? No need to create bc_value_t here.
 			const auto s = regs[i._b]._external->_string + regs[i._c]._external->_string;
 			const auto value = bc_value_t::make_string(s);
@@ -3609,10 +3874,10 @@ std::pair<bc_typeid_t, bc_value_t> execute_instructions(interpreter_t& vm, const
 			value._pod._external->_rc++;
 			regs[i._a] = value._pod;
 			release_pod_external(prev_copy);
-			break;
+			BC_NEXT();
 		}
 
-		case bc_opcode::k_concat_vectors_w_external_elements: {
+		BC_OP(k_concat_vectors_w_external_elements) {
 			QUARK_ASSERT(stack.check_reg_vector_w_external_elements(i._a));
 			QUARK_ASSERT(stack.check_reg_vector_w_external_elements(i._b));
 			QUARK_ASSERT(stack.check_reg_vector_w_external_elements(i._c));
@@ -3622,6 +3887,14 @@ std::pair<bc_typeid_t, bc_value_t> execute_instructions(interpreter_t& vm, const
 			const auto& element_type = peek.get_vector_element_type(types);
 			QUARK_ASSERT(encode_as_vector_w_inplace_elements(types, vector_type) == false);
 
+			if(i._a == i._b && i._c != i._b && regs[i._b]._external->_rc == 1){
+				auto& ext = const_cast<bc_external_value_t&>(*regs[i._b]._external);
+				for(const auto& e: regs[i._c]._external->_vector_w_external_elements){
+					ext._vector_w_external_elements = std::move(ext._vector_w_external_elements).push_back(e);
+				}
+				BC_NEXT();
+			}
+
 			//	Copy left into new vector.
 			immer::vector<bc_external_handle_t> elements2 = regs[i._b]._external->_vector_w_external_elements;
 
@@ -3631,9 +3904,9 @@ std::pair<bc_typeid_t, bc_value_t> execute_instructions(interpreter_t& vm, const
 			}
 			const auto& value2 = make_vector(types, element_type, elements2);
 			stack.write_register__external_value(i._a, value2);
-			break;
+			BC_NEXT();
 		}
-		case bc_opcode::k_concat_vectors_w_inplace_elements: {
+		BC_OP(k_concat_vectors_w_inplace_elements) {
 			QUARK_ASSERT(stack.check_reg_vector_w_inplace_elements(i._a));
 			QUARK_ASSERT(stack.check_reg_vector_w_inplace_elements(i._b));
 			QUARK_ASSERT(stack.check_reg_vector_w_inplace_elements(i._c));
@@ -3643,6 +3916,14 @@ std::pair<bc_typeid_t, bc_value_t> execute_instructions(interpreter_t& vm, const
 			const auto& element_type = peek.get_vector_element_type(types);
 			QUARK_ASSERT(encode_as_vector_w_inplace_elements(types, vector_type) == true);
 
+			if(i._a == i._b && i._c != i._b && regs[i._b]._external->_rc == 1){
+				auto& ext = const_cast<bc_external_value_t&>(*regs[i._b]._external);
+				for(const auto& e: regs[i._c]._external->_vector_w_inplace_elements){
+					ext._vector_w_inplace_elements = std::move(ext._vector_w_inplace_elements).push_back(e);
+				}
+				BC_NEXT();
+			}
+
 			//	Copy left into new vector.
 			auto elements2 = regs[i._b]._external->_vector_w_inplace_elements;
 
@@ -3652,42 +3933,42 @@ std::pair<bc_typeid_t, bc_value_t> execute_instructions(interpreter_t& vm, const
 			}
 			const auto& value2 = make_vector(types, element_type, elements2);
 			stack.write_register__external_value(i._a, value2);
-			break;
+			BC_NEXT();
 		}
 
-		case bc_opcode::k_subtract_double: {
+		BC_OP(k_subtract_double) {
 			QUARK_ASSERT(stack.check_reg_double(i._a));
 			QUARK_ASSERT(stack.check_reg_double(i._b));
 			QUARK_ASSERT(stack.check_reg_double(i._c));
 
 			regs[i._a]._inplace.double_value = regs[i._b]._inplace.double_value - regs[i._c]._inplace.double_value;
-			break;
+			BC_NEXT();
 		}
-		case bc_opcode::k_subtract_int: {
+		BC_OP(k_subtract_int) {
 			QUARK_ASSERT(stack.check_reg_int(i._a));
 			QUARK_ASSERT(stack.check_reg_int(i._b));
 			QUARK_ASSERT(stack.check_reg_int(i._c));
 
 			regs[i._a]._inplace.int64_value = regs[i._b]._inplace.int64_value - regs[i._c]._inplace.int64_value;
-			break;
+			BC_NEXT();
 		}
-		case bc_opcode::k_multiply_double: {
+		BC_OP(k_multiply_double) {
 			QUARK_ASSERT(stack.check_reg_double(i._a));
 			QUARK_ASSERT(stack.check_reg_double(i._c));
 			QUARK_ASSERT(stack.check_reg_double(i._c));
 
 			regs[i._a]._inplace.double_value = regs[i._b]._inplace.double_value * regs[i._c]._inplace.double_value;
-			break;
+			BC_NEXT();
 		}
-		case bc_opcode::k_multiply_int: {
+		BC_OP(k_multiply_int) {
 			QUARK_ASSERT(stack.check_reg_int(i._a));
 			QUARK_ASSERT(stack.check_reg_int(i._c));
 			QUARK_ASSERT(stack.check_reg_int(i._c));
 
 			regs[i._a]._inplace.int64_value = regs[i._b]._inplace.int64_value * regs[i._c]._inplace.int64_value;
-			break;
+			BC_NEXT();
 		}
-		case bc_opcode::k_divide_double: {
+		BC_OP(k_divide_double) {
 			QUARK_ASSERT(stack.check_reg_double(i._a));
 			QUARK_ASSERT(stack.check_reg_double(i._b));
 			QUARK_ASSERT(stack.check_reg_double(i._c));
@@ -3697,9 +3978,9 @@ std::pair<bc_typeid_t, bc_value_t> execute_instructions(interpreter_t& vm, const
 				quark::throw_runtime_error("EEE_DIVIDE_BY_ZERO");
 			}
 			regs[i._a]._inplace.double_value = regs[i._b]._inplace.double_value / right;
-			break;
+			BC_NEXT();
 		}
-		case bc_opcode::k_divide_int: {
+		BC_OP(k_divide_int) {
 			QUARK_ASSERT(stack.check_reg_int(i._a));
 			QUARK_ASSERT(stack.check_reg_int(i._b));
 			QUARK_ASSERT(stack.check_reg_int(i._c));
@@ -3709,9 +3990,9 @@ std::pair<bc_typeid_t, bc_value_t> execute_instructions(interpreter_t& vm, const
 				quark::throw_runtime_error("EEE_DIVIDE_BY_ZERO");
 			}
 			regs[i._a]._inplace.int64_value = regs[i._b]._inplace.int64_value / right;
-			break;
+			BC_NEXT();
 		}
-		case bc_opcode::k_remainder_int: {
+		BC_OP(k_remainder_int) {
 			QUARK_ASSERT(stack.check_reg_int(i._a));
 			QUARK_ASSERT(stack.check_reg_int(i._b));
 			QUARK_ASSERT(stack.check_reg_int(i._c));
@@ -3721,73 +4002,99 @@ std::pair<bc_typeid_t, bc_value_t> execute_instructions(interpreter_t& vm, const
 				quark::throw_runtime_error("EEE_DIVIDE_BY_ZERO");
 			}
 			regs[i._a]._inplace.int64_value = regs[i._b]._inplace.int64_value % right;
-			break;
+			BC_NEXT();
 		}
 
 
-		case bc_opcode::k_logical_and_bool: {
+		BC_OP(k_logical_and_bool) {
 			QUARK_ASSERT(stack.check_reg_bool(i._a));
 			QUARK_ASSERT(stack.check_reg_bool(i._b));
 			QUARK_ASSERT(stack.check_reg_bool(i._c));
 
 			regs[i._a]._inplace.bool_value = regs[i._b]._inplace.bool_value  && regs[i._c]._inplace.bool_value;
-			break;
+			BC_NEXT();
 		}
-		case bc_opcode::k_logical_and_int: {
+		BC_OP(k_logical_and_int) {
 			QUARK_ASSERT(stack.check_reg_bool(i._a));
 			QUARK_ASSERT(stack.check_reg_int(i._b));
 			QUARK_ASSERT(stack.check_reg_int(i._c));
 
 			regs[i._a]._inplace.bool_value = (regs[i._b]._inplace.int64_value != 0) && (regs[i._c]._inplace.int64_value != 0);
-			break;
+			BC_NEXT();
 		}
-		case bc_opcode::k_logical_and_double: {
+		BC_OP(k_logical_and_double) {
 			QUARK_ASSERT(stack.check_reg_bool(i._a));
 			QUARK_ASSERT(stack.check_reg_double(i._b));
 			QUARK_ASSERT(stack.check_reg_double(i._c));
 
 			regs[i._a]._inplace.bool_value = (regs[i._b]._inplace.double_value != 0) && (regs[i._c]._inplace.double_value != 0);
-			break;
+			BC_NEXT();
 		}
 
-		case bc_opcode::k_logical_or_bool: {
+		BC_OP(k_logical_or_bool) {
 			QUARK_ASSERT(stack.check_reg_bool(i._a));
 			QUARK_ASSERT(stack.check_reg_bool(i._b));
 			QUARK_ASSERT(stack.check_reg_bool(i._c));
 
 			regs[i._a]._inplace.bool_value = regs[i._b]._inplace.bool_value || regs[i._c]._inplace.bool_value;
-			break;
+			BC_NEXT();
 		}
-		case bc_opcode::k_logical_or_int: {
+		BC_OP(k_logical_or_int) {
 			QUARK_ASSERT(stack.check_reg_bool(i._a));
 			QUARK_ASSERT(stack.check_reg_int(i._b));
 			QUARK_ASSERT(stack.check_reg_int(i._c));
 
 			regs[i._a]._inplace.bool_value = (regs[i._b]._inplace.int64_value != 0) || (regs[i._c]._inplace.int64_value != 0);
-			break;
+			BC_NEXT();
 		}
-		case bc_opcode::k_logical_or_double: {
+		BC_OP(k_logical_or_double) {
 			QUARK_ASSERT(stack.check_reg_bool(i._a));
 			QUARK_ASSERT(stack.check_reg_double(i._b));
 			QUARK_ASSERT(stack.check_reg_double(i._c));
 
 			regs[i._a]._inplace.bool_value = (regs[i._b]._inplace.double_value != 0.0f) || (regs[i._c]._inplace.double_value != 0.0f);
-			break;
+			BC_NEXT();
 		}
 
 
 		//////////////////////////////		NONE
 
 
+#if FLOYD_BC_COMPUTED_GOTO
+		op_illegal:
+			QUARK_ASSERT(false);
+			quark::throw_exception();
+	}
+#else
 		default:
 			QUARK_ASSERT(false);
 			quark::throw_exception();
 		}
-		pc++;
 	}
+#endif
 	return { false, bc_value_t::make_undefined() };
 }
 
+#undef BC_NEXT
+#undef BC_DISPATCH
+#undef BC_OP
+#undef BC_CHECK_INSTRUCTION
+
+std::pair<bc_typeid_t, bc_value_t> execute_instructions(interpreter_t& vm, const std::vector<bc_linked_instruction_t>& instructions){
+	QUARK_ASSERT(vm.check_invariant());
+	QUARK_ASSERT(instructions.empty() == true || (instructions.back()._opcode == bc_opcode::k_return || instructions.back()._opcode == bc_opcode::k_stop));
+
+	if(instructions.empty()){
+		return { false, bc_value_t::make_undefined() };
+	}
+	return execute_linked_instructions(&vm, &instructions[0], nullptr);
+}
+
+//	For instructions that aren't part of a bc_static_frame_t, like new statements in the REPL.
+std::pair<bc_typeid_t, bc_value_t> execute_instructions(interpreter_t& vm, const std::vector<bc_instruction_t>& instructions){
+	return execute_instructions(vm, link_instructions(instructions));
+}
+
 
 //////////////////////////////////////////		FUNCTIONS
 
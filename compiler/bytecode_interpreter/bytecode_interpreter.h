@@ -271,6 +271,16 @@ bool check_external_deep(const types_t& types, const type_t& type, const bc_exte
 	TODO: Right now wastes resouces by containing *all* types of external values! Should use std::variant.
 */
 
+#if DEBUG
+//	Counts the live bc_external_value_t:s. Lets tests check that the interpreter doesn't leak values.
+struct bc_debug_live_counter_t {
+	public: bc_debug_live_counter_t();
+	public: ~bc_debug_live_counter_t();
+};
+
+int bc_count_live_external_values();
+#endif
+
 struct bc_external_value_t {
 	public: bc_external_value_t(const std::string& s);
 	public: bc_external_value_t(const std::shared_ptr<json_t>& s);
@@ -293,6 +303,7 @@ struct bc_external_value_t {
 	public: mutable std::atomic<int> _rc;
 #if DEBUG
 	public: bool _debug__is_unwritten_external_value = false;
+	public: bc_debug_live_counter_t _debug_live_counter;
 #endif
 #if DEBUG
 	public: type_t _debug_type;
@@ -301,6 +312,10 @@ struct bc_external_value_t {
 	public: std::string _string;
 	public: std::shared_ptr<json_t> _json;
 	public: function_id_t _function_id;
+
+	//	Function values: index into interpreter_imm_t::_call_targets, -1 until the value is first called.
+	public: mutable std::atomic<int> _call_target_index { -1 };
+
 	public: type_t _typeid_value = make_undefined();
 	public: std::vector<bc_value_t> _struct_members;
 	public: immer::vector<bc_external_handle_t> _vector_w_external_elements;
@@ -651,6 +666,24 @@ enum class bc_opcode: uint8_t {
 	k_popn,
 
 
+	//////////////////////////////////////		BENCHMARK
+
+
+	/*
+		A: Register: where to put result: integer, nanoseconds
+		B: ---
+		C: ---
+	*/
+	k_get_profile_time,
+
+	/*
+		A: Register: where to put result: integer, the analysed duration in nanoseconds
+		B: Register: samples, [int]
+		C: ---
+	*/
+	k_analyse_benchmark_samples,
+
+
 	//////////////////////////////////////		BRANCH
 
 
@@ -748,6 +781,40 @@ struct bc_instruction_t {
 };
 
 
+//////////////////////////////////////		bc_linked_instruction_t
+
+/*
+	Computed-goto dispatch needs the GCC / Clang labels-as-values extension.
+	Other compilers fall back to a switch over the opcode.
+*/
+#if defined(__GNUC__) || defined(__clang__)
+	#define FLOYD_BC_COMPUTED_GOTO 1
+#else
+	#define FLOYD_BC_COMPUTED_GOTO 0
+#endif
+
+/*
+	An instruction in the form the interpreter executes it. Made from a bc_instruction_t when the
+	bc_static_frame_t is created: _handler is the address of the opcode's code inside execute_instructions(),
+	so dispatching is a single indirect jump, no switch and no bounds check.
+*/
+struct bc_linked_instruction_t {
+#if DEBUG
+	public: bool check_invariant() const;
+#endif
+
+
+	//////////////////////////////////////		STATE
+	const void* _handler;
+	bc_opcode _opcode;
+	int16_t _a;
+	int16_t _b;
+	int16_t _c;
+};
+
+std::vector<bc_linked_instruction_t> link_instructions(const std::vector<bc_instruction_t>& instructions);
+
+
 //////////////////////////////////////		bc_static_frame_t
 
 /*
@@ -769,6 +836,9 @@ struct bc_static_frame_t {
 	//////////////////////////////////////		STATE
 	std::vector<bc_instruction_t> _instructions;
 
+	//	_instructions, linked. This is what the interpreter runs.
+	std::vector<bc_linked_instruction_t> _linked_instructions;
+
 	//??? Optimize how we store this data for quick access + compactness.
 	std::vector<std::pair<std::string, bc_symbol_t>> _symbols;
 	std::vector<type_t> _args;
@@ -1378,6 +1448,32 @@ struct interpreter_stack_t {
 
 
 
+//////////////////////////////////////		bc_call_target_t
+
+/*
+	A function that can be called, resolved when the interpreter is created so a call doesn't need
+	to look up the callee by name. It's a Floyd function (_function_def with a _frame_ptr) or
+	a native function / intrinsic (_native_ptr).
+*/
+
+struct bc_call_target_t {
+	function_id_t _function_id;
+	type_t _function_type;
+
+	//	nullptr for intrinsics, they have no bc_function_definition_t.
+	const bc_function_definition_t* _function_def;
+	const bc_static_frame_t* _frame_ptr;
+	BC_NATIVE_FUNCTION_PTR _native_ptr;
+
+	//	Native calls only: each DYN argument is preceded by its itype on the stack.
+	std::vector<type_t> _arg_types;
+	int _dyn_arg_count;
+
+	bool _return_is_void;
+	bool _return_is_ext;
+};
+
+
 //////////////////////////////////////		interpreter_imm_t
 
 //	Holds static = immutable state the interpreter wants to keep around.
@@ -1386,6 +1482,11 @@ struct interpreter_imm_t {
 	public: const std::chrono::time_point<std::chrono::high_resolution_clock> _start_time;
 	public: const bc_program_t _program;
 	public: const std::map<function_id_t, BC_NATIVE_FUNCTION_PTR> _native_functions;
+
+	//	Every Floyd function, native function and intrinsic of _program. Function values cache their index.
+	//	Filled in once by interpreter_t's constructor, then immutable.
+	public: std::vector<bc_call_target_t> _call_targets;
+	public: std::map<function_id_t, int> _call_target_indexes;
 };
 
 
@@ -1436,6 +1537,9 @@ struct interpreter_t {
 	//	Notice: stack holds refs to RC-counted objects!
 	public: interpreter_stack_t _stack;
 	public: std::vector<std::string> _print_output;
+
+	//	Statistics of each executed benchmark expression, in execution order.
+	public: std::vector<benchmark_stats_t> _benchmark_stats_log;
 };
 
 
@@ -1447,6 +1551,7 @@ int get_global_n_pos(int n);
 bc_value_t call_function_bc(interpreter_t& vm, const bc_value_t& f, const bc_value_t args[], int arg_count);
 json_t interpreter_to_json(const interpreter_t& vm);
 std::pair<bc_typeid_t, bc_value_t> execute_instructions(interpreter_t& vm, const std::vector<bc_instruction_t>& instructions);
+std::pair<bc_typeid_t, bc_value_t> execute_instructions(interpreter_t& vm, const std::vector<bc_linked_instruction_t>& instructions);
 
 std::shared_ptr<value_entry_t> find_global_symbol2(const interpreter_t& vm, const std::string& s);
 
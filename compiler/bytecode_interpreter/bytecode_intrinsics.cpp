@@ -17,6 +17,7 @@
 #include "floyd_interpreter.h"
 #include "floyd_runtime.h"
 #include "bytecode_helpers.h"
+#include "task_scheduler.h"
 
 
 #include <algorithm>
@@ -654,70 +655,30 @@ bc_value_t bc_intrinsic__map_dag(interpreter_t& vm, const bc_value_t args[], int
 		quark::throw_runtime_error("map_dag() requires elements and parents be the same count.");
 	}
 
-	auto elements_todo = elements2.size();
-	std::vector<int> rcs(elements2.size(), 0);
-
-	immer::vector<bc_value_t> complete(elements2.size(), bc_value_t());
-
-	for(const auto& e: parents2){
-		const auto parent_index = e.get_int_value();
-
-		const auto count = static_cast<int64_t>(elements2.size());
-		QUARK_ASSERT(parent_index >= -1);
-		QUARK_ASSERT(parent_index < count);
-
-		if(parent_index != -1){
-			rcs[parent_index]++;
-		}
+	const auto count = static_cast<int64_t>(elements2.size());
+	std::vector<int64_t> parent_indexes(count);
+	for(int64_t i = 0 ; i < count ; i++){
+		parent_indexes[i] = parents2[i].get_int_value();
 	}
-
-	while(elements_todo > 0){
-		std::vector<int> pass_ids;
-		for(int i = 0 ; i < elements2.size() ; i++){
-			const auto rc = rcs[i];
-			if(rc == 0){
-				pass_ids.push_back(i);
-				rcs[i] = -1;
-			}
+	const auto dag = make_dag_schedule(parent_indexes);
+
+	//	The interpreter isn't thread safe: process the nodes on this thread.
+	std::vector<bc_value_t> complete(count, bc_value_t());
+	run_dag_schedule(nullptr, dag, [&](int64_t node){
+		//	Make list of the element's inputs -- they are all complete now.
+		immer::vector<bc_value_t> solved_deps;
+		for(auto c = dag.child_offsets[node] ; c < dag.child_offsets[node + 1] ; c++){
+			QUARK_ASSERT(complete[dag.children[c]]._type.is_undefined() == false);
+			solved_deps = solved_deps.push_back(complete[dag.children[c]]);
 		}
 
-		if(pass_ids.empty()){
-			quark::throw_runtime_error("map_dag() dependency cycle error.");
-		}
+		const bc_value_t f_args[] = { elements2[node], make_vector(types, r_type, solved_deps), context };
+		complete[node] = call_function_bc(vm, f, f_args, 3);
+	});
 
-		for(const auto element_index: pass_ids){
-			const auto& e = elements2[element_index];
-
-			//	Make list of the element's inputs -- the must all be complete now.
-			immer::vector<bc_value_t> solved_deps;
-			for(int element_index2 = 0 ; element_index2 < parents2.size() ; element_index2++){
-				const auto& p = parents2[element_index2];
-				const auto parent_index = p.get_int_value();
-				if(parent_index == element_index){
-					QUARK_ASSERT(element_index2 != -1);
-					QUARK_ASSERT(element_index2 >= -1 && element_index2 < elements2.size());
-					QUARK_ASSERT(rcs[element_index2] == -1);
-					QUARK_ASSERT(complete[element_index2]._type.is_undefined() == false);
-					const auto& solved = complete[element_index2];
-					solved_deps = solved_deps.push_back(solved);
-				}
-			}
-
-			const bc_value_t f_args[] = { e, make_vector(types, r_type, solved_deps), context };
-			const auto result1 = call_function_bc(vm, f, f_args, 3);
-
-			const auto parent_index = parents2[element_index].get_int_value();
-			if(parent_index != -1){
-				rcs[parent_index]--;
-			}
-			complete = complete.set(element_index, result1);
-			elements_todo--;
-		}
-	}
-
-	const auto result = make_vector(types, r_type, complete);
+	const auto result = make_vector(types, r_type, immer::vector<bc_value_t>(complete.begin(), complete.end()));
 
-#if 1
+#if 0
 	const auto debug = value_and_type_to_ast_json(types, bc_to_value(types, result));
 	QUARK_TRACE(json_to_pretty_string(debug));
 #endif
@@ -14,9 +14,15 @@
 #include "os_process.h"
 #include "bytecode_helpers.h"
 #include "semantic_ast.h"
+#include "compiler_helpers.h"
 #include "utils.h"
+#include "process_inbox.h"
+#include "value_features.h"
 
 #include <thread>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
 #include <deque>
 #include <future>
 
@@ -103,6 +109,37 @@ std::pair<std::shared_ptr<interpreter_t>, value_t> run_main(const compilation_un
 	}
 }
 
+#if DEBUG
+//	Every handler leaves through BC_NEXT(). Make sure that doesn't skip the destructors of the handler's locals.
+QUARK_TEST("interpreter_t", "BC_NEXT()", "loop creating strings, vectors and dicts", "no values leak"){
+	const auto cu = make_compilation_unit_nolib(
+		R"(
+
+			func int f(int count){
+				mutable string acc = ""
+				for(i in 0 ..< count){
+					let s = "abc" + to_string(i)
+					let v = [ s, s ]
+					let d = { "a": s }
+					acc = acc + v[1] + d["a"]
+				}
+				return size(acc)
+			}
+
+		)",
+		""
+	);
+	const auto program = compile_to_bytecode(cu);
+	interpreter_t vm(program);
+	const auto f = get_global(vm, "f");
+
+	const auto live_before = bc_count_live_external_values();
+	const auto result = call_function(vm, f, { value_t::make_int(100) });
+	QUARK_VERIFY(result.get_int_value() == 980);
+	QUARK_VERIFY(bc_count_live_external_values() == live_before);
+}
+#endif
+
 void print_vm_printlog(const interpreter_t& vm){
 	QUARK_ASSERT(vm.check_invariant());
 
@@ -135,112 +172,204 @@ struct process_interface {
 };
 
 
-//	NOTICE: Each process inbox has its own mutex + condition variable. No mutex protects cout.
-struct bc_process_t {
-	std::condition_variable _inbox_condition_variable;
-	std::mutex _inbox_mutex;
-	std::deque<json_t> _inbox;
+struct bc_message_t {
+	json_t message;
+	int process_id;
+};
 
+struct bc_process_t {
 	std::string _name_key;
 	std::string _function_key;
-	std::thread::id _thread_id;
+	int _clock_bus_id;
 
 	std::shared_ptr<interpreter_t> _interpreter;
 	std::shared_ptr<value_entry_t> _init_function;
 	std::shared_ptr<value_entry_t> _process_function;
-	value_t _process_state;
+
+	//	Kept in the interpreter's own format between messages, no conversion to value_t.
+	bc_value_t _process_state;
 
 
 	std::shared_ptr<process_interface> _processor;
+
+	//	Number of messages to this process waiting in the clock bus inbox. A synchronous send must not
+	//	overtake them.
+	std::atomic<int64_t> _queued_count;
+
+	//	These are only accessed by the thread running the process's clock bus.
+	//	_running is true while the message handler executes, _stopped when the process has received "stop".
+	bool _running;
+	bool _stopped;
+};
+
+/*
+	Same model as the LLVM runtime's process_scheduling::thread_per_clock_bus: each clock bus has one
+	thread and one inbox. A send to another process on the sender's own clock bus calls the receiver's
+	handler right away, see manual "SYNCHRONOUS PROCESSES".
+
+	NOTICE: Each clock bus inbox is a lock-free queue, see process_inbox.h. No mutex protects cout.
+*/
+struct bc_clock_bus_t {
+	std::string _name_key;
+	std::vector<int> _process_ids;
+	std::thread::id _thread_id;
+
+	process_inbox_t<bc_message_t> _inbox;
 };
 
 struct bc_process_runtime_t {
 	container_t _container;
-	std::map<std::string, std::string> _process_infos;
 	std::thread::id _main_thread_id;
 
 	std::vector<std::shared_ptr<bc_process_t>> _processes;
+	std::vector<std::shared_ptr<bc_clock_bus_t>> _clock_busses;
 	std::vector<std::thread> _worker_threads;
+
+	//	Each process prints to its own interpreter. The lines are moved here, in the order they were printed.
+	std::mutex _print_output_mutex;
+	std::vector<std::string> _print_output;
 };
 
+//	The process whose init function or message handler the current thread is executing, else nullptr.
+static thread_local bc_process_t* tl_current_process = nullptr;
+
 
 /*
 ??? have ONE runtime PER computer or one per interpreter?
 ??? Separate system-interpreter (all processes and many clock busses) vs ONE thread of execution?
 */
 
+static void flush_print_output(bc_process_runtime_t& runtime, bc_process_t& process){
+	auto& lines = process._interpreter->_print_output;
+	if(lines.empty() == false){
+		std::lock_guard<std::mutex> lock(runtime._print_output_mutex);
+		runtime._print_output.insert(runtime._print_output.end(), lines.begin(), lines.end());
+		lines.clear();
+	}
+}
+
+//	Makes process the current process of this thread. With is_handler it is also marked as running.
+struct current_process_scope_t {
+	current_process_scope_t(bc_process_runtime_t& runtime, bc_process_t& process, bool is_handler) :
+		_runtime(runtime),
+		_prev_process(tl_current_process),
+		_process(process)
+	{
+		QUARK_ASSERT(process._running == false);
+
+		tl_current_process = &process;
+		_process._running = is_handler;
+	}
+	~current_process_scope_t(){
+		flush_print_output(_runtime, _process);
+		_process._running = false;
+		tl_current_process = _prev_process;
+	}
+
+	bc_process_runtime_t& _runtime;
+	bc_process_t* _prev_process;
+	bc_process_t& _process;
+};
+
+static void process_message(bc_process_runtime_t& runtime, bc_process_t& process, const json_t& message);
+
 static void send_message(bc_process_runtime_t& runtime, int process_id, const json_t& message){
 	auto& process = *runtime._processes[process_id];
+	auto& clock_bus = *runtime._clock_busses[process._clock_bus_id];
 
-    {
-        std::lock_guard<std::mutex> lk(process._inbox_mutex);
-        process._inbox.push_front(message);
-        if(k_trace_messaging){
-        	QUARK_TRACE("Notifying...");
-		}
-    }
-    process._inbox_condition_variable.notify_one();
-//    process._inbox_condition_variable.notify_all();
-}
+	//	What the sender printed so far comes before anything the receiver prints.
+	const auto sender = tl_current_process;
+	if(sender != nullptr){
+		flush_print_output(runtime, *sender);
+	}
 
-static void process_process(bc_process_runtime_t& runtime, int process_id){
-	auto& process = *runtime._processes[process_id];
-	bool stop = false;
+	//	Synchronous send: we are a handler on the receiver's clock bus. A receiver that is already running
+	//	higher up on the call stack, like a process sending to itself, gets the message via the inbox instead.
+	if(sender != nullptr && sender->_running && sender->_clock_bus_id == process._clock_bus_id && process._running == false && process._queued_count == 0){
+		process_message(runtime, process, message);
+		return;
+	}
 
-	const auto thread_name = get_current_thread_name();
+	//	Wakes the clock bus if it is parked in wait_for_messages().
+	process._queued_count++;
+	push_message(clock_bus._inbox, bc_message_t{ message, process_id });
+	if(k_trace_messaging){
+		QUARK_TRACE("Notifying...");
+	}
+}
+
+static void init_process(bc_process_runtime_t& runtime, bc_process_t& process){
+	const current_process_scope_t scope(runtime, process, false);
 
 	if(process._processor){
 		process._processor->on_init();
 	}
 
 	if(process._init_function != nullptr){
-		const std::vector<value_t> args = {};
-		process._process_state = call_function(*process._interpreter, bc_to_value(process._interpreter->_imm->_program._types, process._init_function->_value), args);
+		process._process_state = call_function_bc(*process._interpreter, process._init_function->_value, nullptr, 0);
 	}
+}
 
-	while(stop == false){
-		json_t message;
-		{
-			std::unique_lock<std::mutex> lk(process._inbox_mutex);
+//	Messages that arrive after "stop" are dropped.
+static void process_message(bc_process_runtime_t& runtime, bc_process_t& process, const json_t& message){
+	if(k_trace_messaging){
+		QUARK_TRACE_SS("RECEIVED: " << json_to_pretty_string(message));
+	}
 
-			if(k_trace_messaging){
-				QUARK_TRACE_SS(thread_name << ": waiting......");
-			}
-			process._inbox_condition_variable.wait(lk, [&]{ return process._inbox.empty() == false; });
-			if(k_trace_messaging){
-				QUARK_TRACE_SS(thread_name << ": continue");
-			}
+	if(process._stopped){
+	}
+	else if(message.is_string() && message.get_string() == "stop"){
+		process._stopped = true;
+		if(k_trace_messaging){
+			QUARK_TRACE_SS(process._name_key << ": STOP");
+		}
+	}
+	else{
+		const current_process_scope_t scope(runtime, process, true);
 
-			//	Pop message.
-			QUARK_ASSERT(process._inbox.empty() == false);
-			message = process._inbox.back();
-			process._inbox.pop_back();
+		if(process._processor){
+			process._processor->on_message(message);
 		}
-		if(k_trace_messaging){
-			QUARK_TRACE_SS("RECEIVED: " << json_to_pretty_string(message));
+
+		if(process._process_function != nullptr){
+			const bc_value_t args[] = { process._process_state, bc_value_t::make_json(message) };
+			process._process_state = call_function_bc(*process._interpreter, process._process_function->_value, args, 2);
 		}
+	}
+}
 
-		if(message.is_string() && message.get_string() == "stop"){
-			stop = true;
-			if(k_trace_messaging){
-        		QUARK_TRACE_SS(thread_name << ": STOP");
-			}
+static bool is_clock_bus_stopped(const bc_process_runtime_t& runtime, const bc_clock_bus_t& clock_bus){
+	return std::all_of(clock_bus._process_ids.begin(), clock_bus._process_ids.end(), [&](int process_id){ return runtime._processes[process_id]->_stopped; });
+}
+
+static void run_clock_bus_thread(bc_process_runtime_t& runtime, int clock_bus_id){
+	auto& clock_bus = *runtime._clock_busses[clock_bus_id];
+
+	const auto thread_name = get_current_thread_name();
+
+	for(const auto process_id: clock_bus._process_ids){
+		init_process(runtime, *runtime._processes[process_id]);
+	}
+
+	while(is_clock_bus_stopped(runtime, clock_bus) == false){
+		if(k_trace_messaging){
+			QUARK_TRACE_SS(thread_name << ": waiting......");
+		}
+		bc_message_t messages[k_inbox_batch_size];
+		const auto count = wait_for_messages(clock_bus._inbox, messages, k_inbox_batch_size);
+		if(k_trace_messaging){
+			QUARK_TRACE_SS(thread_name << ": continue");
 		}
-		else{
-			if(process._processor){
-				process._processor->on_message(message);
-			}
 
-			if(process._process_function != nullptr){
-				const std::vector<value_t> args = { process._process_state, value_t::make_json(message) };
-				const auto& state2 = call_function(*process._interpreter, bc_to_value(process._interpreter->_imm->_program._types, process._process_function->_value), args);
-				process._process_state = state2;
-			}
+		for(size_t i = 0 ; i < count ; i++){
+			auto& process = *runtime._processes[messages[i].process_id];
+			process._queued_count--;
+			process_message(runtime, process, messages[i].message);
 		}
 	}
 }
 
-static std::map<std::string, value_t> run_floyd_processes(const interpreter_t& vm, const std::vector<std::string>& args){
+static std::map<std::string, value_t> run_floyd_processes(interpreter_t& vm, const std::vector<std::string>& args){
 	const auto& container_def = vm._imm->_program._container_def;
 
 	if(container_def._clock_busses.empty()){
@@ -258,12 +387,6 @@ static std::map<std::string, value_t> run_floyd_processes(const interpreter_t& v
 
 		runtime._container = container_def;
 
-		runtime._process_infos = reduce(runtime._container._clock_busses, std::map<std::string, std::string>(), [](const std::map<std::string, std::string>& acc, const std::pair<std::string, clock_bus_t>& e){
-			auto acc2 = acc;
-			acc2.insert(e.second._processes.begin(), e.second._processes.end());
-			return acc2;
-		});
-
 		struct my_interpreter_handler_t : public runtime_handler_i {
 			my_interpreter_handler_t(bc_process_runtime_t& runtime) : _runtime(runtime) {}
 
@@ -280,41 +403,63 @@ static std::map<std::string, value_t> run_floyd_processes(const interpreter_t& v
 		auto my_interpreter_handler = my_interpreter_handler_t{runtime};
 
 
-		for(const auto& t: runtime._process_infos){
-			auto process = std::make_shared<bc_process_t>();
-			process->_name_key = t.first;
-			process->_function_key = t.second;
-			process->_interpreter = std::make_shared<interpreter_t>(vm._imm->_program, &my_interpreter_handler);
-			process->_init_function = find_global_symbol2(*process->_interpreter, t.second + "__init");
-			process->_process_function = find_global_symbol2(*process->_interpreter, t.second);
-
-			runtime._processes.push_back(process);
+		for(const auto& c: runtime._container._clock_busses){
+			auto clock_bus = std::make_shared<bc_clock_bus_t>();
+			clock_bus->_name_key = c.first;
+
+			for(const auto& t: c.second._processes){
+				auto process = std::make_shared<bc_process_t>();
+				process->_name_key = t.first;
+				process->_function_key = t.second;
+				process->_clock_bus_id = static_cast<int>(runtime._clock_busses.size());
+				process->_interpreter = std::make_shared<interpreter_t>(vm._imm->_program, &my_interpreter_handler);
+				process->_init_function = find_global_symbol2(*process->_interpreter, t.second + "__init");
+				process->_process_function = find_global_symbol2(*process->_interpreter, t.second);
+				process->_queued_count = 0;
+				process->_running = false;
+				process->_stopped = false;
+
+				clock_bus->_process_ids.push_back(static_cast<int>(runtime._processes.size()));
+				runtime._processes.push_back(process);
+			}
+			runtime._clock_busses.push_back(clock_bus);
 		}
 
-		//	Remember that current thread (main) is also a thread, no need to create a worker thread for one process.
-		runtime._processes[0]->_thread_id = runtime._main_thread_id;
+		//	Remember that current thread (main) is also a thread, no need to create a worker thread for one clock bus.
+		runtime._clock_busses[0]->_thread_id = runtime._main_thread_id;
 
-		for(int process_id = 1 ; process_id < runtime._processes.size() ; process_id++){
-			runtime._worker_threads.push_back(std::thread([&](int process_id){
+		for(int clock_bus_id = 1 ; clock_bus_id < runtime._clock_busses.size() ; clock_bus_id++){
+			runtime._worker_threads.push_back(std::thread([&](int clock_bus_id){
 
 	//			const auto native_thread = thread::native_handle();
 
 				std::stringstream thread_name;
-				thread_name << std::string() << "process " << process_id << " thread";
+				thread_name << std::string() << "clock bus " << clock_bus_id << " thread";
 	#if QUARK_MAC
 				pthread_setname_np(/*pthread_self(),*/ thread_name.str().c_str());
 	#endif
 
-				process_process(runtime, process_id);
-			}, process_id));
+				run_clock_bus_thread(runtime, clock_bus_id);
+			}, clock_bus_id));
 		}
 
-		process_process(runtime, 0);
+		run_clock_bus_thread(runtime, 0);
 
 		for(auto &t: runtime._worker_threads){
 			t.join();
 		}
 
+		vm._print_output.insert(vm._print_output.end(), runtime._print_output.begin(), runtime._print_output.end());
+
+		if(k_trace_messaging){
+			std::vector<std::pair<std::string, inbox_stats_t>> stats;
+			for(const auto& clock_bus: runtime._clock_busses){
+				stats.push_back({ clock_bus->_name_key, get_inbox_stats(clock_bus->_inbox) });
+			}
+			QUARK_SCOPED_TRACE("CLOCK BUS INBOXES");
+			QUARK_TRACE(format_inbox_stats(stats));
+		}
+
 	#if 0
 		const auto result_vec = mapf<pair<string, value_t>>(
 			runtime._processes,
@@ -374,6 +519,115 @@ run_output_t run_program_bc(interpreter_t& vm, const std::vector<std::string>& m
 }
 
 
+std::vector<benchmark_id_t> collect_benchmarks_bc(const interpreter_t& vm){
+	QUARK_ASSERT(vm.check_invariant());
+
+	const auto reg = get_global(vm, k_global_benchmark_registry);
+
+	std::vector<benchmark_id_t> result;
+	for(const auto& e: reg.get_vector_value()){
+		const auto& s = e.get_struct_value();
+		result.push_back(benchmark_id_t { "", s->_member_values[0].get_string_value() });
+	}
+	return result;
+}
+
+std::vector<benchmark_result2_t> run_benchmarks_bc(interpreter_t& vm, const std::vector<std::string>& tests){
+	QUARK_ASSERT(vm.check_invariant());
+
+	const auto reg = get_global(vm, k_global_benchmark_registry).get_vector_value();
+
+	std::vector<benchmark_result2_t> result;
+	for(const auto& wanted_test: tests){
+		const auto it = std::find_if(reg.begin(), reg.end(), [&] (const value_t& e) { return e.get_struct_value()->_member_values[0].get_string_value() == wanted_test; } );
+		if(it == reg.end()){
+			QUARK_TRACE("Some specified tests were not found");
+		}
+		else{
+			const auto benchmark_id = benchmark_id_t { "", wanted_test };
+			const auto f = it->get_struct_value()->_member_values[1];
+			vm._benchmark_stats_log.clear();
+			const auto bench_result = call_function(vm, f, {});
+
+			auto stats_log = vm._benchmark_stats_log;
+			for(const auto& e: bench_result.get_vector_value()){
+				const auto& struct_result = e.get_struct_value();
+				const auto result3 = benchmark_result_t {
+					struct_result->_member_values[0].get_int_value(),
+					struct_result->_member_values[1].get_json()
+				};
+				const auto stats = take_benchmark_stats(stats_log, result3.dur);
+				result.push_back(benchmark_result2_t { benchmark_id, result3, stats });
+			}
+		}
+	}
+	return result;
+}
+
+QUARK_TEST("", "run_benchmarks_bc()", "Benchmark expression with a cheap body", "Real duration, sampled k_max_samples_count times"){
+	const auto cu = make_compilation_unit_lib(
+		R"(
+
+			benchmark-def "vector" {
+				let dur = benchmark {
+					let a = [ 1, 2, 3 ]
+				}
+				return [ benchmark_result_t(dur, json("3 elements")) ]
+			}
+
+		)",
+		""
+	);
+	const auto program = compile_to_bytecode(cu);
+	interpreter_t vm(program);
+
+	const auto start = get_profile_time();
+	const auto result = run_benchmarks_bc(vm, { "vector" });
+	const auto elapsed = get_profile_time() - start;
+
+	QUARK_VERIFY(result.size() == 1);
+	QUARK_VERIFY(result[0].result.dur > 0);
+	QUARK_VERIFY(result[0].result.dur != 404);
+	QUARK_VERIFY(result[0].stats.min == result[0].result.dur);
+
+	//	The first sample is warm-up. Unless the run hit k_max_run_time_ns, it took k_max_samples_count samples.
+	if(elapsed < k_max_run_time_ns){
+		QUARK_VERIFY(result[0].stats.sample_count == k_max_samples_count - 1);
+	}
+	else{
+		QUARK_VERIFY(result[0].stats.sample_count >= k_min_run_count - 1 && result[0].stats.sample_count < k_max_samples_count);
+	}
+}
+
+QUARK_TEST("", "run_benchmarks_bc()", "Results made from benchmark expressions, summed and by hand", "Only a result that is a benchmark expression gets stats"){
+	const auto cu = make_compilation_unit_lib(
+		R"(
+
+			benchmark-def "direct" {
+				return [ benchmark_result_t(benchmark { let a = [ 1, 2, 3 ] }, json("direct")) ]
+			}
+
+			benchmark-def "combined" {
+				let a = benchmark { let x = [ 1, 2, 3 ] }
+				let b = benchmark { let y = [ 4, 5, 6 ] }
+				return [ benchmark_result_t(404, json("by hand")), benchmark_result_t(a + b, json("sum")) ]
+			}
+
+		)",
+		""
+	);
+	const auto program = compile_to_bytecode(cu);
+	interpreter_t vm(program);
+
+	const auto result = run_benchmarks_bc(vm, { "direct", "combined" });
+	QUARK_VERIFY(result.size() == 3);
+	QUARK_VERIFY(result[0].stats.sample_count > 0);
+	QUARK_VERIFY(result[0].stats.min == result[0].result.dur);
+	QUARK_VERIFY(result[1].stats == benchmark_stats_t {});
+	QUARK_VERIFY(result[2].stats == benchmark_stats_t {});
+}
+
+
 
 
 
@@ -53,6 +53,12 @@ std::pair<std::shared_ptr<interpreter_t>, value_t> bc_run_main(
 
 run_output_t run_program_bc(interpreter_t& vm, const std::vector<std::string>& main_args);
 
+//	Reads the benchmark registry global of a program that has already run its global code.
+std::vector<benchmark_id_t> collect_benchmarks_bc(const interpreter_t& vm);
+
+//	Runs the specified benchmark-defs, in the order they are specified. Unknown names are skipped.
+std::vector<benchmark_result2_t> run_benchmarks_bc(interpreter_t& vm, const std::vector<std::string>& tests);
+
 void print_vm_printlog(const interpreter_t& vm);
 
 
@@ -0,0 +1,702 @@
+//
+//  ast_cache_json.cpp
+//  Floyd
+//
+//  Created by Marcus Zetterquist on 2026-10-18.
+//  Copyright © 2026 Marcus Zetterquist. All rights reserved.
+//
+
+#include "ast_cache_json.h"
+
+#include "json_support.h"
+#include "text_parser.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace floyd {
+
+
+
+static json_t type_to_cache_json(const type_t& t){
+	return json_t(t.get_data());
+}
+static type_t type_from_cache_json(const json_t& j){
+	return type_t(static_cast<int32_t>(j.get_number()));
+}
+
+static json_t location_to_cache_json(const location_t& loc){
+	return loc == k_no_location ? json_t(-1) : json_t(static_cast<int64_t>(loc.offset));
+}
+static location_t location_from_cache_json(const json_t& j){
+	const auto n = j.get_number();
+	return n < 0 ? k_no_location : location_t(static_cast<std::size_t>(n));
+}
+
+static json_t symbol_pos_to_cache_json(const symbol_pos_t& pos){
+	return json_t::make_array({ json_t(pos._parent_steps), json_t(pos._index) });
+}
+static symbol_pos_t symbol_pos_from_cache_json(const json_t& j){
+	return symbol_pos_t::make_stack_pos(
+		static_cast<int>(j.get_array_n(0).get_number()),
+		static_cast<int>(j.get_array_n(1).get_number())
+	);
+}
+
+static json_t members_to_cache_json(const std::vector<member_t>& members){
+	std::vector<json_t> result;
+	for(const auto& m: members){
+		result.push_back(json_t::make_array({ json_t(m._name), type_to_cache_json(m._type) }));
+	}
+	return json_t::make_array(result);
+}
+static std::vector<member_t> members_from_cache_json(const json_t& j){
+	std::vector<member_t> result;
+	for(const auto& m: j.get_array()){
+		result.push_back(member_t(type_from_cache_json(m.get_array_n(1)), m.get_array_n(0).get_string()));
+	}
+	return result;
+}
+
+
+
+//////////////////////////////////////		value_t
+
+
+//	Numbers are strings: JSON numbers are doubles and would lose the low bits of large ints.
+static std::string double_to_cache_string(double value){
+	char temp[64];
+	std::snprintf(temp, sizeof(temp), "%.17g", value);
+	return std::string(temp);
+}
+
+json_t value_to_cache_json(const value_t& v){
+	QUARK_ASSERT(v.check_invariant());
+
+	const auto bt = v.get_basetype();
+	if(bt == base_type::k_undefined){
+		return json_t::make_array({ "undefined" });
+	}
+	else if(bt == base_type::k_any){
+		return json_t::make_array({ "any" });
+	}
+	else if(bt == base_type::k_void){
+		return json_t::make_array({ "void" });
+	}
+	else if(bt == base_type::k_bool){
+		return json_t::make_array({ "bool", json_t(v.get_bool_value()) });
+	}
+	else if(bt == base_type::k_int){
+		return json_t::make_array({ "int", std::to_string(v.get_int_value()) });
+	}
+	else if(bt == base_type::k_double){
+		return json_t::make_array({ "double", double_to_cache_string(v.get_double_value()) });
+	}
+	else if(bt == base_type::k_string){
+		return json_t::make_array({ "string", v.get_string_value() });
+	}
+	else if(bt == base_type::k_json){
+		return json_t::make_array({ "json", v.get_json() });
+	}
+	else if(bt == base_type::k_typeid){
+		return json_t::make_array({ "typeid", type_to_cache_json(v.get_typeid_value()) });
+	}
+	else if(bt == base_type::k_struct){
+		std::vector<json_t> members;
+		for(const auto& e: v.get_struct_value()->_member_values){
+			members.push_back(value_to_cache_json(e));
+		}
+		return json_t::make_array({ "struct", type_to_cache_json(v.get_type()), json_t::make_array(members) });
+	}
+	else if(bt == base_type::k_vector){
+		std::vector<json_t> elements;
+		for(const auto& e: v.get_vector_value()){
+			elements.push_back(value_to_cache_json(e));
+		}
+		return json_t::make_array({ "vector", type_to_cache_json(v.get_type()), json_t::make_array(elements) });
+	}
+	else if(bt == base_type::k_dict){
+		std::map<std::string, json_t> entries;
+		for(const auto& e: v.get_dict_value()){
+			entries.insert({ e.first, value_to_cache_json(e.second) });
+		}
+		return json_t::make_array({ "dict", type_to_cache_json(v.get_type()), json_t::make_object(entries) });
+	}
+	else if(bt == base_type::k_function){
+		return json_t::make_array({ "function", type_to_cache_json(v.get_type()), v.get_function_value().name });
+	}
+	else{
+		QUARK_ASSERT(false);
+		throw std::exception();
+	}
+}
+
+value_t value_from_cache_json(const types_t& types, const json_t& j){
+	QUARK_ASSERT(types.check_invariant());
+
+	const auto& tag = j.get_array_n(0).get_string();
+	if(tag == "undefined"){
+		return value_t::make_undefined();
+	}
+	else if(tag == "any"){
+		return value_t::make_any();
+	}
+	else if(tag == "void"){
+		return value_t::make_void();
+	}
+	else if(tag == "bool"){
+		return value_t::make_bool(j.get_array_n(1).is_true());
+	}
+	else if(tag == "int"){
+		return value_t::make_int(std::stoll(j.get_array_n(1).get_string()));
+	}
+	else if(tag == "double"){
+		return value_t::make_double(std::strtod(j.get_array_n(1).get_string().c_str(), nullptr));
+	}
+	else if(tag == "string"){
+		return value_t::make_string(j.get_array_n(1).get_string());
+	}
+	else if(tag == "json"){
+		return value_t::make_json(j.get_array_n(1));
+	}
+	else if(tag == "typeid"){
+		return value_t::make_typeid_value(type_from_cache_json(j.get_array_n(1)));
+	}
+	else if(tag == "struct"){
+		std::vector<value_t> members;
+		for(const auto& e: j.get_array_n(2).get_array()){
+			members.push_back(value_from_cache_json(types, e));
+		}
+		return value_t::make_struct_value(types, type_from_cache_json(j.get_array_n(1)), members);
+	}
+	else if(tag == "vector"){
+		const auto type = type_from_cache_json(j.get_array_n(1));
+		std::vector<value_t> elements;
+		for(const auto& e: j.get_array_n(2).get_array()){
+			elements.push_back(value_from_cache_json(types, e));
+		}
+		return value_t::make_vector_value(types, peek2(types, type).get_vector_element_type(types), elements);
+	}
+	else if(tag == "dict"){
+		const auto type = type_from_cache_json(j.get_array_n(1));
+		std::map<std::string, value_t> entries;
+		for(const auto& e: j.get_array_n(2).get_object()){
+			entries.insert({ e.first, value_from_cache_json(types, e.second) });
+		}
+		return value_t::make_dict_value(types, peek2(types, type).get_dict_value_type(types), entries);
+	}
+	else if(tag == "function"){
+		return value_t::make_function_value(type_from_cache_json(j.get_array_n(1)), function_id_t { j.get_array_n(2).get_string() });
+	}
+	else{
+		throw std::runtime_error("Unknown value in cache JSON.");
+	}
+}
+
+
+
+//////////////////////////////////////		expression_t
+
+
+static json_t expressions_to_cache_json(const std::vector<expression_t>& expressions){
+	std::vector<json_t> result;
+	for(const auto& e: expressions){
+		result.push_back(expression_to_cache_json(e));
+	}
+	return json_t::make_array(result);
+}
+static std::vector<expression_t> expressions_from_cache_json(types_t& types, const json_t& j){
+	std::vector<expression_t> result;
+	for(const auto& e: j.get_array()){
+		result.push_back(expression_from_cache_json(types, e));
+	}
+	return result;
+}
+
+//	[ opcode, location, output type, ...operands ]
+json_t expression_to_cache_json(const expression_t& e){
+	QUARK_ASSERT(e.check_invariant());
+
+	struct visitor_t {
+		const expression_t& expr;
+
+		json_t make(const std::string& opcode, const std::vector<json_t>& operands) const {
+			std::vector<json_t> result = { opcode, location_to_cache_json(expr.location), type_to_cache_json(expr._output_type) };
+			result.insert(result.end(), operands.begin(), operands.end());
+			return json_t::make_array(result);
+		}
+
+		json_t operator()(const expression_t::literal_exp_t& e) const{
+			return make(expression_opcode_t::k_literal, { value_to_cache_json(e.value) });
+		}
+		json_t operator()(const expression_t::arithmetic_t& e) const{
+			return make(expression_type_to_opcode(e.op), { expression_to_cache_json(*e.lhs), expression_to_cache_json(*e.rhs) });
+		}
+		json_t operator()(const expression_t::comparison_t& e) const{
+			return make(expression_type_to_opcode(e.op), { expression_to_cache_json(*e.lhs), expression_to_cache_json(*e.rhs) });
+		}
+		json_t operator()(const expression_t::unary_minus_t& e) const{
+			return make(expression_opcode_t::k_unary_minus, { expression_to_cache_json(*e.expr) });
+		}
+		json_t operator()(const expression_t::conditional_t& e) const{
+			return make(
+				expression_opcode_t::k_conditional_operator,
+				{ expression_to_cache_json(*e.condition), expression_to_cache_json(*e.a), expression_to_cache_json(*e.b) }
+			);
+		}
+		json_t operator()(const expression_t::call_t& e) const{
+			return make(expression_opcode_t::k_call, { expression_to_cache_json(*e.callee), expressions_to_cache_json(e.args) });
+		}
+		json_t operator()(const expression_t::intrinsic_t& e) const{
+			return make(expression_opcode_t::k_intrinsic, { e.call_name, expressions_to_cache_json(e.args) });
+		}
+		json_t operator()(const expression_t::struct_definition_expr_t& e) const{
+			return make(expression_opcode_t::k_struct_def, { e.name, members_to_cache_json(e.def->_members) });
+		}
+		json_t operator()(const expression_t::function_definition_expr_t& e) const{
+			return make(expression_opcode_t::k_function_def, { function_def_to_cache_json(e.def) });
+		}
+		json_t operator()(const expression_t::load_t& e) const{
+			return make(expression_opcode_t::k_load, { e.variable_name });
+		}
+		json_t operator()(const expression_t::load2_t& e) const{
+			return make(expression_opcode_t::k_load2, { symbol_pos_to_cache_json(e.address) });
+		}
+		json_t operator()(const expression_t::resolve_member_t& e) const{
+			return make(expression_opcode_t::k_resolve_member, { expression_to_cache_json(*e.parent_address), e.member_name });
+		}
+		json_t operator()(const expression_t::update_member_t& e) const{
+			return make(
+				expression_opcode_t::k_update_member,
+				{ expression_to_cache_json(*e.parent_address), json_t(e.member_index), expression_to_cache_json(*e.new_value) }
+			);
+		}
+		json_t operator()(const expression_t::lookup_t& e) const{
+			return make(expression_opcode_t::k_lookup_element, { expression_to_cache_json(*e.parent_address), expression_to_cache_json(*e.lookup_key) });
+		}
+		json_t operator()(const expression_t::value_constructor_t& e) const{
+			return make(expression_opcode_t::k_value_constructor, { type_to_cache_json(e.value_type), expressions_to_cache_json(e.elements) });
+		}
+		json_t operator()(const expression_t::benchmark_expr_t& e) const{
+			return make(expression_opcode_t::k_benchmark, { body_to_cache_json(*e.body) });
+		}
+	};
+
+	return std::visit(visitor_t{ e }, e._expression_variant);
+}
+
+expression_t expression_from_cache_json(types_t& types, const json_t& j){
+	QUARK_ASSERT(types.check_invariant());
+
+	const auto& opcode = j.get_array_n(0).get_string();
+	const auto output_type = type_from_cache_json(j.get_array_n(2));
+	const auto& a = j.get_array_n(3);
+
+	const auto e = [&]() -> expression_t {
+		if(opcode == expression_opcode_t::k_literal){
+			return expression_t::make_literal(value_from_cache_json(types, a), output_type);
+		}
+		else if(is_opcode_arithmetic_expression(opcode)){
+			const auto lhs = expression_from_cache_json(types, a);
+			const auto rhs = expression_from_cache_json(types, j.get_array_n(4));
+			return expression_t::make_arithmetic(opcode_to_expression_type(opcode), lhs, rhs, output_type);
+		}
+		else if(is_opcode_comparison_expression(opcode)){
+			const auto lhs = expression_from_cache_json(types, a);
+			const auto rhs = expression_from_cache_json(types, j.get_array_n(4));
+			return expression_t::make_comparison(opcode_to_expression_type(opcode), lhs, rhs, output_type);
+		}
+		else if(opcode == expression_opcode_t::k_unary_minus){
+			return expression_t::make_unary_minus(expression_from_cache_json(types, a), output_type);
+		}
+		else if(opcode == expression_opcode_t::k_conditional_operator){
+			return expression_t::make_conditional_operator(
+				expression_from_cache_json(types, a),
+				expression_from_cache_json(types, j.get_array_n(4)),
+				expression_from_cache_json(types, j.get_array_n(5)),
+				output_type
+			);
+		}
+		else if(opcode == expression_opcode_t::k_call){
+			return expression_t::make_call(expression_from_cache_json(types, a), expressions_from_cache_json(types, j.get_array_n(4)), output_type);
+		}
+		else if(opcode == expression_opcode_t::k_intrinsic){
+			return expression_t::make_intrinsic(a.get_string(), expressions_from_cache_json(types, j.get_array_n(4)), output_type);
+		}
+		else if(opcode == expression_opcode_t::k_struct_def){
+			const auto def = std::make_shared<const struct_type_desc_t>(members_from_cache_json(j.get_array_n(4)));
+			return expression_t::make_struct_definition(types, a.get_string(), def);
+		}
+		else if(opcode == expression_opcode_t::k_function_def){
+			return expression_t::make_function_definition(function_def_from_cache_json(types, a));
+		}
+		else if(opcode == expression_opcode_t::k_load){
+			return expression_t::make_load(a.get_string(), output_type);
+		}
+		else if(opcode == expression_opcode_t::k_load2){
+			return expression_t::make_load2(symbol_pos_from_cache_json(a), output_type);
+		}
+		else if(opcode == expression_opcode_t::k_resolve_member){
+			return expression_t::make_resolve_member(expression_from_cache_json(types, a), j.get_array_n(4).get_string(), output_type);
+		}
+		else if(opcode == expression_opcode_t::k_update_member){
+			return expression_t::make_update_member(
+				expression_from_cache_json(types, a),
+				static_cast<int>(j.get_array_n(4).get_number()),
+				expression_from_cache_json(types, j.get_array_n(5)),
+				output_type
+			);
+		}
+		else if(opcode == expression_opcode_t::k_lookup_element){
+			return expression_t::make_lookup(expression_from_cache_json(types, a), expression_from_cache_json(types, j.get_array_n(4)), output_type);
+		}
+		else if(opcode == expression_opcode_t::k_value_constructor){
+			return expression_t::make_construct_value_expr(type_from_cache_json(a), expressions_from_cache_json(types, j.get_array_n(4)));
+		}
+		else if(opcode == expression_opcode_t::k_benchmark){
+			return expression_t::make_benchmark_expr(body_from_cache_json(types, a));
+		}
+		else{
+			throw std::runtime_error("Unknown expression in cache JSON.");
+		}
+	}();
+
+	//	Some make-functions calculate their own output type: restore the stored one.
+	auto result = e;
+	result.location = location_from_cache_json(j.get_array_n(1));
+	result._output_type = output_type;
+	return result;
+}
+
+
+
+//////////////////////////////////////		statement_t
+
+
+//	[ opcode, location, ...operands ]
+json_t statement_to_cache_json(const statement_t& s){
+	QUARK_ASSERT(s.check_invariant());
+
+	struct visitor_t {
+		const statement_t& statement;
+
+		json_t make(const std::string& opcode, const std::vector<json_t>& operands) const {
+			std::vector<json_t> result = { opcode, location_to_cache_json(statement.location) };
+			result.insert(result.end(), operands.begin(), operands.end());
+			return json_t::make_array(result);
+		}
+
+		json_t operator()(const statement_t::return_statement_t& s) const{
+			return make(statement_opcode_t::k_return, { expression_to_cache_json(s._expression) });
+		}
+		json_t operator()(const statement_t::bind_local_t& s) const{
+			return make(
+				statement_opcode_t::k_init_local,
+				{
+					s._new_local_name,
+					type_to_cache_json(s._bindtype),
+					expression_to_cache_json(s._expression),
+					json_t(s._locals_mutable_mode == statement_t::bind_local_t::k_mutable)
+				}
+			);
+		}
+		json_t operator()(const statement_t::assign_t& s) const{
+			return make(statement_opcode_t::k_assign, { s._local_name, expression_to_cache_json(s._expression) });
+		}
+		json_t operator()(const statement_t::assign2_t& s) const{
+			return make(statement_opcode_t::k_assign2, { symbol_pos_to_cache_json(s._dest_variable), expression_to_cache_json(s._expression) });
+		}
+		json_t operator()(const statement_t::init2_t& s) const{
+			return make(statement_opcode_t::k_init_local2, { symbol_pos_to_cache_json(s._dest_variable), expression_to_cache_json(s._expression) });
+		}
+		json_t operator()(const statement_t::block_statement_t& s) const{
+			return make(statement_opcode_t::k_block, { body_to_cache_json(s._body) });
+		}
+		json_t operator()(const statement_t::ifelse_statement_t& s) const{
+			return make(
+				statement_opcode_t::k_if,
+				{ expression_to_cache_json(s._condition), body_to_cache_json(s._then_body), body_to_cache_json(s._else_body) }
+			);
+		}
+		json_t operator()(const statement_t::for_statement_t& s) const{
+			return make(
+				statement_opcode_t::k_for,
+				{
+					s._iterator_name,
+					expression_to_cache_json(s._start_expression),
+					expression_to_cache_json(s._end_expression),
+					body_to_cache_json(s._body),
+					json_t(s._range_type == statement_t::for_statement_t::k_closed_range)
+				}
+			);
+		}
+		json_t operator()(const statement_t::while_statement_t& s) const{
+			return make(statement_opcode_t::k_while, { expression_to_cache_json(s._condition), body_to_cache_json(s._body) });
+		}
+		json_t operator()(const statement_t::expression_statement_t& s) const{
+			return make(statement_opcode_t::k_expression_statement, { expression_to_cache_json(s._expression) });
+		}
+		json_t operator()(const statement_t::software_system_statement_t& s) const{
+			return make(statement_opcode_t::k_software_system_def, { s._json_data });
+		}
+		json_t operator()(const statement_t::container_def_statement_t& s) const{
+			return make(statement_opcode_t::k_container_def, { s._json_data });
+		}
+		json_t operator()(const statement_t::benchmark_def_statement_t& s) const{
+			return make(statement_opcode_t::k_benchmark_def, { s.name, body_to_cache_json(s._body) });
+		}
+	};
+
+	return std::visit(visitor_t{ s }, s._contents);
+}
+
+statement_t statement_from_cache_json(types_t& types, const json_t& j){
+	QUARK_ASSERT(types.check_invariant());
+
+	const auto& opcode = j.get_array_n(0).get_string();
+	const auto location = location_from_cache_json(j.get_array_n(1));
+	const auto& a = j.get_array_n(2);
+
+	if(opcode == statement_opcode_t::k_return){
+		return statement_t::make__return_statement(location, expression_from_cache_json(types, a));
+	}
+	else if(opcode == statement_opcode_t::k_init_local){
+		return statement_t::make__bind_local(
+			location,
+			a.get_string(),
+			type_from_cache_json(j.get_array_n(3)),
+			expression_from_cache_json(types, j.get_array_n(4)),
+			j.get_array_n(5).is_true() ? statement_t::bind_local_t::k_mutable : statement_t::bind_local_t::k_immutable
+		);
+	}
+	else if(opcode == statement_opcode_t::k_assign){
+		return statement_t::make__assign(location, a.get_string(), expression_from_cache_json(types, j.get_array_n(3)));
+	}
+	else if(opcode == statement_opcode_t::k_assign2){
+		return statement_t::make__assign2(location, symbol_pos_from_cache_json(a), expression_from_cache_json(types, j.get_array_n(3)));
+	}
+	else if(opcode == statement_opcode_t::k_init_local2){
+		return statement_t::make__init2(location, symbol_pos_from_cache_json(a), expression_from_cache_json(types, j.get_array_n(3)));
+	}
+	else if(opcode == statement_opcode_t::k_block){
+		return statement_t::make__block_statement(location, body_from_cache_json(types, a));
+	}
+	else if(opcode == statement_opcode_t::k_if){
+		return statement_t::make__ifelse_statement(
+			location,
+			expression_from_cache_json(types, a),
+			body_from_cache_json(types, j.get_array_n(3)),
+			body_from_cache_json(types, j.get_array_n(4))
+		);
+	}
+	else if(opcode == statement_opcode_t::k_for){
+		return statement_t::make__for_statement(
+			location,
+			a.get_string(),
+			expression_from_cache_json(types, j.get_array_n(3)),
+			expression_from_cache_json(types, j.get_array_n(4)),
+			body_from_cache_json(types, j.get_array_n(5)),
+			j.get_array_n(6).is_true() ? statement_t::for_statement_t::k_closed_range : statement_t::for_statement_t::k_open_range
+		);
+	}
+	else if(opcode == statement_opcode_t::k_while){
+		return statement_t::make__while_statement(location, expression_from_cache_json(types, a), body_from_cache_json(types, j.get_array_n(3)));
+	}
+	else if(opcode == statement_opcode_t::k_expression_statement){
+		return statement_t::make__expression_statement(location, expression_from_cache_json(types, a));
+	}
+	else if(opcode == statement_opcode_t::k_software_system_def){
+		return statement_t::make__software_system_statement(location, a);
+	}
+	else if(opcode == statement_opcode_t::k_container_def){
+		return statement_t::make__container_def_statement(location, a);
+	}
+	else if(opcode == statement_opcode_t::k_benchmark_def){
+		return statement_t::make__benchmark_def_statement(location, a.get_string(), body_from_cache_json(types, j.get_array_n(3)));
+	}
+	else{
+		throw std::runtime_error("Unknown statement in cache JSON.");
+	}
+}
+
+json_t statements_to_cache_json(const std::vector<statement_t>& statements){
+	std::vector<json_t> result;
+	for(const auto& e: statements){
+		result.push_back(statement_to_cache_json(e));
+	}
+	return json_t::make_array(result);
+}
+
+std::vector<statement_t> statements_from_cache_json(types_t& types, const json_t& j){
+	std::vector<statement_t> result;
+	for(const auto& e: j.get_array()){
+		result.push_back(statement_from_cache_json(types, e));
+	}
+	return result;
+}
+
+
+
+//////////////////////////////////////		body_t, symbol_table_t, function_definition_t
+
+
+json_t body_to_cache_json(const body_t& body){
+	QUARK_ASSERT(body.check_invariant());
+
+	return json_t::make_array({ statements_to_cache_json(body._statements), symbols_to_cache_json(body._symbol_table) });
+}
+
+body_t body_from_cache_json(types_t& types, const json_t& j){
+	const auto statements = statements_from_cache_json(types, j.get_array_n(0));
+	const auto symbols = symbols_from_cache_json(types, j.get_array_n(1));
+	return body_t(statements, symbols);
+}
+
+//	[ [ name, symbol type, value type, init value ] ]
+json_t symbols_to_cache_json(const symbol_table_t& symbols){
+	std::vector<json_t> result;
+	for(const auto& e: symbols._symbols){
+		result.push_back(
+			json_t::make_array({
+				e.first,
+				json_t(static_cast<int>(e.second._symbol_type)),
+				type_to_cache_json(e.second._value_type),
+				value_to_cache_json(e.second._init)
+			})
+		);
+	}
+	return json_t::make_array(result);
+}
+
+symbol_table_t symbols_from_cache_json(const types_t& types, const json_t& j){
+	std::vector<std::pair<std::string, symbol_t>> result;
+	for(const auto& e: j.get_array()){
+		const auto symbol = symbol_t(
+			static_cast<symbol_t::symbol_type>(static_cast<int>(e.get_array_n(1).get_number())),
+			type_from_cache_json(e.get_array_n(2)),
+			value_from_cache_json(types, e.get_array_n(3))
+		);
+		result.push_back({ e.get_array_n(0).get_string(), symbol });
+	}
+	return symbol_table_t{ result };
+}
+
+//	[ location, definition name, function type, named args, body or null ]
+json_t function_def_to_cache_json(const function_definition_t& def){
+	QUARK_ASSERT(def.check_invariant());
+
+	return json_t::make_array({
+		location_to_cache_json(def._location),
+		def._definition_name,
+		type_to_cache_json(def._function_type),
+		members_to_cache_json(def._named_args),
+		def._optional_body ? body_to_cache_json(*def._optional_body) : json_t()
+	});
+}
+
+function_definition_t function_def_from_cache_json(types_t& types, const json_t& j){
+	const auto& body_json = j.get_array_n(4);
+	const auto body = body_json.is_null() ? std::shared_ptr<const body_t>() : std::make_shared<const body_t>(body_from_cache_json(types, body_json));
+	return function_definition_t{
+		location_from_cache_json(j.get_array_n(0)),
+		j.get_array_n(1).get_string(),
+		type_desc_t::wrap_non_named(type_from_cache_json(j.get_array_n(2))),
+		members_from_cache_json(j.get_array_n(3)),
+		body
+	};
+}
+
+
+
+//////////////////////////////////////		TESTS
+
+
+static json_t round_trip_expression(types_t& types, const expression_t& e){
+	const auto json = expression_to_cache_json(e);
+	const auto text = json_to_compact_string(json);
+	const auto e2 = expression_from_cache_json(types, parse_json(seq_t(text)).first);
+	QUARK_VERIFY(e2.location == e.location);
+	QUARK_VERIFY(e2._output_type == e._output_type);
+	return expression_to_cache_json(e2);
+}
+
+QUARK_TEST("ast_cache_json", "value_from_cache_json()", "all value kinds", "same values"){
+	types_t types;
+	const auto s = make_struct(types, struct_type_desc_t( { member_t(type_t::make_int(), "a"), member_t(type_t::make_double(), "b") } ));
+	const auto f = make_function(types, type_t::make_void(), { type_t::make_int() }, epure::pure);
+	const std::vector<value_t> values = {
+		value_t::make_undefined(),
+		value_t::make_bool(true),
+		value_t::make_int(-9007199254740993),
+		value_t::make_double(0.1),
+		value_t::make_string("hello"),
+		value_t::make_json(json_t::make_array({ 1.0, "x" })),
+		value_t::make_typeid_value(s),
+		value_t::make_struct_value(types, s, { value_t::make_int(3), value_t::make_double(1.0 / 3.0) }),
+		value_t::make_vector_value(types, type_t::make_string(), { value_t::make_string("a"), value_t::make_string("b") }),
+		value_t::make_dict_value(types, type_t::make_int(), { { "x", value_t::make_int(1) } }),
+		value_t::make_function_value(f, function_id_t { "my_func" })
+	};
+	for(const auto& v: values){
+		const auto text = json_to_compact_string(value_to_cache_json(v));
+		const auto v2 = value_from_cache_json(types, parse_json(seq_t(text)).first);
+		QUARK_VERIFY(v2 == v);
+		QUARK_VERIFY(v2.get_type() == v.get_type());
+	}
+}
+
+QUARK_TEST("ast_cache_json", "expression_from_cache_json()", "nested expressions with locations", "same JSON again"){
+	types_t types;
+	auto lhs = expression_t::make_load2(symbol_pos_t::make_stack_pos(1, 4), type_t::make_int());
+	lhs.location = location_t(123);
+	const auto call = expression_t::make_call(
+		expression_t::make_load("f", type_t::make_int()),
+		{ expression_t::make_literal_int(3), lhs },
+		type_t::make_int()
+	);
+	const auto e = expression_t::make_conditional_operator(
+		expression_t::make_comparison(expression_type::k_comparison_smaller, lhs, call, type_t::make_bool()),
+		expression_t::make_arithmetic(expression_type::k_arithmetic_add, lhs, expression_t::make_literal_int(1), type_t::make_int()),
+		expression_t::make_unary_minus(call, type_t::make_int()),
+		type_t::make_int()
+	);
+	QUARK_VERIFY(round_trip_expression(types, e) == expression_to_cache_json(e));
+}
+
+QUARK_TEST("ast_cache_json", "function_def_from_cache_json()", "function with body", "same JSON again"){
+	types_t types;
+	const auto f = make_function(types, type_t::make_int(), { type_t::make_int() }, epure::pure);
+	const auto body = body_t(
+		{
+			statement_t::make__bind_local(
+				location_t(7),
+				"x",
+				type_t::make_int(),
+				expression_t::make_literal_int(2),
+				statement_t::bind_local_t::k_mutable
+			),
+			statement_t::make__for_statement(
+				k_no_location,
+				"i",
+				expression_t::make_literal_int(0),
+				expression_t::make_literal_int(3),
+				body_t(),
+				statement_t::for_statement_t::k_closed_range
+			),
+			statement_t::make__return_statement(location_t(20), expression_t::make_load2(symbol_pos_t::make_stack_pos(0, 1), type_t::make_int()))
+		},
+		symbol_table_t{ { { "a", symbol_t::make_immutable_arg(type_t::make_int()) }, { "x", symbol_t::make_mutable(type_t::make_int()) } } }
+	);
+	const auto def = function_definition_t::make_func(location_t(3), "f", type_desc_t::wrap_non_named(f), { member_t(type_t::make_int(), "a") }, std::make_shared<body_t>(body));
+
+	const auto json = function_def_to_cache_json(def);
+	const auto def2 = function_def_from_cache_json(types, parse_json(seq_t(json_to_compact_string(json))).first);
+	QUARK_VERIFY(def2._location == def._location);
+	QUARK_VERIFY(def2._named_args == def._named_args);
+	QUARK_VERIFY(def2._optional_body->_symbol_table == body._symbol_table);
+	QUARK_VERIFY(def2._optional_body->_statements[1].location == k_no_location);
+	QUARK_VERIFY(function_def_to_cache_json(def2) == json);
+}
+
+
+}	//	floyd
@@ -0,0 +1,51 @@
+//
+//  ast_cache_json.h
+//  Floyd
+//
+//  Created by Marcus Zetterquist on 2026-10-18.
+//  Copyright © 2026 Marcus Zetterquist. All rights reserved.
+//
+
+#ifndef ast_cache_json_hpp
+#define ast_cache_json_hpp
+
+/*
+	Exact JSON for analysed AST parts, used to cache analysed code on disk.
+
+	Unlike expression_to_json() & co this keeps everything: locations, output types, symbol positions.
+	Types are stored as their type_t data, which indexes into the types_t of the AST. Store that types_t
+	using types_to_json() and load it with types_from_json() before loading the other parts into it.
+*/
+
+#include "statement.h"
+
+#include <vector>
+
+struct json_t;
+
+namespace floyd {
+
+json_t value_to_cache_json(const value_t& v);
+value_t value_from_cache_json(const types_t& types, const json_t& j);
+
+json_t expression_to_cache_json(const expression_t& e);
+expression_t expression_from_cache_json(types_t& types, const json_t& j);
+
+json_t statement_to_cache_json(const statement_t& s);
+statement_t statement_from_cache_json(types_t& types, const json_t& j);
+
+json_t statements_to_cache_json(const std::vector<statement_t>& statements);
+std::vector<statement_t> statements_from_cache_json(types_t& types, const json_t& j);
+
+json_t body_to_cache_json(const body_t& body);
+body_t body_from_cache_json(types_t& types, const json_t& j);
+
+json_t symbols_to_cache_json(const symbol_table_t& symbols);
+symbol_table_t symbols_from_cache_json(const types_t& types, const json_t& j);
+
+json_t function_def_to_cache_json(const function_definition_t& def);
+function_definition_t function_def_from_cache_json(types_t& types, const json_t& j);
+
+}	//	floyd
+
+#endif /* ast_cache_json_hpp */
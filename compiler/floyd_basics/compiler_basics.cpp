@@ -21,7 +21,7 @@ const location_t k_no_location(std::numeric_limits<std::size_t>::max());
 
 
 config_t make_default_config(){
-	return config_t { vector_backend::hamt, dict_backend::hamt, false } ;
+	return config_t { vector_backend::hamt, dict_backend::hamt, false, process_scheduling::worker_pool } ;
 }
  
 compiler_settings_t make_default_compiler_settings(){
@@ -891,6 +891,29 @@ void ut_verify(const quark::call_context_t& context, const std::pair<std::string
 	}
 }
 
+void ut_verify_json_and_rest(const quark::call_context_t& context, const std::pair<json_t, text_cursor_t>& result_pair, const std::string& expected_json, const std::string& expected_rest){
+	ut_verify(
+		context,
+		result_pair.first,
+		parse_json(seq_t(expected_json)).first
+	);
+
+	ut_verify(context, result_pair.second.str(), expected_rest);
+}
+
+void ut_verify(const quark::call_context_t& context, const std::pair<std::string, text_cursor_t>& result, const std::pair<std::string, text_cursor_t>& expected){
+	if(result == expected){
+	}
+	else{
+		ut_verify(context, result.first, expected.first);
+		ut_verify(context, result.second.str(), expected.second.str());
+	}
+}
+
+void ut_verify(const quark::call_context_t& context, const std::pair<json_t, text_cursor_t>& result, const std::pair<json_t, text_cursor_t>& expected){
+	ut_verify(context, std::pair<json_t, seq_t>(result.first, seq_t(result.second.str())), std::pair<json_t, seq_t>(expected.first, seq_t(expected.second.str())));
+}
+
 
 
 
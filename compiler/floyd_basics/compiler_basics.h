@@ -18,6 +18,7 @@
 #include "quark.h"
 
 struct seq_t;
+struct text_cursor_t;
 struct json_t;
 
 
@@ -146,12 +147,51 @@ inline type_t make_benchmark_id_t(types_t& types){
 }
 
 
+//////////////////////////////////////		benchmark_stats_t
+
+/*
+	Statistics of the samples of one benchmark expression, in nanoseconds. The first sample is
+	treated as warm-up and is not included. sample_count == 0 means there are no statistics, for
+	example when a benchmark-def returns hand-made benchmark_result_t:s.
+
+	mad: median absolute deviation.
+	outlier_count: samples further than 3 scaled MADs from the median.
+*/
+struct benchmark_stats_t {
+	int64_t sample_count;
+	int64_t min;
+	int64_t max;
+	int64_t mean;
+	int64_t median;
+	int64_t p90;
+	int64_t p99;
+	int64_t stddev;
+	int64_t mad;
+	int64_t outlier_count;
+};
+inline bool operator==(const benchmark_stats_t& lhs, const benchmark_stats_t& rhs){
+	return lhs.sample_count == rhs.sample_count
+		&& lhs.min == rhs.min
+		&& lhs.max == rhs.max
+		&& lhs.mean == rhs.mean
+		&& lhs.median == rhs.median
+		&& lhs.p90 == rhs.p90
+		&& lhs.p99 == rhs.p99
+		&& lhs.stddev == rhs.stddev
+		&& lhs.mad == rhs.mad
+		&& lhs.outlier_count == rhs.outlier_count;
+}
+
+
 //////////////////////////////////////		benchmark_result2_t
 
 
 struct benchmark_result2_t {
 	benchmark_id_t test_id;
 	benchmark_result_t result;
+
+	//	Statistics of the benchmark expression that produced result.dur, if known.
+	benchmark_stats_t stats;
 };
 
 inline bool operator==(const benchmark_result2_t& lhs, const benchmark_result2_t& rhs){
@@ -406,13 +446,30 @@ struct compilation_unit_t {
 
 
 
+//	per_type: each vector / dict type uses the backend recorded in its type node by select_collection_backends().
 enum class vector_backend {
 	carray,
-	hamt
+	hamt,
+	per_type
 };
 enum class dict_backend {
 	cppmap,
-	hamt
+	hamt,
+
+	//	Flat open-addressing hash table, see quadratic_probing_hash_table_t.
+	hashtable,
+
+	per_type
+};
+
+//	How Floyd processes are mapped to OS threads. Processes on the same clock bus always run on the same thread.
+//	worker_pool: clock busses are multiplexed on a fixed pool of worker threads, a clock bus only occupies a worker while it has messages.
+//		The processes are done when no clock bus has any messages left.
+//	thread_per_clock_bus: each clock bus gets its own std::thread that blocks on its inbox.
+//		The processes are done when every process has received "stop".
+enum class process_scheduling {
+	worker_pool,
+	thread_per_clock_bus
 };
 
 struct config_t {
@@ -424,12 +481,13 @@ struct config_t {
 	vector_backend vector_backend_mode;
 	dict_backend dict_backend_mode;
 	bool trace_allocs;
+	process_scheduling process_scheduling_mode;
 };
 
 inline bool operator==(const config_t& lhs, const config_t& rhs){
 	QUARK_ASSERT(lhs.check_invariant());
 	QUARK_ASSERT(rhs.check_invariant());
-	return lhs.vector_backend_mode == rhs.vector_backend_mode && lhs.dict_backend_mode == rhs.dict_backend_mode && lhs.trace_allocs == rhs.trace_allocs;
+	return lhs.vector_backend_mode == rhs.vector_backend_mode && lhs.dict_backend_mode == rhs.dict_backend_mode && lhs.trace_allocs == rhs.trace_allocs && lhs.process_scheduling_mode == rhs.process_scheduling_mode;
 }
 
 
@@ -571,6 +629,10 @@ void ut_verify_json_and_rest(const quark::call_context_t& context, const std::pa
 
 void ut_verify(const quark::call_context_t& context, const std::pair<std::string, seq_t>& result, const std::pair<std::string, seq_t>& expected);
 
+void ut_verify_json_and_rest(const quark::call_context_t& context, const std::pair<json_t, text_cursor_t>& result_pair, const std::string& expected_json, const std::string& expected_rest);
+void ut_verify(const quark::call_context_t& context, const std::pair<std::string, text_cursor_t>& result, const std::pair<std::string, text_cursor_t>& expected);
+void ut_verify(const quark::call_context_t& context, const std::pair<json_t, text_cursor_t>& result, const std::pair<json_t, text_cursor_t>& expected);
+
 
 
 
@@ -19,6 +19,19 @@
 #include "compiler_helpers.h"
 #include "compiler_basics.h"
 #include "floyd_corelib.h"
+#include "format_table.h"
+#include "json_support.h"
+#include "text_parser.h"
+#include "sha1_class.h"
+
+#include <mutex>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <cstdlib>
+#include <cerrno>
+#include <unistd.h>
+#include <sys/stat.h>
 
 namespace floyd {
 
@@ -123,11 +136,262 @@ semantic_ast_t run_semantic_analysis__errors(const unchecked_ast_t& unchecked_as
 
 
 semantic_ast_t compile_to_sematic_ast__errors(const compilation_unit_t& cu){
-//	QUARK_CONTEXT_TRACE(context._tracer, json_to_pretty_string(statements_pos.first._value));
-	const auto parse_tree = parse_program__errors(cu);
+	std::vector<phase_time_t> phase_times;
+	return compile_to_sematic_ast__errors(cu, phase_times);
+}
+
+
+
+////////////////////////////////		PREFIX CACHE
+
+
+const std::string k_compiler_version = "floyd-compiler-1";
+
+std::string get_prefix_cache_dir(){
+	const char* dir = std::getenv("FLOYD_CACHE_DIR");
+	if(dir != nullptr){
+		return std::string(dir);
+	}
+	const char* home = std::getenv("HOME");
+	return home != nullptr && home[0] != 0 ? std::string(home) + "/.cache/floyd" : "";
+}
+
+std::string get_prefix_cache_path(const std::string& cache_dir, const std::string& prefix_source){
+	const auto key = SHA1ToStringPlain(CalcSHA1(k_compiler_version + "\n" + prefix_source));
+	return cache_dir + "/prefix_" + key + ".json";
+}
+
+//	Only the prefix's hash is stored: the file name already depends on the whole prefix source.
+std::shared_ptr<const analysed_prefix_t> load_prefix_cache(const std::string& cache_dir, const std::string& prefix_source){
+	if(cache_dir.empty()){
+		return nullptr;
+	}
+
+	std::ifstream f(get_prefix_cache_path(cache_dir, prefix_source), std::ios::binary);
+	if(f.is_open() == false){
+		return nullptr;
+	}
+	std::stringstream text;
+	text << f.rdbuf();
+
+	try {
+		const auto json = parse_json(seq_t(text.str())).first;
+		if(
+			json.get_object_element("compiler_version").get_string() != k_compiler_version
+			|| json.get_object_element("prefix_sha1").get_string() != SHA1ToStringPlain(CalcSHA1(prefix_source))
+		){
+			return nullptr;
+		}
+		return analysed_prefix_from_json(json.get_object_element("prefix"));
+	}
+
+	//	A broken or foreign file: analyse the prefix again and overwrite it.
+	catch(const std::exception& e){
+		return nullptr;
+	}
+}
+
+static bool make_directories(const std::string& path){
+	for(std::size_t pos = path.find('/', 1) ; ; pos = path.find('/', pos + 1)){
+		const auto dir = path.substr(0, pos);
+		if(::mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST){
+			return false;
+		}
+		if(pos == std::string::npos){
+			return true;
+		}
+	}
+}
+
+bool save_prefix_cache(const std::string& cache_dir, const std::string& prefix_source, const analysed_prefix_t& prefix){
+	if(cache_dir.empty() || make_directories(cache_dir) == false){
+		return false;
+	}
+
+	std::string text;
+	try {
+		const auto json = json_t::make_object({
+			{ "compiler_version", k_compiler_version },
+			{ "prefix_sha1", SHA1ToStringPlain(CalcSHA1(prefix_source)) },
+			{ "prefix", analysed_prefix_to_json(prefix) }
+		});
+		text = json_to_compact_string(json);
+	}
+	catch(const std::exception& e){
+		return false;
+	}
+
+	//	Write a file of our own and rename it, so other processes never see a partial file.
+	const auto path = get_prefix_cache_path(cache_dir, prefix_source);
+	const auto temp_path = path + "." + std::to_string(::getpid()) + ".tmp";
+	{
+		std::ofstream f(temp_path, std::ios::binary | std::ios::trunc);
+		f << text;
+		f.close();
+		if(f.fail()){
+			std::remove(temp_path.c_str());
+			return false;
+		}
+	}
+	if(std::rename(temp_path.c_str(), path.c_str()) != 0){
+		std::remove(temp_path.c_str());
+		return false;
+	}
+	return true;
+}
+
+
+//	Parses and analyses a prefix the first time it is used, then reuses the result. Shared by all
+//	compiles in the process. Below the in-memory map is the disk cache, shared by all processes.
+static std::shared_ptr<const analysed_prefix_t> get_analysed_prefix(const std::string& prefix_source){
+	static std::mutex lock;
+	static std::map<std::string, std::shared_ptr<const analysed_prefix_t>> cache;
+
+	std::lock_guard<std::mutex> guard(lock);
+	const auto it = cache.find(prefix_source);
+	if(it != cache.end()){
+		return it->second;
+	}
+	else{
+		const auto cache_dir = get_prefix_cache_dir();
+		const auto loaded = load_prefix_cache(cache_dir, prefix_source);
+		if(loaded){
+			cache.insert({ prefix_source, loaded });
+			return loaded;
+		}
+
+		const auto cu = make_compilation_unit_nolib(prefix_source, "");
+		const auto parse_tree = parse_program__errors(cu);
+		const auto unchecked_ast = parse_tree_to_ast(parse_tree);
+		const auto prefix = analyse_prefix(unchecked_ast);
+		save_prefix_cache(cache_dir, prefix_source, *prefix);
+		cache.insert({ prefix_source, prefix });
+		return prefix;
+	}
+}
+
+static parser::parse_tree_t parse_program_after_prefix__errors(const compilation_unit_t& cu, const types_t& prefix_types){
+	try {
+		const auto source = cu.prefix_source + cu.program_text;
+		return parser::parse_program2(source, cu.prefix_source.size(), prefix_types);
+	}
+	catch(const compiler_error& e){
+		const auto refined = refine_compiler_error_with_loc2(cu, e);
+		throw_compiler_error(refined.first, refined.second);
+	}
+}
+
+static semantic_ast_t run_semantic_analysis_after_prefix__errors(const analysed_prefix_t& prefix, const unchecked_ast_t& unchecked_ast, const compilation_unit_t& cu){
+	try {
+		return run_semantic_analysis(prefix, unchecked_ast);
+	}
+	catch(const compiler_error& e){
+		const auto refined = refine_compiler_error_with_loc2(cu, e);
+		throw_compiler_error(refined.first, refined.second);
+	}
+}
+
+//	The prefix (corelib) is only parsed and analysed once per process, see get_analysed_prefix().
+semantic_ast_t compile_to_sematic_ast__errors(const compilation_unit_t& cu, std::vector<phase_time_t>& phase_times){
+	if(cu.prefix_source.empty()){
+		const auto parse_tree = time_phase(phase_times, "parse", [&](){ return parse_program__errors(cu); });
+		const auto unchecked_ast = time_phase(phase_times, "parse tree to AST", [&](){ return parse_tree_to_ast(parse_tree); });
+		const auto sem_ast = time_phase(phase_times, "semantic analysis", [&](){ return run_semantic_analysis__errors(unchecked_ast, cu); });
+		return sem_ast;
+	}
+	else{
+		const auto prefix = time_phase(phase_times, "prefix", [&](){ return get_analysed_prefix(cu.prefix_source); });
+		const auto parse_tree = time_phase(phase_times, "parse", [&](){ return parse_program_after_prefix__errors(cu, get_prefix_types(*prefix)); });
+		const auto unchecked_ast = time_phase(phase_times, "parse tree to AST", [&](){ return parse_tree_to_ast(parse_tree); });
+		const auto sem_ast = time_phase(phase_times, "semantic analysis", [&](){ return run_semantic_analysis_after_prefix__errors(*prefix, unchecked_ast, cu); });
+		return sem_ast;
+	}
+}
+
+void trace_phase_times(const std::vector<phase_time_t>& phase_times){
+	QUARK_SCOPED_TRACE("PHASE TIMES");
+
+	std::vector<std::vector<std::string>> matrix;
+	int64_t total = 0;
+	for(const auto& e: phase_times){
+		matrix.push_back({ e.phase, std::to_string(e.ns / 1000) });
+		total += e.ns;
+	}
+	matrix.push_back({ "TOTAL", std::to_string(total / 1000) });
+
+	const auto result = generate_table_type1({ "PHASE", "TIME (us)" }, matrix);
+	QUARK_TRACE(result);
+}
+
+
+
+////////////////////////////////		PREFIX CACHE TESTS
+
+
+static std::string make_test_cache_dir(const std::string& name){
+	const char* temp = std::getenv("TMPDIR");
+	const auto dir = std::string(temp != nullptr && temp[0] != 0 ? temp : "/tmp") + "/floyd_test_" + std::to_string(::getpid()) + "_" + name;
+	std::remove(get_prefix_cache_path(dir, k_corelib_builtin_types_and_constants).c_str());
+	return dir;
+}
+
+static std::string compile_after_prefix_to_json(const analysed_prefix_t& prefix, const std::string& program){
+	const auto cu = make_compilation_unit_lib(program, "");
+	const auto parse_tree = parse_program_after_prefix__errors(cu, get_prefix_types(prefix));
 	const auto unchecked_ast = parse_tree_to_ast(parse_tree);
-	const auto sem_ast = run_semantic_analysis__errors(unchecked_ast, cu);
-	return sem_ast;
+	const auto sem_ast = run_semantic_analysis_after_prefix__errors(prefix, unchecked_ast, cu);
+	return json_to_compact_string(semantic_ast_to_json(sem_ast));
+}
+
+static std::shared_ptr<const analysed_prefix_t> analyse_corelib(){
+	const auto cu = make_compilation_unit_nolib(k_corelib_builtin_types_and_constants, "");
+	return analyse_prefix(parse_tree_to_ast(parse_program__errors(cu)));
+}
+
+QUARK_TEST("", "load_prefix_cache()", "corelib saved to disk", "programs analyse the same as with the analysed corelib"){
+	const auto dir = make_test_cache_dir("a");
+	const auto prefix = analyse_corelib();
+	QUARK_VERIFY(load_prefix_cache(dir, k_corelib_builtin_types_and_constants) == nullptr);
+	QUARK_VERIFY(save_prefix_cache(dir, k_corelib_builtin_types_and_constants, *prefix));
+
+	const auto loaded = load_prefix_cache(dir, k_corelib_builtin_types_and_constants);
+	QUARK_VERIFY(loaded != nullptr);
+	QUARK_VERIFY(get_prefix_types(*loaded).nodes == get_prefix_types(*prefix).nodes);
+
+	const auto program = R"(
+		struct pixel_t { double x; double y }
+		func [string] f(string s){ return [ s, "," ] }
+		func int scale(int e, int c){ return e * c }
+		let a = map([1, 2, 3], scale, 2)
+		let d = { "one": pixel_t(1.0, 2.0) }
+		for(i in 0 ..< 3){
+			print(to_string(a[i]) + f("x,y")[0])
+		}
+		benchmark-def "b" {
+			return [ benchmark_result_t(1, json("")) ]
+		}
+		let ids = get_benchmarks()
+		print(make_benchmark_report(run_benchmarks(ids)))
+	)";
+	QUARK_VERIFY(compile_after_prefix_to_json(*loaded, program) == compile_after_prefix_to_json(*prefix, program));
+
+	std::remove(get_prefix_cache_path(dir, k_corelib_builtin_types_and_constants).c_str());
+}
+
+QUARK_TEST("", "load_prefix_cache()", "file of other prefix or broken file", "nullptr"){
+	const auto dir = make_test_cache_dir("b");
+	const auto prefix = analyse_corelib();
+	QUARK_VERIFY(save_prefix_cache(dir, k_corelib_builtin_types_and_constants, *prefix));
+	QUARK_VERIFY(load_prefix_cache(dir, k_corelib_builtin_types_and_constants + "\n") == nullptr);
+
+	const auto path = get_prefix_cache_path(dir, k_corelib_builtin_types_and_constants);
+	{
+		std::ofstream f(path, std::ios::binary | std::ios::trunc);
+		f << R"({ "compiler_version": ")" << k_compiler_version << R"(", "prefix)";
+	}
+	QUARK_VERIFY(load_prefix_cache(dir, k_corelib_builtin_types_and_constants) == nullptr);
+
+	std::remove(path.c_str());
 }
 
 
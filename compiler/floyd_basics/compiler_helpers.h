@@ -17,11 +17,14 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <chrono>
+#include <memory>
 
 namespace floyd {
 struct semantic_ast_t;
 struct compilation_unit_t;
 struct unchecked_ast_t;
+struct analysed_prefix_t;
 
 namespace parser {
 	struct parse_tree_t;
@@ -74,6 +77,55 @@ compilation_unit_t make_compilation_unit(const std::string& source_code, const s
 
 semantic_ast_t compile_to_sematic_ast__errors(const compilation_unit_t& cu);
 
+
+
+////////////////////////////////		PREFIX CACHE
+
+/*
+	compile_to_sematic_ast__errors() analyses the prefix (corelib) once per process and also keeps it on
+	disk, so the next process loads it instead of parsing and analysing it again.
+	A cache file is keyed by the compiler version and the prefix source.
+*/
+
+//	Bump when the parser, the analyser or their JSON changes: cache files of other versions are ignored.
+extern const std::string k_compiler_version;
+
+//	$FLOYD_CACHE_DIR, else $HOME/.cache/floyd. "" means no disk cache.
+std::string get_prefix_cache_dir();
+
+std::string get_prefix_cache_path(const std::string& cache_dir, const std::string& prefix_source);
+
+//	Returns nullptr if there is no usable cache file.
+std::shared_ptr<const analysed_prefix_t> load_prefix_cache(const std::string& cache_dir, const std::string& prefix_source);
+
+//	Returns false if the file could not be written. Replaces the file atomically.
+bool save_prefix_cache(const std::string& cache_dir, const std::string& prefix_source, const analysed_prefix_t& prefix);
+
+
+
+////////////////////////////////		PHASE TIMES
+
+
+//	Wall-clock time of one compiler phase. "floyd compile -t" prints them.
+struct phase_time_t {
+	std::string phase;
+	int64_t ns;
+};
+
+//	Runs f() and records how long it took as phase.
+template <typename F> auto time_phase(std::vector<phase_time_t>& phase_times, const std::string& phase, F f) -> decltype(f()) {
+	const auto start = std::chrono::steady_clock::now();
+	auto result = f();
+	const auto end = std::chrono::steady_clock::now();
+	phase_times.push_back({ phase, std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() });
+	return result;
+}
+
+//	Same as compile_to_sematic_ast__errors() but records the time of each phase.
+semantic_ast_t compile_to_sematic_ast__errors(const compilation_unit_t& cu, std::vector<phase_time_t>& phase_times);
+
+void trace_phase_times(const std::vector<phase_time_t>& phase_times);
+
 }
 
 #endif /* compiler_helpers_hpp */
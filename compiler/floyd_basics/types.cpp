@@ -1569,35 +1569,104 @@ static type_node_t make_entry(const base_type& bt){
 	};
 }
 
+static void hash_combine(std::size_t& seed, std::size_t value){
+	seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+//	Hashes the fields used by operator==(type_node_t), except optional_name since node_index only holds unnamed nodes.
+static std::size_t hash_type_node(const type_node_t& node){
+	std::size_t result = std::hash<int>{}(static_cast<int>(node.bt));
+	for(const auto& e: node.child_types){
+		hash_combine(result, std::hash<int32_t>{}(e.get_data()));
+	}
+	for(const auto& e: node.struct_desc._members){
+		hash_combine(result, std::hash<int32_t>{}(e._type.get_data()));
+		hash_combine(result, std::hash<std::string>{}(e._name));
+	}
+	hash_combine(result, std::hash<int>{}(static_cast<int>(node.func_pure)));
+	hash_combine(result, std::hash<int>{}(static_cast<int>(node.func_return_dyn_type)));
+	hash_combine(result, std::hash<std::string>{}(node.identifier_str));
+	return result;
+}
+
+static std::size_t hash_type_name(const type_name_t& name){
+	std::size_t result = name.lexical_path.size();
+	for(const auto& e: name.lexical_path){
+		hash_combine(result, std::hash<std::string>{}(e));
+	}
+	return result;
+}
+
+static type_lookup_index_t find_indexed_node(const types_t& types, const type_node_t& node, std::size_t hash){
+	const auto range = types.node_index.equal_range(hash);
+	for(auto it = range.first ; it != range.second ; ++it){
+		if(types.nodes[it->second] == node){
+			return it->second;
+		}
+	}
+	return -1;
+}
+
+static type_lookup_index_t find_named_node(const types_t& types, const type_name_t& name){
+	const auto range = types.name_index.equal_range(hash_type_name(name));
+	for(auto it = range.first ; it != range.second ; ++it){
+		if(types.nodes[it->second].optional_name == name){
+			return it->second;
+		}
+	}
+	return -1;
+}
+
+//	Appends an unnamed node to nodes and indexes it. Returns its index.
+static type_lookup_index_t add_node(types_t& types, const type_node_t& node, std::size_t hash){
+	QUARK_ASSERT(is_empty_type_name(node.optional_name));
+
+	const auto index = static_cast<type_lookup_index_t>(types.nodes.size());
+	types.nodes.push_back(node);
+	types.node_index.insert({ hash, index });
+	return index;
+}
+
 types_t::types_t(){
 	//	Order is designed to match up the nodes[] with base_type indexes.
-	nodes.push_back(make_entry(base_type::k_undefined));
-	nodes.push_back(make_entry(base_type::k_any));
-	nodes.push_back(make_entry(base_type::k_void));
+	//	The placeholders for complex types are identical to k_undefined so they are not indexed:
+	//	interning k_undefined must find the first node.
+	const auto add = [&](const type_node_t& node){
+		const auto hash = hash_type_node(node);
+		if(find_indexed_node(*this, node, hash) == -1){
+			node_index.insert({ hash, static_cast<type_lookup_index_t>(nodes.size()) });
+		}
+		nodes.push_back(node);
+	};
+
+	add(make_entry(base_type::k_undefined));
+	add(make_entry(base_type::k_any));
+	add(make_entry(base_type::k_void));
 
 
-	nodes.push_back(make_entry(base_type::k_bool));
-	nodes.push_back(make_entry(base_type::k_int));
-	nodes.push_back(make_entry(base_type::k_double));
-	nodes.push_back(make_entry(base_type::k_string));
-	nodes.push_back(make_entry(base_type::k_json));
+	add(make_entry(base_type::k_bool));
+	add(make_entry(base_type::k_int));
+	add(make_entry(base_type::k_double));
+	add(make_entry(base_type::k_string));
+	add(make_entry(base_type::k_json));
 
-	nodes.push_back(make_entry(base_type::k_typeid));
+	add(make_entry(base_type::k_typeid));
 
 	//	These are complex types and are undefined. We need them to take up space in the nodes-vector.
-	nodes.push_back(make_entry(base_type::k_undefined));
-	nodes.push_back(make_entry(base_type::k_undefined));
-	nodes.push_back(make_entry(base_type::k_undefined));
-	nodes.push_back(make_entry(base_type::k_undefined));
+	add(make_entry(base_type::k_undefined));
+	add(make_entry(base_type::k_undefined));
+	add(make_entry(base_type::k_undefined));
+	add(make_entry(base_type::k_undefined));
 
-	nodes.push_back(make_entry(base_type::k_symbol_ref));
-	nodes.push_back(make_entry(base_type::k_undefined));
+	add(make_entry(base_type::k_symbol_ref));
+	add(make_entry(base_type::k_undefined));
 
 	QUARK_ASSERT(check_invariant());
 }
 
 bool types_t::check_invariant() const {
 	QUARK_ASSERT(nodes.size() < INT_MAX);
+	QUARK_ASSERT(node_index.size() + name_index.size() <= nodes.size());
 
 	QUARK_ASSERT(nodes[(type_lookup_index_t)base_type::k_undefined] == make_entry(base_type::k_undefined));
 	QUARK_ASSERT(nodes[(type_lookup_index_t)base_type::k_any] == make_entry(base_type::k_any));
@@ -1629,15 +1698,11 @@ bool types_t::check_invariant() const {
 
 static type_t lookup_node(const types_t& types, const type_node_t& node){
 	QUARK_ASSERT(types.check_invariant());
+	QUARK_ASSERT(is_empty_type_name(node.optional_name));
 
-	const auto it = std::find_if(
-		types.nodes.begin(),
-		types.nodes.end(),
-		[&](const auto& e){ return e == node; }
-	);
-
-	if(it != types.nodes.end()){
-		return lookup_type_from_index_it(types, it - types.nodes.begin());
+	const auto index = find_indexed_node(types, node, hash_type_node(node));
+	if(index != -1){
+		return lookup_type_from_index_it(types, index);
 	}
 	else{
 		throw std::exception();
@@ -1649,23 +1714,19 @@ static type_t lookup_node(const types_t& types, const type_node_t& node){
 
 static type_t intern_node(types_t& types, const type_node_t& node){
 	QUARK_ASSERT(types.check_invariant());
+	QUARK_ASSERT(is_empty_type_name(node.optional_name));
 
-	const auto it = std::find_if(
-		types.nodes.begin(),
-		types.nodes.end(),
-		[&](const auto& e){ return e == node; }
-	);
-
-	if(it != types.nodes.end()){
-		return lookup_type_from_index_it(types, it - types.nodes.begin());
+	const auto hash = hash_type_node(node);
+	const auto index = find_indexed_node(types, node, hash);
+	if(index != -1){
+		return lookup_type_from_index_it(types, index);
 	}
 
 	//	New type, store it.
 	else{
 
 		//	All child type are guaranteed to have types already since those are specified using types_t:s.
-		types.nodes.push_back(node);
-		return lookup_type_from_index_it(types, types.nodes.size() - 1);
+		return lookup_type_from_index_it(types, add_node(types, node, hash));
 	}
 }
 
@@ -1679,12 +1740,7 @@ type_t make_named_type(types_t& types, const type_name_t& n, const type_t& desti
 
 	if(false) trace_types(types);
 
-	const auto it = std::find_if(
-		types.nodes.begin(),
-		types.nodes.end(),
-		[&](const auto& e){ return e.optional_name == n; }
-	);
-	if(it != types.nodes.end()){
+	if(find_named_node(types, n) != -1){
 		throw std::exception();
 	}
 
@@ -1701,8 +1757,10 @@ type_t make_named_type(types_t& types, const type_name_t& n, const type_t& desti
 	QUARK_ASSERT(node.child_types.size() == 1);
 
 	//	Can't use intern_node() since we have a tag.
+	const auto index = static_cast<type_lookup_index_t>(types.nodes.size());
 	types.nodes.push_back(node);
-	return lookup_type_from_index_it(types, types.nodes.size() - 1);
+	types.name_index.insert({ hash_type_name(n), index });
+	return lookup_type_from_index_it(types, index);
 }
 
 type_t update_named_type(types_t& types, const type_t& named, const type_t& destination_type){
@@ -1727,16 +1785,12 @@ type_t lookup_type_from_name(const types_t& types, const type_name_t& tag){
 		throw std::exception();
 	}
 	else{
-		const auto it = std::find_if(
-			types.nodes.begin(),
-			types.nodes.end(),
-			[&](const auto& e){ return e.optional_name == tag; }
-		);
-		if(it == types.nodes.end()){
+		const auto index = find_named_node(types, tag);
+		if(index == -1){
 			throw std::exception();
 		}
 
-		return lookup_type_from_index_it(types, it - types.nodes.begin());
+		return lookup_type_from_index_it(types, index);
 	}
 }
 
@@ -1770,6 +1824,25 @@ type_desc_t peek2(const types_t& types, const type_t& type){
 }
 
 
+collection_backend get_collection_backend(const types_t& types, const type_t& type){
+	QUARK_ASSERT(types.check_invariant());
+	QUARK_ASSERT(type.check_invariant());
+
+	const auto& info = lookup_typeinfo_from_type(types, peek0(types, type));
+	QUARK_ASSERT(info.bt == base_type::k_vector || info.bt == base_type::k_dict);
+	return info.backend;
+}
+
+void set_collection_backend(types_t& types, const type_t& type, collection_backend backend){
+	QUARK_ASSERT(types.check_invariant());
+	QUARK_ASSERT(type.check_invariant());
+
+	auto& info = lookup_typeinfo_from_type(types, peek0(types, type));
+	QUARK_ASSERT(info.bt == base_type::k_vector || info.bt == base_type::k_dict);
+	info.backend = backend;
+}
+
+
 
 type_t refresh_type(const types_t& types, const type_t& type){
 	const auto lookup_index = type.get_lookup_index();
@@ -2363,40 +2436,87 @@ type_t make_symbol_ref(types_t& types, const std::string& s){
 }
 
 
-//??? Doesnt work. Needs to use type_t-style code that genreates contents of type
+//	Each entry holds the node's exact fields, with child types as their type_t data, so types_from_json()
+//	rebuilds the same nodes at the same indexes and type_t:s stored elsewhere stay valid. "desc" is for humans.
 json_t types_to_json(const types_t& types){
 	std::vector<json_t> result;
 	for(auto i = 0 ; i < types.nodes.size() ; i++){
 		const auto& type = lookup_type_from_index(types, i);
 
 		const auto& e = types.nodes[i];
-		const auto tag = pack_type_name(e.optional_name);
-		const auto desc = type_to_json(types, type);
+		std::vector<json_t> children;
+		for(const auto& c: e.child_types){
+			children.push_back(json_t(c.get_data()));
+		}
+		std::vector<json_t> members;
+		for(const auto& m: e.struct_desc._members){
+			members.push_back(json_t::make_array({ json_t(m._name), json_t(m._type.get_data()) }));
+		}
 		const auto x = json_t::make_object({
-			{ "tag", tag },
-			{ "desc", desc }
+			{ "tag", pack_type_name(e.optional_name) },
+			{ "desc", type_to_json(types, type) },
+			{ "bt", json_t(static_cast<int>(e.bt)) },
+			{ "children", json_t::make_array(children) },
+			{ "members", json_t::make_array(members) },
+			{ "pure", json_t(e.func_pure == epure::pure) },
+			{ "dyn", json_t(static_cast<int>(e.func_return_dyn_type)) },
+			{ "identifier", json_t(e.identifier_str) },
+			{ "backend", json_t(static_cast<int>(e.backend)) }
 		});
 		result.push_back(x);
 	}
-
-	//??? support tags!
 	return result;
 }
 
+static type_node_t type_node_from_json(const json_t& j){
+	std::vector<type_t> children;
+	for(const auto& c: j.get_object_element("children").get_array()){
+		children.push_back(type_t(static_cast<int32_t>(c.get_number())));
+	}
+	std::vector<member_t> members;
+	for(const auto& m: j.get_object_element("members").get_array()){
+		members.push_back(member_t(type_t(static_cast<int32_t>(m.get_array_n(1).get_number())), m.get_array_n(0).get_string()));
+	}
+	auto result = type_node_t{
+		unpack_type_name(j.get_object_element("tag").get_string()),
+		static_cast<base_type>(static_cast<int>(j.get_object_element("bt").get_number())),
+		children,
+		struct_type_desc_t(members),
+		j.get_object_element("pure").is_true() ? epure::pure : epure::impure,
+		static_cast<return_dyn_type>(static_cast<int>(j.get_object_element("dyn").get_number())),
+		j.get_object_element("identifier").get_string()
+	};
+	result.backend = static_cast<collection_backend>(static_cast<int>(j.get_object_element("backend").get_number()));
+	return result;
+}
 
-//??? Doesnt work. Needs to use type_t-style code that genreates contents of type
-//??? support tags!
+//	Throws if the JSON doesn't start with the same base nodes as types_t().
 types_t types_from_json(const json_t& j){
 	types_t types;
-	for(const auto& t: j.get_array()){
-		const auto tag = t.get_object_element("tag").get_string();
-		const auto desc = t.get_object_element("desc");
+	const auto base_count = types.nodes.size();
+	const auto& entries = j.get_array();
+	if(entries.size() < base_count){
+		throw std::runtime_error("Types JSON is missing base types.");
+	}
 
-		const auto tag2 = unpack_type_name(tag);
-		const auto type2 = type_from_json(types, desc);
-		(void)type2;
-//		types.push_back(type_node_t { tag2, type2 });
+	for(auto i = 0 ; i < entries.size() ; i++){
+		const auto node = type_node_from_json(entries[i]);
+		if(i < base_count){
+			if(!(types.nodes[i] == node)){
+				throw std::runtime_error("Types JSON has different base types.");
+			}
+		}
+		else if(is_empty_type_name(node.optional_name)){
+			add_node(types, node, hash_type_node(node));
+		}
+		else{
+			const auto index = static_cast<type_lookup_index_t>(types.nodes.size());
+			types.nodes.push_back(node);
+			types.name_index.insert({ hash_type_name(node.optional_name), index });
+		}
 	}
+
+	QUARK_ASSERT(types.check_invariant());
 	return types;
 }
 
@@ -2580,6 +2700,58 @@ QUARK_TEST("Types", "update_named_type()", "", ""){
 	QUARK_ASSERT(is_wellformed(types, b));
 }
 
+QUARK_TEST("Types", "set_collection_backend()", "named vector", "backend is stored on the vector, type identity is unchanged"){
+	types_t types;
+	const auto v = make_vector(types, type_t::make_int());
+	const auto named = make_named_type(types, unpack_type_name("/a/v"), v);
+	QUARK_VERIFY(get_collection_backend(types, v) == collection_backend::k_unspecified);
+
+	set_collection_backend(types, named, collection_backend::k_carray);
+	QUARK_VERIFY(get_collection_backend(types, v) == collection_backend::k_carray);
+	QUARK_VERIFY(make_vector(types, type_t::make_int()) == v);
+}
+
+QUARK_TEST("Types", "intern_node()", "many types", "each type is stored once and found again"){
+	types_t types;
+	const auto count0 = types.nodes.size();
+	std::vector<type_t> structs;
+	for(int i = 0 ; i < 500 ; i++){
+		const auto s = make_struct(types, struct_type_desc_t( { member_t(type_t::make_int(), "m" + std::to_string(i)) } ));
+		make_vector(types, s);
+		make_named_type(types, type_name_t{ { "a", std::to_string(i) } }, s);
+		structs.push_back(s);
+	}
+	QUARK_VERIFY(types.nodes.size() == count0 + 500 * 3);
+
+	for(int i = 0 ; i < 500 ; i++){
+		QUARK_VERIFY(make_struct(types, struct_type_desc_t( { member_t(type_t::make_int(), "m" + std::to_string(i)) } )) == structs[i]);
+		QUARK_VERIFY(peek0(types, lookup_type_from_name(types, type_name_t{ { "a", std::to_string(i) } })) == structs[i]);
+	}
+	QUARK_VERIFY(types.nodes.size() == count0 + 500 * 3);
+}
+
+QUARK_TEST("Types", "types_from_json()", "types_to_json() as text", "same nodes at same indexes, indexes work"){
+	types_t types;
+	const auto s = make_struct(types, struct_type_desc_t( { member_t(type_t::make_int(), "a"), member_t(type_t::make_string(), "b") } ));
+	const auto v = make_vector(types, s);
+	const auto named = make_named_type(types, unpack_type_name("/p/v"), make_undefined());
+	update_named_type(types, named, v);
+	set_collection_backend(types, v, collection_backend::k_hamt);
+	const auto f = make_function(types, named, { type_t::make_double(), make_dict(types, type_t::make_bool()) }, epure::impure);
+
+	const auto text = json_to_compact_string(types_to_json(types));
+	const auto types2 = types_from_json(parse_json(seq_t(text)).first);
+
+	QUARK_VERIFY(types2.nodes == types.nodes);
+	QUARK_VERIFY(get_collection_backend(types2, v) == collection_backend::k_hamt);
+	QUARK_VERIFY(lookup_type_from_name(types2, unpack_type_name("/p/v")) == named);
+	QUARK_VERIFY(make_function(types2, named, { type_t::make_double(), make_dict(types2, type_t::make_bool()) }, epure::impure) == f);
+
+	auto types3 = types2;
+	QUARK_VERIFY(make_vector(types3, s) == v);
+	QUARK_VERIFY(types3.nodes.size() == types.nodes.size());
+}
+
 
 
 }	// floyd
@@ -107,6 +107,7 @@ Use read_type(), read_required_type()
 #include <string>
 #include <vector>
 #include <variant>
+#include <unordered_map>
 
 struct json_t;
 
@@ -875,6 +876,24 @@ std::vector<member_t> members_from_json(types_t& types, const json_t& members);
 
 
 
+//////////////////////////////////////////////////		collection_backend
+
+
+/*
+	The runtime representation picked for a vector or dict type by select_collection_backends().
+	It is only honoured when config_t asks for per-type backends.
+*/
+enum class collection_backend : uint8_t {
+	k_unspecified,
+
+	k_carray,
+	k_hamt,
+	k_cppmap,
+	k_hashtable
+};
+
+
+
 //////////////////////////////////////////////////		type_node_t
 
 
@@ -903,6 +922,10 @@ struct type_node_t {
 	return_dyn_type func_return_dyn_type;
 
 	std::string identifier_str;
+
+	//	Only used when bt == k_vector or k_dict. Not part of the type's identity: vector[int] is the same type
+	//	whatever its backend, so all values of a type share one representation and never need converting.
+	collection_backend backend = collection_backend::k_unspecified;
 };
 
 inline bool operator==(const type_node_t& lhs, const type_node_t& rhs){
@@ -935,6 +958,13 @@ struct types_t {
 	//	All types are recorded here, an uniqued. Including named types.
 	//	type uses the INDEX into this array for fast lookups.
 	std::vector<type_node_t> nodes;
+
+	//	Hash indexes into nodes, so interning and name lookups don't need to scan all nodes.
+	//	Key is the hash, value is the index into nodes. Hashes can collide: compare the node itself.
+	//	Only updated when adding nodes: node_index only holds unnamed nodes and name_index only named nodes,
+	//	the fields that update_named_type() and set_collection_backend() change are not hashed.
+	std::unordered_multimap<std::size_t, type_lookup_index_t> node_index;
+	std::unordered_multimap<std::size_t, type_lookup_index_t> name_index;
 };
 
 
@@ -969,6 +999,10 @@ type_t update_named_type(types_t& types, const type_t& named, const type_t& dest
 type_t peek0(const types_t& types, const type_t& type);
 type_desc_t peek2(const types_t& types, const type_t& type);
 
+//	Follows named types. type must be a vector or a dict.
+collection_backend get_collection_backend(const types_t& types, const type_t& type);
+void set_collection_backend(types_t& types, const type_t& type, collection_backend backend);
+
 
 //	Is this type instantiatable: it uses no symbols and uses no undefined. Deep and follows named types.
 bool is_wellformed(const types_t& types, const type_t& t);
@@ -25,51 +25,51 @@ namespace floyd {
 
 namespace parser {
 
-std::pair<json_t, seq_t> parse_prefixless_statement(const seq_t& s);
+std::pair<parse_node_index_t, text_cursor_t> parse_prefixless_statement(parse_tree_t& tree, const text_cursor_t& s);
 
 
-std::pair<json_t, seq_t> parse_statement(const seq_t& s){
+std::pair<parse_node_index_t, text_cursor_t> parse_statement(parse_tree_t& tree, const text_cursor_t& s){
 	const auto pos = skip_whitespace(s);
 	try {
 		if(is_first(pos, "{")){
-			return parse_block(pos);
+			return parse_block(tree, pos);
 		}
 		else if(is_first(pos, keyword_t::k_return)){
-			return parse_return_statement(pos);
+			return parse_return_statement(tree, pos);
 		}
 		else if(is_first(pos, keyword_t::k_struct)){
-			return parse_struct_definition_statement(pos);
+			return parse_struct_definition_statement(tree, pos);
 		}
 		else if(is_first(pos, keyword_t::k_if)){
-			return  parse_if_statement(pos);
+			return  parse_if_statement(tree, pos);
 		}
 		else if(is_first(pos, keyword_t::k_for)){
-			return parse_for_statement(pos);
+			return parse_for_statement(tree, pos);
 		}
 		else if(is_first(pos, keyword_t::k_while)){
-			return parse_while_statement(pos);
+			return parse_while_statement(tree, pos);
 		}
 		else if(is_first(pos, keyword_t::k_func)){
-			return parse_function_definition_statement(pos);
+			return parse_function_definition_statement(tree, pos);
 		}
 		else if(is_first(pos, keyword_t::k_let)){
-			return parse_bind_statement(pos);
+			return parse_bind_statement(tree, pos);
 		}
 		else if(is_first(pos, keyword_t::k_mutable)){
-			return parse_bind_statement(pos);
+			return parse_bind_statement(tree, pos);
 		}
 		else if(is_first(pos, keyword_t::k_software_system)){
-			return parse_software_system_def_statement(pos);
+			return parse_software_system_def_statement(tree, pos);
 		}
 		else if(is_first(pos, keyword_t::k_container_def)){
-			return parse_container_def_statement(pos);
+			return parse_container_def_statement(tree, pos);
 		}
 		else if(is_first(pos, keyword_t::k_benchmark_def)){
-			return parse_benchmark_def_statement(pos);
+			return parse_benchmark_def_statement(tree, pos);
 		}
 		else {
 			//	k_assign and k_expression_statement has no prefix, we need to figure out if it's one of those.
-			return parse_prefixless_statement(pos);
+			return parse_prefixless_statement(tree, pos);
 		}
 	}
 
@@ -93,14 +93,14 @@ std::pair<json_t, seq_t> parse_statement(const seq_t& s){
 
 QUARK_TEST("", "parse_statement()", "", ""){
 	ut_verify(QUARK_POS,
-		parse_statement(seq_t("let int x = 10;")).first,
+		ut_parse(parse_statement, text_cursor_t("let int x = 10;")).first,
 		parse_json(seq_t(R"([0, "init-local", "int", "x", ["k", 10, "int"]])")).first
 	);
 }
 
 QUARK_TEST("", "parse_statement()", "", ""){
 	ut_verify(QUARK_POS,
-		parse_statement(seq_t("func int f(string name){ return 13; }")).first,
+		ut_parse(parse_statement, text_cursor_t("func int f(string name){ return 13; }")).first,
 		parse_json(seq_t(R"(
 			[
 				0,
@@ -121,19 +121,19 @@ QUARK_TEST("", "parse_statement()", "", ""){
 
 QUARK_TEST("", "parse_statement()", "", ""){
 	ut_verify(QUARK_POS,
-		parse_statement(seq_t("let int x = f(3);")).first,
+		ut_parse(parse_statement, text_cursor_t("let int x = f(3);")).first,
 		parse_json(seq_t(R"([0, "init-local", "int", "x", ["call", ["@", "f"], [["k", 3, "int"]]]])")).first
 	);
 }
 
 
-parse_result_t parse_statements_no_brackets(const seq_t& s){
-	std::vector<json_t> statements;
+parse_result_t parse_statements_no_brackets(parse_tree_t& tree, const text_cursor_t& s){
+	std::vector<parse_node_index_t> statements;
 
 	auto pos = skip_whitespace(s);
 
 	while(pos.empty() == false){
-		const auto statement_pos = parse_statement(pos);
+		const auto statement_pos = parse_statement(tree, pos);
 		QUARK_ASSERT(statement_pos.second.pos() >= pos.pos());
 
 		statements.push_back(statement_pos.first);
@@ -149,19 +149,19 @@ parse_result_t parse_statements_no_brackets(const seq_t& s){
 		QUARK_ASSERT(pos2.pos() >= pos.pos());
 		pos = pos2;
 	}
-	return { statements, pos };
+	return { add_list(tree, statements), pos };
 }
 
 //	"{ a = 1; print(a) }"
-parse_result_t parse_statements_bracketted(const seq_t& s){
-	std::vector<json_t> statements;
+parse_result_t parse_statements_bracketted(parse_tree_t& tree, const text_cursor_t& s){
+	std::vector<parse_node_index_t> statements;
 
 	auto pos = skip_whitespace(s);
 	pos = read_required(pos, "{");
 	pos = skip_whitespace(pos);
 
 	while(pos.empty() == false && pos.first() != "}"){
-		const auto statement_pos = parse_statement(pos);
+		const auto statement_pos = parse_statement(tree, pos);
 		QUARK_ASSERT(statement_pos.second.pos() >= pos.pos());
 
 		statements.push_back(statement_pos.first);
@@ -178,7 +178,7 @@ parse_result_t parse_statements_bracketted(const seq_t& s){
 		pos = pos2;
 	}
 	if(pos.first() == "}"){
-		return { statements, pos.rest() };
+		return { add_list(tree, statements), pos.rest() };
 	}
 	else{
 		throw_compiler_error_nopos("Block is missing end bracket \'}\'.");
@@ -187,7 +187,7 @@ parse_result_t parse_statements_bracketted(const seq_t& s){
 
 QUARK_TEST("", "parse_statements_bracketted()", "", ""){
 	ut_verify(QUARK_POS,
-		parse_statement_body(seq_t(" { } ")).parse_tree,
+		ut_parse(parse_statement_body, text_cursor_t(" { } ")).first,
 		parse_json(seq_t(
 			R"(
 				[]
@@ -197,7 +197,7 @@ QUARK_TEST("", "parse_statements_bracketted()", "", ""){
 }
 QUARK_TEST("", "parse_statements_bracketted()", "", ""){
 	ut_verify(QUARK_POS,
-		parse_statement_body(seq_t(" { let int x = 1; let int y = 2; } ")).parse_tree,
+		ut_parse(parse_statement_body, text_cursor_t(" { let int x = 1; let int y = 2; } ")).first,
 		parse_json(seq_t(
 			R"(
 				[
@@ -209,28 +209,36 @@ QUARK_TEST("", "parse_statements_bracketted()", "", ""){
 	);
 }
 
-void check_illegal_chars(const seq_t& p){
-	const auto illegal_char = read_while(p, k_valid_expression_chars);
-	const auto pos = illegal_char.first.size();
+void check_illegal_chars(const text_cursor_t& p){
+	const auto pos = skip(p, k_valid_expression_chars).pos() - p.pos();
 	if(pos < p.size()){
-		throw_compiler_error(location_t(pos), "Illegal characters.");
+		throw_compiler_error(location_t(p.pos() + pos), "Illegal characters.");
 	}
 }
 
 parse_tree_t parse_program2(const std::string& program){
+	return parse_program2(program, 0, types_t());
+}
+
+parse_tree_t parse_program2(const std::string& source, std::size_t start, const types_t& types){
+	QUARK_ASSERT(start <= source.size());
+	QUARK_ASSERT(types.check_invariant());
+
 	try {
-		const auto pos = seq_t(program);
+		const auto pos = text_cursor_t(source).rest(start);
 		check_illegal_chars(pos);
 
-		const auto statements_pos = parse_statements_no_brackets(pos);
-		const auto p = parse_tree_t{ statements_pos.parse_tree };
+		parse_tree_t tree;
+		tree.types = types;
+		tree.statements = parse_statements_no_brackets(tree, pos).statements;
+		QUARK_ASSERT(tree.check_invariant());
 
 		if(k_trace_parse_tree_flag){
 			QUARK_SCOPED_TRACE("Parser tree output");
-			QUARK_TRACE(json_to_pretty_string(p._value));
+			QUARK_TRACE(json_to_pretty_string(parse_tree_to_json(tree)));
 		}
 
-		return p;
+		return tree;
 	}
 	catch(const compiler_error& e){
 		const auto what = e.what();
@@ -254,11 +262,19 @@ const std::string k_test_program_0_parserout = R"(
 
 QUARK_TEST("", "parse_program2()", "k_test_program_0_source", ""){
 	ut_verify(QUARK_POS,
-		parse_program2(k_test_program_0_source)._value,
+		parse_tree_to_json(parse_program2(k_test_program_0_source)),
 		parse_json(seq_t(k_test_program_0_parserout)).first
 	);
 }
 
+QUARK_TEST("", "parse_program2()", "start after prefix", "locations are offsets into the whole source"){
+	const std::string source = "let int a = 1\nlet int b = 2";
+	ut_verify(QUARK_POS,
+		parse_tree_to_json(parse_program2(source, 14, types_t())),
+		parse_json(seq_t(R"([[14, "init-local", "int", "b", ["k", 2, "int"]]])")).first
+	);
+}
+
 const std::string k_test_program_1_source =
 	"func int main(string args){\n"
 	"	return 3;\n"
@@ -283,7 +299,7 @@ const std::string k_test_program_1_parserout = R"(
 
 QUARK_TEST("", "parse_program2()", "k_test_program_1_source", ""){
 	ut_verify(QUARK_POS,
-		parse_program2(k_test_program_1_source)._value,
+		parse_tree_to_json(parse_program2(k_test_program_1_source)),
 		parse_json(seq_t(k_test_program_1_parserout)).first
 	);
 }
@@ -337,7 +353,7 @@ const char k_test_program_100_parserout[] = R"(
 
 QUARK_TEST("", "parse_program2()", "k_test_program_100_source", ""){
 	ut_verify(QUARK_POS,
-		parse_program2(
+		parse_tree_to_json(parse_program2(
 			R"(
 				struct pixel { double red; double green; double blue; }
 				func double get_grey(pixel p){ return (p.red + p.green + p.blue) / 3.0; }
@@ -347,7 +363,7 @@ QUARK_TEST("", "parse_program2()", "k_test_program_100_source", ""){
 					return get_grey(p);
 				}
 			)"
-		)._value,
+		)),
 		parse_json(seq_t(k_test_program_100_parserout)).first
 	);
 }
@@ -362,7 +378,7 @@ enum class implicit_statement {
 	k_assign
 };
 
-bool is_identifier_and_equal(const seq_t& s){
+bool is_identifier_and_equal(const text_cursor_t& s){
 	const auto identifier_fr = read_identifier(s);
 	const auto next_seq = skip_whitespace(identifier_fr.second);
 	if(identifier_fr.first.empty() == false && next_seq.first1() == "="){
@@ -373,7 +389,7 @@ bool is_identifier_and_equal(const seq_t& s){
 	}
 }
 
-static implicit_statement detect_implicit_statement_lookahead(const seq_t& s){
+static implicit_statement detect_implicit_statement_lookahead(const text_cursor_t& s){
 	if(is_identifier_and_equal(s)){
 		return implicit_statement::k_assign;
 	}
@@ -403,56 +419,56 @@ static implicit_statement detect_implicit_statement_lookahead(const seq_t& s){
 #define DETECT_TEST QUARK_TEST
 
 DETECT_TEST("", "detect_implicit_statement_lookahead()", "", "ERROR"){
-	QUARK_ASSERT(detect_implicit_statement_lookahead(seq_t(R"(	int test = 123 xyz	)")) == implicit_statement::k_error);
+	QUARK_ASSERT(detect_implicit_statement_lookahead(text_cursor_t(R"(	int test = 123 xyz	)")) == implicit_statement::k_error);
 }
 
 DETECT_TEST("", "detect_implicit_statement_lookahead()", "", "EXPRESSION-STATEMENT"){
-	QUARK_VERIFY(detect_implicit_statement_lookahead(seq_t(R"(	print("B:" + to_string(x))	{ print(3) int x = 4 } xyz	)")) == implicit_statement::k_expression_statement);
+	QUARK_VERIFY(detect_implicit_statement_lookahead(text_cursor_t(R"(	print("B:" + to_string(x))	{ print(3) int x = 4 } xyz	)")) == implicit_statement::k_expression_statement);
 }
 DETECT_TEST("", "detect_implicit_statement_lookahead()", "", "EXPRESSION-STATEMENT"){
-	QUARK_VERIFY(detect_implicit_statement_lookahead(seq_t(R"(	print(3) int x = 4	xyz	)")) == implicit_statement::k_expression_statement);
+	QUARK_VERIFY(detect_implicit_statement_lookahead(text_cursor_t(R"(	print(3) int x = 4	xyz	)")) == implicit_statement::k_expression_statement);
 }
 
 
 DETECT_TEST("", "detect_implicit_statement_lookahead()", "", "EXPRESSION-STATEMENT"){
-	QUARK_VERIFY(detect_implicit_statement_lookahead(seq_t(" print ( \"Hello, World!\" )		xyz")) == implicit_statement::k_expression_statement);
-	QUARK_VERIFY(detect_implicit_statement_lookahead(seq_t(R"( print ( "Hello, World!" )		xyz)")) == implicit_statement::k_expression_statement);
+	QUARK_VERIFY(detect_implicit_statement_lookahead(text_cursor_t(" print ( \"Hello, World!\" )		xyz")) == implicit_statement::k_expression_statement);
+	QUARK_VERIFY(detect_implicit_statement_lookahead(text_cursor_t(R"( print ( "Hello, World!" )		xyz)")) == implicit_statement::k_expression_statement);
 }
 DETECT_TEST("", "detect_implicit_statement_lookahead()", "", "EXPRESSION-STATEMENT"){
-	QUARK_VERIFY(detect_implicit_statement_lookahead(seq_t("print(\"Hello, World!\")		xyz")) == implicit_statement::k_expression_statement);
-	QUARK_VERIFY(detect_implicit_statement_lookahead(seq_t(R"(print("Hello, World!")		xyz)")) == implicit_statement::k_expression_statement);
+	QUARK_VERIFY(detect_implicit_statement_lookahead(text_cursor_t("print(\"Hello, World!\")		xyz")) == implicit_statement::k_expression_statement);
+	QUARK_VERIFY(detect_implicit_statement_lookahead(text_cursor_t(R"(print("Hello, World!")		xyz)")) == implicit_statement::k_expression_statement);
 }
 DETECT_TEST("", "detect_implicit_statement_lookahead()", "", "EXPRESSION-STATEMENT"){
-	QUARK_VERIFY(detect_implicit_statement_lookahead(seq_t(R"(     print("/Desktop/test_out.txt")		xyz)")) == implicit_statement::k_expression_statement);
+	QUARK_VERIFY(detect_implicit_statement_lookahead(text_cursor_t(R"(     print("/Desktop/test_out.txt")		xyz)")) == implicit_statement::k_expression_statement);
 }
 DETECT_TEST("", "detect_implicit_statement_lookahead()", "", "EXPRESSION-STATEMENT"){
-	QUARK_VERIFY(detect_implicit_statement_lookahead(seq_t("print(3)		xyz")) == implicit_statement::k_expression_statement);
+	QUARK_VERIFY(detect_implicit_statement_lookahead(text_cursor_t("print(3)		xyz")) == implicit_statement::k_expression_statement);
 }
 DETECT_TEST("", "detect_implicit_statement_lookahead()", "", "EXPRESSION-STATEMENT"){
-	QUARK_VERIFY(detect_implicit_statement_lookahead(seq_t("3		xyz")) == implicit_statement::k_expression_statement);
+	QUARK_VERIFY(detect_implicit_statement_lookahead(text_cursor_t("3		xyz")) == implicit_statement::k_expression_statement);
 }
 DETECT_TEST("", "detect_implicit_statement_lookahead()", "", "EXPRESSION-STATEMENT"){
-	QUARK_VERIFY(detect_implicit_statement_lookahead(seq_t("3 + 4		xyz")) == implicit_statement::k_expression_statement);
+	QUARK_VERIFY(detect_implicit_statement_lookahead(text_cursor_t("3 + 4		xyz")) == implicit_statement::k_expression_statement);
 }
 DETECT_TEST("", "detect_implicit_statement_lookahead()", "", "EXPRESSION-STATEMENT"){
-	QUARK_VERIFY(detect_implicit_statement_lookahead(seq_t("3 + f(1) + f(2)		xyz")) == implicit_statement::k_expression_statement);
+	QUARK_VERIFY(detect_implicit_statement_lookahead(text_cursor_t("3 + f(1) + f(2)		xyz")) == implicit_statement::k_expression_statement);
 }
 
 
 DETECT_TEST("", "detect_implicit_statement_lookahead()", "", "assign"){
-	QUARK_VERIFY(detect_implicit_statement_lookahead(seq_t(" x = 10		xyz")) == implicit_statement::k_assign);
+	QUARK_VERIFY(detect_implicit_statement_lookahead(text_cursor_t(" x = 10		xyz")) == implicit_statement::k_assign);
 }
 DETECT_TEST("", "detect_implicit_statement_lookahead()", "", "assign"){
-	QUARK_VERIFY(detect_implicit_statement_lookahead(seq_t(" x = \"hello\"		xyz")) == implicit_statement::k_assign);
+	QUARK_VERIFY(detect_implicit_statement_lookahead(text_cursor_t(" x = \"hello\"		xyz")) == implicit_statement::k_assign);
 }
 DETECT_TEST("", "detect_implicit_statement_lookahead()", "", "assign"){
-	QUARK_VERIFY(detect_implicit_statement_lookahead(seq_t(" x = f ( 3 ) == 2		xyz")) == implicit_statement::k_assign);
+	QUARK_VERIFY(detect_implicit_statement_lookahead(text_cursor_t(" x = f ( 3 ) == 2		xyz")) == implicit_statement::k_assign);
 }
 DETECT_TEST("", "detect_implicit_statement_lookahead()", "vector", "assign"){
-	QUARK_VERIFY(detect_implicit_statement_lookahead(seq_t("a = [1,2,3]		xyz")) == implicit_statement::k_assign);
+	QUARK_VERIFY(detect_implicit_statement_lookahead(text_cursor_t("a = [1,2,3]		xyz")) == implicit_statement::k_assign);
 }
 DETECT_TEST("", "detect_implicit_statement_lookahead()", "dict", "assign"){
-	QUARK_VERIFY(detect_implicit_statement_lookahead(seq_t(R"(a = {"uno": 1, "duo": 2}		xyz)")) == implicit_statement::k_assign);
+	QUARK_VERIFY(detect_implicit_statement_lookahead(text_cursor_t(R"(a = {"uno": 1, "duo": 2}		xyz)")) == implicit_statement::k_assign);
 }
 
 /*
@@ -461,14 +477,14 @@ DETECT_TEST("", "detect_implicit_statement_lookahead()", "dict", "assign"){
 	or
 	EXPRESSION, like "print(3)"
 */
-std::pair<json_t, seq_t> parse_prefixless_statement(const seq_t& s){
+std::pair<parse_node_index_t, text_cursor_t> parse_prefixless_statement(parse_tree_t& tree, const text_cursor_t& s){
 	const auto pos = skip_whitespace(s);
 	const auto implicit_type = detect_implicit_statement_lookahead(pos);
 	if(implicit_type == implicit_statement::k_expression_statement){
-		return parse_expression_statement(pos);
+		return parse_expression_statement(tree, pos);
 	}
 	else if(implicit_type == implicit_statement::k_assign){
-		return parse_assign_statement(pos);
+		return parse_assign_statement(tree, pos);
 	}
 	else{
 		throw_compiler_error_nopos("Use 'mutable' or 'let' syntax.");
@@ -478,7 +494,7 @@ std::pair<json_t, seq_t> parse_prefixless_statement(const seq_t& s){
 /*
 QUARK_TEST("", "parse_prefixless_statement()", "", ""){
 	ut_verify(QUARK_POS,
-		parse_prefixless_statement(seq_t("x = f(3);")).first._value,
+		parse_prefixless_statement(text_cursor_t("x = f(3);")).first._value,
 		parse_json(seq_t(R"(["init-local", "int", "x", ["call", ["@", "f"], [["k", 3, "int"]]]])")).first
 	);
 }
@@ -3,17 +3,17 @@
 #define floyd_parser_h
 
 /*
-	Converts source code text to a parse tree, encoded in a JSON.
+	Converts source code text to a parse tree, see parse_tree.h.
 	Not much validation is going on, except the syntax itself.
 	Result may contain unresolvable references to indentifers, illegal names etc.
 */
 
 #include "quark.h"
-#include "json_support.h"
+#include "parse_tree.h"
 
 #include <string>
 
-struct seq_t;
+struct text_cursor_t;
 
 namespace floyd {
 namespace parser {
@@ -22,28 +22,22 @@ struct parse_result_t;
 
 
 
-////////////////////////////////		parse_tree_t
-
-//	Holds a complete program, as a JSON-array with one element per statement.
-
-struct parse_tree_t {
-	json_t _value;
-};
-
-
-
 //	"a = 1; print(a)"
-//	Returns array of statements.
-parse_result_t parse_statements_no_brackets(const seq_t& s);
+//	Returns list of statements.
+parse_result_t parse_statements_no_brackets(parse_tree_t& tree, const text_cursor_t& s);
 
 //	"{ a = 1; print(a) }"
-//	Returns array of statements.
-parse_result_t parse_statements_bracketted(const seq_t& s);
+//	Returns list of statements.
+parse_result_t parse_statements_bracketted(parse_tree_t& tree, const text_cursor_t& s);
 
 
-//	returns json-array of statements.
+//	Returns the complete program, parse_tree_t::statements holds its top level statements.
 parse_tree_t parse_program2(const std::string& program);
 
+//	Parses source from offset start, into a tree whose types start as a copy of types. Locations are
+//	offsets into source. Used to parse a program after a prefix that has already been analysed.
+parse_tree_t parse_program2(const std::string& source, std::size_t start, const types_t& types);
+
 }	// parser
 }	//	floyd
 
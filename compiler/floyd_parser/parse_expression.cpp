@@ -43,17 +43,13 @@ QUARK_TEST("parser", "C++ enum class()", "", ""){
 }
 
 
-std::pair<json_t, seq_t> parse_expression_deep(const seq_t& p, const eoperator_precedence precedence);
+std::pair<parse_node_index_t, text_cursor_t> parse_expression_deep(parse_tree_t& tree, const text_cursor_t& p, const eoperator_precedence precedence);
 
 
 
 
 
 
-std::string expr_to_string(const json_t& e){
-	return json_to_compact_string(e);
-}
-
 /*
 	()
 	(100)
@@ -64,44 +60,25 @@ std::string expr_to_string(const json_t& e){
 	["one": 1000, "two": 2000]
 */
 struct collection_element_t {
-	std::shared_ptr<json_t> _key;
-	json_t _value;
+	//	k_no_parse_node if the element has no key.
+	parse_node_index_t _key;
+	parse_node_index_t _value;
 };
 
-bool operator==(const collection_element_t& lhs, const collection_element_t& rhs){
-	return compare_shared_values(lhs._key, rhs._key)
-	&& lhs._value == rhs._value;
-}
-
-
 struct collection_def_t {
 	bool _has_keys;
 	std::vector<collection_element_t> _elements;
 };
 
-bool operator==(const collection_def_t& lhs, const collection_def_t& rhs){
-	return
-		lhs._has_keys == rhs._has_keys
-		&& lhs._elements == rhs._elements;
-}
-std::vector<json_t> get_values(const collection_def_t& c){
-	std::vector<json_t> result;
+std::vector<parse_node_index_t> get_values(const collection_def_t& c){
+	std::vector<parse_node_index_t> result;
 	for(const auto& e: c._elements){
 		result.push_back(e._value);
 	}
 	return result;
 }
 
-void ut_verify_collection(const quark::call_context_t& context, const std::pair<collection_def_t, seq_t> result, const std::pair<collection_def_t, seq_t> expected){
-	if(result == expected){
-	}
-	else{
-		quark::fail_test(context);
-	}
-}
-
-//	???	Return json_t directly, no need for collection_def_t-type.
-std::pair<collection_def_t, seq_t> parse_bounded_list(const seq_t& s, const std::string& start_char, const std::string& end_char){
+std::pair<collection_def_t, text_cursor_t> parse_bounded_list(parse_tree_t& tree, const text_cursor_t& s, const std::string& start_char, const std::string& end_char){
 	QUARK_ASSERT(s.check_invariant());
 	QUARK_ASSERT(s.first() == start_char);
 	QUARK_ASSERT(start_char.size() == 1);
@@ -123,101 +100,85 @@ std::pair<collection_def_t, seq_t> parse_bounded_list(const seq_t& s, const std:
 	else{
 		collection_def_t result{false, {}};
 		while(pos.first1() != end_char){
-			const auto expression_pos = parse_expression_deep(pos, eoperator_precedence::k_super_weak);
+			const auto expression_pos = parse_expression_deep(tree, pos, eoperator_precedence::k_super_weak);
 			const auto pos2 = skip_whitespace(expression_pos.second);
 			const auto ch = pos2.first1();
 			if(ch == ","){
-				result._elements.push_back(collection_element_t{ nullptr, expression_pos.first });
+				result._elements.push_back(collection_element_t{ k_no_parse_node, expression_pos.first });
 				pos = pos2.rest1();
 			}
 			else if(ch == end_char){
-				result._elements.push_back(collection_element_t{ nullptr, expression_pos.first });
+				result._elements.push_back(collection_element_t{ k_no_parse_node, expression_pos.first });
 				pos = pos2;
 			}
 			else if(ch == ":"){
 				result._has_keys = true;
 
 				const auto pos3 = skip_whitespace(pos2.rest1());
-				const auto expression2_pos = parse_expression_deep(pos3, eoperator_precedence::k_super_weak);
+				const auto expression2_pos = parse_expression_deep(tree, pos3, eoperator_precedence::k_super_weak);
 				const auto pos4 = skip_whitespace(expression2_pos.second);
 				const auto ch2 = pos4.first1();
 				if(ch2 == ","){
-					result._elements.push_back(collection_element_t{ std::make_shared<json_t>(expression_pos.first), expression2_pos.first});
+					result._elements.push_back(collection_element_t{ expression_pos.first, expression2_pos.first});
 					pos = pos4.rest1();
 				}
 				else if(ch2 == end_char){
-					result._elements.push_back(collection_element_t{ std::make_shared<json_t>(expression_pos.first), expression2_pos.first});
+					result._elements.push_back(collection_element_t{ expression_pos.first, expression2_pos.first});
 					pos = pos4;
 				}
 				else{
-					throw_compiler_error_nopos("Unexpected char \"" + ch2 + "\" in bounded list " + start_char + " " + end_char + "!");
+					throw_compiler_error_nopos("Unexpected char \"" + std::string(ch2) + "\" in bounded list " + start_char + " " + end_char + "!");
 				}
 			}
 			else{
-				throw_compiler_error_nopos("Unexpected char \"" + ch + "\" in bounded list " + start_char + " " + end_char + "!");
+				throw_compiler_error_nopos("Unexpected char \"" + std::string(ch) + "\" in bounded list " + start_char + " " + end_char + "!");
 			}
 		}
 		return { result, pos.rest1() };
 	}
 }
 
+//	expected_json: [ HAS_KEYS, [ KEY_EXPRESSION or null, VALUE_EXPRESSION ]... ]
+void ut_verify_collection(const quark::call_context_t& context, const std::string& input, const std::string& start_char, const std::string& end_char, const std::string& expected_json, const std::string& expected_rest){
+	parse_tree_t tree;
+	const auto result = parse_bounded_list(tree, text_cursor_t(input), start_char, end_char);
+
+	std::vector<json_t> elements;
+	for(const auto& e: result.first._elements){
+		elements.push_back(json_t::make_array({
+			e._key == k_no_parse_node ? json_t() : parse_node_to_json(tree, e._key),
+			parse_node_to_json(tree, e._value)
+		}));
+	}
+	const auto result_json = json_t::make_array({ json_t(result.first._has_keys), json_t::make_array(elements) });
+	ut_verify(context, result_json, parse_json(seq_t(expected_json)).first);
+	ut_verify(context, result.second.str(), expected_rest);
+}
+
 QUARK_TEST("parser", "parse_bounded_list()", "", ""){
-	ut_verify_collection(
-		QUARK_POS,
-		parse_bounded_list(seq_t("(3)xyz"), "(", ")"),
-		std::pair<collection_def_t, seq_t>({false, {	{ nullptr, parser__make_literal(value_t::make_int(3)) }}}, seq_t("xyz"))
-	);
+	ut_verify_collection(QUARK_POS, "(3)xyz", "(", ")", R"([false, [[null, ["k", 3, "int"]]]])", "xyz");
 }
 
 QUARK_TEST("parser", "parse_bounded_list()", "", ""){
-	ut_verify_collection(QUARK_POS, parse_bounded_list(seq_t("[]xyz"), "[", "]"), std::pair<collection_def_t, seq_t>({false, {}}, seq_t("xyz")));
+	ut_verify_collection(QUARK_POS, "[]xyz", "[", "]", R"([false, []])", "xyz");
 }
 
 QUARK_TEST("parser", "parse_bounded_list()", "", ""){
-	ut_verify_collection(
-		QUARK_POS,
-		parse_bounded_list(seq_t("[1,2]xyz"), "[", "]"),
-		std::pair<collection_def_t, seq_t>(
-			{
-				false,
-				{
-					{ nullptr, parser__make_literal(value_t::make_int(1)) },
-					{ nullptr, parser__make_literal(value_t::make_int(2)) }
-				}
-			},
-			seq_t("xyz")
-		)
-	);
+	ut_verify_collection(QUARK_POS, "[1,2]xyz", "[", "]", R"([false, [[null, ["k", 1, "int"]], [null, ["k", 2, "int"]]]])", "xyz");
 }
 
 QUARK_TEST("parser", "parse_bounded_list()", "blank dict", ""){
-	ut_verify_collection(
-		QUARK_POS,
-		parse_bounded_list(seq_t(R"([:]xyz)"), "[", "]"),
-		std::pair<collection_def_t, seq_t>(
-			{
-				true,
-				{}
-			},
-			seq_t("xyz")
-		)
-	);
+	ut_verify_collection(QUARK_POS, R"([:]xyz)", "[", "]", R"([true, []])", "xyz");
 }
 
 QUARK_TEST("parser", "parse_bounded_list()", "two elements", ""){
 	ut_verify_collection(
 		QUARK_POS,
-		parse_bounded_list(seq_t(R"(["one": 1, "two": 2]xyz)"), "[", "]"),
-		std::pair<collection_def_t, seq_t>(
-			{
-				true,
-				{
-					{ std::make_shared<json_t>(parser__make_literal(value_t::make_string("one"))), parser__make_literal(value_t::make_int(1)) },
-					{ std::make_shared<json_t>(parser__make_literal(value_t::make_string("two"))), parser__make_literal(value_t::make_int(2)) }
-				}
-			},
-			seq_t("xyz")
-		)
+		R"(["one": 1, "two": 2]xyz)",
+		"[",
+		"]",
+		R"([true, [[["k", "one", "string"], ["k", 1, "int"]], [["k", "two", "string"], ["k", 2, "int"]]]])",
+		"xyz"
 	);
 }
 
@@ -272,13 +233,13 @@ int64_t expand_one_char_escape(const char ch2){
 	}
 }
 
-std::pair<std::string, seq_t> parse_string_literal_internal(const seq_t& s, const char delimiter){
+std::pair<std::string, text_cursor_t> parse_string_literal_internal(const text_cursor_t& s, const char delimiter){
 	QUARK_ASSERT(!s.empty());
 	QUARK_ASSERT(s.first1_char() == delimiter);
 
 	auto pos = s.rest();
 	std::string result = "";
-	while(pos.empty() == false && pos.first() != std::string(1, delimiter)){
+	while(pos.empty() == false && pos.first1_char() != delimiter){
 		//	Look for escape char
 		if(pos.first1_char() == 0x5c){
 			if(pos.size() < 2){
@@ -292,17 +253,17 @@ std::pair<std::string, seq_t> parse_string_literal_internal(const seq_t& s, cons
 				}
 				else{
 					QUARK_ASSERT(expanded_char >= 0 && expanded_char < 256);
-					result += std::string(1, static_cast<uint8_t>(expanded_char));
+					result.push_back(static_cast<char>(expanded_char));
 					pos = pos.rest(2);
 				}
 			}
 		}
 		else {
-			result += pos.first();
+			result.push_back(pos.first1_char());
 			pos = pos.rest();
 		}
 	}
-	if(pos.first() != std::string(1, delimiter)){
+	if(pos.empty() || pos.first1_char() != delimiter){
 		throw_compiler_error_nopos("Incomplete string literal -- missing ending " + std::string(1, delimiter) + "-character in string literal: \"" + result + "\"!");
 	}
 	return { result, pos.rest() };
@@ -310,60 +271,60 @@ std::pair<std::string, seq_t> parse_string_literal_internal(const seq_t& s, cons
 
 
 
-std::pair<std::string, seq_t> parse_string_literal(const seq_t& s){
+std::pair<std::string, text_cursor_t> parse_string_literal(const text_cursor_t& s){
 	return parse_string_literal_internal(s, '\"');
 }
 
 QUARK_TEST("parser", "parse_string_literal()", "", ""){
-	ut_verify(QUARK_POS, parse_string_literal(seq_t(R"("" xxx)")), std::pair<std::string, seq_t>("", seq_t(" xxx")));
+	ut_verify(QUARK_POS, parse_string_literal(text_cursor_t(R"("" xxx)")), std::pair<std::string, text_cursor_t>("", text_cursor_t(" xxx")));
 }
 
 QUARK_TEST("parser", "parse_string_literal()", "", ""){
-	ut_verify(QUARK_POS, parse_string_literal(seq_t(R"("hello" xxx)")), std::pair<std::string, seq_t>("hello", seq_t(" xxx")));
+	ut_verify(QUARK_POS, parse_string_literal(text_cursor_t(R"("hello" xxx)")), std::pair<std::string, text_cursor_t>("hello", text_cursor_t(" xxx")));
 }
 
 QUARK_TEST("parser", "parse_string_literal()", "", ""){
-	ut_verify(QUARK_POS, parse_string_literal(seq_t(R"(".5" xxx)")), std::pair<std::string, seq_t>(".5", seq_t(" xxx")));
+	ut_verify(QUARK_POS, parse_string_literal(text_cursor_t(R"(".5" xxx)")), std::pair<std::string, text_cursor_t>(".5", text_cursor_t(" xxx")));
 }
 
 QUARK_TEST("parser", "parse_string_literal()", "", ""){
 	ut_verify(
 		QUARK_POS,
 		//	NOTICE that \" are Floyd-escapes in the Floyd source code.
-		parse_string_literal(seq_t(R"___("hello \"Bob\"!" xxx)___")),
-		std::pair<std::string, seq_t>(R"(hello "Bob"!)", seq_t(" xxx"))
+		parse_string_literal(text_cursor_t(R"___("hello \"Bob\"!" xxx)___")),
+		std::pair<std::string, text_cursor_t>(R"(hello "Bob"!)", text_cursor_t(" xxx"))
 	);
 }
 
 QUARK_TEST("parser", "parse_string_literal()", "Escape \0", ""){
-	ut_verify(QUARK_POS, parse_string_literal(seq_t(R"___("\0" xxx)___")), std::pair<std::string, seq_t>(std::string(1, '\0'), seq_t(" xxx")));
+	ut_verify(QUARK_POS, parse_string_literal(text_cursor_t(R"___("\0" xxx)___")), std::pair<std::string, text_cursor_t>(std::string(1, '\0'), text_cursor_t(" xxx")));
 }
 QUARK_TEST("parser", "parse_string_literal()", "Escape \t", ""){
-	ut_verify(QUARK_POS, parse_string_literal(seq_t(R"___("\t" xxx)___")), std::pair<std::string, seq_t>("\t", seq_t(" xxx")));
+	ut_verify(QUARK_POS, parse_string_literal(text_cursor_t(R"___("\t" xxx)___")), std::pair<std::string, text_cursor_t>("\t", text_cursor_t(" xxx")));
 }
 QUARK_TEST("parser", "parse_string_literal()", "Escape \\", ""){
-	ut_verify(QUARK_POS, parse_string_literal(seq_t(R"___("\\" xxx)___")), std::pair<std::string, seq_t>("\\", seq_t(" xxx")));
+	ut_verify(QUARK_POS, parse_string_literal(text_cursor_t(R"___("\\" xxx)___")), std::pair<std::string, text_cursor_t>("\\", text_cursor_t(" xxx")));
 }
 QUARK_TEST("parser", "parse_string_literal()", "Escape \n", ""){
-	ut_verify(QUARK_POS, parse_string_literal(seq_t(R"___("\n" xxx)___")), std::pair<std::string, seq_t>("\n", seq_t(" xxx")));
+	ut_verify(QUARK_POS, parse_string_literal(text_cursor_t(R"___("\n" xxx)___")), std::pair<std::string, text_cursor_t>("\n", text_cursor_t(" xxx")));
 }
 QUARK_TEST("parser", "parse_string_literal()", "Escape \r", ""){
-	ut_verify(QUARK_POS, parse_string_literal(seq_t(R"___("\r" xxx)___")), std::pair<std::string, seq_t>("\r", seq_t(" xxx")));
+	ut_verify(QUARK_POS, parse_string_literal(text_cursor_t(R"___("\r" xxx)___")), std::pair<std::string, text_cursor_t>("\r", text_cursor_t(" xxx")));
 }
 QUARK_TEST("parser", "parse_string_literal()", "Escape \"", ""){
-	ut_verify(QUARK_POS, parse_string_literal(seq_t(R"___("\"" xxx)___")), std::pair<std::string, seq_t>("\"", seq_t(" xxx")));
+	ut_verify(QUARK_POS, parse_string_literal(text_cursor_t(R"___("\"" xxx)___")), std::pair<std::string, text_cursor_t>("\"", text_cursor_t(" xxx")));
 }
 QUARK_TEST("parser", "parse_string_literal()", "Escape \'", ""){
-	ut_verify(QUARK_POS, parse_string_literal(seq_t(R"___("\'" xxx)___")), std::pair<std::string, seq_t>("\'", seq_t(" xxx")));
+	ut_verify(QUARK_POS, parse_string_literal(text_cursor_t(R"___("\'" xxx)___")), std::pair<std::string, text_cursor_t>("\'", text_cursor_t(" xxx")));
 }
 QUARK_TEST("parser", "parse_string_literal()", "Escape \'", ""){
-	ut_verify(QUARK_POS, parse_string_literal(seq_t(R"___("\/" xxx)___")), std::pair<std::string, seq_t>("/", seq_t(" xxx")));
+	ut_verify(QUARK_POS, parse_string_literal(text_cursor_t(R"___("\/" xxx)___")), std::pair<std::string, text_cursor_t>("/", text_cursor_t(" xxx")));
 }
 
 
 
 
-std::pair<int64_t, seq_t> parse_character_literal(const seq_t& s){
+std::pair<int64_t, text_cursor_t> parse_character_literal(const text_cursor_t& s){
 	QUARK_ASSERT(!s.empty());
 	QUARK_ASSERT(s.first1_char() == '\'');
 
@@ -379,15 +340,15 @@ std::pair<int64_t, seq_t> parse_character_literal(const seq_t& s){
 }
 
 QUARK_TEST("parser", "parse_character_literal()", "", ""){
-	ut_verify(QUARK_POS, parse_character_literal(seq_t(R"('A' xxx)")), std::pair<int64_t, seq_t>(65, seq_t(" xxx")));
+	ut_verify(QUARK_POS, parse_character_literal(text_cursor_t(R"('A' xxx)")), std::pair<int64_t, text_cursor_t>(65, text_cursor_t(" xxx")));
 }
 QUARK_TEST("parser", "parse_string_literal()", "Escape \0", ""){
-	ut_verify(QUARK_POS, parse_character_literal(seq_t(R"___('\0' xxx)___")), std::pair<int64_t, seq_t>(0x00, seq_t(" xxx")));
+	ut_verify(QUARK_POS, parse_character_literal(text_cursor_t(R"___('\0' xxx)___")), std::pair<int64_t, text_cursor_t>(0x00, text_cursor_t(" xxx")));
 }
 
 QUARK_TEST("parser", "parse_character_literal()", "", ""){
 	try {
-		parse_character_literal(seq_t(R"('AB' xxx)"));
+		parse_character_literal(text_cursor_t(R"('AB' xxx)"));
 		QUARK_ASSERT(false);
 	}
 	catch(const compiler_error& e){
@@ -401,7 +362,7 @@ QUARK_TEST("parser", "parse_character_literal()", "", ""){
 
 // [0-9] and "."  => numeric constant.
 //	Only works with positive numbers. Any sign is parsed first.
-std::pair<value_t, seq_t> parse_decimal_literal(const seq_t& p) {
+std::pair<value_t, text_cursor_t> parse_decimal_literal(const text_cursor_t& p) {
 	QUARK_ASSERT(p.check_invariant());
 	QUARK_ASSERT(k_c99_number_chars.find(p.first()) != std::string::npos);
 
@@ -444,48 +405,48 @@ QUARK_TEST("parser", "std::strtoull()", "", ""){
 
 
 QUARK_TEST("parser", "parse_decimal_literal()", "", ""){
-	const auto a = parse_decimal_literal(seq_t("0 xxx"));
+	const auto a = parse_decimal_literal(text_cursor_t("0 xxx"));
 	QUARK_VERIFY(a.first.get_int_value() == 0);
 	QUARK_VERIFY(a.second.get_s() == " xxx");
 }
 
 QUARK_TEST("parser", "parse_decimal_literal()", "", ""){
-	const auto a = parse_decimal_literal(seq_t("1234 xxx"));
+	const auto a = parse_decimal_literal(text_cursor_t("1234 xxx"));
 	QUARK_VERIFY(a.first.get_int_value() == 1234);
 	QUARK_VERIFY(a.second.get_s() == " xxx");
 }
 
 QUARK_TEST("parser", "parse_decimal_literal()", "", ""){
-	const auto a = parse_decimal_literal(seq_t("0.5 xxx"));
+	const auto a = parse_decimal_literal(text_cursor_t("0.5 xxx"));
 	QUARK_VERIFY(a.first.get_double_value() == 0.5f);
 	QUARK_VERIFY(a.second.get_s() == " xxx");
 }
 
 QUARK_TEST("parser", "parse_decimal_literal()", "", ""){
-	const auto a = parse_decimal_literal(seq_t("17179869184 xxx"));
+	const auto a = parse_decimal_literal(text_cursor_t("17179869184 xxx"));
 	QUARK_VERIFY(a.first.get_int_value() == 17179869184);
 	QUARK_VERIFY(a.second.get_s() == " xxx");
 }
 
 QUARK_TEST("parser", "parse_decimal_literal()", "", ""){
-	const auto a = parse_decimal_literal(seq_t("9223372036854775807 xxx"));
+	const auto a = parse_decimal_literal(text_cursor_t("9223372036854775807 xxx"));
 	QUARK_VERIFY(a.first.get_int_value() == k_floyd_int64_max);
 	QUARK_VERIFY(a.second.get_s() == " xxx");
 }
 QUARK_TEST("parser", "parse_decimal_literal()", "", ""){
-	const auto a = parse_decimal_literal(seq_t("9223372036854775808 xxx"));
+	const auto a = parse_decimal_literal(text_cursor_t("9223372036854775808 xxx"));
 	QUARK_VERIFY((uint64_t)a.first.get_int_value() == 9223372036854775808ull);
 	QUARK_VERIFY(a.second.get_s() == " xxx");
 }
 QUARK_TEST("parser", "parse_decimal_literal()", "", ""){
-	const auto a = parse_decimal_literal(seq_t("18446744073709551615 xxx"));
+	const auto a = parse_decimal_literal(text_cursor_t("18446744073709551615 xxx"));
 	QUARK_VERIFY(a.first.get_int_value() == k_floyd_uint64_max);
 	QUARK_VERIFY(a.second.get_s() == " xxx");
 }
 
 QUARK_TEST("parser", "parse_decimal_literal()", "", ""){
 	try {
-		parse_decimal_literal(seq_t("618446744073709551615 xxx"));
+		parse_decimal_literal(text_cursor_t("618446744073709551615 xxx"));
 	}
 	catch(const std::runtime_error& e){
 		QUARK_VERIFY(std::string(e.what()) == "Integer literal \"618446744073709551615\" larger than maxium allowed, which is 18446744073709551615 aka 0x7fffffff'ffffffff - maxium for an unsigned 64-bit integer.");
@@ -625,7 +586,7 @@ QUARK_TEST("parser", "strip_optional_dividers()", "", ""){
 	0b0'11111111
 */
 
-std::pair<value_t, seq_t> parse_binary_literal(const seq_t& p) {
+std::pair<value_t, text_cursor_t> parse_binary_literal(const text_cursor_t& p) {
 	QUARK_ASSERT(p.check_invariant());
 
 	const auto pos = read_required(p, "0b");
@@ -660,50 +621,50 @@ std::pair<value_t, seq_t> parse_binary_literal(const seq_t& p) {
 
 QUARK_TEST("parser", "parse_binary_literal()", "", ""){
 	try {
-		const auto a = parse_binary_literal(seq_t("0b xxx"));
+		const auto a = parse_binary_literal(text_cursor_t("0b xxx"));
 		QUARK_ASSERT(false);
 	}
 	catch(...){
 	}
 }
 QUARK_TEST("parser", "parse_binary_literal()", "", ""){
-	const auto a = parse_binary_literal(seq_t("0b0 xxx"));
+	const auto a = parse_binary_literal(text_cursor_t("0b0 xxx"));
 	QUARK_VERIFY(a.first.get_int_value() == 0);
 	QUARK_VERIFY(a.second.get_s() == " xxx");
 }
 QUARK_TEST("parser", "parse_binary_literal()", "", ""){
-	const auto a = parse_binary_literal(seq_t("0b1 xxx"));
+	const auto a = parse_binary_literal(text_cursor_t("0b1 xxx"));
 	QUARK_VERIFY(a.first.get_int_value() == 1);
 	QUARK_VERIFY(a.second.get_s() == " xxx");
 }
 QUARK_TEST("parser", "parse_binary_literal()", "", ""){
-	const auto a = parse_binary_literal(seq_t("0b00000000 xxx"));
+	const auto a = parse_binary_literal(text_cursor_t("0b00000000 xxx"));
 	QUARK_VERIFY(a.first.get_int_value() == 0);
 	QUARK_VERIFY(a.second.get_s() == " xxx");
 }
 QUARK_TEST("parser", "parse_binary_literal()", "", ""){
-	const auto a = parse_binary_literal(seq_t("0b00000001 xxx"));
+	const auto a = parse_binary_literal(text_cursor_t("0b00000001 xxx"));
 	QUARK_VERIFY(a.first.get_int_value() == 1);
 	QUARK_VERIFY(a.second.get_s() == " xxx");
 }
 QUARK_TEST("parser", "parse_binary_literal()", "", ""){
-	const auto a = parse_binary_literal(seq_t("0b10000000 xxx"));
+	const auto a = parse_binary_literal(text_cursor_t("0b10000000 xxx"));
 	QUARK_VERIFY(a.first.get_int_value() == 128);
 	QUARK_VERIFY(a.second.get_s() == " xxx");
 }
 QUARK_TEST("parser", "parse_binary_literal()", "", ""){
-	const auto a = parse_binary_literal(seq_t("0b11111111 xxx"));
+	const auto a = parse_binary_literal(text_cursor_t("0b11111111 xxx"));
 	QUARK_VERIFY(a.first.get_int_value() == 255);
 	QUARK_VERIFY(a.second.get_s() == " xxx");
 }
 QUARK_TEST("parser", "parse_binary_literal()", "", ""){
-	const auto a = parse_binary_literal(seq_t("0b1000000000000000000000000000000000000000000000000000000000000001 xxx"));
+	const auto a = parse_binary_literal(text_cursor_t("0b1000000000000000000000000000000000000000000000000000000000000001 xxx"));
 	QUARK_VERIFY(a.first.get_int_value() == 0b1000000000000000000000000000000000000000000000000000000000000001);
 	QUARK_VERIFY(a.second.get_s() == " xxx");
 }
 QUARK_TEST("parser", "parse_binary_literal()", "", ""){
 	try {
-		const auto a = parse_binary_literal(seq_t("0b000011112 xxx"));
+		const auto a = parse_binary_literal(text_cursor_t("0b000011112 xxx"));
 		QUARK_ASSERT(false);
 	}
 	catch(...){
@@ -711,7 +672,7 @@ QUARK_TEST("parser", "parse_binary_literal()", "", ""){
 }
 QUARK_TEST("parser", "parse_binary_literal()", "", ""){
 	try {
-		const auto a = parse_binary_literal(seq_t("0b00001111a xxx"));
+		const auto a = parse_binary_literal(text_cursor_t("0b00001111a xxx"));
 		QUARK_ASSERT(false);
 	}
 	catch(...){
@@ -721,19 +682,19 @@ QUARK_TEST("parser", "parse_binary_literal()", "", ""){
 
 QUARK_TEST("parser", "parse_binary_literal()", "range", ""){
 	//											 --------XXXXXXXX--------XXXXXXXX--------XXXXXXXX--------XXXXXXXX
-	const auto a = parse_binary_literal(seq_t("0b0111111111111111111111111111111111111111111111111111111111111111 xxx"));
+	const auto a = parse_binary_literal(text_cursor_t("0b0111111111111111111111111111111111111111111111111111111111111111 xxx"));
 	QUARK_VERIFY(a.first.get_int_value() == 0b0111111111111111111111111111111111111111111111111111111111111111);
 	QUARK_VERIFY(a.second.get_s() == " xxx");
 }
 QUARK_TEST("parser", "parse_binary_literal()", "range", ""){
 	//											 --------XXXXXXXX--------XXXXXXXX--------XXXXXXXX--------XXXXXXXX
-	const auto a = parse_binary_literal(seq_t("0b1000000000000000000000000000000000000000000000000000000000000000 xxx"));
+	const auto a = parse_binary_literal(text_cursor_t("0b1000000000000000000000000000000000000000000000000000000000000000 xxx"));
 	QUARK_VERIFY(a.first.get_int_value() == 0b1000000000000000000000000000000000000000000000000000000000000000);
 	QUARK_VERIFY(a.second.get_s() == " xxx");
 }
 QUARK_TEST("parser", "parse_binary_literal()", "range", ""){
 	//											 --------XXXXXXXX--------XXXXXXXX--------XXXXXXXX--------XXXXXXXX
-	const auto a = parse_binary_literal(seq_t("0b1111111111111111111111111111111111111111111111111111111111111111 xxx"));
+	const auto a = parse_binary_literal(text_cursor_t("0b1111111111111111111111111111111111111111111111111111111111111111 xxx"));
 	QUARK_VERIFY(a.first.get_int_value() == 0b1111111111111111111111111111111111111111111111111111111111111111);
 	QUARK_VERIFY(a.second.get_s() == " xxx");
 }
@@ -742,26 +703,26 @@ QUARK_TEST("parser", "parse_binary_literal()", "range", ""){
 
 QUARK_TEST("parser", "parse_binary_literal()", "", ""){
 											//   ----XXXX----XXXX----XXXX----XXXX----XXXX----XXXX----XXXX----XXXX
-	const auto a = parse_binary_literal(seq_t("0b0001001000110100010101100111100010011010101111001101111011110001 xxx"));
+	const auto a = parse_binary_literal(text_cursor_t("0b0001001000110100010101100111100010011010101111001101111011110001 xxx"));
 	QUARK_VERIFY(a.first.get_int_value() == 0x123456789abcdef1);
 	QUARK_VERIFY(a.second.get_s() == " xxx");
 }
 
 QUARK_TEST("parser", "parse_binary_literal()", "", ""){
-	const auto a = parse_binary_literal(seq_t("0b00010010'00110100'01010110'01111000'10011010'10111100'11011110'11110001 xxx"));
+	const auto a = parse_binary_literal(text_cursor_t("0b00010010'00110100'01010110'01111000'10011010'10111100'11011110'11110001 xxx"));
 	QUARK_VERIFY(a.first.get_int_value() == 0x123456789abcdef1);
 	QUARK_VERIFY(a.second.get_s() == " xxx");
 }
 
 QUARK_TEST("parser", "parse_binary_literal()", "", ""){
-	const auto a = parse_binary_literal(seq_t("0b10000000'00000000'00000000'00000000'00000000'00000000'00000000'00000001 xxx"));
+	const auto a = parse_binary_literal(text_cursor_t("0b10000000'00000000'00000000'00000000'00000000'00000000'00000000'00000001 xxx"));
 	QUARK_VERIFY(a.first.get_int_value() == 0x8000000000000001);
 	QUARK_VERIFY(a.second.get_s() == " xxx");
 }
 
 QUARK_TEST("parser", "parse_binary_literal()", "", ""){
 	try {
-		const auto a = parse_binary_literal(seq_t("0b1'10000000'00000000'00000000'00000000'00000000'00000000'00000000'00000001 xxx"));
+		const auto a = parse_binary_literal(text_cursor_t("0b1'10000000'00000000'00000000'00000000'00000000'00000000'00000000'00000001 xxx"));
 		QUARK_ASSERT(false);
 	}
 	catch(...){
@@ -772,7 +733,7 @@ QUARK_TEST("parser", "parse_binary_literal()", "", ""){
 
 
 
-std::pair<value_t, seq_t> parse_hexadecimal_literal(const seq_t& p) {
+std::pair<value_t, text_cursor_t> parse_hexadecimal_literal(const text_cursor_t& p) {
 	QUARK_ASSERT(p.check_invariant());
 
 	const auto pos = read_required(p, "0x");
@@ -804,67 +765,67 @@ std::pair<value_t, seq_t> parse_hexadecimal_literal(const seq_t& p) {
 }
 
 QUARK_TEST("parser", "parse_hexadecimal_literal()", "", ""){
-	const auto a = parse_hexadecimal_literal(seq_t("0x00 xxx"));
+	const auto a = parse_hexadecimal_literal(text_cursor_t("0x00 xxx"));
 	QUARK_VERIFY(a.first.get_int_value() == 0x00);
 	QUARK_VERIFY(a.second.get_s() == " xxx");
 }
 
 QUARK_TEST("parser", "parse_hexadecimal_literal()", "", ""){
-	const auto a = parse_hexadecimal_literal(seq_t("0x1234 xxx"));
+	const auto a = parse_hexadecimal_literal(text_cursor_t("0x1234 xxx"));
 	QUARK_VERIFY(a.first.get_int_value() == 0x1234);
 	QUARK_VERIFY(a.second.get_s() == " xxx");
 }
 
 QUARK_TEST("parser", "parse_hexadecimal_literal()", "", ""){
-	const auto a = parse_hexadecimal_literal(seq_t("0xabcdef0123456789 xxx"));
+	const auto a = parse_hexadecimal_literal(text_cursor_t("0xabcdef0123456789 xxx"));
 	QUARK_VERIFY(a.first.get_int_value() == 0xabcdef0123456789);
 	QUARK_VERIFY(a.second.get_s() == " xxx");
 }
 
 
 QUARK_TEST("parser", "parse_hexadecimal_literal()", "range", ""){
-	const auto a = parse_hexadecimal_literal(seq_t("0x7fffffffffffffff xxx"));
+	const auto a = parse_hexadecimal_literal(text_cursor_t("0x7fffffffffffffff xxx"));
 	QUARK_VERIFY(a.first.get_int_value() == 0x7fffffffffffffff);
 	QUARK_VERIFY(a.second.get_s() == " xxx");
 }
 QUARK_TEST("parser", "parse_hexadecimal_literal()", "range", ""){
-	const auto a = parse_hexadecimal_literal(seq_t("0x8000000000000000 xxx"));
+	const auto a = parse_hexadecimal_literal(text_cursor_t("0x8000000000000000 xxx"));
 	QUARK_VERIFY(a.first.get_int_value() == 0x8000000000000000);
 	QUARK_VERIFY(a.second.get_s() == " xxx");
 }
 QUARK_TEST("parser", "parse_hexadecimal_literal()", "range", ""){
-	const auto a = parse_hexadecimal_literal(seq_t("0xffffffffffffffff xxx"));
+	const auto a = parse_hexadecimal_literal(text_cursor_t("0xffffffffffffffff xxx"));
 	QUARK_VERIFY(a.first.get_int_value() == 0xffffffffffffffff);
 	QUARK_VERIFY(a.second.get_s() == " xxx");
 }
 
 
 QUARK_TEST("parser", "parse_hexadecimal_literal()", "", ""){
-	const auto a = parse_hexadecimal_literal(seq_t("0xabcdef01'23456789 xxx"));
+	const auto a = parse_hexadecimal_literal(text_cursor_t("0xabcdef01'23456789 xxx"));
 	QUARK_VERIFY(a.first.get_int_value() == 0xabcdef0123456789);
 	QUARK_VERIFY(a.second.get_s() == " xxx");
 }
 
 QUARK_TEST("parser", "parse_hexadecimal_literal()", "", ""){
-	const auto a = parse_hexadecimal_literal(seq_t("0xabcdef01'23456789 xxx"));
+	const auto a = parse_hexadecimal_literal(text_cursor_t("0xabcdef01'23456789 xxx"));
 	QUARK_VERIFY(a.first.get_int_value() == 0xabcdef0123456789);
 	QUARK_VERIFY(a.second.get_s() == " xxx");
 }
 QUARK_TEST("parser", "parse_hexadecimal_literal()", "", ""){
-	const auto a = parse_hexadecimal_literal(seq_t("0x01'23456789 xxx"));
+	const auto a = parse_hexadecimal_literal(text_cursor_t("0x01'23456789 xxx"));
 	QUARK_VERIFY(a.first.get_int_value() == 0x0123456789);
 	QUARK_VERIFY(a.second.get_s() == " xxx");
 }
 
 QUARK_TEST("parser", "parse_hexadecimal_literal()", "", ""){
-	const auto a = parse_hexadecimal_literal(seq_t("0xABCD xxx"));
+	const auto a = parse_hexadecimal_literal(text_cursor_t("0xABCD xxx"));
 	QUARK_VERIFY(a.first.get_int_value() == 0xabcd);
 	QUARK_VERIFY(a.second.get_s() == " xxx");
 }
 
 QUARK_TEST("parser", "parse_binary_literal()", "", ""){
 	try {
-		const auto a = parse_hexadecimal_literal(seq_t("0xf'abcdef01'23456789 xxx"));
+		const auto a = parse_hexadecimal_literal(text_cursor_t("0xf'abcdef01'23456789 xxx"));
 		QUARK_ASSERT(false);
 	}
 	catch(...){
@@ -889,7 +850,7 @@ QUARK_TEST("parser", "parse_binary_literal()", "", ""){
 		hello2
 		x
 */
-std::pair<json_t, seq_t> parse_terminal(const seq_t& p0) {
+std::pair<parse_node_index_t, text_cursor_t> parse_terminal(parse_tree_t& tree, const text_cursor_t& p0) {
 	QUARK_ASSERT(p0.check_invariant());
 
 	const auto p = skip_whitespace(p0);
@@ -897,23 +858,23 @@ std::pair<json_t, seq_t> parse_terminal(const seq_t& p0) {
 	//	String literal?
 	if(p.first1() == "\""){
 		const auto value_pos = parse_string_literal(p);
-		const auto result = parser__make_literal(value_t::make_string(value_pos.first));
+		const auto result = add_literal_node(tree, value_t::make_string(value_pos.first));
 		return { result, value_pos.second };
 	}
 	else if(p.first1() == "\'"){
 		const auto value_pos = parse_character_literal(p);
-		const auto result = parser__make_literal(value_t::make_int(value_pos.first));
+		const auto result = add_literal_node(tree, value_t::make_int(value_pos.first));
 		return { result, value_pos.second };
 	}
 
 	else if(is_first(p, "0b")){
 		const auto value_p = parse_binary_literal(p);
-		const auto result = parser__make_literal(value_p.first);
+		const auto result = add_literal_node(tree, value_p.first);
 		return { result, value_p.second };
 	}
 	else if(is_first(p, "0x")){
 		const auto value_p = parse_hexadecimal_literal(p);
-		const auto result = parser__make_literal(value_p.first);
+		const auto result = add_literal_node(tree, value_p.first);
 		return { result, value_p.second };
 	}
 
@@ -921,17 +882,17 @@ std::pair<json_t, seq_t> parse_terminal(const seq_t& p0) {
 	// [0-9] and "."  => numeric constant.
 	else if(k_c99_number_chars.find(p.first1()) != std::string::npos){
 		const auto value_p = parse_decimal_literal(p);
-		const auto result = parser__make_literal(value_p.first);
+		const auto result = add_literal_node(tree, value_p.first);
 		return { result, value_p.second };
 	}
 
 	else if(if_first(p, keyword_t::k_true).first){
-		const auto result = parser__make_literal(value_t::make_bool(true));
+		const auto result = add_literal_node(tree, value_t::make_bool(true));
 		return { result, if_first(p, keyword_t::k_true).second };
 	}
 
 	else if(if_first(p, keyword_t::k_false).first){
-		const auto result = parser__make_literal(value_t::make_bool(false));
+		const auto result = add_literal_node(tree, value_t::make_bool(false));
 		return { result, if_first(p, keyword_t::k_false).second };
 	}
 
@@ -939,8 +900,9 @@ std::pair<json_t, seq_t> parse_terminal(const seq_t& p0) {
 	{
 		const auto identifier_s = read_while(p, k_c99_identifier_chars);
 		if(!identifier_s.first.empty()){
-			const auto result = make_parser_node(floyd::k_no_location, parse_tree_expression_opcode_t::k_load, { identifier_s.first } );
-			return { result, identifier_s.second };
+			auto node = make_parse_node(parse_node_opcode::k_load, k_no_location);
+			node.name = identifier_s.first;
+			return { add_node(tree, node), identifier_s.second };
 		}
 	}
 
@@ -948,8 +910,8 @@ std::pair<json_t, seq_t> parse_terminal(const seq_t& p0) {
 }
 
 void ut_verify_terminal(const std::string& expression, const std::string& expected_value, const std::string& expected_seq){
-	const auto result = parse_terminal(seq_t(expression));
-	const std::string json_s = expr_to_string(result.first);
+	const auto result = ut_parse(parse_terminal, text_cursor_t(expression));
+	const std::string json_s = json_to_compact_string(result.first);
 	if(json_s == expected_value && result.second.get_s() == expected_seq){
 	}
 	else{
@@ -1030,7 +992,7 @@ QUARK_TEST("parser", "parse_terminal()", "identifier", ""){
 	lhs operation EXPR +++
 	lhs OPERATION EXPRESSION ...
 */
-std::pair<json_t, seq_t> parse_optional_operation_rightward(const seq_t& p0, const json_t& lhs, const eoperator_precedence precedence){
+std::pair<parse_node_index_t, text_cursor_t> parse_optional_operation_rightward(parse_tree_t& tree, const text_cursor_t& p0, parse_node_index_t lhs, const eoperator_precedence precedence){
 	QUARK_ASSERT(p0.check_invariant());
 
 	const auto p = skip_whitespace(p0);
@@ -1054,16 +1016,18 @@ std::pair<json_t, seq_t> parse_optional_operation_rightward(const seq_t& p0, con
 			//	Function call
 			//	EXPRESSION (EXPRESSION +, EXPRESSION)
 			if(op1 == "(" && precedence > eoperator_precedence::k_function_call){
-				const auto a_pos = parse_bounded_list(p, "(", ")");
+				const auto a_pos = parse_bounded_list(tree, p, "(", ")");
 
 				if(a_pos.first._has_keys){
 					throw_compiler_error_nopos("Cannot name arguments in function call!");
 				}
 
-				const auto values = get_values(a_pos.first);
-				const auto call = make_parser_node(floyd::k_no_location, parse_tree_expression_opcode_t::k_call, { lhs, json_t::make_array(values) } );
+				auto node = make_parse_node(parse_node_opcode::k_call, k_no_location);
+				node.a = lhs;
+				node.list = add_list(tree, get_values(a_pos.first));
+				const auto call = add_node(tree, node);
 
-				return parse_optional_operation_rightward(a_pos.second, call, precedence);
+				return parse_optional_operation_rightward(tree, a_pos.second, call, precedence);
 			}
 
 			//	Member access
@@ -1073,64 +1037,67 @@ std::pair<json_t, seq_t> parse_optional_operation_rightward(const seq_t& p0, con
 				if(identifier_s.first.empty()){
 					throw_compiler_error_nopos("Expected ')'");
 				}
-				const auto value2 = make_parser_node(floyd::k_no_location, parse_tree_expression_opcode_t::k_resolve_member, { lhs, identifier_s.first } );
+				auto node = make_parse_node(parse_node_opcode::k_resolve_member, k_no_location);
+				node.a = lhs;
+				node.name = identifier_s.first;
+				const auto value2 = add_node(tree, node);
 
-				return parse_optional_operation_rightward(identifier_s.second, value2, precedence);
+				return parse_optional_operation_rightward(tree, identifier_s.second, value2, precedence);
 			}
 
 			//	Lookup / subscription
 			//	EXPRESSION "[" EXPRESSION "]" +
 			else if(op1 == "["  && precedence > eoperator_precedence::k_lookup){
 				const auto p2 = skip_whitespace(p.rest());
-				const auto key = parse_expression_deep(p2, eoperator_precedence::k_super_weak);
-				const auto result = make_parser_node(floyd::k_no_location, parse_tree_expression_opcode_t::k_lookup_element, { lhs, key.first } );
+				const auto key = parse_expression_deep(tree, p2, eoperator_precedence::k_super_weak);
+				const auto result = add_node(tree, parse_node_opcode::k_lookup_element, lhs, key.first);
 				const auto p3 = skip_whitespace(key.second);
 
 				// Closing "]".
 				if(p3.first() != "]"){
 					throw_compiler_error_nopos("Expected closing \"]\"");
 				}
-				return parse_optional_operation_rightward(p3.rest(), result, precedence);
+				return parse_optional_operation_rightward(tree, p3.rest(), result, precedence);
 			}
 
 			//	EXPRESSION "+" EXPRESSION
 			else if(op1 == "+"  && precedence > eoperator_precedence::k_add_sub){
-				const auto rhs = parse_expression_deep(p.rest(), eoperator_precedence::k_add_sub);
-				const auto value2 = make_parser_node(floyd::k_no_location, parse_tree_expression_opcode_t::k_arithmetic_add, { lhs, rhs.first } );
-				return parse_optional_operation_rightward(rhs.second, value2, precedence);
+				const auto rhs = parse_expression_deep(tree, p.rest(), eoperator_precedence::k_add_sub);
+				const auto value2 = add_node(tree, parse_node_opcode::k_arithmetic_add, lhs, rhs.first);
+				return parse_optional_operation_rightward(tree, rhs.second, value2, precedence);
 			}
 
 			//	EXPRESSION "-" EXPRESSION
 			else if(op1 == "-" && precedence > eoperator_precedence::k_add_sub){
-				const auto rhs = parse_expression_deep(p.rest(), eoperator_precedence::k_add_sub);
-				const auto value2 = make_parser_node(floyd::k_no_location, parse_tree_expression_opcode_t::k_arithmetic_subtract, { lhs, rhs.first } );
-				return parse_optional_operation_rightward(rhs.second, value2, precedence);
+				const auto rhs = parse_expression_deep(tree, p.rest(), eoperator_precedence::k_add_sub);
+				const auto value2 = add_node(tree, parse_node_opcode::k_arithmetic_subtract, lhs, rhs.first);
+				return parse_optional_operation_rightward(tree, rhs.second, value2, precedence);
 			}
 
 			//	EXPRESSION "*" EXPRESSION
 			else if(op1 == "*" && precedence > eoperator_precedence::k_multiply_divider_remainder) {
-				const auto rhs = parse_expression_deep(p.rest(), eoperator_precedence::k_multiply_divider_remainder);
-				const auto value2 = make_parser_node(floyd::k_no_location, parse_tree_expression_opcode_t::k_arithmetic_multiply, { lhs, rhs.first } );
-				return parse_optional_operation_rightward(rhs.second, value2, precedence);
+				const auto rhs = parse_expression_deep(tree, p.rest(), eoperator_precedence::k_multiply_divider_remainder);
+				const auto value2 = add_node(tree, parse_node_opcode::k_arithmetic_multiply, lhs, rhs.first);
+				return parse_optional_operation_rightward(tree, rhs.second, value2, precedence);
 			}
 			//	EXPRESSION "/" EXPRESSION
 			else if(op1 == "/" && precedence > eoperator_precedence::k_multiply_divider_remainder) {
-				const auto rhs = parse_expression_deep(p.rest(), eoperator_precedence::k_multiply_divider_remainder);
-				const auto value2 = make_parser_node(floyd::k_no_location, parse_tree_expression_opcode_t::k_arithmetic_divide, { lhs, rhs.first } );
-				return parse_optional_operation_rightward(rhs.second, value2, precedence);
+				const auto rhs = parse_expression_deep(tree, p.rest(), eoperator_precedence::k_multiply_divider_remainder);
+				const auto value2 = add_node(tree, parse_node_opcode::k_arithmetic_divide, lhs, rhs.first);
+				return parse_optional_operation_rightward(tree, rhs.second, value2, precedence);
 			}
 
 			//	EXPRESSION "%" EXPRESSION
 			else if(op1 == "%" && precedence > eoperator_precedence::k_multiply_divider_remainder) {
-				const auto rhs = parse_expression_deep(p.rest(), eoperator_precedence::k_multiply_divider_remainder);
-				const auto value2 = make_parser_node(floyd::k_no_location, parse_tree_expression_opcode_t::k_arithmetic_remainder, { lhs, rhs.first } );
-				return parse_optional_operation_rightward(rhs.second, value2, precedence);
+				const auto rhs = parse_expression_deep(tree, p.rest(), eoperator_precedence::k_multiply_divider_remainder);
+				const auto value2 = add_node(tree, parse_node_opcode::k_arithmetic_remainder, lhs, rhs.first);
+				return parse_optional_operation_rightward(tree, rhs.second, value2, precedence);
 			}
 
 
 			//	EXPRESSION "?" EXPRESSION ":" EXPRESSION
 			else if(op1 == "?" && precedence > eoperator_precedence::k_comparison_operator) {
-				const auto true_expr_p = parse_expression_deep(p.rest(), eoperator_precedence::k_comparison_operator);
+				const auto true_expr_p = parse_expression_deep(tree, p.rest(), eoperator_precedence::k_comparison_operator);
 
 				const auto pos2 = skip_whitespace(true_expr_p.second);
 				const auto colon = pos2.first();
@@ -1138,69 +1105,73 @@ std::pair<json_t, seq_t> parse_optional_operation_rightward(const seq_t& p0, con
 					throw_compiler_error_nopos("Expected \":\"");
 				}
 
-				const auto false_expr_p = parse_expression_deep(pos2.rest(), precedence);
-				const auto value2 = make_parser_node(floyd::k_no_location, parse_tree_expression_opcode_t::k_conditional_operator, { lhs, true_expr_p.first, false_expr_p.first} );
-				return parse_optional_operation_rightward(false_expr_p.second, value2, precedence);
+				const auto false_expr_p = parse_expression_deep(tree, pos2.rest(), precedence);
+				auto node = make_parse_node(parse_node_opcode::k_conditional_operator, k_no_location);
+				node.a = lhs;
+				node.b = true_expr_p.first;
+				node.c = false_expr_p.first;
+				const auto value2 = add_node(tree, node);
+				return parse_optional_operation_rightward(tree, false_expr_p.second, value2, precedence);
 			}
 
 
 			//	EXPRESSION "==" EXPRESSION
 			else if(op2 == "==" && precedence > eoperator_precedence::k_equal__not_equal){
-				const auto rhs = parse_expression_deep(p.rest(2), eoperator_precedence::k_equal__not_equal);
-				const auto value2 = make_parser_node(floyd::k_no_location, parse_tree_expression_opcode_t::k_logical_equal, { lhs, rhs.first } );
-				return parse_optional_operation_rightward(rhs.second, value2, precedence);
+				const auto rhs = parse_expression_deep(tree, p.rest(2), eoperator_precedence::k_equal__not_equal);
+				const auto value2 = add_node(tree, parse_node_opcode::k_logical_equal, lhs, rhs.first);
+				return parse_optional_operation_rightward(tree, rhs.second, value2, precedence);
 			}
 			//	EXPRESSION "!=" EXPRESSION
 			else if(op2 == "!=" && precedence > eoperator_precedence::k_equal__not_equal){
-				const auto rhs = parse_expression_deep(p.rest(2), eoperator_precedence::k_equal__not_equal);
-				const auto value2 = make_parser_node(floyd::k_no_location, parse_tree_expression_opcode_t::k_logical_nonequal, { lhs, rhs.first } );
-				return parse_optional_operation_rightward(rhs.second, value2, precedence);
+				const auto rhs = parse_expression_deep(tree, p.rest(2), eoperator_precedence::k_equal__not_equal);
+				const auto value2 = add_node(tree, parse_node_opcode::k_logical_nonequal, lhs, rhs.first);
+				return parse_optional_operation_rightward(tree, rhs.second, value2, precedence);
 			}
 
 			//	!!! Check for "<=" before we check for "<".
 			//	EXPRESSION "<=" EXPRESSION
 			else if(op2 == "<=" && precedence > eoperator_precedence::k_larger_smaller){
-				const auto rhs = parse_expression_deep(p.rest(2), eoperator_precedence::k_larger_smaller);
-				const auto value2 = make_parser_node(floyd::k_no_location, parse_tree_expression_opcode_t::k_comparison_smaller_or_equal, { lhs, rhs.first } );
-				return parse_optional_operation_rightward(rhs.second, value2, precedence);
+				const auto rhs = parse_expression_deep(tree, p.rest(2), eoperator_precedence::k_larger_smaller);
+				const auto value2 = add_node(tree, parse_node_opcode::k_comparison_smaller_or_equal, lhs, rhs.first);
+				return parse_optional_operation_rightward(tree, rhs.second, value2, precedence);
 			}
 
 			//	EXPRESSION "<" EXPRESSION
 			else if(op1 == "<" && precedence > eoperator_precedence::k_larger_smaller){
-				const auto rhs = parse_expression_deep(p.rest(2), eoperator_precedence::k_larger_smaller);
-				const auto value2 = make_parser_node(floyd::k_no_location, parse_tree_expression_opcode_t::k_comparison_smaller, { lhs, rhs.first } );
-				return parse_optional_operation_rightward(rhs.second, value2, precedence);
+				const auto rhs = parse_expression_deep(tree, p.rest(2), eoperator_precedence::k_larger_smaller);
+				const auto value2 = add_node(tree, parse_node_opcode::k_comparison_smaller, lhs, rhs.first);
+				return parse_optional_operation_rightward(tree, rhs.second, value2, precedence);
 			}
 
 
 			//	!!! Check for ">=" before we check for ">".
 			//	EXPRESSION ">=" EXPRESSION
 			else if(op2 == ">=" && precedence > eoperator_precedence::k_larger_smaller){
-				const auto rhs = parse_expression_deep(p.rest(2), eoperator_precedence::k_larger_smaller);
-				const auto value2 = make_parser_node(floyd::k_no_location, parse_tree_expression_opcode_t::k_comparison_larger_or_equal, { lhs, rhs.first } );
-				return parse_optional_operation_rightward(rhs.second, value2, precedence);
+				const auto rhs = parse_expression_deep(tree, p.rest(2), eoperator_precedence::k_larger_smaller);
+				const auto value2 = add_node(tree, parse_node_opcode::k_comparison_larger_or_equal, lhs, rhs.first);
+				return parse_optional_operation_rightward(tree, rhs.second, value2, precedence);
 			}
 
 			//	EXPRESSION ">" EXPRESSION
 			else if(op1 == ">" && precedence > eoperator_precedence::k_larger_smaller){
-				const auto rhs = parse_expression_deep(p.rest(2), eoperator_precedence::k_larger_smaller);
-				const auto value2 = make_parser_node(floyd::k_no_location, parse_tree_expression_opcode_t::k_comparison_larger, { lhs, rhs.first } );
-				return parse_optional_operation_rightward(rhs.second, value2, precedence);
+				const auto rhs = parse_expression_deep(tree, p.rest(2), eoperator_precedence::k_larger_smaller);
+				const auto value2 = add_node(tree, parse_node_opcode::k_comparison_larger, lhs, rhs.first);
+				return parse_optional_operation_rightward(tree, rhs.second, value2, precedence);
 			}
 
 
 			//	EXPRESSION "&&" EXPRESSION
 			else if(op2 == "&&" && precedence > eoperator_precedence::k_logical_and){
-				const auto rhs = parse_expression_deep(p.rest(2), eoperator_precedence::k_logical_and);
-				const auto value2 = make_parser_node(floyd::k_no_location, parse_tree_expression_opcode_t::k_logical_and, { lhs, rhs.first } );
-				return parse_optional_operation_rightward(rhs.second, value2, precedence);
+				const auto rhs = parse_expression_deep(tree, p.rest(2), eoperator_precedence::k_logical_and);
+				const auto value2 = add_node(tree, parse_node_opcode::k_logical_and, lhs, rhs.first);
+				return parse_optional_operation_rightward(tree, rhs.second, value2, precedence);
 			}
 
 			//	EXPRESSION "||" EXPRESSION
 			else if(op2 == "||" && precedence > eoperator_precedence::k_logical_or){
-				const auto rhs = parse_expression_deep(p.rest(2), eoperator_precedence::k_logical_or);
-				const auto value2 = make_parser_node(floyd::k_no_location, parse_tree_expression_opcode_t::k_logical_or, { lhs, rhs.first } );
-				return parse_optional_operation_rightward(rhs.second, value2, precedence);
+				const auto rhs = parse_expression_deep(tree, p.rest(2), eoperator_precedence::k_logical_or);
+				const auto value2 = add_node(tree, parse_node_opcode::k_logical_or, lhs, rhs.first);
+				return parse_optional_operation_rightward(tree, rhs.second, value2, precedence);
 			}
 
 			//	EXPRESSION
@@ -1213,7 +1184,7 @@ std::pair<json_t, seq_t> parse_optional_operation_rightward(const seq_t& p0, con
 }
 
 
-static bool is_identifier(const seq_t& p, const std::string identifier){
+static bool is_identifier(const text_cursor_t& p, const std::string identifier){
 	const auto pos = read_identifier(p);
 	return pos.first == identifier;
 }
@@ -1232,11 +1203,9 @@ static bool is_identifier(const seq_t& p, const std::string identifier){
 		(123 + 123 * x + f(y*3))
 		[ 1, 2, calc_exp(3) ]
 */
-std::pair<json_t, seq_t> parse_lhs_atom(const seq_t& p){
+std::pair<parse_node_index_t, text_cursor_t> parse_lhs_atom(parse_tree_t& tree, const text_cursor_t& p){
 	QUARK_ASSERT(p.check_invariant());
 
-	types_t temp;
-
     const auto p2 = skip_whitespace(p);
 	if(p2.empty()){
 		throw_compiler_error_nopos("Unexpected end of program.");
@@ -1246,18 +1215,19 @@ std::pair<json_t, seq_t> parse_lhs_atom(const seq_t& p){
 
 	//	Negate? "-xxx"
 	if(ch1 == '-'){
-		const auto a = parse_expression_deep(p2.rest1(), eoperator_precedence::k_super_strong);
-		const auto value2 = make_parser_node(floyd::k_no_location, parse_tree_expression_opcode_t::k_arithmetic_unary_minus, { a.first } );
-		return { value2, a.second };
+		const auto a = parse_expression_deep(tree, p2.rest1(), eoperator_precedence::k_super_strong);
+		auto node = make_parse_node(parse_node_opcode::k_arithmetic_unary_minus, k_no_location);
+		node.a = a.first;
+		return { add_node(tree, node), a.second };
 	}
 	else if(ch1 == '+'){
-		const auto a = parse_expression_deep(p2.rest1(), eoperator_precedence::k_super_strong);
+		const auto a = parse_expression_deep(tree, p2.rest1(), eoperator_precedence::k_super_strong);
 		return { a.first, a.second };
 	}
 	//	Expression within parantheses?
 	//	(EXPRESSION)xxx"
 	else if(ch1 == '('){
-		const auto a = parse_expression_deep(p2.rest1(), eoperator_precedence::k_super_weak);
+		const auto a = parse_expression_deep(tree, p2.rest1(), eoperator_precedence::k_super_weak);
 		const auto p3 = skip_whitespace(a.second);
 		if (p3.first() != ")"){
 			throw_compiler_error(location_t(p2.pos()), "Expected ')' character.");
@@ -1280,84 +1250,73 @@ std::pair<json_t, seq_t> parse_lhs_atom(const seq_t& p){
 			{ "one": 1, "two": 2, "three": 3 }
 	*/
 	else if(ch1 == '['){
-		const auto a = parse_bounded_list(p2, "[", "]");
+		const auto a = parse_bounded_list(tree, p2, "[", "]");
 		if(a.first._has_keys){
 			throw_compiler_error(location_t(p2.pos()), "Illegal vector, use {} to make a dictionary!");
 		}
 		else{
-			const auto element_type2 = type_to_json(temp, make_vector(temp, make_undefined()));
-			const auto result = make_parser_node(
-				floyd::k_no_location,
-				parse_tree_expression_opcode_t::k_value_constructor,
-				{ element_type2, get_values(a.first) }
-			);
-			return {result, a.second };
+			auto node = make_parse_node(parse_node_opcode::k_value_constructor, k_no_location);
+			node.type = make_vector(tree.types, make_undefined());
+			node.list = add_list(tree, get_values(a.first));
+			return { add_node(tree, node), a.second };
 		}
 	}
 	else if(ch1 == '{'){
-		const auto a = parse_bounded_list(p2, "{", "}");
+		const auto a = parse_bounded_list(tree, p2, "{", "}");
 		if(a.first._elements.size() > 0 && a.first._has_keys == false){
 			throw_compiler_error(location_t(p2.pos()), "Dictionary needs keys!");
 		}
-		std::vector<json_t> flat_dict;
+		std::vector<parse_node_index_t> flat_dict;
 		for(const auto& b: a.first._elements){
-			if(b._key == nullptr){
+			if(b._key == k_no_parse_node){
 				throw_compiler_error(location_t(p2.pos()), "Dictionary definition misses element key(s)!");
 			}
-			flat_dict.push_back(*b._key);
+			flat_dict.push_back(b._key);
 			flat_dict.push_back(b._value);
 		}
 
-		const auto element_type2 = type_to_json(temp, make_dict(temp, make_undefined()));
-		const auto result = make_parser_node(floyd::k_no_location, parse_tree_expression_opcode_t::k_value_constructor, { element_type2, json_t::make_array(flat_dict) } );
-		return {result, a.second };
+		auto node = make_parse_node(parse_node_opcode::k_value_constructor, k_no_location);
+		node.type = make_dict(tree.types, make_undefined());
+		node.list = add_list(tree, flat_dict);
+		return { add_node(tree, node), a.second };
 	}
 
 	else if(is_identifier(p2, keyword_t::k_benchmark)){
 		const auto pos = read_identifier(p2);
-		const auto block_pos = parse_statement_body(pos.second);
-		const auto result = make_parser_node(floyd::k_no_location, parse_tree_expression_opcode_t::k_benchmark, { block_pos.parse_tree } );
-		return { result, block_pos.pos };
+		const auto block_pos = parse_statement_body(tree, pos.second);
+		auto node = make_parse_node(parse_node_opcode::k_benchmark, k_no_location);
+		node.list = block_pos.statements;
+		return { add_node(tree, node), block_pos.pos };
 	}
 
 	//	Single constant number, string literal, function call, variable access, lookup or member access. Can be a chain.
 	//	"1234xxx" or "my_function(3)xxx"
 	else {
-		const auto a = parse_terminal(p2);
+		const auto a = parse_terminal(tree, p2);
 		return a;
 	}
 }
 
 QUARK_TEST("parser", "parse_lhs_atom()", "", ""){
-	const auto a = parse_lhs_atom(seq_t("3"));
-	QUARK_VERIFY(a.first == parser__make_literal(value_t::make_int(3)));
+	const auto a = ut_parse(parse_lhs_atom, text_cursor_t("3"));
+	ut_verify(QUARK_POS, a.first, parse_json(seq_t(R"(["k", 3, "int"])")).first);
 }
 
 QUARK_TEST("parser", "parse_lhs_atom()", "", ""){
-	types_t temp;
-	const auto a = parse_lhs_atom(seq_t("[3]"));
-	QUARK_VERIFY(a.first == make_parser_node(
-		floyd::k_no_location,
-		parse_tree_expression_opcode_t::k_value_constructor,
-		{
-			type_to_json(temp, make_vector(temp, make_undefined())),
-			std::vector<json_t>{ parser__make_literal(value_t::make_int(3)) }
-		}
-	));
+	const auto a = ut_parse(parse_lhs_atom, text_cursor_t("[3]"));
+	ut_verify(QUARK_POS, a.first, parse_json(seq_t(R"(["value-constructor", ["vector", "undef"], [["k", 3, "int"]]])")).first);
 }
 
 
 
 void ut_verify__parse_expression(const quark::call_context_t& context, const std::string& input, const std::string& expected_json_s, const std::string& expected_rest){
-	const auto result = parse_expression(seq_t(input));
-	const std::string result_json_s = expr_to_string(result.first);
+	const auto result = ut_parse(parse_expression, text_cursor_t(input));
 
 	//	Generate the expted JSON using json_to_compact_string() so manual-input differences in expected_json don't matter for result being OK.
 	const auto expected_json = parse_json(seq_t(expected_json_s)).first;
 	if(result.first == expected_json && result.second.get_s() == expected_rest){
 	}
 	else{
-		const std::string expected_json2_s = json_to_compact_string(expected_json);
 		ut_verify(context, result.first, expected_json);
 		ut_verify(context, result.second.str(), expected_rest);
 		fail_test(context);
@@ -1370,7 +1329,7 @@ void ut_verify__parse_expression(const quark::call_context_t& context, const std
 
 QUARK_TEST("parser", "parse_expression()", "", ""){
 	try{
-		parse_expression(seq_t(""));
+		ut_parse(parse_expression, text_cursor_t(""));
 		fail_test(QUARK_POS);
 	}
 	catch(const std::runtime_error& e){
@@ -1388,7 +1347,7 @@ QUARK_TEST("parser", "parse_expression()", "", ""){
 }
 QUARK_TEST("parser", "parse_expression()", "", ""){
 //???
-//	ut_verify__expression(parse_expression(seq_t("1234567890")), "[\"k\", 1234567890, \"int\"]", "");
+//	ut_verify__expression(ut_parse(parse_expression, text_cursor_t("1234567890")), "[\"k\", 1234567890, \"int\"]", "");
 }
 QUARK_TEST("parser", "parse_expression()", "", ""){
 	ut_verify__parse_expression(QUARK_POS, R"___("hello, world!")___", R"(["k", "hello, world!", "string"])", "");
@@ -1972,7 +1931,7 @@ QUARK_TEST("parser", "parse_expression()", "combo arithmetics", ""){
 
 void test__parse_expression__throw(const std::string& expression, const std::string& exception_message){
 	try{
-		const auto result = parse_expression(seq_t(expression));
+		const auto result = ut_parse(parse_expression, text_cursor_t(expression));
 		fail_test(QUARK_POS);
 	}
 	catch(const std::runtime_error& e){
@@ -2028,22 +1987,22 @@ QUARK_TEST("parser", "parse_expression()", "Invalid characters", ""){
 */
 
 
-std::pair<json_t, seq_t> parse_expression_deep(const seq_t& p, const eoperator_precedence precedence){
+std::pair<parse_node_index_t, text_cursor_t> parse_expression_deep(parse_tree_t& tree, const text_cursor_t& p, const eoperator_precedence precedence){
 	QUARK_ASSERT(p.check_invariant());
 
-	auto lhs = parse_lhs_atom(p);
-	const auto r = parse_optional_operation_rightward(lhs.second, lhs.first, precedence);
+	auto lhs = parse_lhs_atom(tree, p);
+	const auto r = parse_optional_operation_rightward(tree, lhs.second, lhs.first, precedence);
 	return r;
 }
 
-std::pair<json_t, seq_t> parse_expression(const seq_t& p){
+std::pair<parse_node_index_t, text_cursor_t> parse_expression(parse_tree_t& tree, const text_cursor_t& p){
 #if DEBUG
 	const auto illegal_char = read_while(p, k_valid_expression_chars);
 	QUARK_ASSERT(illegal_char.second.empty());
 #endif
 
 	try{
-		const auto r = parse_expression_deep(p, eoperator_precedence::k_super_weak);
+		const auto r = parse_expression_deep(tree, p, eoperator_precedence::k_super_weak);
 		return { r.first, r.second };
 	}
 
@@ -11,7 +11,7 @@
 
 /*
 	Parses one expression from program text. Checks syntax.
-	Returns a parse tree for the expression, in JSON-format.
+	Adds the expression's nodes to the parse tree and returns the index of its root node.
 
 	Does NOT validates that called functions exists and has correct type.
 	Does NOT validates that accessed variables exists and has correct types.
@@ -27,16 +27,16 @@
 */
 
 #include "quark.h"
+#include "parse_tree.h"
 
-struct seq_t;
-struct json_t;
+struct text_cursor_t;
 
 namespace floyd {
 namespace parser {
 
-std::pair<std::string, seq_t> parse_string_literal(const seq_t& s);
+std::pair<std::string, text_cursor_t> parse_string_literal(const text_cursor_t& s);
 
-std::pair<json_t, seq_t> parse_expression(const seq_t& expression);
+std::pair<parse_node_index_t, text_cursor_t> parse_expression(parse_tree_t& tree, const text_cursor_t& expression);
 
 }	//	parser
 }	//	floyd
@@ -27,13 +27,13 @@ namespace parser {
 //////////////////////////////////////////////////		parse_statement_body()
 
 
-parse_result_t parse_statement_body(const seq_t& s){
-	return parse_statements_bracketted(s);
+parse_result_t parse_statement_body(parse_tree_t& tree, const text_cursor_t& s){
+	return parse_statements_bracketted(tree, s);
 }
 
 QUARK_TEST("", "parse_statement_body()", "", ""){
 	ut_verify(QUARK_POS,
-		parse_statement_body(seq_t("{}")).parse_tree,
+		ut_parse(parse_statement_body, text_cursor_t("{}")).first,
 		parse_json(seq_t(
 			R"(
 				[]
@@ -43,7 +43,7 @@ QUARK_TEST("", "parse_statement_body()", "", ""){
 }
 QUARK_TEST("", "parse_statement_body()", "", ""){
 	ut_verify(QUARK_POS,
-		parse_statement_body(seq_t("{ let int y = 11; }")).parse_tree,
+		ut_parse(parse_statement_body, text_cursor_t("{ let int y = 11; }")).first,
 		parse_json(seq_t(
 			R"(
 				[
@@ -55,7 +55,7 @@ QUARK_TEST("", "parse_statement_body()", "", ""){
 }
 QUARK_TEST("", "parse_statement_body()", "", ""){
 	ut_verify(QUARK_POS,
-		parse_statement_body(seq_t("{ let int y = 11; print(3); }")).parse_tree,
+		ut_parse(parse_statement_body, text_cursor_t("{ let int y = 11; print(3); }")).first,
 		parse_json(seq_t(
 			R"(
 				[
@@ -70,7 +70,7 @@ QUARK_TEST("", "parse_statement_body()", "", ""){
 //### test nested blocks.
 QUARK_TEST("", "parse_statement_body()", "", ""){
 	ut_verify(QUARK_POS,
-		parse_statement_body(seq_t(" { let int x = 1; let int y = 2; } ")).parse_tree,
+		ut_parse(parse_statement_body, text_cursor_t(" { let int x = 1; let int y = 2; } ")).first,
 		parse_json(seq_t(
 			R"(
 				[
@@ -86,15 +86,18 @@ QUARK_TEST("", "parse_statement_body()", "", ""){
 //////////////////////////////////////////////////		parse_block()
 
 
-std::pair<json_t, seq_t> parse_block(const seq_t& s){
+std::pair<parse_node_index_t, text_cursor_t> parse_block(parse_tree_t& tree, const text_cursor_t& s){
 	const auto start = skip_whitespace(s);
-	const auto body = parse_statement_body(start);
-	return { make_parser_node(location_t(start.pos()), parse_tree_statement_opcode::k_block, { body.parse_tree } ), body.pos };
+	const auto body = parse_statement_body(tree, start);
+
+	auto node = make_parse_node(parse_node_opcode::k_block, location_t(start.pos()));
+	node.list = body.statements;
+	return { add_node(tree, node), body.pos };
 }
 
 QUARK_TEST("", "parse_block()", "Block with two binds", ""){
 	ut_verify(QUARK_POS,
-		parse_block(seq_t(" { let int x = 1; let int y = 2; } ")).first,
+		ut_parse(parse_block, text_cursor_t(" { let int x = 1; let int y = 2; } ")).first,
 		parse_json(seq_t(
 			R"(
 				[
@@ -114,21 +117,22 @@ QUARK_TEST("", "parse_block()", "Block with two binds", ""){
 //////////////////////////////////////////////////		parse_return_statement()
 
 
-std::pair<json_t, seq_t> parse_return_statement(const seq_t& s){
+std::pair<parse_node_index_t, text_cursor_t> parse_return_statement(parse_tree_t& tree, const text_cursor_t& s){
 	const auto start = skip_whitespace(s);
 	const auto token_pos = if_first(start, keyword_t::k_return);
 	QUARK_ASSERT(token_pos.first);
 	const auto pos2 = skip_whitespace(token_pos.second);
-	const auto expression1 = parse_expression(pos2);
+	const auto expression1 = parse_expression(tree, pos2);
 
-	const auto statement = make_parser_node(location_t(start.pos()), parse_tree_statement_opcode::k_return, { expression1.first } );
+	auto node = make_parse_node(parse_node_opcode::k_return, location_t(start.pos()));
+	node.a = expression1.first;
 	const auto pos = skip_whitespace(expression1.second.rest1());
-	return { statement, pos };
+	return { add_node(tree, node), pos };
 }
 
 QUARK_TEST("", "parse_block()", "Block with two binds", ""){
 	ut_verify(QUARK_POS,
-		parse_return_statement(seq_t("return 0;")).first,
+		ut_parse(parse_return_statement, text_cursor_t("return 0;")).first,
 		parse_json(seq_t(
 			R"(
 				[0, "return", ["k", 0, "int"]]
@@ -164,10 +168,10 @@ struct a_result_t {
 	std::string identifier;
 
 	//	Points to "=" or end of sequence if no "=" was found.
-	seq_t rest;
+	text_cursor_t rest;
 };
 
-static a_result_t parse_a(types_t& types, const seq_t& p, const location_t& loc){
+static a_result_t parse_a(types_t& types, const text_cursor_t& p, const location_t& loc){
 	const auto pos = skip_whitespace(p);
 
 	//	Notice: if there is no type, only and identifier -- then we still get a type back: with an unresolved identifier.
@@ -189,45 +193,35 @@ static a_result_t parse_a(types_t& types, const seq_t& p, const location_t& loc)
 	}
 }
 
-std::pair<json_t, seq_t> parse_let(const seq_t& pos, const location_t& loc){
-	types_t types;
-
-	const auto a_result = parse_a(types, pos, loc);
+std::pair<parse_node_index_t, text_cursor_t> parse_let(parse_tree_t& tree, const text_cursor_t& pos, const location_t& loc){
+	const auto a_result = parse_a(tree.types, pos, loc);
 	if(a_result.rest.empty()){
 		throw_compiler_error(loc, "Require a value for new bind.");
 	}
 	const auto equal_sign = read_required(skip_whitespace(a_result.rest), "=");
-	const auto expression_pos = parse_expression(equal_sign);
-
-	const auto params = std::vector<json_t>{
-		type_to_json(types, a_result.type),
-		a_result.identifier,
-		expression_pos.first,
-	};
-	const auto statement = make_parser_node(loc, parse_tree_statement_opcode::k_init_local, params);
-	return { statement, expression_pos.second };
+	const auto expression_pos = parse_expression(tree, equal_sign);
+
+	auto node = make_parse_node(parse_node_opcode::k_init_local, loc);
+	node.type = a_result.type;
+	node.name = a_result.identifier;
+	node.a = expression_pos.first;
+	return { add_node(tree, node), expression_pos.second };
 }
 
-std::pair<json_t, seq_t> parse_mutable(const seq_t& pos, const location_t& loc){
-	types_t types;
-	const auto a_result = parse_a(types, pos, loc);
+std::pair<parse_node_index_t, text_cursor_t> parse_mutable(parse_tree_t& tree, const text_cursor_t& pos, const location_t& loc){
+	const auto a_result = parse_a(tree.types, pos, loc);
 	if(a_result.rest.empty()){
 		throw_compiler_error(loc, "Require a value for new bind.");
 	}
 	const auto equal_sign = read_required(skip_whitespace(a_result.rest), "=");
-	const auto expression_pos = parse_expression(equal_sign);
-
-	const auto meta = (json_t::make_object({ std::pair<std::string, json_t>{"mutable", true } }));
-
-	const auto params = std::vector<json_t>{
-		type_to_json(types, a_result.type),
-		a_result.identifier,
-		expression_pos.first,
-		meta
-	};
-	const auto statement = make_parser_node(loc, parse_tree_statement_opcode::k_init_local, params);
-
-	return { statement, expression_pos.second };
+	const auto expression_pos = parse_expression(tree, equal_sign);
+
+	auto node = make_parse_node(parse_node_opcode::k_init_local, loc);
+	node.type = a_result.type;
+	node.name = a_result.identifier;
+	node.a = expression_pos.first;
+	node.flag = true;
+	return { add_node(tree, node), expression_pos.second };
 }
 
 //	BIND:			let int x = 10
@@ -245,18 +239,18 @@ std::pair<json_t, seq_t> parse_mutable(const seq_t& pos, const location_t& loc){
 //	[let]/[mutable] TYPE identifier = EXPRESSION
 //					|<----------->|		call this section a.
 
-std::pair<json_t, seq_t> parse_bind_statement(const seq_t& s){
+std::pair<parse_node_index_t, text_cursor_t> parse_bind_statement(parse_tree_t& tree, const text_cursor_t& s){
 	const auto start = skip_whitespace(s);
 	const auto loc = location_t(start.pos());
 
 	const auto let_pos = if_first(start, keyword_t::k_let);
 	if(let_pos.first){
-		return parse_let(let_pos.second, loc);
+		return parse_let(tree, let_pos.second, loc);
 	}
 
 	const auto mutable_pos = if_first(skip_whitespace(s), keyword_t::k_mutable);
 	if(mutable_pos.first){
-		return parse_mutable(mutable_pos.second, loc);
+		return parse_mutable(tree, mutable_pos.second, loc);
 	}
 
 	throw_compiler_error(loc, "Bind syntax error.");
@@ -272,7 +266,7 @@ QUARK_TEST("parse_bind_statement", "", "", ""){
 	try {
 		ut_verify_json_and_rest(
 			QUARK_POS,
-			parse_bind_statement(seq_t(input)),
+			ut_parse(parse_bind_statement, text_cursor_t(input)),
 			R"(
 				[ 0, "init-local", "int", "test", ["k", 123, "int"]]
 			)",
@@ -290,7 +284,7 @@ QUARK_TEST("parse_bind_statement", "", "", ""){
 QUARK_TEST("parse_bind_statement", "", "", ""){
 	ut_verify_json_and_rest(
 		QUARK_POS,
-		parse_bind_statement(seq_t("let int test = 123 let int a = 4 ")),
+		ut_parse(parse_bind_statement, text_cursor_t("let int test = 123 let int a = 4 ")),
 		R"(
 			[ 0, "init-local", "int", "test", ["k", 123, "int"]]
 		)",
@@ -302,7 +296,7 @@ QUARK_TEST("parse_bind_statement", "", "", ""){
 
 QUARK_TEST("parse_bind_statement", "", "", ""){
 	ut_verify(QUARK_POS,
-		parse_bind_statement(seq_t("let bool bb = true")).first,
+		ut_parse(parse_bind_statement, text_cursor_t("let bool bb = true")).first,
 		parse_json(seq_t(
 			R"(
 				[ 0, "init-local", "bool", "bb", ["k", true, "bool"]]
@@ -312,7 +306,7 @@ QUARK_TEST("parse_bind_statement", "", "", ""){
 }
 QUARK_TEST("parse_bind_statement", "", "", ""){
 	ut_verify(QUARK_POS,
-		parse_bind_statement(seq_t("let int hello = 3")).first,
+		ut_parse(parse_bind_statement, text_cursor_t("let int hello = 3")).first,
 		parse_json(seq_t(
 			R"(
 				[ 0, "init-local", "int", "hello", ["k", 3, "int"]]
@@ -323,7 +317,7 @@ QUARK_TEST("parse_bind_statement", "", "", ""){
 
 QUARK_TEST("parse_bind_statement", "", "", ""){
 	ut_verify(QUARK_POS,
-		parse_bind_statement(seq_t("mutable int a = 14")).first,
+		ut_parse(parse_bind_statement, text_cursor_t("mutable int a = 14")).first,
 		parse_json(seq_t(
 			R"(
 				[ 0, "init-local", "int", "a", ["k", 14, "int"], { "mutable": true }]
@@ -334,7 +328,7 @@ QUARK_TEST("parse_bind_statement", "", "", ""){
 
 QUARK_TEST("parse_bind_statement", "", "", ""){
 	ut_verify(QUARK_POS,
-		parse_bind_statement(seq_t("mutable hello = 3")).first,
+		ut_parse(parse_bind_statement, text_cursor_t("mutable hello = 3")).first,
 		parse_json(seq_t(
 			R"(
 				[ 0, "init-local", "undef", "hello", ["k", 3, "int"], { "mutable": true }]
@@ -346,7 +340,7 @@ QUARK_TEST("parse_bind_statement", "", "", ""){
 QUARK_TEST("parse_bind_statement", "", "", ""){
 	ut_verify_json_and_rest(
 		QUARK_POS,
-		parse_bind_statement(seq_t("let int (double, [string]) test = 123 let int a = 4 ")),
+		ut_parse(parse_bind_statement, text_cursor_t("let int (double, [string]) test = 123 let int a = 4 ")),
 		R"(
 			[0, "init-local", ["func", "int", ["double", ["vector", "string"]], true], "test", ["k", 123, "int"]]
 		)",
@@ -361,7 +355,7 @@ QUARK_TEST("parse_bind_statement", "", "", ""){
 //////////////////////////////////////////////////		parse_assign_statement()
 
 
-std::pair<json_t, seq_t> parse_assign_statement(const seq_t& s){
+std::pair<parse_node_index_t, text_cursor_t> parse_assign_statement(parse_tree_t& tree, const text_cursor_t& s){
 	const auto start = skip_whitespace(s);
 	const auto variable_pos = read_identifier(start);
 	if(variable_pos.first.empty()){
@@ -369,15 +363,17 @@ std::pair<json_t, seq_t> parse_assign_statement(const seq_t& s){
 	}
 	const auto equal_pos = read_required_char(skip_whitespace(variable_pos.second), '=');
 	const auto rhs_seq = skip_whitespace(equal_pos);
-	const auto expression_fr = parse_expression(rhs_seq);
+	const auto expression_fr = parse_expression(tree, rhs_seq);
 
-	const auto statement = make_parser_node(location_t(start.pos()), parse_tree_statement_opcode::k_assign, { variable_pos.first, expression_fr.first });
-	return { statement, expression_fr.second };
+	auto node = make_parse_node(parse_node_opcode::k_assign, location_t(start.pos()));
+	node.name = variable_pos.first;
+	node.a = expression_fr.first;
+	return { add_node(tree, node), expression_fr.second };
 }
 
 QUARK_TEST("", "parse_assign_statement()", "", ""){
 	ut_verify(QUARK_POS,
-		parse_assign_statement(seq_t("x = 10;")).first,
+		ut_parse(parse_assign_statement, text_cursor_t("x = 10;")).first,
 		parse_json(seq_t(
 			R"(
 				[ 0, "assign","x",["k",10,"int"] ]
@@ -390,17 +386,18 @@ QUARK_TEST("", "parse_assign_statement()", "", ""){
 //////////////////////////////////////////////////		parse_expression_statement()
 
 
-std::pair<json_t, seq_t> parse_expression_statement(const seq_t& s){
+std::pair<parse_node_index_t, text_cursor_t> parse_expression_statement(parse_tree_t& tree, const text_cursor_t& s){
 	const auto start = skip_whitespace(s);
-	const auto expression_fr = parse_expression(start);
+	const auto expression_fr = parse_expression(tree, start);
 
-	const auto statement = make_parser_node(location_t(start.pos()), parse_tree_statement_opcode::k_expression_statement, { expression_fr.first } );
-	return { statement, expression_fr.second };
+	auto node = make_parse_node(parse_node_opcode::k_expression_statement, location_t(start.pos()));
+	node.a = expression_fr.first;
+	return { add_node(tree, node), expression_fr.second };
 }
 
 QUARK_TEST("", "parse_expression_statement()", "", ""){
 	ut_verify(QUARK_POS,
-		parse_expression_statement(seq_t("print(14);")).first,
+		ut_parse(parse_expression_statement, text_cursor_t("print(14);")).first,
 		parse_json(seq_t(
 			R"(
 				[ 0, "expression-statement", [ "call", ["@", "print"], [["k", 14, "int"]] ] ]
@@ -414,68 +411,54 @@ QUARK_TEST("", "parse_expression_statement()", "", ""){
 //////////////////////////////////////////////////		parse_function_definition_statement()
 
 
-parse_result_t parse_optional_statement_body(const seq_t& s){
+//	Returns false if there is no body.
+std::pair<bool, parse_result_t> parse_optional_statement_body(parse_tree_t& tree, const text_cursor_t& s){
 	const auto bracket_pos = read_optional_char(skip_whitespace(s), '{');
 	if(bracket_pos.first){
-		const auto body = parse_statement_body(s);
-		return body;
+		const auto body = parse_statement_body(tree, s);
+		return { true, body };
 	}
 	else{
-		return { json_t(), s };
+		return { false, parse_result_t{ k_empty_parse_node_list, s } };
 	}
 }
 
 
-std::pair<json_t, seq_t> parse_function_definition_statement(const seq_t& pos){
-	types_t temp;
+std::pair<parse_node_index_t, text_cursor_t> parse_function_definition_statement(parse_tree_t& tree, const text_cursor_t& pos){
+	auto& types = tree.types;
 
 	const auto start = skip_whitespace(pos);
 	const auto func_pos = read_required(start, keyword_t::k_func);
-	const auto return_type_pos = read_required_type(temp, func_pos);
+	const auto return_type_pos = read_required_type(types, func_pos);
 	const auto function_name_pos = read_required_identifier(return_type_pos.second);
-	const auto named_args_pos = read_functiondef_arg_parantheses(temp, skip_whitespace(function_name_pos.second));
+	const auto named_args_pos = read_functiondef_arg_parantheses(types, skip_whitespace(function_name_pos.second));
 
 	const auto impure_pos = if_first(skip_whitespace(named_args_pos.second), keyword_t::k_impure);
 
-	const auto body = parse_optional_statement_body(impure_pos.second);
+	const auto body = parse_optional_statement_body(tree, impure_pos.second);
 
-	const auto named_args = members_to_json(temp, named_args_pos.first);
 	const auto function_name = function_name_pos.first;
 
-	const auto body_json = body.parse_tree.is_null()
-	? json_t()
-	: json_t::make_object({
-		{ "statements", body.parse_tree },
-		{ "symbols", {} }
-	});
-
 	std::vector<type_t> arg_types;
 	for(const auto& e: named_args_pos.first){
 		arg_types.push_back(e._type);
 	}
 
-	const auto function_type = make_function(temp, return_type_pos.first, arg_types, impure_pos.first ? epure::impure : epure::pure);
-	const auto func_def_expr = make_parser_node(
-		location_t(k_no_location),
-		parse_tree_expression_opcode_t::k_function_def,
-		{
-			type_to_json(temp, function_type),
-			function_name,
-			named_args,
-			body_json
-		}
-	);
-
-	const auto s = make_parser_node(
-		location_t(start.pos()),
-		parse_tree_statement_opcode::k_init_local,
-		{
-			type_to_json(temp, function_type),
-			function_name,
-			func_def_expr
-		}
-	);
-	return { s, body.pos };
+	const auto function_type = make_function(types, return_type_pos.first, arg_types, impure_pos.first ? epure::impure : epure::pure);
+
+	auto func_def_expr = make_parse_node(parse_node_opcode::k_function_def, k_no_location);
+	func_def_expr.type = function_type;
+	func_def_expr.name = function_name;
+	func_def_expr.payload = static_cast<uint32_t>(tree.members.size());
+	func_def_expr.flag = body.first;
+	func_def_expr.list = body.second.statements;
+	tree.members.push_back(named_args_pos.first);
+
+	auto node = make_parse_node(parse_node_opcode::k_init_local, location_t(start.pos()));
+	node.type = function_type;
+	node.name = function_name;
+	node.a = add_node(tree, func_def_expr);
+	return { add_node(tree, node), body.second.pos };
 }
 
 struct test {
@@ -495,14 +478,14 @@ QUARK_TEST("", "parse_function_definition_statement()", "Minimal function IMPURE
 			["function-def", ["func", "int", [], false], "f", [], { "statements": [[21, "return", ["k", 3, "int"]]], "symbols": null }]
 		]
 	)";
-	ut_verify(QUARK_POS, parse_function_definition_statement(seq_t(input)).first, parse_json(seq_t(expected)).first);
+	ut_verify(QUARK_POS, ut_parse(parse_function_definition_statement, text_cursor_t(input)).first, parse_json(seq_t(expected)).first);
 }
 
 
 QUARK_TEST("", "parse_function_definition_statement()", "function", "Correct output JSON"){
 	ut_verify(
 		QUARK_POS,
-		parse_function_definition_statement(seq_t("func int f(){ return 3; }")).first,
+		ut_parse(parse_function_definition_statement, text_cursor_t("func int f(){ return 3; }")).first,
 		parse_json(seq_t(
 			R"___(
 
@@ -523,7 +506,7 @@ QUARK_TEST("", "parse_function_definition_statement()", "function", "Correct out
 QUARK_TEST("", "parse_function_definition_statement()", "3 args of different types", "Correct output JSON"){
 	ut_verify(
 		QUARK_POS,
-		parse_function_definition_statement(seq_t("func int printf(string a, double barry, int c){ return 3; }")).first,
+		ut_parse(parse_function_definition_statement, text_cursor_t("func int printf(string a, double barry, int c){ return 3; }")).first,
 		parse_json(seq_t(
 			R"___(
 
@@ -550,7 +533,7 @@ QUARK_TEST("", "parse_function_definition_statement()", "3 args of different typ
 QUARK_TEST("", "parse_function_definition_statement()", "Max whitespace", "Correct output JSON"){
 	ut_verify(
 		QUARK_POS,
-		parse_function_definition_statement(seq_t(" func  \t int \t printf( \t string \t a \t , \t double \t b \t ){ \t return \t 3 \t ; \t } \t ")).first,
+		ut_parse(parse_function_definition_statement, text_cursor_t(" func  \t int \t printf( \t string \t a \t , \t double \t b \t ){ \t return \t 3 \t ; \t } \t ")).first,
 		parse_json(seq_t(
 			R"___(
 
@@ -576,7 +559,7 @@ QUARK_TEST("", "parse_function_definition_statement()", "Max whitespace", "Corre
 QUARK_TEST("", "parse_function_definition_statement()", "Min whitespace", "Correct output JSON"){
 	ut_verify(
 		QUARK_POS,
-		parse_function_definition_statement(seq_t("func int printf(string a,double b){return 3;}")).first,
+		ut_parse(parse_function_definition_statement, text_cursor_t("func int printf(string a,double b){return 3;}")).first,
 		parse_json(seq_t(
 			R"___(
 
@@ -604,7 +587,9 @@ QUARK_TEST("", "parse_function_definition_statement()", "Min whitespace", "Corre
 //////////////////////////////////////////////////		parse_struct_definition_statement()
 
 
-static std::pair<json_t, seq_t>  parse_struct_definition_body(types_t& types, const seq_t& p, const std::string& name, const location_t& location){
+static std::pair<parse_node_index_t, text_cursor_t>  parse_struct_definition_body(parse_tree_t& tree, const text_cursor_t& p, const std::string& name, const location_t& location){
+	auto& types = tree.types;
+
 	const auto s2 = skip_whitespace(p);
 	const auto start = s2;
 	auto pos = read_required_char(s2, '{');
@@ -618,41 +603,31 @@ static std::pair<json_t, seq_t>  parse_struct_definition_body(types_t& types, co
 	}
 	pos = read_required(pos, "}");
 
-	const auto struct_def_expr = make_parser_node(
-		location_t(k_no_location),
-		parse_tree_expression_opcode_t::k_struct_def,
-		{
-			name,
-			members_to_json(types, members)
-		}
-	);
+	auto struct_def_expr = make_parse_node(parse_node_opcode::k_struct_def, k_no_location);
+	struct_def_expr.name = name;
+	struct_def_expr.payload = static_cast<uint32_t>(tree.members.size());
+	tree.members.push_back(members);
 
-	const auto s = make_parser_node(
-		location_t(start.pos()),
-		parse_tree_statement_opcode::k_expression_statement,
-		{
-			struct_def_expr
-		}
-	);
-	return { s, pos };
+	auto node = make_parse_node(parse_node_opcode::k_expression_statement, location_t(start.pos()));
+	node.a = add_node(tree, struct_def_expr);
+	return { add_node(tree, node), pos };
 }
 
-std::pair<json_t, seq_t>  parse_struct_definition_statement(const seq_t& pos0){
-	types_t types;
-	std::pair<bool, seq_t> token_pos = if_first(pos0, keyword_t::k_struct);
+std::pair<parse_node_index_t, text_cursor_t>  parse_struct_definition_statement(parse_tree_t& tree, const text_cursor_t& pos0){
+	std::pair<bool, text_cursor_t> token_pos = if_first(pos0, keyword_t::k_struct);
 	QUARK_ASSERT(token_pos.first);
 
 	const auto struct_name_pos = read_required_identifier(token_pos.second);
 	const auto location = location_t(pos0.pos());
 
 	const auto s2 = skip_whitespace(struct_name_pos.second);
-	const auto b = parse_struct_definition_body(types, s2, struct_name_pos.first, location);
+	const auto b = parse_struct_definition_body(tree, s2, struct_name_pos.first, location);
 	return b;
 }
 
 
 QUARK_TEST("parser", "parse_struct_definition_statement", "", ""){
-	const auto r = parse_struct_definition_statement(seq_t("struct a {int x; string y; double z;}"));
+	const auto r = ut_parse(parse_struct_definition_statement, text_cursor_t("struct a {int x; string y; double z;}"));
 
 	const auto expected = parse_json(seq_t(
 		R"___(
@@ -675,14 +650,15 @@ QUARK_TEST("parser", "parse_struct_definition_statement", "", ""){
 //////////////////////////////////////////////////		parse_protocol_definition_statement()
 
 
-std::pair<json_t, seq_t>  parse_protocol_definition_body(const seq_t& p, const std::string& name){
+std::pair<json_t, text_cursor_t>  parse_protocol_definition_body(const text_cursor_t& p, const std::string& name){
 	const auto start = skip_whitespace(p);
 	read_required_char(start, '{');
 	const auto body_pos = get_balanced(start);
 
 	std::vector<member_t> functions;
 
-	auto pos = seq_t(trim_ends(body_pos.first));
+	const auto body = trim_ends(body_pos.first);
+	auto pos = text_cursor_t(body);
 	while(!pos.empty()){
 		const auto func_pos = read_required(skip_whitespace(pos), keyword_t::k_func);
 		const auto return_type_pos = read_required_type(func_pos);
@@ -717,9 +693,9 @@ std::pair<json_t, seq_t>  parse_protocol_definition_body(const seq_t& p, const s
 	return { r, skip_whitespace(body_pos.second) };
 }
 
-std::pair<json_t, seq_t>  parse_protocol_definition_statement(const seq_t& p){
+std::pair<json_t, text_cursor_t>  parse_protocol_definition_statement(const text_cursor_t& p){
 	const auto pos0 = skip_whitespace(p);
-	std::pair<bool, seq_t> token_pos = if_first(pos0, keyword_t::k_protocol);
+	std::pair<bool, text_cursor_t> token_pos = if_first(pos0, keyword_t::k_protocol);
 	QUARK_ASSERT(token_pos.first);
 
 	const auto protocol_name_pos = read_required_identifier(token_pos.second);
@@ -737,7 +713,7 @@ const std::string k_test_protocol0 = R"(
 
 #if 0
 OFF_QUARK_UNIT_TEST("parse_protocol_definition_statement", "", "", ""){
-	const auto r = parse_protocol_definition_statement(seq_t(k_test_protocol0));
+	const auto r = ut_parse(parse_protocol_definition_statement, text_cursor_t(k_test_protocol0));
 
 	const auto expected =
 	json_t::make_array({
@@ -784,19 +760,19 @@ OFF_QUARK_UNIT_TEST("parse_protocol_definition_statement", "", "", ""){
 		a
 	}
 */
-std::pair<json_t, seq_t> parse_if(const seq_t& pos){
+std::pair<parse_node_index_t, text_cursor_t> parse_if(parse_tree_t& tree, const text_cursor_t& pos){
 	const auto start = skip_whitespace(pos);
 	const auto a = if_first(start, keyword_t::k_if);
 	QUARK_ASSERT(a.first);
 
 	const auto condition = read_enclosed_in_parantheses(a.second);
-	const auto then_body = parse_statement_body(condition.second);
-	const auto condition2 = parse_expression(seq_t(condition.first));
+	const auto then_body = parse_statement_body(tree, condition.second);
+	const auto condition2 = parse_expression(tree, text_cursor_t(condition.first));
 
-	return {
-		make_parser_node(location_t(start.pos()), parse_tree_statement_opcode::k_if, { condition2.first, then_body.parse_tree } ),
-		then_body.pos
-	};
+	auto node = make_parse_node(parse_node_opcode::k_if, location_t(start.pos()));
+	node.a = condition2.first;
+	node.list = then_body.statements;
+	return { add_node(tree, node), then_body.pos };
 }
 
 /*
@@ -807,46 +783,30 @@ std::pair<json_t, seq_t> parse_if(const seq_t& pos){
 	Ex 4: "else if (EXPRESSION) { STATEMENTS } else { STATEMENTS }"
 	Ex 5: "else if (EXPRESSION) { STATEMENTS } else if (EXPRESSION) { STATEMENTS } else { STATEMENTS }"
 */
-std::pair<json_t, seq_t> parse_if_statement(const seq_t& pos){
+std::pair<parse_node_index_t, text_cursor_t> parse_if_statement(parse_tree_t& tree, const text_cursor_t& pos){
 	const auto start = skip_whitespace(pos);
 
-	const auto if_statement2 = parse_if(start);
-	std::pair<bool, seq_t> else_start = if_first(skip_whitespace(if_statement2.second), keyword_t::k_else);
+	const auto if_statement2 = parse_if(tree, start);
+	std::pair<bool, text_cursor_t> else_start = if_first(skip_whitespace(if_statement2.second), keyword_t::k_else);
 	if(else_start.first){
 		const auto pos2 = skip_whitespace(else_start.second);
-		std::pair<bool, seq_t> elseif_pos = if_first(pos2, keyword_t::k_if);
+		std::pair<bool, text_cursor_t> elseif_pos = if_first(pos2, keyword_t::k_if);
 
 		if(elseif_pos.first){
-			const auto elseif_statement2 = parse_if_statement(pos2);
-
-			return {
-				make_parser_node(
-					location_t(start.pos()),
-					parse_tree_statement_opcode::k_if,
-					{
-						if_statement2.first.get_array_n(2),
-						if_statement2.first.get_array_n(3),
-						json_t::make_array({elseif_statement2.first})
-					}
-				),
-				elseif_statement2.second
-			};
+			const auto elseif_statement2 = parse_if_statement(tree, pos2);
+
+			auto& node = tree.nodes[if_statement2.first];
+			node.flag = true;
+			node.list2 = add_list(tree, { elseif_statement2.first });
+			return { if_statement2.first, elseif_statement2.second };
 		}
 		else{
-			const auto else_body = parse_statement_body(pos2);
-
-			return {
-				make_parser_node(
-					location_t(start.pos()),
-					parse_tree_statement_opcode::k_if,
-					{
-						if_statement2.first.get_array_n(2),
-						if_statement2.first.get_array_n(3),
-						else_body.parse_tree
-					}
-				),
-				else_body.pos
-			};
+			const auto else_body = parse_statement_body(tree, pos2);
+
+			auto& node = tree.nodes[if_statement2.first];
+			node.flag = true;
+			node.list2 = else_body.statements;
+			return { if_statement2.first, else_body.pos };
 		}
 	}
 	else{
@@ -856,7 +816,7 @@ std::pair<json_t, seq_t> parse_if_statement(const seq_t& pos){
 
 QUARK_TEST("", "parse_if_statement()", "if(){}", ""){
 	ut_verify(QUARK_POS,
-		parse_if_statement(seq_t("if (1 > 2) { return 3 }")).first,
+		ut_parse(parse_if_statement, text_cursor_t("if (1 > 2) { return 3 }")).first,
 		parse_json(seq_t(
 			R"(
 				[
@@ -874,7 +834,7 @@ QUARK_TEST("", "parse_if_statement()", "if(){}", ""){
 
 QUARK_TEST("", "parse_if_statement()", "if(){}else{}", ""){
 	ut_verify(QUARK_POS,
-		parse_if_statement(seq_t("if (1 > 2) { return 3 } else { return 4 }")).first,
+		ut_parse(parse_if_statement, text_cursor_t("if (1 > 2) { return 3 } else { return 4 }")).first,
 		parse_json(seq_t(
 			R"(
 				[
@@ -895,7 +855,7 @@ QUARK_TEST("", "parse_if_statement()", "if(){}else{}", ""){
 
 QUARK_TEST("", "parse_if_statement()", "if(){}else{}", ""){
 	ut_verify(QUARK_POS,
-		parse_if_statement(seq_t("if (1 > 2) { return 3 } else { return 4 }")).first,
+		ut_parse(parse_if_statement, text_cursor_t("if (1 > 2) { return 3 } else { return 4 }")).first,
 		parse_json(seq_t(
 			R"(
 				[
@@ -916,8 +876,9 @@ QUARK_TEST("", "parse_if_statement()", "if(){}else{}", ""){
 
 QUARK_TEST("", "parse_if_statement()", "if(){} else if(){} else {}", ""){
 	ut_verify(QUARK_POS,
-		parse_if_statement(
-			seq_t("if (1 == 1) { return 1 } else if(2 == 2) { return 2 } else if(3 == 3) { return 3 } else { return 4 }")
+		ut_parse(
+			parse_if_statement,
+			text_cursor_t("if (1 == 1) { return 1 } else if(2 == 2) { return 2 } else if(3 == 3) { return 3 } else { return 4 }")
 		).first,
 		parse_json(seq_t(
 			R"(
@@ -957,13 +918,13 @@ QUARK_TEST("", "parse_if_statement()", "if(){} else if(){} else {}", ""){
 struct range_def_t {
 	std::string _start;
 	std::string _range_type;
-	seq_t _end_pos;
+	text_cursor_t _end_pos;
 };
 
 //	Closed range == "1 ... 5 ".
 //	Open range == "1 ..< 5 ".
 //	left_and_right == "1 ", " 5 ".
-range_def_t parse_range(const seq_t& pos){
+range_def_t parse_range(const text_cursor_t& pos){
 	const auto start_end = split_at(pos, "...");
 	if(start_end.first != ""){
 		return { start_end.first, "...", start_end.second };
@@ -978,17 +939,17 @@ range_def_t parse_range(const seq_t& pos){
 }
 
 
-std::pair<json_t, seq_t> parse_for_statement(const seq_t& pos){
-	std::pair<bool, seq_t> for_pos = if_first(pos, keyword_t::k_for);
+std::pair<parse_node_index_t, text_cursor_t> parse_for_statement(parse_tree_t& tree, const text_cursor_t& pos){
+	std::pair<bool, text_cursor_t> for_pos = if_first(pos, keyword_t::k_for);
 	QUARK_ASSERT(for_pos.first);
 
 	//	header == " index in 1 ... 5 "
 	const auto header = read_enclosed_in_parantheses(for_pos.second);
 
-	const auto body = parse_statement_body(header.second);
+	const auto body = parse_statement_body(tree, header.second);
 
 	//	iterator == "index".
-	const auto iterator_name = read_required_identifier(seq_t(header.first));
+	const auto iterator_name = read_required_identifier(text_cursor_t(header.first));
 	if(iterator_name.first.empty()){
 		throw_compiler_error(location_t(pos.pos()), "For loop requires iterator name.");
 	}
@@ -1002,26 +963,21 @@ std::pair<json_t, seq_t> parse_for_statement(const seq_t& pos){
 	const auto range_type = range_parts._range_type;
 	const auto end_pos = range_parts._end_pos;
 
-	const auto start_expr = parse_expression(seq_t(start)).first;
-	const auto end_expr = parse_expression(end_pos).first;
+	const auto start_expr = parse_expression(tree, text_cursor_t(start)).first;
+	const auto end_expr = parse_expression(tree, end_pos).first;
 
-	const auto r = make_parser_node(
-		location_t(pos.pos()),
-		parse_tree_statement_opcode::k_for,
-		{
-			range_type == "..." ? "closed-range" : "open-range",
-			iterator_name.first,
-			start_expr,
-			end_expr,
-			body.parse_tree
-		}
-	);
-	return { r, body.pos };
+	auto node = make_parse_node(parse_node_opcode::k_for, location_t(pos.pos()));
+	node.flag = range_type == "..<";
+	node.name = iterator_name.first;
+	node.a = start_expr;
+	node.b = end_expr;
+	node.list = body.statements;
+	return { add_node(tree, node), body.pos };
 }
 
 QUARK_TEST("", "parse_for_statement()", "for(){}", ""){
 	ut_verify(QUARK_POS,
-		parse_for_statement(seq_t("for ( index in 1...5 ) { let int y = 11 }")).first,
+		ut_parse(parse_for_statement, text_cursor_t("for ( index in 1...5 ) { let int y = 11 }")).first,
 		parse_json(seq_t(
 			R"(
 				[
@@ -1041,7 +997,7 @@ QUARK_TEST("", "parse_for_statement()", "for(){}", ""){
 }
 QUARK_TEST("", "parse_for_statement()", "for(){}", ""){
 	ut_verify(QUARK_POS,
-		parse_for_statement(seq_t("for ( index in 1..<5 ) { let int y = 11 }")).first,
+		ut_parse(parse_for_statement, text_cursor_t("for ( index in 1..<5 ) { let int y = 11 }")).first,
 		parse_json(seq_t(
 			R"(
 				[
@@ -1062,7 +1018,7 @@ QUARK_TEST("", "parse_for_statement()", "for(){}", ""){
 #if 0
 QUARK_TEST("", "parse_for_statement()", "for(){}", ""){
 	ut_verify(QUARK_POS,
-		parse_for_statement(seq_t("for(v in 0 ..< size(benchmark_result)){ let int y = 11 }")).first,
+		ut_parse(parse_for_statement, text_cursor_t("for(v in 0 ..< size(benchmark_result)){ let int y = 11 }")).first,
 		parse_json(seq_t(
 			R"(
 				[
@@ -1086,28 +1042,23 @@ QUARK_TEST("", "parse_for_statement()", "for(){}", ""){
 //////////////////////////////////////////////////		parse_while_statement()
 
 
-std::pair<json_t, seq_t> parse_while_statement(const seq_t& pos){
-	std::pair<bool, seq_t> pos2 = if_first(pos, keyword_t::k_while);
+std::pair<parse_node_index_t, text_cursor_t> parse_while_statement(parse_tree_t& tree, const text_cursor_t& pos){
+	std::pair<bool, text_cursor_t> pos2 = if_first(pos, keyword_t::k_while);
 	QUARK_ASSERT(pos2.first);
 
 	const auto condition = read_enclosed_in_parantheses(pos2.second);
-	const auto body = parse_statement_body(condition.second);
+	const auto body = parse_statement_body(tree, condition.second);
 
-	const auto condition_expr = parse_expression(seq_t(condition.first)).first;
-	const auto r = make_parser_node(
-		location_t(pos.pos()),
-		parse_tree_statement_opcode::k_while,
-		{
-			condition_expr,
-			body.parse_tree
-		}
-	);
-	return { r, body.pos };
+	const auto condition_expr = parse_expression(tree, text_cursor_t(condition.first)).first;
+	auto node = make_parse_node(parse_node_opcode::k_while, location_t(pos.pos()));
+	node.a = condition_expr;
+	node.list = body.statements;
+	return { add_node(tree, node), body.pos };
 }
 
 QUARK_TEST("", "parse_while_statement()", "while(){}", ""){
 	ut_verify(QUARK_POS, 
-		parse_while_statement(seq_t("while (a < 10) { print(a) }")).first,
+		ut_parse(parse_while_statement, text_cursor_t("while (a < 10) { print(a) }")).first,
 		parse_json(seq_t(
 			R"(
 				[
@@ -1136,29 +1087,24 @@ QUARK_TEST("", "parse_while_statement()", "while(){}", ""){
 
 
 
-std::pair<json_t, seq_t> parse_benchmark_def_statement(const seq_t& pos0){
+std::pair<parse_node_index_t, text_cursor_t> parse_benchmark_def_statement(parse_tree_t& tree, const text_cursor_t& pos0){
 	const auto pos = skip_whitespace(pos0);
-	std::pair<bool, seq_t> pos2 = if_first(pos, keyword_t::k_benchmark_def);
+	std::pair<bool, text_cursor_t> pos2 = if_first(pos, keyword_t::k_benchmark_def);
 	QUARK_ASSERT(pos2.first);
 
 //	const auto name = parse_expression(pos2.second);
 	const auto name_pos = parse_string_literal(skip_whitespace(pos2.second));
-	const auto body = parse_statement_body(name_pos.second);
+	const auto body = parse_statement_body(tree, name_pos.second);
 
-	const auto r = make_parser_node(
-		location_t(pos.pos()),
-		parse_tree_statement_opcode::k_benchmark_def,
-		{
-			name_pos.first,
-			body.parse_tree
-		}
-	);
-	return { r, body.pos };
+	auto node = make_parse_node(parse_node_opcode::k_benchmark_def, location_t(pos.pos()));
+	node.name = name_pos.first;
+	node.list = body.statements;
+	return { add_node(tree, node), body.pos };
 }
 
 QUARK_TEST("", "parse_benchmark_def_statement()", "while(){}", ""){
 	ut_verify(QUARK_POS,
-		parse_benchmark_def_statement(seq_t(R"___(
+		ut_parse(parse_benchmark_def_statement, text_cursor_t(R"___(
 
 			benchmark-def "Linear veq 0" {
 				print(1234)
@@ -1184,11 +1130,18 @@ QUARK_TEST("", "parse_benchmark_def_statement()", "while(){}", ""){
 
 //////////////////////////////////////////////////		parse_software_system_statement()
 
+
+//	parse_json() reads a seq_t: parse a copy of the rest and advance the cursor as many characters.
+static std::pair<json_t, text_cursor_t> parse_json_literal(const text_cursor_t& s){
+	const auto r = parse_json(seq_t(s.str()));
+	return { r.first, s.rest(s.size() - r.second.size()) };
+}
+
 /*
 	software-system-def: JSON
 */
 
-std::pair<json_t, seq_t> parse_software_system_def_statement(const seq_t& s){
+std::pair<parse_node_index_t, text_cursor_t> parse_software_system_def_statement(parse_tree_t& tree, const text_cursor_t& s){
 	const auto start = skip_whitespace(s);
 	const auto loc = location_t(start.pos());
 	const auto ss_pos = if_first(start, keyword_t::k_software_system);
@@ -1197,9 +1150,12 @@ std::pair<json_t, seq_t> parse_software_system_def_statement(const seq_t& s){
 	}
 
 	//??? Instead of parsing a static JSON literal, we could parse a Floyd expression that results in a JSON value = use variables etc.
-	std::pair<json_t, seq_t> json_pos = parse_json(ss_pos.second);
-	const auto r = make_parser_node(loc, parse_tree_statement_opcode::k_software_system_def, { json_pos.first } );
-	return { r, json_pos.second };
+	std::pair<json_t, text_cursor_t> json_pos = parse_json_literal(ss_pos.second);
+
+	auto node = make_parse_node(parse_node_opcode::k_software_system_def, loc);
+	node.payload = static_cast<uint32_t>(tree.json_data.size());
+	tree.json_data.push_back(json_pos.first);
+	return { add_node(tree, node), json_pos.second };
 }
 
 
@@ -1209,7 +1165,7 @@ std::pair<json_t, seq_t> parse_software_system_def_statement(const seq_t& s){
 	container-def: JSON
 */
 
-std::pair<json_t, seq_t> parse_container_def_statement(const seq_t& s){
+std::pair<parse_node_index_t, text_cursor_t> parse_container_def_statement(parse_tree_t& tree, const text_cursor_t& s){
 	const auto start = skip_whitespace(s);
 	const auto loc = location_t(start.pos());
 	const auto ss_pos = if_first(start, keyword_t::k_container_def);
@@ -1218,10 +1174,12 @@ std::pair<json_t, seq_t> parse_container_def_statement(const seq_t& s){
 	}
 
 	//??? Instead of parsing a static JSON literal, we could parse a Floyd expression that results in a JSON value = use variables etc.
-	std::pair<json_t, seq_t> json_pos = parse_json(ss_pos.second);
+	std::pair<json_t, text_cursor_t> json_pos = parse_json_literal(ss_pos.second);
 
-	const auto r = make_parser_node(loc, parse_tree_statement_opcode::k_container_def, { json_pos.first } );
-	return { r, json_pos.second };
+	auto node = make_parse_node(parse_node_opcode::k_container_def, loc);
+	node.payload = static_cast<uint32_t>(tree.json_data.size());
+	tree.json_data.push_back(json_pos.first);
+	return { add_node(tree, node), json_pos.second };
 }
 
 }	// parser
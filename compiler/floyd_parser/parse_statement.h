@@ -11,12 +11,13 @@
 
 /*
 	Functions to parse every type of statement in the Floyd syntax.
+	Each adds its nodes to the parse tree. OUTPUT shows the node as generated by parse_tree_to_json().
 */
 
 #include "quark.h"
+#include "parse_tree.h"
 
-struct seq_t;
-struct json_t;
+struct text_cursor_t;
 
 namespace floyd {
 namespace parser {
@@ -38,7 +39,7 @@ struct parse_result_t;
 			...
 		]
 */
-parse_result_t parse_statement_body(const seq_t& s);
+parse_result_t parse_statement_body(parse_tree_t& tree, const text_cursor_t& s);
 
 /*
 	INPUT:
@@ -50,7 +51,7 @@ parse_result_t parse_statement_body(const seq_t& s);
 	OUTPUT:
 		["block", [ STATEMENTS ] ]
 */
-std::pair<json_t, seq_t> parse_block(const seq_t& s);
+std::pair<parse_node_index_t, text_cursor_t> parse_block(parse_tree_t& tree, const text_cursor_t& s);
 
 /*
 	INPUT:
@@ -63,24 +64,24 @@ std::pair<json_t, seq_t> parse_block(const seq_t& s);
 	OUTPUT:
 		["return", EXPRESSION ]
 */
-std::pair<json_t, seq_t> parse_return_statement(const seq_t& s);
+std::pair<parse_node_index_t, text_cursor_t> parse_return_statement(parse_tree_t& tree, const text_cursor_t& s);
 
 /*
 	OUTPUT:
 		[ "bind", "float", "x", EXPRESSION, { "mutable": true } ]
 */
-std::pair<json_t, seq_t> parse_bind_statement(const seq_t& s);
+std::pair<parse_node_index_t, text_cursor_t> parse_bind_statement(parse_tree_t& tree, const text_cursor_t& s);
 
-std::pair<json_t, seq_t> parse_assign_statement(const seq_t& s);
+std::pair<parse_node_index_t, text_cursor_t> parse_assign_statement(parse_tree_t& tree, const text_cursor_t& s);
 
-std::pair<json_t, seq_t> parse_expression_statement(const seq_t& s);
+std::pair<parse_node_index_t, text_cursor_t> parse_expression_statement(parse_tree_t& tree, const text_cursor_t& s);
 
 /*
 	Output is a bind of a variable with a function_def expression
 */
-std::pair<json_t, seq_t> parse_function_definition_statement(const seq_t& s);
+std::pair<parse_node_index_t, text_cursor_t> parse_function_definition_statement(parse_tree_t& tree, const text_cursor_t& s);
 
-std::pair<json_t, seq_t> parse_struct_definition_statement(const seq_t& s);
+std::pair<parse_node_index_t, text_cursor_t> parse_struct_definition_statement(parse_tree_t& tree, const text_cursor_t& s);
 
 
 
@@ -114,7 +115,7 @@ std::pair<json_t, seq_t> parse_struct_definition_statement(const seq_t& s);
 		["if", EXPRESSION, THEN_STATEMENTS ]
 		["if", EXPRESSION, THEN_STATEMENTS, ELSE_STATEMENTS ]
 */
-std::pair<json_t, seq_t> parse_if_statement(const seq_t& s);
+std::pair<parse_node_index_t, text_cursor_t> parse_if_statement(parse_tree_t& tree, const text_cursor_t& s);
 
 /*
 	for (index in 1...5) {
@@ -127,7 +128,7 @@ std::pair<json_t, seq_t> parse_if_statement(const seq_t& s);
 		[ "for", "closed-range", ITERATOR_NAME, START_EXPRESSION, END_EXPRESSION, BODY ]
 		[ "for", "open-range", ITERATOR_NAME, START_EXPRESSION, END_EXPRESSION, BODY ]
 */
-std::pair<json_t, seq_t> parse_for_statement(const seq_t& s);
+std::pair<parse_node_index_t, text_cursor_t> parse_for_statement(parse_tree_t& tree, const text_cursor_t& s);
 
 /*
 	while (a < 10) {
@@ -140,12 +141,12 @@ std::pair<json_t, seq_t> parse_for_statement(const seq_t& s);
 	OUTPUT
 		[ "while", "EXPRESSION, BODY ]
 */
-std::pair<json_t, seq_t> parse_while_statement(const seq_t& s);
-std::pair<json_t, seq_t> parse_benchmark_def_statement(const seq_t& s);
+std::pair<parse_node_index_t, text_cursor_t> parse_while_statement(parse_tree_t& tree, const text_cursor_t& s);
+std::pair<parse_node_index_t, text_cursor_t> parse_benchmark_def_statement(parse_tree_t& tree, const text_cursor_t& s);
 
-std::pair<json_t, seq_t> parse_software_system_def_statement(const seq_t& s);
+std::pair<parse_node_index_t, text_cursor_t> parse_software_system_def_statement(parse_tree_t& tree, const text_cursor_t& s);
 
-std::pair<json_t, seq_t> parse_container_def_statement(const seq_t& s);
+std::pair<parse_node_index_t, text_cursor_t> parse_container_def_statement(parse_tree_t& tree, const text_cursor_t& s);
 
 }	// parser
 }	//	floyd
@@ -0,0 +1,293 @@
+//
+//  parse_tree.cpp
+//  Floyd
+//
+//  Created by Marcus Zetterquist on 2026-10-18.
+//  Copyright © 2026 Marcus Zetterquist. All rights reserved.
+//
+
+#include "parse_tree.h"
+
+#include "text_parser.h"
+
+
+namespace floyd {
+namespace parser {
+
+
+////////////////////////////////		parse_node_opcode
+
+
+std::string parse_node_opcode_to_string(parse_node_opcode opcode){
+	switch(opcode){
+		case parse_node_opcode::k_literal: return "k";
+		case parse_node_opcode::k_load: return "@";
+		case parse_node_opcode::k_call: return "call";
+		case parse_node_opcode::k_resolve_member: return "->";
+		case parse_node_opcode::k_lookup_element: return "[]";
+		case parse_node_opcode::k_arithmetic_unary_minus: return "unary-minus";
+		case parse_node_opcode::k_conditional_operator: return "?:";
+		case parse_node_opcode::k_struct_def: return "struct-def";
+		case parse_node_opcode::k_function_def: return "function-def";
+		case parse_node_opcode::k_value_constructor: return "value-constructor";
+		case parse_node_opcode::k_benchmark: return "benchmark";
+
+		case parse_node_opcode::k_arithmetic_add: return "+";
+		case parse_node_opcode::k_arithmetic_subtract: return "-";
+		case parse_node_opcode::k_arithmetic_multiply: return "*";
+		case parse_node_opcode::k_arithmetic_divide: return "/";
+		case parse_node_opcode::k_arithmetic_remainder: return "%";
+
+		case parse_node_opcode::k_logical_and: return "&&";
+		case parse_node_opcode::k_logical_or: return "||";
+
+		case parse_node_opcode::k_comparison_smaller_or_equal: return "<=";
+		case parse_node_opcode::k_comparison_smaller: return "<";
+		case parse_node_opcode::k_comparison_larger_or_equal: return ">=";
+		case parse_node_opcode::k_comparison_larger: return ">";
+
+		case parse_node_opcode::k_logical_equal: return "==";
+		case parse_node_opcode::k_logical_nonequal: return "!=";
+
+		case parse_node_opcode::k_return: return "return";
+		case parse_node_opcode::k_init_local: return "init-local";
+		case parse_node_opcode::k_assign: return "assign";
+		case parse_node_opcode::k_block: return "block";
+		case parse_node_opcode::k_if: return "if";
+		case parse_node_opcode::k_for: return "for";
+		case parse_node_opcode::k_while: return "while";
+		case parse_node_opcode::k_expression_statement: return "expression-statement";
+		case parse_node_opcode::k_software_system_def: return "software-system-def";
+		case parse_node_opcode::k_container_def: return "container-def";
+		case parse_node_opcode::k_benchmark_def: return "benchmark-def";
+	}
+	QUARK_ASSERT(false);
+	throw std::exception();
+}
+
+
+////////////////////////////////		parse_node_t
+
+
+parse_node_t make_parse_node(parse_node_opcode opcode, const location_t& location){
+	return parse_node_t {
+		opcode,
+		false,
+		location,
+		k_no_parse_node,
+		k_no_parse_node,
+		k_no_parse_node,
+		k_empty_parse_node_list,
+		k_empty_parse_node_list,
+		make_undefined(),
+		0,
+		""
+	};
+}
+
+
+////////////////////////////////		parse_tree_t
+
+
+bool parse_tree_t::check_invariant() const {
+	QUARK_ASSERT(types.check_invariant());
+
+	const auto node_count = nodes.size();
+	for(const auto& e: lists){
+		QUARK_ASSERT(e < node_count);
+	}
+	QUARK_ASSERT(statements.begin + statements.count <= lists.size());
+	return true;
+}
+
+parse_node_index_t add_node(parse_tree_t& tree, const parse_node_t& node){
+	const auto index = static_cast<parse_node_index_t>(tree.nodes.size());
+	tree.nodes.push_back(node);
+	return index;
+}
+
+parse_node_index_t add_node(parse_tree_t& tree, parse_node_opcode opcode, parse_node_index_t a, parse_node_index_t b){
+	auto node = make_parse_node(opcode, k_no_location);
+	node.a = a;
+	node.b = b;
+	return add_node(tree, node);
+}
+
+//	Lists are appended after their nodes have been parsed, so nested lists never interleave.
+parse_node_list_t add_list(parse_tree_t& tree, const std::vector<parse_node_index_t>& nodes){
+	const auto begin = static_cast<uint32_t>(tree.lists.size());
+	tree.lists.insert(tree.lists.end(), nodes.begin(), nodes.end());
+	return parse_node_list_t{ begin, static_cast<uint32_t>(nodes.size()) };
+}
+
+parse_node_index_t add_literal_node(parse_tree_t& tree, const value_t& value){
+	auto node = make_parse_node(parse_node_opcode::k_literal, k_no_location);
+	node.payload = static_cast<uint32_t>(tree.literals.size());
+	tree.literals.push_back(value);
+	return add_node(tree, node);
+}
+
+
+////////////////////////////////		JSON
+
+
+json_t parse_node_list_to_json(const parse_tree_t& tree, const parse_node_list_t& list){
+	std::vector<json_t> result;
+	result.reserve(list.count);
+	for(uint32_t i = 0 ; i < list.count ; i++){
+		result.push_back(parse_node_to_json(tree, get_list_node(tree, list, i)));
+	}
+	return json_t::make_array(result);
+}
+
+json_t parse_node_to_json(const parse_tree_t& tree, parse_node_index_t index){
+	const auto& types = tree.types;
+	const auto& node = get_node(tree, index);
+
+	std::vector<json_t> params;
+	switch(node.opcode){
+		case parse_node_opcode::k_literal: {
+			const auto& value = tree.literals[node.payload];
+			params = { value_to_ast_json(types, value), type_to_json(types, value.get_type()) };
+			break;
+		}
+		case parse_node_opcode::k_load:
+			params = { node.name };
+			break;
+		case parse_node_opcode::k_call:
+			params = { parse_node_to_json(tree, node.a), parse_node_list_to_json(tree, node.list) };
+			break;
+		case parse_node_opcode::k_resolve_member:
+			params = { parse_node_to_json(tree, node.a), node.name };
+			break;
+		case parse_node_opcode::k_arithmetic_unary_minus:
+			params = { parse_node_to_json(tree, node.a) };
+			break;
+		case parse_node_opcode::k_conditional_operator:
+			params = { parse_node_to_json(tree, node.a), parse_node_to_json(tree, node.b), parse_node_to_json(tree, node.c) };
+			break;
+		case parse_node_opcode::k_struct_def:
+			params = { node.name, members_to_json(types, tree.members[node.payload]) };
+			break;
+		case parse_node_opcode::k_function_def: {
+			const auto body = node.flag
+				? json_t::make_object({
+					{ "statements", parse_node_list_to_json(tree, node.list) },
+					{ "symbols", {} }
+				})
+				: json_t();
+			params = { type_to_json(types, node.type), node.name, members_to_json(types, tree.members[node.payload]), body };
+			break;
+		}
+		case parse_node_opcode::k_value_constructor:
+			params = { type_to_json(types, node.type), parse_node_list_to_json(tree, node.list) };
+			break;
+		case parse_node_opcode::k_benchmark:
+			params = { parse_node_list_to_json(tree, node.list) };
+			break;
+
+		case parse_node_opcode::k_lookup_element:
+		case parse_node_opcode::k_arithmetic_add:
+		case parse_node_opcode::k_arithmetic_subtract:
+		case parse_node_opcode::k_arithmetic_multiply:
+		case parse_node_opcode::k_arithmetic_divide:
+		case parse_node_opcode::k_arithmetic_remainder:
+		case parse_node_opcode::k_logical_and:
+		case parse_node_opcode::k_logical_or:
+		case parse_node_opcode::k_comparison_smaller_or_equal:
+		case parse_node_opcode::k_comparison_smaller:
+		case parse_node_opcode::k_comparison_larger_or_equal:
+		case parse_node_opcode::k_comparison_larger:
+		case parse_node_opcode::k_logical_equal:
+		case parse_node_opcode::k_logical_nonequal:
+			params = { parse_node_to_json(tree, node.a), parse_node_to_json(tree, node.b) };
+			break;
+
+
+		case parse_node_opcode::k_return:
+			params = { parse_node_to_json(tree, node.a) };
+			break;
+		case parse_node_opcode::k_init_local:
+			params = { type_to_json(types, node.type), node.name, parse_node_to_json(tree, node.a) };
+			if(node.flag){
+				params.push_back(json_t::make_object({ { "mutable", true } }));
+			}
+			break;
+		case parse_node_opcode::k_assign:
+			params = { node.name, parse_node_to_json(tree, node.a) };
+			break;
+		case parse_node_opcode::k_block:
+			params = { parse_node_list_to_json(tree, node.list) };
+			break;
+		case parse_node_opcode::k_if:
+			params = { parse_node_to_json(tree, node.a), parse_node_list_to_json(tree, node.list) };
+			if(node.flag){
+				params.push_back(parse_node_list_to_json(tree, node.list2));
+			}
+			break;
+		case parse_node_opcode::k_for:
+			params = {
+				node.flag ? "open-range" : "closed-range",
+				node.name,
+				parse_node_to_json(tree, node.a),
+				parse_node_to_json(tree, node.b),
+				parse_node_list_to_json(tree, node.list)
+			};
+			break;
+		case parse_node_opcode::k_while:
+			params = { parse_node_to_json(tree, node.a), parse_node_list_to_json(tree, node.list) };
+			break;
+		case parse_node_opcode::k_expression_statement:
+			params = { parse_node_to_json(tree, node.a) };
+			break;
+		case parse_node_opcode::k_software_system_def:
+		case parse_node_opcode::k_container_def:
+			params = { tree.json_data[node.payload] };
+			break;
+		case parse_node_opcode::k_benchmark_def:
+			params = { node.name, parse_node_list_to_json(tree, node.list) };
+			break;
+	}
+
+	std::vector<json_t> result;
+	if((node.location == k_no_location) == false){
+		result.push_back(json_t(static_cast<double>(node.location.offset)));
+	}
+	result.push_back(parse_node_opcode_to_string(node.opcode));
+	result.insert(result.end(), params.begin(), params.end());
+	return json_t::make_array(result);
+}
+
+json_t parse_tree_to_json(const parse_tree_t& tree){
+	QUARK_ASSERT(tree.check_invariant());
+
+	return parse_node_list_to_json(tree, tree.statements);
+}
+
+
+
+QUARK_TEST("parser", "parse_tree_to_json()", "statement with nested expressions", ""){
+	parse_tree_t tree;
+	const auto sum = add_node(tree, parse_node_opcode::k_arithmetic_add, add_literal_node(tree, value_t::make_int(1)), add_literal_node(tree, value_t::make_int(2)));
+
+	auto statement = make_parse_node(parse_node_opcode::k_init_local, location_t(7));
+	statement.type = type_t::make_int();
+	statement.name = "x";
+	statement.a = sum;
+	statement.flag = true;
+	tree.statements = add_list(tree, { add_node(tree, statement) });
+
+	ut_verify(
+		QUARK_POS,
+		parse_tree_to_json(tree),
+		parse_json(seq_t(R"(
+			[
+				[7, "init-local", "int", "x", ["+", ["k", 1, "int"], ["k", 2, "int"]], { "mutable": true }]
+			]
+		)")).first
+	);
+}
+
+
+}	// parser
+}	//	floyd
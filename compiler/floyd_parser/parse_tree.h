@@ -0,0 +1,203 @@
+//
+//  parse_tree.h
+//  Floyd
+//
+//  Created by Marcus Zetterquist on 2026-10-18.
+//  Copyright © 2026 Marcus Zetterquist. All rights reserved.
+//
+
+#ifndef parse_tree_h
+#define parse_tree_h
+
+/*
+	The parser's output: a typed tree of statements and expressions. The parser builds it directly and
+	parse_tree_to_ast() reads it by switching on the opcode -- no JSON and no opcode strings in between.
+
+	All nodes of a program live in one parse_tree_t, nodes refer to each other using indexes. This keeps
+	nodes small, the parser never copies subtrees and the whole tree is freed at once.
+
+	parse_tree_to_json() generates the JSON format described in parse_tree.md, used by "floyd compile -p"
+	and the parser's unit tests.
+*/
+
+#include "types.h"
+#include "ast_value.h"
+#include "compiler_basics.h"
+#include "json_support.h"
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+namespace floyd {
+namespace parser {
+
+
+////////////////////////////////		parse_node_opcode
+
+
+enum class parse_node_opcode : uint8_t {
+	//	Expressions
+
+	k_literal,
+	k_load,
+	k_call,
+	k_resolve_member,
+	k_lookup_element,
+	k_arithmetic_unary_minus,
+	k_conditional_operator,
+	k_struct_def,
+	k_function_def,
+	k_value_constructor,
+	k_benchmark,
+
+	k_arithmetic_add,
+	k_arithmetic_subtract,
+	k_arithmetic_multiply,
+	k_arithmetic_divide,
+	k_arithmetic_remainder,
+
+	k_logical_and,
+	k_logical_or,
+
+	k_comparison_smaller_or_equal,
+	k_comparison_smaller,
+	k_comparison_larger_or_equal,
+	k_comparison_larger,
+
+	k_logical_equal,
+	k_logical_nonequal,
+
+
+	//	Statements
+
+	k_return,
+	k_init_local,
+	k_assign,
+	k_block,
+	k_if,
+	k_for,
+	k_while,
+	k_expression_statement,
+	k_software_system_def,
+	k_container_def,
+	k_benchmark_def
+};
+
+//	Returns the opcode string used by the JSON format, like "+" or "init-local".
+std::string parse_node_opcode_to_string(parse_node_opcode opcode);
+
+
+////////////////////////////////		parse_node_t
+
+
+typedef uint32_t parse_node_index_t;
+const parse_node_index_t k_no_parse_node = UINT32_MAX;
+
+//	A range of parse_tree_t::lists, holding node indexes.
+struct parse_node_list_t {
+	uint32_t begin;
+	uint32_t count;
+};
+inline bool operator==(const parse_node_list_t& lhs, const parse_node_list_t& rhs){
+	return lhs.begin == rhs.begin && lhs.count == rhs.count;
+}
+
+const parse_node_list_t k_empty_parse_node_list = { 0, 0 };
+
+
+/*
+	What each opcode uses. Unused fields keep their defaults.
+
+	k_literal					payload = index into literals
+	k_load						name
+	k_call						a = callee, list = args
+	k_resolve_member			a = parent, name = member name
+	k_lookup_element			a = parent, b = key
+	k_arithmetic_unary_minus	a
+	k_conditional_operator		a = condition, b = true-expression, c = false-expression
+	k_struct_def				name, payload = index into members
+	k_function_def				type = function type, name, payload = index into members (named args),
+									flag = has body, list = body statements
+	k_value_constructor			type, list = elements. Dicts have key, value, key, value...
+	k_benchmark					list = body statements
+	+, -, && etc				a = lhs, b = rhs
+
+	k_return					a
+	k_init_local				type, name, a = expression, flag = mutable
+	k_assign					name, a = expression
+	k_block						list = statements
+	k_if						a = condition, list = then statements, flag = has else, list2 = else statements
+	k_for						name = iterator, a = start, b = end, list = body statements, flag = open range
+	k_while						a = condition, list = body statements
+	k_expression_statement		a
+	k_software_system_def		payload = index into json_data
+	k_container_def				payload = index into json_data
+	k_benchmark_def				name, list = body statements
+*/
+struct parse_node_t {
+	parse_node_opcode opcode;
+	bool flag;
+	location_t location;
+
+	parse_node_index_t a;
+	parse_node_index_t b;
+	parse_node_index_t c;
+	parse_node_list_t list;
+	parse_node_list_t list2;
+
+	type_t type;
+	uint32_t payload;
+	std::string name;
+};
+
+parse_node_t make_parse_node(parse_node_opcode opcode, const location_t& location);
+
+
+////////////////////////////////		parse_tree_t
+
+
+struct parse_tree_t {
+	bool check_invariant() const;
+
+
+	/////////////////////////////		STATE
+
+	//	All types used by the nodes. Becomes the types of the unchecked AST.
+	types_t types;
+
+	std::vector<parse_node_t> nodes;
+	std::vector<parse_node_index_t> lists;
+	std::vector<value_t> literals;
+	std::vector<std::vector<member_t>> members;
+	std::vector<json_t> json_data;
+
+	//	The program's top level statements.
+	parse_node_list_t statements;
+};
+
+parse_node_index_t add_node(parse_tree_t& tree, const parse_node_t& node);
+parse_node_index_t add_node(parse_tree_t& tree, parse_node_opcode opcode, parse_node_index_t a, parse_node_index_t b);
+parse_node_list_t add_list(parse_tree_t& tree, const std::vector<parse_node_index_t>& nodes);
+
+parse_node_index_t add_literal_node(parse_tree_t& tree, const value_t& value);
+
+inline const parse_node_t& get_node(const parse_tree_t& tree, parse_node_index_t index){
+	QUARK_ASSERT(index < tree.nodes.size());
+	return tree.nodes[index];
+}
+inline parse_node_index_t get_list_node(const parse_tree_t& tree, const parse_node_list_t& list, uint32_t index){
+	QUARK_ASSERT(index < list.count);
+	return tree.lists[list.begin + index];
+}
+
+
+json_t parse_node_to_json(const parse_tree_t& tree, parse_node_index_t index);
+json_t parse_node_list_to_json(const parse_tree_t& tree, const parse_node_list_t& list);
+json_t parse_tree_to_json(const parse_tree_t& tree);
+
+
+}	// parser
+}	//	floyd
+
+#endif /* parse_tree_h */
@@ -27,11 +27,31 @@ namespace parser {
 //////////////////////////////////////////////////		Text parsing primitives
 
 
+static text_cursor_t skip_multicomment(const text_cursor_t& s);
+
 std::string skip_whitespace(const std::string& s){
-	return skip_whitespace2(seq_t(s)).second.str();
+	return skip_whitespace(text_cursor_t(s)).str();
 }
-seq_t skip_whitespace(const seq_t& s){
-	return skip_whitespace2(s).second;
+text_cursor_t skip_whitespace(const text_cursor_t& s){
+	auto p = s;
+	while(!p.empty()){
+		const auto ch2 = p.first(2);
+
+		//	Whitespace?
+		if(k_whitespace_chars.find(p.first1_char()) != std::string::npos){
+			p = p.rest1();
+		}
+		else if(ch2 == "//"){
+			p = skip_until(p.rest(2), "\n");
+		}
+		else if(ch2 == "/*"){
+			p = skip_multicomment(p);
+		}
+		else{
+			return p;
+		}
+	}
+	return p;
 }
 
 //	Test where C++ lets you insert comments:
@@ -45,25 +65,21 @@ seq_t skip_whitespace(const seq_t& s){
 	/*xyz*/int my_global7 = 3;
 
 
-std::pair<std::string, seq_t> while_multicomment(const seq_t& s){
+static text_cursor_t skip_multicomment(const text_cursor_t& s){
 	QUARK_ASSERT(s.first(2) == "/*");
 
 	auto p = s.rest(2);
-	std::string a = "";
 	while(!p.empty()){
 		//	Skip uninteresting chars.
 		while(!p.empty() && p.first(2) != "/*" && p.first(2) != "*/"){
-			a = a + p.first(1);
-			p = p.rest(1);
+			p = p.rest1();
 		}
 
 		if(p.first(2) == "/*"){
-			const auto t = while_multicomment(p);
-			a = a + t.first;
-			p = t.second;
+			p = skip_multicomment(p);
 		}
 		else if(p.first(2) == "*/"){
-			return { a, p.rest(2) };
+			return p.rest(2);
 		}
 		else{
 			throw_compiler_error_nopos("Unbalanaced comments /* ... */");
@@ -72,75 +88,54 @@ std::pair<std::string, seq_t> while_multicomment(const seq_t& s){
 	throw_compiler_error_nopos("Unbalanaced comments /* ... */");
 }
 
-std::pair<std::string, seq_t> skip_whitespace2(const seq_t& s){
-	std::pair<std::string, seq_t> p = { "", s };
-
-	while(!p.second.empty()){
-		const auto ch2 = p.second.first(2);
-
-		//	Whitespace?
-		if(k_whitespace_chars.find(p.second.first1_char()) != std::string::npos){
-			p = { p.first + p.second.first(1), p.second.rest(1) };
-		}
-		else if(ch2 == "//"){
-			auto p2 = read_until(p.second.rest(2), "\n");
-			p = { p.first + p2.first, p2.second };
-		}
-		else if(ch2 == "/*"){
-			const auto px = while_multicomment(p.second);
-			p = { p.first + px.first, px.second };
-		}
-		else{
-			return p;
-		}
-	}
-
-	return p;
+std::pair<std::string, text_cursor_t> skip_whitespace2(const text_cursor_t& s){
+	const auto end = skip_whitespace(s);
+	return { get_range(s, end), end };
 }
 
 QUARK_TEST("", "skip_whitespace2()", "", ""){
-	QUARK_VERIFY(skip_whitespace2(seq_t("")).second == seq_t(""));
+	QUARK_VERIFY(skip_whitespace2(text_cursor_t("")).second == text_cursor_t(""));
 }
 QUARK_TEST("", "skip_whitespace2()", "", ""){
-	QUARK_VERIFY(skip_whitespace2(seq_t(" ")).second == seq_t(""));
+	QUARK_VERIFY(skip_whitespace2(text_cursor_t(" ")).second == text_cursor_t(""));
 }
-QUARK_TEST("", "skip_whitespace2(seq_t()", "", ""){
-	QUARK_VERIFY(skip_whitespace2(seq_t("\t")).second == seq_t(""));
+QUARK_TEST("", "skip_whitespace2(text_cursor_t()", "", ""){
+	QUARK_VERIFY(skip_whitespace2(text_cursor_t("\t")).second == text_cursor_t(""));
 }
-QUARK_TEST("", "skip_whitespace2(seq_t()", "", ""){
-	QUARK_VERIFY(skip_whitespace2(seq_t("int blob()")).second == seq_t("int blob()"));
+QUARK_TEST("", "skip_whitespace2(text_cursor_t()", "", ""){
+	QUARK_VERIFY(skip_whitespace2(text_cursor_t("int blob()")).second == text_cursor_t("int blob()"));
 }
-QUARK_TEST("", "skip_whitespace2(seq_t()", "", ""){
-	QUARK_VERIFY(skip_whitespace2(seq_t("\t\t\t int blob()")).second == seq_t("int blob()"));
+QUARK_TEST("", "skip_whitespace2(text_cursor_t()", "", ""){
+	QUARK_VERIFY(skip_whitespace2(text_cursor_t("\t\t\t int blob()")).second == text_cursor_t("int blob()"));
 }
 
 
 QUARK_TEST("", "skip_whitespace2()", "//", ""){
-	QUARK_VERIFY(skip_whitespace2(seq_t("//xyz")).second == seq_t(""));
+	QUARK_VERIFY(skip_whitespace2(text_cursor_t("//xyz")).second == text_cursor_t(""));
 }
 QUARK_TEST("", "skip_whitespace2()", "//", ""){
-	QUARK_VERIFY(skip_whitespace2(seq_t("//xyz\nabc")).second == seq_t("abc"));
+	QUARK_VERIFY(skip_whitespace2(text_cursor_t("//xyz\nabc")).second == text_cursor_t("abc"));
 }
 QUARK_TEST("", "skip_whitespace2()", "//", ""){
-	QUARK_VERIFY(skip_whitespace2(seq_t("   \t//xyz \t\n\t abc")).second == seq_t("abc"));
+	QUARK_VERIFY(skip_whitespace2(text_cursor_t("   \t//xyz \t\n\t abc")).second == text_cursor_t("abc"));
 }
 
 QUARK_TEST("", "skip_whitespace2()", "/* */", ""){
-	QUARK_VERIFY(skip_whitespace2(seq_t("/**/xyz")).second == seq_t("xyz"));
+	QUARK_VERIFY(skip_whitespace2(text_cursor_t("/**/xyz")).second == text_cursor_t("xyz"));
 }
 QUARK_TEST("", "skip_whitespace2()", "/* */", ""){
-	QUARK_VERIFY(skip_whitespace2(seq_t("/*abc*/xyz")).second == seq_t("xyz"));
+	QUARK_VERIFY(skip_whitespace2(text_cursor_t("/*abc*/xyz")).second == text_cursor_t("xyz"));
 }
 QUARK_TEST("", "skip_whitespace2()", "/* */", ""){
-	QUARK_VERIFY(skip_whitespace2(seq_t("/*abc*/xyz")).second == seq_t("xyz"));
+	QUARK_VERIFY(skip_whitespace2(text_cursor_t("/*abc*/xyz")).second == text_cursor_t("xyz"));
 }
 QUARK_TEST("", "skip_whitespace2()", "/* */", ""){
-	QUARK_VERIFY(skip_whitespace2(seq_t("   \t/*a \tbc*/   \txyz")).second == seq_t("xyz"));
+	QUARK_VERIFY(skip_whitespace2(text_cursor_t("   \t/*a \tbc*/   \txyz")).second == text_cursor_t("xyz"));
 }
 
 QUARK_TEST("", "skip_whitespace2()", "/* */", ""){
 	try {
-		QUARK_VERIFY(skip_whitespace2(seq_t("/*xyz")).second == seq_t(""));
+		QUARK_VERIFY(skip_whitespace2(text_cursor_t("/*xyz")).second == text_cursor_t(""));
 		fail_test(QUARK_POS);
 	}
 	catch(...) {
@@ -148,10 +143,10 @@ QUARK_TEST("", "skip_whitespace2()", "/* */", ""){
 }
 
 QUARK_TEST("", "skip_whitespace2()", "/* */ -- nested", ""){
-	QUARK_VERIFY(skip_whitespace2(seq_t("/*/**/*/xyz")).second == seq_t("xyz"));
+	QUARK_VERIFY(skip_whitespace2(text_cursor_t("/*/**/*/xyz")).second == text_cursor_t("xyz"));
 }
 QUARK_TEST("", "skip_whitespace2()", "/* */ -- nested", ""){
-	QUARK_VERIFY(skip_whitespace2(seq_t("/*xyz/*abc*/123*/789")).second == seq_t("789"));
+	QUARK_VERIFY(skip_whitespace2(text_cursor_t("/*xyz/*abc*/123*/789")).second == text_cursor_t("789"));
 }
 
 
@@ -205,7 +200,7 @@ QUARK_TEST("", "skip_whitespace_ends()", "", ""){
 	Is recursive and not just checking intermediate chars, also pair match them.
 */
 
-static std::pair<std::string, seq_t> get_balanced(const seq_t& s){
+static std::pair<std::string, text_cursor_t> get_balanced(const text_cursor_t& s){
 	QUARK_ASSERT(s.size() > 0);
 
 	const auto r = read_balanced2(s, k_bracket_pairs);
@@ -218,55 +213,54 @@ static std::pair<std::string, seq_t> get_balanced(const seq_t& s){
 
 QUARK_TEST("", "get_balanced()", "", ""){
 //	QUARK_VERIFY(get_balanced("") == seq("", ""));
-	QUARK_VERIFY(get_balanced(seq_t("()")) == (std::pair<std::string, seq_t>("()", seq_t(""))));
+	QUARK_VERIFY(get_balanced(text_cursor_t("()")) == (std::pair<std::string, text_cursor_t>("()", text_cursor_t(""))));
 }
 QUARK_TEST("", "get_balanced()", "", ""){
-	QUARK_VERIFY(get_balanced(seq_t("(abc)")) == (std::pair<std::string, seq_t>("(abc)", seq_t(""))));
+	QUARK_VERIFY(get_balanced(text_cursor_t("(abc)")) == (std::pair<std::string, text_cursor_t>("(abc)", text_cursor_t(""))));
 }
 QUARK_TEST("", "get_balanced()", "", ""){
-	QUARK_VERIFY(get_balanced(seq_t("(abc)xyz")) == (std::pair<std::string, seq_t>("(abc)", seq_t("xyz"))));
+	QUARK_VERIFY(get_balanced(text_cursor_t("(abc)xyz")) == (std::pair<std::string, text_cursor_t>("(abc)", text_cursor_t("xyz"))));
 }
 QUARK_TEST("", "get_balanced()", "", ""){
-	QUARK_VERIFY(get_balanced(seq_t("((abc))xyz")) == (std::pair<std::string, seq_t>("((abc))", seq_t("xyz"))));
+	QUARK_VERIFY(get_balanced(text_cursor_t("((abc))xyz")) == (std::pair<std::string, text_cursor_t>("((abc))", text_cursor_t("xyz"))));
 }
 QUARK_TEST("", "get_balanced()", "", ""){
-	QUARK_VERIFY(get_balanced(seq_t("((abc)[])xyz")) == (std::pair<std::string, seq_t>("((abc)[])", seq_t("xyz"))));
+	QUARK_VERIFY(get_balanced(text_cursor_t("((abc)[])xyz")) == (std::pair<std::string, text_cursor_t>("((abc)[])", text_cursor_t("xyz"))));
 }
 QUARK_TEST("", "get_balanced()", "", ""){
-	QUARK_VERIFY(get_balanced(seq_t("(return 4 < 5;)xxx")) == (std::pair<std::string, seq_t>("(return 4 < 5;)", seq_t("xxx"))));
+	QUARK_VERIFY(get_balanced(text_cursor_t("(return 4 < 5;)xxx")) == (std::pair<std::string, text_cursor_t>("(return 4 < 5;)", text_cursor_t("xxx"))));
 }
 QUARK_TEST("", "get_balanced()", "", ""){
-	QUARK_VERIFY(get_balanced(seq_t("{}")) == (std::pair<std::string, seq_t>("{}", seq_t(""))));
+	QUARK_VERIFY(get_balanced(text_cursor_t("{}")) == (std::pair<std::string, text_cursor_t>("{}", text_cursor_t(""))));
 }
 QUARK_TEST("", "get_balanced()", "", ""){
-	QUARK_VERIFY(get_balanced(seq_t("{aaa}bbb")) == (std::pair<std::string, seq_t>("{aaa}", seq_t("bbb"))));
+	QUARK_VERIFY(get_balanced(text_cursor_t("{aaa}bbb")) == (std::pair<std::string, text_cursor_t>("{aaa}", text_cursor_t("bbb"))));
 }
 QUARK_TEST("", "get_balanced()", "", ""){
-	QUARK_VERIFY(get_balanced(seq_t("{return 4 < 5;}xxx")) == (std::pair<std::string, seq_t>("{return 4 < 5;}", seq_t("xxx"))));
+	QUARK_VERIFY(get_balanced(text_cursor_t("{return 4 < 5;}xxx")) == (std::pair<std::string, text_cursor_t>("{return 4 < 5;}", text_cursor_t("xxx"))));
 }
 //	QUARK_VERIFY(get_balanced("{\n\t\t\t\treturn 4 < 5;\n\t\t\t}\n\t\t") == seq("((abc)[])", xyz));
 
 
-std::pair<std::string, seq_t> read_enclosed_in_parantheses(const seq_t& pos){
+std::pair<std::string, text_cursor_t> read_enclosed_in_parantheses(const text_cursor_t& pos){
 	const auto pos2 = skip_whitespace(pos);
 	read_required(pos2, "(");
 	const auto range = get_balanced(pos2);
-	const auto range2 = seq_t(trim_ends(range.first));
-	return { range2.str(), range.second };
+	return { trim_ends(range.first), range.second };
 }
 
 QUARK_TEST("", "read_enclosed_in_parantheses()", "", ""){
-	QUARK_VERIFY((	read_enclosed_in_parantheses(seq_t("()xyz")) == std::pair<std::string, seq_t>{"", seq_t("xyz") } 	));
+	QUARK_VERIFY((	read_enclosed_in_parantheses(text_cursor_t("()xyz")) == std::pair<std::string, text_cursor_t>{"", text_cursor_t("xyz") } 	));
 }
 QUARK_TEST("", "read_enclosed_in_parantheses()", "", ""){
-	QUARK_VERIFY((	read_enclosed_in_parantheses(seq_t(" ( abc )xyz")) == std::pair<std::string, seq_t>{" abc ", seq_t("xyz") } 	));
+	QUARK_VERIFY((	read_enclosed_in_parantheses(text_cursor_t(" ( abc )xyz")) == std::pair<std::string, text_cursor_t>{" abc ", text_cursor_t("xyz") } 	));
 }
 
 
 const auto open_close2 = deinterleave_string(k_bracket_pairs);
 
 
-std::pair<std::string, seq_t> read_until_toplevel_match(const seq_t& s, const std::string& match_chars){
+std::pair<std::string, text_cursor_t> read_until_toplevel_match(const text_cursor_t& s, const std::string& match_chars){
 	auto pos = s;
 	while(pos.empty() == false && match_chars.find(pos.first1()) == std::string::npos){
 		const auto ch = pos.first();
@@ -279,7 +273,7 @@ std::pair<std::string, seq_t> read_until_toplevel_match(const seq_t& s, const st
 		}
 	}
 	if (pos.empty()){
-		return { s.str(), seq_t("") };
+		return { s.str(), pos };
 //		return { "", s };
 	}
 	else{
@@ -290,7 +284,7 @@ std::pair<std::string, seq_t> read_until_toplevel_match(const seq_t& s, const st
 
 QUARK_TEST("", "read_until_toplevel_match()", "", ""){
 	try {
-		read_until_toplevel_match(seq_t("print(json_to_string(json_to_value(value_to_json(\"cola\"));\n\t"), ";{");
+		read_until_toplevel_match(text_cursor_t("print(json_to_string(json_to_value(value_to_json(\"cola\"));\n\t"), ";{");
 		fail_test(QUARK_POS);
 	}
 	catch(...){
@@ -312,12 +306,12 @@ std::string reverse(const std::string& s){
 
 
 //	Returns "" if no symbol is found.
-std::pair<std::string, seq_t> read_identifier(const seq_t& s){
+std::pair<std::string, text_cursor_t> read_identifier(const text_cursor_t& s){
 	const auto a = skip_whitespace(s);
 	const auto b = read_while(a, k_identifier_chars);
 	return b;
 }
-std::pair<std::string, seq_t> read_required_identifier(const seq_t& s){
+std::pair<std::string, text_cursor_t> read_required_identifier(const text_cursor_t& s){
 	const auto b = read_identifier(s);
 	if(b.first.empty()){
 		throw_compiler_error_nopos("missing identifier");
@@ -326,14 +320,14 @@ std::pair<std::string, seq_t> read_required_identifier(const seq_t& s){
 }
 
 QUARK_TEST("read_required_identifier()", "", "", ""){
-	QUARK_VERIFY(read_required_identifier(seq_t("\thello\txxx")) == (std::pair<std::string, seq_t>("hello", seq_t("\txxx"))));
+	QUARK_VERIFY(read_required_identifier(text_cursor_t("\thello\txxx")) == (std::pair<std::string, text_cursor_t>("hello", text_cursor_t("\txxx"))));
 }
 
 
 //////////////////////////////////////		TYPES
 
 
-std::pair<std::shared_ptr<type_t>, seq_t> read_basic_type(types_t& types, const seq_t& s){
+std::pair<std::shared_ptr<type_t>, text_cursor_t> read_basic_type(types_t& types, const text_cursor_t& s){
 	const auto pos0 = skip_whitespace(s);
 
 	const auto pos1 = read_while(pos0, k_identifier_chars + "*");
@@ -376,7 +370,8 @@ static std::vector<member_t> parse_functiondef_arguments2(types_t& types, const
 	QUARK_ASSERT(s[0] == '(');
 	QUARK_ASSERT(s.back() == ')');
 
-	const auto s2 = seq_t(trim_ends(s));
+	const auto trimmed = trim_ends(s);
+	const auto s2 = text_cursor_t(trimmed);
 	std::vector<member_t> args;
 	auto pos = skip_whitespace(s2);
 	while(!pos.empty()){
@@ -410,10 +405,10 @@ QUARK_TEST("", "parse_functiondef_arguments2()", "", ""){
 	}		));
 }
 
-std::pair<std::vector<member_t>, seq_t> read_functiondef_arg_parantheses(types_t& types, const seq_t& s){
+std::pair<std::vector<member_t>, text_cursor_t> read_functiondef_arg_parantheses(types_t& types, const text_cursor_t& s){
 	QUARK_ASSERT(s.first1() == "(");
 
-	std::pair<std::string, seq_t> args_pos = read_balanced2(s, k_bracket_pairs);
+	std::pair<std::string, text_cursor_t> args_pos = read_balanced2(s, k_bracket_pairs);
 	if(args_pos.first.empty()){
 		throw_compiler_error_nopos("unbalanced ()");
 	}
@@ -422,10 +417,10 @@ std::pair<std::vector<member_t>, seq_t> read_functiondef_arg_parantheses(types_t
 }
 
 
-std::pair<std::vector<member_t>, seq_t> read_function_type_args(types_t& types, const seq_t& s){
+std::pair<std::vector<member_t>, text_cursor_t> read_function_type_args(types_t& types, const text_cursor_t& s){
 	QUARK_ASSERT(s.first1() == "(");
 
-	std::pair<std::string, seq_t> args_pos = read_balanced2(s, k_bracket_pairs);
+	std::pair<std::string, text_cursor_t> args_pos = read_balanced2(s, k_bracket_pairs);
 	if(args_pos.first.empty()){
 		throw_compiler_error_nopos("unbalanced ()");
 	}
@@ -435,13 +430,13 @@ std::pair<std::vector<member_t>, seq_t> read_function_type_args(types_t& types,
 
 QUARK_TEST("", "read_function_type_args()", "", ""){
 	types_t types;
-	const auto result = read_function_type_args(types, seq_t("()"));
+	const auto result = read_function_type_args(types, text_cursor_t("()"));
 	QUARK_VERIFY(result.first.empty());
 	QUARK_VERIFY(result.second.empty());
 }
 QUARK_TEST("", "read_function_type_args()", "", ""){
 	types_t types;
-	const auto result = read_function_type_args(types, seq_t("(int, double)"));
+	const auto result = read_function_type_args(types, text_cursor_t("(int, double)"));
 	QUARK_VERIFY(result.first.size() == 2);
 	QUARK_VERIFY(peek2(types, result.first[0]._type).is_int());
 	QUARK_VERIFY(result.first[0]._name == "");
@@ -451,7 +446,7 @@ QUARK_TEST("", "read_function_type_args()", "", ""){
 }
 QUARK_TEST("", "read_function_type_args()", "", ""){
 	types_t types;
-	const auto result = read_function_type_args(types, seq_t("(int x, double y)"));
+	const auto result = read_function_type_args(types, text_cursor_t("(int x, double y)"));
 	QUARK_VERIFY(result.first.size() == 2);
 	QUARK_VERIFY(peek2(types, result.first[0]._type).is_int());
 	QUARK_VERIFY(result.first[0]._name == "x");
@@ -460,7 +455,7 @@ QUARK_TEST("", "read_function_type_args()", "", ""){
 	QUARK_VERIFY(result.second.empty());
 }
 
-static std::pair<std::shared_ptr<type_t>, seq_t> read_basic_or_vector(types_t& types, const seq_t& s){
+static std::pair<std::shared_ptr<type_t>, text_cursor_t> read_basic_or_vector(types_t& types, const text_cursor_t& s){
 	const auto pos0 = skip_whitespace(s);
 	if(pos0.first1() == "["){
 		const auto pos2 = pos0.rest1();
@@ -503,7 +498,7 @@ static std::pair<std::shared_ptr<type_t>, seq_t> read_basic_or_vector(types_t& t
 }
 
 
-static std::pair<std::shared_ptr<type_t>, seq_t> read_optional_trailing_function_type_args(types_t& types, const type_t& type, const seq_t& s){
+static std::pair<std::shared_ptr<type_t>, text_cursor_t> read_optional_trailing_function_type_args(types_t& types, const type_t& type, const text_cursor_t& s){
 	//	See if there is a () afterward type_pos -- that would be that type_pos is the return value of a function-type.
 	const auto more_pos = skip_whitespace(s);
 	if(more_pos.first1() == "("){
@@ -522,7 +517,7 @@ static std::pair<std::shared_ptr<type_t>, seq_t> read_optional_trailing_function
 	}
 }
 
-std::pair<std::shared_ptr<type_t>, seq_t> read_type(types_t& types, const seq_t& s){
+std::pair<std::shared_ptr<type_t>, text_cursor_t> read_type(types_t& types, const text_cursor_t& s){
 	const auto type_pos = read_basic_or_vector(types, s);
 	if(type_pos.first == nullptr){
 		return type_pos;
@@ -534,79 +529,79 @@ std::pair<std::shared_ptr<type_t>, seq_t> read_type(types_t& types, const seq_t&
 
 QUARK_TEST("", "read_type()", "", ""){
 	types_t i;
-	QUARK_VERIFY(read_type(i, seq_t("-3")).first == nullptr);
+	QUARK_VERIFY(read_type(i, text_cursor_t("-3")).first == nullptr);
 }
 QUARK_TEST("", "read_type()", "", ""){
 	types_t i;
-	QUARK_VERIFY(*read_type(i, seq_t("undef")).first == make_undefined());
+	QUARK_VERIFY(*read_type(i, text_cursor_t("undef")).first == make_undefined());
 }
 QUARK_TEST("", "read_type()", "", ""){
 	types_t i;
-	QUARK_VERIFY(*read_type(i, seq_t("any")).first == type_t::make_any());
+	QUARK_VERIFY(*read_type(i, text_cursor_t("any")).first == type_t::make_any());
 }
 QUARK_TEST("", "read_type()", "", ""){
 	types_t i;
-	QUARK_VERIFY(*read_type(i, seq_t("void")).first == type_t::make_void());
+	QUARK_VERIFY(*read_type(i, text_cursor_t("void")).first == type_t::make_void());
 }
 QUARK_TEST("", "read_type()", "", ""){
 	types_t i;
-	QUARK_VERIFY(*read_type(i, seq_t("bool")).first == type_t::make_bool());
+	QUARK_VERIFY(*read_type(i, text_cursor_t("bool")).first == type_t::make_bool());
 }
 QUARK_TEST("", "read_type()", "", ""){
 	types_t i;
-	QUARK_VERIFY(*read_type(i, seq_t("int")).first == type_t::make_int());
+	QUARK_VERIFY(*read_type(i, text_cursor_t("int")).first == type_t::make_int());
 }
 QUARK_TEST("", "read_type()", "", ""){
 	types_t i;
-	QUARK_VERIFY(*read_type(i, seq_t("double")).first == type_t::make_double());
+	QUARK_VERIFY(*read_type(i, text_cursor_t("double")).first == type_t::make_double());
 }
 QUARK_TEST("", "read_type()", "", ""){
 	types_t i;
-	QUARK_VERIFY(*read_type(i, seq_t("string")).first == type_t::make_string());
+	QUARK_VERIFY(*read_type(i, text_cursor_t("string")).first == type_t::make_string());
 }
 QUARK_TEST("", "read_type()", "identifier", ""){
 	types_t i;
-	const auto r = read_type(i, seq_t("temp"));
+	const auto r = read_type(i, text_cursor_t("temp"));
 	QUARK_VERIFY(*r.first ==  make_symbol_ref(i, "temp"));
-	QUARK_VERIFY(r.second == seq_t(""));
+	QUARK_VERIFY(r.second == text_cursor_t(""));
 }
 QUARK_TEST("", "read_type()", "vector", ""){
 	types_t i;
-	const auto r = read_type(i, seq_t("[int]"));
+	const auto r = read_type(i, text_cursor_t("[int]"));
 	QUARK_VERIFY(	*r.first ==  make_vector(i, type_t::make_int())		);
-	QUARK_VERIFY(r.second == seq_t(""));
+	QUARK_VERIFY(r.second == text_cursor_t(""));
 }
 QUARK_TEST("", "read_type()", "vector", ""){
 	types_t i;
-	const auto r = read_type(i, seq_t("[[int]]"));
+	const auto r = read_type(i, text_cursor_t("[[int]]"));
 	QUARK_VERIFY(	*r.first ==  make_vector(i, make_vector(i, type_t::make_int()))		);
-	QUARK_VERIFY(r.second == seq_t(""));
+	QUARK_VERIFY(r.second == text_cursor_t(""));
 }
 
 QUARK_TEST("", "read_type()", "dict", ""){
 	types_t i;
-	const auto r = read_type(i, seq_t("[string: int]"));
+	const auto r = read_type(i, text_cursor_t("[string: int]"));
 	QUARK_VERIFY(	*r.first ==  make_dict(i, type_t::make_int())		);
-	QUARK_VERIFY(r.second == seq_t(""));
+	QUARK_VERIFY(r.second == text_cursor_t(""));
 }
 
 
 QUARK_TEST("", "read_type()", "", ""){
 	types_t i;
-	const auto r = read_type(i, seq_t("int ()"));
+	const auto r = read_type(i, text_cursor_t("int ()"));
 	QUARK_VERIFY(*r.first ==  make_function(i, type_t::make_int(), {}, epure::pure));
-	QUARK_VERIFY(r.second == seq_t(""));
+	QUARK_VERIFY(r.second == text_cursor_t(""));
 }
 
 QUARK_TEST("", "read_type()", "", ""){
 	types_t i;
-	const auto r = read_type(i, seq_t("string (double a, double b)"));
+	const auto r = read_type(i, text_cursor_t("string (double a, double b)"));
 	QUARK_VERIFY(	*r.first ==  make_function(i, type_t::make_string(), { type_t::make_double(), type_t::make_double() }, epure::pure)	);
-	QUARK_VERIFY(r.second == seq_t(""));
+	QUARK_VERIFY(r.second == text_cursor_t(""));
 }
 QUARK_TEST("", "read_type()", "", ""){
 	types_t i;
-	const auto r = read_type(i, seq_t("int (double a) ()"));
+	const auto r = read_type(i, text_cursor_t("int (double a) ()"));
 
 	QUARK_VERIFY( *r.first == make_function(
 		i,
@@ -614,11 +609,11 @@ QUARK_TEST("", "read_type()", "", ""){
 		{},
 		epure::pure
 	));
-	QUARK_VERIFY(	r.second == seq_t("") );
+	QUARK_VERIFY(	r.second == text_cursor_t("") );
 }
 QUARK_TEST("", "read_type()", "", ""){
 	types_t i;
-	const auto r = read_type(i, seq_t("bool (int (double a) b)"));
+	const auto r = read_type(i, text_cursor_t("bool (int (double a) b)"));
 
 	QUARK_VERIFY(
 		*r.first
@@ -633,11 +628,11 @@ QUARK_TEST("", "read_type()", "", ""){
 		)
 	);
 
-	QUARK_VERIFY(	r.second == seq_t("") );
+	QUARK_VERIFY(	r.second == text_cursor_t("") );
 }
 /*
 QUARK_TEST("", "read_type_identifier()", "", ""){
-	QUARK_VERIFY(read_type_identifier(seq_t("int (double a) g(int(double b))")).first == "int (double a) g(int(double b))");
+	QUARK_VERIFY(read_type_identifier(text_cursor_t("int (double a) g(int(double b))")).first == "int (double a) g(int(double b))");
 }
 
 -	TYPE-IDENTIFIER (TYPE-IDENTIFIER a, TYPE-IDENTIFIER b, ...)
@@ -646,7 +641,7 @@ QUARK_TEST("", "read_type_identifier()", "", ""){
 */
 
 
-std::pair<type_t, seq_t> read_required_type(types_t& types, const seq_t& s){
+std::pair<type_t, text_cursor_t> read_required_type(types_t& types, const text_cursor_t& s){
 	const auto type_pos = read_type(types, s);
 	if(type_pos.first == nullptr){
 		throw_compiler_error_nopos("illegal character in type identifier");
@@ -660,32 +655,16 @@ std::pair<type_t, seq_t> read_required_type(types_t& types, const seq_t& s){
 
 
 
-json_t make_parser_node(const location_t& location, const std::string& opcode, const std::vector<json_t>& params){
-	if(location == k_no_location){
-		std::vector<json_t> e = { json_t(opcode) };
-		e.insert(e.end(), params.begin(), params.end());
-		return json_t(e);
-	}
-	else{
-		const auto offset = static_cast<double>(location.offset);
-		std::vector<json_t> e = { json_t(offset), json_t(opcode) };
-		e.insert(e.end(), params.begin(), params.end());
-		return json_t(e);
-	}
+std::pair<json_t, text_cursor_t> ut_parse(std::pair<parse_node_index_t, text_cursor_t> (*f)(parse_tree_t& tree, const text_cursor_t& s), const text_cursor_t& s){
+	parse_tree_t tree;
+	const auto result = f(tree, s);
+	return { parse_node_to_json(tree, result.first), result.second };
 }
 
-json_t parser__make_literal(const value_t& value){
-//	QUARK_ASSERT(is_floyd_literal(value.get_type()));
-
-	const types_t temp;
-	return make_parser_node(
-		floyd::k_no_location,
-		parse_tree_expression_opcode_t::k_literal,
-		{
-			value_to_ast_json(temp, value),
-			type_to_json(temp, value.get_type())
-		}
-	);
+std::pair<json_t, text_cursor_t> ut_parse(parse_result_t (*f)(parse_tree_t& tree, const text_cursor_t& s), const text_cursor_t& s){
+	parse_tree_t tree;
+	const auto result = f(tree, s);
+	return { parse_node_list_to_json(tree, result.statements), result.pos };
 }
 
 }	// parser
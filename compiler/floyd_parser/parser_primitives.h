@@ -16,6 +16,7 @@
 #include "quark.h"
 #include "text_parser.h"
 #include "json_support.h"
+#include "parse_tree.h"
 
 #include <string>
 #include <vector>
@@ -38,9 +39,9 @@ namespace parser {
 //		- one-line comments starting with "//"
 //		- multiline comments withint /* ... */. Any number of nesting of comments allowed.
 std::string skip_whitespace(const std::string& s);
-seq_t skip_whitespace(const seq_t& s);
+text_cursor_t skip_whitespace(const text_cursor_t& s);
 
-std::pair<std::string, seq_t> skip_whitespace2(const seq_t& s);
+std::pair<std::string, text_cursor_t> skip_whitespace2(const text_cursor_t& s);
 
 //	Removes whitespace before AND AFTER.
 std::string skip_whitespace_ends(const std::string& s);
@@ -56,16 +57,16 @@ bool is_whitespace(char ch);
 	(x)	=>	"x"
 	(int x, int y) => "int x, int y"
 */
-std::pair<std::string, seq_t> read_enclosed_in_parantheses(const seq_t& pos);
+std::pair<std::string, text_cursor_t> read_enclosed_in_parantheses(const text_cursor_t& pos);
 
 
 /*
 	??? Use this is all places we scan.
 	Understands nested parantheses and brackets and skips those.
 	Does NOT skip leading whitespace.
-	If none are found, returns { s.str(), seq_t("") }
+	If none are found, returns { s.str(), <empty cursor at end of s> }
 */
-std::pair<std::string, seq_t> read_until_toplevel_match(const seq_t& s, const std::string& match_chars);
+std::pair<std::string, text_cursor_t> read_until_toplevel_match(const text_cursor_t& s, const std::string& match_chars);
 
 
 ////////////////////////////////		BASIC STRING
@@ -77,7 +78,7 @@ std::string reverse(const std::string& s);
 ////////////////////////////////		IDENTIFIER
 
 
-std::pair<std::string, seq_t> read_identifier(const seq_t& s);
+std::pair<std::string, text_cursor_t> read_identifier(const text_cursor_t& s);
 
 /*
 	Reads an identifier, like a variable name or function name.
@@ -86,7 +87,7 @@ std::pair<std::string, seq_t> read_identifier(const seq_t& s);
 		"hello()xxx"
 		"hello+xxx"
 */
-std::pair<std::string, seq_t> read_required_identifier(const seq_t& s);
+std::pair<std::string, text_cursor_t> read_required_identifier(const text_cursor_t& s);
 
 
 ////////////////////////////////		TYPES
@@ -98,8 +99,8 @@ std::pair<std::string, seq_t> read_required_identifier(const seq_t& s);
 	Does NOT make sure this a known type-identifier.
 	String must not be empty.
 */
-std::pair<std::shared_ptr<type_t>, seq_t> read_type(types_t& types, const seq_t& s);
-std::pair<type_t, seq_t> read_required_type(types_t& types, const seq_t& s);
+std::pair<std::shared_ptr<type_t>, text_cursor_t> read_type(types_t& types, const text_cursor_t& s);
+std::pair<type_t, text_cursor_t> read_required_type(types_t& types, const text_cursor_t& s);
 
 
 ////////////////////////////////		HIGH LEVEL
@@ -120,89 +121,30 @@ std::pair<type_t, seq_t> read_required_type(types_t& types, const seq_t& s);
 
 	(int, int)
 */
-std::pair<std::vector<member_t>, seq_t> read_functiondef_arg_parantheses(types_t& types, const seq_t& s);
+std::pair<std::vector<member_t>, text_cursor_t> read_functiondef_arg_parantheses(types_t& types, const text_cursor_t& s);
 
 //	Member names may be left blank.
-std::pair<std::vector<member_t>, seq_t> read_function_type_args(types_t& types, const seq_t& s);
+std::pair<std::vector<member_t>, text_cursor_t> read_function_type_args(types_t& types, const text_cursor_t& s);
 
-std::pair<std::vector<member_t>, seq_t> read_call_args(const seq_t& s);
+std::pair<std::vector<member_t>, text_cursor_t> read_call_args(const text_cursor_t& s);
 
 
 ////////////////////////////////		parse_result_t
 
-//	Used by the parser functions to return both its result and the pos where it stopped reading.
+//	Used by the parser functions that read a list of statements to return both the list and the pos where it stopped reading.
 
 struct parse_result_t {
-	json_t parse_tree;
-	seq_t pos;
+	parse_node_list_t statements;
+	text_cursor_t pos;
 };
 
 
-////////////////////////////////		parse_tree_expression_opcode_t
+////////////////////////////////		UNIT TESTS
 
 
-namespace parse_tree_expression_opcode_t {
-	const std::string k_literal = "k";
-	const std::string k_call = "call";
-	const std::string k_load = "@";
-	const std::string k_resolve_member = "->";
-	const std::string k_arithmetic_unary_minus = "unary-minus";
-	const std::string k_conditional_operator = "?:";
-	const std::string k_struct_def = "struct-def";
-	const std::string k_function_def = "function-def";
-	const std::string k_value_constructor = "value-constructor";
-	const std::string k_lookup_element = "[]";
-	const std::string k_benchmark = "benchmark";
-
-
-	const std::string k_arithmetic_add = "+";
-	const std::string k_arithmetic_subtract = "-";
-	const std::string k_arithmetic_multiply = "*";
-	const std::string k_arithmetic_divide = "/";
-	const std::string k_arithmetic_remainder = "%";
-
-	const std::string k_logical_and = "&&";
-	const std::string k_logical_or = "||";
-
-	const std::string k_comparison_smaller_or_equal = "<=";
-	const std::string k_comparison_smaller = "<";
-	const std::string k_comparison_larger_or_equal = ">=";
-	const std::string k_comparison_larger = ">";
-
-	const std::string k_logical_equal = "==";
-	const std::string k_logical_nonequal = "!=";
-};
-
-
-////////////////////////////////		parse_tree_statement_opcode
-
-
-namespace parse_tree_statement_opcode {
-	const std::string k_return = "return";
-
-	//??? Make init-local-const, init-local-mut
-	const std::string k_init_local = "init-local";
-	const std::string k_assign = "assign";
-	const std::string k_block = "block";
-
-	const std::string k_def_struct = "def-struct";
-
-	const std::string k_if = "if";
-	const std::string k_for = "for";
-	const std::string k_while = "while";
-
-	const std::string k_expression_statement = "expression-statement";
-
-	const std::string k_software_system_def = "software-system-def";
-	const std::string k_container_def = "container-def";
-	const std::string k_benchmark_def = "benchmark-def";
-};
-
-
-
-json_t make_parser_node(const location_t& location, const std::string& opcode, const std::vector<json_t>& params);
-
-json_t parser__make_literal(const value_t& value);
+//	Runs one parse function on a new parse tree and returns what it made as JSON, see parse_tree_to_json().
+std::pair<json_t, text_cursor_t> ut_parse(std::pair<parse_node_index_t, text_cursor_t> (*f)(parse_tree_t& tree, const text_cursor_t& s), const text_cursor_t& s);
+std::pair<json_t, text_cursor_t> ut_parse(parse_result_t (*f)(parse_tree_t& tree, const text_cursor_t& s), const text_cursor_t& s);
 
 }	//	 parser
 }	//	floyd
@@ -17,12 +17,18 @@
 #include "file_handling.h"
 #include "hardware_caps.h"
 #include "format_table.h"
+#include "json_support.h"
+#include "text_parser.h"
 
 #include <iostream>
 #include <fstream>
 #include <thread>
 #include <chrono>
 #include <set>
+#include <map>
+#include <cmath>
+#include <algorithm>
+#include <sstream>
 #include <ctime>
 
 namespace floyd {
@@ -669,8 +675,37 @@ static std::string json_to_pretty_string_no_quotes(const json_t& j){
 	}
 }
 
+static const std::vector<std::string> k_benchmark_stats_headings = { "MEDIAN", "P90", "P99", "STDDEV", "MAD", "OUTLIERS", "SAMPLES" };
+
+static std::vector<std::string> make_benchmark_stats_columns(const benchmark_stats_t& stats){
+	if(stats.sample_count == 0){
+		return std::vector<std::string>(k_benchmark_stats_headings.size(), "");
+	}
+	else{
+		return {
+			std::to_string(stats.median) + " ns",
+			std::to_string(stats.p90) + " ns",
+			std::to_string(stats.p99) + " ns",
+			std::to_string(stats.stddev) + " ns",
+			std::to_string(stats.mad) + " ns",
+			std::to_string(stats.outlier_count),
+			std::to_string(stats.sample_count)
+		};
+	}
+}
+
 std::string make_benchmark_report(const std::vector<benchmark_result2_t>& test_results){
-	const auto fixed_headings = std::vector<std::string>{ "MODULE", "TEST", "DUR" };
+	//	Only show statistics columns if some result has statistics.
+	const bool has_stats = std::find_if(
+		test_results.begin(),
+		test_results.end(),
+		[](const benchmark_result2_t& e){ return e.stats.sample_count > 0; }
+	) != test_results.end();
+
+	const auto fixed_headings = concat(
+		std::vector<std::string>{ "MODULE", "TEST", "DUR" },
+		has_stats ? k_benchmark_stats_headings : std::vector<std::string>{}
+	);
 
 	const int fixed_column_count = (int)fixed_headings.size();
 
@@ -702,11 +737,14 @@ std::string make_benchmark_report(const std::vector<benchmark_result2_t>& test_r
 
 	std::vector<line_t> table;
 	for(const auto& e: test_results){
-		const auto columns = std::vector<std::string>{
-			e.test_id.module,
-			e.test_id.test,
-			std::to_string(e.result.dur) + " ns"
-		};
+		const auto columns = concat(
+			std::vector<std::string>{
+				e.test_id.module,
+				e.test_id.test,
+				std::to_string(e.result.dur) + " ns"
+			},
+			has_stats ? make_benchmark_stats_columns(e.stats) : std::vector<std::string>{}
+		);
 
 		const auto& more = e.result.more;
 
@@ -741,7 +779,10 @@ std::string make_benchmark_report(const std::vector<benchmark_result2_t>& test_r
 
 	const auto default_column = column_t{ 0, 0, 1 };
 	const auto start_columns = concat(
-		std::vector<column_t>{ default_column, default_column, { 0, 1, 0 } },
+		concat(
+			std::vector<column_t>{ default_column, default_column },
+			std::vector<column_t>(fixed_column_count - 2, { 0, 1, 0 })
+		),
 		std::vector<column_t>(column_count - fixed_column_count, default_column)
 	);
 	const auto columns0 = fit_column(start_columns, headings);
@@ -795,6 +836,283 @@ QUARK_TEST("", "make_benchmark_report()", "Demo", ""){
 
 
 
+static json_t benchmark_stats_to_json(const benchmark_stats_t& stats){
+	return json_t::make_object({
+		{ "samples", json_t(stats.sample_count) },
+		{ "min", json_t(stats.min) },
+		{ "max", json_t(stats.max) },
+		{ "mean", json_t(stats.mean) },
+		{ "median", json_t(stats.median) },
+		{ "p90", json_t(stats.p90) },
+		{ "p99", json_t(stats.p99) },
+		{ "stddev", json_t(stats.stddev) },
+		{ "mad", json_t(stats.mad) },
+		{ "outliers", json_t(stats.outlier_count) }
+	});
+}
+
+static benchmark_stats_t benchmark_stats_from_json(const json_t& j){
+	const auto get = [&](const std::string& key){
+		return static_cast<int64_t>(j.get_object_element(key).get_number());
+	};
+	return benchmark_stats_t {
+		get("samples"),
+		get("min"),
+		get("max"),
+		get("mean"),
+		get("median"),
+		get("p90"),
+		get("p99"),
+		get("stddev"),
+		get("mad"),
+		get("outliers")
+	};
+}
+
+json_t benchmark_results_to_json(const std::vector<benchmark_result2_t>& test_results){
+	std::vector<json_t> result;
+	for(const auto& e: test_results){
+		std::map<std::string, json_t> members = {
+			{ "module", json_t(e.test_id.module) },
+			{ "test", json_t(e.test_id.test) },
+			{ "dur", json_t(e.result.dur) },
+			{ "more", e.result.more }
+		};
+		if(e.stats.sample_count > 0){
+			members.insert({ "stats", benchmark_stats_to_json(e.stats) });
+		}
+		result.push_back(json_t::make_object(members));
+	}
+	return json_t::make_array(result);
+}
+
+std::vector<benchmark_result2_t> benchmark_results_from_json(const json_t& j){
+	if(j.is_array() == false){
+		quark::throw_runtime_error("Benchmark results must be a JSON array.");
+	}
+
+	std::vector<benchmark_result2_t> result;
+	for(const auto& e: j.get_array()){
+		const auto stats = e.does_object_element_exist("stats") ? benchmark_stats_from_json(e.get_object_element("stats")) : benchmark_stats_t {};
+		result.push_back(
+			benchmark_result2_t {
+				benchmark_id_t { e.get_object_element("module").get_string(), e.get_object_element("test").get_string() },
+				benchmark_result_t {
+					static_cast<int64_t>(e.get_object_element("dur").get_number()),
+					e.does_object_element_exist("more") ? e.get_object_element("more") : json_t()
+				},
+				stats
+			}
+		);
+	}
+	return result;
+}
+
+QUARK_TEST("", "benchmark_results_from_json()", "", ""){
+	const auto test = std::vector<benchmark_result2_t> {
+		benchmark_result2_t { benchmark_id_t{ "", "abc" }, benchmark_result_t { 2000, json_t("0 elements") }, benchmark_stats_t {} },
+		benchmark_result2_t { benchmark_id_t{ "m", "def" }, benchmark_result_t { 1, json_t() }, benchmark_stats_t { 10, 1, 9, 3, 2, 8, 9, 2, 1, 1 } }
+	};
+	const auto result = benchmark_results_from_json(benchmark_results_to_json(test));
+	QUARK_VERIFY(result.size() == 2);
+	QUARK_VERIFY(result[0] == test[0] && result[0].stats == test[0].stats);
+	QUARK_VERIFY(result[1] == test[1] && result[1].stats == test[1].stats);
+}
+
+
+std::string make_benchmark_report_json(const std::vector<benchmark_result2_t>& test_results, const std::vector<std::pair<std::string, json_t>>& hardware_caps){
+	const auto doc = json_t::make_object({
+		{ "date", json_t(get_current_date_and_time_string()) },
+		{ "build", json_t(DEBUG ? "debug" : "release") },
+		{ "hardware_caps", json_t::make_object(std::map<std::string, json_t>(hardware_caps.begin(), hardware_caps.end())) },
+		{ "results", benchmark_results_to_json(test_results) }
+	});
+	return json_to_pretty_string(doc) + "\n";
+}
+
+std::vector<benchmark_result2_t> parse_benchmark_report_json(const std::string& s){
+	const auto doc = parse_json(seq_t(s)).first;
+	if(doc.is_object() == false || doc.does_object_element_exist("results") == false){
+		quark::throw_runtime_error("Not a benchmark report: missing \"results\".");
+	}
+	return benchmark_results_from_json(doc.get_object_element("results"));
+}
+
+
+//	RFC 4180 style quoting.
+static std::string csv_escape(const std::string& s){
+	if(s.find_first_of(",\"\n") == std::string::npos){
+		return s;
+	}
+	std::string result = "\"";
+	for(const auto ch: s){
+		if(ch == '"'){
+			result += "\"\"";
+		}
+		else{
+			result.push_back(ch);
+		}
+	}
+	return result + "\"";
+}
+
+std::string make_benchmark_report_csv(const std::vector<benchmark_result2_t>& test_results){
+	std::stringstream ss;
+	ss << "module,test,dur,samples,min,max,mean,median,p90,p99,stddev,mad,outliers,more" << std::endl;
+	for(const auto& e: test_results){
+		ss << csv_escape(e.test_id.module) << "," << csv_escape(e.test_id.test) << "," << e.result.dur;
+		if(e.stats.sample_count > 0){
+			const auto& st = e.stats;
+			ss << "," << st.sample_count << "," << st.min << "," << st.max << "," << st.mean << "," << st.median
+				<< "," << st.p90 << "," << st.p99 << "," << st.stddev << "," << st.mad << "," << st.outlier_count;
+		}
+		else{
+			ss << ",,,,,,,,,,";
+		}
+		ss << "," << (e.result.more.is_null() ? "" : csv_escape(json_to_compact_string(e.result.more))) << std::endl;
+	}
+	return ss.str();
+}
+
+QUARK_TEST("", "make_benchmark_report_csv()", "", ""){
+	const auto test = std::vector<benchmark_result2_t> {
+		benchmark_result2_t { benchmark_id_t{ "", "a,b" }, benchmark_result_t { 2000, json_t("0 elements") }, benchmark_stats_t {} },
+		benchmark_result2_t { benchmark_id_t{ "", "def" }, benchmark_result_t { 1, json_t() }, benchmark_stats_t { 10, 1, 9, 3, 2, 8, 9, 2, 1, 1 } }
+	};
+	ut_verify(
+		QUARK_POS,
+		make_benchmark_report_csv(test),
+		"module,test,dur,samples,min,max,mean,median,p90,p99,stddev,mad,outliers,more\n"
+		",\"a,b\",2000,,,,,,,,,,,\"\"\"0 elements\"\"\"\n"
+		",def,1,10,1,9,3,2,8,9,2,1,1,\n"
+	);
+}
+
+
+/*
+	Results are matched on module + test + their order within that test.
+	With statistics on both sides, a change counts if Welch's t-statistic of the means is >= 3 and the
+	medians differ by more than threshold. Without statistics only the threshold is used, on dur.
+*/
+benchmark_compare_t compare_benchmark_results(const std::vector<benchmark_result2_t>& baseline, const std::vector<benchmark_result2_t>& current, double threshold){
+	const auto make_keys = [](const std::vector<benchmark_result2_t>& results){
+		std::map<std::pair<std::string, std::string>, int> counts;
+		std::vector<std::string> keys;
+		for(const auto& e: results){
+			const auto index = counts[{ e.test_id.module, e.test_id.test }]++;
+			keys.push_back(e.test_id.module + ":" + e.test_id.test + ":" + std::to_string(index));
+		}
+		return keys;
+	};
+	const auto baseline_keys = make_keys(baseline);
+	const auto current_keys = make_keys(current);
+
+	const auto headings = line_t{ { "MODULE", "TEST", "BASELINE", "CURRENT", "CHANGE", "VERDICT" } };
+	std::vector<line_t> table;
+	int regression_count = 0;
+
+	for(size_t i = 0 ; i < current.size() ; i++){
+		const auto& cur = current[i];
+		const auto it = std::find(baseline_keys.begin(), baseline_keys.end(), current_keys[i]);
+		if(it == baseline_keys.end()){
+			table.push_back(line_t{ { cur.test_id.module, cur.test_id.test, "", std::to_string(cur.result.dur) + " ns", "", "new" } });
+			continue;
+		}
+		const auto& base = baseline[it - baseline_keys.begin()];
+
+		const bool has_stats = base.stats.sample_count > 1 && cur.stats.sample_count > 1;
+		const auto base_value = has_stats ? base.stats.median : base.result.dur;
+		const auto cur_value = has_stats ? cur.stats.median : cur.result.dur;
+		const double change = base_value != 0 ? (double)(cur_value - base_value) / (double)base_value : 0.0;
+
+		const bool significant = [&](){
+			if(has_stats){
+				const auto variance = [](const benchmark_stats_t& st){
+					return (double)st.stddev * (double)st.stddev / (double)st.sample_count;
+				};
+				const double se = std::sqrt(variance(base.stats) + variance(cur.stats));
+				const double t = se > 0.0 ? std::abs((double)(cur.stats.mean - base.stats.mean)) / se : 0.0;
+				return t >= 3.0;
+			}
+			else{
+				return true;
+			}
+		}();
+
+		std::string verdict;
+		if(significant && change > threshold){
+			verdict = "REGRESSION";
+			regression_count++;
+		}
+		else if(significant && change < -threshold){
+			verdict = "improved";
+		}
+
+		std::stringstream change_str;
+		change_str.precision(1);
+		change_str << std::fixed << (change >= 0.0 ? "+" : "") << change * 100.0 << "%";
+
+		table.push_back(
+			line_t{
+				{
+					cur.test_id.module,
+					cur.test_id.test,
+					std::to_string(base_value) + " ns",
+					std::to_string(cur_value) + " ns",
+					change_str.str(),
+					verdict
+				}
+			}
+		);
+	}
+	for(size_t i = 0 ; i < baseline.size() ; i++){
+		if(std::find(current_keys.begin(), current_keys.end(), baseline_keys[i]) == current_keys.end()){
+			const auto& base = baseline[i];
+			table.push_back(line_t{ { base.test_id.module, base.test_id.test, std::to_string(base.result.dur) + " ns", "", "", "missing" } });
+		}
+	}
+
+	const auto default_column = column_t{ 0, 0, 1 };
+	const auto start_columns = std::vector<column_t>{ default_column, default_column, { 0, 1, 0 }, { 0, 1, 0 }, { 0, 1, 0 }, default_column };
+	const auto columns = fit_columns(fit_column(start_columns, headings), table);
+	const auto header_rows = std::vector<line_t>{
+		headings,
+		line_t::make_pad(std::vector<std::string>(start_columns.size(), ""), '-')
+	};
+
+	std::stringstream ss;
+	for(const auto& e: generate_table(concat(header_rows, table), columns)){
+		ss << e << std::endl;
+	}
+	return benchmark_compare_t { ss.str(), regression_count };
+}
+
+QUARK_TEST("", "compare_benchmark_results()", "", ""){
+	const auto baseline = std::vector<benchmark_result2_t> {
+		benchmark_result2_t { benchmark_id_t{ "", "a" }, benchmark_result_t { 1000, json_t() }, benchmark_stats_t {} },
+		benchmark_result2_t { benchmark_id_t{ "", "b" }, benchmark_result_t { 1000, json_t() }, benchmark_stats_t { 1000, 990, 1100, 1000, 1000, 1050, 1090, 20, 10, 0 } },
+		benchmark_result2_t { benchmark_id_t{ "", "c" }, benchmark_result_t { 1000, json_t() }, benchmark_stats_t { 1000, 990, 1100, 1000, 1000, 1050, 1090, 20, 10, 0 } },
+		benchmark_result2_t { benchmark_id_t{ "", "gone" }, benchmark_result_t { 1000, json_t() }, benchmark_stats_t {} }
+	};
+	const auto current = std::vector<benchmark_result2_t> {
+		//	Slower, no stats: regression.
+		benchmark_result2_t { benchmark_id_t{ "", "a" }, benchmark_result_t { 1200, json_t() }, benchmark_stats_t {} },
+
+		//	Slower median and significant: regression.
+		benchmark_result2_t { benchmark_id_t{ "", "b" }, benchmark_result_t { 1190, json_t() }, benchmark_stats_t { 1000, 1190, 1300, 1200, 1200, 1250, 1290, 20, 10, 0 } },
+
+		//	Slower median but noise is huge: not significant.
+		benchmark_result2_t { benchmark_id_t{ "", "c" }, benchmark_result_t { 990, json_t() }, benchmark_stats_t { 4, 990, 90000, 30000, 1200, 90000, 90000, 40000, 10, 1 } },
+		benchmark_result2_t { benchmark_id_t{ "", "new" }, benchmark_result_t { 1000, json_t() }, benchmark_stats_t {} }
+	};
+
+	const auto r = compare_benchmark_results(baseline, current, 0.05);
+	std::cout << r.report;
+	QUARK_VERIFY(r.regression_count == 2);
+}
+
+
+
 //??? check path is valid dir
 bool is_valid_absolute_dir_path(const std::string& s){
 	if(s.empty()){
@@ -46,6 +46,22 @@ type_t make__binary_t__type(types_t& types);
 
 std::string make_benchmark_report(const std::vector<benchmark_result2_t>& test_results);
 
+json_t benchmark_results_to_json(const std::vector<benchmark_result2_t>& test_results);
+std::vector<benchmark_result2_t> benchmark_results_from_json(const json_t& j);
+
+//	Machine readable reports. The JSON report can be read back using parse_benchmark_report_json().
+std::string make_benchmark_report_json(const std::vector<benchmark_result2_t>& test_results, const std::vector<std::pair<std::string, json_t>>& hardware_caps);
+std::vector<benchmark_result2_t> parse_benchmark_report_json(const std::string& s);
+std::string make_benchmark_report_csv(const std::vector<benchmark_result2_t>& test_results);
+
+struct benchmark_compare_t {
+	std::string report;
+	int regression_count;
+};
+
+//	Diffs two sets of results. threshold is the relative change that counts, 0.05 = 5%.
+benchmark_compare_t compare_benchmark_results(const std::vector<benchmark_result2_t>& baseline, const std::vector<benchmark_result2_t>& current, double threshold);
+
 std::vector<std::pair<std::string, json_t>> corelib_detect_hardware_caps();
 std::string corelib_make_hardware_caps_report(const std::vector<std::pair<std::string, json_t>>& caps);
 std::string corelib_make_hardware_caps_report_brief(const std::vector<std::pair<std::string, json_t>>& caps);
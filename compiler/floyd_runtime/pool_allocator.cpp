@@ -0,0 +1,387 @@
+//
+//  pool_allocator.cpp
+//  floyd
+//
+//  Created by Marcus Zetterquist on 2026-10-18.
+//  Copyright © 2026 Marcus Zetterquist. All rights reserved.
+//
+
+#include "pool_allocator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <thread>
+
+
+namespace floyd {
+
+
+
+static const size_t k_alignment = 16;
+
+static size_t align_size(size_t byte_count){
+	return (byte_count + k_alignment - 1) & ~(k_alignment - 1);
+}
+
+static void* malloc_or_throw(size_t byte_count){
+	void* p = std::malloc(byte_count);
+	if(p == nullptr){
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+
+
+////////////////////////////////		POOL
+
+
+/*
+	Size classes in bytes. A heap_alloc_64_t header is 64 bytes, the first classes give it 0 - 6 allocation
+	words in steps of 2 words, then the classes grow by about 25%. This wastes at most 20% on rounding.
+*/
+static const size_t k_size_classes[] = {
+	64, 80, 96, 112,
+	128, 160, 192, 224,
+	256, 320, 384, 448,
+	512, 640, 768, 896,
+	1024, 1280, 1536, 1792,
+	2048, 2560, 3072, 3584,
+	4096
+};
+static const int k_size_class_count = sizeof(k_size_classes) / sizeof(k_size_classes[0]);
+
+//	Number of blocks moved between a thread's free list and the central free list at a time.
+static const int64_t k_transfer_count = 32;
+
+//	A thread keeps at most this many free blocks per size class before it hands a batch back.
+static const int64_t k_max_thread_cached_count = k_transfer_count * 2;
+
+//	Slabs are at least this big.
+static const size_t k_slab_size = 64 * 1024;
+
+//	The link of a free block sits after the first word. For a heap_alloc_64_t that word holds the RC and
+//	magic, keeping them intact lets debug code detect use of a released alloc.
+static const size_t k_link_offset = 8;
+
+
+static int get_size_class(size_t byte_count){
+	QUARK_ASSERT(byte_count <= k_pool_max_block_size);
+
+	const auto it = std::lower_bound(&k_size_classes[0], &k_size_classes[k_size_class_count], byte_count);
+	return static_cast<int>(it - &k_size_classes[0]);
+}
+
+static void*& get_link(void* block){
+	return *reinterpret_cast<void**>(reinterpret_cast<uint8_t*>(block) + k_link_offset);
+}
+
+
+struct free_list_t {
+	void* head;
+	int64_t count;
+};
+
+static void push_block(free_list_t& list, void* block){
+	get_link(block) = list.head;
+	list.head = block;
+	list.count++;
+}
+
+static void* pop_block(free_list_t& list){
+	QUARK_ASSERT(list.head != nullptr);
+
+	void* block = list.head;
+	list.head = get_link(block);
+	list.count--;
+	return block;
+}
+
+//	Moves up to count blocks from source to dest.
+static void transfer_blocks(free_list_t& dest, free_list_t& source, int64_t count){
+	for(int64_t i = 0 ; i < count && source.head != nullptr ; i++){
+		push_block(dest, pop_block(source));
+	}
+}
+
+
+struct pool_central_t {
+	std::mutex mutex;
+	free_list_t lists[k_size_class_count];
+	std::vector<void*> slabs;
+};
+
+//	Never destroyed: threads can still free blocks while static objects are destructed.
+static pool_central_t& get_central(){
+	static pool_central_t* central = new pool_central_t{};
+	return *central;
+}
+
+//	Refills a thread's free list from the central free list, carving a new slab if it is empty.
+static void refill_from_central(free_list_t& list, int size_class){
+	auto& central = get_central();
+	std::lock_guard<std::mutex> guard(central.mutex);
+
+	auto& central_list = central.lists[size_class];
+	if(central_list.head == nullptr){
+		const auto block_size = k_size_classes[size_class];
+		const auto block_count = std::max<size_t>(k_slab_size / block_size, k_transfer_count);
+		auto slab = reinterpret_cast<uint8_t*>(malloc_or_throw(block_size * block_count));
+		central.slabs.push_back(slab);
+
+		//	Push in reverse so blocks are handed out in address order.
+		for(size_t i = block_count ; i > 0 ; i--){
+			push_block(central_list, slab + (i - 1) * block_size);
+		}
+	}
+	transfer_blocks(list, central_list, k_transfer_count);
+}
+
+static void return_to_central(free_list_t& list, int size_class, int64_t count){
+	auto& central = get_central();
+	std::lock_guard<std::mutex> guard(central.mutex);
+	transfer_blocks(central.lists[size_class], list, count);
+}
+
+
+struct pool_thread_cache_t {
+	~pool_thread_cache_t(){
+		for(int i = 0 ; i < k_size_class_count ; i++){
+			if(lists[i].head != nullptr){
+				return_to_central(lists[i], i, lists[i].count);
+			}
+		}
+	}
+
+	free_list_t lists[k_size_class_count] = {};
+};
+
+static thread_local pool_thread_cache_t tl_thread_cache;
+
+
+
+size_t get_pool_block_size(size_t byte_count){
+	if(byte_count <= k_pool_max_block_size){
+		return k_size_classes[get_size_class(byte_count)];
+	}
+	else{
+		return align_size(byte_count);
+	}
+}
+
+void* pool_alloc(size_t byte_count){
+	if(byte_count > k_pool_max_block_size){
+		return malloc_or_throw(byte_count);
+	}
+
+	const auto size_class = get_size_class(byte_count);
+	auto& list = tl_thread_cache.lists[size_class];
+	if(list.head == nullptr){
+		refill_from_central(list, size_class);
+	}
+	return pop_block(list);
+}
+
+void pool_free(void* p, size_t byte_count){
+	QUARK_ASSERT(p != nullptr);
+
+	if(byte_count > k_pool_max_block_size){
+		std::free(p);
+		return;
+	}
+
+	const auto size_class = get_size_class(byte_count);
+	auto& list = tl_thread_cache.lists[size_class];
+	push_block(list, p);
+	if(list.count > k_max_thread_cached_count){
+		return_to_central(list, size_class, k_transfer_count);
+	}
+}
+
+
+
+QUARK_TEST("pool_allocator", "get_pool_block_size()", "", ""){
+	QUARK_VERIFY(get_pool_block_size(1) == 64);
+	QUARK_VERIFY(get_pool_block_size(64) == 64);
+	QUARK_VERIFY(get_pool_block_size(64 + 8) == 80);
+	QUARK_VERIFY(get_pool_block_size(64 + 3 * 8) == 96);
+	QUARK_VERIFY(get_pool_block_size(4096) == 4096);
+	QUARK_VERIFY(get_pool_block_size(4097) == 4112);
+}
+
+QUARK_TEST("pool_allocator", "pool_alloc()", "", "Freed blocks are reused"){
+	void* a = pool_alloc(72);
+	QUARK_VERIFY(a != nullptr);
+	QUARK_VERIFY((reinterpret_cast<uintptr_t>(a) % 16) == 0);
+	pool_free(a, 72);
+
+	void* b = pool_alloc(80);
+	QUARK_VERIFY(b == a);
+	pool_free(b, 80);
+}
+
+QUARK_TEST("pool_allocator", "pool_free()", "", "First word is kept"){
+	auto a = reinterpret_cast<uint64_t*>(pool_alloc(64));
+	a[0] = 0x1234;
+	pool_free(a, 64);
+	QUARK_VERIFY(a[0] == 0x1234);
+}
+
+QUARK_TEST("pool_allocator", "pool_alloc()", "Big block", "Uses malloc()"){
+	auto a = reinterpret_cast<uint8_t*>(pool_alloc(100000));
+	a[99999] = 7;
+	pool_free(a, 100000);
+}
+
+QUARK_TEST("pool_allocator", "pool_alloc()", "Many threads", "No block is handed out twice"){
+	const int thread_count = 4;
+	const int alloc_count = 5000;
+
+	std::atomic<bool> ok(true);
+	std::vector<std::thread> threads;
+	for(int t = 0 ; t < thread_count ; t++){
+		threads.push_back(std::thread([&ok, t](){
+			std::vector<uint64_t*> blocks;
+			for(int i = 0 ; i < alloc_count ; i++){
+				auto p = reinterpret_cast<uint64_t*>(pool_alloc(64 + (i % 5) * 8));
+				p[0] = t * alloc_count + i;
+				blocks.push_back(p);
+			}
+			for(int i = 0 ; i < alloc_count ; i++){
+				if(blocks[i][0] != static_cast<uint64_t>(t * alloc_count + i)){
+					ok = false;
+				}
+				pool_free(blocks[i], 64 + (i % 5) * 8);
+			}
+		}));
+	}
+	for(auto& e: threads){
+		e.join();
+	}
+	QUARK_VERIFY(ok);
+}
+
+
+
+////////////////////////////////		arena_t
+
+
+
+arena_t::arena_t(size_t chunk_size) :
+	chunk_size(align_size(chunk_size)),
+	pos(nullptr),
+	end(nullptr),
+	alloc_count(0)
+{
+	QUARK_ASSERT(chunk_size > 0);
+
+	QUARK_ASSERT(check_invariant());
+}
+
+arena_t::~arena_t(){
+	QUARK_ASSERT(check_invariant());
+
+	for(auto e: chunks){
+		std::free(e);
+	}
+}
+
+bool arena_t::check_invariant() const {
+	QUARK_ASSERT(chunk_size > 0 && (chunk_size % k_alignment) == 0);
+	QUARK_ASSERT(pos <= end);
+	return true;
+}
+
+void* arena_alloc(arena_t& arena, size_t byte_count){
+	const auto size = align_size(byte_count);
+
+	std::lock_guard<std::mutex> guard(arena.mutex);
+	QUARK_ASSERT(arena.check_invariant());
+
+	if(size > static_cast<size_t>(arena.end - arena.pos)){
+		//	Big blocks get a chunk of their own, we keep bump allocating in the current chunk.
+		if(size > arena.chunk_size / 4){
+			auto chunk = reinterpret_cast<uint8_t*>(malloc_or_throw(size));
+			arena.chunks.insert(arena.chunks.begin(), chunk);
+			arena.alloc_count++;
+			return chunk;
+		}
+
+		auto chunk = reinterpret_cast<uint8_t*>(malloc_or_throw(arena.chunk_size));
+		arena.chunks.push_back(chunk);
+		arena.pos = chunk;
+		arena.end = chunk + arena.chunk_size;
+	}
+
+	auto result = arena.pos;
+	arena.pos += size;
+	arena.alloc_count++;
+	return result;
+}
+
+void reset_arena(arena_t& arena){
+	std::lock_guard<std::mutex> guard(arena.mutex);
+	QUARK_ASSERT(arena.check_invariant());
+
+	//	Keep the last chunk, it is always a normal-sized chunk.
+	uint8_t* keep = nullptr;
+	if(arena.chunks.empty() == false && arena.end == arena.chunks.back() + arena.chunk_size){
+		keep = arena.chunks.back();
+		arena.chunks.pop_back();
+	}
+	for(auto e: arena.chunks){
+		std::free(e);
+	}
+	arena.chunks.clear();
+
+	if(keep != nullptr){
+		arena.chunks.push_back(keep);
+		arena.pos = keep;
+		arena.end = keep + arena.chunk_size;
+	}
+	else{
+		arena.pos = nullptr;
+		arena.end = nullptr;
+	}
+	arena.alloc_count = 0;
+
+	QUARK_ASSERT(arena.check_invariant());
+}
+
+
+
+QUARK_TEST("arena_t", "arena_alloc()", "", ""){
+	arena_t arena(1024);
+	auto a = reinterpret_cast<uint8_t*>(arena_alloc(arena, 10));
+	auto b = reinterpret_cast<uint8_t*>(arena_alloc(arena, 100));
+	QUARK_VERIFY(b == a + 16);
+	QUARK_VERIFY(arena.alloc_count == 2);
+
+	//	Big block gets its own chunk.
+	auto c = reinterpret_cast<uint8_t*>(arena_alloc(arena, 5000));
+	c[4999] = 1;
+	QUARK_VERIFY(arena.chunks.size() == 2);
+
+	auto d = reinterpret_cast<uint8_t*>(arena_alloc(arena, 16));
+	QUARK_VERIFY(d == a + 16 + 112);
+}
+
+QUARK_TEST("arena_t", "reset_arena()", "", "Keeps one chunk"){
+	arena_t arena(1024);
+	for(int i = 0 ; i < 100 ; i++){
+		arena_alloc(arena, 64);
+	}
+	QUARK_VERIFY(arena.chunks.size() > 1);
+
+	reset_arena(arena);
+	QUARK_VERIFY(arena.alloc_count == 0);
+	QUARK_VERIFY(arena.chunks.size() == 1);
+
+	auto a = reinterpret_cast<uint8_t*>(arena_alloc(arena, 64));
+	QUARK_VERIFY(a == arena.chunks[0]);
+}
+
+
+}	// floyd
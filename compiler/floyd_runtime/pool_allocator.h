@@ -0,0 +1,95 @@
+//
+//  pool_allocator.h
+//  floyd
+//
+//  Created by Marcus Zetterquist on 2026-10-18.
+//  Copyright © 2026 Marcus Zetterquist. All rights reserved.
+//
+
+#ifndef pool_allocator_hpp
+#define pool_allocator_hpp
+
+/*
+	Memory for heap_t allocs. Two allocators:
+
+	POOL
+	Blocks are rounded up to a size class and recycled via free lists instead of malloc() / free().
+	The size classes are tuned for a heap_alloc_64_t header followed by a few allocation words.
+	Each thread has its own free lists, so threads don't contend. Free lists move blocks to / from a
+	central free list in batches. Memory is carved from big slabs and is never returned to the OS.
+	Blocks bigger than the largest size class use malloc() / free() directly.
+
+	ARENA
+	Bump allocation from big chunks. Individual blocks are never freed: the entire arena is reset at once,
+	for example after handling a message or after a benchmark iteration.
+
+	All blocks are aligned to 16 bytes.
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "quark.h"
+
+
+namespace floyd {
+
+
+
+////////////////////////////////		POOL
+
+
+//	Largest block that comes from the size classes, bigger blocks use malloc().
+const size_t k_pool_max_block_size = 4096;
+
+//	Returns the size of the block that pool_alloc(byte_count) will actually use.
+size_t get_pool_block_size(size_t byte_count);
+
+//	Thread safe. Never returns nullptr, throws std::bad_alloc.
+void* pool_alloc(size_t byte_count);
+
+//	Thread safe. Any thread can free a block. byte_count must be the same as when the block was allocated.
+//	The first 8 bytes of the block are left untouched.
+void pool_free(void* p, size_t byte_count);
+
+
+
+////////////////////////////////		arena_t
+
+
+struct arena_t {
+	arena_t(size_t chunk_size);
+	~arena_t();
+	bool check_invariant() const;
+
+	arena_t(const arena_t& other) = delete;
+	arena_t& operator=(const arena_t& other) = delete;
+
+
+	////////////////////////////////		STATE
+
+	//	Several threads can allocate at the same time, for example map() running in parallel.
+	std::mutex mutex;
+
+	size_t chunk_size;
+	std::vector<uint8_t*> chunks;
+
+	//	Free space in the last chunk.
+	uint8_t* pos;
+	uint8_t* end;
+
+	int64_t alloc_count;
+};
+
+//	Thread safe. Never returns nullptr, throws std::bad_alloc.
+void* arena_alloc(arena_t& arena, size_t byte_count);
+
+//	Frees every block in the arena at once. Keeps one chunk for reuse.
+void reset_arena(arena_t& arena);
+
+
+}	// floyd
+
+#endif /* pool_allocator_hpp */
@@ -0,0 +1,143 @@
+//
+//  process_inbox.cpp
+//  floyd
+//
+//  Created by Marcus Zetterquist on 2026-10-18.
+//  Copyright © 2026 Marcus Zetterquist. All rights reserved.
+//
+
+#include "process_inbox.h"
+
+#include <iomanip>
+#include <sstream>
+
+
+namespace floyd {
+
+
+
+std::string format_inbox_stats(const std::vector<std::pair<std::string, inbox_stats_t>>& stats){
+	std::stringstream ss;
+	ss << std::left << std::setw(24) << "INBOX"
+		<< std::right << std::setw(10) << "DEPTH"
+		<< std::setw(10) << "MAX DEPTH"
+		<< std::setw(12) << "SENDS"
+		<< std::setw(12) << "CONTENTION"
+		<< std::setw(10) << "PARKS"
+		<< std::setw(10) << "WAKEUPS"
+		<< std::endl;
+
+	for(const auto& e: stats){
+		ss << std::left << std::setw(24) << e.first
+			<< std::right << std::setw(10) << e.second.depth
+			<< std::setw(10) << e.second.max_depth
+			<< std::setw(12) << e.second.send_count
+			<< std::setw(12) << e.second.contention_count
+			<< std::setw(10) << e.second.park_count
+			<< std::setw(10) << e.second.wakeup_count
+			<< std::endl;
+	}
+	return ss.str();
+}
+
+
+
+QUARK_TEST("process_inbox_t", "pop_messages()", "", "Send order, in batches"){
+	process_inbox_t<int> inbox;
+	for(int i = 0 ; i < 10 ; i++){
+		push_message(inbox, i);
+	}
+	QUARK_VERIFY(has_messages(inbox));
+	QUARK_VERIFY(get_inbox_stats(inbox).depth == 10);
+
+	int dest[4];
+	QUARK_VERIFY(pop_messages(inbox, dest, 4) == 4);
+	QUARK_VERIFY(dest[0] == 0 && dest[1] == 1 && dest[2] == 2 && dest[3] == 3);
+	QUARK_VERIFY(has_messages(inbox));
+	QUARK_VERIFY(has_incoming_messages(inbox) == false);
+
+	//	Arrives after the current batch was taken.
+	push_message(inbox, 10);
+	QUARK_VERIFY(has_incoming_messages(inbox));
+
+	QUARK_VERIFY(pop_messages(inbox, dest, 4) == 4);
+	QUARK_VERIFY(dest[0] == 4 && dest[3] == 7);
+	QUARK_VERIFY(pop_messages(inbox, dest, 4) == 2);
+	QUARK_VERIFY(dest[0] == 8 && dest[1] == 9);
+	QUARK_VERIFY(pop_messages(inbox, dest, 4) == 1);
+	QUARK_VERIFY(dest[0] == 10);
+	QUARK_VERIFY(pop_messages(inbox, dest, 4) == 0);
+	QUARK_VERIFY(has_messages(inbox) == false);
+
+	const auto stats = get_inbox_stats(inbox);
+	QUARK_VERIFY(stats.depth == 0);
+	QUARK_VERIFY(stats.max_depth == 10);
+	QUARK_VERIFY(stats.send_count == 11);
+}
+
+QUARK_TEST("process_inbox_t", "wait_for_messages()", "Many senders", "All messages arrive, per-sender order is kept"){
+	const int sender_count = 4;
+	const int message_count = 20000;
+
+	process_inbox_t<int> inbox;
+	std::vector<std::thread> senders;
+	for(int s = 0 ; s < sender_count ; s++){
+		senders.push_back(std::thread([&inbox, s](){
+			for(int i = 0 ; i < message_count ; i++){
+				push_message(inbox, s * message_count + i);
+			}
+		}));
+	}
+
+	std::vector<int> last(sender_count, -1);
+	int received_count = 0;
+	bool in_order = true;
+	while(received_count < sender_count * message_count){
+		int dest[k_inbox_batch_size];
+		const auto count = wait_for_messages(inbox, dest, k_inbox_batch_size);
+		for(size_t i = 0 ; i < count ; i++){
+			const auto sender = dest[i] / message_count;
+			const auto index = dest[i] % message_count;
+			in_order = in_order && index == last[sender] + 1;
+			last[sender] = index;
+		}
+		received_count += static_cast<int>(count);
+	}
+
+	for(auto& t: senders){
+		t.join();
+	}
+	QUARK_VERIFY(in_order);
+	QUARK_VERIFY(received_count == sender_count * message_count);
+	QUARK_VERIFY(get_inbox_stats(inbox).send_count == sender_count * message_count);
+}
+
+QUARK_TEST("process_inbox_t", "wait_for_messages()", "Receiver parks", "Wakes up on send"){
+	process_inbox_t<int> inbox;
+
+	int received = 0;
+	std::thread receiver([&inbox, &received](){
+		int dest[1];
+		wait_for_messages(inbox, dest, 1);
+		received = dest[0];
+	});
+
+	//	Give the receiver time to run out of spins.
+	while(inbox.parked.load() == false){
+		std::this_thread::yield();
+	}
+	push_message(inbox, 1234);
+	receiver.join();
+
+	QUARK_VERIFY(received == 1234);
+	QUARK_VERIFY(get_inbox_stats(inbox).wakeup_count >= 1);
+}
+
+QUARK_TEST("process_inbox_t", "format_inbox_stats()", "", ""){
+	const auto s = format_inbox_stats({ { "a", inbox_stats_t{ 1, 2, 3, 4, 5, 6 } } });
+	QUARK_VERIFY(s.find("MAX DEPTH") != std::string::npos);
+	QUARK_VERIFY(s.find("a ") != std::string::npos);
+}
+
+
+}	// floyd
@@ -0,0 +1,248 @@
+//
+//  process_inbox.h
+//  floyd
+//
+//  Created by Marcus Zetterquist on 2026-10-18.
+//  Copyright © 2026 Marcus Zetterquist. All rights reserved.
+//
+
+#ifndef process_inbox_hpp
+#define process_inbox_hpp
+
+/*
+	The inbox of a Floyd clock bus or process: a lock-free multi-producer, single-consumer queue.
+
+	- Any thread can send. A send is one compare-and-swap that pushes a node onto a stack. No mutex.
+	- Only the owning thread receives. It takes the entire stack with one exchange, reverses it to get
+		oldest-first order and then hands out messages in batches without touching any shared state.
+	- A receiver without messages first spins, then parks on a condition variable. Senders only take the
+		park mutex and notify when the receiver is actually parked, so a busy process costs no futex calls.
+
+	The counters are approximate and meant for finding hot spots: an inbox with a high max_depth or
+	contention_count is a fan-in bottleneck.
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "quark.h"
+
+
+namespace floyd {
+
+
+//	Number of times a receiver polls its empty inbox before it parks.
+const int k_inbox_spin_count = 256;
+
+//	A process handles up to this many messages per wakeup.
+const size_t k_inbox_batch_size = 32;
+
+
+struct inbox_stats_t {
+	int64_t depth;
+	int64_t max_depth;
+	int64_t send_count;
+
+	//	Sends that had to retry their compare-and-swap because another sender got there first.
+	int64_t contention_count;
+
+	//	Times the receiver ran out of spins and parked, and times a sender had to wake it up.
+	int64_t park_count;
+	int64_t wakeup_count;
+};
+
+
+
+////////////////////////////////		process_inbox_t
+
+
+template <typename T>
+struct process_inbox_t {
+	struct node_t {
+		T value;
+		node_t* next;
+	};
+
+	process_inbox_t() :
+		incoming(nullptr),
+		batch(nullptr),
+		parked(false),
+		depth(0),
+		max_depth(0),
+		send_count(0),
+		contention_count(0),
+		park_count(0),
+		wakeup_count(0)
+	{
+	}
+
+	//	Frees the nodes of messages that were never received. It does not release what the values point to.
+	~process_inbox_t(){
+		free_nodes(incoming.load());
+		free_nodes(batch);
+	}
+
+	process_inbox_t(const process_inbox_t& other) = delete;
+	process_inbox_t& operator=(const process_inbox_t& other) = delete;
+
+	bool check_invariant() const {
+		return true;
+	}
+
+	static void free_nodes(node_t* p){
+		while(p != nullptr){
+			const auto next = p->next;
+			delete p;
+			p = next;
+		}
+	}
+
+
+	////////////////////////////////		STATE
+
+	//	Senders push here, newest first.
+	std::atomic<node_t*> incoming;
+
+	//	Only the receiver touches this, oldest first.
+	node_t* batch;
+
+	std::atomic<bool> parked;
+	std::mutex park_mutex;
+	std::condition_variable park_condition;
+
+	std::atomic<int64_t> depth;
+	std::atomic<int64_t> max_depth;
+	std::atomic<int64_t> send_count;
+	std::atomic<int64_t> contention_count;
+	std::atomic<int64_t> park_count;
+	std::atomic<int64_t> wakeup_count;
+};
+
+
+//	Thread safe, call from any thread.
+template <typename T>
+void push_message(process_inbox_t<T>& inbox, const T& value){
+	auto node = new typename process_inbox_t<T>::node_t{ value, inbox.incoming.load(std::memory_order_relaxed) };
+	while(inbox.incoming.compare_exchange_weak(node->next, node) == false){
+		inbox.contention_count.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	inbox.send_count.fetch_add(1, std::memory_order_relaxed);
+	const auto depth = inbox.depth.fetch_add(1, std::memory_order_relaxed) + 1;
+	auto max_depth = inbox.max_depth.load(std::memory_order_relaxed);
+	while(depth > max_depth && inbox.max_depth.compare_exchange_weak(max_depth, depth, std::memory_order_relaxed) == false){
+	}
+
+	//	Pairs with the receiver storing parked = true and then checking incoming, both sequentially consistent:
+	//	either we see the receiver parked or the receiver sees our node.
+	if(inbox.parked.load()){
+		{
+			std::lock_guard<std::mutex> lk(inbox.park_mutex);
+		}
+		inbox.park_condition.notify_one();
+		inbox.wakeup_count.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+//	The caller must own the receiving side, for a clock bus inbox that means owning the clock bus. Reads batch,
+//	which races with a receiver on another thread. Returns true if there are messages to receive. Senders can
+//	add more at any time.
+template <typename T>
+bool has_messages(const process_inbox_t<T>& inbox){
+	return inbox.batch != nullptr || inbox.incoming.load() != nullptr;
+}
+
+//	Thread safe, call from any thread. Returns true if senders pushed messages that no receiver has taken yet.
+//	Doesn't look at batch: use when pop_messages() just came back empty, so batch is known to be empty.
+template <typename T>
+bool has_incoming_messages(const process_inbox_t<T>& inbox){
+	return inbox.incoming.load() != nullptr;
+}
+
+//	Receiver only. Moves up to max_count messages into dest, oldest first, without blocking. Returns the count.
+template <typename T>
+size_t pop_messages(process_inbox_t<T>& inbox, T dest[], size_t max_count){
+	if(inbox.batch == nullptr){
+		auto p = inbox.incoming.exchange(nullptr, std::memory_order_acquire);
+
+		//	Reverse the stack to get the messages in send order.
+		typename process_inbox_t<T>::node_t* batch = nullptr;
+		while(p != nullptr){
+			const auto next = p->next;
+			p->next = batch;
+			batch = p;
+			p = next;
+		}
+		inbox.batch = batch;
+	}
+
+	size_t count = 0;
+	while(count < max_count && inbox.batch != nullptr){
+		auto node = inbox.batch;
+		inbox.batch = node->next;
+		dest[count] = std::move(node->value);
+		delete node;
+		count++;
+	}
+	inbox.depth.fetch_sub(static_cast<int64_t>(count), std::memory_order_relaxed);
+	return count;
+}
+
+//	Receiver only. Blocks until there is at least one message, then works like pop_messages().
+//	Spins first since a process in a busy pipeline usually gets its next message soon, then parks.
+template <typename T>
+size_t wait_for_messages(process_inbox_t<T>& inbox, T dest[], size_t max_count){
+	QUARK_ASSERT(max_count > 0);
+
+	for(int i = 0 ; i < k_inbox_spin_count ; i++){
+		const auto count = pop_messages(inbox, dest, max_count);
+		if(count > 0){
+			return count;
+		}
+		if(i >= k_inbox_spin_count / 2){
+			std::this_thread::yield();
+		}
+	}
+
+	while(true){
+		const auto count = pop_messages(inbox, dest, max_count);
+		if(count > 0){
+			return count;
+		}
+
+		inbox.parked.store(true);
+		if(has_messages(inbox) == false){
+			inbox.park_count.fetch_add(1, std::memory_order_relaxed);
+			std::unique_lock<std::mutex> lk(inbox.park_mutex);
+			inbox.park_condition.wait(lk, [&]{ return inbox.incoming.load() != nullptr; });
+		}
+		inbox.parked.store(false);
+	}
+}
+
+template <typename T>
+inbox_stats_t get_inbox_stats(const process_inbox_t<T>& inbox){
+	return inbox_stats_t {
+		std::max<int64_t>(inbox.depth.load(), 0),
+		inbox.max_depth.load(),
+		inbox.send_count.load(),
+		inbox.contention_count.load(),
+		inbox.park_count.load(),
+		inbox.wakeup_count.load()
+	};
+}
+
+//	Formats one line per inbox: name, depth, max depth, sends, contention, parks, wakeups.
+std::string format_inbox_stats(const std::vector<std::pair<std::string, inbox_stats_t>>& stats);
+
+
+}	// floyd
+
+#endif /* process_inbox_hpp */
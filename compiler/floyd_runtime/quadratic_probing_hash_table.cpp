@@ -7,3 +7,119 @@
 //
 
 #include "quadratic_probing_hash_table.h"
+
+#include <map>
+
+
+typedef quadratic_probing_hash_table_t<double> test_table_t;
+
+static std::string make_test_key(int i){
+	return "key-" + std::to_string(i);
+}
+
+
+QUARK_TEST("quadratic_probing_hash_table_t", "", "", ""){
+	QUARK_VERIFY(sizeof(test_table_t) == sizeof(uint64_t) * 4);
+}
+
+QUARK_TEST("quadratic_probing_hash_table_t", "find()", "Empty table", "Not found, no allocation"){
+	const test_table_t a;
+	QUARK_VERIFY(a.size() == 0);
+	QUARK_VERIFY(a.get_capacity() == 0);
+	QUARK_VERIFY(a.find("one") == nullptr);
+	QUARK_VERIFY(a.begin() == a.end());
+}
+
+QUARK_TEST("quadratic_probing_hash_table_t", "insert_or_assign()", "Insert, then assign", "Last value wins"){
+	test_table_t a;
+	QUARK_VERIFY(a.insert_or_assign("one", 1.0) == true);
+	QUARK_VERIFY(a.insert_or_assign("two", 2.0) == true);
+	QUARK_VERIFY(a.insert_or_assign("one", 10.0) == false);
+
+	QUARK_VERIFY(a.size() == 2);
+	QUARK_VERIFY(*a.find("one") == 10.0);
+	QUARK_VERIFY(*a.find("two") == 2.0);
+	QUARK_VERIFY(a.find("three") == nullptr);
+}
+
+QUARK_TEST("quadratic_probing_hash_table_t", "insert_or_assign()", "10000 keys", "Grows, all keys found"){
+	test_table_t a;
+	for(int i = 0 ; i < 10000 ; i++){
+		a.insert_or_assign(make_test_key(i), i);
+	}
+	QUARK_VERIFY(a.size() == 10000);
+	QUARK_VERIFY(a.get_capacity() == 16384);
+	for(int i = 0 ; i < 10000 ; i++){
+		QUARK_VERIFY(*a.find(make_test_key(i)) == i);
+	}
+	QUARK_VERIFY(a.find(make_test_key(10000)) == nullptr);
+}
+
+QUARK_TEST("quadratic_probing_hash_table_t", "erase()", "Erase every other key", "Other keys still found"){
+	test_table_t a;
+	for(int i = 0 ; i < 1000 ; i++){
+		a.insert_or_assign(make_test_key(i), i);
+	}
+	for(int i = 0 ; i < 1000 ; i += 2){
+		QUARK_VERIFY(a.erase(make_test_key(i)) == true);
+	}
+	QUARK_VERIFY(a.erase(make_test_key(0)) == false);
+
+	QUARK_VERIFY(a.size() == 500);
+	for(int i = 0 ; i < 1000 ; i++){
+		const auto p = a.find(make_test_key(i));
+		QUARK_VERIFY((i % 2 == 0) ? p == nullptr : *p == i);
+	}
+}
+
+QUARK_TEST("quadratic_probing_hash_table_t", "erase()", "Insert / erase churn", "Tombstones are reclaimed, table doesn't grow"){
+	test_table_t a;
+	for(int i = 0 ; i < 100000 ; i++){
+		a.insert_or_assign(make_test_key(i), i);
+		if(i >= 8){
+			a.erase(make_test_key(i - 8));
+		}
+	}
+	QUARK_VERIFY(a.size() == 8);
+	QUARK_VERIFY(a.get_capacity() == 16);
+	QUARK_VERIFY(*a.find(make_test_key(99999)) == 99999);
+}
+
+QUARK_TEST("quadratic_probing_hash_table_t", "const_iterator", "", "Visits every key once"){
+	test_table_t a;
+	for(int i = 0 ; i < 100 ; i++){
+		a.insert_or_assign(make_test_key(i), i);
+	}
+	a.erase(make_test_key(50));
+
+	std::map<std::string, double> visited;
+	for(const auto& e: a){
+		QUARK_VERIFY(visited.insert(e).second);
+	}
+	QUARK_VERIFY(visited.size() == 99);
+	QUARK_VERIFY(visited.count(make_test_key(50)) == 0);
+	QUARK_VERIFY(visited.at(make_test_key(99)) == 99);
+}
+
+QUARK_TEST("quadratic_probing_hash_table_t", "copy", "Mutate copy", "Original is untouched"){
+	test_table_t a;
+	for(int i = 0 ; i < 100 ; i++){
+		a.insert_or_assign(make_test_key(i), i);
+	}
+	a.erase(make_test_key(3));
+
+	test_table_t b = a;
+	b.insert_or_assign(make_test_key(0), -1.0);
+	b.erase(make_test_key(1));
+	b.insert_or_assign(make_test_key(3), 3.0);
+
+	QUARK_VERIFY(a.size() == 99);
+	QUARK_VERIFY(*a.find(make_test_key(0)) == 0.0);
+	QUARK_VERIFY(*a.find(make_test_key(1)) == 1.0);
+	QUARK_VERIFY(a.find(make_test_key(3)) == nullptr);
+
+	QUARK_VERIFY(b.size() == 99);
+	QUARK_VERIFY(*b.find(make_test_key(0)) == -1.0);
+	QUARK_VERIFY(b.find(make_test_key(1)) == nullptr);
+	QUARK_VERIFY(*b.find(make_test_key(3)) == 3.0);
+}
@@ -9,44 +9,410 @@
 #ifndef quadratic_probing_hash_table_hpp
 #define quadratic_probing_hash_table_hpp
 
+/*
+	Flat open-addressing hash table with string keys. Backs the dict_backend::hashtable dictionaries.
+
+	Every slot has a control byte: empty, tombstone (erased) or full. A full control byte holds 7 bits of
+	the key's hash. Slots are probed in groups of 16 and all control bytes of a group are matched at once
+	(SSE2 when available), so keys are only compared for slots whose hash bits match. Each slot caches the
+	full hash of its key: the common miss is rejected without touching the string and growing the table
+	never rehashes a key.
+
+	Groups are visited in quadratic (triangular) order, 0, 1, 3, 6, 10... This visits every group since the
+	group count is a power of two.
+
+	Erasing leaves a tombstone so the probe sequences of other keys stay intact. Tombstones count towards
+	the max load of 7/8. When that is reached the table is rehashed: at the same size if most of the used
+	slots are tombstones, otherwise at double the size.
+
+	The table is four words big so it can be stored inside a heap_alloc_64_t. Iteration order is unspecified.
+*/
+
 #include <string>
-#include <vector>
+#include <string_view>
+#include <functional>
+#include <utility>
+#include <iterator>
+#include <cstddef>
+#include <cstring>
+#include <cstdint>
+#include <new>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
-struct kv_t {
-	std::string key;
-	double value;
-};
+#include "quark.h"
 
 
+template <typename VALUE> struct quadratic_probing_hash_table_t {
+	typedef std::pair<std::string, VALUE> kv_t;
 
-//	std::size_t h2 = std::hash<std::string>{}(s.last_name);
-//	https://www.youtube.com/watch?v=7eLDTtbzX4M
+	static const uint64_t k_group_width = 16;
+	static const int8_t k_empty = -128;
+	static const int8_t k_tombstone = -2;
 
-struct quadratic_probing_hash_table_t {
-	enum class mode {
-		empty,
-		tombstone
+	struct slot_t {
+		uint64_t hash;
+		kv_t kv;
 	};
 
-	quadratic_probing_hash_table_t(int64_t table_size) :
-		backstore(table_size, std::pair<mode, kv_t>(mode::empty, kv_t { "-", 3.0 }))
+	struct const_iterator {
+		typedef std::forward_iterator_tag iterator_category;
+		typedef kv_t value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef const kv_t* pointer;
+		typedef const kv_t& reference;
+
+		const kv_t& operator*() const {
+			return table->get_slots()[pos].kv;
+		}
+		const kv_t* operator->() const {
+			return &table->get_slots()[pos].kv;
+		}
+		const_iterator& operator++(){
+			pos = table->skip_to_full(pos + 1);
+			return *this;
+		}
+		bool operator==(const const_iterator& other) const {
+			return table == other.table && pos == other.pos;
+		}
+		bool operator!=(const const_iterator& other) const {
+			return !(*this == other);
+		}
+
+		const quadratic_probing_hash_table_t* table;
+		uint64_t pos;
+	};
+
+
+	quadratic_probing_hash_table_t() :
+		ctrl(nullptr),
+		capacity(0),
+		count(0),
+		tombstone_count(0)
 	{
+		QUARK_ASSERT(check_invariant());
+	}
+
+	quadratic_probing_hash_table_t(const quadratic_probing_hash_table_t& other) :
+		ctrl(nullptr),
+		capacity(0),
+		count(0),
+		tombstone_count(0)
+	{
+		QUARK_ASSERT(other.check_invariant());
+
+		copy_from(other);
+		QUARK_ASSERT(check_invariant());
+	}
+
+	quadratic_probing_hash_table_t(quadratic_probing_hash_table_t&& other) noexcept :
+		ctrl(other.ctrl),
+		capacity(other.capacity),
+		count(other.count),
+		tombstone_count(other.tombstone_count)
+	{
+		other.ctrl = nullptr;
+		other.capacity = 0;
+		other.count = 0;
+		other.tombstone_count = 0;
+	}
+
+	quadratic_probing_hash_table_t& operator=(const quadratic_probing_hash_table_t& other){
+		QUARK_ASSERT(other.check_invariant());
+
+		if(this != &other){
+			destroy();
+			copy_from(other);
+		}
+		QUARK_ASSERT(check_invariant());
+		return *this;
+	}
+
+	quadratic_probing_hash_table_t& operator=(quadratic_probing_hash_table_t&& other) noexcept {
+		if(this != &other){
+			destroy();
+			std::swap(ctrl, other.ctrl);
+			std::swap(capacity, other.capacity);
+			std::swap(count, other.count);
+			std::swap(tombstone_count, other.tombstone_count);
+		}
+		return *this;
+	}
+
+	~quadratic_probing_hash_table_t(){
+		QUARK_ASSERT(check_invariant());
+
+		destroy();
+	}
+
+	bool check_invariant() const {
+		QUARK_ASSERT((capacity == 0) == (ctrl == nullptr));
+		QUARK_ASSERT(capacity % k_group_width == 0);
+		QUARK_ASSERT(count + tombstone_count <= calc_max_load(capacity));
+		return true;
+	}
+
+
+	////////////////////////////////		LOOKUP
+
+
+	uint64_t size() const {
+		return count;
+	}
+
+	uint64_t get_capacity() const {
+		return capacity;
+	}
+
+	const VALUE* find(std::string_view key) const {
+		const auto pos = find_slot(key, hash_key(key));
+		return pos == k_not_found ? nullptr : &get_slots()[pos].kv.second;
+	}
+	VALUE* find_mut(std::string_view key){
+		const auto pos = find_slot(key, hash_key(key));
+		return pos == k_not_found ? nullptr : &get_slots()[pos].kv.second;
+	}
+
+	uint64_t count_key(std::string_view key) const {
+		return find(key) != nullptr ? 1 : 0;
+	}
+
+	const_iterator begin() const {
+		return const_iterator { this, skip_to_full(0) };
+	}
+	const_iterator end() const {
+		return const_iterator { this, capacity };
+	}
+
+
+	////////////////////////////////		MUTATE
+
+
+	//	Returns true if key was inserted, false if it already existed and its value was replaced.
+	bool insert_or_assign(std::string_view key, const VALUE& value){
+		QUARK_ASSERT(check_invariant());
+
+		const auto hash = hash_key(key);
+		const auto pos = find_slot(key, hash);
+		if(pos != k_not_found){
+			get_slots()[pos].kv.second = value;
+			return false;
+		}
+
+		if(count + tombstone_count + 1 > calc_max_load(capacity)){
+			const bool mostly_tombstones = count + 1 <= calc_max_load(capacity) / 2;
+			rehash(mostly_tombstones ? capacity : calc_grown_capacity(count + 1));
+		}
+		insert_new_slot(hash, kv_t { std::string(key), value });
+		count++;
+
+		QUARK_ASSERT(check_invariant());
+		return true;
 	}
 
-	quadratic_probing_hash_table_t(const kv_t values[], int64_t count, int64_t table_size){
+	//	Returns true if key existed.
+	bool erase(std::string_view key){
+		QUARK_ASSERT(check_invariant());
+
+		const auto pos = find_slot(key, hash_key(key));
+		if(pos == k_not_found){
+			return false;
+		}
+
+		get_slots()[pos].~slot_t();
+		ctrl[pos] = k_tombstone;
+		count--;
+		tombstone_count++;
+
+		QUARK_ASSERT(check_invariant());
+		return true;
 	}
 
-	void insert(const kv_t& kv){
-		const auto hash0 = std::hash<std::string>{}(kv.key);
-		(void)hash0;
+	//	Makes room for element_count keys without rehashing.
+	void reserve(uint64_t element_count){
+		QUARK_ASSERT(check_invariant());
+
+		if(element_count > calc_max_load(capacity)){
+			rehash(calc_grown_capacity(element_count));
+		}
 	}
 
 
+	////////////////////////////////		INTERNALS
+
+
+	static const uint64_t k_not_found = UINT64_MAX;
+
+	static uint64_t hash_key(std::string_view key){
+		return std::hash<std::string_view>{}(key);
+	}
+
+	static uint64_t calc_max_load(uint64_t capacity){
+		return capacity - capacity / 8;
+	}
+
+	static uint64_t calc_grown_capacity(uint64_t element_count){
+		uint64_t result = k_group_width;
+		while(calc_max_load(result) < element_count){
+			result = result * 2;
+		}
+		return result;
+	}
+
+	//	Bit i is set if group[i] == value.
+	static uint32_t match_byte(const int8_t* group, int8_t value){
+#if defined(__SSE2__)
+		const auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+		return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(value))));
+#else
+		uint32_t result = 0;
+		for(uint64_t i = 0 ; i < k_group_width ; i++){
+			result |= group[i] == value ? (1u << i) : 0;
+		}
+		return result;
+#endif
+	}
+
+	//	Bit i is set if group[i] is empty or a tombstone: those are the control bytes with the top bit set.
+	static uint32_t match_free(const int8_t* group){
+#if defined(__SSE2__)
+		const auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+		return static_cast<uint32_t>(_mm_movemask_epi8(bytes));
+#else
+		uint32_t result = 0;
+		for(uint64_t i = 0 ; i < k_group_width ; i++){
+			result |= group[i] < 0 ? (1u << i) : 0;
+		}
+		return result;
+#endif
+	}
+
+	slot_t* get_slots() const {
+		return reinterpret_cast<slot_t*>(ctrl + capacity);
+	}
+
+	uint64_t skip_to_full(uint64_t pos) const {
+		while(pos < capacity && ctrl[pos] < 0){
+			pos++;
+		}
+		return pos;
+	}
+
+	uint64_t find_slot(std::string_view key, uint64_t hash) const {
+		if(capacity == 0){
+			return k_not_found;
+		}
+
+		const auto h2 = static_cast<int8_t>(hash & 0x7f);
+		const auto group_mask = capacity / k_group_width - 1;
+		auto group = (hash >> 7) & group_mask;
+		for(uint64_t step = 1 ; ; step++){
+			const auto group_ctrl = ctrl + group * k_group_width;
+			for(auto m = match_byte(group_ctrl, h2) ; m != 0 ; m = m & (m - 1)){
+				const auto pos = group * k_group_width + __builtin_ctz(m);
+				const auto& slot = get_slots()[pos];
+				if(slot.hash == hash && slot.kv.first == key){
+					return pos;
+				}
+			}
+
+			//	An empty slot ends the probe sequence: the key would have been inserted there.
+			if(match_byte(group_ctrl, k_empty) != 0){
+				return k_not_found;
+			}
+			group = (group + step) & group_mask;
+		}
+	}
+
+	//	Key must not already be in the table and there must be a free slot.
+	void insert_new_slot(uint64_t hash, kv_t&& kv){
+		const auto group_mask = capacity / k_group_width - 1;
+		auto group = (hash >> 7) & group_mask;
+		for(uint64_t step = 1 ; ; step++){
+			const auto m = match_free(ctrl + group * k_group_width);
+			if(m != 0){
+				const auto pos = group * k_group_width + __builtin_ctz(m);
+				if(ctrl[pos] == k_tombstone){
+					tombstone_count--;
+				}
+				ctrl[pos] = static_cast<int8_t>(hash & 0x7f);
+				new (&get_slots()[pos]) slot_t { hash, std::move(kv) };
+				return;
+			}
+			group = (group + step) & group_mask;
+		}
+	}
+
+	void allocate(uint64_t new_capacity){
+		QUARK_ASSERT(new_capacity % k_group_width == 0);
+
+		ctrl = static_cast<int8_t*>(::operator new(new_capacity + new_capacity * sizeof(slot_t)));
+		capacity = new_capacity;
+		tombstone_count = 0;
+		std::memset(ctrl, k_empty, new_capacity);
+	}
+
+	//	Moves all entries into a new allocation of new_capacity slots. Drops all tombstones.
+	void rehash(uint64_t new_capacity){
+		QUARK_ASSERT(calc_max_load(new_capacity) > count);
+
+		const auto old_ctrl = ctrl;
+		const auto old_capacity = capacity;
+		const auto old_slots = get_slots();
+
+		allocate(new_capacity);
+		for(uint64_t pos = 0 ; pos < old_capacity ; pos++){
+			if(old_ctrl[pos] >= 0){
+				insert_new_slot(old_slots[pos].hash, std::move(old_slots[pos].kv));
+				old_slots[pos].~slot_t();
+			}
+		}
+		::operator delete(old_ctrl);
+	}
+
+	//	Keeps the layout of other, tombstones included, so no probing is needed.
+	void copy_from(const quadratic_probing_hash_table_t& other){
+		QUARK_ASSERT(ctrl == nullptr);
+
+		if(other.capacity > 0){
+			allocate(other.capacity);
+			std::memcpy(ctrl, other.ctrl, capacity);
+			const auto source_slots = other.get_slots();
+			for(uint64_t pos = 0 ; pos < capacity ; pos++){
+				if(ctrl[pos] >= 0){
+					new (&get_slots()[pos]) slot_t(source_slots[pos]);
+				}
+			}
+			count = other.count;
+			tombstone_count = other.tombstone_count;
+		}
+	}
+
+	void destroy(){
+		if(ctrl != nullptr){
+			for(uint64_t pos = 0 ; pos < capacity ; pos++){
+				if(ctrl[pos] >= 0){
+					get_slots()[pos].~slot_t();
+				}
+			}
+			::operator delete(ctrl);
+		}
+		ctrl = nullptr;
+		capacity = 0;
+		count = 0;
+		tombstone_count = 0;
+	}
+
 
 	////////////////////////////////		STATE
 
-	std::vector<std::pair<mode, kv_t>> backstore;
+	//	capacity control bytes, followed by capacity slots. One allocation.
+	int8_t* ctrl;
+	uint64_t capacity;
+	uint64_t count;
+	uint64_t tombstone_count;
 };
 
 
@@ -0,0 +1,608 @@
+//
+//  task_scheduler.cpp
+//  floyd
+//
+//  Created by Marcus Zetterquist on 2026-10-18.
+//  Copyright © 2026 Marcus Zetterquist. All rights reserved.
+//
+
+#include "task_scheduler.h"
+
+#include "hardware_caps.h"
+
+#include <algorithm>
+#include <chrono>
+
+
+namespace floyd {
+
+
+static const bool k_trace_task_scheduler = false;
+
+//	wait_for_task_group() yields this many times, waiting for tasks running on other threads, before it sleeps.
+static const int k_wait_spin_count = 64;
+
+
+//	Which worker of which scheduler the current thread is. -1 = not a worker thread.
+static thread_local const task_scheduler_t* tl_scheduler = nullptr;
+static thread_local int tl_worker_index = -1;
+
+
+
+static void execute_task(task_rec_t& rec){
+	QUARK_ASSERT(rec.group != nullptr);
+
+	auto& group = *rec.group;
+	try {
+		rec.f();
+	}
+	catch(...){
+		std::lock_guard<std::mutex> guard(group.exception_mutex);
+		if(!group.exception){
+			group.exception = std::current_exception();
+		}
+	}
+
+	//	Release the task's resources before signaling the group: the waiting thread may destroy captured state.
+	rec.f = nullptr;
+
+	std::lock_guard<std::mutex> guard(group.done_mutex);
+	if(std::atomic_fetch_sub_explicit(&group.pending_count, int64_t(1), std::memory_order_acq_rel) == 1){
+		group.done_condition.notify_all();
+	}
+}
+
+//	Pops from the back of our own deque, else steals from the front of the other deques.
+static bool try_pop_task(task_scheduler_t& scheduler, task_rec_t& out){
+	const auto deque_count = static_cast<int>(scheduler.deques.size());
+	if(deque_count == 0){
+		return false;
+	}
+
+	const int own_index = tl_scheduler == &scheduler ? tl_worker_index : -1;
+	if(own_index >= 0){
+		auto& d = *scheduler.deques[own_index];
+		std::lock_guard<std::mutex> guard(d.mutex);
+		if(d.tasks.empty() == false){
+			out = std::move(d.tasks.back());
+			d.tasks.pop_back();
+			scheduler.queued_count--;
+			return true;
+		}
+	}
+
+	const int start = own_index >= 0 ? own_index + 1 : 0;
+	for(int i = 0 ; i < deque_count ; i++){
+		const auto victim_index = (start + i) % deque_count;
+		if(victim_index == own_index){
+			continue;
+		}
+		auto& d = *scheduler.deques[victim_index];
+		std::lock_guard<std::mutex> guard(d.mutex);
+		if(d.tasks.empty() == false){
+			out = std::move(d.tasks.front());
+			d.tasks.pop_front();
+			scheduler.queued_count--;
+			return true;
+		}
+	}
+	return false;
+}
+
+static void worker_thread_main(task_scheduler_t* scheduler, int worker_index){
+	tl_scheduler = scheduler;
+	tl_worker_index = worker_index;
+
+	if(k_trace_task_scheduler){
+		QUARK_TRACE_SS("task worker " << worker_index << " started");
+	}
+
+	while(scheduler->stop_flag == false){
+		task_rec_t rec;
+		if(try_pop_task(*scheduler, rec)){
+			execute_task(rec);
+		}
+		else{
+			std::unique_lock<std::mutex> lk(scheduler->sleep_mutex);
+			scheduler->sleep_condition.wait(lk, [&]{ return scheduler->stop_flag || scheduler->queued_count > 0; });
+		}
+	}
+}
+
+
+
+////////////////////////////////		task_scheduler_t
+
+
+
+task_scheduler_t::task_scheduler_t(int worker_count) :
+	stop_flag(false),
+	queued_count(0),
+	next_deque(0)
+{
+	QUARK_ASSERT(worker_count >= 0);
+
+	for(int i = 0 ; i < worker_count ; i++){
+		deques.push_back(std::make_unique<work_deque_t>());
+	}
+	for(int i = 0 ; i < worker_count ; i++){
+		workers.push_back(std::thread(worker_thread_main, this, i));
+	}
+
+	QUARK_ASSERT(check_invariant());
+}
+
+task_scheduler_t::~task_scheduler_t(){
+	QUARK_ASSERT(check_invariant());
+
+	{
+		std::lock_guard<std::mutex> guard(sleep_mutex);
+		stop_flag = true;
+	}
+	sleep_condition.notify_all();
+
+	for(auto& t: workers){
+		t.join();
+	}
+}
+
+bool task_scheduler_t::check_invariant() const {
+	QUARK_ASSERT(deques.size() == workers.size());
+	return true;
+}
+
+
+int get_hardware_worker_count(){
+	const auto caps = read_hardware_caps();
+
+	//	Not all platforms fill in all fields.
+	const int64_t candidates[] = {
+		caps._hw_logical_processor_count,
+		caps._hw_physical_processor_count,
+		static_cast<int32_t>(caps._hw_ncpu),
+		std::thread::hardware_concurrency()
+	};
+	for(const auto e: candidates){
+		if(e > 0 && e < 4096){
+			return static_cast<int>(e);
+		}
+	}
+	return 1;
+}
+
+task_scheduler_t& get_default_task_scheduler(){
+	//	The thread waiting for a task group also executes tasks, so we need one worker less than there are CPUs.
+	static task_scheduler_t scheduler(std::max(get_hardware_worker_count() - 1, 1));
+	return scheduler;
+}
+
+
+void post_task(task_scheduler_t& scheduler, task_group_t& group, const std::function<void()>& f){
+	QUARK_ASSERT(scheduler.check_invariant());
+	QUARK_ASSERT(group.check_invariant());
+
+	group.pending_count++;
+
+	//	No workers: run it right away.
+	if(scheduler.deques.empty()){
+		auto rec = task_rec_t{ &group, f };
+		execute_task(rec);
+		return;
+	}
+
+	const auto deque_index = (tl_scheduler == &scheduler && tl_worker_index >= 0)
+		? tl_worker_index
+		: static_cast<int>(scheduler.next_deque++ % scheduler.deques.size());
+	{
+		auto& d = *scheduler.deques[deque_index];
+		std::lock_guard<std::mutex> guard(d.mutex);
+		d.tasks.push_back(task_rec_t{ &group, f });
+		scheduler.queued_count++;
+	}
+
+	//	Take the sleep mutex so a worker cannot miss the notification between checking queued_count and sleeping.
+	{
+		std::lock_guard<std::mutex> guard(scheduler.sleep_mutex);
+	}
+	scheduler.sleep_condition.notify_one();
+
+	//	Same for the threads sleeping in wait_for_task_group().
+	std::lock_guard<std::mutex> guard(scheduler.sleeping_groups_mutex);
+	for(const auto sleeping_group: scheduler.sleeping_groups){
+		{
+			std::lock_guard<std::mutex> done_guard(sleeping_group->done_mutex);
+		}
+		sleeping_group->done_condition.notify_all();
+	}
+}
+
+//	Sleeps until group is done or there is a task to help with.
+static void sleep_on_task_group(task_scheduler_t& scheduler, task_group_t& group){
+	{
+		std::lock_guard<std::mutex> guard(scheduler.sleeping_groups_mutex);
+		scheduler.sleeping_groups.push_back(&group);
+	}
+	{
+		std::unique_lock<std::mutex> lk(group.done_mutex);
+		group.done_condition.wait(lk, [&]{ return group.pending_count == 0 || scheduler.queued_count > 0; });
+	}
+	{
+		std::lock_guard<std::mutex> guard(scheduler.sleeping_groups_mutex);
+		scheduler.sleeping_groups.erase(std::find(scheduler.sleeping_groups.begin(), scheduler.sleeping_groups.end(), &group));
+	}
+}
+
+void wait_for_task_group(task_scheduler_t& scheduler, task_group_t& group){
+	QUARK_ASSERT(scheduler.check_invariant());
+
+	int idle_count = 0;
+	while(std::atomic_load_explicit(&group.pending_count, std::memory_order_acquire) > 0){
+		task_rec_t rec;
+		if(try_pop_task(scheduler, rec)){
+			execute_task(rec);
+			idle_count = 0;
+		}
+		else if(idle_count < k_wait_spin_count){
+			//	Our remaining tasks are executing on other threads.
+			std::this_thread::yield();
+			idle_count++;
+		}
+		else{
+			sleep_on_task_group(scheduler, group);
+			idle_count = 0;
+		}
+	}
+
+	//	The thread that finished the last task may still hold done_mutex.
+	{
+		std::lock_guard<std::mutex> guard(group.done_mutex);
+	}
+
+	if(group.exception){
+		std::rethrow_exception(group.exception);
+	}
+}
+
+void parallel_for(task_scheduler_t& scheduler, size_t count, size_t chunk_size, const std::function<void(size_t start, size_t end)>& f){
+	QUARK_ASSERT(scheduler.check_invariant());
+	QUARK_ASSERT(chunk_size > 0);
+
+	if(count == 0){
+		return;
+	}
+	if(count <= chunk_size || scheduler.deques.empty()){
+		f(0, count);
+		return;
+	}
+
+	task_group_t group;
+	for(size_t start = 0 ; start < count ; start += chunk_size){
+		const auto end = std::min(start + chunk_size, count);
+		post_task(scheduler, group, [&f, start, end](){ f(start, end); });
+	}
+	wait_for_task_group(scheduler, group);
+}
+
+
+
+
+////////////////////////////////		dag_schedule_t
+
+
+
+dag_schedule_t make_dag_schedule(const std::vector<int64_t>& parents){
+	const auto count = static_cast<int64_t>(parents.size());
+
+	std::vector<int64_t> child_offsets(count + 1, 0);
+	for(const auto parent: parents){
+		if(parent < -1 || parent >= count){
+			quark::throw_runtime_error("map_dag() parent index out of range.");
+		}
+		if(parent != -1){
+			child_offsets[parent + 1]++;
+		}
+	}
+	for(int64_t i = 0 ; i < count ; i++){
+		child_offsets[i + 1] += child_offsets[i];
+	}
+
+	//	Visiting nodes in index order keeps each node's children in index order.
+	std::vector<int64_t> children(child_offsets[count]);
+	std::vector<int64_t> fill_pos(child_offsets.begin(), child_offsets.end() - 1);
+	for(int64_t i = 0 ; i < count ; i++){
+		const auto parent = parents[i];
+		if(parent != -1){
+			children[fill_pos[parent]++] = i;
+		}
+	}
+
+	const auto result = dag_schedule_t{ parents, child_offsets, children };
+	QUARK_ASSERT(result.check_invariant());
+	return result;
+}
+
+static void run_dag_schedule_serial(const dag_schedule_t& dag, const std::function<void(int64_t node)>& process_node){
+	const auto count = static_cast<int64_t>(dag.parents.size());
+
+	std::vector<int64_t> pending(count);
+	std::deque<int64_t> ready;
+	for(int64_t i = 0 ; i < count ; i++){
+		pending[i] = dag.child_offsets[i + 1] - dag.child_offsets[i];
+		if(pending[i] == 0){
+			ready.push_back(i);
+		}
+	}
+
+	int64_t done_count = 0;
+	while(ready.empty() == false){
+		const auto node = ready.front();
+		ready.pop_front();
+
+		process_node(node);
+		done_count++;
+
+		const auto parent = dag.parents[node];
+		if(parent != -1 && --pending[parent] == 0){
+			ready.push_back(parent);
+		}
+	}
+
+	if(done_count != count){
+		quark::throw_runtime_error("map_dag() dependency cycle error.");
+	}
+}
+
+void run_dag_schedule(task_scheduler_t* scheduler, const dag_schedule_t& dag, const std::function<void(int64_t node)>& process_node){
+	QUARK_ASSERT(dag.check_invariant());
+
+	if(scheduler == nullptr || scheduler->workers.empty()){
+		run_dag_schedule_serial(dag, process_node);
+		return;
+	}
+
+	const auto count = static_cast<int64_t>(dag.parents.size());
+	std::unique_ptr<std::atomic<int64_t>[]> pending(new std::atomic<int64_t>[count]);
+	for(int64_t i = 0 ; i < count ; i++){
+		pending[i] = dag.child_offsets[i + 1] - dag.child_offsets[i];
+	}
+	std::atomic<int64_t> done_count(0);
+
+	task_group_t group;
+
+	//	Runs a node and then, on the same thread, each parent it was the last child of. No queueing for chains.
+	std::function<void(int64_t)> run_chain = [&](int64_t node){
+		while(node != -1){
+			process_node(node);
+			done_count++;
+
+			const auto parent = dag.parents[node];
+			node = (parent != -1 && --pending[parent] == 0) ? parent : -1;
+		}
+	};
+
+	for(int64_t i = 0 ; i < count ; i++){
+		if(dag.child_offsets[i + 1] == dag.child_offsets[i]){
+			post_task(*scheduler, group, [&run_chain, i](){ run_chain(i); });
+		}
+	}
+	wait_for_task_group(*scheduler, group);
+
+	if(done_count != count){
+		quark::throw_runtime_error("map_dag() dependency cycle error.");
+	}
+}
+
+
+
+QUARK_TEST("task_scheduler_t", "parallel_for()", "", ""){
+	task_scheduler_t scheduler(3);
+
+	std::vector<int64_t> result(10000, 0);
+	parallel_for(scheduler, result.size(), 64, [&](size_t start, size_t end){
+		for(auto i = start ; i < end ; i++){
+			result[i] = static_cast<int64_t>(i) * 2;
+		}
+	});
+	for(size_t i = 0 ; i < result.size() ; i++){
+		QUARK_VERIFY(result[i] == static_cast<int64_t>(i) * 2);
+	}
+}
+
+QUARK_TEST("task_scheduler_t", "parallel_for()", "No worker threads", "Runs on calling thread"){
+	task_scheduler_t scheduler(0);
+
+	std::vector<int64_t> result(1000, 0);
+	parallel_for(scheduler, result.size(), 10, [&](size_t start, size_t end){
+		for(auto i = start ; i < end ; i++){
+			result[i] = 7;
+		}
+	});
+	QUARK_VERIFY(std::count(result.begin(), result.end(), 7) == 1000);
+}
+
+QUARK_TEST("task_scheduler_t", "parallel_for()", "Nested parallel_for()", "No deadlock"){
+	task_scheduler_t scheduler(2);
+
+	std::atomic<int64_t> sum(0);
+	parallel_for(scheduler, 16, 1, [&](size_t start, size_t end){
+		parallel_for(scheduler, 100, 10, [&](size_t start2, size_t end2){
+			sum += static_cast<int64_t>(end2 - start2);
+		});
+	});
+	QUARK_VERIFY(sum == 1600);
+}
+
+QUARK_TEST("task_scheduler_t", "wait_for_task_group()", "Task throws", "Exception is rethrown"){
+	task_scheduler_t scheduler(2);
+
+	bool caught = false;
+	try {
+		parallel_for(scheduler, 100, 10, [&](size_t start, size_t end){
+			if(start == 50){
+				quark::throw_runtime_error("task failed");
+			}
+		});
+	}
+	catch(const std::runtime_error& e){
+		caught = true;
+	}
+	QUARK_VERIFY(caught);
+}
+
+static bool is_sleeping_on(task_scheduler_t& scheduler, const task_group_t& group){
+	std::lock_guard<std::mutex> guard(scheduler.sleeping_groups_mutex);
+	return std::find(scheduler.sleeping_groups.begin(), scheduler.sleeping_groups.end(), &group) != scheduler.sleeping_groups.end();
+}
+
+QUARK_TEST("task_scheduler_t", "wait_for_task_group()", "Long task on a worker", "Waiting thread sleeps, wakes when the group is done"){
+	task_scheduler_t scheduler(1);
+	task_group_t group;
+
+	std::atomic<bool> started(false);
+	std::atomic<bool> saw_sleeping(false);
+	post_task(scheduler, group, [&](){
+		started = true;
+		for(int i = 0 ; i < 5000 && saw_sleeping == false ; i++){
+			saw_sleeping = is_sleeping_on(scheduler, group);
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	});
+	while(started == false){
+		std::this_thread::yield();
+	}
+
+	wait_for_task_group(scheduler, group);
+	QUARK_VERIFY(saw_sleeping);
+	QUARK_VERIFY(scheduler.sleeping_groups.empty());
+}
+
+QUARK_TEST("task_scheduler_t", "wait_for_task_group()", "Task posted while the waiting thread sleeps", "Waiting thread wakes and runs it"){
+	task_scheduler_t scheduler(1);
+	task_group_t group;
+
+	std::atomic<bool> started(false);
+	std::atomic<bool> second_done(false);
+	std::thread::id second_thread_id;
+	post_task(scheduler, group, [&](){
+		started = true;
+		while(is_sleeping_on(scheduler, group) == false){
+			std::this_thread::yield();
+		}
+
+		//	The only worker is busy with us, so only the waiting thread can run this task.
+		post_task(scheduler, group, [&](){
+			second_thread_id = std::this_thread::get_id();
+			second_done = true;
+		});
+		while(second_done == false){
+			std::this_thread::yield();
+		}
+	});
+	while(started == false){
+		std::this_thread::yield();
+	}
+
+	wait_for_task_group(scheduler, group);
+	QUARK_VERIFY(second_thread_id == std::this_thread::get_id());
+}
+
+
+QUARK_TEST("task_scheduler_t", "parallel_stable_sort()", "Serial", "Sorted and stable"){
+	//	Sort on key only, the index tells if equal keys kept their order.
+	std::vector<std::pair<int, int>> a;
+	for(int i = 0 ; i < 1000 ; i++){
+		a.push_back({ (i * 7919) % 13, i });
+	}
+	parallel_stable_sort(nullptr, a.data(), a.size(), [](const std::pair<int, int>& l, const std::pair<int, int>& r){ return l.first < r.first; });
+
+	for(size_t i = 1 ; i < a.size() ; i++){
+		QUARK_VERIFY(a[i - 1].first < a[i].first || (a[i - 1].first == a[i].first && a[i - 1].second < a[i].second));
+	}
+}
+
+QUARK_TEST("task_scheduler_t", "parallel_stable_sort()", "Parallel, uneven chunks", "Sorted and stable"){
+	task_scheduler_t scheduler(3);
+
+	std::vector<std::pair<int, int>> a;
+	for(int i = 0 ; i < 100003 ; i++){
+		a.push_back({ (i * 7919) % 101, i });
+	}
+	parallel_stable_sort(&scheduler, a.data(), a.size(), [](const std::pair<int, int>& l, const std::pair<int, int>& r){ return l.first < r.first; });
+
+	for(size_t i = 1 ; i < a.size() ; i++){
+		QUARK_VERIFY(a[i - 1].first < a[i].first || (a[i - 1].first == a[i].first && a[i - 1].second < a[i].second));
+	}
+}
+
+
+
+QUARK_TEST("dag_schedule_t", "make_dag_schedule()", "", ""){
+	const auto dag = make_dag_schedule({ 2, 2, -1, 0 });
+	QUARK_VERIFY((dag.child_offsets == std::vector<int64_t>{ 0, 1, 1, 3, 3 }));
+	QUARK_VERIFY((dag.children == std::vector<int64_t>{ 3, 0, 1 }));
+}
+
+QUARK_TEST("dag_schedule_t", "make_dag_schedule()", "Bad parent index", "Throws"){
+	bool caught = false;
+	try {
+		make_dag_schedule({ 1, 5 });
+	}
+	catch(const std::runtime_error& e){
+		caught = true;
+	}
+	QUARK_VERIFY(caught);
+}
+
+static void verify_dag_order(task_scheduler_t* scheduler){
+	//	A wide tree: node 0 is the root, nodes 1..100 feed node 0 and nodes 101..1100 feed nodes 1..100.
+	std::vector<int64_t> parents = { -1 };
+	for(int64_t i = 1 ; i <= 100 ; i++){
+		parents.push_back(0);
+	}
+	for(int64_t i = 0 ; i < 1000 ; i++){
+		parents.push_back(1 + (i % 100));
+	}
+	const auto dag = make_dag_schedule(parents);
+
+	std::vector<std::atomic<int64_t>> done(parents.size());
+	std::atomic<int64_t> order_errors(0);
+	run_dag_schedule(scheduler, dag, [&](int64_t node){
+		for(auto c = dag.child_offsets[node] ; c < dag.child_offsets[node + 1] ; c++){
+			if(done[dag.children[c]] == 0){
+				order_errors++;
+			}
+		}
+		done[node]++;
+	});
+
+	QUARK_VERIFY(order_errors == 0);
+	for(const auto& e: done){
+		QUARK_VERIFY(e == 1);
+	}
+}
+
+QUARK_TEST("dag_schedule_t", "run_dag_schedule()", "Serial", "Children before parents"){
+	verify_dag_order(nullptr);
+}
+
+QUARK_TEST("dag_schedule_t", "run_dag_schedule()", "Parallel", "Children before parents"){
+	task_scheduler_t scheduler(3);
+	verify_dag_order(&scheduler);
+}
+
+QUARK_TEST("dag_schedule_t", "run_dag_schedule()", "Cycle", "Throws"){
+	task_scheduler_t scheduler(2);
+	const auto dag = make_dag_schedule({ -1, 2, 1 });
+
+	bool caught = false;
+	try {
+		run_dag_schedule(&scheduler, dag, [&](int64_t node){});
+	}
+	catch(const std::runtime_error& e){
+		caught = true;
+	}
+	QUARK_VERIFY(caught);
+}
+
+
+}	// floyd
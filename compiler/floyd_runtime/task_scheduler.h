@@ -0,0 +1,253 @@
+//
+//  task_scheduler.h
+//  floyd
+//
+//  Created by Marcus Zetterquist on 2026-10-18.
+//  Copyright © 2026 Marcus Zetterquist. All rights reserved.
+//
+
+#ifndef task_scheduler_hpp
+#define task_scheduler_hpp
+
+/*
+	A runtime-wide thread team that executes tasks generated by map() and similar features.
+
+	- One worker thread per logical CPU. Each worker has its own deque of tasks.
+	- A worker pops tasks from the back of its own deque (LIFO = cache-warm) and steals from the front of
+		other workers' deques when it runs dry (FIFO = the biggest, oldest work items).
+	- The thread waiting for a task group helps executing tasks instead of blocking. This makes it safe
+		to post tasks from within a task, for example a map() nested inside a map() function. When there
+		is nothing to help with, it spins briefly, then sleeps until the group is done or a task is posted.
+
+	Tasks should ideally take 0.5 - 100 ms to execute, see manual "About parallelism".
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "quark.h"
+
+
+namespace floyd {
+
+
+
+////////////////////////////////		task_group_t
+
+
+/*
+	Tracks a batch of tasks. Use wait_for_task_group() to block until all of them have executed.
+	If a task throws, the first exception is captured and rethrown by wait_for_task_group().
+	pending_count is only decremented with done_mutex held, so a waiter that has taken done_mutex after
+	seeing 0 knows no thread touches the group anymore.
+*/
+struct task_group_t {
+	task_group_t() :
+		pending_count(0)
+	{
+	}
+
+	bool check_invariant() const {
+		QUARK_ASSERT(pending_count >= 0);
+		return true;
+	}
+
+
+	////////////////////////////////		STATE
+
+	std::atomic<int64_t> pending_count;
+
+	std::mutex done_mutex;
+	std::condition_variable done_condition;
+
+	std::mutex exception_mutex;
+	std::exception_ptr exception;
+};
+
+
+
+////////////////////////////////		task_scheduler_t
+
+
+struct task_rec_t {
+	task_group_t* group;
+	std::function<void()> f;
+};
+
+struct work_deque_t {
+	std::mutex mutex;
+	std::deque<task_rec_t> tasks;
+};
+
+struct task_scheduler_t {
+	//	worker_count = 0 makes a scheduler without threads: everything runs on the waiting thread.
+	task_scheduler_t(int worker_count);
+	~task_scheduler_t();
+	bool check_invariant() const;
+
+
+	////////////////////////////////		STATE
+
+	std::vector<std::unique_ptr<work_deque_t>> deques;
+	std::vector<std::thread> workers;
+
+	std::atomic<bool> stop_flag;
+
+	//	Number of tasks sitting in any deque. Workers sleep when this is 0.
+	std::atomic<int64_t> queued_count;
+	std::mutex sleep_mutex;
+	std::condition_variable sleep_condition;
+
+	//	Round-robin target for tasks posted from threads that are not workers.
+	std::atomic<uint32_t> next_deque;
+
+	//	Groups whose waiting thread sleeps in wait_for_task_group(). post_task() wakes them so they can help.
+	std::mutex sleeping_groups_mutex;
+	std::vector<task_group_t*> sleeping_groups;
+};
+
+
+//	Returns the number of threads to use, from hardware caps. Always >= 1.
+int get_hardware_worker_count();
+
+//	The runtime-wide scheduler, created on first use and sized from the hardware caps.
+task_scheduler_t& get_default_task_scheduler();
+
+//	Queue one task. It will execute on some worker or on the thread calling wait_for_task_group().
+void post_task(task_scheduler_t& scheduler, task_group_t& group, const std::function<void()>& f);
+
+//	Executes queued tasks until all tasks in group are done. Rethrows the first exception from the group.
+void wait_for_task_group(task_scheduler_t& scheduler, task_group_t& group);
+
+//	Splits [0, count) into ranges of chunk_size elements, runs f(start, end) for each range and
+//	returns when all ranges are done. The ranges run in any order and in parallel.
+void parallel_for(task_scheduler_t& scheduler, size_t count, size_t chunk_size, const std::function<void(size_t start, size_t end)>& f);
+
+
+
+////////////////////////////////		parallel_stable_sort()
+
+
+//	Inputs smaller than this are sorted on the calling thread.
+const size_t k_parallel_sort_min_count = 8192;
+
+//	Merges of sorted runs are split into pieces of about this many elements.
+const size_t k_parallel_merge_piece_count = 4096;
+
+/*
+	Stable merge of the sorted runs src[lo, mid) and src[mid, hi) into dest[lo, hi).
+	The output is split into pieces that are merged as separate tasks: each split point in the left run is
+	binary searched in the right run using lower_bound(), so equal elements from the left run still come first.
+*/
+template <typename T, typename LESS>
+void parallel_merge_runs(task_scheduler_t& scheduler, task_group_t& group, const T* src, T* dest, size_t lo, size_t mid, size_t hi, const LESS& less){
+	if(lo == mid || mid == hi){
+		std::copy(src + lo, src + hi, dest + lo);
+		return;
+	}
+
+	const auto left_count = mid - lo;
+	const auto piece_count = std::max<size_t>((hi - lo) / k_parallel_merge_piece_count, 1);
+
+	size_t prev_i = lo;
+	size_t prev_j = mid;
+	for(size_t piece = 1 ; piece <= piece_count ; piece++){
+		const auto i = piece == piece_count ? mid : lo + piece * left_count / piece_count;
+		const auto j = piece == piece_count ? hi : static_cast<size_t>(std::lower_bound(src + prev_j, src + hi, src[i], less) - src);
+
+		const auto dest_pos = lo + (prev_i - lo) + (prev_j - mid);
+		post_task(scheduler, group, [=, &less](){
+			std::merge(src + prev_i, src + i, src + prev_j, src + j, dest + dest_pos, less);
+		});
+		prev_i = i;
+		prev_j = j;
+	}
+}
+
+/*
+	Stable sort of data[0, count) using less(a, b). Sorts equal-sized chunks in parallel, then merges pairs
+	of runs level by level, each merge also split into parallel pieces. Uses one temporary buffer of count elements.
+	Pass nullptr as scheduler to sort on the calling thread, this is then std::stable_sort().
+*/
+template <typename T, typename LESS>
+void parallel_stable_sort(task_scheduler_t* scheduler, T* data, size_t count, const LESS& less){
+	if(scheduler == nullptr || scheduler->workers.empty() || count < k_parallel_sort_min_count){
+		std::stable_sort(data, data + count, less);
+		return;
+	}
+
+	//	A power of two number of chunks gives a balanced merge tree.
+	const auto thread_count = scheduler->workers.size() + 1;
+	size_t chunk_count = 1;
+	while(chunk_count < thread_count * 2 && count / (chunk_count * 2) >= k_parallel_merge_piece_count){
+		chunk_count *= 2;
+	}
+	const auto chunk_size = (count + chunk_count - 1) / chunk_count;
+
+	parallel_for(*scheduler, count, chunk_size, [&](size_t start, size_t end){
+		std::stable_sort(data + start, data + end, less);
+	});
+
+	std::vector<T> temp(count);
+	T* src = data;
+	T* dest = temp.data();
+	for(size_t width = chunk_size ; width < count ; width *= 2){
+		task_group_t group;
+		for(size_t lo = 0 ; lo < count ; lo += width * 2){
+			const auto mid = std::min(lo + width, count);
+			const auto hi = std::min(lo + width * 2, count);
+			parallel_merge_runs(*scheduler, group, static_cast<const T*>(src), dest, lo, mid, hi, less);
+		}
+		wait_for_task_group(*scheduler, group);
+		std::swap(src, dest);
+	}
+
+	if(src != data){
+		std::copy(src, src + count, data);
+	}
+}
+
+
+
+////////////////////////////////		dag_schedule_t
+
+
+/*
+	The dependency graph used by map_dag(). parents[i] is the node that node i is an input to, or -1.
+	A node is ready to run when all its children (its inputs) are done.
+
+	Children are stored once, in index order, using offsets into one flat vector:
+	the children of node i are children[child_offsets[i]] ..< children[child_offsets[i + 1]].
+*/
+struct dag_schedule_t {
+	bool check_invariant() const {
+		QUARK_ASSERT(child_offsets.size() == parents.size() + 1);
+		QUARK_ASSERT(children.size() <= parents.size());
+		return true;
+	}
+
+	std::vector<int64_t> parents;
+	std::vector<int64_t> child_offsets;
+	std::vector<int64_t> children;
+};
+
+//	Throws if a parent index is out of range. O(n).
+dag_schedule_t make_dag_schedule(const std::vector<int64_t>& parents);
+
+//	Calls process_node(node) once for every node, after process_node() has returned for all the node's children.
+//	Independent nodes run in parallel on scheduler. Pass nullptr to run everything on the calling thread.
+//	Throws if the graph has a cycle. O(n + e).
+void run_dag_schedule(task_scheduler_t* scheduler, const dag_schedule_t& dag, const std::function<void(int64_t node)>& process_node);
+
+
+}	// floyd
+
+#endif /* task_scheduler_hpp */
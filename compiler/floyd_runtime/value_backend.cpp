@@ -132,6 +132,10 @@ heap_alloc_64_t* alloc_64(heap_t& heap, uint64_t allocation_word_count, type_t d
 	QUARK_ASSERT(heap.check_invariant());
 	QUARK_ASSERT(debug_string != nullptr);
 
+	if(heap.redirect_arena != nullptr){
+		return alloc_64(*heap.redirect_arena, allocation_word_count, debug_value_type, debug_string);
+	}
+
 	const auto header_size = sizeof(heap_alloc_64_t);
 	QUARK_ASSERT((header_size % 8) == 0);
 
@@ -139,11 +143,8 @@ heap_alloc_64_t* alloc_64(heap_t& heap, uint64_t allocation_word_count, type_t d
 	std::lock_guard<std::recursive_mutex> guard(*heap.alloc_records_mutex);
 #endif
 
-	const auto malloc_size = header_size + allocation_word_count * sizeof(uint64_t);
-	void* alloc0 = std::malloc(malloc_size);
-	if(alloc0 == nullptr){
-		throw std::exception();
-	}
+	const auto byte_count = header_size + allocation_word_count * sizeof(uint64_t);
+	void* alloc0 = heap.mode == heap_mode::arena ? arena_alloc(*heap.arena, byte_count) : pool_alloc(byte_count);
 
 	auto alloc = new (alloc0) heap_alloc_64_t(&heap, allocation_word_count, debug_value_type, debug_string);
 	QUARK_ASSERT(alloc->rc == 1);
@@ -199,6 +200,36 @@ QUARK_TEST("heap_t", "release_ref()", "", ""){
 	QUARK_VERIFY(count == 0);
 }
 
+QUARK_TEST("heap_t", "alloc_64()", "Pool", "Released memory is reused"){
+	heap_t heap(false);
+	auto a = alloc_64(heap, 3, make_undefined(), "test");
+	release_ref(*a);
+
+	auto b = alloc_64(heap, 3, make_undefined(), "test");
+	QUARK_VERIFY(b == a);
+	QUARK_VERIFY(b->rc == 1);
+	release_ref(*b);
+}
+
+QUARK_TEST("heap_t", "reset_heap_arena()", "", ""){
+	heap_t heap(true, heap_mode::arena);
+	auto a = alloc_64(heap, 0, make_undefined(), "test");
+	auto b = alloc_64(heap, 100, make_undefined(), "test");
+	QUARK_VERIFY(b->rc == 1);
+	release_ref(*a);
+	QUARK_VERIFY(heap.count_used() == 1);
+	QUARK_VERIFY(heap.arena->alloc_count == 2);
+
+	//	b is still in use: the arena frees it anyway.
+	QUARK_VERIFY(reset_heap_arena(heap) == 0);
+	QUARK_VERIFY(heap.count_used() == 0);
+	QUARK_VERIFY(heap.arena->alloc_count == 0);
+
+	auto c = alloc_64(heap, 0, make_undefined(), "test");
+	QUARK_VERIFY(c == a);
+	release_ref(*c);
+}
+
 
 
 void* get_alloc_ptr(heap_alloc_64_t& alloc){
@@ -243,12 +274,18 @@ void dispose_alloc(heap_alloc_64_t& alloc){
 	std::lock_guard<std::recursive_mutex> guard(*alloc.heap->alloc_records_mutex);
 #endif
 
-	if(alloc.heap->record_allocs_flag){
-		auto it = std::find_if(alloc.heap->alloc_records.begin(), alloc.heap->alloc_records.end(), [&](heap_rec_t& e){ return e.alloc_ptr == &alloc; });
-		QUARK_ASSERT(it != alloc.heap->alloc_records.end());
+	auto& heap = *alloc.heap;
+	const auto byte_count = sizeof(heap_alloc_64_t) + alloc.allocation_word_count * sizeof(uint64_t);
+
+	//	The pool will hand out this memory again: forget the record so it is not counted twice.
+	if(heap.record_allocs_flag){
+		auto it = std::find_if(heap.alloc_records.begin(), heap.alloc_records.end(), [&](heap_rec_t& e){ return e.alloc_ptr == &alloc; });
+		QUARK_ASSERT(it != heap.alloc_records.end());
 
 //		QUARK_ASSERT(it->in_use);
 //		it->in_use = false;
+		*it = heap.alloc_records.back();
+		heap.alloc_records.pop_back();
 	}
 	
 	//??? we don't delete the malloc() block in debug version.
@@ -265,7 +302,63 @@ void dispose_alloc(heap_alloc_64_t& alloc){
 	alloc.debug_info = "disposed alloc";
 #endif
 
-	std::free(&alloc);
+	//	Arena memory is only freed by reset_heap_arena(). The RC stays 0 so the reset knows the alloc is disposed.
+	if(heap.mode == heap_mode::pool){
+		pool_free(&alloc, byte_count);
+	}
+}
+
+//	Call after constructing the C++ object inside an alloc, so resetting an arena can destruct it.
+static void track_arena_owner(heap_alloc_64_t& alloc, alloc_destructor_t destructor){
+	auto& heap = *alloc.heap;
+	if(heap.mode == heap_mode::arena){
+		std::lock_guard<std::mutex> guard(heap.arena->mutex);
+		heap.arena_owners.push_back(arena_owner_t { &alloc, destructor });
+	}
+}
+
+int reset_heap_arena(heap_t& heap){
+	QUARK_ASSERT(heap.check_invariant());
+	QUARK_ASSERT(heap.mode == heap_mode::arena);
+
+#if HEAP_MUTEX
+	std::lock_guard<std::recursive_mutex> guard(*heap.alloc_records_mutex);
+#endif
+
+	int destruct_count = 0;
+	{
+		std::lock_guard<std::mutex> guard2(heap.arena->mutex);
+
+		//	Disposed allocs have already destructed their object.
+		for(const auto& e: heap.arena_owners){
+			if(e.alloc->rc > 0){
+				e.destructor(*e.alloc);
+				destruct_count++;
+			}
+		}
+		heap.arena_owners.clear();
+	}
+
+	heap.alloc_records.clear();
+	reset_arena(*heap.arena);
+	return destruct_count;
+}
+
+heap_arena_scope_t::heap_arena_scope_t(heap_t& heap, heap_t& arena) :
+	heap(heap),
+	arena(arena)
+{
+	QUARK_ASSERT(heap.check_invariant());
+	QUARK_ASSERT(heap.mode == heap_mode::pool);
+	QUARK_ASSERT(heap.redirect_arena == nullptr);
+	QUARK_ASSERT(arena.mode == heap_mode::arena);
+
+	heap.redirect_arena = &arena;
+}
+
+heap_arena_scope_t::~heap_arena_scope_t(){
+	heap.redirect_arena = nullptr;
+	reset_heap_arena(arena);
 }
 
 
@@ -390,6 +483,10 @@ runtime_value_t make_runtime_dict_hamt(DICT_HAMT_T* dict_hamt_ptr){
 	return { .dict_hamt_ptr = dict_hamt_ptr };
 }
 
+runtime_value_t make_runtime_dict_hashtable(DICT_HASHTABLE_T* dict_hashtable_ptr){
+	return { .dict_hashtable_ptr = dict_hashtable_ptr };
+}
+
 
 
 
@@ -402,6 +499,13 @@ uint64_t get_vec_string_size(runtime_value_t str){
 	return str.vector_carray_ptr->get_element_count();
 }
 
+std::string_view get_vec_string_view(runtime_value_t str){
+	QUARK_ASSERT(str.vector_carray_ptr != nullptr);
+
+	const auto chars = reinterpret_cast<const char*>(str.vector_carray_ptr->get_element_ptr());
+	return std::string_view(chars, str.vector_carray_ptr->get_element_count());
+}
+
 void copy_elements(runtime_value_t dest[], runtime_value_t source[], uint64_t count){
 	for(auto i = 0 ; i < count ; i++){
 		dest[i] = source[i];
@@ -529,6 +633,10 @@ bool VECTOR_HAMT_T::check_invariant() const {
 	return true;
 }
 
+static void destruct_vector_hamt(heap_alloc_64_t& alloc){
+	reinterpret_cast<VECTOR_HAMT_T&>(alloc).get_vecref_mut().~vector<runtime_value_t>();
+}
+
 runtime_value_t alloc_vector_hamt(heap_t& heap, uint64_t allocation_count, uint64_t element_count, type_t value_type){
 	QUARK_ASSERT(heap.check_invariant());
 
@@ -536,6 +644,7 @@ runtime_value_t alloc_vector_hamt(heap_t& heap, uint64_t allocation_count, uint6
 
 	QUARK_ASSERT(sizeof(immer::vector<runtime_value_t>) <= heap_alloc_64_t::k_data_bytes);
     new (&vec->alloc.data[0]) immer::vector<runtime_value_t>(allocation_count, runtime_value_t{ .int_value = (int64_t)0xdeadbeef12345678 } );
+	track_arena_owner(vec->alloc, destruct_vector_hamt);
 
 	QUARK_ASSERT(vec->check_invariant());
 	QUARK_ASSERT(heap.check_invariant());
@@ -555,6 +664,7 @@ runtime_value_t alloc_vector_hamt(heap_t& heap, const runtime_value_t elements[]
 	QUARK_ASSERT(sizeof(immer::vector<runtime_value_t>) <= heap_alloc_64_t::k_data_bytes);
     auto vec2 = new (buffer_ptr) immer::vector<runtime_value_t>(&elements[0], &elements[element_count]);
 	QUARK_ASSERT(vec2 == buffer_ptr);
+	track_arena_owner(*alloc, destruct_vector_hamt);
 
 	QUARK_ASSERT(vec->check_invariant());
 	QUARK_ASSERT(heap.check_invariant());
@@ -590,6 +700,7 @@ runtime_value_t store_immutable(const runtime_value_t& vec0, const uint64_t inde
 
 	QUARK_ASSERT(sizeof(immer::vector<runtime_value_t>) <= heap_alloc_64_t::k_data_bytes);
     auto vec2 = new (buffer_ptr) immer::vector<runtime_value_t>();
+	track_arena_owner(*alloc, destruct_vector_hamt);
 
 	const auto& v2 = vec1.get_vecref().set(index, value);
 	*vec2 = v2;
@@ -611,6 +722,7 @@ runtime_value_t push_back_immutable(const runtime_value_t& vec0, runtime_value_t
 
 	QUARK_ASSERT(sizeof(immer::vector<runtime_value_t>) <= heap_alloc_64_t::k_data_bytes);
     auto vec2 = new (buffer_ptr) immer::vector<runtime_value_t>();
+	track_arena_owner(*alloc, destruct_vector_hamt);
 
 	const auto& v2 = vec1.get_vecref().push_back(value);
 	*vec2 = v2;
@@ -677,6 +789,10 @@ uint64_t DICT_CPPMAP_T::size() const {
 	return d.size();
 }
 
+static void destruct_dict_cppmap(heap_alloc_64_t& alloc){
+	reinterpret_cast<DICT_CPPMAP_T&>(alloc).get_map_mut().~CPPMAP();
+}
+
 runtime_value_t alloc_dict_cppmap(heap_t& heap, type_t value_type){
 	QUARK_ASSERT(heap.check_invariant());
 
@@ -687,6 +803,7 @@ runtime_value_t alloc_dict_cppmap(heap_t& heap, type_t value_type){
 
 	QUARK_ASSERT(sizeof(CPPMAP) <= heap_alloc_64_t::k_data_bytes);
     new (&m) CPPMAP();
+	track_arena_owner(*alloc, destruct_dict_cppmap);
 
 	QUARK_ASSERT(heap.check_invariant());
 	QUARK_ASSERT(dict->check_invariant());
@@ -734,6 +851,10 @@ uint64_t DICT_HAMT_T::size() const {
 	return d.size();
 }
 
+static void destruct_dict_hamt(heap_alloc_64_t& alloc){
+	reinterpret_cast<DICT_HAMT_T&>(alloc).get_map_mut().~HAMT_MAP();
+}
+
 runtime_value_t alloc_dict_hamt(heap_t& heap, type_t value_type){
 	QUARK_ASSERT(heap.check_invariant());
 
@@ -744,6 +865,7 @@ runtime_value_t alloc_dict_hamt(heap_t& heap, type_t value_type){
 
 	QUARK_ASSERT(sizeof(HAMT_MAP) <= heap_alloc_64_t::k_data_bytes);
     new (&m) HAMT_MAP();
+	track_arena_owner(*alloc, destruct_dict_hamt);
 
 	QUARK_ASSERT(heap.check_invariant());
 	QUARK_ASSERT(dict->check_invariant());
@@ -769,6 +891,132 @@ void dispose_dict_hamt(runtime_value_t& d){
 
 
 
+////////////////////////////////		DICT_HASHTABLE_T
+
+
+
+QUARK_TEST("", "", "", ""){
+	const auto size = sizeof(HASHTABLE_MAP);
+	QUARK_ASSERT(size == 32);
+}
+
+bool DICT_HASHTABLE_T::check_invariant() const{
+	QUARK_ASSERT(alloc.check_invariant());
+	QUARK_ASSERT(get_debug_info(alloc) == "hashdic");
+	QUARK_ASSERT(get_map().check_invariant());
+	return true;
+}
+
+uint64_t DICT_HASHTABLE_T::size() const {
+	QUARK_ASSERT(check_invariant());
+
+	const auto& d = get_map();
+	return d.size();
+}
+
+static void destruct_dict_hashtable(heap_alloc_64_t& alloc){
+	reinterpret_cast<DICT_HASHTABLE_T&>(alloc).get_map_mut().~HASHTABLE_MAP();
+}
+
+runtime_value_t alloc_dict_hashtable(heap_t& heap, type_t value_type){
+	QUARK_ASSERT(heap.check_invariant());
+
+	heap_alloc_64_t* alloc = alloc_64(heap, 0, value_type, "hashdic");
+	auto dict = reinterpret_cast<DICT_HASHTABLE_T*>(alloc);
+
+	auto& m = dict->get_map_mut();
+
+	QUARK_ASSERT(sizeof(HASHTABLE_MAP) <= heap_alloc_64_t::k_data_bytes);
+    new (&m) HASHTABLE_MAP();
+	track_arena_owner(*alloc, destruct_dict_hashtable);
+
+	QUARK_ASSERT(heap.check_invariant());
+	QUARK_ASSERT(dict->check_invariant());
+
+	return runtime_value_t { .dict_hashtable_ptr = dict };
+}
+
+void dispose_dict_hashtable(runtime_value_t& d){
+	QUARK_ASSERT(sizeof(DICT_HASHTABLE_T) == sizeof(heap_alloc_64_t));
+	QUARK_ASSERT(d.dict_hashtable_ptr != nullptr);
+	auto& dict = *d.dict_hashtable_ptr;
+
+	QUARK_ASSERT(dict.check_invariant());
+
+	dict.get_map_mut().~HASHTABLE_MAP();
+	auto heap = dict.alloc.heap;
+	dispose_alloc(dict.alloc);
+	QUARK_ASSERT(heap->check_invariant());
+}
+
+
+
+
+
+
+
+
+
+
+//	libstdc++'s std::map doesn't fit in an alloc's data, alloc_dict_cppmap() can't be used there.
+static runtime_value_t alloc_dict_cppmap_if_fits(heap_t& heap){
+	if(sizeof(CPPMAP) <= heap_alloc_64_t::k_data_bytes){
+		auto result = alloc_dict_cppmap(heap, type_t::make_int());
+		result.dict_cppmap_ptr->get_map_mut().insert({ "a", make_runtime_int(1) });
+		return result;
+	}
+	else{
+		return runtime_value_t { .dict_cppmap_ptr = nullptr };
+	}
+}
+
+QUARK_TEST("heap_t", "reset_heap_arena()", "Dicts and json still alive", "Destructs their C++ objects"){
+	heap_t heap(false, heap_mode::arena);
+
+	auto cppmap = alloc_dict_cppmap_if_fits(heap);
+	auto hamt = alloc_dict_hamt(heap, type_t::make_int());
+	auto hashtable = alloc_dict_hashtable(heap, type_t::make_int());
+	auto disposed = alloc_dict_hashtable(heap, type_t::make_int());
+	auto json = alloc_json(heap, json_t::make_array({ 1, 2, 3 }));
+
+	hamt.dict_hamt_ptr->get_map_mut() = hamt.dict_hamt_ptr->get_map().set("a", make_runtime_int(1));
+	hashtable.dict_hashtable_ptr->get_map_mut().insert_or_assign("a", make_runtime_int(1));
+	disposed.dict_hashtable_ptr->get_map_mut().insert_or_assign("b", make_runtime_int(2));
+
+	//	Disposing destructs the map right away, the reset must not do it again.
+	if(dec_rc(disposed.dict_hashtable_ptr->alloc) == 0){
+		dispose_dict_hashtable(disposed);
+	}
+
+	const int cppmap_count = cppmap.dict_cppmap_ptr != nullptr ? 1 : 0;
+	QUARK_VERIFY(heap.arena_owners.size() == 4 + cppmap_count);
+	QUARK_VERIFY(json->get_json().get_array_size() == 3);
+
+	QUARK_VERIFY(reset_heap_arena(heap) == 3 + cppmap_count);
+	QUARK_VERIFY(heap.arena_owners.empty());
+	QUARK_VERIFY(heap.arena->alloc_count == 0);
+}
+
+QUARK_TEST("heap_t", "heap_arena_scope_t", "", "Allocs go to the arena until the scope ends"){
+	heap_t heap(true);
+	heap_t arena(true, heap_mode::arena);
+	{
+		heap_arena_scope_t scope(heap, arena);
+		auto d = alloc_dict_hashtable(heap, type_t::make_int());
+		d.dict_hashtable_ptr->get_map_mut().insert_or_assign("a", make_runtime_int(1));
+		QUARK_VERIFY(d.dict_hashtable_ptr->alloc.heap == &arena);
+		QUARK_VERIFY(heap.count_used() == 0);
+		QUARK_VERIFY(arena.count_used() == 1);
+	}
+	QUARK_VERIFY(heap.redirect_arena == nullptr);
+	QUARK_VERIFY(arena.count_used() == 0);
+	QUARK_VERIFY(arena.arena_owners.empty());
+
+	auto a = alloc_64(heap, 0, make_undefined(), "test");
+	QUARK_VERIFY(a->heap == &heap);
+	release_ref(*a);
+}
+
 
 
 
@@ -784,6 +1032,10 @@ bool JSON_T::check_invariant() const{
 	return true;
 }
 
+static void destruct_json(heap_alloc_64_t& alloc){
+	delete &reinterpret_cast<JSON_T&>(alloc).get_json();
+}
+
 JSON_T* alloc_json(heap_t& heap, const json_t& init){
 	QUARK_ASSERT(heap.check_invariant());
 	QUARK_ASSERT(init.check_invariant());
@@ -793,6 +1045,7 @@ JSON_T* alloc_json(heap_t& heap, const json_t& init){
 	auto json = reinterpret_cast<JSON_T*>(alloc);
 	auto copy = new json_t(init);
 	json->alloc.data[0] = reinterpret_cast<uint64_t>(copy);
+	track_arena_owner(json->alloc, destruct_json);
 
 	QUARK_ASSERT(json->check_invariant());
 	QUARK_ASSERT(heap.check_invariant());
@@ -1134,6 +1387,15 @@ void retain_dict_hamt(value_backend_t& backend, runtime_value_t dict, type_t typ
 
 	inc_rc(dict.dict_hamt_ptr->alloc);
 }
+void retain_dict_hashtable(value_backend_t& backend, runtime_value_t dict, type_t type){
+	QUARK_ASSERT(backend.check_invariant());
+	QUARK_ASSERT(dict.check_invariant());
+	QUARK_ASSERT(type.check_invariant());
+	QUARK_ASSERT(is_rc_value(peek2(backend.types, type)));
+	QUARK_ASSERT(is_dict_hashtable(backend.types, backend.config, type));
+
+	inc_rc(dict.dict_hashtable_ptr->alloc);
+}
 
 void retain_struct(value_backend_t& backend, runtime_value_t s, type_t type){
 	QUARK_ASSERT(backend.check_invariant());
@@ -1167,6 +1429,9 @@ void retain_value(value_backend_t& backend, runtime_value_t value, type_t type){
 		else if(is_dict_hamt(backend.types, backend.config, type)){
 			retain_dict_hamt(backend, value, type);
 		}
+		else if(is_dict_hashtable(backend.types, backend.config, type)){
+			retain_dict_hashtable(backend, value, type);
+		}
 		else if(type_peek.is_json()){
 			inc_rc(value.json_ptr->alloc);
 		}
@@ -1225,6 +1490,26 @@ void release_dict_hamt(value_backend_t& backend, runtime_value_t dict0, type_t t
 	}
 }
 
+void release_dict_hashtable(value_backend_t& backend, runtime_value_t dict0, type_t type){
+	QUARK_ASSERT(backend.check_invariant());
+	QUARK_ASSERT(dict0.check_invariant());
+	QUARK_ASSERT(peek2(backend.types, type).is_dict());
+	QUARK_ASSERT(is_dict_hashtable(backend.types, backend.config, type));
+
+	auto& dict = *dict0.dict_hashtable_ptr;
+	if(dec_rc(dict.alloc) == 0){
+
+		//	Release all elements.
+		const auto element_type2 = lookup_dict_value_type(backend, type);
+		if(is_rc_value(peek2(backend.types, element_type2))){
+			for(const auto& e: dict.get_map()){
+				release_value(backend, e.second, element_type2);
+			}
+		}
+		dispose_dict_hashtable(dict0);
+	}
+}
+
 void release_dict(value_backend_t& backend, runtime_value_t dict, type_t type){
 	QUARK_ASSERT(backend.check_invariant());
 	QUARK_ASSERT(dict.check_invariant());
@@ -1236,6 +1521,9 @@ void release_dict(value_backend_t& backend, runtime_value_t dict, type_t type){
 	else if(is_dict_hamt(backend.types, backend.config, type)){
 		release_dict_hamt(backend, dict, type);
 	}
+	else if(is_dict_hashtable(backend.types, backend.config, type)){
+		release_dict_hashtable(backend, dict, type);
+	}
 	else{
 		QUARK_ASSERT(false);
 	}
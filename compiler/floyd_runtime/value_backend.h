@@ -25,7 +25,8 @@
 	- Controlling alignment and letting us address allocations more effectively than 64 bit pointers.
 	- Support never reusing the same allocation pointer/ID.
 
-	NOTICE: Right now each alloc is made using malloc(). In the future we can switch to private heap / arena / pooling.
+	Allocs come from pool_allocator.h: size-class pools with per-thread free lists, or an arena that is
+	reset wholesale, see heap_mode.
 */
 
 #ifndef value_backend_hpp
@@ -33,13 +34,16 @@
 
 #include "immer/vector.hpp"
 #include "immer/map.hpp"
+#include "quadratic_probing_hash_table.h"
 
 #include <atomic>
 #include <map>
+#include <memory>
 #include <mutex>
 #include "ast_value.h"
 #include "types.h"
 #include "ast.h"
+#include "pool_allocator.h"
 
 #include "quark.h"
 
@@ -72,6 +76,7 @@ struct VECTOR_CARRAY_T;
 struct VECTOR_HAMT_T;
 struct DICT_CPPMAP_T;
 struct DICT_HAMT_T;
+struct DICT_HASHTABLE_T;
 struct JSON_T;
 struct STRUCT_T;
 
@@ -106,11 +111,36 @@ struct heap_rec_t {
 
 static const uint64_t HEAP_MAGIC = 0xf00d1234;
 
+/*
+	pool: each alloc is freed when its RC goes to 0, its memory is recycled in size-class pools.
+	arena: allocs are bump allocated and never freed one by one. reset_heap_arena() frees all of them at
+		once. Use for short-lived values, like the ones made while running one benchmark, see heap_arena_scope_t.
+*/
+enum class heap_mode {
+	pool,
+	arena
+};
+
+//	Arena heaps grab memory in chunks of this size.
+static const size_t k_heap_arena_chunk_size = 256 * 1024;
+
+//	Destructs the C++ object an alloc holds, like the std::map of a DICT_CPPMAP_T. Does not release the values
+//	that object refers to.
+typedef void (*alloc_destructor_t)(heap_alloc_64_t& alloc);
+
+struct arena_owner_t {
+	heap_alloc_64_t* alloc;
+	alloc_destructor_t destructor;
+};
+
 struct heap_t {
-	heap_t(bool record_allocs_flag) :
+	heap_t(bool record_allocs_flag, heap_mode mode = heap_mode::pool) :
 		magic(0xf00d1234),
 		allocation_id_generator(1000000),
-		record_allocs_flag(record_allocs_flag)
+		record_allocs_flag(record_allocs_flag),
+		mode(mode),
+		arena(mode == heap_mode::arena ? std::make_unique<arena_t>(k_heap_arena_chunk_size) : nullptr),
+		redirect_arena(nullptr)
 	{
 #if HEAP_MUTEX
 		alloc_records_mutex = std::make_shared<std::recursive_mutex>();
@@ -128,8 +158,42 @@ struct heap_t {
 #endif
 	std::vector<heap_rec_t> alloc_records;
 
-	uint64_t allocation_id_generator;
+	//	Atomic since several threads can allocate at the same time, for example map() running in parallel.
+	std::atomic<uint64_t> allocation_id_generator;
 	bool record_allocs_flag;
+
+	heap_mode mode;
+	std::unique_ptr<arena_t> arena;
+
+	//	Arena allocs that hold C++ objects: their memory isn't enough to free them. Protected by arena->mutex.
+	std::vector<arena_owner_t> arena_owners;
+
+	//	When set, alloc_64() makes allocs in this arena heap instead. Only change it when no other thread
+	//	allocates from the heap. See heap_arena_scope_t.
+	heap_t* redirect_arena;
+};
+
+/*
+	Frees every alloc in an arena heap at once, whatever their RCs. The C++ objects of allocs still alive,
+	like a DICT_CPPMAP_T's std::map, are destructed first. No alloc from the heap may be used afterwards.
+	Returns how many C++ objects it destructed.
+*/
+int reset_heap_arena(heap_t& heap);
+
+/*
+	While in scope, new allocs from heap are made in arena. When the scope ends the arena is reset.
+	All values made in the scope must have been released or copied out by then, like when calling a
+	benchmark-def function and converting its result to value_t.
+*/
+struct heap_arena_scope_t {
+	heap_arena_scope_t(heap_t& heap, heap_t& arena);
+	~heap_arena_scope_t();
+
+	heap_arena_scope_t(const heap_arena_scope_t& other) = delete;
+	heap_arena_scope_t& operator=(const heap_arena_scope_t& other) = delete;
+
+	heap_t& heap;
+	heap_t& arena;
 };
 
 
@@ -232,7 +296,7 @@ std::string get_debug_info(const heap_alloc_64_t& alloc);
 
 
 /*
-	Allocates a block of data using malloc().
+	Allocates a block of data from the heap's pool or arena.
 
 	It consists of two parts: the header and the dynamic elements.
 
@@ -244,8 +308,6 @@ std::string get_debug_info(const heap_alloc_64_t& alloc);
 	Returned alloc has RC = 1
 	The allocation is recorded into the heap_t.
 	Only delete the block using release_ref(), never std::free() or c++ delete.
-
-	DEBUG VERSION: We never actually free the heap blocks, we keep them around for debugging.
 */
 heap_alloc_64_t* alloc_64(heap_t& heap, uint64_t allocation_word_count, type_t value_type, const char debug_string[]);
 
@@ -263,6 +325,9 @@ inline uint64_t size_to_allocation_blocks(std::size_t size);
 inline int32_t dec_rc(const heap_alloc_64_t& alloc);
 inline int32_t inc_rc(const heap_alloc_64_t& alloc);
 
+//	True if the caller holds the only reference: nobody else can observe a mutation of the alloc.
+inline bool is_rc_unique(const heap_alloc_64_t& alloc);
+
 void dispose_alloc(heap_alloc_64_t& alloc);
 
 
@@ -293,6 +358,7 @@ union runtime_value_t {
 
 	DICT_CPPMAP_T* dict_cppmap_ptr;
 	DICT_HAMT_T* dict_hamt_ptr;
+	DICT_HASHTABLE_T* dict_hashtable_ptr;
 
 	JSON_T* json_ptr;
 	STRUCT_T* struct_ptr;
@@ -315,9 +381,13 @@ runtime_value_t make_runtime_vector_carray(VECTOR_CARRAY_T* vector_ptr);
 runtime_value_t make_runtime_vector_hamt(VECTOR_HAMT_T* vector_hamt_ptr);
 runtime_value_t make_runtime_dict_cppmap(DICT_CPPMAP_T* dict_cppmap_ptr);
 runtime_value_t make_runtime_dict_hamt(DICT_HAMT_T* dict_hamt_ptr);
+runtime_value_t make_runtime_dict_hashtable(DICT_HASHTABLE_T* dict_hashtable_ptr);
 
 uint64_t get_vec_string_size(runtime_value_t str);
 
+//	Views the characters of a string without copying them.
+std::string_view get_vec_string_view(runtime_value_t str);
+
 void copy_elements(runtime_value_t dest[], runtime_value_t source[], uint64_t count);
 
 
@@ -370,11 +440,13 @@ WIDE_RETURN_T make_wide_return_2x64(runtime_value_t a, runtime_value_t b);
 /*
 	A fixed-size immutable vector with RC. Deep copy everytime = expensive to mutate.
 
-	- Mutation = copy entire vector every time.
+	- Mutation = copy entire vector every time, unless the RC is 1. Then push_back() / update() may mutate it in place.
 	- Elements are always runtime_value_t. You need to pack and address other types of data manually.
 
 	Invariant:
-		alloc_count = roundup(element_count * element_bits, 64) / 64
+		alloc_count >= roundup(element_count * element_bits, 64) / 64
+
+	The extra allocation is capacity for in-place push_back() and concatenation, see concat_inplace__string().
 
 	data[0]: element count
 */
@@ -587,6 +659,36 @@ void dispose_dict_hamt(runtime_value_t& vec);
 
 
 
+////////////////////////////////		DICT_HASHTABLE_T
+
+
+/*
+	A quadratic_probing_hash_table_t<> is stored inplace:
+	data: embeds quadratic_probing_hash_table_t<runtime_value_t>
+*/
+typedef quadratic_probing_hash_table_t<runtime_value_t> HASHTABLE_MAP;
+
+struct DICT_HASHTABLE_T {
+	bool check_invariant() const;
+	uint64_t size() const;
+
+	const HASHTABLE_MAP& get_map() const {
+		return *reinterpret_cast<const HASHTABLE_MAP*>(&alloc.data[0]);
+	}
+	HASHTABLE_MAP& get_map_mut(){
+		return *reinterpret_cast<HASHTABLE_MAP*>(&alloc.data[0]);
+	}
+
+
+	////////////////////////////////		STATE
+	heap_alloc_64_t alloc;
+};
+
+runtime_value_t alloc_dict_hashtable(heap_t& heap, type_t value_type);
+void dispose_dict_hashtable(runtime_value_t& vec);
+
+
+
 ////////////////////////////////		JSON_T
 
 
@@ -703,9 +805,8 @@ struct value_backend_t {
 	std::vector<std::pair<link_name_t, void*>> native_func_lookup;
 	std::vector<std::pair<type_t, struct_layout_t>> struct_layouts;
 
-	//	Temporary *global* constant that switches between array-based vector backened and HAMT-based vector.
+	//	Picks the vector and dict backends, either globally or per type, see get_vector_backend().
 	//	The string always uses array-based vector.
-	//	Future: make this flag a per-vector setting.
 	config_t config;
 };
 
@@ -734,6 +835,7 @@ inline void retain_vector_hamt(value_backend_t& backend, runtime_value_t vec, ty
 
 void retain_dict_cppmap(value_backend_t& backend, runtime_value_t dict, type_t type);
 void retain_dict_hamt(value_backend_t& backend, runtime_value_t dict, type_t type);
+void retain_dict_hashtable(value_backend_t& backend, runtime_value_t dict, type_t type);
 
 void retain_struct(value_backend_t& backend, runtime_value_t s, type_t type);
 
@@ -752,6 +854,7 @@ void release_vec(value_backend_t& backend, runtime_value_t vec, type_t type);
 
 void release_dict_cppmap(value_backend_t& backend, runtime_value_t dict0, type_t type);
 void release_dict_hamt(value_backend_t& backend, runtime_value_t dict0, type_t type);
+void release_dict_hashtable(value_backend_t& backend, runtime_value_t dict0, type_t type);
 void release_dict(value_backend_t& backend, runtime_value_t dict0, type_t type);
 
 
@@ -764,19 +867,51 @@ void release_struct(value_backend_t& backend, runtime_value_t s, type_t type);
 
 
 
+//	Resolves vector_backend::per_type using the type's node. Types without a recorded backend use HAMT.
+inline vector_backend get_vector_backend(const types_t& types, const config_t& config, type_t t){
+	QUARK_ASSERT(peek2(types, t).is_vector());
+
+	if(config.vector_backend_mode == vector_backend::per_type){
+		return get_collection_backend(types, t) == collection_backend::k_carray ? vector_backend::carray : vector_backend::hamt;
+	}
+	else{
+		return config.vector_backend_mode;
+	}
+}
+
+inline dict_backend get_dict_backend(const types_t& types, const config_t& config, type_t t){
+	QUARK_ASSERT(peek2(types, t).is_dict());
+
+	if(config.dict_backend_mode == dict_backend::per_type){
+		const auto backend = get_collection_backend(types, t);
+		if(backend == collection_backend::k_cppmap){
+			return dict_backend::cppmap;
+		}
+		else if(backend == collection_backend::k_hashtable){
+			return dict_backend::hashtable;
+		}
+		else{
+			return dict_backend::hamt;
+		}
+	}
+	else{
+		return config.dict_backend_mode;
+	}
+}
+
 inline bool is_vector_carray(const types_t& types, const config_t& config, type_t t){
 	QUARK_ASSERT(types.check_invariant());
 	QUARK_ASSERT(config.check_invariant());
 	QUARK_ASSERT(t.check_invariant());
 
-	return peek2(types, t).is_vector() && config.vector_backend_mode == vector_backend::carray;
+	return peek2(types, t).is_vector() && get_vector_backend(types, config, t) == vector_backend::carray;
 }
 inline bool is_vector_hamt(const types_t& types, const config_t& config, type_t t){
 	QUARK_ASSERT(types.check_invariant());
 	QUARK_ASSERT(config.check_invariant());
 	QUARK_ASSERT(t.check_invariant());
 
-	return peek2(types, t).is_vector() && config.vector_backend_mode == vector_backend::hamt;
+	return peek2(types, t).is_vector() && get_vector_backend(types, config, t) == vector_backend::hamt;
 }
 
 inline bool is_dict_cppmap(const types_t& types, const config_t& config, type_t t){
@@ -784,14 +919,21 @@ inline bool is_dict_cppmap(const types_t& types, const config_t& config, type_t
 	QUARK_ASSERT(config.check_invariant());
 	QUARK_ASSERT(t.check_invariant());
 
-	return peek2(types, t).is_dict() && config.dict_backend_mode == dict_backend::cppmap;
+	return peek2(types, t).is_dict() && get_dict_backend(types, config, t) == dict_backend::cppmap;
 }
 inline bool is_dict_hamt(const types_t& types, const config_t& config, type_t t){
 	QUARK_ASSERT(types.check_invariant());
 	QUARK_ASSERT(config.check_invariant());
 	QUARK_ASSERT(t.check_invariant());
 
-	return peek2(types, t).is_dict() && config.dict_backend_mode == dict_backend::hamt;
+	return peek2(types, t).is_dict() && get_dict_backend(types, config, t) == dict_backend::hamt;
+}
+inline bool is_dict_hashtable(const types_t& types, const config_t& config, type_t t){
+	QUARK_ASSERT(types.check_invariant());
+	QUARK_ASSERT(config.check_invariant());
+	QUARK_ASSERT(t.check_invariant());
+
+	return peek2(types, t).is_dict() && get_dict_backend(types, config, t) == dict_backend::hashtable;
 }
 
 
@@ -842,6 +984,16 @@ inline int32_t inc_rc(const heap_alloc_64_t& alloc){
 	return rc2;
 }
 
+inline bool is_rc_unique(const heap_alloc_64_t& alloc){
+	QUARK_ASSERT(alloc.check_invariant());
+
+#if ATOMIC_RC
+	return alloc.rc.load(std::memory_order_acquire) == 1;
+#else
+	return alloc.rc == 1;
+#endif
+}
+
 
 
 inline void retain_vector_hamt(value_backend_t& backend, runtime_value_t vec, type_t type){
@@ -12,6 +12,11 @@
 
 #include "expression.h"
 
+#include <cstring>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+
 
 namespace floyd {
 
@@ -43,35 +48,270 @@ DICT_CPPMAP_T* unpack_dict_cppmap_arg(const value_backend_t& backend, runtime_va
 }
 
 
-int compare_values(value_backend_t& backend, int64_t op, const runtime_type_t type, runtime_value_t lhs, runtime_value_t rhs){
+
+////////////////////////////////		COMPARE
+
+/*
+	Compares runtime values directly, without converting them to value_t. Gives the same results as
+	value_t::compare_value_true_deep().
+
+	- Values sharing the same heap allocation are equal, without looking at the contents.
+	- Strings and vectors of ints are compared with memcmp().
+*/
+
+
+static int limit_compare_result(int64_t value){
+	return value < 0 ? -1 : (value > 0 ? 1 : 0);
+}
+
+int compare_strings(runtime_value_t lhs, runtime_value_t rhs){
+	QUARK_ASSERT(lhs.vector_carray_ptr != nullptr && rhs.vector_carray_ptr != nullptr);
+
+	if(lhs.vector_carray_ptr == rhs.vector_carray_ptr){
+		return 0;
+	}
+
+	//	Characters are packed 8 per element, in memory order.
+	const auto lhs_size = get_vec_string_size(lhs);
+	const auto rhs_size = get_vec_string_size(rhs);
+	const auto lhs_chars = reinterpret_cast<const char*>(static_cast<const VECTOR_CARRAY_T*>(lhs.vector_carray_ptr)->get_element_ptr());
+	const auto rhs_chars = reinterpret_cast<const char*>(static_cast<const VECTOR_CARRAY_T*>(rhs.vector_carray_ptr)->get_element_ptr());
+
+	const auto diff = std::memcmp(lhs_chars, rhs_chars, std::min(lhs_size, rhs_size));
+	if(diff != 0){
+		return limit_compare_result(diff);
+	}
+	return lhs_size == rhs_size ? 0 : (lhs_size < rhs_size ? -1 : 1);
+}
+
+//	Longer vectors are sorted before shorter vectors, like compare_vector_true_deep().
+static int compare_vector_sizes(uint64_t lhs_size, uint64_t rhs_size){
+	return lhs_size == rhs_size ? 0 : (lhs_size > rhs_size ? -1 : 1);
+}
+
+static int compare_element_ranges(const value_backend_t& backend, const runtime_value_t* lhs, const runtime_value_t* rhs, uint64_t count, const type_t& element_type){
+	const auto& element_peek = peek2(backend.types, element_type);
+
+	//	Ints: only walk elements if the raw memory differs somewhere.
+	if(element_peek.is_int()){
+		if(std::memcmp(lhs, rhs, count * sizeof(runtime_value_t)) == 0){
+			return 0;
+		}
+		for(uint64_t i = 0 ; i < count ; i++){
+			if(lhs[i].int_value != rhs[i].int_value){
+				return limit_compare_result(lhs[i].int_value - rhs[i].int_value);
+			}
+		}
+		return 0;
+	}
+	else{
+		for(uint64_t i = 0 ; i < count ; i++){
+			const auto result = compare_values_true_deep(backend, lhs[i], rhs[i], element_type);
+			if(result != 0){
+				return result;
+			}
+		}
+		return 0;
+	}
+}
+
+static int compare_vectors(const value_backend_t& backend, runtime_value_t lhs, runtime_value_t rhs, const type_t& type){
+	const auto element_type = peek2(backend.types, type).get_vector_element_type(backend.types);
+
+	if(is_vector_carray(backend.types, backend.config, type)){
+		const auto& lhs_vec = *static_cast<const VECTOR_CARRAY_T*>(lhs.vector_carray_ptr);
+		const auto& rhs_vec = *static_cast<const VECTOR_CARRAY_T*>(rhs.vector_carray_ptr);
+		const auto shared_count = std::min(lhs_vec.get_element_count(), rhs_vec.get_element_count());
+
+		const auto result = compare_element_ranges(backend, lhs_vec.get_element_ptr(), rhs_vec.get_element_ptr(), shared_count, element_type);
+		return result != 0 ? result : compare_vector_sizes(lhs_vec.get_element_count(), rhs_vec.get_element_count());
+	}
+	else if(is_vector_hamt(backend.types, backend.config, type)){
+		const auto& lhs_vec = *lhs.vector_hamt_ptr;
+		const auto& rhs_vec = *rhs.vector_hamt_ptr;
+		const auto shared_count = std::min(lhs_vec.get_element_count(), rhs_vec.get_element_count());
+
+		for(uint64_t i = 0 ; i < shared_count ; i++){
+			const auto result = compare_values_true_deep(backend, lhs_vec.load_element(i), rhs_vec.load_element(i), element_type);
+			if(result != 0){
+				return result;
+			}
+		}
+		return compare_vector_sizes(lhs_vec.get_element_count(), rhs_vec.get_element_count());
+	}
+	else{
+		QUARK_ASSERT(false);
+		throw std::exception();
+	}
+}
+
+//	Walks two key-sorted sequences of (key, value) and compares them like compare_dict_true_deep().
+template <typename IT>
+static int compare_sorted_dict_entries(const value_backend_t& backend, IT lhs_it, IT lhs_end, IT rhs_it, IT rhs_end, const type_t& value_type){
+	while(lhs_it != lhs_end && rhs_it != rhs_end){
+		const std::string& lhs_key = (*lhs_it).first;
+		const std::string& rhs_key = (*rhs_it).first;
+		if(lhs_key != rhs_key){
+			return limit_compare_result(std::strcmp(lhs_key.c_str(), rhs_key.c_str()));
+		}
+		const auto value_result = compare_values_true_deep(backend, (*lhs_it).second, (*rhs_it).second, value_type);
+		if(value_result != 0){
+			return value_result;
+		}
+		lhs_it++;
+		rhs_it++;
+	}
+
+	if(lhs_it == lhs_end && rhs_it == rhs_end){
+		return 0;
+	}
+	else{
+		return lhs_it == lhs_end ? 1 : -1;
+	}
+}
+
+template <typename MAP>
+static std::vector<std::pair<std::string, runtime_value_t>> get_sorted_entries(const MAP& m){
+	std::vector<std::pair<std::string, runtime_value_t>> result(m.begin(), m.end());
+	std::sort(result.begin(), result.end(), [](const auto& a, const auto& b){ return a.first < b.first; });
+	return result;
+}
+
+//	For maps without key order, HAMT_MAP and HASHTABLE_MAP. Checks for equality first, it needs no sorting.
+template <typename MAP>
+static int compare_unordered_dicts(const value_backend_t& backend, const MAP& lhs_map, const MAP& rhs_map, const type_t& value_type){
+	if(lhs_map.size() == rhs_map.size()){
+		bool equal = true;
+		for(const auto& e: lhs_map){
+			const auto other = rhs_map.find(e.first);
+			if(other == nullptr || compare_values_true_deep(backend, e.second, *other, value_type) != 0){
+				equal = false;
+				break;
+			}
+		}
+		if(equal){
+			return 0;
+		}
+	}
+
+	const auto lhs_entries = get_sorted_entries(lhs_map);
+	const auto rhs_entries = get_sorted_entries(rhs_map);
+	return compare_sorted_dict_entries(backend, lhs_entries.begin(), lhs_entries.end(), rhs_entries.begin(), rhs_entries.end(), value_type);
+}
+
+static int compare_dicts(const value_backend_t& backend, runtime_value_t lhs, runtime_value_t rhs, const type_t& type){
+	const auto value_type = peek2(backend.types, type).get_dict_value_type(backend.types);
+
+	if(is_dict_cppmap(backend.types, backend.config, type)){
+		const auto& lhs_map = lhs.dict_cppmap_ptr->get_map();
+		const auto& rhs_map = rhs.dict_cppmap_ptr->get_map();
+		return compare_sorted_dict_entries(backend, lhs_map.begin(), lhs_map.end(), rhs_map.begin(), rhs_map.end(), value_type);
+	}
+	else if(is_dict_hamt(backend.types, backend.config, type)){
+		return compare_unordered_dicts(backend, lhs.dict_hamt_ptr->get_map(), rhs.dict_hamt_ptr->get_map(), value_type);
+	}
+	else if(is_dict_hashtable(backend.types, backend.config, type)){
+		return compare_unordered_dicts(backend, lhs.dict_hashtable_ptr->get_map(), rhs.dict_hashtable_ptr->get_map(), value_type);
+	}
+	else{
+		QUARK_ASSERT(false);
+		throw std::exception();
+	}
+}
+
+static int compare_structs(const value_backend_t& backend, runtime_value_t lhs, runtime_value_t rhs, const type_t& type){
+	const auto& struct_layout = find_struct_layout(backend, type);
+	const auto lhs_base_ptr = lhs.struct_ptr->get_data_ptr();
+	const auto rhs_base_ptr = rhs.struct_ptr->get_data_ptr();
+
+	for(const auto& member: struct_layout.second.members){
+		const auto lhs_member = *reinterpret_cast<const runtime_value_t*>(lhs_base_ptr + member.offset);
+		const auto rhs_member = *reinterpret_cast<const runtime_value_t*>(rhs_base_ptr + member.offset);
+		const auto result = compare_values_true_deep(backend, lhs_member, rhs_member, member.type);
+		if(result != 0){
+			return result;
+		}
+	}
+	return 0;
+}
+
+static int compare_jsons(runtime_value_t lhs, runtime_value_t rhs){
+	//	A null pointer is the null json.
+	const auto& lhs_json = lhs.json_ptr == nullptr ? json_t() : lhs.json_ptr->get_json();
+	const auto& rhs_json = rhs.json_ptr == nullptr ? json_t() : rhs.json_ptr->get_json();
+	return lhs_json == rhs_json ? 0 : 1;
+}
+
+int compare_values_true_deep(const value_backend_t& backend, runtime_value_t lhs, runtime_value_t rhs, const type_t& type){
 	QUARK_ASSERT(backend.check_invariant());
 
-	const auto& value_type = lookup_type_ref(backend, type);
+	const auto& peek = peek2(backend.types, type);
+
+	if(peek.is_bool()){
+		return (lhs.bool_value != 0 ? 1 : 0) - (rhs.bool_value != 0 ? 1 : 0);
+	}
+	else if(peek.is_int()){
+		return limit_compare_result(lhs.int_value - rhs.int_value);
+	}
+	else if(peek.is_double()){
+		return lhs.double_value > rhs.double_value ? 1 : (lhs.double_value < rhs.double_value ? -1 : 0);
+	}
+	else if(peek.is_typeid()){
+		return lhs.typeid_itype == rhs.typeid_itype ? 0 : -1;
+	}
+	else if(peek.is_string()){
+		return compare_strings(lhs, rhs);
+	}
 
-	const auto left_value = from_runtime_value2(backend, lhs, value_type);
-	const auto right_value = from_runtime_value2(backend, rhs, value_type);
+	//	Same heap_alloc_64_t = same value. Compares the raw pointer bits.
+	else if(lhs.int_value == rhs.int_value && (peek.is_json() || peek.is_vector() || peek.is_dict() || peek.is_struct())){
+		return 0;
+	}
+	else if(peek.is_json()){
+		return compare_jsons(lhs, rhs);
+	}
+	else if(peek.is_vector()){
+		return compare_vectors(backend, lhs, rhs, peek);
+	}
+	else if(peek.is_dict()){
+		return compare_dicts(backend, lhs, rhs, peek);
+	}
+	else if(peek.is_struct()){
+		return compare_structs(backend, lhs, rhs, peek);
+	}
+	else if(peek.is_undefined() || peek.is_any() || peek.is_void()){
+		return 0;
+	}
+	else if(peek.is_function()){
+		QUARK_ASSERT(false);
+		return 0;
+	}
+	else{
+		QUARK_ASSERT(false);
+		throw std::exception();
+	}
+}
 
-	const int result = value_t::compare_value_true_deep(left_value, right_value);
-//	int result = runtime_compare_value_true_deep((const uint64_t)lhs, (const uint64_t)rhs, vector_type);
+int apply_compare_op(int64_t op, int compare_result){
 	const auto op2 = static_cast<expression_type>(op);
 	if(op2 == expression_type::k_comparison_smaller_or_equal){
-		return result <= 0 ? 1 : 0;
+		return compare_result <= 0 ? 1 : 0;
 	}
 	else if(op2 == expression_type::k_comparison_smaller){
-		return result < 0 ? 1 : 0;
+		return compare_result < 0 ? 1 : 0;
 	}
 	else if(op2 == expression_type::k_comparison_larger_or_equal){
-		return result >= 0 ? 1 : 0;
+		return compare_result >= 0 ? 1 : 0;
 	}
 	else if(op2 == expression_type::k_comparison_larger){
-		return result > 0 ? 1 : 0;
+		return compare_result > 0 ? 1 : 0;
 	}
 
 	else if(op2 == expression_type::k_logical_equal){
-		return result == 0 ? 1 : 0;
+		return compare_result == 0 ? 1 : 0;
 	}
 	else if(op2 == expression_type::k_logical_nonequal){
-		return result != 0 ? 1 : 0;
+		return compare_result != 0 ? 1 : 0;
 	}
 	else{
 		QUARK_ASSERT(false);
@@ -79,6 +319,91 @@ int compare_values(value_backend_t& backend, int64_t op, const runtime_type_t ty
 	}
 }
 
+int compare_values(value_backend_t& backend, int64_t op, const runtime_type_t type, runtime_value_t lhs, runtime_value_t rhs){
+	QUARK_ASSERT(backend.check_invariant());
+
+	const auto& value_type = lookup_type_ref(backend, type);
+	return apply_compare_op(op, compare_values_true_deep(backend, lhs, rhs, value_type));
+}
+
+
+//	Verifies that compare_values_true_deep() orders the values like value_t::compare_value_true_deep().
+static void verify_compare_like_value_t(const types_t& types, const std::vector<value_t>& values){
+	for(const auto vector_mode: { vector_backend::carray, vector_backend::hamt }){
+		auto config = make_default_config();
+		config.vector_backend_mode = vector_mode;
+		auto backend = value_backend_t({}, {}, types, config);
+
+		std::vector<runtime_value_t> encoded;
+		for(const auto& e: values){
+			encoded.push_back(to_runtime_value2(backend, e));
+		}
+
+		for(size_t a = 0 ; a < values.size() ; a++){
+			for(size_t b = 0 ; b < values.size() ; b++){
+				const auto expected = value_t::compare_value_true_deep(values[a], values[b]);
+				const auto result = compare_values_true_deep(backend, encoded[a], encoded[b], values[a].get_type());
+				QUARK_VERIFY(result == expected);
+			}
+		}
+
+		for(size_t i = 0 ; i < values.size() ; i++){
+			release_value(backend, encoded[i], values[i].get_type());
+		}
+	}
+}
+
+QUARK_TEST("compare_values_true_deep()", "string", "", ""){
+	types_t types;
+	verify_compare_like_value_t(
+		types,
+		{
+			value_t::make_string(""),
+			value_t::make_string("a"),
+			value_t::make_string("ab"),
+			value_t::make_string("abcdefghijk"),
+			value_t::make_string("abcdefghijl"),
+			value_t::make_string("b")
+		}
+	);
+}
+
+QUARK_TEST("compare_values_true_deep()", "[int]", "", ""){
+	types_t types;
+	const auto e = type_t::make_int();
+	verify_compare_like_value_t(
+		types,
+		{
+			value_t::make_vector_value(types, e, {}),
+			value_t::make_vector_value(types, e, { value_t::make_int(1) }),
+			value_t::make_vector_value(types, e, { value_t::make_int(1), value_t::make_int(-2) }),
+			value_t::make_vector_value(types, e, { value_t::make_int(1), value_t::make_int(2) }),
+			value_t::make_vector_value(types, e, { value_t::make_int(3) })
+		}
+	);
+}
+
+QUARK_TEST("compare_values_true_deep()", "[string]", "", ""){
+	types_t types;
+	const auto e = type_t::make_string();
+	verify_compare_like_value_t(
+		types,
+		{
+			value_t::make_vector_value(types, e, {}),
+			value_t::make_vector_value(types, e, { value_t::make_string("one") }),
+			value_t::make_vector_value(types, e, { value_t::make_string("one"), value_t::make_string("two") }),
+			value_t::make_vector_value(types, e, { value_t::make_string("three") })
+		}
+	);
+}
+
+QUARK_TEST("compare_values_true_deep()", "", "Same object", "Equal"){
+	auto backend = make_test_value_backend();
+	const auto a = to_runtime_string2(backend, "hello, world!");
+	QUARK_VERIFY(compare_values_true_deep(backend, a, a, type_t::make_string()) == 0);
+	release_value(backend, a, type_t::make_string());
+}
+
 
 
 
@@ -176,6 +501,542 @@ const runtime_value_t update__dict_hamt(value_backend_t& backend, runtime_value_
 	return dict2;
 }
 
+const runtime_value_t update__dict_hashtable(value_backend_t& backend, runtime_value_t coll_value, runtime_type_t coll_type, runtime_value_t key_value, runtime_value_t value){
+	QUARK_ASSERT(backend.check_invariant());
+
+	const auto dict = coll_value.dict_hashtable_ptr;
+	const auto value_itype = lookup_dict_value_type(backend, type_t(coll_type));
+
+	//	Deep copy dict.
+	auto dict2 = alloc_dict_hashtable(backend.heap, type_t(coll_type));
+	auto& m = dict2.dict_hashtable_ptr->get_map_mut();
+	m = dict->get_map();
+	m.insert_or_assign(get_vec_string_view(key_value), value);
+
+	if(is_rc_value(peek2(backend.types, value_itype))){
+		for(const auto& e: m){
+			retain_value(backend, e.second, value_itype);
+		}
+	}
+
+	return dict2;
+}
+
+
+
+////////////////////////////////		IN-PLACE push_back() / update() / concatenation
+
+
+//	Doubles the capacity so repeated appends are amortized O(1) per element.
+static uint64_t calc_carray_growth(uint64_t required_count){
+	return std::max<uint64_t>(required_count * 2, 4);
+}
+
+/*
+	Returns s with capacity for at least required_size characters and RC 1, taking over the caller's reference to s.
+	If s is shared or too small, its characters are copied into a new string with room for capacity characters.
+*/
+static runtime_value_t reserve_string(value_backend_t& backend, runtime_value_t s, uint64_t required_size, uint64_t capacity){
+	QUARK_ASSERT(backend.check_invariant());
+	QUARK_ASSERT(s.vector_carray_ptr != nullptr);
+	QUARK_ASSERT(capacity >= required_size);
+
+	auto& vec = *s.vector_carray_ptr;
+	if(is_rc_unique(vec.alloc) && required_size <= vec.get_allocation_count() * 8){
+		return s;
+	}
+
+	const auto size = vec.get_element_count();
+	const auto used_count = size_to_allocation_blocks(size);
+	const auto allocation_count = size_to_allocation_blocks(capacity);
+	auto result = alloc_vector_carray(backend.heap, allocation_count, size, type_t::make_string());
+	auto dest_ptr = result.vector_carray_ptr->get_element_ptr();
+	std::copy(vec.get_element_ptr(), vec.get_element_ptr() + used_count, dest_ptr);
+	std::fill(dest_ptr + used_count, dest_ptr + allocation_count, make_runtime_int(0));
+
+	if(dec_rc(vec.alloc) == 0){
+		dispose_vector_carray(s);
+	}
+	return result;
+}
+
+/*
+	Same as reserve_string() for carray vectors. When vec is unique but too small the elements are moved:
+	the old vector goes away without releasing them so their RCs stay the same.
+*/
+static runtime_value_t reserve_vector_carray(value_backend_t& backend, runtime_value_t vec, const type_t& type, uint64_t required_count, uint64_t capacity){
+	QUARK_ASSERT(backend.check_invariant());
+	QUARK_ASSERT(vec.vector_carray_ptr != nullptr);
+	QUARK_ASSERT(capacity >= required_count);
+
+	auto source = vec.vector_carray_ptr;
+	const auto unique = is_rc_unique(source->alloc);
+	if(unique && required_count <= source->get_allocation_count()){
+		return vec;
+	}
+
+	const auto count = source->get_element_count();
+	auto result = alloc_vector_carray(backend.heap, capacity, count, type);
+	auto dest_ptr = result.vector_carray_ptr->get_element_ptr();
+	auto source_ptr = source->get_element_ptr();
+	std::copy(source_ptr, source_ptr + count, dest_ptr);
+
+	if(unique){
+		dec_rc(source->alloc);
+		dispose_vector_carray(vec);
+	}
+	else{
+		const auto element_type = lookup_vector_element_type(backend, type);
+		if(is_rc_value(peek2(backend.types, element_type))){
+			for(int i = 0 ; i < count ; i++){
+				retain_value(backend, dest_ptr[i], element_type);
+			}
+		}
+		release_vec(backend, vec, type);
+	}
+	return result;
+}
+
+//	Characters are packed 8 per element, first character in the lowest byte.
+static void store_string_char(VECTOR_CARRAY_T& vec, uint64_t pos, char ch){
+	auto p = vec.get_element_ptr();
+	const auto shift = (pos & 7) * 8;
+	const auto word = static_cast<uint64_t>(p[pos >> 3].int_value);
+	const auto word2 = (word & ~(static_cast<uint64_t>(0xff) << shift)) | (static_cast<uint64_t>(static_cast<uint8_t>(ch)) << shift);
+	p[pos >> 3].int_value = static_cast<int64_t>(word2);
+}
+
+runtime_value_t push_back_inplace__string(value_backend_t& backend, runtime_value_t s, runtime_value_t element){
+	QUARK_ASSERT(backend.check_invariant());
+	QUARK_ASSERT(s.vector_carray_ptr != nullptr);
+
+	const auto size = s.vector_carray_ptr->get_element_count();
+	auto result = reserve_string(backend, s, size + 1, calc_carray_growth(size + 1));
+	store_string_char(*result.vector_carray_ptr, size, static_cast<char>(element.int_value));
+	result.vector_carray_ptr->alloc.data[0] = size + 1;
+	return result;
+}
+
+runtime_value_t push_back_inplace__vector_carray(value_backend_t& backend, runtime_value_t coll_value, runtime_type_t coll_type, runtime_value_t element){
+	QUARK_ASSERT(backend.check_invariant());
+
+	const auto count = unpack_vector_carray_arg(backend, coll_value, coll_type)->get_element_count();
+	auto result = reserve_vector_carray(backend, coll_value, type_t(coll_type), count + 1, calc_carray_growth(count + 1));
+	result.vector_carray_ptr->store(count, element);
+	result.vector_carray_ptr->alloc.data[0] = count + 1;
+	return result;
+}
+
+runtime_value_t reserve_string_inplace(value_backend_t& backend, runtime_value_t s, uint64_t capacity){
+	QUARK_ASSERT(backend.check_invariant());
+
+	return reserve_string(backend, s, capacity, capacity);
+}
+
+runtime_value_t concat_inplace__string(value_backend_t& backend, runtime_value_t lhs, runtime_value_t rhs){
+	QUARK_ASSERT(backend.check_invariant());
+	QUARK_ASSERT(lhs.check_invariant());
+	QUARK_ASSERT(rhs.check_invariant());
+
+	const auto lhs_size = get_vec_string_size(lhs);
+	const auto rhs_size = get_vec_string_size(rhs);
+	const auto size2 = lhs_size + rhs_size;
+
+	//	rhs is still referenced by the caller, so if lhs == rhs, lhs isn't unique and gets copied.
+	auto result = reserve_string(backend, lhs, size2, calc_carray_growth(size2));
+	auto dest_chars = reinterpret_cast<char*>(result.vector_carray_ptr->get_element_ptr());
+	const auto rhs_chars = reinterpret_cast<const char*>(rhs.vector_carray_ptr->get_element_ptr());
+	std::memcpy(dest_chars + lhs_size, rhs_chars, rhs_size);
+	result.vector_carray_ptr->alloc.data[0] = size2;
+	return result;
+}
+
+runtime_value_t concat_inplace__vector_carray(value_backend_t& backend, const type_t& type, runtime_value_t lhs, runtime_value_t rhs){
+	QUARK_ASSERT(backend.check_invariant());
+	QUARK_ASSERT(type.check_invariant());
+	QUARK_ASSERT(lhs.check_invariant());
+	QUARK_ASSERT(rhs.check_invariant());
+
+	const auto lhs_count = lhs.vector_carray_ptr->get_element_count();
+	const auto rhs_count = rhs.vector_carray_ptr->get_element_count();
+	const auto count2 = lhs_count + rhs_count;
+
+	auto result = reserve_vector_carray(backend, lhs, type, count2, calc_carray_growth(count2));
+	auto dest_ptr = result.vector_carray_ptr->get_element_ptr() + lhs_count;
+	auto rhs_ptr = rhs.vector_carray_ptr->get_element_ptr();
+	std::copy(rhs_ptr, rhs_ptr + rhs_count, dest_ptr);
+
+	const auto element_type = lookup_vector_element_type(backend, type);
+	if(is_rc_value(peek2(backend.types, element_type))){
+		for(int i = 0 ; i < rhs_count ; i++){
+			retain_value(backend, dest_ptr[i], element_type);
+		}
+	}
+	result.vector_carray_ptr->alloc.data[0] = count2;
+	return result;
+}
+
+runtime_value_t update_inplace__vector_carray(value_backend_t& backend, runtime_value_t coll_value, runtime_type_t coll_type, runtime_value_t index, runtime_value_t value){
+	QUARK_ASSERT(backend.check_invariant());
+
+	auto vec = unpack_vector_carray_arg(backend, coll_value, coll_type);
+	const auto count = vec->get_element_count();
+	const auto index2 = index.int_value;
+	if(index2 < 0 || index2 >= count){
+		quark::throw_runtime_error("Position argument to update() is outside collection span.");
+	}
+
+	const auto element_type = lookup_vector_element_type(backend, type_t(coll_type));
+	const auto is_rc = is_rc_value(peek2(backend.types, element_type));
+
+	if(is_rc_unique(vec->alloc)){
+		if(is_rc){
+			release_value(backend, vec->load_element(index2), element_type);
+		}
+		vec->store(index2, value);
+		return coll_value;
+	}
+	else{
+		auto result = alloc_vector_carray(backend.heap, count, count, type_t(coll_type));
+		auto dest_ptr = result.vector_carray_ptr->get_element_ptr();
+		auto source_ptr = vec->get_element_ptr();
+		for(int i = 0 ; i < count ; i++){
+			dest_ptr[i] = source_ptr[i];
+			if(is_rc && i != index2){
+				retain_value(backend, dest_ptr[i], element_type);
+			}
+		}
+		dest_ptr[index2] = value;
+
+		release_vec(backend, coll_value, type_t(coll_type));
+		return result;
+	}
+}
+
+//	Takes over the reference to value, releases the value it replaces.
+static void store_dict_cppmap_value(value_backend_t& backend, CPPMAP& m, const std::string& key, runtime_value_t value, const type_t& value_type){
+	const auto it = m.find(key);
+	if(it == m.end()){
+		m.insert({ key, value });
+	}
+	else{
+		if(is_rc_value(peek2(backend.types, value_type))){
+			release_value(backend, it->second, value_type);
+		}
+		it->second = value;
+	}
+}
+
+runtime_value_t update_inplace__dict_cppmap(value_backend_t& backend, runtime_value_t coll_value, runtime_type_t coll_type, runtime_value_t key_value, runtime_value_t value){
+	QUARK_ASSERT(backend.check_invariant());
+
+	const auto key = from_runtime_string2(backend, key_value);
+	auto dict = unpack_dict_cppmap_arg(backend, coll_value, coll_type);
+	const auto value_type = lookup_dict_value_type(backend, type_t(coll_type));
+
+	if(is_rc_unique(dict->alloc)){
+		store_dict_cppmap_value(backend, dict->get_map_mut(), key, value, value_type);
+		return coll_value;
+	}
+	else{
+		auto dict2 = alloc_dict_cppmap(backend.heap, type_t(coll_type));
+		auto& m = dict2.dict_cppmap_ptr->get_map_mut();
+		m = dict->get_map();
+		if(is_rc_value(peek2(backend.types, value_type))){
+			for(const auto& e: m){
+				retain_value(backend, e.second, value_type);
+			}
+		}
+		store_dict_cppmap_value(backend, m, key, value, value_type);
+
+		release_dict_cppmap(backend, coll_value, type_t(coll_type));
+		return dict2;
+	}
+}
+
+//	Takes over the reference to value, releases the value it replaces.
+static void store_dict_hashtable_value(value_backend_t& backend, HASHTABLE_MAP& m, std::string_view key, runtime_value_t value, const type_t& value_type){
+	const auto existing = m.find_mut(key);
+	if(existing == nullptr){
+		m.insert_or_assign(key, value);
+	}
+	else{
+		if(is_rc_value(peek2(backend.types, value_type))){
+			release_value(backend, *existing, value_type);
+		}
+		*existing = value;
+	}
+}
+
+runtime_value_t update_inplace__dict_hashtable(value_backend_t& backend, runtime_value_t coll_value, runtime_type_t coll_type, runtime_value_t key_value, runtime_value_t value){
+	QUARK_ASSERT(backend.check_invariant());
+
+	const auto key = get_vec_string_view(key_value);
+	auto dict = coll_value.dict_hashtable_ptr;
+	const auto value_type = lookup_dict_value_type(backend, type_t(coll_type));
+
+	if(is_rc_unique(dict->alloc)){
+		store_dict_hashtable_value(backend, dict->get_map_mut(), key, value, value_type);
+		return coll_value;
+	}
+	else{
+		auto dict2 = alloc_dict_hashtable(backend.heap, type_t(coll_type));
+		auto& m = dict2.dict_hashtable_ptr->get_map_mut();
+		m = dict->get_map();
+		if(is_rc_value(peek2(backend.types, value_type))){
+			for(const auto& e: m){
+				retain_value(backend, e.second, value_type);
+			}
+		}
+		store_dict_hashtable_value(backend, m, key, value, value_type);
+
+		release_dict_hashtable(backend, coll_value, type_t(coll_type));
+		return dict2;
+	}
+}
+
+
+
+static value_backend_t make_carray_test_backend(const types_t& types, dict_backend dict_mode = dict_backend::cppmap){
+	auto config = make_default_config();
+	config.vector_backend_mode = vector_backend::carray;
+	config.dict_backend_mode = dict_mode;
+	return value_backend_t({}, {}, types, config);
+}
+
+QUARK_TEST("push_back_inplace__string()", "", "Unique string", "Grows in place"){
+	auto backend = make_test_value_backend();
+	auto a = to_runtime_string2(backend, "");
+
+	std::string expected;
+	for(int i = 0 ; i < 100 ; i++){
+		const auto ch = static_cast<char>('a' + (i % 26));
+		a = push_back_inplace__string(backend, a, make_runtime_int(ch));
+		expected.push_back(ch);
+		QUARK_VERIFY(from_runtime_string2(backend, a) == expected);
+	}
+
+	QUARK_VERIFY(a.vector_carray_ptr->get_allocation_count() * 8 < 200 * 2);
+	release_value(backend, a, type_t::make_string());
+}
+
+QUARK_TEST("push_back_inplace__string()", "", "Shared string", "Original is untouched"){
+	auto backend = make_test_value_backend();
+	const auto a = to_runtime_string2(backend, "hello, world");
+	retain_value(backend, a, type_t::make_string());
+
+	const auto b = push_back_inplace__string(backend, a, make_runtime_int('!'));
+	QUARK_VERIFY(b.vector_carray_ptr != a.vector_carray_ptr);
+	QUARK_VERIFY(from_runtime_string2(backend, a) == "hello, world");
+	QUARK_VERIFY(from_runtime_string2(backend, b) == "hello, world!");
+	QUARK_VERIFY(a.vector_carray_ptr->alloc.rc == 1);
+
+	release_value(backend, a, type_t::make_string());
+	release_value(backend, b, type_t::make_string());
+}
+
+QUARK_TEST("push_back_inplace__string()", "", "Shared string with spare capacity", "Second reference is unchanged"){
+	auto backend = make_test_value_backend();
+	auto a = to_runtime_string2(backend, "hello");
+	a = push_back_inplace__string(backend, a, make_runtime_int(','));
+	const auto a_ptr = a.vector_carray_ptr;
+
+	const auto second = a;
+	retain_value(backend, second, type_t::make_string());
+	a = push_back_inplace__string(backend, a, make_runtime_int('!'));
+	QUARK_VERIFY(a.vector_carray_ptr != a_ptr);
+	QUARK_VERIFY(from_runtime_string2(backend, second) == "hello,");
+	QUARK_VERIFY(second.vector_carray_ptr->get_element_count() == 6);
+	QUARK_VERIFY(second.vector_carray_ptr->alloc.rc == 1);
+	QUARK_VERIFY(from_runtime_string2(backend, a) == "hello,!");
+
+	release_value(backend, second, type_t::make_string());
+	release_value(backend, a, type_t::make_string());
+}
+
+QUARK_TEST("push_back_inplace__vector_carray()", "[string]", "Unique vector", "Reuses the allocation while there is capacity"){
+	types_t types;
+	const auto vec_value = value_t::make_vector_value(types, type_t::make_string(), { value_t::make_string("one") });
+	const auto vec_type = vec_value.get_type();
+	auto backend = make_carray_test_backend(types);
+
+	auto a = to_runtime_value2(backend, vec_value);
+	a = push_back_inplace__vector_carray(backend, a, make_runtime_type(vec_type), to_runtime_string2(backend, "two"));
+	const auto grown_ptr = a.vector_carray_ptr;
+	a = push_back_inplace__vector_carray(backend, a, make_runtime_type(vec_type), to_runtime_string2(backend, "three"));
+	QUARK_VERIFY(a.vector_carray_ptr == grown_ptr);
+
+	const auto expected = value_t::make_vector_value(types, type_t::make_string(), { value_t::make_string("one"), value_t::make_string("two"), value_t::make_string("three") });
+	QUARK_VERIFY(from_runtime_value2(backend, a, vec_type) == expected);
+	release_value(backend, a, vec_type);
+}
+
+QUARK_TEST("push_back_inplace__vector_carray()", "[string]", "Shared vector with spare capacity", "Second reference is unchanged"){
+	types_t types;
+	const auto vec_value = value_t::make_vector_value(types, type_t::make_string(), { value_t::make_string("one") });
+	const auto vec_type = vec_value.get_type();
+	auto backend = make_carray_test_backend(types);
+
+	auto a = to_runtime_value2(backend, vec_value);
+	a = push_back_inplace__vector_carray(backend, a, make_runtime_type(vec_type), to_runtime_string2(backend, "two"));
+	const auto a_ptr = a.vector_carray_ptr;
+	const auto second_expected = from_runtime_value2(backend, a, vec_type);
+
+	const auto second = a;
+	retain_value(backend, second, vec_type);
+	a = push_back_inplace__vector_carray(backend, a, make_runtime_type(vec_type), to_runtime_string2(backend, "three"));
+	QUARK_VERIFY(a.vector_carray_ptr != a_ptr);
+	QUARK_VERIFY(from_runtime_value2(backend, second, vec_type) == second_expected);
+	QUARK_VERIFY(second.vector_carray_ptr->get_element_count() == 2);
+	QUARK_VERIFY(second.vector_carray_ptr->alloc.rc == 1);
+	QUARK_VERIFY(from_runtime_value2(backend, a, vec_type) == value_t::make_vector_value(types, type_t::make_string(), { value_t::make_string("one"), value_t::make_string("two"), value_t::make_string("three") }));
+
+	release_value(backend, second, vec_type);
+	release_value(backend, a, vec_type);
+}
+
+QUARK_TEST("update_inplace__vector_carray()", "[string]", "Shared vector", "Original is untouched"){
+	types_t types;
+	const auto vec_value = value_t::make_vector_value(types, type_t::make_string(), { value_t::make_string("one"), value_t::make_string("two") });
+	const auto vec_type = vec_value.get_type();
+	auto backend = make_carray_test_backend(types);
+
+	const auto a = to_runtime_value2(backend, vec_value);
+	retain_value(backend, a, vec_type);
+	const auto b = update_inplace__vector_carray(backend, a, make_runtime_type(vec_type), make_runtime_int(1), to_runtime_string2(backend, "TWO"));
+	QUARK_VERIFY(from_runtime_value2(backend, a, vec_type) == vec_value);
+	QUARK_VERIFY(from_runtime_value2(backend, b, vec_type) == value_t::make_vector_value(types, type_t::make_string(), { value_t::make_string("one"), value_t::make_string("TWO") }));
+
+	const auto c = update_inplace__vector_carray(backend, b, make_runtime_type(vec_type), make_runtime_int(0), to_runtime_string2(backend, "ONE"));
+	QUARK_VERIFY(c.vector_carray_ptr == b.vector_carray_ptr);
+
+	release_value(backend, a, vec_type);
+	release_value(backend, c, vec_type);
+}
+
+//	libstdc++'s std::map doesn't fit in a heap_alloc_64_t, alloc_dict_cppmap() asserts. The hashtable tests below
+//	cover the same in-place path on every standard library.
+static const bool k_cppmap_fits_alloc = sizeof(CPPMAP) <= heap_alloc_64_t::k_data_bytes;
+
+QUARK_TEST("update_inplace__dict_cppmap()", "[string:int]", "Unique dict", "Mutated in place"){
+	if(k_cppmap_fits_alloc == false){
+		return;
+	}
+	types_t types;
+	const auto dict_value = value_t::make_dict_value(types, type_t::make_int(), { { "one", value_t::make_int(1) } });
+	const auto dict_type = dict_value.get_type();
+	auto backend = make_carray_test_backend(types);
+
+	auto a = to_runtime_value2(backend, dict_value);
+	const auto a_ptr = a.dict_cppmap_ptr;
+	const auto key = to_runtime_string2(backend, "two");
+	a = update_inplace__dict_cppmap(backend, a, make_runtime_type(dict_type), key, make_runtime_int(2));
+	QUARK_VERIFY(a.dict_cppmap_ptr == a_ptr);
+	QUARK_VERIFY(from_runtime_value2(backend, a, dict_type) == value_t::make_dict_value(types, type_t::make_int(), { { "one", value_t::make_int(1) }, { "two", value_t::make_int(2) } }));
+
+	release_value(backend, key, type_t::make_string());
+	release_value(backend, a, dict_type);
+}
+
+QUARK_TEST("update_inplace__dict_cppmap()", "[string:string]", "Shared dict", "Second reference is unchanged"){
+	if(k_cppmap_fits_alloc == false){
+		return;
+	}
+	types_t types;
+	const auto dict_value = value_t::make_dict_value(types, type_t::make_string(), { { "one", value_t::make_string("1") } });
+	const auto dict_type = dict_value.get_type();
+	auto backend = make_carray_test_backend(types);
+
+	auto a = to_runtime_value2(backend, dict_value);
+	const auto a_ptr = a.dict_cppmap_ptr;
+	const auto second = a;
+	retain_value(backend, second, dict_type);
+
+	const auto key = to_runtime_string2(backend, "one");
+	a = update_inplace__dict_cppmap(backend, a, make_runtime_type(dict_type), key, to_runtime_string2(backend, "I"));
+	QUARK_VERIFY(a.dict_cppmap_ptr != a_ptr);
+	QUARK_VERIFY(from_runtime_value2(backend, second, dict_type) == dict_value);
+	QUARK_VERIFY(second.dict_cppmap_ptr->alloc.rc == 1);
+	QUARK_VERIFY(from_runtime_value2(backend, a, dict_type) == value_t::make_dict_value(types, type_t::make_string(), { { "one", value_t::make_string("I") } }));
+
+	release_value(backend, key, type_t::make_string());
+	release_value(backend, second, dict_type);
+	release_value(backend, a, dict_type);
+}
+
+QUARK_TEST("update_inplace__dict_hashtable()", "[string:string]", "Unique, then shared dict", "Mutated in place, then copied"){
+	types_t types;
+	const auto dict_value = value_t::make_dict_value(types, type_t::make_string(), { { "one", value_t::make_string("1") } });
+	const auto dict_type = dict_value.get_type();
+	auto backend = make_carray_test_backend(types, dict_backend::hashtable);
+
+	auto a = to_runtime_value2(backend, dict_value);
+	const auto a_ptr = a.dict_hashtable_ptr;
+	const auto key = to_runtime_string2(backend, "two");
+	a = update_inplace__dict_hashtable(backend, a, make_runtime_type(dict_type), key, to_runtime_string2(backend, "2"));
+	QUARK_VERIFY(a.dict_hashtable_ptr == a_ptr);
+
+	retain_value(backend, a, dict_type);
+	const auto b = update_inplace__dict_hashtable(backend, a, make_runtime_type(dict_type), key, to_runtime_string2(backend, "II"));
+	QUARK_VERIFY(b.dict_hashtable_ptr != a_ptr);
+	QUARK_VERIFY(a.dict_hashtable_ptr->alloc.rc == 1);
+
+	QUARK_VERIFY(from_runtime_value2(backend, a, dict_type) == value_t::make_dict_value(types, type_t::make_string(), { { "one", value_t::make_string("1") }, { "two", value_t::make_string("2") } }));
+	QUARK_VERIFY(from_runtime_value2(backend, b, dict_type) == value_t::make_dict_value(types, type_t::make_string(), { { "one", value_t::make_string("1") }, { "two", value_t::make_string("II") } }));
+	QUARK_VERIFY(compare_values_true_deep(backend, a, b, dict_type) != 0);
+
+	release_value(backend, key, type_t::make_string());
+	release_value(backend, a, dict_type);
+	release_value(backend, b, dict_type);
+}
+
+QUARK_TEST("concat_inplace__string()", "", "Unique string", "Appends in place once there is capacity"){
+	auto backend = make_test_value_backend();
+	auto a = to_runtime_string2(backend, "hello");
+	const auto b = to_runtime_string2(backend, ", world");
+
+	a = concat_inplace__string(backend, a, b);
+	const auto grown_ptr = a.vector_carray_ptr;
+	a = concat_inplace__string(backend, a, b);
+	QUARK_VERIFY(a.vector_carray_ptr == grown_ptr);
+	QUARK_VERIFY(from_runtime_string2(backend, a) == "hello, world, world");
+
+	release_value(backend, a, type_t::make_string());
+	release_value(backend, b, type_t::make_string());
+}
+
+QUARK_TEST("concat_inplace__string()", "", "Reserved string", "Chain makes no more allocations"){
+	auto backend = make_test_value_backend();
+	const std::vector<std::string> parts = { "The quick ", "brown fox ", "jumps over ", "the lazy dog" };
+
+	auto a = reserve_string_inplace(backend, to_runtime_string2(backend, parts[0]), 43);
+	const auto reserved_ptr = a.vector_carray_ptr;
+	for(int i = 1 ; i < parts.size() ; i++){
+		const auto part = to_runtime_string2(backend, parts[i]);
+		a = concat_inplace__string(backend, a, part);
+		release_value(backend, part, type_t::make_string());
+	}
+	QUARK_VERIFY(a.vector_carray_ptr == reserved_ptr);
+	QUARK_VERIFY(from_runtime_string2(backend, a) == "The quick brown fox jumps over the lazy dog");
+	release_value(backend, a, type_t::make_string());
+}
+
+QUARK_TEST("concat_inplace__vector_carray()", "[string]", "Shared vector", "Original is untouched"){
+	types_t types;
+	const auto vec_value = value_t::make_vector_value(types, type_t::make_string(), { value_t::make_string("one") });
+	const auto vec_type = vec_value.get_type();
+	auto backend = make_carray_test_backend(types);
+
+	const auto a = to_runtime_value2(backend, vec_value);
+	retain_value(backend, a, vec_type);
+	const auto b = concat_inplace__vector_carray(backend, vec_type, a, a);
+	QUARK_VERIFY(from_runtime_value2(backend, a, vec_type) == vec_value);
+	QUARK_VERIFY(from_runtime_value2(backend, b, vec_type) == value_t::make_vector_value(types, type_t::make_string(), { value_t::make_string("one"), value_t::make_string("one") }));
+
+	release_value(backend, a, vec_type);
+	release_value(backend, b, vec_type);
+}
+
 
 
 
@@ -431,7 +1292,7 @@ int64_t find__carray(value_backend_t& backend, runtime_value_t coll_value, runti
 		vec->get_element_ptr(),
 		vec->get_element_ptr() + vec->get_element_count(),
 		[&] (const runtime_value_t& e) {
-			return compare_values(backend, static_cast<int64_t>(expression_type::k_logical_equal), value_type, e, value) == 1;
+			return compare_values_true_deep(backend, e, value, type1) == 0;
 		}
 	);
 	if(it == vec->get_element_ptr() + vec->get_element_count()){
@@ -455,7 +1316,7 @@ int64_t find__hamt(value_backend_t& backend, runtime_value_t coll_value, runtime
 
 	const auto count = vec.get_element_count();
 	int64_t index = 0;
-	while(index < count && compare_values(backend, static_cast<int64_t>(expression_type::k_logical_equal), value_type, vec.load_element(index), value) != 1){
+	while(index < count && compare_values_true_deep(backend, vec.load_element(index), value, type1) != 0){
 		index++;
 	}
 	if(index == count){
@@ -542,6 +1403,39 @@ runtime_value_t get_keys__hamtmap_carray(value_backend_t& backend, runtime_value
 	}
 	return result_vec;
 }
+runtime_value_t get_keys__hashtable_carray(value_backend_t& backend, runtime_value_t dict_value, runtime_type_t dict_type){
+	QUARK_ASSERT(backend.check_invariant());
+	QUARK_ASSERT(peek2(backend.types, lookup_type_ref(backend, dict_type)).is_dict());
+
+	const auto& m = dict_value.dict_hashtable_ptr->get_map();
+	const auto count = m.size();
+
+	auto result_vec = alloc_vector_carray(backend.heap, count, count, make_vector(backend.types, type_t::make_string()));
+
+	int index = 0;
+	for(const auto& e: m){
+		result_vec.vector_carray_ptr->get_element_ptr()[index] = to_runtime_string2(backend, e.first);
+		index++;
+	}
+	return result_vec;
+}
+runtime_value_t get_keys__hashtable_hamt(value_backend_t& backend, runtime_value_t dict_value, runtime_type_t dict_type){
+	QUARK_ASSERT(backend.check_invariant());
+	QUARK_ASSERT(peek2(backend.types, lookup_type_ref(backend, dict_type)).is_dict());
+
+	const auto& m = dict_value.dict_hashtable_ptr->get_map();
+	const auto count = m.size();
+
+	auto result_vec = alloc_vector_hamt(backend.heap, count, count, make_vector(backend.types, type_t::make_string()));
+
+	int index = 0;
+	for(const auto& e: m){
+		result_vec.vector_hamt_ptr->store_mutate(index, to_runtime_string2(backend, e.first));
+		index++;
+	}
+	return result_vec;
+}
+
 runtime_value_t get_keys__hamtmap_hamt(value_backend_t& backend, runtime_value_t dict_value, runtime_type_t dict_type){
 	QUARK_ASSERT(backend.check_invariant());
 
@@ -572,24 +1466,142 @@ runtime_value_t get_keys__hamtmap_hamt(value_backend_t& backend, runtime_value_t
 
 
 
-int64_t analyse_samples(const int64_t* samples, int64_t count){
-	const auto use_ptr = &samples[1];
-	const auto use_count = count - 1;
+int64_t get_profile_time(){
+	const std::chrono::time_point<std::chrono::high_resolution_clock> now = std::chrono::high_resolution_clock::now();
+	const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
+	return int64_t(ns);
+}
 
-	auto smallest_acc = use_ptr[0];
-	auto largest_acc = use_ptr[0];
-	for(int64_t i = 0 ; i < use_count ; i++){
-		const auto value = use_ptr[i];
-		if(value < smallest_acc){
-			smallest_acc = value;
-		}
-		if(value > largest_acc){
-			largest_acc = value;
+//	Nearest-rank percentile of sorted values.
+static int64_t get_percentile(const std::vector<int64_t>& sorted, int percent){
+	QUARK_ASSERT(sorted.empty() == false);
+	QUARK_ASSERT(percent >= 0 && percent <= 100);
+
+	const auto count = static_cast<int64_t>(sorted.size());
+	const auto rank = (count * percent + 99) / 100;
+	return sorted[std::max<int64_t>(rank, 1) - 1];
+}
+
+static int64_t get_median(const std::vector<int64_t>& sorted){
+	QUARK_ASSERT(sorted.empty() == false);
+
+	const auto count = sorted.size();
+	return (count & 1) ? sorted[count / 2] : (sorted[count / 2 - 1] + sorted[count / 2]) / 2;
+}
+
+benchmark_stats_t analyse_samples_stats(const int64_t* samples, int64_t count){
+	QUARK_ASSERT(samples != nullptr);
+	QUARK_ASSERT(count >= 1);
+
+	//	Skip the warm-up sample, unless it's the only one.
+	const auto use_ptr = count > 1 ? &samples[1] : &samples[0];
+	const auto use_count = count > 1 ? count - 1 : count;
+
+	std::vector<int64_t> sorted(use_ptr, use_ptr + use_count);
+	std::sort(sorted.begin(), sorted.end());
+
+	double sum = 0.0;
+	for(const auto& e: sorted){
+		sum += static_cast<double>(e);
+	}
+	const double mean = sum / static_cast<double>(use_count);
+
+	double square_sum = 0.0;
+	for(const auto& e: sorted){
+		const auto d = static_cast<double>(e) - mean;
+		square_sum += d * d;
+	}
+	const double stddev = use_count > 1 ? std::sqrt(square_sum / static_cast<double>(use_count - 1)) : 0.0;
+
+	const auto median = get_median(sorted);
+
+	std::vector<int64_t> deviations;
+	deviations.reserve(sorted.size());
+	for(const auto& e: sorted){
+		deviations.push_back(std::abs(e - median));
+	}
+	std::sort(deviations.begin(), deviations.end());
+	const auto mad = get_median(deviations);
+
+	//	1.4826 scales MAD to match stddev for normal distributions.
+	const double outlier_limit = 3.0 * 1.4826 * static_cast<double>(mad);
+	int64_t outlier_count = 0;
+	for(const auto& e: deviations){
+		if(static_cast<double>(e) > outlier_limit){
+			outlier_count++;
 		}
 	}
-//	std::cout << "smallest: " << smallest_acc << std::endl;
-//	std::cout << "largest: " << largest_acc << std::endl;
-	return smallest_acc;
+
+	return benchmark_stats_t {
+		use_count,
+		sorted.front(),
+		sorted.back(),
+		static_cast<int64_t>(std::llround(mean)),
+		median,
+		get_percentile(sorted, 90),
+		get_percentile(sorted, 99),
+		static_cast<int64_t>(std::llround(stddev)),
+		mad,
+		outlier_count
+	};
+}
+
+QUARK_TEST("", "analyse_samples_stats()", "", ""){
+	const int64_t samples[] = { 1000, 10, 12, 11, 13, 10, 14, 11, 12, 10, 200 };
+	const auto r = analyse_samples_stats(samples, 11);
+	QUARK_VERIFY(r.sample_count == 10);
+	QUARK_VERIFY(r.min == 10);
+	QUARK_VERIFY(r.max == 200);
+	QUARK_VERIFY(r.median == 11);
+	QUARK_VERIFY(r.p90 == 14);
+	QUARK_VERIFY(r.p99 == 200);
+	QUARK_VERIFY(r.mean == 30);
+	QUARK_VERIFY(r.mad == 1);
+	QUARK_VERIFY(r.outlier_count == 1);
+}
+
+QUARK_TEST("", "analyse_samples_stats()", "Only warm-up sample", ""){
+	const int64_t samples[] = { 7 };
+	const auto r = analyse_samples_stats(samples, 1);
+	QUARK_VERIFY(r.sample_count == 1);
+	QUARK_VERIFY(r.min == 7 && r.max == 7 && r.median == 7 && r.p99 == 7);
+	QUARK_VERIFY(r.stddev == 0 && r.mad == 0 && r.outlier_count == 0);
+}
+
+int64_t analyse_samples(const int64_t* samples, int64_t count){
+	return analyse_samples_stats(samples, count).min;
+}
+
+benchmark_stats_t take_benchmark_stats(std::vector<benchmark_stats_t>& stats_log, int64_t dur){
+	const auto it = std::find_if(stats_log.begin(), stats_log.end(), [&](const benchmark_stats_t& e){ return e.min == dur; });
+	if(it == stats_log.end()){
+		return benchmark_stats_t {};
+	}
+	else{
+		const auto result = *it;
+		stats_log.erase(it);
+		return result;
+	}
+}
+
+QUARK_TEST("", "take_benchmark_stats()", "Results in another order than the expressions ran", "Each result gets its own stats"){
+	std::vector<benchmark_stats_t> stats_log = {
+		benchmark_stats_t { 10, 100, 150, 110, 105, 140, 150, 10, 5, 0 },
+		benchmark_stats_t { 10, 200, 250, 210, 205, 240, 250, 10, 5, 0 }
+	};
+	QUARK_VERIFY(take_benchmark_stats(stats_log, 200).median == 205);
+	QUARK_VERIFY(take_benchmark_stats(stats_log, 100).median == 105);
+	QUARK_VERIFY(stats_log.empty());
+}
+
+QUARK_TEST("", "take_benchmark_stats()", "Hand-built and summed results", "Empty stats"){
+	std::vector<benchmark_stats_t> stats_log = {
+		benchmark_stats_t { 10, 100, 150, 110, 105, 140, 150, 10, 5, 0 },
+		benchmark_stats_t { 10, 200, 250, 210, 205, 240, 250, 10, 5, 0 }
+	};
+	QUARK_VERIFY(take_benchmark_stats(stats_log, 404) == benchmark_stats_t {});
+	QUARK_VERIFY(take_benchmark_stats(stats_log, 100 + 200) == benchmark_stats_t {});
+	QUARK_VERIFY(stats_log.size() == 2);
 }
 
 
@@ -603,8 +1615,20 @@ runtime_value_t concat_strings(value_backend_t& backend, const runtime_value_t&
 	QUARK_ASSERT(lhs.check_invariant());
 	QUARK_ASSERT(rhs.check_invariant());
 
-	const auto result = from_runtime_string2(backend, lhs) + from_runtime_string2(backend, rhs);
-	return to_runtime_string2(backend, result);
+	const auto lhs_size = get_vec_string_size(lhs);
+	const auto rhs_size = get_vec_string_size(rhs);
+	const auto size2 = lhs_size + rhs_size;
+
+	//	Copy straight into a single allocation, no temporary std::strings.
+	const auto allocation_count = size_to_allocation_blocks(size2);
+	auto result = alloc_vector_carray(backend.heap, allocation_count, size2, type_t::make_string());
+	auto dest_ptr = result.vector_carray_ptr->get_element_ptr();
+	std::fill(dest_ptr, dest_ptr + allocation_count, make_runtime_int(0));
+
+	auto dest_chars = reinterpret_cast<char*>(dest_ptr);
+	std::memcpy(dest_chars, lhs.vector_carray_ptr->get_element_ptr(), lhs_size);
+	std::memcpy(dest_chars + lhs_size, rhs.vector_carray_ptr->get_element_ptr(), rhs_size);
+	return result;
 }
 
 runtime_value_t concat_vector_carray(value_backend_t& backend, const type_t& type, const runtime_value_t& lhs, const runtime_value_t& rhs){
@@ -11,6 +11,7 @@
 
 #include "value_backend.h"
 #include "value_thunking.h"
+#include "compiler_basics.h"
 
 namespace floyd {
 
@@ -21,6 +22,13 @@ VECTOR_CARRAY_T* unpack_vector_carray_arg(const value_backend_t& backend, runtim
 DICT_CPPMAP_T* unpack_dict_cppmap_arg(const value_backend_t& backend, runtime_value_t arg, runtime_type_t arg_type);
 
 
+//	Returns -1, 0 or +1. Works directly on the runtime values, no value_t are created.
+int compare_values_true_deep(const value_backend_t& backend, runtime_value_t lhs, runtime_value_t rhs, const type_t& type);
+int compare_strings(runtime_value_t lhs, runtime_value_t rhs);
+
+//	Converts a compare result to the result of comparison operator op, an expression_type. Returns 0 or 1.
+int apply_compare_op(int64_t op, int compare_result);
+
 int compare_values(value_backend_t& backend, int64_t op, const runtime_type_t type, runtime_value_t lhs, runtime_value_t rhs);
 
 
@@ -35,6 +43,36 @@ inline const runtime_value_t update__vector_hamt_nonpod(value_backend_t& backend
 
 const runtime_value_t update__dict_cppmap(value_backend_t& backend, runtime_value_t coll_value, runtime_type_t coll_type, runtime_value_t key_value, runtime_value_t value);
 const runtime_value_t update__dict_hamt(value_backend_t& backend, runtime_value_t coll_value, runtime_type_t coll_type, runtime_value_t key_value, runtime_value_t value);
+const runtime_value_t update__dict_hashtable(value_backend_t& backend, runtime_value_t coll_value, runtime_type_t coll_type, runtime_value_t key_value, runtime_value_t value);
+
+
+
+/*
+	In-place variants, for "a = push_back(a, x)" and "a = update(a, key, x)".
+
+	They take over the caller's reference to the collection and to the new element / value and return a
+	collection with RC 1. When the input collection is uniquely referenced it is mutated and returned,
+	otherwise it is copied and the caller's reference to it is released. The key is only borrowed.
+
+	push_back() grows the allocation geometrically so a loop of N push_back() is O(N), not O(N^2).
+*/
+runtime_value_t push_back_inplace__string(value_backend_t& backend, runtime_value_t s, runtime_value_t element);
+runtime_value_t push_back_inplace__vector_carray(value_backend_t& backend, runtime_value_t coll_value, runtime_type_t coll_type, runtime_value_t element);
+runtime_value_t update_inplace__vector_carray(value_backend_t& backend, runtime_value_t coll_value, runtime_type_t coll_type, runtime_value_t index, runtime_value_t value);
+runtime_value_t update_inplace__dict_cppmap(value_backend_t& backend, runtime_value_t coll_value, runtime_type_t coll_type, runtime_value_t key_value, runtime_value_t value);
+runtime_value_t update_inplace__dict_hashtable(value_backend_t& backend, runtime_value_t coll_value, runtime_type_t coll_type, runtime_value_t key_value, runtime_value_t value);
+
+/*
+	"a = a + b" for strings and carray vectors: takes over the caller's reference to lhs, rhs is borrowed.
+	Appends rhs in place when lhs is unique and has spare capacity, otherwise copies into an allocation
+	with room to grow.
+
+	reserve_string_inplace() returns s with room for at least capacity characters. It's used by chains
+	like "a + b + c + d" to make one allocation of the final size and append every operand to it.
+*/
+runtime_value_t concat_inplace__string(value_backend_t& backend, runtime_value_t lhs, runtime_value_t rhs);
+runtime_value_t concat_inplace__vector_carray(value_backend_t& backend, const type_t& type, runtime_value_t lhs, runtime_value_t rhs);
+runtime_value_t reserve_string_inplace(value_backend_t& backend, runtime_value_t s, uint64_t capacity);
 
 
 
@@ -66,10 +104,31 @@ runtime_value_t get_keys__cppmap_hamt(value_backend_t& backend, runtime_value_t
 runtime_value_t get_keys__hamtmap_carray(value_backend_t& backend, runtime_value_t dict_value, runtime_type_t dict_type);
 runtime_value_t get_keys__hamtmap_hamt(value_backend_t& backend, runtime_value_t dict_value, runtime_type_t dict_type);
 
+runtime_value_t get_keys__hashtable_carray(value_backend_t& backend, runtime_value_t dict_value, runtime_type_t dict_type);
+runtime_value_t get_keys__hashtable_hamt(value_backend_t& backend, runtime_value_t dict_value, runtime_type_t dict_type);
+
+
+//	Sampling policy of the benchmark expression. All backends use these: sample the body at least
+//	k_min_run_count times, then keep sampling until k_max_run_time_ns has passed or
+//	k_max_samples_count samples have been taken.
+const int64_t k_max_samples_count = 10000;
+const int64_t k_max_run_time_ns = 3000000000;
+const int64_t k_min_run_count = 2;
+
+//	Monotonic-ish time in nanoseconds, used to time benchmark samples.
+int64_t get_profile_time();
 
 //	Use subset of samples -- assume first sample is warm-up.
+benchmark_stats_t analyse_samples_stats(const int64_t* samples, int64_t count);
+
+//	Returns the fastest sample, see analyse_samples_stats().
 int64_t analyse_samples(const int64_t* samples, int64_t count);
 
+//	Removes and returns the stats of the benchmark expression whose result was dur, else returns empty stats.
+//	A benchmark-def can build a result by hand or from several benchmark expressions, so results are matched
+//	to the stats log on dur == stats.min, never by position.
+benchmark_stats_t take_benchmark_stats(std::vector<benchmark_stats_t>& stats_log, int64_t dur);
+
 
 
 runtime_value_t concat_strings(value_backend_t& backend, const runtime_value_t& lhs, const runtime_value_t& rhs);
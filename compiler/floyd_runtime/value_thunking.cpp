@@ -79,7 +79,7 @@ std::string from_runtime_string2(const value_backend_t& backend, runtime_value_t
 	//	Read 8 characters at a time.
 	size_t char_pos = 0;
 	const auto begin0 = encoded_value.vector_carray_ptr->begin();
-	const auto end0 = encoded_value.vector_carray_ptr->end();
+	const auto end0 = begin0 + size_to_allocation_blocks(size);
 	for(auto it = begin0 ; it != end0 ; it++){
 		const size_t copy_chars = std::min(size - char_pos, (size_t)8);
 		const uint64_t element = it->int_value;
@@ -276,6 +276,19 @@ static runtime_value_t to_runtime_dict(value_backend_t& backend, const dict_t& e
 		}
 		return result;
 	}
+	else if(is_dict_hashtable(backend.types, backend.config, type)){
+		const auto& v0 = value.get_dict_value();
+
+		auto result = alloc_dict_hashtable(backend.heap, type);
+
+		auto& m = result.dict_hashtable_ptr->get_map_mut();
+		m.reserve(v0.size());
+		for(const auto& e: v0){
+			const auto a = to_runtime_value2(backend, e.second);
+			m.insert_or_assign(e.first, a);
+		}
+		return result;
+	}
 	else{
 		QUARK_ASSERT(false);
 		throw std::exception();
@@ -315,6 +328,18 @@ static value_t from_runtime_dict(const value_backend_t& backend, const runtime_v
 		const auto val = value_t::make_dict_value(backend.types, value_type, values);
 		return val;
 	}
+	else if(is_dict_hashtable(backend.types, backend.config, type)){
+		const auto value_type = type_peek.get_dict_value_type(backend.types);
+		const auto dict = encoded_value.dict_hashtable_ptr;
+
+		std::map<std::string, value_t> values;
+		for(const auto& e: dict->get_map()){
+			const auto value = from_runtime_value2(backend, e.second, value_type);
+			values.insert({ e.first, value} );
+		}
+		const auto val = value_t::make_dict_value(backend.types, value_type, values);
+		return val;
+	}
 	else{
 		QUARK_ASSERT(false);
 		throw std::exception();
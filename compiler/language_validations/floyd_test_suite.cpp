@@ -3081,6 +3081,60 @@ FLOYD_LANG_PROOF("Floyd test suite", "vector [string] push_back()", "", ""){
 	)");
 }
 
+FLOYD_LANG_PROOF("Floyd test suite", "vector [string] push_back()", "a = push_back(a, x) while b shares a", "b is unchanged"){
+	ut_run_closed_nolib(QUARK_POS, R"(
+
+		mutable [string] a = ["one"]
+		a = push_back(a, "two")
+		let b = a
+		a = push_back(a, "three")
+		a = update(a, 0, "ONE")
+		assert(a == ["ONE", "two", "three"])
+		assert(b == ["one", "two"])
+
+	)");
+}
+
+FLOYD_LANG_PROOF("Floyd test suite", "vector [int] push_back()", "a = push_back(a, x) while b shares a", "b is unchanged"){
+	ut_run_closed_nolib(QUARK_POS, R"(
+
+		mutable [int] a = [1]
+		a = push_back(a, 2)
+		let b = a
+		a = push_back(a, 3)
+		a = update(a, 0, 10)
+		assert(a == [10, 2, 3])
+		assert(b == [1, 2])
+
+	)");
+}
+
+FLOYD_LANG_PROOF("Floyd test suite", "string push_back()", "a = push_back(a, x) while b shares a", "b is unchanged"){
+	ut_run_closed_nolib(QUARK_POS, R"(
+
+		mutable string a = "ab"
+		a = push_back(a, 99)
+		let b = a
+		a = push_back(a, 100)
+		assert(a == "abcd")
+		assert(b == "abc")
+
+	)");
+}
+
+FLOYD_LANG_PROOF("Floyd test suite", "dict [string] update()", "a = update(a, k, x) while b shares a", "b is unchanged"){
+	ut_run_closed_nolib(QUARK_POS, R"(
+
+		mutable [string: string] a = { "one": "1" }
+		let b = a
+		a = update(a, "one", "I")
+		a = update(a, "two", "II")
+		assert(a == { "one": "I", "two": "II" })
+		assert(b == { "one": "1" })
+
+	)");
+}
+
 FLOYD_LANG_PROOF("Floyd test suite", "vector [string] subset()", "", ""){
 	ut_run_closed_nolib(QUARK_POS, R"(		assert(subset(["one", "two", "three"], 0, 3) == ["one", "two", "three"])		)");
 }
@@ -5503,6 +5557,35 @@ FLOYD_LANG_PROOF("Floyd test suite", "map()", "context struct", ""){
 
 	)");
 }
+
+FLOYD_LANG_PROOF("Floyd test suite", "map()", "Big vector, split into parallel tasks", "Results are in order"){
+	ut_run_closed_nolib(QUARK_POS, R"(
+
+		func [int] make_input(int count){
+			mutable [int] acc = []
+			for(i in 0 ..< count){
+				acc = push_back(acc, i)
+			}
+			return acc
+		}
+
+		func string f(int v, int context){
+			mutable sum = 0
+			for(i in 0 ..< 100){
+				sum = sum + i
+			}
+			return to_string(v * context + sum - 4950)
+		}
+
+		let a = make_input(20000)
+		let r = map(a, f, 3)
+		assert(size(r) == 20000)
+		for(i in 0 ..< 20000){
+			assert(r[i] == to_string(i * 3))
+		}
+
+	)");
+}
 //??? make sure f() can't be impure!
 
 /*
@@ -5591,6 +5674,36 @@ FLOYD_LANG_PROOF("Floyd test suite", "map_dag()", "complex", ""){
 	)");
 }
 
+FLOYD_LANG_PROOF("Floyd test suite", "map_dag()", "Big tree, independent nodes run in parallel", "Each node sees all its inputs"){
+	ut_run_closed_nolib(QUARK_POS, R"(
+
+		//	Binary tree: node i feeds into node (i - 1) / 2. Each node returns the size of its sub-tree.
+		func [int] make_parents(int count){
+			mutable [int] acc = [ -1 ]
+			for(i in 1 ..< count){
+				acc = push_back(acc, (i - 1) / 2)
+			}
+			return acc
+		}
+
+		func int f2(int acc, int element, int context){
+			return acc + element
+		}
+
+		func int f(int v, [int] inputs, int context){
+			return reduce(inputs, 1, f2, context)
+		}
+
+		let parents = make_parents(10000)
+		let r = map_dag(parents, parents, f, 0)
+		assert(size(r) == 10000)
+		assert(r[0] == 10000)
+		assert(r[1] + r[2] + 1 == 10000)
+		assert(r[9999] == 1)
+
+	)");
+}
+
 
 
 //////////////////////////////////////////		HIGHER-ORDER INTRINSICS - reduce()
@@ -5754,6 +5867,35 @@ FLOYD_LANG_PROOF("Floyd test suite", "stable_sort()", "[string]", ""){
 	);
 }
 
+FLOYD_LANG_PROOF("Floyd test suite", "stable_sort()", "Big [struct], sorted in parallel", "Equal keys keep their order"){
+	ut_run_closed_nolib(QUARK_POS, R"(
+
+		struct item_t {
+			int key
+			int index
+			string name
+		}
+
+		func bool less_f(item_t left, item_t right, string context){
+			return left.key < right.key
+		}
+
+		mutable [item_t] items = []
+		for(i in 0 ..< 30000){
+			items = push_back(items, item_t((i * 7919) % 97, i, to_string(i)))
+		}
+
+		let a = stable_sort(items, less_f, "")
+		assert(size(a) == 30000)
+		for(i in 1 ..< 30000){
+			let prev = a[i - 1]
+			let e = a[i]
+			assert(prev.key < e.key || (prev.key == e.key && prev.index < e.index))
+		}
+
+	)");
+}
+
 
 #endif	//	RUN_LANG_INTRINSICS_TESTS
 
@@ -6998,6 +7140,137 @@ FLOYD_LANG_PROOF("software-system-def", "run two CONNECTED processes", "", ""){
 	ut_run_closed_nolib(QUARK_POS, program);
 }
 
+FLOYD_LANG_PROOF("software-system-def", "processes on two clock busses", "Sends on the main clock bus", "Receiver runs inline, before the sender continues"){
+	const auto program = R"(
+
+		software-system-def {
+			"name": "My Arcade Game",
+			"desc": "Space shooter for mobile devices, with connection to a server.",
+			"people": {},
+			"connections": [],
+			"containers": [
+				"iphone app"
+			]
+		}
+
+		container-def {
+			"name": "iphone app",
+			"tech": "Swift, iOS, Xcode, Open GL",
+			"desc": "Mobile shooter game for iOS.",
+			"clocks": {
+				"main": {
+					"a": "my_gui",
+					"c": "my_controller"
+				},
+				"audio": {
+					"b": "my_audio"
+				}
+			}
+		}
+
+
+		////////////////////////////////	my_gui -- process, sends synchronously to my_controller
+
+		struct my_gui_state_t {
+			int _count
+		}
+
+		func my_gui_state_t my_gui__init() impure {
+			send("a", "go")
+			return my_gui_state_t(0)
+		}
+
+		func my_gui_state_t my_gui(my_gui_state_t state, json message) impure {
+			if(message == "go"){
+				print("my_gui: go")
+				send("c", "1")
+				print("my_gui: sent 1")
+				send("c", "2")
+				print("my_gui: sent 2")
+				return update(state, _count, state._count + 1)
+			}
+			else if(message == "done"){
+				print("my_gui: done")
+				send("c", "stop")
+				send("a", "stop")
+				return update(state, _count, state._count + 10)
+			}
+			else{
+				assert(false)
+				return state
+			}
+		}
+
+
+		////////////////////////////////	my_controller -- process, forwards to the audio clock bus
+
+		struct my_controller_state_t {
+			int _sum
+		}
+
+		func my_controller_state_t my_controller__init() impure {
+			return my_controller_state_t(0)
+		}
+
+		func my_controller_state_t my_controller(my_controller_state_t state, json message) impure {
+			if(message == "1"){
+				print("my_controller: 1")
+				send("b", message)
+				return update(state, _sum, state._sum + 1)
+			}
+			else if(message == "2"){
+				print("my_controller: 2")
+				send("b", message)
+				return update(state, _sum, state._sum + 2)
+			}
+			else{
+				assert(false)
+				return state
+			}
+		}
+
+
+		////////////////////////////////	my_audio -- process, doesn't print: it runs on its own thread
+
+		struct my_audio_state_t {
+			int _audio
+		}
+
+		func my_audio_state_t my_audio__init() impure {
+			return my_audio_state_t(0)
+		}
+
+		func my_audio_state_t my_audio(my_audio_state_t state, json message) impure {
+			if(message == "1"){
+				return update(state, _audio, state._audio + 1)
+			}
+			else if(message == "2"){
+				send("a", "done")
+				send("b", "stop")
+				return update(state, _audio, state._audio + 2)
+			}
+			else{
+				assert(false)
+				return state
+			}
+		}
+
+	)";
+
+	ut_verify_printout_nolib(
+		QUARK_POS,
+		program,
+		{
+			"my_gui: go",
+			"my_controller: 1",
+			"my_gui: sent 1",
+			"my_controller: 2",
+			"my_gui: sent 2",
+			"my_gui: done"
+		}
+	);
+}
+
 #endif	//	RUN_CONTAINER_TESTS
 
 
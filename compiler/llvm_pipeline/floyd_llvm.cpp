@@ -92,6 +92,34 @@ QUARK_TEST("", "run_benchmarks()", "", ""){
 	QUARK_VERIFY(true);
 }
 
+QUARK_TEST("", "run_benchmarks()", "Benchmark makes hashtable dicts, one from a global", "Arena reset after it keeps results and globals intact"){
+	auto settings = make_default_compiler_settings();
+	settings.config.dict_backend_mode = dict_backend::hashtable;
+
+	const auto result = run_benchmarks(
+		R"(
+
+			let g = { "a": 1 }
+
+			benchmark-def "dicts" {
+				let d = update(g, "b", 2)
+				let e = { "x": [ 1, 2 ], "y": [ 3 ] }
+				return [ benchmark_result_t(size(d) + size(e), to_json(d)) ]
+			}
+			benchmark-def "global" {
+				return [ benchmark_result_t(g["a"], to_json(g)) ]
+			}
+		)",
+		"myfile.floyd",
+		compilation_unit_mode::k_no_core_lib,
+		settings,
+		{ "dicts", "global" }
+	);
+	QUARK_VERIFY(result.size() == 2);
+	QUARK_VERIFY(result[0].result == (benchmark_result_t { 4, json_t::make_object({ { "a", 1 }, { "b", 2 } }) }));
+	QUARK_VERIFY(result[1].result == (benchmark_result_t { 1, json_t::make_object({ { "a", 1 } }) }));
+}
+
 
 }	//	namespace floyd
 
@@ -127,4 +155,93 @@ QUARK_TEST("", "From JSON: Simple function call, call print() from floyd_runtime
 	QUARK_ASSERT(ee->_print_output == std::vector<std::string>{"5"});
 }
 
+QUARK_TEST("", "run_program()", "Worker pool: two clock busses send to a third, nobody sends stop", "Ends when no messages are left"){
+	const auto cu = floyd::make_compilation_unit_nolib(
+		R"(
+
+			software-system-def {
+				"name": "Fan-in",
+				"desc": "",
+				"people": {},
+				"connections": [],
+				"containers": [ "server" ]
+			}
+
+			container-def {
+				"name": "server",
+				"tech": "",
+				"desc": "",
+				"clocks": {
+					"left": {
+						"l": "left"
+					},
+					"right": {
+						"r": "right"
+					},
+					"sink": {
+						"s": "sink"
+					}
+				}
+			}
+
+			struct producer_state_t {
+				int _sent
+			}
+
+			func producer_state_t left__init() impure {
+				send("l", "go")
+				return producer_state_t(0)
+			}
+
+			func producer_state_t left(producer_state_t state, json message) impure {
+				for(i in 0 ..< 50){
+					send("s", "left")
+				}
+				return producer_state_t(state._sent + 50)
+			}
+
+			func producer_state_t right__init() impure {
+				send("r", "go")
+				return producer_state_t(0)
+			}
+
+			func producer_state_t right(producer_state_t state, json message) impure {
+				for(i in 0 ..< 50){
+					send("s", "right")
+				}
+				return producer_state_t(state._sent + 50)
+			}
+
+			struct sink_state_t {
+				int _count
+			}
+
+			func sink_state_t sink__init() impure {
+				return sink_state_t(0)
+			}
+
+			func sink_state_t sink(sink_state_t state, json message) impure {
+				let count = state._count + 1
+				if(count == 100){
+					print("sink got " + to_string(count))
+				}
+				return sink_state_t(count)
+			}
+
+		)",
+		"myfile.floyd"
+	);
+	const auto sem_ast = compile_to_sematic_ast__errors(cu);
+
+	auto settings = floyd::make_default_compiler_settings();
+	settings.config.process_scheduling_mode = floyd::process_scheduling::worker_pool;
+	floyd::llvm_instance_t instance;
+	auto program = generate_llvm_ir_program(instance, sem_ast, "myfile.floyd", settings);
+	auto ee = init_llvm_jit(*program);
+
+	//	Returns once the sink has handled every message, even though all three processes still run.
+	run_program(*ee, {});
+	QUARK_VERIFY(ee->_print_output == std::vector<std::string>{ "sink got 100" });
+}
+
 
@@ -27,6 +27,7 @@ static const bool k_trace_pass_io = false;
 
 #include "quark.h"
 #include "floyd_runtime.h"
+#include "value_features.h"
 
 
 //#include <llvm/ADT/APInt.h>
@@ -717,11 +718,11 @@ static llvm::Value* generate_lookup_element_expression(llvm_function_generator_t
 
 		return result_reg;
 	}
-	else if(is_dict_cppmap(types, gen_acc.gen.settings.config, parent_type) || is_dict_hamt(types, gen_acc.gen.settings.config, parent_type)){
+	else if(peek2(types, parent_type).is_dict()){
 		QUARK_ASSERT(key_type_peek.is_string());
 
 		const auto element_type0 = peek2(types, parent_type).get_dict_value_type(types);
-		const auto dict_mode = is_dict_hamt(types, gen_acc.gen.settings.config, parent_type) ? dict_backend::hamt : dict_backend::cppmap;
+		const auto dict_mode = get_dict_backend(types, gen_acc.gen.settings.config, parent_type);
 		auto element_value_uint64_reg = generate_lookup_dict(gen_acc, *parent_reg, parent_type, *key_reg, dict_mode);
 		auto result_reg = generate_cast_from_runtime_value(gen_acc.gen, *element_value_uint64_reg, element_type0);
 
@@ -739,6 +740,81 @@ static llvm::Value* generate_lookup_element_expression(llvm_function_generator_t
 }
 
 
+/*
+	Returns the operands of a left-nested chain of string / vector "+": ((a + b) + c) + d gives { a, b, c, d }.
+	Returns an empty vector if e isn't a concatenation.
+*/
+static std::vector<const expression_t*> get_concat_operands(llvm_function_generator_t& gen_acc, const expression_t& e){
+	const auto& types = gen_acc.gen.type_lookup.state.types;
+
+	const auto arithmetic = std::get_if<expression_t::arithmetic_t>(&e._expression_variant);
+	if(arithmetic == nullptr || arithmetic->op != expression_type::k_arithmetic_add){
+		return {};
+	}
+	const auto type_peek = peek2(types, get_expr_output_type(gen_acc.gen, *arithmetic->lhs));
+	if(type_peek.is_string() == false && type_peek.is_vector() == false){
+		return {};
+	}
+
+	auto result = get_concat_operands(gen_acc, *arithmetic->lhs);
+	if(result.empty()){
+		result.push_back(arithmetic->lhs.get());
+	}
+	result.push_back(arithmetic->rhs.get());
+	return result;
+}
+
+//	Appends each of the operand_regs to acc_reg and releases them. Takes over acc_reg, returns the result.
+static llvm::Value* generate_concat_inplace(llvm_function_generator_t& gen_acc, const type_t& type, llvm::Value& acc_reg, const std::vector<llvm::Value*>& operand_regs){
+	QUARK_ASSERT(gen_acc.check_invariant());
+
+	auto& builder = gen_acc.get_builder();
+
+	llvm::Value* acc = &acc_reg;
+	for(const auto& e: operand_regs){
+		std::vector<llvm::Value*> args2 = {
+			gen_acc.get_callers_fcp(),
+			generate_itype_constant(gen_acc.gen, type),
+			acc,
+			e
+		};
+		acc = builder.CreateCall(gen_acc.gen.runtime_functions.floydrt_concatunate_vectors_inplace.llvm_codegen_f, args2, "");
+		generate_release(gen_acc, *e, type);
+	}
+	return acc;
+}
+
+/*
+	"a + b + c + d" for strings: sums the operand sizes and appends them all to one allocation of the final
+	size, instead of making (and throwing away) a new string for every "+".
+*/
+static llvm::Value* generate_string_concat_chain(llvm_function_generator_t& gen_acc, const std::vector<const expression_t*>& operands){
+	QUARK_ASSERT(gen_acc.check_invariant());
+	QUARK_ASSERT(operands.size() > 2);
+
+	auto& builder = gen_acc.get_builder();
+	const auto string_type = type_t::make_string();
+	const auto& size_function_type = gen_acc.gen.intrinsic_signatures.size._function_type;
+
+	std::vector<llvm::Value*> operand_regs;
+	for(const auto& e: operands){
+		operand_regs.push_back(generate_expression(gen_acc, *e));
+	}
+
+	llvm::Value* total_size_reg = builder.getInt64(0);
+	for(const auto& e: operand_regs){
+		auto size_reg = generate_instrinsic_size(gen_acc, size_function_type, *e, string_type);
+		total_size_reg = builder.CreateAdd(total_size_reg, size_reg, "concat_size");
+	}
+
+	auto acc_reg = builder.CreateCall(
+		gen_acc.gen.runtime_functions.floydrt_reserve_string.llvm_codegen_f,
+		{ gen_acc.get_callers_fcp(), operand_regs[0], total_size_reg },
+		""
+	);
+	return generate_concat_inplace(gen_acc, string_type, *acc_reg, std::vector<llvm::Value*>(operand_regs.begin() + 1, operand_regs.end()));
+}
+
 static llvm::Value* generate_arithmetic_expression(llvm_function_generator_t& gen_acc, expression_type op, const expression_t& e, const expression_t::arithmetic_t& details){
 	QUARK_ASSERT(gen_acc.check_invariant());
 	QUARK_ASSERT(e.check_invariant());
@@ -747,6 +823,13 @@ static llvm::Value* generate_arithmetic_expression(llvm_function_generator_t& ge
 	const auto type = get_expr_output_type(gen_acc.gen, *details.lhs);
 	const auto type_peek = peek2(types, type);
 
+	if(type_peek.is_string()){
+		const auto operands = get_concat_operands(gen_acc, e);
+		if(operands.size() > 2){
+			return generate_string_concat_chain(gen_acc, operands);
+		}
+	}
+
 	auto lhs_temp = generate_expression(gen_acc, *details.lhs);
 	auto rhs_temp = generate_expression(gen_acc, *details.rhs);
 
@@ -857,6 +940,20 @@ static llvm::Value* generate_compare_values(llvm_function_generator_t& gen_acc,
 
 	llvm::Value* op_reg = llvm::ConstantInt::get(builder.getInt64Ty(), static_cast<int64_t>(op));
 
+	//	Strings have a specialized comparator that doesn't need the type.
+	if(peek2(gen_acc.gen.type_lookup.state.types, type).is_string()){
+		std::vector<llvm::Value*> args = {
+			gen_acc.get_callers_fcp(),
+			op_reg,
+			generate_cast_to_runtime_value(gen_acc.gen, lhs_reg, type),
+			generate_cast_to_runtime_value(gen_acc.gen, rhs_reg, type)
+		};
+		auto result = builder.CreateCall(gen_acc.gen.runtime_functions.floydrt_compare_strings.llvm_codegen_f, args, "");
+
+		QUARK_ASSERT(gen_acc.check_invariant());
+		return result;
+	}
+
 	std::vector<llvm::Value*> args = {
 		gen_acc.get_callers_fcp(),
 		op_reg,
@@ -1495,7 +1592,7 @@ static llvm::Value* generate_construct_dict(llvm_function_generator_t& gen_acc,
 	for(int element_index = 0 ; element_index < count ; element_index++){
 		llvm::Value* key0_reg = generate_expression(gen_acc, details.elements[element_index * 2 + 0]);
 		llvm::Value* element0_reg = generate_expression(gen_acc, details.elements[element_index * 2 + 1]);
-		generate_store_dict_mutable(gen_acc, *dict_acc_ptr_reg, construct_type, *key0_reg, *element0_reg, gen_acc.gen.settings.config.dict_backend_mode);
+		generate_store_dict_mutable(gen_acc, *dict_acc_ptr_reg, construct_type, *key0_reg, *element0_reg, get_dict_backend(types, gen_acc.gen.settings.config, construct_type));
 		generate_release(gen_acc, *key0_reg, type_t::make_string());
 	}
 	return dict_acc_ptr_reg;
@@ -1680,10 +1777,6 @@ end_bb:
 	store double 0.0, double* %2
 */
 
-static int64_t k_max_samples_count = 10000;
-static int64_t k_max_run_time_ns = 3000000000;
-static int64_t k_min_run_count = 2;
-
 static llvm::Value* generate_benchmark_expression(llvm_function_generator_t& gen_acc, const expression_t& e, const expression_t::benchmark_expr_t& details){
 	QUARK_ASSERT(gen_acc.check_invariant());
 	QUARK_ASSERT(e.check_invariant());
@@ -1887,9 +1980,81 @@ static llvm::Value* generate_expression(llvm_function_generator_t& gen_acc, cons
 
 
 
+//	Is e a load of the variable at address?
+static bool is_load_of(const expression_t& e, const symbol_pos_t& address){
+	const auto load2 = std::get_if<expression_t::load2_t>(&e._expression_variant);
+	return load2 != nullptr && load2->address == address;
+}
+
+/*
+	"a = push_back(a, x)", "a = update(a, key, x)" and "a = a + x": moves a into the intrinsic / runtime
+	function instead of retaining it, so it can mutate a in place when a is the only reference. The call
+	returns the collection to store back into a. Returns false if the statement doesn't match.
+
+	The other arguments are evaluated before a is moved out of the variable.
+*/
+static bool generate_assign2_inplace(llvm_function_generator_t& gen_acc, const statement_t::assign2_t& s){
+	QUARK_ASSERT(gen_acc.check_invariant());
+
+	const auto& types = gen_acc.gen.type_lookup.state.types;
+	const auto& config = gen_acc.gen.settings.config;
+	const auto& signs = gen_acc.gen.intrinsic_signatures;
+
+	auto& builder = gen_acc.get_builder();
+
+	const auto concat_operands = get_concat_operands(gen_acc, s._expression);
+	if(concat_operands.empty() == false && is_load_of(*concat_operands[0], s._dest_variable)){
+		auto dest = find_symbol(gen_acc.gen, s._dest_variable);
+		const auto type = dest.symbol.get_value_type();
+
+		std::vector<llvm::Value*> operand_regs;
+		for(auto it = concat_operands.begin() + 1 ; it != concat_operands.end() ; it++){
+			operand_regs.push_back(generate_expression(gen_acc, **it));
+		}
+		auto collection_reg = builder.CreateLoad(dest.value_ptr);
+		auto result_reg = generate_concat_inplace(gen_acc, type, *collection_reg, operand_regs);
+		builder.CreateStore(result_reg, dest.value_ptr);
+		return true;
+	}
+
+	const auto intrinsic = std::get_if<expression_t::intrinsic_t>(&s._expression._expression_variant);
+	if(intrinsic == nullptr || intrinsic->args.empty() || is_load_of(intrinsic->args[0], s._dest_variable) == false){
+		return false;
+	}
+
+	auto dest = find_symbol(gen_acc.gen, s._dest_variable);
+	const auto type = dest.symbol.get_value_type();
+
+	if(intrinsic->call_name == get_intrinsic_opcode(signs.push_back) && has_intrinsic_push_back_inplace(config, types, type)){
+		auto element_reg = generate_expression(gen_acc, intrinsic->args[1]);
+		auto collection_reg = builder.CreateLoad(dest.value_ptr);
+		auto result_reg = generate_instrinsic_push_back_inplace(gen_acc, *collection_reg, type, *element_reg);
+		builder.CreateStore(result_reg, dest.value_ptr);
+		return true;
+	}
+	else if(intrinsic->call_name == get_intrinsic_opcode(signs.update) && has_intrinsic_update_inplace(config, types, type)){
+		const auto key_type = get_expr_output_type(gen_acc.gen, intrinsic->args[1]);
+		auto key_reg = generate_expression(gen_acc, intrinsic->args[1]);
+		auto value_reg = generate_expression(gen_acc, intrinsic->args[2]);
+		auto collection_reg = builder.CreateLoad(dest.value_ptr);
+		auto result_reg = generate_instrinsic_update_inplace(gen_acc, *collection_reg, type, *key_reg, *value_reg);
+		builder.CreateStore(result_reg, dest.value_ptr);
+		generate_release(gen_acc, *key_reg, key_type);
+		return true;
+	}
+	else{
+		return false;
+	}
+}
+
 static void generate_assign2_statement(llvm_function_generator_t& gen_acc, const statement_t::assign2_t& s){
 	QUARK_ASSERT(gen_acc.check_invariant());
 
+	if(generate_assign2_inplace(gen_acc, s)){
+		QUARK_ASSERT(gen_acc.check_invariant());
+		return;
+	}
+
 	const auto& types = gen_acc.gen.type_lookup.state.types;
 	llvm::Value* value = generate_expression(gen_acc, s._expression);
 
@@ -2646,9 +2811,12 @@ static std::unique_ptr<llvm_ir_program_t> generate_llvm_ir_program_internal(llvm
 	auto result0 = generate_module(instance, module_name, ast, settings);
 	auto module = std::move(result0.module);
 
+	std::map<std::string, rc_elision_stats_t> rc_elision_stats;
 	if(settings.optimization_level == eoptimization_level::g_no_optimizations_enable_debugging){
 	}
 	else{
+		//	Needs to run before the RC helpers are inlined.
+		rc_elision_stats = elide_redundant_rc_mutating(*module);
 		optimize_module_mutating(instance, module, settings);
 	}
 //	write_object_file(module, *result0.target_machine);
@@ -2659,6 +2827,7 @@ static std::unique_ptr<llvm_ir_program_t> generate_llvm_ir_program_internal(llvm
 
 	result->container_def = ast0._tree._container_def;
 	result->software_system = ast0._tree._software_system;
+	result->rc_elision_stats = rc_elision_stats;
 	return result;
 }
 
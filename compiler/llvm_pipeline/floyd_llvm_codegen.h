@@ -14,6 +14,7 @@
 
 #include "floyd_llvm_helpers.h"
 #include "floyd_llvm_types.h"
+#include "floyd_llvm_rc_elision.h"
 
 #include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/Module.h>
@@ -22,6 +23,7 @@
 //#include "llvm/Target/TargetMachine.h"
 
 #include <string>
+#include <map>
 
 namespace floyd {
 	struct semantic_ast_t;
@@ -61,6 +63,9 @@ struct llvm_ir_program_t {
 	container_t container_def;
 	software_system_t software_system;
 	compiler_settings_t settings;
+
+	//	Retain/release pairs removed per function, see floyd_llvm_rc_elision.h. Empty at -g.
+	std::map<std::string, rc_elision_stats_t> rc_elision_stats;
 };
 
 
@@ -12,6 +12,8 @@
 
 #include "llvm/Support/TargetRegistry.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/Host.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/Target/TargetMachine.h"
 #include "llvm/Target/TargetOptions.h"
 
@@ -79,6 +81,38 @@ target_t make_default_target(){
 	return target_t { TargetTriple, TargetMachine };
 }
 
+llvm::CodeGenOpt::Level get_codegen_opt_level(eoptimization_level level){
+	if(level == eoptimization_level::g_no_optimizations_enable_debugging){
+		return llvm::CodeGenOpt::Level::None;
+	}
+	else if(level == eoptimization_level::O1_enable_trivial_optimizations){
+		return llvm::CodeGenOpt::Level::Less;
+	}
+	else if(level == eoptimization_level::O2_enable_default_optimizations){
+		return llvm::CodeGenOpt::Level::Default;
+	}
+	else if(level == eoptimization_level::O3_enable_expensive_optimizations){
+		return llvm::CodeGenOpt::Level::Aggressive;
+	}
+	else{
+		QUARK_ASSERT(false);
+		throw std::exception();
+	}
+}
+
+std::vector<std::string> get_host_cpu_features(){
+	llvm::StringMap<bool> features;
+	std::vector<std::string> result;
+
+	//	Returns false on hosts where LLVM can't query the features -- then we get the CPU's defaults only.
+	if(llvm::sys::getHostCPUFeatures(features)){
+		for(const auto& e: features){
+			result.push_back(std::string(e.second ? "+" : "-") + e.first().str());
+		}
+	}
+	return result;
+}
+
 
 
 
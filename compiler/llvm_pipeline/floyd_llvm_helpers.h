@@ -10,6 +10,7 @@
 #define floyd_llvm_helpers_hpp
 
 #include "value_backend.h"
+#include "compiler_basics.h"
 
 #include <llvm/IR/IRBuilder.h>
 #include "llvm/Target/TargetMachine.h"
@@ -36,6 +37,12 @@ struct target_t {
 
 target_t make_default_target();
 
+//	Maps Floyd's optimization level to the level used by LLVM's machine code generator.
+llvm::CodeGenOpt::Level get_codegen_opt_level(eoptimization_level level);
+
+//	The features of the CPU we are running on, in LLVM's attribute form: "+avx2", "-avx512f" etc.
+std::vector<std::string> get_host_cpu_features();
+
 
 
 //	Must LLVMContext be kept while using the execution engine? Yes!
@@ -17,9 +17,12 @@
 #include "text_parser.h"
 
 #include "utils.h"
+#include "task_scheduler.h"
 
 #include <llvm/ExecutionEngine/ExecutionEngine.h>
 
+#include <chrono>
+
 namespace floyd {
 
 
@@ -70,6 +73,7 @@ POD VS NONPOD
 
 	update_dict_cppmap()		dict<T>		dict<T>		string		T
 	update_dict_hamt()			dict<T>		dict<T>		string		T
+	update_dict_hashtable()		dict<T>		dict<T>		string		T
 */
 
 enum class eresolved_type {
@@ -86,6 +90,9 @@ enum class eresolved_type {
 	k_dict_hamt_pod,
 	k_dict_hamt_nonpod,
 
+	k_dict_hashtable_pod,
+	k_dict_hashtable_nonpod,
+
 	k_json
 };
 
@@ -140,6 +147,15 @@ static bool matches_specialization(const config_t& config, const types_t& types,
 			return wanted == eresolved_type::k_dict_hamt_pod;
 		}
 	}
+	else if(is_dict_hashtable(types, config, arg_type)){
+		const auto is_rc = is_rc_value(peek2(types, arg_type_peek.get_dict_value_type(types)));
+		if(is_rc){
+			return wanted == eresolved_type::k_dict_hashtable_nonpod;
+		}
+		else{
+			return wanted == eresolved_type::k_dict_hashtable_pod;
+		}
+	}
 
 	else if(arg_type_peek.is_json()){
 		return wanted == eresolved_type::k_json;
@@ -241,6 +257,24 @@ static runtime_value_t floyd_llvm_intrinsic__erase(floyd_runtime_t* frp, runtime
 		}
 		return dict2;
 	}
+	else if(is_dict_hashtable(types, r.backend.config, type0)){
+		const auto& dict = *coll_value.dict_hashtable_ptr;
+
+		const auto value_type = peek2(types, type0).get_dict_value_type(types);
+
+		//	Deep copy dict.
+		auto dict2 = alloc_dict_hashtable(r.backend.heap, type0);
+		auto& m = dict2.dict_hashtable_ptr->get_map_mut();
+		m = dict.get_map();
+		m.erase(get_vec_string_view(key_value));
+
+		if(is_rc_value(peek2(types, value_type))){
+			for(const auto& e: m){
+				retain_value(r.backend, e.second, value_type);
+			}
+		}
+		return dict2;
+	}
 	else{
 		QUARK_ASSERT(false);
 		throw std::exception();
@@ -262,11 +296,12 @@ static runtime_value_t floyd_llvm_intrinsic__get_keys(floyd_runtime_t* frp, runt
 	const auto& type0 = lookup_type_ref(r.backend, coll_type);
 	QUARK_ASSERT(peek2(types, type0).is_dict());
 
+	const auto keys_backend = get_vector_backend(types, r.backend.config, make_vector(types, type_t::make_string()));
 	if(is_dict_cppmap(types, r.backend.config, type0)){
-		if(r.backend.config.vector_backend_mode == vector_backend::carray){
+		if(keys_backend == vector_backend::carray){
 			return get_keys__cppmap_carray(r.backend, coll_value, coll_type);
 		}
-		else if(r.backend.config.vector_backend_mode == vector_backend::hamt){
+		else if(keys_backend == vector_backend::hamt){
 			return get_keys__cppmap_hamt(r.backend, coll_value, coll_type);
 		}
 		else{
@@ -275,10 +310,10 @@ static runtime_value_t floyd_llvm_intrinsic__get_keys(floyd_runtime_t* frp, runt
 		}
 	}
 	else if(is_dict_hamt(types, r.backend.config, type0)){
-		if(r.backend.config.vector_backend_mode == vector_backend::carray){
+		if(keys_backend == vector_backend::carray){
 			return get_keys__hamtmap_carray(r.backend, coll_value, coll_type);
 		}
-		else if(r.backend.config.vector_backend_mode == vector_backend::hamt){
+		else if(keys_backend == vector_backend::hamt){
 			return get_keys__hamtmap_hamt(r.backend, coll_value, coll_type);
 		}
 		else{
@@ -286,6 +321,18 @@ static runtime_value_t floyd_llvm_intrinsic__get_keys(floyd_runtime_t* frp, runt
 			throw std::exception();
 		}
 	}
+	else if(is_dict_hashtable(types, r.backend.config, type0)){
+		if(keys_backend == vector_backend::carray){
+			return get_keys__hashtable_carray(r.backend, coll_value, coll_type);
+		}
+		else if(keys_backend == vector_backend::hamt){
+			return get_keys__hashtable_hamt(r.backend, coll_value, coll_type);
+		}
+		else{
+			QUARK_ASSERT(false);
+			throw std::exception();
+		}
+	}
 	else{
 		QUARK_ASSERT(false);
 		throw std::exception();
@@ -324,6 +371,10 @@ static uint32_t floyd_llvm_intrinsic__exists(floyd_runtime_t* frp, runtime_value
 		const auto it = m.find(key_string);
 		return it != nullptr ? 1 : 0;
 	}
+	else if(is_dict_hashtable(types, r.backend.config, type0)){
+		const auto& m = coll_value.dict_hashtable_ptr->get_map();
+		return m.find(get_vec_string_view(value)) != nullptr ? 1 : 0;
+	}
 	else{
 		QUARK_ASSERT(false);
 		throw std::exception();
@@ -417,6 +468,52 @@ static runtime_value_t floyd_llvm_intrinsic__from_json(floyd_runtime_t* frp, JSO
 //??? Use C++ template to generate these two functions.
 typedef runtime_value_t (*MAP_F)(floyd_runtime_t* frp, runtime_value_t e_value, runtime_value_t context_value);
 
+
+//	map() runs small inputs serially. For bigger inputs it first times k_map_probe_count elements on the
+//	calling thread, then splits the remaining elements into tasks on the task scheduler if that is estimated
+//	to take more than k_map_parallel_min_ns.
+static const size_t k_map_parallel_min_count = 64;
+static const size_t k_map_probe_count = 16;
+static const int64_t k_map_parallel_min_ns = 500 * 1000;
+
+//	Aim for tasks of this size, but split into enough tasks to keep all workers busy.
+static const int64_t k_map_task_target_ns = 1000 * 1000;
+static const size_t k_map_tasks_per_worker = 4;
+
+//	Calls f(start, end) for all elements [0, count), possibly in parallel. Each element must be written exactly once.
+static void run_map_elements(const value_backend_t& backend, size_t count, const std::function<void(size_t start, size_t end)>& f){
+	QUARK_ASSERT(backend.check_invariant());
+
+	//	The alloc-records of the heap are not thread safe.
+	if(count < k_map_parallel_min_count || backend.heap.record_allocs_flag){
+		f(0, count);
+		return;
+	}
+
+	const auto probe_start = std::chrono::high_resolution_clock::now();
+	f(0, k_map_probe_count);
+	const auto probe_end = std::chrono::high_resolution_clock::now();
+
+	const auto probe_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(probe_end - probe_start).count();
+	const auto element_ns = std::max<int64_t>(probe_ns / static_cast<int64_t>(k_map_probe_count), 1);
+	const auto remaining = count - k_map_probe_count;
+
+	auto& scheduler = get_default_task_scheduler();
+	if(element_ns * static_cast<int64_t>(remaining) < k_map_parallel_min_ns || scheduler.workers.empty()){
+		f(k_map_probe_count, count);
+	}
+	else{
+		const auto thread_count = scheduler.workers.size() + 1;
+		const auto target_chunk = static_cast<size_t>(std::max<int64_t>(k_map_task_target_ns / element_ns, 1));
+		const auto balanced_chunk = (remaining + thread_count * k_map_tasks_per_worker - 1) / (thread_count * k_map_tasks_per_worker);
+		const auto chunk_size = std::max<size_t>(std::min(target_chunk, balanced_chunk), 1);
+
+		parallel_for(scheduler, remaining, chunk_size, [&](size_t start, size_t end){
+			f(k_map_probe_count + start, k_map_probe_count + end);
+		});
+	}
+}
+
 static runtime_value_t map__carray(floyd_runtime_t* frp, runtime_value_t elements_vec, runtime_type_t elements_vec_type, runtime_value_t f_value, runtime_type_t f_type, runtime_value_t context_value, runtime_type_t context_type, runtime_type_t result_vec_type){
 	auto& r = get_floyd_runtime(frp);
 	auto& backend = r.backend;
@@ -439,10 +536,15 @@ static runtime_value_t map__carray(floyd_runtime_t* frp, runtime_value_t element
 
 	const auto count = elements_vec.vector_carray_ptr->get_element_count();
 	auto result_vec = alloc_vector_carray(backend.heap, count, count, type_t(result_vec_type));
-	for(int i = 0 ; i < count ; i++){
-		const auto a = (*f)(frp, elements_vec.vector_carray_ptr->get_element_ptr()[i], context_value);
-		result_vec.vector_carray_ptr->get_element_ptr()[i] = a;
-	}
+
+	//	Each task writes its own range of the result vector, in place.
+	const auto source_ptr = elements_vec.vector_carray_ptr->get_element_ptr();
+	const auto dest_ptr = result_vec.vector_carray_ptr->get_element_ptr();
+	run_map_elements(backend, count, [&](size_t start, size_t end){
+		for(auto i = start ; i < end ; i++){
+			dest_ptr[i] = (*f)(frp, source_ptr[i], context_value);
+		}
+	});
 	return result_vec;
 }
 //??? Update 1 element in a big hamt will copy the entire hamt, inc RC on all elements in hamt2. This is not needed since most of hamt is shared. Cheaper if we build in RC for leaf in the hamt itself.
@@ -466,14 +568,16 @@ static runtime_value_t map__hamt(floyd_runtime_t* frp, runtime_value_t elements_
 
 	const auto f = reinterpret_cast<MAP_F>(f_value.function_ptr);
 
-	const auto count = elements_vec.vector_hamt_ptr->get_element_count();
-	auto result_vec = alloc_vector_hamt(backend.heap, count, count, type_t(result_vec_type));
-	for(int i = 0 ; i < count ; i++){
-		const auto& element = elements_vec.vector_hamt_ptr->load_element(i);
-		const auto a = (*f)(frp, element, context_value);
-		result_vec.vector_hamt_ptr->store_mutate(i, a);
-	}
-	return result_vec;
+	//	immer::vector can't be written from several threads: collect the results in a flat buffer, then build the HAMT in one go.
+	const auto& source = elements_vec.vector_hamt_ptr->get_vecref();
+	const auto count = source.size();
+	std::vector<runtime_value_t> temp(count);
+	run_map_elements(backend, count, [&](size_t start, size_t end){
+		for(auto i = start ; i < end ; i++){
+			temp[i] = (*f)(frp, source[i], context_value);
+		}
+	});
+	return alloc_vector_hamt(backend.heap, temp.data(), count, type_t(result_vec_type));
 }
 
 //	[R] map([E] elements, func R (E e, C context) f, C context)
@@ -594,7 +698,19 @@ static runtime_value_t floyd_llvm_intrinsic__map_string(floyd_runtime_t* frp, ru
 
 typedef runtime_value_t (*map_dag_F)(floyd_runtime_t* frp, runtime_value_t r_value, runtime_value_t r_vec_value, runtime_value_t context_value);
 
-//??? optimize prio 2
+//	Independent nodes run in parallel when there are enough of them to pay for the tasks.
+static const size_t k_map_dag_parallel_min_count = 64;
+
+//	Runs process_node() for each node, children before parents. Each node is processed exactly once.
+static void run_map_dag_nodes(const value_backend_t& backend, const dag_schedule_t& dag, const std::function<void(int64_t node)>& process_node){
+	QUARK_ASSERT(backend.check_invariant());
+	QUARK_ASSERT(dag.check_invariant());
+
+	//	The alloc-records of the heap are not thread safe.
+	const auto parallel = dag.parents.size() >= k_map_dag_parallel_min_count && backend.heap.record_allocs_flag == false;
+	run_dag_schedule(parallel ? &get_default_task_scheduler() : nullptr, dag, process_node);
+}
+
 static runtime_value_t map_dag__carray(
 	floyd_runtime_t* frp,
 	value_backend_t& backend,
@@ -625,9 +741,6 @@ static runtime_value_t map_dag__carray(
 
 	QUARK_ASSERT(e_type == peek2(types, type2).get_function_args(types)[0] && r_type == peek2(types, peek2(types, type2).get_function_args(types)[1]).get_vector_element_type(types));
 
-//	QUARK_ASSERT(is_vector_carray(make_vector(e_type)));
-//	QUARK_ASSERT(is_vector_carray(make_vector(r_type)));
-
 	const auto return_type = make_vector(types, r_type);
 
 	const auto f2 = reinterpret_cast<map_dag_F>(f.function_ptr);
@@ -639,90 +752,42 @@ static runtime_value_t map_dag__carray(
 		quark::throw_runtime_error("map_dag() requires elements and parents be the same count.");
 	}
 
-	auto elements_todo = elements2->get_element_count();
-	std::vector<int> rcs(elements2->get_element_count(), 0);
-
-	std::vector<runtime_value_t> complete(elements2->get_element_count(), runtime_value_t());
-
-	for(int i = 0 ; i < parents2->get_element_count() ; i++){
-		const auto& e = parents2->load_element(i);
-		const auto parent_index = e.int_value;
-
-		const auto count = static_cast<int64_t>(elements2->get_element_count());
-		QUARK_ASSERT(parent_index >= -1);
-		QUARK_ASSERT(parent_index < count);
-
-		if(parent_index != -1){
-			rcs[parent_index]++;
-		}
+	const auto count = elements2->get_element_count();
+	const auto parents_ptr = parents2->get_element_ptr();
+	std::vector<int64_t> parent_indexes(count);
+	for(int i = 0 ; i < count ; i++){
+		parent_indexes[i] = parents_ptr[i].int_value;
 	}
+	const auto dag = make_dag_schedule(parent_indexes);
 
-	while(elements_todo > 0){
-		//	Find all elements that are free to process -- they are not blocked on a depenency.
-		std::vector<int> pass_ids;
-		for(int i = 0 ; i < elements2->get_element_count() ; i++){
-			const auto rc = rcs[i];
-			if(rc == 0){
-				pass_ids.push_back(i);
-				rcs[i] = -1;
-			}
-		}
-		if(pass_ids.empty()){
-			quark::throw_runtime_error("map_dag() dependency cycle error.");
-		}
-
-		for(const auto element_index: pass_ids){
-			const auto& e = elements2->load_element(element_index);
-
-			//	Make list of the element's inputs -- they must all be complete now.
-			std::vector<runtime_value_t> solved_deps;
-			for(int element_index2 = 0 ; element_index2 < parents2->get_element_count() ; element_index2++){
-				const auto& p = parents2->load_element(element_index2);
-				const auto parent_index = p.int_value;
-				if(parent_index == element_index){
-					QUARK_ASSERT(element_index2 != -1);
-					QUARK_ASSERT(element_index2 >= -1 && element_index2 < elements2->get_element_count());
-					QUARK_ASSERT(rcs[element_index2] == -1);
-
-					const auto& solved = complete[element_index2];
-					solved_deps.push_back(solved);
-				}
-			}
+	//	Results are stored directly into the result vector. Each node only reads results of its children,
+	//	which are complete before the node is processed.
+	auto result_vec = alloc_vector_carray(backend.heap, count, count, return_type);
+	const auto elements_ptr = elements2->get_element_ptr();
+	const auto complete_ptr = result_vec.vector_carray_ptr->get_element_ptr();
 
-			auto solved_deps2 = alloc_vector_carray(backend.heap, solved_deps.size(), solved_deps.size(), return_type);
-			for(int i = 0 ; i < solved_deps.size() ; i++){
-				solved_deps2.vector_carray_ptr->store(i, solved_deps[i]);
-			}
-			runtime_value_t solved_deps3 = solved_deps2;
+	run_map_dag_nodes(backend, dag, [&](int64_t node){
+		const auto child_begin = dag.child_offsets[node];
+		const auto child_count = dag.child_offsets[node + 1] - child_begin;
 
-			const auto result1 = (*f2)(frp, e, solved_deps3, context);
+		//	Make list of the element's inputs -- they are all complete now.
+		auto solved_deps = alloc_vector_carray(backend.heap, child_count, child_count, return_type);
+		for(int64_t i = 0 ; i < child_count ; i++){
+			solved_deps.vector_carray_ptr->store(i, complete_ptr[dag.children[child_begin + i]]);
+		}
 
-			//	Release just the vec, **not the elements**. The elements are aliases for complete-vector.
-			if(dec_rc(solved_deps2.vector_carray_ptr->alloc) == 0){
-				dispose_vector_carray(solved_deps2);
-			}
+		const auto result1 = (*f2)(frp, elements_ptr[node], solved_deps, context);
 
-			const auto parent_index = parents2->load_element(element_index).int_value;
-			if(parent_index != -1){
-				rcs[parent_index]--;
-			}
-			complete[element_index] = result1;
-			elements_todo--;
+		//	Release just the vec, **not the elements**. The elements are aliases for complete-vector.
+		if(dec_rc(solved_deps.vector_carray_ptr->alloc) == 0){
+			dispose_vector_carray(solved_deps);
 		}
-	}
-
-	//??? No need to copy all elements -- could store them directly into the VEC_T.
-	const auto count = complete.size();
-	auto result_vec = alloc_vector_carray(backend.heap, count, count, return_type);
-	for(int i = 0 ; i < count ; i++){
-//		retain_value(r, complete[i], r_type);
-		result_vec.vector_carray_ptr->store(i, complete[i]);
-	}
+		complete_ptr[node] = result1;
+	});
 
 	return result_vec;
 }
 
-//??? optimize prio 2
 static runtime_value_t map_dag__hamt(
 	floyd_runtime_t* frp,
 	value_backend_t& backend,
@@ -754,9 +819,6 @@ static runtime_value_t map_dag__hamt(
 
 	QUARK_ASSERT(e_type == peek2(types, type2).get_function_args(types)[0] && r_type == peek2(types, peek2(types, type2).get_function_args(types)[1]).get_vector_element_type(types));
 
-//	QUARK_ASSERT(is_vector_hamt(make_vector(e_type)));
-//	QUARK_ASSERT(is_vector_hamt(make_vector(r_type)));
-
 	const auto return_type = make_vector(types, r_type);
 
 	const auto f2 = reinterpret_cast<map_dag_F>(f.function_ptr);
@@ -768,88 +830,39 @@ static runtime_value_t map_dag__hamt(
 		quark::throw_runtime_error("map_dag() requires elements and parents be the same count.");
 	}
 
-	auto elements_todo = elements2->get_element_count();
-	std::vector<int> rcs(elements2->get_element_count(), 0);
-
-	std::vector<runtime_value_t> complete(elements2->get_element_count(), runtime_value_t());
-
-	for(int i = 0 ; i < parents2->get_element_count() ; i++){
-		const auto& e = parents2->load_element(i);
-		const auto parent_index = e.int_value;
-
-		//??? remove cast? static_cast<int64_t>()
-		const auto count = static_cast<int64_t>(elements2->get_element_count());
-		QUARK_ASSERT(parent_index >= -1);
-		QUARK_ASSERT(parent_index < count);
-
-		if(parent_index != -1){
-			rcs[parent_index]++;
-		}
+	const auto count = elements2->get_element_count();
+	std::vector<int64_t> parent_indexes(count);
+	std::vector<runtime_value_t> element_values(count);
+	for(int i = 0 ; i < count ; i++){
+		parent_indexes[i] = parents2->load_element(i).int_value;
+		element_values[i] = elements2->load_element(i);
 	}
+	const auto dag = make_dag_schedule(parent_indexes);
 
-	while(elements_todo > 0){
-		//	Find all elements that are free to process -- they are not blocked on a depenency.
-		std::vector<int> pass_ids;
-		for(int i = 0 ; i < elements2->get_element_count() ; i++){
-			const auto rc = rcs[i];
-			if(rc == 0){
-				pass_ids.push_back(i);
-				rcs[i] = -1;
-			}
-		}
-		if(pass_ids.empty()){
-			quark::throw_runtime_error("map_dag() dependency cycle error.");
-		}
-
-		for(const auto element_index: pass_ids){
-			const auto& e = elements2->load_element(element_index);
-
-			//	Make list of the element's inputs -- they must all be complete now.
-			std::vector<runtime_value_t> solved_deps;
-			for(int element_index2 = 0 ; element_index2 < parents2->get_element_count() ; element_index2++){
-				const auto& p = parents2->load_element(element_index2);
-				const auto parent_index = p.int_value;
-				if(parent_index == element_index){
-					QUARK_ASSERT(element_index2 != -1);
-					QUARK_ASSERT(element_index2 >= -1 && element_index2 < elements2->get_element_count());
-					QUARK_ASSERT(rcs[element_index2] == -1);
-
-					const auto& solved = complete[element_index2];
-					solved_deps.push_back(solved);
-				}
-			}
+	//	The hamt isn't safe to mutate from several threads: collect the results in a plain buffer, then build the hamt once.
+	std::vector<runtime_value_t> complete(count, runtime_value_t());
 
-			auto solved_deps2 = alloc_vector_hamt(backend.heap, solved_deps.size(), solved_deps.size(), return_type);
-			for(int i = 0 ; i < solved_deps.size() ; i++){
-				solved_deps2.vector_hamt_ptr->store_mutate(i, solved_deps[i]);
-			}
-			runtime_value_t solved_deps3 = solved_deps2;
+	run_map_dag_nodes(backend, dag, [&](int64_t node){
+		const auto child_begin = dag.child_offsets[node];
+		const auto child_count = dag.child_offsets[node + 1] - child_begin;
 
-			const auto result1 = (*f2)(frp, e, solved_deps3, context);
+		//	Make list of the element's inputs -- they are all complete now.
+		std::vector<runtime_value_t> solved_deps(child_count);
+		for(int64_t i = 0 ; i < child_count ; i++){
+			solved_deps[i] = complete[dag.children[child_begin + i]];
+		}
+		auto solved_deps2 = alloc_vector_hamt(backend.heap, solved_deps.data(), child_count, return_type);
 
-			//	Release just the vec, **not the elements**. The elements are aliases for complete-vector.
-			if(dec_rc(solved_deps2.vector_hamt_ptr->alloc) == 0){
-				dispose_vector_hamt(solved_deps2);
-			}
+		const auto result1 = (*f2)(frp, element_values[node], solved_deps2, context);
 
-			const auto parent_index = parents2->load_element(element_index).int_value;
-			if(parent_index != -1){
-				rcs[parent_index]--;
-			}
-			complete[element_index] = result1;
-			elements_todo--;
+		//	Release just the vec, **not the elements**. The elements are aliases for complete-vector.
+		if(dec_rc(solved_deps2.vector_hamt_ptr->alloc) == 0){
+			dispose_vector_hamt(solved_deps2);
 		}
-	}
-
-	//??? No need to copy all elements -- could store them directly into the VEC_T.
-	const auto count = complete.size();
-	auto result_vec = alloc_vector_hamt(backend.heap, count, count, return_type);
-	for(int i = 0 ; i < count ; i++){
-//		retain_value(r, complete[i], r_type);
-		result_vec.vector_hamt_ptr->store_mutate(i, complete[i]);
-	}
+		complete[node] = result1;
+	});
 
-	return result_vec;
+	return alloc_vector_hamt(backend.heap, complete.data(), count, return_type);
 }
 
 // ??? optimize prio 1: check type at compile time, not runtime.
@@ -1089,7 +1102,19 @@ static runtime_value_t floyd_llvm_intrinsic__reduce(floyd_runtime_t* frp, runtim
 
 typedef uint8_t (*stable_sort_F)(floyd_runtime_t* frp, runtime_value_t left_value, runtime_value_t right_value, runtime_value_t context_value);
 
-//??? optimize prio 1
+//	Sorts the raw element words in place. Comparisons call the compiled less-function directly: no boxing
+//	or allocations. Elements are borrowed, not retained.
+static void sort_elements(const value_backend_t& backend, floyd_runtime_t* frp, runtime_value_t* elements, size_t count, stable_sort_F f, runtime_value_t context){
+	QUARK_ASSERT(backend.check_invariant());
+
+	const auto less = [frp, f, context](const runtime_value_t& a, const runtime_value_t& b){
+		return (*f)(frp, a, b, context) == 1;
+	};
+
+	//	The alloc-records of the heap are not thread safe.
+	auto scheduler = backend.heap.record_allocs_flag ? nullptr : &get_default_task_scheduler();
+	parallel_stable_sort(scheduler, elements, count, less);
+}
 
 static runtime_value_t stable_sort__carray(
 	floyd_runtime_t* frp,
@@ -1113,39 +1138,28 @@ static runtime_value_t stable_sort__carray(
 //	QUARK_ASSERT(check_stable_sort_func_type(type0, type1, type2));
 	QUARK_ASSERT(is_vector_carray(types, backend.config, type_t(elements_vec_type)));
 
-	const auto& elements = elements_vec;
-	const auto& f = f_value;
-	const auto& context = context_value;
-
-	const auto elements2 = from_runtime_value2(backend, elements, type0);
-	const auto f2 = reinterpret_cast<stable_sort_F>(f.function_ptr);
-
-	struct sort_functor_r {
-		bool operator() (const value_t &a, const value_t &b) {
-			auto& r = get_floyd_runtime(frp);
-			const auto left = to_runtime_value(r, a);
-			const auto right = to_runtime_value(r, b);
-			uint8_t result = (*f)(frp, left, right, context);
-			return result == 1 ? true : false;
-		}
-
-		floyd_runtime_t* frp;
-		runtime_value_t context;
-		stable_sort_F f;
-	};
+	auto& vec = *elements_vec.vector_carray_ptr;
+	const auto f2 = reinterpret_cast<stable_sort_F>(f_value.function_ptr);
+	const auto count = vec.get_element_count();
 
-	const sort_functor_r sort_functor { frp, context, f2 };
+	auto result_vec = alloc_vector_carray(backend.heap, count, count, type0);
+	const auto dest_ptr = result_vec.vector_carray_ptr->get_element_ptr();
+	if(count > 0){
+		copy_elements(dest_ptr, vec.get_element_ptr(), count);
+	}
 
-	auto mutate_inplace_elements = elements2.get_vector_value();
-	std::stable_sort(mutate_inplace_elements.begin(), mutate_inplace_elements.end(), sort_functor);
+	sort_elements(backend, frp, dest_ptr, count, f2, context_value);
 
-	//??? optimize
-	const auto result = to_runtime_value2(backend, value_t::make_vector_value(types, peek2(types, type0).get_vector_element_type(types), mutate_inplace_elements));
-	return result;
+	//	The result vector shares the elements with the input vector.
+	const auto e_element_itype = lookup_vector_element_type(backend, type_t(elements_vec_type));
+	if(is_rc_value(peek2(types, e_element_itype))){
+		for(int i = 0 ; i < count ; i++){
+			retain_value(backend, dest_ptr[i], e_element_itype);
+		}
+	}
+	return result_vec;
 }
 
-//??? optimize prio 1
-
 static runtime_value_t stable_sort__hamt(
 	floyd_runtime_t* frp,
 	value_backend_t& backend,
@@ -1168,35 +1182,25 @@ static runtime_value_t stable_sort__hamt(
 //	QUARK_ASSERT(check_stable_sort_func_type(type0, type1, type2));
 	QUARK_ASSERT(is_vector_hamt(types, backend.config, type_t(elements_vec_type)));
 
-	const auto& elements = elements_vec;
-	const auto& f = f_value;
-	const auto& context = context_value;
-
-	const auto elements2 = from_runtime_value2(backend, elements, type0);
-	const auto f2 = reinterpret_cast<stable_sort_F>(f.function_ptr);
-
-	struct sort_functor_r {
-		bool operator() (const value_t &a, const value_t &b) {
-			auto& r = get_floyd_runtime(frp);
-			const auto left = to_runtime_value(r, a);
-			const auto right = to_runtime_value(r, b);
-			uint8_t result = (*f)(frp, left, right, context);
-			return result == 1 ? true : false;
-		}
-
-		floyd_runtime_t* frp;
-		runtime_value_t context;
-		stable_sort_F f;
-	};
+	const auto& vec = *elements_vec.vector_hamt_ptr;
+	const auto f2 = reinterpret_cast<stable_sort_F>(f_value.function_ptr);
+	const auto count = vec.get_element_count();
 
-	const sort_functor_r sort_functor { frp, context, f2 };
+	std::vector<runtime_value_t> temp(count);
+	for(int i = 0 ; i < count ; i++){
+		temp[i] = vec.load_element(i);
+	}
 
-	auto mutate_inplace_elements = elements2.get_vector_value();
-	std::stable_sort(mutate_inplace_elements.begin(), mutate_inplace_elements.end(), sort_functor);
+	sort_elements(backend, frp, temp.data(), count, f2, context_value);
 
-	//??? optimize
-	const auto result = to_runtime_value2(backend, value_t::make_vector_value(types, peek2(types, type0).get_vector_element_type(types), mutate_inplace_elements));
-	return result;
+	//	The result vector shares the elements with the input vector.
+	const auto e_element_itype = lookup_vector_element_type(backend, type_t(elements_vec_type));
+	if(is_rc_value(peek2(types, e_element_itype))){
+		for(const auto& e: temp){
+			retain_value(backend, e, e_element_itype);
+		}
+	}
+	return alloc_vector_hamt(backend.heap, temp.data(), count, type0);
 }
 
 //	[T] stable_sort([T] elements, bool less(T left, T right, C context), C context)
@@ -1387,6 +1391,65 @@ llvm::Value* generate_instrinsic_push_back(llvm_function_generator_t& gen_acc, c
 }
 
 
+////////////////////////////////	push_back() in place
+
+
+//	These consume vec and element. See push_back_inplace__vector_carray().
+
+static runtime_value_t floydrt_push_back_inplace_string(floyd_runtime_t* frp, runtime_value_t vec, runtime_type_t vec_type, runtime_value_t element){
+	auto& r = get_floyd_runtime(frp);
+	return push_back_inplace__string(r.backend, vec, element);
+}
+
+static runtime_value_t floydrt_push_back_inplace_carray(floyd_runtime_t* frp, runtime_value_t vec, runtime_type_t vec_type, runtime_value_t element){
+	auto& r = get_floyd_runtime(frp);
+	return push_back_inplace__vector_carray(r.backend, vec, vec_type, element);
+}
+
+static std::vector<specialization_t> make_push_back_inplace_specializations(llvm::LLVMContext& context, const llvm_type_lookup& type_lookup){
+	llvm::FunctionType* function_type = llvm::FunctionType::get(
+		make_generic_vec_type_byvalue(type_lookup)->getPointerTo(),
+		{
+			make_frp_type(type_lookup),
+			make_generic_vec_type_byvalue(type_lookup)->getPointerTo(),
+			make_runtime_type_type(type_lookup),
+			make_runtime_value_type(type_lookup)
+		},
+		false
+	);
+	return {
+		specialization_t { eresolved_type::k_string,				{ "push_back_inplace_string", function_type, reinterpret_cast<void*>(floydrt_push_back_inplace_string) } },
+		specialization_t { eresolved_type::k_vector_carray_pod,		{ "push_back_inplace_carray", function_type, reinterpret_cast<void*>(floydrt_push_back_inplace_carray) } },
+		specialization_t { eresolved_type::k_vector_carray_nonpod,	{ "push_back_inplace_carray", function_type, reinterpret_cast<void*>(floydrt_push_back_inplace_carray) } }
+	};
+}
+
+bool has_intrinsic_push_back_inplace(const config_t& config, const types_t& types, const type_t& collection_type){
+	return peek2(types, collection_type).is_string() || is_vector_carray(types, config, collection_type);
+}
+
+llvm::Value* generate_instrinsic_push_back_inplace(llvm_function_generator_t& gen_acc, llvm::Value& collection_reg, const type_t& collection_type, llvm::Value& value_reg){
+	QUARK_ASSERT(gen_acc.check_invariant());
+	QUARK_ASSERT(collection_type.check_invariant());
+	QUARK_ASSERT(has_intrinsic_push_back_inplace(gen_acc.gen.settings.config, gen_acc.gen.type_lookup.state.types, collection_type));
+
+	auto& builder = gen_acc.get_builder();
+	const auto& types = gen_acc.gen.type_lookup.state.types;
+
+	const auto res = lookup_link_map(gen_acc.gen.settings.config, types, gen_acc.gen.link_map, make_push_back_inplace_specializations(builder.getContext(), gen_acc.gen.type_lookup), collection_type);
+	const auto collection_type_peek = peek2(types, collection_type);
+	const auto element_type = collection_type_peek.is_string() ? type_t::make_int() : collection_type_peek.get_vector_element_type(types);
+
+	const auto vector_itype_reg = generate_itype_constant(gen_acc.gen, collection_type);
+	const auto packed_value_reg = generate_cast_to_runtime_value(gen_acc.gen, value_reg, element_type);
+	return builder.CreateCall(
+		res.llvm_codegen_f,
+		{ gen_acc.get_callers_fcp(), &collection_reg, vector_itype_reg, packed_value_reg },
+		""
+	);
+}
+
+
 
 
 ////////////////////////////////	replace()
@@ -1442,21 +1505,20 @@ static JSON_T* floyd_llvm_intrinsic__parse_json_script(floyd_runtime_t* frp, run
 /////////////////////////////////////////		send()
 
 
-//??? optimize prio 2
-
+//	The message is passed on as a runtime value, the receiving process shares it. No copying of the json.
 static void floyd_llvm_intrinsic__send(floyd_runtime_t* frp, runtime_value_t process_id0, const JSON_T* message_json_ptr){
 	auto& r = get_floyd_runtime(frp);
 
 	QUARK_ASSERT(message_json_ptr != nullptr);
 
 	const auto& process_id = from_runtime_string(r, process_id0);
-	const auto& message_json = message_json_ptr->get_json();
 
 	if(k_trace_process_messaging){
-		QUARK_TRACE_SS("send(\"" << process_id << "\"," << json_to_pretty_string(message_json) <<")");
+		QUARK_TRACE_SS("send(\"" << process_id << "\"," << json_to_pretty_string(message_json_ptr->get_json()) <<")");
 	}
 
-	r._handler->on_send(process_id, message_json);
+	const runtime_value_t message = { .json_ptr = const_cast<JSON_T*>(message_json_ptr) };
+	r._handler->on_send_value(process_id, message, make_runtime_type(type_t::make_json()));
 }
 
 
@@ -1497,6 +1559,11 @@ static int64_t size_dict_hamt(floyd_runtime_t* frp, runtime_value_t collection,
 	(void)r;
 	return collection.dict_hamt_ptr->size();
 }
+static int64_t size_dict_hashtable(floyd_runtime_t* frp, runtime_value_t collection, runtime_type_t collection_type){
+	auto& r = get_floyd_runtime(frp);
+	(void)r;
+	return collection.dict_hashtable_ptr->size();
+}
 static int64_t size_json(floyd_runtime_t* frp, runtime_value_t collection, runtime_type_t collection_type){
 	auto& r = get_floyd_runtime(frp);
 	(void)r;
@@ -1558,6 +1625,8 @@ static std::vector<specialization_t> make_size_specializations(llvm::LLVMContext
 		specialization_t { eresolved_type::k_dict_cppmap_nonpod,		{ "size_dict_cppmap", function_type2, reinterpret_cast<void*>(size_dict_cppmap) } },
 		specialization_t { eresolved_type::k_dict_hamt_pod,				{ "size_dict_hamt", function_type2, reinterpret_cast<void*>(size_dict_hamt) } },
 		specialization_t { eresolved_type::k_dict_hamt_nonpod,			{ "size_dict_hamt", function_type2, reinterpret_cast<void*>(size_dict_hamt) } },
+		specialization_t { eresolved_type::k_dict_hashtable_pod,		{ "size_dict_hashtable", function_type2, reinterpret_cast<void*>(size_dict_hashtable) } },
+		specialization_t { eresolved_type::k_dict_hashtable_nonpod,		{ "size_dict_hashtable", function_type2, reinterpret_cast<void*>(size_dict_hashtable) } },
 
 		specialization_t { eresolved_type::k_json,						{ "size_json", function_type3, reinterpret_cast<void*>(size_json) } }
 	};
@@ -1804,6 +1873,15 @@ static const runtime_value_t update_dict_hamt_nonpod(floyd_runtime_t* frp, runti
 #endif
 	return update__dict_hamt(r.backend, coll_value, coll_type, key_value, value);
 }
+static const runtime_value_t update_dict_hashtable(floyd_runtime_t* frp, runtime_value_t coll_value, runtime_type_t coll_type, runtime_value_t key_value, runtime_type_t key_type, runtime_value_t value, runtime_type_t value_type){
+	auto& r = get_floyd_runtime(frp);
+
+#if DEBUG
+	const auto& type1 = lookup_type_ref(r.backend, key_type);
+	QUARK_ASSERT(peek2(r.backend.types, type1).is_string());
+#endif
+	return update__dict_hashtable(r.backend, coll_value, coll_type, key_value, value);
+}
 
 static std::vector<specialization_t> make_update_specializations(llvm::LLVMContext& context, const llvm_type_lookup& type_lookup){
 	llvm::FunctionType* function_type1 = llvm::FunctionType::get(
@@ -1851,6 +1929,8 @@ static std::vector<specialization_t> make_update_specializations(llvm::LLVMConte
 		specialization_t { eresolved_type::k_dict_cppmap_nonpod,		{ "update_dict_cppmap", function_type2, reinterpret_cast<void*>(update_dict_cppmap_nonpod) } },
 		specialization_t { eresolved_type::k_dict_hamt_pod,				{ "update_dict_hamt", function_type2, reinterpret_cast<void*>(update_dict_hamt_pod) } },
 		specialization_t { eresolved_type::k_dict_hamt_nonpod,			{ "update_dict_hamt", function_type2, reinterpret_cast<void*>(update_dict_hamt_nonpod) } },
+		specialization_t { eresolved_type::k_dict_hashtable_pod,		{ "update_dict_hashtable", function_type2, reinterpret_cast<void*>(update_dict_hashtable) } },
+		specialization_t { eresolved_type::k_dict_hashtable_nonpod,		{ "update_dict_hashtable", function_type2, reinterpret_cast<void*>(update_dict_hashtable) } },
 	};
 }
 
@@ -1909,6 +1989,104 @@ llvm::Value* generate_instrinsic_update(llvm_function_generator_t& gen_acc, cons
 }
 
 
+/////////////////////////////////////////		update() in place
+
+
+//	These consume coll_value and value but not the key. See update_inplace__vector_carray().
+
+static runtime_value_t floydrt_update_inplace_carray(floyd_runtime_t* frp, runtime_value_t coll_value, runtime_type_t coll_type, runtime_value_t key_value, runtime_type_t key_type, runtime_value_t value, runtime_type_t value_type){
+	auto& r = get_floyd_runtime(frp);
+	return update_inplace__vector_carray(r.backend, coll_value, coll_type, key_value, value);
+}
+
+static runtime_value_t floydrt_update_inplace_cppmap(floyd_runtime_t* frp, runtime_value_t coll_value, runtime_type_t coll_type, runtime_value_t key_value, runtime_type_t key_type, runtime_value_t value, runtime_type_t value_type){
+	auto& r = get_floyd_runtime(frp);
+	return update_inplace__dict_cppmap(r.backend, coll_value, coll_type, key_value, value);
+}
+
+static runtime_value_t floydrt_update_inplace_hashtable(floyd_runtime_t* frp, runtime_value_t coll_value, runtime_type_t coll_type, runtime_value_t key_value, runtime_type_t key_type, runtime_value_t value, runtime_type_t value_type){
+	auto& r = get_floyd_runtime(frp);
+	return update_inplace__dict_hashtable(r.backend, coll_value, coll_type, key_value, value);
+}
+
+static std::vector<specialization_t> make_update_inplace_specializations(llvm::LLVMContext& context, const llvm_type_lookup& type_lookup){
+	llvm::FunctionType* function_type1 = llvm::FunctionType::get(
+		make_generic_vec_type_byvalue(type_lookup)->getPointerTo(),
+		{
+			make_frp_type(type_lookup),
+
+			make_generic_vec_type_byvalue(type_lookup)->getPointerTo(),
+			make_runtime_type_type(type_lookup),
+
+			llvm::Type::getInt64Ty(context),
+			make_runtime_type_type(type_lookup),
+
+			make_runtime_value_type(type_lookup),
+			make_runtime_type_type(type_lookup),
+		},
+		false
+	);
+	llvm::FunctionType* function_type2 = llvm::FunctionType::get(
+		make_generic_dict_type_byvalue(type_lookup)->getPointerTo(),
+		{
+			make_frp_type(type_lookup),
+
+			make_generic_dict_type_byvalue(type_lookup)->getPointerTo(),
+			make_runtime_type_type(type_lookup),
+
+			make_generic_vec_type_byvalue(type_lookup)->getPointerTo(),
+			make_runtime_type_type(type_lookup),
+
+			make_runtime_value_type(type_lookup),
+			make_runtime_type_type(type_lookup)
+		},
+		false
+	);
+	return {
+		specialization_t { eresolved_type::k_vector_carray_pod,			{ "update_inplace_carray", function_type1, reinterpret_cast<void*>(floydrt_update_inplace_carray) } },
+		specialization_t { eresolved_type::k_vector_carray_nonpod,		{ "update_inplace_carray", function_type1, reinterpret_cast<void*>(floydrt_update_inplace_carray) } },
+		specialization_t { eresolved_type::k_dict_cppmap_pod,			{ "update_inplace_cppmap", function_type2, reinterpret_cast<void*>(floydrt_update_inplace_cppmap) } },
+		specialization_t { eresolved_type::k_dict_cppmap_nonpod,		{ "update_inplace_cppmap", function_type2, reinterpret_cast<void*>(floydrt_update_inplace_cppmap) } },
+		specialization_t { eresolved_type::k_dict_hashtable_pod,		{ "update_inplace_hashtable", function_type2, reinterpret_cast<void*>(floydrt_update_inplace_hashtable) } },
+		specialization_t { eresolved_type::k_dict_hashtable_nonpod,		{ "update_inplace_hashtable", function_type2, reinterpret_cast<void*>(floydrt_update_inplace_hashtable) } }
+	};
+}
+
+bool has_intrinsic_update_inplace(const config_t& config, const types_t& types, const type_t& collection_type){
+	return is_vector_carray(types, config, collection_type) || is_dict_cppmap(types, config, collection_type) || is_dict_hashtable(types, config, collection_type);
+}
+
+llvm::Value* generate_instrinsic_update_inplace(llvm_function_generator_t& gen_acc, llvm::Value& collection_reg, const type_t& collection_type, llvm::Value& key_reg, llvm::Value& value_reg){
+	QUARK_ASSERT(gen_acc.check_invariant());
+	QUARK_ASSERT(collection_type.check_invariant());
+	QUARK_ASSERT(has_intrinsic_update_inplace(gen_acc.gen.settings.config, gen_acc.gen.type_lookup.state.types, collection_type));
+
+	auto& builder = gen_acc.get_builder();
+	const auto& types = gen_acc.gen.type_lookup.state.types;
+
+	const auto res = lookup_link_map(
+		gen_acc.gen.settings.config,
+		types,
+		gen_acc.gen.link_map,
+		make_update_inplace_specializations(builder.getContext(), gen_acc.gen.type_lookup),
+		collection_type
+	);
+	const auto collection_itype = generate_itype_constant(gen_acc.gen, collection_type);
+	const auto collection_type_peek = peek2(types, collection_type);
+
+	const auto key_type = collection_type_peek.is_dict() ? type_t::make_string() : type_t::make_int();
+	const auto element_type = collection_type_peek.is_dict() ? collection_type_peek.get_dict_value_type(types) : collection_type_peek.get_vector_element_type(types);
+	const auto key_itype = generate_itype_constant(gen_acc.gen, key_type);
+	const auto value_itype = generate_itype_constant(gen_acc.gen, element_type);
+	const auto packed_value_reg = generate_cast_to_runtime_value(gen_acc.gen, value_reg, element_type);
+	return builder.CreateCall(
+		res.llvm_codegen_f,
+		{ gen_acc.get_callers_fcp(), &collection_reg, collection_itype, &key_reg, key_itype, packed_value_reg, value_itype },
+		""
+	);
+}
+
+
 
 /////////////////////////////////////////		to_json()
 
@@ -2028,6 +2206,8 @@ std::vector<function_link_entry_t> make_intrinsics_link_map(llvm::LLVMContext& c
 	result = concat(result, make_entries2(intrinsic_signatures, make_push_back_specializations(context, type_lookup)));
 	result = concat(result, make_entries2(intrinsic_signatures, make_size_specializations(context, type_lookup)));
 	result = concat(result, make_entries2(intrinsic_signatures, make_update_specializations(context, type_lookup)));
+	result = concat(result, make_entries2(intrinsic_signatures, make_push_back_inplace_specializations(context, type_lookup)));
+	result = concat(result, make_entries2(intrinsic_signatures, make_update_inplace_specializations(context, type_lookup)));
 	result = concat(result, make_entries2(intrinsic_signatures, make_map_specializations(context, type_lookup)));
 
 	if(k_trace_function_link_map){
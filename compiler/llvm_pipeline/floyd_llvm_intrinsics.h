@@ -25,6 +25,17 @@ std::vector<function_link_entry_t> make_intrinsics_link_map(llvm::LLVMContext& c
 llvm::Value* generate_instrinsic_push_back(llvm_function_generator_t& gen_acc, const type_t& resolved_call_type, llvm::Value& collection_reg, const type_t& collection_type, llvm::Value& value_reg);
 llvm::Value* generate_instrinsic_size(llvm_function_generator_t& gen_acc, const type_t& resolved_call_type, llvm::Value& collection_reg, const type_t& collection_type);
 llvm::Value* generate_instrinsic_update(llvm_function_generator_t& gen_acc, const type_t& resolved_call_type, llvm::Value& collection_reg, const type_t& collection_type, llvm::Value& key_reg, llvm::Value& value_reg);
+
+/*
+	In-place push_back() / update(), for "a = push_back(a, x)" and "a = update(a, key, x)".
+	They consume collection_reg and value_reg and return the collection to store back into a. When a holds the
+	only reference the collection is mutated instead of copied. Only available for some collection backends.
+*/
+bool has_intrinsic_push_back_inplace(const config_t& config, const types_t& types, const type_t& collection_type);
+llvm::Value* generate_instrinsic_push_back_inplace(llvm_function_generator_t& gen_acc, llvm::Value& collection_reg, const type_t& collection_type, llvm::Value& value_reg);
+bool has_intrinsic_update_inplace(const config_t& config, const types_t& types, const type_t& collection_type);
+llvm::Value* generate_instrinsic_update_inplace(llvm_function_generator_t& gen_acc, llvm::Value& collection_reg, const type_t& collection_type, llvm::Value& key_reg, llvm::Value& value_reg);
+
 llvm::Value* generate_instrinsic_map(
 	llvm_function_generator_t& gen_acc,
 	const type_t& resolved_call_type,
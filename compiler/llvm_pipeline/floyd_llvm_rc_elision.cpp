@@ -0,0 +1,380 @@
+//
+//  floyd_llvm_rc_elision.cpp
+//  floyd
+//
+//  Created by Marcus Zetterquist on 2026-10-18.
+//  Copyright © 2026 Marcus Zetterquist. All rights reserved.
+//
+
+#include "floyd_llvm_rc_elision.h"
+
+#include "floyd_llvm_runtime_functions.h"
+#include "floyd_llvm_codegen.h"
+#include "floyd_llvm_runtime.h"
+#include "compiler_helpers.h"
+#include "semantic_ast.h"
+#include "format_table.h"
+
+#include <llvm/IR/BasicBlock.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Verifier.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <vector>
+#include <algorithm>
+
+#include "quark.h"
+
+
+namespace floyd {
+
+
+enum class rc_op {
+	other_call,
+	retain,
+	release,
+	no_call
+};
+
+static rc_op classify_instruction(const llvm::Instruction& inst){
+	const auto call = llvm::dyn_cast<llvm::CallInst>(&inst);
+	if(call == nullptr){
+		return rc_op::no_call;
+	}
+
+	const auto f = call->getCalledFunction();
+	if(f == nullptr){
+		return rc_op::other_call;
+	}
+	else if(f->isIntrinsic()){
+		return rc_op::no_call;
+	}
+
+	const auto name = f->getName().str();
+	if(name == k_inline_retain_name){
+		return rc_op::retain;
+	}
+	else if(name.compare(0, k_inline_release_prefix.size() + 8, k_inline_release_prefix + "release_") == 0){
+		return rc_op::release;
+	}
+	else{
+		return rc_op::other_call;
+	}
+}
+
+//	retain(value) takes the value as arg 0, release(frp, value, itype) as arg 1. Both can be bitcasts of the same value.
+static const llvm::Value* get_rc_value(const llvm::CallInst& call, rc_op op){
+	const auto arg_index = op == rc_op::retain ? 0 : 1;
+	return call.getArgOperand(arg_index)->stripPointerCasts();
+}
+
+static void erase_call_and_dead_cast(llvm::CallInst* call){
+	std::vector<llvm::Instruction*> casts;
+	for(unsigned i = 0 ; i < call->arg_size() ; i++){
+		const auto cast = llvm::dyn_cast<llvm::CastInst>(call->getArgOperand(i));
+		if(cast != nullptr){
+			casts.push_back(cast);
+		}
+	}
+
+	call->eraseFromParent();
+
+	for(const auto& e: casts){
+		if(e->use_empty()){
+			e->eraseFromParent();
+		}
+	}
+}
+
+static rc_elision_stats_t elide_in_block(llvm::BasicBlock& bb){
+	//	Retains that can still be cancelled by a later release of the same value.
+	std::vector<llvm::CallInst*> open_retains;
+
+	std::vector<std::pair<llvm::CallInst*, llvm::CallInst*>> pairs;
+	for(auto& inst: bb){
+		const auto op = classify_instruction(inst);
+		if(op == rc_op::no_call){
+		}
+		else if(op == rc_op::retain){
+			open_retains.push_back(llvm::cast<llvm::CallInst>(&inst));
+		}
+		else if(op == rc_op::release){
+			auto release = llvm::cast<llvm::CallInst>(&inst);
+			const auto value = get_rc_value(*release, op);
+
+			const auto it = std::find_if(
+				open_retains.rbegin(),
+				open_retains.rend(),
+				[&](const llvm::CallInst* retain){ return get_rc_value(*retain, rc_op::retain) == value; }
+			);
+			if(it != open_retains.rend()){
+				pairs.push_back({ *it, release });
+				open_retains.erase(std::next(it).base());
+			}
+			else{
+				//	This release may drop the last reference to something the open retains depend on.
+				open_retains.clear();
+			}
+		}
+		else if(op == rc_op::other_call){
+			open_retains.clear();
+		}
+		else{
+			QUARK_ASSERT(false);
+		}
+	}
+
+	for(const auto& e: pairs){
+		erase_call_and_dead_cast(e.first);
+		erase_call_and_dead_cast(e.second);
+	}
+	return rc_elision_stats_t { static_cast<int>(pairs.size()) };
+}
+
+std::map<std::string, rc_elision_stats_t> elide_redundant_rc_mutating(llvm::Module& module){
+	std::map<std::string, rc_elision_stats_t> result;
+	for(auto& f: module){
+		rc_elision_stats_t acc { 0 };
+		for(auto& bb: f){
+			acc.pairs_removed += elide_in_block(bb).pairs_removed;
+		}
+		if(acc.pairs_removed > 0){
+			result[f.getName().str()] = acc;
+		}
+	}
+	return result;
+}
+
+void trace_rc_elision_stats(const std::map<std::string, rc_elision_stats_t>& stats){
+	QUARK_SCOPED_TRACE("RC ELISION");
+
+	std::vector<std::vector<std::string>> matrix;
+	int pairs_removed = 0;
+	for(const auto& e: stats){
+		matrix.push_back({ e.first, std::to_string(e.second.pairs_removed) });
+		pairs_removed += e.second.pairs_removed;
+	}
+	matrix.push_back({ "TOTAL", std::to_string(pairs_removed) });
+
+	const auto result = generate_table_type1({ "FUNCTION", "PAIRS REMOVED" }, matrix);
+	QUARK_TRACE(result);
+}
+
+
+
+QUARK_TEST("", "elide_redundant_rc_mutating()", "retain + release of same value in a block", "pair is removed"){
+	llvm::LLVMContext context;
+	llvm::Module module("test", context);
+
+	auto int8_ptr_type = llvm::Type::getInt8PtrTy(context);
+	auto int32_ptr_type = llvm::Type::getInt32PtrTy(context);
+	auto void_type = llvm::Type::getVoidTy(context);
+	auto retain_f = llvm::Function::Create(llvm::FunctionType::get(void_type, { int32_ptr_type }, false), llvm::Function::ExternalLinkage, k_inline_retain_name, &module);
+	auto release_f = llvm::Function::Create(llvm::FunctionType::get(void_type, { int8_ptr_type, int8_ptr_type, int8_ptr_type }, false), llvm::Function::ExternalLinkage, k_inline_release_prefix + "release_struct", &module);
+	auto other_f = llvm::Function::Create(llvm::FunctionType::get(void_type, {}, false), llvm::Function::ExternalLinkage, "other", &module);
+
+	auto f = llvm::Function::Create(llvm::FunctionType::get(void_type, { int8_ptr_type, int8_ptr_type, int8_ptr_type }, false), llvm::Function::ExternalLinkage, "f", &module);
+	auto args_it = f->arg_begin();
+	llvm::Value* frp_reg = &*args_it++;
+	llvm::Value* a_reg = &*args_it++;
+	llvm::Value* b_reg = &*args_it++;
+
+	llvm::IRBuilder<> builder(llvm::BasicBlock::Create(context, "entry", f));
+
+	//	a: retain, release -- removed.
+	builder.CreateCall(retain_f, { builder.CreateBitCast(a_reg, int32_ptr_type) });
+	builder.CreateCall(release_f, { frp_reg, a_reg, frp_reg });
+
+	//	b: retain, unknown call, release -- kept.
+	builder.CreateCall(retain_f, { builder.CreateBitCast(b_reg, int32_ptr_type) });
+	builder.CreateCall(other_f, {});
+	builder.CreateCall(release_f, { frp_reg, b_reg, frp_reg });
+	builder.CreateRetVoid();
+
+	const auto result = elide_redundant_rc_mutating(module);
+	QUARK_VERIFY(result.size() == 1);
+	QUARK_VERIFY(result.at("f") == (rc_elision_stats_t { 1 }));
+	QUARK_VERIFY(f->getEntryBlock().size() == 5);
+}
+
+struct rc_op_count_t {
+	int retains;
+	int releases;
+};
+
+static std::map<std::string, rc_op_count_t> count_rc_ops(const llvm::Module& module){
+	std::map<std::string, rc_op_count_t> result;
+	for(const auto& f: module){
+		rc_op_count_t count { 0, 0 };
+		for(const auto& bb: f){
+			for(const auto& inst: bb){
+				const auto op = classify_instruction(inst);
+				count.retains += op == rc_op::retain ? 1 : 0;
+				count.releases += op == rc_op::release ? 1 : 0;
+			}
+		}
+		result[f.getName().str()] = count;
+	}
+	return result;
+}
+
+QUARK_TEST("", "elide_redundant_rc_mutating()", "codegen output passing a string and a vector through calls", "retains and releases still balance"){
+	const auto cu = make_compilation_unit_nolib(
+		R"(
+
+			struct pair_t {
+				string s
+				[string] v
+			}
+
+			func string first(pair_t p){
+				return p.s + p.v[0]
+			}
+
+			func string f(string s, [string] v){
+				return first(pair_t(s, v))
+			}
+
+			print(f("a", [ "b" ]))
+
+		)",
+		"myfile.floyd"
+	);
+	const auto sem_ast = compile_to_sematic_ast__errors(cu);
+
+	//	No optimizations: codegen output as is, the pass hasn't run yet.
+	auto settings = make_default_compiler_settings();
+	settings.optimization_level = eoptimization_level::g_no_optimizations_enable_debugging;
+	llvm_instance_t instance;
+	auto program = generate_llvm_ir_program(instance, sem_ast, "myfile.floyd", settings);
+	QUARK_VERIFY(program->rc_elision_stats.empty());
+
+	const auto before = count_rc_ops(*program->module);
+	const auto removed = elide_redundant_rc_mutating(*program->module);
+	const auto after = count_rc_ops(*program->module);
+	QUARK_VERIFY(removed.empty() == false);
+	QUARK_VERIFY(llvm::verifyModule(*program->module, &llvm::errs()) == false);
+
+	for(const auto& e: before){
+		const auto it = removed.find(e.first);
+		const auto pairs_removed = it != removed.end() ? it->second.pairs_removed : 0;
+		QUARK_VERIFY(e.second.retains - after.at(e.first).retains == pairs_removed);
+		QUARK_VERIFY(e.second.releases - after.at(e.first).releases == pairs_removed);
+	}
+
+	//	The program still runs.
+	auto ee = init_llvm_jit(*program);
+	QUARK_VERIFY(ee->_print_output == std::vector<std::string>{ "ab" });
+}
+
+
+static std::string function_ir(const llvm::Function& f){
+	std::string result;
+	llvm::raw_string_ostream stream(result);
+	f.print(stream);
+	return stream.str();
+}
+
+static std::vector<const llvm::CallInst*> get_calls(const llvm::Function& f){
+	std::vector<const llvm::CallInst*> result;
+	for(const auto& bb: f){
+		for(const auto& inst: bb){
+			if(const auto call = llvm::dyn_cast<llvm::CallInst>(&inst)){
+				result.push_back(call);
+			}
+		}
+	}
+	return result;
+}
+
+//	True if bb is only entered when prev == 1, where prev is the value before the atomic decrement.
+static bool is_last_reference_block(const llvm::BasicBlock& bb, const llvm::AtomicRMWInst& dec){
+	const auto pred = bb.getSinglePredecessor();
+	if(pred == nullptr){
+		return false;
+	}
+	const auto br = llvm::dyn_cast<llvm::BranchInst>(pred->getTerminator());
+	if(br == nullptr || br->isConditional() == false || br->getSuccessor(0) != &bb){
+		return false;
+	}
+	const auto cmp = llvm::dyn_cast<llvm::ICmpInst>(br->getCondition());
+	if(cmp == nullptr || cmp->getPredicate() != llvm::ICmpInst::ICMP_EQ || cmp->getOperand(0) != &dec){
+		return false;
+	}
+	const auto one = llvm::dyn_cast<llvm::ConstantInt>(cmp->getOperand(1));
+	return one != nullptr && one->isOne();
+}
+
+QUARK_TEST("", "generate_llvm_ir_program()", "inline retain / release of string and json", "atomic add / sub, runtime called only on last reference"){
+	const auto cu = make_compilation_unit_nolib(
+		R"(
+
+			func string f(string s, json j){
+				return s + to_string(get_json_type(j))
+			}
+
+			print(f("a", json([ 1, 2 ])))
+
+		)",
+		"myfile.floyd"
+	);
+	const auto sem_ast = compile_to_sematic_ast__errors(cu);
+
+	auto settings = make_default_compiler_settings();
+	settings.optimization_level = eoptimization_level::g_no_optimizations_enable_debugging;
+	llvm_instance_t instance;
+	auto program = generate_llvm_ir_program(instance, sem_ast, "myfile.floyd", settings);
+
+	const auto retain_f = program->module->getFunction(k_inline_retain_name);
+	QUARK_VERIFY(retain_f != nullptr);
+	QUARK_VERIFY(function_ir(*retain_f).find("atomicrmw add") != std::string::npos);
+	QUARK_VERIFY(get_calls(*retain_f).empty());
+
+	std::vector<std::string> release_names;
+	for(const auto& f: *program->module){
+		const auto name = f.getName().str();
+		if(name.find(k_inline_release_prefix + "release_") != 0){
+			continue;
+		}
+		release_names.push_back(name);
+
+		const auto ir = function_ir(f);
+		QUARK_VERIFY(ir.find("atomicrmw sub") != std::string::npos);
+
+		const llvm::AtomicRMWInst* dec = nullptr;
+		for(const auto& bb: f){
+			for(const auto& inst: bb){
+				const auto rmw = llvm::dyn_cast<llvm::AtomicRMWInst>(&inst);
+				if(rmw != nullptr && rmw->getOperation() == llvm::AtomicRMWInst::Sub){
+					dec = rmw;
+				}
+			}
+		}
+		QUARK_VERIFY(dec != nullptr);
+
+		//	Exactly one call into the runtime, guarded by prev == 1.
+		const auto calls = get_calls(f);
+		QUARK_VERIFY(calls.size() == 1);
+		QUARK_VERIFY(is_last_reference_block(*calls[0]->getParent(), *dec));
+	}
+	QUARK_VERIFY(std::find(release_names.begin(), release_names.end(), k_inline_release_prefix + "release_json") != release_names.end());
+
+	//	Json is retained inline too: nobody calls the runtime's retain.
+	const auto retain_json_name = encode_runtime_func_link_name("retain_json").s;
+	for(const auto& f: *program->module){
+		for(const auto call: get_calls(f)){
+			const auto callee = call->getCalledFunction();
+			QUARK_VERIFY(callee == nullptr || callee->getName().str() != retain_json_name);
+		}
+	}
+
+	auto ee = init_llvm_jit(*program);
+	QUARK_VERIFY(ee->_print_output == std::vector<std::string>{ "a2" });
+}
+
+
+} // floyd
@@ -0,0 +1,54 @@
+//
+//  floyd_llvm_rc_elision.h
+//  floyd
+//
+//  Created by Marcus Zetterquist on 2026-10-18.
+//  Copyright © 2026 Marcus Zetterquist. All rights reserved.
+//
+
+#ifndef floyd_llvm_rc_elision_hpp
+#define floyd_llvm_rc_elision_hpp
+
+namespace llvm {
+	struct Module;
+}
+
+#include <map>
+#include <string>
+
+namespace floyd {
+
+
+/*
+	Removes retain/release pairs that provably cancel out.
+
+	Floyd values are immutable so a retain of a value followed by a release of the same value is a no-op,
+	unless something in between can drop the last reference to it. Codegen emits this pattern all the
+	time: a temporary is retained when loaded and released right after its last use, a parent collection
+	is retained while an element is read from it, etc. Removing the pair turns the copy into a move.
+
+	The pass works on the IR helpers emitted by generate_retain() / generate_release() and only inside a
+	basic block. Only instructions that can't free anything may sit between the two: any non-call
+	instruction, intrinsics and other retains. Every other call ends the search.
+
+	Run it before optimize_module_mutating(), while the helpers are still calls.
+*/
+
+//	Each removed pair is one retain and one release.
+struct rc_elision_stats_t {
+	int pairs_removed;
+};
+inline bool operator==(const rc_elision_stats_t& lhs, const rc_elision_stats_t& rhs){
+	return lhs.pairs_removed == rhs.pairs_removed;
+}
+
+//	Returns the number of removed retain/release pairs, per function name. Functions without removals are not listed.
+std::map<std::string, rc_elision_stats_t> elide_redundant_rc_mutating(llvm::Module& module);
+
+void trace_rc_elision_stats(const std::map<std::string, rc_elision_stats_t>& stats);
+
+
+} // floyd
+
+
+#endif /* floyd_llvm_rc_elision_hpp */
@@ -16,6 +16,8 @@ static const bool k_trace_function_link_map = false;
 #include "value_features.h"
 #include "floyd_llvm_runtime_functions.h"
 #include "floyd_llvm_intrinsics.h"
+#include "task_scheduler.h"
+#include "process_inbox.h"
 
 #include "text_parser.h"
 #include "os_process.h"
@@ -27,6 +29,7 @@ static const bool k_trace_function_link_map = false;
 #include <llvm/ExecutionEngine/GenericValue.h>
 #include <llvm/ExecutionEngine/MCJIT.h>
 #include <llvm/Support/TargetSelect.h>
+#include <llvm/Support/Host.h>
 #include <llvm/Support/raw_ostream.h>
 #include <llvm/IR/DataLayout.h>
 
@@ -36,6 +39,7 @@ static const bool k_trace_function_link_map = false;
 #include <thread>
 #include <deque>
 #include <condition_variable>
+#include <atomic>
 #include <iostream>
 
 
@@ -515,10 +519,16 @@ static std::unique_ptr<llvm_execution_engine_t> make_engine_no_init(llvm_instanc
 
 	std::string collectedErrors;
 
+	//	Generate machine code for the host CPU (AVX2 etc.) at the requested optimization level,
+	//	so the JIT matches what floyd compile produces.
+	const auto opt_level = get_codegen_opt_level(program_breaks.settings.optimization_level);
+
 	//	WARNING: Destroys p -- uses std::move().
 	llvm::ExecutionEngine* exeEng = llvm::EngineBuilder(std::move(program_breaks.module))
 		.setErrorStr(&collectedErrors)
-		.setOptLevel(llvm::CodeGenOpt::Level::None)
+		.setOptLevel(opt_level)
+		.setMCPU(llvm::sys::getHostCPUName())
+		.setMAttrs(get_host_cpu_features())
 		.setVerifyModules(true)
 		.setEngineKind(llvm::EngineKind::JIT)
 		.create();
@@ -670,67 +680,149 @@ std::unique_ptr<llvm_execution_engine_t> init_llvm_jit(llvm_ir_program_t& progra
 
 struct process_interface {
 	virtual ~process_interface(){};
-	virtual void on_message(const json_t& message) = 0;
+	virtual void on_message(runtime_value_t message, type_t message_type) = 0;
 	virtual void on_init() = 0;
 };
 
 
-//	NOTICE: Each process inbox has its own mutex + condition variable.
+//	A message in a clock bus inbox, in its native form. The inbox holds one RC of the value: the
+//	value is shared with the sender, not copied.
+struct llvm_message_t {
+	runtime_value_t value;
+	runtime_type_t type;
+
+	//	The receiving process.
+	int process_id;
+};
+
 //	No mutex protects cout.
 struct llvm_process_t {
-	std::condition_variable _inbox_condition_variable;
-	std::mutex _inbox_mutex;
-	std::deque<json_t> _inbox;
-
 	std::string _name_key;
 	std::string _function_key;
-	std::thread::id _thread_id;
+	int _clock_bus_id;
 
 //	std::shared_ptr<interpreter_t> _interpreter;
 	std::shared_ptr<llvm_bind_t> _init_function;
 	std::shared_ptr<llvm_bind_t> _process_function;
-	value_t _process_state;
+
+	//	Owns one RC. Handed directly to the message handler, no conversion to value_t.
+	runtime_value_t _process_state;
+	type_t _process_state_type;
 	std::shared_ptr<process_interface> _processor;
+
+	//	Number of messages to this process waiting in the clock bus inbox. A synchronous send must not
+	//	overtake them.
+	std::atomic<int64_t> _queued_count;
+
+	//	These are only accessed by the thread currently running the process's clock bus.
+	//	_running is true while the message handler executes, _stopped when the process has received "stop".
+	bool _running;
+	bool _stopped;
+};
+
+/*
+	All processes on the same clock bus run on one thread at a time and share one inbox, see manual
+	"SYNCHRONOUS PROCESSES". When a message handler sends to another process on its own clock bus, the
+	receiver's handler is called right away, like a function call, without going through the inbox.
+
+	NOTICE: Each clock bus inbox is a lock-free queue, see process_inbox.h.
+*/
+struct llvm_clock_bus_t {
+	std::string _name_key;
+	std::vector<int> _process_ids;
+	std::thread::id _thread_id;
+
+	process_inbox_t<llvm_message_t> _inbox;
+
+	//	process_scheduling::worker_pool: true while a task for this clock bus is queued or running on the
+	//	scheduler, or while the runtime is starting up. Only the sender that flips it from false to true
+	//	posts a task, this guarantees a clock bus never runs on two workers at once.
+	std::atomic<bool> _scheduled;
 };
 
 struct llvm_process_runtime_t {
 	container_t _container;
-	std::map<std::string, std::string> _process_infos;
 	std::thread::id _main_thread_id;
 
 	llvm_execution_engine_t* ee;
 
 	std::vector<std::shared_ptr<llvm_process_t>> _processes;
+	std::vector<std::shared_ptr<llvm_clock_bus_t>> _clock_busses;
+
+	//	process_scheduling::thread_per_clock_bus
 	std::vector<std::thread> _worker_threads;
+
+	//	process_scheduling::worker_pool
+	std::unique_ptr<task_scheduler_t> _scheduler;
+	task_group_t _process_tasks;
 };
 
+//	A scheduled clock bus handles at most this many messages before it goes back into the run queue, so a
+//	busy clock bus cannot starve the others.
+static const size_t k_process_slice_message_count = 64;
+
+//	The clock bus the current thread is executing a message handler for, else nullptr.
+static thread_local const llvm_clock_bus_t* tl_running_clock_bus = nullptr;
+
 /*
 ??? have ONE runtime PER computer or one per interpreter?
 ??? Separate system-interpreter (all processes and many clock busses) vs ONE thread of execution?
 */
 
-static void send_message(llvm_process_runtime_t& runtime, int process_id, const json_t& message){
+static void schedule_clock_bus(llvm_process_runtime_t& runtime, int clock_bus_id);
+static void process_message(llvm_process_runtime_t& runtime, llvm_process_t& process, const llvm_message_t& message);
+
+//	Retains message: the inbox keeps it until the process has handled it.
+static void send_message(llvm_process_runtime_t& runtime, int process_id, runtime_value_t message, runtime_type_t message_type){
 	auto& process = *runtime._processes[process_id];
+	auto& clock_bus = *runtime._clock_busses[process._clock_bus_id];
+	auto& backend = runtime.ee->backend;
 
-    {
-        std::lock_guard<std::mutex> lk(process._inbox_mutex);
-        process._inbox.push_front(message);
-        if(k_trace_process_messaging){
-        	QUARK_TRACE("Notifying...");
-		}
-    }
-    process._inbox_condition_variable.notify_one();
-//    process._inbox_condition_variable.notify_all();
+	if(is_rc_value(peek2(backend.types, type_t(message_type)))){
+		retain_value(backend, message, type_t(message_type));
+	}
+	const auto message2 = llvm_message_t{ message, message_type, process_id };
+
+	//	Synchronous send: we are a handler on the receiver's clock bus. A receiver that is already running
+	//	higher up on the call stack, like a process sending to itself, gets the message via the inbox instead.
+	if(tl_running_clock_bus == &clock_bus && process._running == false && process._queued_count == 0){
+		process_message(runtime, process, message2);
+		return;
+	}
+
+	//	Wakes the clock bus if it is parked in wait_for_messages().
+	process._queued_count++;
+	push_message(clock_bus._inbox, message2);
+	if(k_trace_process_messaging){
+		QUARK_TRACE("Notifying...");
+	}
+
+	if(runtime._scheduler && clock_bus._scheduled.exchange(true) == false){
+		schedule_clock_bus(runtime, process._clock_bus_id);
+	}
 }
 
-static void run_process(llvm_process_runtime_t& runtime, int process_id){
-	auto& process = *runtime._processes[process_id];
-	bool stop = false;
-	auto& types = runtime.ee->backend.types;
+static bool is_stop_message(const value_backend_t& backend, const llvm_message_t& message){
+	if(peek2(backend.types, type_t(message.type)).is_json() && message.value.json_ptr != nullptr){
+		const auto& json = message.value.json_ptr->get_json();
+		return json.is_string() && json.get_string() == "stop";
+	}
+	else{
+		return false;
+	}
+}
 
-	const auto thread_name = get_current_thread_name();
+static void release_process_state(llvm_process_runtime_t& runtime, llvm_process_t& process){
+	if(process._init_function != nullptr && is_rc_value(peek2(runtime.ee->backend.types, process._process_state_type))){
+		release_value(runtime.ee->backend, process._process_state, process._process_state_type);
+	}
+	process._process_state = make_blank_runtime_value();
+}
 
-	const type_t process_state_type = process._init_function != nullptr ? peek2(types, process._init_function->type).get_function_return(types) : make_undefined();
+static void init_process(llvm_process_runtime_t& runtime, llvm_process_t& process){
+	auto& types = runtime.ee->backend.types;
+
+	process._process_state_type = process._init_function != nullptr ? peek2(types, process._init_function->type).get_function_return(types) : make_undefined();
 
 	if(process._processor){
 		process._processor->on_init();
@@ -738,63 +830,269 @@ static void run_process(llvm_process_runtime_t& runtime, int process_id){
 
 	if(process._init_function != nullptr){
 		//	!!! This validation should be done earlier in the startup process / compilation process.
-		if(process._init_function->type != make_process_init_type(types, process_state_type)){
+		if(process._init_function->type != make_process_init_type(types, process._process_state_type)){
 			quark::throw_runtime_error("Invalid function prototype for process-init");
 		}
 
 		auto f = reinterpret_cast<FLOYD_RUNTIME_PROCESS_INIT>(process._init_function->address);
-		const auto result = (*f)(make_runtime_ptr(runtime.ee));
-		process._process_state = from_runtime_value(*runtime.ee, result, peek2(types, process._init_function->type).get_function_return(types));
+		process._process_state = (*f)(make_runtime_ptr(runtime.ee));
 	}
+}
 
-	while(stop == false){
-		json_t message;
-		{
-			std::unique_lock<std::mutex> lk(process._inbox_mutex);
+//	Marks the process as running on its clock bus while its message handler executes.
+struct running_handler_scope_t {
+	running_handler_scope_t(const llvm_clock_bus_t& clock_bus, llvm_process_t& process) :
+		_prev_clock_bus(tl_running_clock_bus),
+		_process(process)
+	{
+		QUARK_ASSERT(process._running == false);
+
+		tl_running_clock_bus = &clock_bus;
+		_process._running = true;
+	}
+	~running_handler_scope_t(){
+		_process._running = false;
+		tl_running_clock_bus = _prev_clock_bus;
+	}
+
+	const llvm_clock_bus_t* _prev_clock_bus;
+	llvm_process_t& _process;
+};
+
+//	Handles one message and releases it. Messages that arrive after "stop" are only released.
+static void process_message(llvm_process_runtime_t& runtime, llvm_process_t& process, const llvm_message_t& message){
+	auto& types = runtime.ee->backend.types;
+
+	const auto message_type = type_t(message.type);
+	if(k_trace_process_messaging){
+		QUARK_TRACE_SS("RECEIVED: " << json_to_pretty_string(value_and_type_to_ast_json(types, from_runtime_value(*runtime.ee, message.value, message_type))));
+	}
+
+	if(process._stopped){
+	}
+	else if(is_stop_message(runtime.ee->backend, message)){
+		process._stopped = true;
+		if(k_trace_process_messaging){
+			QUARK_TRACE_SS(process._name_key << ": STOP");
+		}
+	}
+	else{
+		const running_handler_scope_t scope(*runtime._clock_busses[process._clock_bus_id], process);
+
+		if(process._processor){
+			process._processor->on_message(message.value, message_type);
+		}
 
-			if(k_trace_process_messaging){
-        		QUARK_TRACE_SS(thread_name << ": waiting......");
+		if(process._process_function != nullptr){
+			//	!!! This validation should be done earlier in the startup process / compilation process.
+			if(process._process_function->type != make_process_message_handler_type(types, process._process_state_type)){
+				quark::throw_runtime_error("Invalid function prototype for process message handler");
 			}
-			process._inbox_condition_variable.wait(lk, [&]{ return process._inbox.empty() == false; });
-			if(k_trace_process_messaging){
-        		QUARK_TRACE_SS(thread_name << ": continue");
+
+			//	The handler borrows the state and returns the new state with its own RC.
+			auto f = reinterpret_cast<FLOYD_RUNTIME_PROCESS_MESSAGE>(process._process_function->address);
+			const auto result = (*f)(make_runtime_ptr(runtime.ee), process._process_state, message.value);
+			release_process_state(runtime, process);
+			process._process_state = result;
+		}
+	}
+
+	if(is_rc_value(peek2(types, message_type))){
+		release_value(runtime.ee->backend, message.value, message_type);
+	}
+}
+
+//	Handles a message popped from a clock bus inbox.
+static void dispatch_message(llvm_process_runtime_t& runtime, const llvm_message_t& message){
+	auto& process = *runtime._processes[message.process_id];
+	process._queued_count--;
+	process_message(runtime, process, message);
+}
+
+static void init_clock_bus(llvm_process_runtime_t& runtime, llvm_clock_bus_t& clock_bus){
+	for(const auto process_id: clock_bus._process_ids){
+		init_process(runtime, *runtime._processes[process_id]);
+	}
+}
+
+static bool is_clock_bus_stopped(const llvm_process_runtime_t& runtime, const llvm_clock_bus_t& clock_bus){
+	return std::all_of(clock_bus._process_ids.begin(), clock_bus._process_ids.end(), [&](int process_id){ return runtime._processes[process_id]->_stopped; });
+}
+
+//	Releases all process states and any messages still in the inboxes.
+static void release_processes(llvm_process_runtime_t& runtime){
+	auto& types = runtime.ee->backend.types;
+
+	for(auto& process: runtime._processes){
+		release_process_state(runtime, *process);
+	}
+
+	for(auto& clock_bus: runtime._clock_busses){
+		llvm_message_t messages[k_inbox_batch_size];
+		size_t count = 0;
+		do {
+			count = pop_messages(clock_bus->_inbox, messages, k_inbox_batch_size);
+			for(size_t i = 0 ; i < count ; i++){
+				const auto& e = messages[i];
+				if(is_rc_value(peek2(types, type_t(e.type)))){
+					release_value(runtime.ee->backend, e.value, type_t(e.type));
+				}
 			}
+		} while(count > 0);
+	}
+}
+
+static void trace_inbox_stats(const llvm_process_runtime_t& runtime){
+	std::vector<std::pair<std::string, inbox_stats_t>> stats;
+	for(const auto& clock_bus: runtime._clock_busses){
+		stats.push_back({ clock_bus->_name_key, get_inbox_stats(clock_bus->_inbox) });
+	}
+
+	QUARK_SCOPED_TRACE("CLOCK BUS INBOXES");
+	QUARK_TRACE(format_inbox_stats(stats));
+}
+
+
+
+//////////////////////////////////////		process_scheduling::thread_per_clock_bus
+
+
+/*
+	One OS thread per clock bus, blocking on its inbox. Unlike worker_pool, a thread can't tell "idle" from
+	"done", so the runtime is done only when every process has received "stop".
+*/
+
+
+static void run_clock_bus_thread(llvm_process_runtime_t& runtime, int clock_bus_id){
+	auto& clock_bus = *runtime._clock_busses[clock_bus_id];
+
+	const auto thread_name = get_current_thread_name();
+
+	init_clock_bus(runtime, clock_bus);
 
-			//	Pop message.
-			QUARK_ASSERT(process._inbox.empty() == false);
-			message = process._inbox.back();
-			process._inbox.pop_back();
+	while(is_clock_bus_stopped(runtime, clock_bus) == false){
+		if(k_trace_process_messaging){
+			QUARK_TRACE_SS(thread_name << ": waiting......");
 		}
 
+		//	Handle every message we got in this wakeup, even after a "stop": that just releases them.
+		llvm_message_t messages[k_inbox_batch_size];
+		const auto count = wait_for_messages(clock_bus._inbox, messages, k_inbox_batch_size);
 		if(k_trace_process_messaging){
-			QUARK_TRACE_SS("RECEIVED: " << json_to_pretty_string(message));
+			QUARK_TRACE_SS(thread_name << ": continue");
+		}
+
+		for(size_t i = 0 ; i < count ; i++){
+			dispatch_message(runtime, messages[i]);
 		}
+	}
+}
+
+static void run_processes_on_threads(llvm_process_runtime_t& runtime){
+	//	Remember that current thread (main) is also a thread, no need to create a worker thread for one clock bus.
+	runtime._clock_busses[0]->_thread_id = runtime._main_thread_id;
+
+	for(int clock_bus_id = 1 ; clock_bus_id < runtime._clock_busses.size() ; clock_bus_id++){
+		runtime._worker_threads.push_back(std::thread([&](int clock_bus_id){
+
+//			const auto native_thread = thread::native_handle();
+
+			std::stringstream thread_name;
+			thread_name << std::string() << "clock bus " << clock_bus_id << " thread";
+#if QUARK_MAC
+			pthread_setname_np(/*pthread_self(),*/ thread_name.str().c_str());
+#endif
+
+			run_clock_bus_thread(runtime, clock_bus_id);
+		}, clock_bus_id));
+	}
+
+	run_clock_bus_thread(runtime, 0);
+
+	for(auto &t: runtime._worker_threads){
+		t.join();
+	}
+}
+
+
+
+//////////////////////////////////////		process_scheduling::worker_pool
 
-		if(message.is_string() && message.get_string() == "stop"){
-			stop = true;
-			if(k_trace_process_messaging){
-        		QUARK_TRACE_SS(thread_name << ": STOP");
+
+/*
+	M:N scheduling: all clock busses share one task_scheduler_t with a fixed number of worker threads, sized
+	from the hardware caps. A clock bus with messages is one task in a worker's deque, idle workers steal.
+	A clock bus without messages has no task and costs no thread. The main thread helps running tasks.
+
+	The runtime is done when no task is queued or running: then every process is either stopped or
+	waiting for a message that nobody can send anymore.
+*/
+
+
+//	Runs on a worker: handles up to k_process_slice_message_count messages, then gives the worker back.
+static void run_clock_bus_slice(llvm_process_runtime_t& runtime, int clock_bus_id){
+	auto& clock_bus = *runtime._clock_busses[clock_bus_id];
+	QUARK_ASSERT(clock_bus._scheduled);
+
+	size_t handled_count = 0;
+	while(true){
+		llvm_message_t messages[k_inbox_batch_size];
+		const auto count = pop_messages(clock_bus._inbox, messages, k_inbox_batch_size);
+		if(count > 0){
+			for(size_t i = 0 ; i < count ; i++){
+				dispatch_message(runtime, messages[i]);
+			}
+			handled_count += count;
+
+			if(handled_count >= k_process_slice_message_count){
+				//	Still marked as scheduled: go to the back of the line.
+				schedule_clock_bus(runtime, clock_bus_id);
+				return;
 			}
 		}
 		else{
-			if(process._processor){
-				process._processor->on_message(message);
+			//	Clear the flag then look again: a sender that pushed before we cleared it did not schedule us.
+			//	We no longer own the clock bus, so only look at incoming. batch is empty since pop_messages() returned 0.
+			clock_bus._scheduled = false;
+			if(has_incoming_messages(clock_bus._inbox) == false || clock_bus._scheduled.exchange(true) == true){
+				return;
 			}
+		}
+	}
+}
 
-			if(process._process_function != nullptr){
-				//	!!! This validation should be done earlier in the startup process / compilation process.
-				if(process._process_function->type != make_process_message_handler_type(types, process_state_type)){
-					quark::throw_runtime_error("Invalid function prototype for process message handler");
-				}
+static void schedule_clock_bus(llvm_process_runtime_t& runtime, int clock_bus_id){
+	QUARK_ASSERT(runtime._scheduler);
 
-				auto f = reinterpret_cast<FLOYD_RUNTIME_PROCESS_MESSAGE>(process._process_function->address);
-				const auto state2 = to_runtime_value(*runtime.ee, process._process_state);
-				const auto message2 = to_runtime_value(*runtime.ee, value_t::make_json(message));
-				const auto result = (*f)(make_runtime_ptr(runtime.ee), state2, message2);
-				process._process_state = from_runtime_value(*runtime.ee, result, peek2(types, process._process_function->type).get_function_return(types));
-			}
+	post_task(*runtime._scheduler, runtime._process_tasks, [&runtime, clock_bus_id](){
+		run_clock_bus_slice(runtime, clock_bus_id);
+	});
+}
+
+static void run_processes_on_worker_pool(llvm_process_runtime_t& runtime){
+	//	The main thread also runs tasks.
+	runtime._scheduler = std::make_unique<task_scheduler_t>(std::max(get_hardware_worker_count() - 1, 1));
+
+	//	All clock busses are marked as scheduled while they init, so messages sent during init are only queued.
+	{
+		task_group_t init_tasks;
+		for(auto& clock_bus: runtime._clock_busses){
+			post_task(*runtime._scheduler, init_tasks, [&runtime, clock_bus](){
+				init_clock_bus(runtime, *clock_bus);
+			});
+		}
+		wait_for_task_group(*runtime._scheduler, init_tasks);
+	}
+
+	for(int clock_bus_id = 0 ; clock_bus_id < runtime._clock_busses.size() ; clock_bus_id++){
+		auto& clock_bus = *runtime._clock_busses[clock_bus_id];
+		clock_bus._scheduled = false;
+		if(has_incoming_messages(clock_bus._inbox) && clock_bus._scheduled.exchange(true) == false){
+			schedule_clock_bus(runtime, clock_bus_id);
 		}
 	}
+
+	wait_for_task_group(*runtime._scheduler, runtime._process_tasks);
 }
 
 
@@ -809,20 +1107,22 @@ static std::map<std::string, value_t> run_processes(llvm_execution_engine_t& ee)
 
 		runtime._container = ee.container_def;
 
-		runtime._process_infos = reduce(runtime._container._clock_busses, std::map<std::string, std::string>(), [](const std::map<std::string, std::string>& acc, const std::pair<std::string, clock_bus_t>& e){
-			auto acc2 = acc;
-			acc2.insert(e.second._processes.begin(), e.second._processes.end());
-			return acc2;
-		});
-
-		struct my_interpreter_handler_t : public runtime_handler_i {
+		struct my_interpreter_handler_t : public llvm_runtime_handler_i {
 			my_interpreter_handler_t(llvm_process_runtime_t& runtime) : _runtime(runtime) {}
 
 			virtual void on_send(const std::string& process_id, const json_t& message){
+				auto& backend = _runtime.ee->backend;
+				const runtime_value_t message2 = { .json_ptr = alloc_json(backend.heap, message) };
+				const auto json_type = type_t::make_json();
+				on_send_value(process_id, message2, make_runtime_type(json_type));
+				release_value(backend, message2, json_type);
+			}
+
+			virtual void on_send_value(const std::string& process_id, runtime_value_t message, runtime_type_t message_type){
 				const auto it = std::find_if(_runtime._processes.begin(), _runtime._processes.end(), [&](const std::shared_ptr<llvm_process_t>& process){ return process->_name_key == process_id; });
 				if(it != _runtime._processes.end()){
 					const auto process_index = it - _runtime._processes.begin();
-					send_message(_runtime, static_cast<int>(process_index), message);
+					send_message(_runtime, static_cast<int>(process_index), message, message_type);
 				}
 			}
 
@@ -834,41 +1134,42 @@ static std::map<std::string, value_t> run_processes(llvm_execution_engine_t& ee)
 
 		ee._handler = &my_interpreter_handler;
 
-		for(const auto& t: runtime._process_infos){
-			auto process = std::make_shared<llvm_process_t>();
-			process->_name_key = t.first;
-			process->_function_key = t.second;
-	//		process->_interpreter = std::make_shared<interpreter_t>(program, &my_interpreter_handler);
-
-			process->_init_function = std::make_shared<llvm_bind_t>(bind_function2(*runtime.ee, encode_floyd_func_link_name(t.second + "__init")));
-			process->_process_function = std::make_shared<llvm_bind_t>(bind_function2(*runtime.ee, encode_floyd_func_link_name(t.second)));
-
-			runtime._processes.push_back(process);
+		for(const auto& c: runtime._container._clock_busses){
+			auto clock_bus = std::make_shared<llvm_clock_bus_t>();
+			clock_bus->_name_key = c.first;
+			clock_bus->_scheduled = true;
+
+			for(const auto& t: c.second._processes){
+				auto process = std::make_shared<llvm_process_t>();
+				process->_name_key = t.first;
+				process->_function_key = t.second;
+				process->_clock_bus_id = static_cast<int>(runtime._clock_busses.size());
+				process->_process_state = make_blank_runtime_value();
+				process->_process_state_type = make_undefined();
+				process->_queued_count = 0;
+				process->_running = false;
+				process->_stopped = false;
+		//		process->_interpreter = std::make_shared<interpreter_t>(program, &my_interpreter_handler);
+
+				process->_init_function = std::make_shared<llvm_bind_t>(bind_function2(*runtime.ee, encode_floyd_func_link_name(t.second + "__init")));
+				process->_process_function = std::make_shared<llvm_bind_t>(bind_function2(*runtime.ee, encode_floyd_func_link_name(t.second)));
+
+				clock_bus->_process_ids.push_back(static_cast<int>(runtime._processes.size()));
+				runtime._processes.push_back(process);
+			}
+			runtime._clock_busses.push_back(clock_bus);
 		}
 
-		//	Remember that current thread (main) is also a thread, no need to create a worker thread for one process.
-		runtime._processes[0]->_thread_id = runtime._main_thread_id;
-
-		for(int process_id = 1 ; process_id < runtime._processes.size() ; process_id++){
-			runtime._worker_threads.push_back(std::thread([&](int process_id){
-
-	//			const auto native_thread = thread::native_handle();
-
-				std::stringstream thread_name;
-				thread_name << std::string() << "process " << process_id << " thread";
-	#if QUARK_MAC
-				pthread_setname_np(/*pthread_self(),*/ thread_name.str().c_str());
-	#endif
-
-				run_process(runtime, process_id);
-			}, process_id));
+		if(ee.config.process_scheduling_mode == process_scheduling::thread_per_clock_bus){
+			run_processes_on_threads(runtime);
 		}
-
-		run_process(runtime, 0);
-
-		for(auto &t: runtime._worker_threads){
-			t.join();
+		else{
+			run_processes_on_worker_pool(runtime);
 		}
+		if(k_trace_process_messaging){
+			trace_inbox_stats(runtime);
+		}
+		release_processes(runtime);
 
 		return {};
 	}
@@ -925,6 +1226,10 @@ std::vector<benchmark_result2_t> run_benchmarks(llvm_execution_engine_t& ee, con
 	const auto benchmark_result_vec_type = benchmark_result_vec_type_symbol._value_type;
 
 //	const types_t& types = ee.backend.types;
+
+	//	Everything a benchmark allocates, including its result vector, is freed at once when it's done.
+	heap_t arena(ee.backend.heap.record_allocs_flag, heap_mode::arena);
+
 	std::vector<benchmark_result2_t> result;
 	for(const auto& b: tests){
 		const auto name = b.benchmark_id.test;
@@ -933,11 +1238,15 @@ std::vector<benchmark_result2_t> run_benchmarks(llvm_execution_engine_t& ee, con
 		const auto f_bind = bind_function2(ee, f_link_name);
 		QUARK_ASSERT(f_bind.address != nullptr);
 		auto f2 = reinterpret_cast<FLOYD_BENCHMARK_F>(f_bind.address);
+		ee.benchmark_stats_log.clear();
+
+		heap_arena_scope_t arena_scope(ee.backend.heap, arena);
 		const auto bench_result = (*f2)(make_runtime_ptr(&ee));
 		const auto result2 = from_runtime_value(ee, bench_result, benchmark_result_vec_type);
 
 //			QUARK_TRACE(value_and_type_to_string(result2));
 
+		auto stats_log = ee.benchmark_stats_log;
 		std::vector<benchmark_result2_t> test_result;
 		const auto& vec_result = result2.get_vector_value();
 		for(const auto& m: vec_result){
@@ -946,7 +1255,8 @@ std::vector<benchmark_result2_t> run_benchmarks(llvm_execution_engine_t& ee, con
 				struct_result->_member_values[0].get_int_value(),
 				struct_result->_member_values[1].get_json()
 			};
-			const auto x = benchmark_result2_t { b.benchmark_id, result3 };
+			const auto stats = take_benchmark_stats(stats_log, result3.dur);
+			const auto x = benchmark_result2_t { b.benchmark_id, result3, stats };
 			test_result.push_back(x);
 		}
 		result = concat(result, test_result);
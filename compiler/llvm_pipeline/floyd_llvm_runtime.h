@@ -12,6 +12,7 @@
 #include "value_backend.h"
 #include "floyd_llvm_types.h"
 #include "value_thunking.h"
+#include "floyd_runtime.h"
 #include <llvm/IR/IRBuilder.h>
 
 #include <string>
@@ -26,7 +27,6 @@ namespace llvm {
 namespace floyd {
 
 struct llvm_ir_program_t;
-struct runtime_handler_i;
 struct run_output_t;
 struct floyd_runtime_t;
 struct llvm_instance_t;
@@ -96,6 +96,13 @@ void trace_function_link_map(const types_t& types, const std::vector<function_li
 const uint64_t k_debug_magic = 0xFACEFEED05050505;
 
 
+//	Lets send() pass messages in their native form: the handler gets the runtime value, not a json_t copy.
+struct llvm_runtime_handler_i : public runtime_handler_i {
+	//	message is borrowed: retain it to keep it.
+	virtual void on_send_value(const std::string& process_id, runtime_value_t message, runtime_type_t message_type) = 0;
+};
+
+
 struct llvm_execution_engine_t {
 	~llvm_execution_engine_t();
 	bool check_invariant() const;
@@ -117,7 +124,7 @@ struct llvm_execution_engine_t {
 	std::vector<function_link_entry_t> function_link_map;
 	public: std::vector<std::string> _print_output;
 
-	public: runtime_handler_i* _handler;
+	public: llvm_runtime_handler_i* _handler;
 
 	public: const std::chrono::time_point<std::chrono::high_resolution_clock> _start_time;
 
@@ -125,6 +132,9 @@ struct llvm_execution_engine_t {
 	llvm_bind_t main_function;
 	bool inited;
 	config_t config;
+
+	//	Statistics of each executed benchmark expression, in execution order.
+	std::vector<benchmark_stats_t> benchmark_stats_log;
 };
 
 
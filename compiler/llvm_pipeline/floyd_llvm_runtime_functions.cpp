@@ -244,6 +244,70 @@ static std::vector<function_bind_t> floydrt_concatunate_vectors__make(llvm::LLVM
 	return {{ "concatunate_vectors", function_type, reinterpret_cast<void*>(floydrt_concatunate_vectors) }};
 }
 
+//	Takes over the caller's reference to lhs, see concat_inplace__string().
+static runtime_value_t floydrt_concatunate_vectors_inplace(floyd_runtime_t* frp, runtime_type_t type, runtime_value_t lhs, runtime_value_t rhs){
+	auto& r = get_floyd_runtime(frp);
+	QUARK_ASSERT(lhs.check_invariant());
+	QUARK_ASSERT(rhs.check_invariant());
+
+	const auto type0 = type_t(type);
+	if(peek2(r.backend.types, type0).is_string()){
+		return concat_inplace__string(r.backend, lhs, rhs);
+	}
+	else if(is_vector_carray(r.backend.types, r.backend.config, type_t(type))){
+		return concat_inplace__vector_carray(r.backend, type0, lhs, rhs);
+	}
+	else if(is_vector_hamt(r.backend.types, r.backend.config, type_t(type))){
+		const auto result = concat_vector_hamt(r.backend, type0, lhs, rhs);
+		release_vec(r.backend, lhs, type0);
+		return result;
+	}
+	else{
+		QUARK_ASSERT(false);
+		throw std::exception();
+	}
+}
+
+static std::vector<function_bind_t> floydrt_concatunate_vectors_inplace__make(llvm::LLVMContext& context, const llvm_type_lookup& type_lookup){
+	llvm::FunctionType* function_type = llvm::FunctionType::get(
+		make_generic_vec_type_byvalue(type_lookup)->getPointerTo(),
+		{
+			make_frp_type(type_lookup),
+			make_runtime_type_type(type_lookup),
+			make_generic_vec_type_byvalue(type_lookup)->getPointerTo(),
+			make_generic_vec_type_byvalue(type_lookup)->getPointerTo()
+		},
+		false
+	);
+	return {{ "concatunate_vectors_inplace", function_type, reinterpret_cast<void*>(floydrt_concatunate_vectors_inplace) }};
+}
+
+
+
+////////////////////////////////		floydrt_reserve_string()
+
+
+//	Takes over the caller's reference to s, see reserve_string_inplace().
+static runtime_value_t floydrt_reserve_string(floyd_runtime_t* frp, runtime_value_t s, uint64_t capacity){
+	auto& r = get_floyd_runtime(frp);
+	QUARK_ASSERT(s.check_invariant());
+
+	return reserve_string_inplace(r.backend, s, capacity);
+}
+
+static std::vector<function_bind_t> floydrt_reserve_string__make(llvm::LLVMContext& context, const llvm_type_lookup& type_lookup){
+	llvm::FunctionType* function_type = llvm::FunctionType::get(
+		make_generic_vec_type_byvalue(type_lookup)->getPointerTo(),
+		{
+			make_frp_type(type_lookup),
+			make_generic_vec_type_byvalue(type_lookup)->getPointerTo(),
+			llvm::Type::getInt64Ty(context)
+		},
+		false
+	);
+	return {{ "reserve_string", function_type, reinterpret_cast<void*>(floydrt_reserve_string) }};
+}
+
 
 
 
@@ -306,6 +370,9 @@ static const runtime_value_t floydrt_allocate_dict(floyd_runtime_t* frp, runtime
 	else if(is_dict_hamt(r.backend.types, r.backend.config, type_t(type))){
 		return alloc_dict_hamt(r.backend.heap, type_t(type));
 	}
+	else if(is_dict_hashtable(r.backend.types, r.backend.config, type_t(type))){
+		return alloc_dict_hashtable(r.backend.heap, type_t(type));
+	}
 	else{
 		QUARK_ASSERT(false);
 		throw std::exception();
@@ -365,6 +432,22 @@ static runtime_value_t floydrt_lookup_dict_hamt(floyd_runtime_t* frp, runtime_va
 	}
 }
 
+//	Looks up using the key's characters directly, no std::string is created.
+static runtime_value_t floydrt_lookup_dict_hashtable(floyd_runtime_t* frp, runtime_value_t dict, runtime_type_t type, runtime_value_t s){
+	auto& r = get_floyd_runtime(frp);
+	(void)r;
+
+	QUARK_ASSERT(is_dict_hashtable(r.backend.types, r.backend.config, type_t(type)));
+
+	const auto it = dict.dict_hashtable_ptr->get_map().find(get_vec_string_view(s));
+	if(it == nullptr){
+		throw std::exception();
+	}
+	else{
+		return *it;
+	}
+}
+
 static std::vector<function_bind_t> floydrt_lookup_dict_cppmap__make(llvm::LLVMContext& context, const llvm_type_lookup& type_lookup){
 	llvm::FunctionType* function_type = llvm::FunctionType::get(
 		make_runtime_value_type(type_lookup),
@@ -391,6 +474,35 @@ static std::vector<function_bind_t> floydrt_lookup_dict_hamt__make(llvm::LLVMCon
 	);
 	return {{ "lookup_dict_hamt", function_type, reinterpret_cast<void*>(floydrt_lookup_dict_hamt) }};
 }
+static std::vector<function_bind_t> floydrt_lookup_dict_hashtable__make(llvm::LLVMContext& context, const llvm_type_lookup& type_lookup){
+	llvm::FunctionType* function_type = llvm::FunctionType::get(
+		make_runtime_value_type(type_lookup),
+		{
+			make_frp_type(type_lookup),
+			make_generic_dict_type_byvalue(type_lookup)->getPointerTo(),
+			make_runtime_type_type(type_lookup),
+			get_llvm_type_as_arg(type_lookup, type_t::make_string())
+		},
+		false
+	);
+	return {{ "lookup_dict_hashtable", function_type, reinterpret_cast<void*>(floydrt_lookup_dict_hashtable) }};
+}
+
+static std::string get_dict_backend_suffix(dict_backend dict_mode){
+	if(dict_mode == dict_backend::cppmap){
+		return "cppmap";
+	}
+	else if(dict_mode == dict_backend::hamt){
+		return "hamt";
+	}
+	else if(dict_mode == dict_backend::hashtable){
+		return "hashtable";
+	}
+	else{
+		QUARK_ASSERT(false);
+		throw std::exception();
+	}
+}
 
 
 llvm::Value* generate_lookup_dict(llvm_function_generator_t& gen_acc, llvm::Value& dict_reg, const type_t& dict_type, llvm::Value& key_reg, dict_backend dict_mode){
@@ -398,9 +510,9 @@ llvm::Value* generate_lookup_dict(llvm_function_generator_t& gen_acc, llvm::Valu
 	QUARK_ASSERT(dict_type.check_invariant());
 
 	const auto& types = gen_acc.gen.type_lookup.state.types;
-	QUARK_ASSERT(is_dict_cppmap(types, gen_acc.gen.settings.config, dict_type) || is_dict_hamt(types, gen_acc.gen.settings.config, dict_type));
+	QUARK_ASSERT(is_dict_cppmap(types, gen_acc.gen.settings.config, dict_type) || is_dict_hamt(types, gen_acc.gen.settings.config, dict_type) || is_dict_hashtable(types, gen_acc.gen.settings.config, dict_type));
 
-	const auto res = resolve_func(gen_acc.gen.link_map, dict_mode == dict_backend::hamt ? "lookup_dict_hamt" : "lookup_dict_cppmap");
+	const auto res = resolve_func(gen_acc.gen.link_map, "lookup_dict_" + get_dict_backend_suffix(dict_mode));
 
 	const auto dict_peek = peek2(types, dict_type);
 	const auto element_type0 = dict_peek.get_dict_value_type(types);
@@ -442,6 +554,13 @@ static void floydrt_store_dict_mutable_hamt(floyd_runtime_t* frp, runtime_value_
 	const auto key_string = from_runtime_string(r, key);
 	dict.dict_hamt_ptr->get_map_mut() = dict.dict_hamt_ptr->get_map_mut().set(key_string, element_value);
 }
+static void floydrt_store_dict_mutable_hashtable(floyd_runtime_t* frp, runtime_value_t dict, runtime_type_t type, runtime_value_t key, runtime_value_t element_value){
+	auto& r = get_floyd_runtime(frp);
+	(void)r;
+
+	QUARK_ASSERT(is_dict_hashtable(r.backend.types, r.backend.config, type_t(type)));
+	dict.dict_hashtable_ptr->get_map_mut().insert_or_assign(get_vec_string_view(key), element_value);
+}
 
 static std::vector<function_bind_t> floydrt_store_dict_mutable__make(llvm::LLVMContext& context, const llvm_type_lookup& type_lookup){
 	llvm::FunctionType* function_type = llvm::FunctionType::get(
@@ -457,7 +576,8 @@ static std::vector<function_bind_t> floydrt_store_dict_mutable__make(llvm::LLVMC
 	);
 	return {
 		{ "store_dict_mutable_cppmap", function_type, reinterpret_cast<void*>(floydrt_store_dict_mutable_cppmap) },
-		{ "store_dict_mutable_hamt", function_type, reinterpret_cast<void*>(floydrt_store_dict_mutable_hamt) }
+		{ "store_dict_mutable_hamt", function_type, reinterpret_cast<void*>(floydrt_store_dict_mutable_hamt) },
+		{ "store_dict_mutable_hashtable", function_type, reinterpret_cast<void*>(floydrt_store_dict_mutable_hashtable) }
 	};
 }
 
@@ -466,9 +586,9 @@ void generate_store_dict_mutable(llvm_function_generator_t& gen_acc, llvm::Value
 	QUARK_ASSERT(dict_type.check_invariant());
 
 	const auto& types = gen_acc.gen.type_lookup.state.types;
-	QUARK_ASSERT(is_dict_cppmap(types, gen_acc.gen.settings.config, dict_type) || is_dict_hamt(types, gen_acc.gen.settings.config, dict_type));
+	QUARK_ASSERT(is_dict_cppmap(types, gen_acc.gen.settings.config, dict_type) || is_dict_hamt(types, gen_acc.gen.settings.config, dict_type) || is_dict_hashtable(types, gen_acc.gen.settings.config, dict_type));
 
-	const auto res = resolve_func(gen_acc.gen.link_map, dict_mode == dict_backend::hamt ? "store_dict_mutable_hamt" : "store_dict_mutable_cppmap");
+	const auto res = resolve_func(gen_acc.gen.link_map, "store_dict_mutable_" + get_dict_backend_suffix(dict_mode));
 	const auto dict_peek = peek2(types, dict_type);
 
 	const auto& element_type0 = dict_peek.get_dict_value_type(types);
@@ -897,7 +1017,7 @@ llvm::Value* generate_update_struct_member(llvm_function_generator_t& gen_acc, l
 
 
 
-//??? optimize. It is not used for simple types right now.
+//	Not used for bool, int and double: codegen compares those inline.
 static int8_t floydrt_compare_values(floyd_runtime_t* frp, int64_t op, const runtime_type_t type, runtime_value_t lhs, runtime_value_t rhs){
 	auto& r = get_floyd_runtime(frp);
 	return (int8_t)compare_values(r.backend, op, type, lhs, rhs);
@@ -918,15 +1038,32 @@ static std::vector<function_bind_t> floydrt_compare_values__make(llvm::LLVMConte
 	return {{ "compare_values", function_type, reinterpret_cast<void*>(floydrt_compare_values) }};
 }
 
+//	Specialization for strings: no type lookup.
+static int8_t floydrt_compare_strings(floyd_runtime_t* frp, int64_t op, runtime_value_t lhs, runtime_value_t rhs){
+	get_floyd_runtime(frp);
+	return (int8_t)apply_compare_op(op, compare_strings(lhs, rhs));
+}
+
+static std::vector<function_bind_t> floydrt_compare_strings__make(llvm::LLVMContext& context, const llvm_type_lookup& type_lookup){
+	llvm::FunctionType* function_type = llvm::FunctionType::get(
+		llvm::Type::getInt1Ty(context),
+		{
+			make_frp_type(type_lookup),
+			llvm::Type::getInt64Ty(context),
+			make_runtime_value_type(type_lookup),
+			make_runtime_value_type(type_lookup)
+		},
+		false
+	);
+	return {{ "compare_strings", function_type, reinterpret_cast<void*>(floydrt_compare_strings) }};
+}
+
 
 
 static int64_t floydrt_get_profile_time(floyd_runtime_t* frp){
 	get_floyd_runtime(frp);
 
-	const std::chrono::time_point<std::chrono::high_resolution_clock> now = std::chrono::high_resolution_clock::now();
-	const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
-	const auto result = int64_t(ns);
-	return result;
+	return get_profile_time();
 }
 
 static std::vector<function_bind_t> floydrt_get_profile_time__make(llvm::LLVMContext& context, const llvm_type_lookup& type_lookup){
@@ -944,7 +1081,7 @@ static std::vector<function_bind_t> floydrt_get_profile_time__make(llvm::LLVMCon
 static int64_t floydrt_analyse_benchmark_samples(floyd_runtime_t* frp, const int64_t* samples, int64_t index){
 	const bool trace_flag = false;
 
-	get_floyd_runtime(frp);
+	auto& r = get_floyd_runtime(frp);
 
 	QUARK_ASSERT(index >= 2);
 	if(trace_flag){
@@ -956,8 +1093,9 @@ static int64_t floydrt_analyse_benchmark_samples(floyd_runtime_t* frp, const int
 		std::cout << "Samples: " << index << "Total COW time: " << total_acc << std::endl;
 	}
 
-	const auto result = analyse_samples(samples, index);
-	return result;
+	const auto stats = analyse_samples_stats(samples, index);
+	r.benchmark_stats_log.push_back(stats);
+	return stats.min;
 }
 static std::vector<function_bind_t> floydrt_analyse_benchmark_samples__make(llvm::LLVMContext& context, const llvm_type_lookup& type_lookup){
 	llvm::FunctionType* function_type = llvm::FunctionType::get(
@@ -987,6 +1125,104 @@ static std::vector<function_bind_t> floydrt_analyse_benchmark_samples__make(llvm
 
 
 
+////////////////////////////////		INLINE RC
+
+
+/*
+	The hot RC primitives are emitted as IR into each module instead of being calls into the C++ runtime.
+	They have internal linkage and are always-inline, so optimize_module_mutating() sees the atomic
+	operations directly and can hoist, combine and remove them.
+
+	Every RC object starts with a heap_alloc_64_t and its rc is the first 32 bits, see ATOMIC_RC.
+
+	Both skip null: json is null while the runtime inits and deinits globals, and locals are null when
+	unwound before being initialized.
+
+	Release only leaves the IR when it drops the last reference: since we are then the only owner it puts
+	the RC back to 1 and calls the regular floydrt_release_*(), which decrements and disposes.
+*/
+static const bool k_inline_rc = true;
+
+
+static llvm::Function* make_inline_rc_function(llvm_code_generator_t& gen, const std::string& name, llvm::FunctionType* function_type){
+	auto f = llvm::Function::Create(function_type, llvm::Function::InternalLinkage, name, gen.module);
+	f->addFnAttr(llvm::Attribute::AlwaysInline);
+	return f;
+}
+
+//	void floyd_inline_retain(int32_t* rc)
+static llvm::Function* get_inline_retain_function(llvm_code_generator_t& gen){
+	const std::string name = k_inline_retain_name;
+	auto existing_f = gen.module->getFunction(name);
+	if(existing_f != nullptr){
+		return existing_f;
+	}
+
+	auto& context = gen.instance->context;
+	auto function_type = llvm::FunctionType::get(llvm::Type::getVoidTy(context), { llvm::Type::getInt32Ty(context)->getPointerTo() }, false);
+	auto f = make_inline_rc_function(gen, name, function_type);
+
+	auto entry_bb = llvm::BasicBlock::Create(context, "entry", f);
+	auto inc_bb = llvm::BasicBlock::Create(context, "inc", f);
+	auto done_bb = llvm::BasicBlock::Create(context, "done", f);
+
+	llvm::Value* rc_ptr_reg = &*f->arg_begin();
+
+	llvm::IRBuilder<> builder(entry_bb);
+	builder.CreateCondBr(builder.CreateIsNull(rc_ptr_reg), done_bb, inc_bb);
+
+	builder.SetInsertPoint(inc_bb);
+	builder.CreateAtomicRMW(llvm::AtomicRMWInst::Add, rc_ptr_reg, builder.getInt32(1), llvm::AtomicOrdering::Monotonic);
+	builder.CreateBr(done_bb);
+
+	builder.SetInsertPoint(done_bb);
+	builder.CreateRetVoid();
+	return f;
+}
+
+//	Has the same signature as the runtime function it wraps: (frp, value, itype).
+static llvm::Function* get_inline_release_function(llvm_code_generator_t& gen, const std::string& release_name){
+	const std::string name = k_inline_release_prefix + release_name;
+	auto existing_f = gen.module->getFunction(name);
+	if(existing_f != nullptr){
+		return existing_f;
+	}
+
+	const auto& res = resolve_func(gen.link_map, release_name);
+	auto& context = gen.instance->context;
+	auto f = make_inline_rc_function(gen, name, res.llvm_codegen_f->getFunctionType());
+
+	auto entry_bb = llvm::BasicBlock::Create(context, "entry", f);
+	auto dec_bb = llvm::BasicBlock::Create(context, "dec", f);
+	auto last_bb = llvm::BasicBlock::Create(context, "last", f);
+	auto done_bb = llvm::BasicBlock::Create(context, "done", f);
+
+	auto args_it = f->arg_begin();
+	llvm::Value* frp_reg = &*args_it++;
+	llvm::Value* value_reg = &*args_it++;
+	llvm::Value* itype_reg = &*args_it++;
+
+	llvm::IRBuilder<> builder(entry_bb);
+	builder.CreateCondBr(builder.CreateIsNull(value_reg), done_bb, dec_bb);
+
+	builder.SetInsertPoint(dec_bb);
+	auto rc_ptr_reg = builder.CreateCast(llvm::Instruction::CastOps::BitCast, value_reg, builder.getInt32Ty()->getPointerTo(), "");
+	auto prev_rc_reg = builder.CreateAtomicRMW(llvm::AtomicRMWInst::Sub, rc_ptr_reg, builder.getInt32(1), llvm::AtomicOrdering::Monotonic);
+	builder.CreateCondBr(builder.CreateICmpEQ(prev_rc_reg, builder.getInt32(1)), last_bb, done_bb);
+
+	builder.SetInsertPoint(last_bb);
+	builder.CreateAtomicRMW(llvm::AtomicRMWInst::Add, rc_ptr_reg, builder.getInt32(1), llvm::AtomicOrdering::Monotonic);
+	builder.CreateCall(res.llvm_codegen_f, { frp_reg, value_reg, itype_reg }, "");
+	builder.CreateBr(done_bb);
+
+	builder.SetInsertPoint(done_bb);
+	builder.CreateRetVoid();
+	return f;
+}
+
+
+
+
 ////////////////////////////////		RETAIN
 
 
@@ -1037,6 +1273,17 @@ static void floydrt_retain_dict_hamt(floyd_runtime_t* frp, runtime_value_t dict,
 
 	retain_dict_hamt(r.backend, dict, type_t(type0));
 }
+static void floydrt_retain_dict_hashtable(floyd_runtime_t* frp, runtime_value_t dict, runtime_type_t type0){
+	auto& r = get_floyd_runtime(frp);
+#if DEBUG
+	const auto& type = lookup_type_ref(r.backend, type0);
+	QUARK_ASSERT(is_rc_value(peek2(r.backend.types, type)));
+	QUARK_ASSERT(peek2(r.backend.types, type).is_dict());
+	QUARK_ASSERT(is_dict_hashtable(r.backend.types, r.backend.config, type));
+#endif
+
+	retain_dict_hashtable(r.backend, dict, type_t(type0));
+}
 
 
 
@@ -1072,6 +1319,50 @@ const auto& type = lookup_type_ref(r.backend, type0);
 
 
 
+static std::string get_retain_func_name(const types_t& types, const config_t& config, const type_t& type){
+	const auto peek = peek2(types, type);
+	if(peek.is_string()){
+		return "retain_vector_carray";
+	}
+	else if(peek.is_vector()){
+		if(is_vector_carray(types, config, type)){
+			return "retain_vector_carray";
+		}
+		else if(is_vector_hamt(types, config, type)){
+			return "retain_vector_hamt";
+		}
+		else{
+			QUARK_ASSERT(false);
+			throw std::exception();
+		}
+	}
+	else if(peek.is_dict()){
+		if(is_dict_cppmap(types, config, type)){
+			return "retain_dict_cppmap";
+		}
+		else if(is_dict_hamt(types, config, type)){
+			return "retain_dict_hamt";
+		}
+		else if(is_dict_hashtable(types, config, type)){
+			return "retain_dict_hashtable";
+		}
+		else{
+			QUARK_ASSERT(false);
+			throw std::exception();
+		}
+	}
+	else if(peek.is_json()){
+		return "retain_json";
+	}
+	else if(peek.is_struct()){
+		return "retain_struct";
+	}
+	else{
+		QUARK_ASSERT(false);
+		throw std::exception();
+	}
+}
+
 void generate_retain(llvm_function_generator_t& gen_acc, llvm::Value& value_reg, const type_t& type0){
 	QUARK_ASSERT(gen_acc.gen.type_lookup.check_invariant());
 	QUARK_ASSERT(type0.check_invariant());
@@ -1084,39 +1375,9 @@ void generate_retain(llvm_function_generator_t& gen_acc, llvm::Value& value_reg,
 	auto& builder = gen_acc.get_builder();
 
 	if(is_rc_value(type_peek)){
-		if(type_peek.is_string()){
-			const auto res = resolve_func(gen_acc.gen.link_map, "retain_vector_carray");
-			builder.CreateCall(res.llvm_codegen_f, { &frp_reg, &value_reg, &itype_reg }, "");
-		}
-		else if(type_peek.is_vector()){
-			if(is_vector_carray(types, gen_acc.gen.settings.config, type0)){
-				const auto res = resolve_func(gen_acc.gen.link_map, "retain_vector_carray");
-				builder.CreateCall(res.llvm_codegen_f, { &frp_reg, &value_reg, &itype_reg }, "");
-			}
-			else if(is_vector_hamt(types, gen_acc.gen.settings.config, type0)){
-				const auto res = resolve_func(gen_acc.gen.link_map, "retain_vector_hamt");
-				builder.CreateCall(res.llvm_codegen_f, { &frp_reg, &value_reg, &itype_reg }, "");
-			}
-			else{
-				QUARK_ASSERT(false);
-			}
-		}
-		else if(type_peek.is_dict()){
-			if(is_dict_cppmap(types, gen_acc.gen.settings.config, type0)){
-				const auto res = resolve_func(gen_acc.gen.link_map, "retain_dict_cppmap");
-				builder.CreateCall(res.llvm_codegen_f, { &frp_reg, &value_reg, &itype_reg }, "");
-			}
-			else if(is_dict_hamt(types, gen_acc.gen.settings.config, type0)){
-				const auto res = resolve_func(gen_acc.gen.link_map, "retain_dict_hamt");
-				builder.CreateCall(res.llvm_codegen_f, { &frp_reg, &value_reg, &itype_reg }, "");
-			}
-			else{
-				QUARK_ASSERT(false);
-			}
-		}
-		else if(type_peek.is_json()){
-			const auto res = resolve_func(gen_acc.gen.link_map, "retain_json");
-			builder.CreateCall(res.llvm_codegen_f, { &frp_reg, &value_reg, &itype_reg }, "");
+		if(k_inline_rc){
+			auto rc_ptr_reg = builder.CreateCast(llvm::Instruction::CastOps::BitCast, &value_reg, builder.getInt32Ty()->getPointerTo(), "");
+			builder.CreateCall(get_inline_retain_function(gen_acc.gen), { rc_ptr_reg }, "");
 		}
 		else if(type_peek.is_struct()){
 			auto generic_vec_reg = builder.CreateCast(llvm::Instruction::CastOps::BitCast, &value_reg, get_generic_struct_type_byvalue(gen_acc.gen.type_lookup)->getPointerTo(), "");
@@ -1124,7 +1385,8 @@ void generate_retain(llvm_function_generator_t& gen_acc, llvm::Value& value_reg,
 			builder.CreateCall(res.llvm_codegen_f, { &frp_reg, generic_vec_reg, &itype_reg }, "");
 		}
 		else{
-			QUARK_ASSERT(false);
+			const auto res = resolve_func(gen_acc.gen.link_map, get_retain_func_name(types, gen_acc.gen.settings.config, type0));
+			builder.CreateCall(res.llvm_codegen_f, { &frp_reg, &value_reg, &itype_reg }, "");
 		}
 	}
 	else{
@@ -1148,6 +1410,7 @@ std::vector<function_bind_t> retain_funcs(llvm::LLVMContext& context, const llvm
 		function_bind_t{ "retain_vector_hamt", make_retain(context, type_lookup, *make_generic_vec_type_byvalue(type_lookup)->getPointerTo()), reinterpret_cast<void*>(floydrt_retain_vector_hamt) },
 		function_bind_t{ "retain_dict_cppmap", make_retain(context, type_lookup, *make_generic_dict_type_byvalue(type_lookup)->getPointerTo()), reinterpret_cast<void*>(floydrt_retain_dict_cppmap) },
 		function_bind_t{ "retain_dict_hamt", make_retain(context, type_lookup, *make_generic_dict_type_byvalue(type_lookup)->getPointerTo()), reinterpret_cast<void*>(floydrt_retain_dict_hamt) },
+		function_bind_t{ "retain_dict_hashtable", make_retain(context, type_lookup, *make_generic_dict_type_byvalue(type_lookup)->getPointerTo()), reinterpret_cast<void*>(floydrt_retain_dict_hashtable) },
 		function_bind_t{ "retain_json", make_retain(context, type_lookup, *get_llvm_type_as_arg(type_lookup, type_t::make_json())), reinterpret_cast<void*>(floydrt_retain_json) },
 		function_bind_t{ "retain_struct", make_retain(context, type_lookup, *get_generic_struct_type_byvalue(type_lookup)->getPointerTo()), reinterpret_cast<void*>(floydrt_retain_struct) }
 	};
@@ -1246,6 +1509,18 @@ const auto& type = lookup_type_ref(r.backend, type0);
 		release_dict_hamt(r.backend, dict, type);
 	}
 }
+static void floydrt_release_dict_hashtable(floyd_runtime_t* frp, runtime_value_t dict, runtime_type_t type0){
+	auto& r = get_floyd_runtime(frp);
+	const auto& type = lookup_type_ref(r.backend, type0);
+#if DEBUG
+	QUARK_ASSERT(is_dict_hashtable(r.backend.types, r.backend.config, type));
+#endif
+
+	//	Check really only required when unwinding locals.
+	if(dict.dict_hashtable_ptr != nullptr){
+		release_dict_hashtable(r.backend, dict, type);
+	}
+}
 
 
 
@@ -1299,11 +1574,64 @@ std::vector<function_bind_t> release_funcs(llvm::LLVMContext& context, const llv
 		function_bind_t{ "release_vector_hamt_nonpod", make_release(context, type_lookup, *make_generic_vec_type_byvalue(type_lookup)->getPointerTo()), reinterpret_cast<void*>(floydrt_release_vector_hamt_nonpod) },
 		function_bind_t{ "release_dict_cppmap", make_release(context, type_lookup, *make_generic_dict_type_byvalue(type_lookup)->getPointerTo()), reinterpret_cast<void*>(floydrt_release_dict_cppmap) },
 		function_bind_t{ "release_dict_hamt", make_release(context, type_lookup, *make_generic_dict_type_byvalue(type_lookup)->getPointerTo()), reinterpret_cast<void*>(floydrt_release_dict_hamt) },
+		function_bind_t{ "release_dict_hashtable", make_release(context, type_lookup, *make_generic_dict_type_byvalue(type_lookup)->getPointerTo()), reinterpret_cast<void*>(floydrt_release_dict_hashtable) },
 		function_bind_t{ "release_json", make_release(context, type_lookup, *get_llvm_type_as_arg(type_lookup, type_t::make_json())), reinterpret_cast<void*>(floydrt_release_json) },
 		function_bind_t{ "release_struct", make_release(context, type_lookup, *get_generic_struct_type_byvalue(type_lookup)->getPointerTo()), reinterpret_cast<void*>(floydrt_release_struct) }
 	};
 }
 
+static std::string get_release_func_name(const types_t& types, const config_t& config, const type_t& type){
+	const auto peek = peek2(types, type);
+	if(peek.is_string()){
+		return "release_vector_carray_pod";
+	}
+	else if(peek.is_vector()){
+		const bool is_element_pod = is_rc_value(peek2(types, peek.get_vector_element_type(types))) ? false : true;
+
+		if(is_vector_carray(types, config, type) && is_element_pod == true){
+			return "release_vector_carray_pod";
+		}
+		else if(is_vector_carray(types, config, type) && is_element_pod == false){
+			return "release_vector_carray_nonpod";
+		}
+		else if(is_vector_hamt(types, config, type) && is_element_pod == true){
+			return "release_vector_hamt_pod";
+		}
+		else if(is_vector_hamt(types, config, type) && is_element_pod == false){
+			return "release_vector_hamt_nonpod";
+		}
+		else{
+			QUARK_ASSERT(false);
+			throw std::exception();
+		}
+	}
+	else if(peek.is_dict()){
+		if(is_dict_cppmap(types, config, type)){
+			return "release_dict_cppmap";
+		}
+		else if(is_dict_hamt(types, config, type)){
+			return "release_dict_hamt";
+		}
+		else if(is_dict_hashtable(types, config, type)){
+			return "release_dict_hashtable";
+		}
+		else{
+			QUARK_ASSERT(false);
+			throw std::exception();
+		}
+	}
+	else if(peek.is_json()){
+		return "release_json";
+	}
+	else if(peek.is_struct()){
+		return "release_struct";
+	}
+	else{
+		QUARK_ASSERT(false);
+		throw std::exception();
+	}
+}
+
 void generate_release(llvm_function_generator_t& gen_acc, llvm::Value& value_reg, const type_t& type){
 	QUARK_ASSERT(gen_acc.check_invariant());
 	QUARK_ASSERT(type.check_invariant());
@@ -1315,57 +1643,9 @@ void generate_release(llvm_function_generator_t& gen_acc, llvm::Value& value_reg
 	const auto peek = peek2(types, type);
 
 	if(is_rc_value(peek)){
-		if(peek.is_string()){
-			const auto res = resolve_func(gen_acc.gen.link_map, "release_vector_carray_pod");
-			builder.CreateCall(res.llvm_codegen_f, { &frp_reg, &value_reg, &itype_reg });
-		}
-		else if(peek.is_vector()){
-			const bool is_element_pod = is_rc_value(peek2(types, peek.get_vector_element_type(types))) ? false : true;
-
-			if(is_vector_carray(types, gen_acc.gen.settings.config, type) && is_element_pod == true){
-				const auto res = resolve_func(gen_acc.gen.link_map, "release_vector_carray_pod");
-				builder.CreateCall(res.llvm_codegen_f, { &frp_reg, &value_reg, &itype_reg });
-			}
-			else if(is_vector_carray(types, gen_acc.gen.settings.config, type) && is_element_pod == false){
-				const auto res = resolve_func(gen_acc.gen.link_map, "release_vector_carray_nonpod");
-				builder.CreateCall(res.llvm_codegen_f, { &frp_reg, &value_reg, &itype_reg });
-			}
-			else if(is_vector_hamt(types, gen_acc.gen.settings.config, type) && is_element_pod == true){
-				const auto res = resolve_func(gen_acc.gen.link_map, "release_vector_hamt_pod");
-				builder.CreateCall(res.llvm_codegen_f, { &frp_reg, &value_reg, &itype_reg });
-			}
-			else if(is_vector_hamt(types, gen_acc.gen.settings.config, type) && is_element_pod == false){
-				const auto res = resolve_func(gen_acc.gen.link_map, "release_vector_hamt_nonpod");
-				builder.CreateCall(res.llvm_codegen_f, { &frp_reg, &value_reg, &itype_reg });
-			}
-			else{
-				QUARK_ASSERT(false);
-			}
-		}
-		else if(peek.is_dict()){
-			if(is_dict_cppmap(types, gen_acc.gen.settings.config, type)){
-				const auto res = resolve_func(gen_acc.gen.link_map, "release_dict_cppmap");
-				builder.CreateCall(res.llvm_codegen_f, { &frp_reg, &value_reg, &itype_reg });
-			}
-			else if(is_dict_hamt(types, gen_acc.gen.settings.config, type)){
-				const auto res = resolve_func(gen_acc.gen.link_map, "release_dict_hamt");
-				builder.CreateCall(res.llvm_codegen_f, { &frp_reg, &value_reg, &itype_reg });
-			}
-			else{
-				QUARK_ASSERT(false);
-			}
-		}
-		else if(peek.is_json()){
-			const auto res = resolve_func(gen_acc.gen.link_map, "release_json");
-			builder.CreateCall(res.llvm_codegen_f, { &frp_reg, &value_reg, &itype_reg });
-		}
-		else if(peek.is_struct()){
-			const auto res = resolve_func(gen_acc.gen.link_map, "release_struct");
-			builder.CreateCall(res.llvm_codegen_f, { &frp_reg, &value_reg, &itype_reg });
-		}
-		else{
-			QUARK_ASSERT(false);
-		}
+		const auto name = get_release_func_name(types, gen_acc.gen.settings.config, type);
+		auto f = k_inline_rc ? get_inline_release_function(gen_acc.gen, name) : resolve_func(gen_acc.gen.link_map, name).llvm_codegen_f;
+		builder.CreateCall(f, { &frp_reg, &value_reg, &itype_reg });
 	}
 	else{
 	}
@@ -1386,11 +1666,14 @@ std::vector<function_bind_t> get_runtime_function_binds(llvm::LLVMContext& conte
 
 		floydrt_store_vector_element_mutable__make(context, type_lookup),
 		floydrt_concatunate_vectors__make(context, type_lookup),
+		floydrt_concatunate_vectors_inplace__make(context, type_lookup),
+		floydrt_reserve_string__make(context, type_lookup),
 		floydrt_load_vector_element__make(context, type_lookup),
 
 		floydrt_allocate_dict__make(context, type_lookup),
 		floydrt_lookup_dict_cppmap__make(context, type_lookup),
 		floydrt_lookup_dict_hamt__make(context, type_lookup),
+		floydrt_lookup_dict_hashtable__make(context, type_lookup),
 		floydrt_store_dict_mutable__make(context, type_lookup),
 
 		floydrt_allocate_json__make(context, type_lookup),
@@ -1401,6 +1684,7 @@ std::vector<function_bind_t> get_runtime_function_binds(llvm::LLVMContext& conte
 		floydrt_update_struct_member__make(context, type_lookup),
 
 		floydrt_compare_values__make(context, type_lookup),
+		floydrt_compare_strings__make(context, type_lookup),
 		floydrt_get_profile_time__make(context, type_lookup),
 		floydrt_analyse_benchmark_samples__make(context, type_lookup),
 
@@ -1433,6 +1717,8 @@ runtime_functions_t::runtime_functions_t(const std::vector<function_link_entry_t
 
 	floydrt_store_vector_element_hamt_mutable(resolve_func(function_defs, "store_vector_element_hamt_mutable")),
 	floydrt_concatunate_vectors(resolve_func(function_defs, "concatunate_vectors")),
+	floydrt_concatunate_vectors_inplace(resolve_func(function_defs, "concatunate_vectors_inplace")),
+	floydrt_reserve_string(resolve_func(function_defs, "reserve_string")),
 	floydrt_load_vector_element_hamt(resolve_func(function_defs, "load_vector_element_hamt")),
 
 
@@ -1447,6 +1733,7 @@ runtime_functions_t::runtime_functions_t(const std::vector<function_link_entry_t
 	floydrt_allocate_struct(resolve_func(function_defs, "allocate_struct")),
 
 	floydrt_compare_values(resolve_func(function_defs, "compare_values")),
+	floydrt_compare_strings(resolve_func(function_defs, "compare_strings")),
 
 
 	floydrt_get_profile_time(resolve_func(function_defs, "get_profile_time")),
@@ -40,6 +40,8 @@ struct runtime_functions_t {
 	const function_link_entry_t floydrt_allocate_vector_fill;
 	const function_link_entry_t floydrt_store_vector_element_hamt_mutable;
 	const function_link_entry_t floydrt_concatunate_vectors;
+	const function_link_entry_t floydrt_concatunate_vectors_inplace;
+	const function_link_entry_t floydrt_reserve_string;
 	const function_link_entry_t floydrt_load_vector_element_hamt;
 	
 	const function_link_entry_t floydrt_allocate_dict;
@@ -51,6 +53,7 @@ struct runtime_functions_t {
 	const function_link_entry_t floydrt_allocate_struct;
 
 	const function_link_entry_t floydrt_compare_values;
+	const function_link_entry_t floydrt_compare_strings;
 
 	const function_link_entry_t floydrt_get_profile_time;
 	const function_link_entry_t floydrt_analyse_benchmark_samples;
@@ -68,6 +71,11 @@ llvm::Value* generate_load_struct_member(llvm_function_generator_t& gen_acc, llv
 void generate_retain(llvm_function_generator_t& gen_acc, llvm::Value& value_reg, const type_t& type);
 void generate_release(llvm_function_generator_t& gen_acc, llvm::Value& value_reg, const type_t& type);
 
+//	Names of the IR helpers that generate_retain() and generate_release() call. Release helpers are
+//	k_inline_release_prefix + the runtime function, like "floyd_inline_release_struct".
+const std::string k_inline_retain_name = "floyd_inline_retain";
+const std::string k_inline_release_prefix = "floyd_inline_";
+
 
 } // floyd
 
@@ -918,12 +918,12 @@ std::pair<json_t, seq_t> parse_json(const seq_t& s){
 		return { json_t(), if_first(a, "null").second };
 	}
 	else{
-		const auto number_pos = read_while(a, "-0123456789.+");
+		const auto number_pos = read_while(a, "-0123456789.+eE");
 		if(number_pos.first.empty()){
 			return { json_t(), a };
 		}
 		else{
-			double number = parse_float(number_pos.first);
+			double number = parse_double(number_pos.first);
 			return { json_t(number), number_pos.second };
 		}
 	}
@@ -1017,6 +1017,30 @@ QUARK_TESTQ("parse_json()", "object - two entries"){
 
 static const size_t k_default_pretty_columns = 160;
 
+//	Integral numbers are written with all their digits so integers (like nanosecond timings) survive a round trip.
+static std::string json_number_to_string(double value){
+	const double k_max_exact = 9007199254740992.0;
+	if(std::floor(value) == value && std::fabs(value) <= k_max_exact){
+		return std::to_string(static_cast<int64_t>(value));
+	}
+	else{
+		return double_to_string_simplify(value);
+	}
+}
+
+QUARK_TESTQ("json_number_to_string()", ""){
+	ut_verify(QUARK_POS, json_number_to_string(1234567890.0), "1234567890");
+}
+QUARK_TESTQ("json_number_to_string()", ""){
+	ut_verify(QUARK_POS, json_number_to_string(-13.0), "-13");
+}
+QUARK_TESTQ("json_number_to_string()", ""){
+	ut_verify(QUARK_POS, json_number_to_string(13.5), "13.5");
+}
+QUARK_TESTQ("parse_json()", "exponent"){
+	ut_verify(QUARK_POS, parse_json(seq_t("1.5e+09 xxx")), { json_t(1.5e9), seq_t(" xxx") });
+}
+
 
 std::string json_to_compact_string2(const json_t& v, bool quote_fields);
 
@@ -1203,7 +1227,7 @@ std::string json_to_compact_string2(const json_t& v, bool quote_fields){
 		return quote_fields ? quote(v.get_string()) : v.get_string();
 	}
 	else if(v.is_number()){
-		return double_to_string_simplify(v.get_number());
+		return json_number_to_string(v.get_number());
 	}
 	else if(v.is_true()){
 		return "true";
@@ -1411,7 +1435,7 @@ std::string json_to_pretty_string_internal(const string& key, const json_t& valu
 		return string(indent, '\t') + key_str + quote(value.get_string());
 	}
 	else if(value.is_number()){
-		return string(indent, '\t') + key_str + double_to_string_simplify(value.get_number());
+		return string(indent, '\t') + key_str + json_number_to_string(value.get_number());
 	}
 	else if(value.is_true()){
 		return string(indent, '\t') + key_str + "true";
@@ -666,3 +666,168 @@ QUARK_TEST("", "read_balanced2()", "", ""){
 
 
 
+
+
+
+///////////////////////////////		text_cursor_t
+
+
+QUARK_TESTQ("text_cursor_t()", ""){
+	const auto a = text_cursor_t("abc");
+	QUARK_VERIFY(a.first1_char() == 'a');
+	QUARK_VERIFY(a.first(2) == "ab");
+	QUARK_VERIFY(a.rest(2).first1() == "c");
+	QUARK_VERIFY(a.rest(100).empty());
+	QUARK_VERIFY(a.rest(100).first(100) == "");
+	QUARK_VERIFY(a.rest(2).back(1).str() == "bc");
+	QUARK_VERIFY(a.rest(2).pos() == 2);
+}
+
+QUARK_TESTQ("text_cursor_t()", "operator==() compares the rest"){
+	const std::string s = "xabc";
+	QUARK_VERIFY(text_cursor_t(s).rest1() == text_cursor_t("abc"));
+	QUARK_VERIFY(text_cursor_t(s) != text_cursor_t("abc"));
+}
+
+
+text_cursor_t skip(const text_cursor_t& s, const std::string& chars){
+	auto pos = s;
+	while(!pos.empty() && chars.find(pos.first1_char()) != string::npos){
+		pos = pos.rest1();
+	}
+	return pos;
+}
+
+pair<string, text_cursor_t> read_while(const text_cursor_t& p1, const string& chars){
+	const auto p2 = skip(p1, chars);
+	return { get_range(p1, p2), p2 };
+}
+
+QUARK_TEST("", "read_while()", "text_cursor_t", ""){
+	QUARK_VERIFY((read_while(text_cursor_t("\n\t\rend"), k_test_whitespace_chars) == pair<string, text_cursor_t>{ "\n\t\r", text_cursor_t("end") }));
+}
+
+text_cursor_t skip_until(const text_cursor_t& s, const std::string& chars){
+	auto pos = s;
+	while(!pos.empty() && chars.find(pos.first1_char()) == string::npos){
+		pos = pos.rest1();
+	}
+	return pos;
+}
+
+pair<string, text_cursor_t> read_until(const text_cursor_t& p1, const string& chars){
+	const auto p2 = skip_until(p1, chars);
+	return { get_range(p1, p2), p2 };
+}
+
+pair<string, text_cursor_t> split_at(const text_cursor_t& p1, const string& str){
+	const auto pos = p1.view().find(str);
+	if(pos == std::string_view::npos){
+		return { "", p1 };
+	}
+	else{
+		return { string(p1.first(pos)), p1.rest(pos + str.size()) };
+	}
+}
+
+QUARK_TEST("", "split_at()", "text_cursor_t", ""){
+	QUARK_VERIFY((split_at(text_cursor_t("hello123world"), "123") == pair<string, text_cursor_t>{ "hello", text_cursor_t("world") }));
+}
+
+std::pair<bool, text_cursor_t> if_first(const text_cursor_t& p, const std::string& wanted_string){
+	const auto size = wanted_string.size();
+	if(p.first(size) == wanted_string){
+		return { true, p.rest(size) };
+	}
+	else{
+		return { false, p };
+	}
+}
+
+bool is_first(const text_cursor_t& p, const std::string& wanted_string){
+	return p.first(wanted_string.size()) == wanted_string;
+}
+
+std::string get_range(const text_cursor_t& a, const text_cursor_t& b){
+	QUARK_ASSERT(text_cursor_t::related(a, b));
+	QUARK_ASSERT(b.pos() >= a.pos());
+
+	return string(a.first(b.pos() - a.pos()));
+}
+
+pair<char, text_cursor_t> read_char(const text_cursor_t& s){
+	if(!s.empty()){
+		return { s.first1_char(), s.rest1() };
+	}
+	else{
+		quark::throw_runtime_error("expected character.");
+	}
+}
+
+text_cursor_t read_required_char(const text_cursor_t& s, char ch){
+	if(s.empty() || s.first1_char() != ch){
+		quark::throw_runtime_error("Expected '" + string(1, ch)  + "' character.");
+	}
+	return s.rest1();
+}
+
+text_cursor_t read_required(const text_cursor_t& s, const std::string& req){
+	const auto count = req.size();
+	if(s.first(count) != req){
+		quark::throw_runtime_error("Expected '" + req  + "' character.");
+	}
+	return s.rest(count);
+}
+
+pair<bool, text_cursor_t> read_optional_char(const text_cursor_t& s, char ch){
+	if(s.size() > 0 && s.first1_char() == ch){
+		return { true, s.rest1() };
+	}
+	else{
+		return { false, s };
+	}
+}
+
+//	Returns the position after the closing character, or the same position if unbalanced.
+static text_cursor_t skip_balanced(const text_cursor_t& s, const std::pair<std::string, std::string>& open_close){
+	const auto closing_index = open_close.first.find(s.first1_char());
+	QUARK_ASSERT(closing_index != string::npos);
+
+	auto pos = s.rest1();
+	while(pos.empty() == false && open_close.second.find(pos.first1_char()) != closing_index){
+		const auto ch = pos.first1_char();
+
+		//	Unexpected close-character?
+		if(open_close.second.find(ch) != string::npos){
+			return s;
+		}
+
+		//	Is this another opening-character?
+		else if(open_close.first.find(ch) != string::npos){
+			const auto end = skip_balanced(pos, open_close);
+			if(end.pos() == pos.pos()){
+				return s;
+			}
+			pos = end;
+		}
+		else {
+			pos = pos.rest1();
+		}
+	}
+	return pos.empty() ? s : pos.rest1();
+}
+
+std::pair<std::string, text_cursor_t> read_balanced2(const text_cursor_t& s, const std::string& open_close_pairs){
+	QUARK_ASSERT(s.size() > 0);
+	QUARK_ASSERT((open_close_pairs.size() % 2) == 0);
+
+	const auto end = skip_balanced(s, deinterleave_string(open_close_pairs));
+	return { get_range(s, end), end };
+}
+
+QUARK_TEST("", "read_balanced2()", "text_cursor_t", ""){
+	QUARK_VERIFY(read_balanced2(text_cursor_t("((abc)[])xyz"), "(){}[]") == (std::pair<std::string, text_cursor_t>("((abc)[])", text_cursor_t("xyz"))));
+}
+QUARK_TEST("", "read_balanced2()", "text_cursor_t", "unbalanced"){
+	QUARK_VERIFY(read_balanced2(text_cursor_t("(a(b(c(d));\n\t"), "(){}[]") == (std::pair<std::string, text_cursor_t>("", text_cursor_t("(a(b(c(d));\n\t"))));
+}
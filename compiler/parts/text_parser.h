@@ -11,9 +11,12 @@
 
 /*
 	Low-level features to read and manipulate strings.
-	Check out seq_t.
+	Check out seq_t and text_cursor_t.
 */
+#include "quark.h"
+
 #include <string>
+#include <string_view>
 #include <memory>
 #include <vector>
 #include <cmath>
@@ -21,6 +24,7 @@
 using std::isnan;
 
 struct seq_t;
+struct text_cursor_t;
 
 const std::string k_test_whitespace_chars = " \n\t\r";
 
@@ -177,4 +181,157 @@ std::pair<std::string, std::string> deinterleave_string(const std::string& s);
 std::pair<std::string, seq_t> read_balanced2(const seq_t& s, const std::string& open_close_pairs);
 
 
+
+///////////////////////////////		text_cursor_t
+
+
+/*
+	Same API as seq_t but only a view of the text and an offset. Copying, rest() and first(n) never
+	allocate and never touch a reference count, which makes it cheap enough for the parser, which makes
+	new cursors all the time.
+
+	The cursor does NOT own the text: the text must outlive all cursors made from it.
+
+	pos() is the offset into the complete text, like seq_t.
+*/
+
+struct text_cursor_t {
+	public: explicit text_cursor_t(std::string_view text) :
+		_text(text),
+		_pos(0)
+	{
+		update_debug();
+		QUARK_ASSERT(check_invariant());
+	}
+
+	public: bool check_invariant() const {
+		QUARK_ASSERT(_pos <= _text.size());
+		return true;
+	}
+
+
+	//	Peek at first char (as C-character). Throws exception if empty().
+	public: char first1_char() const {
+		QUARK_ASSERT(check_invariant());
+
+		if(_pos >= _text.size()){
+			quark::throw_runtime_error("");
+		}
+		return _text[_pos];
+	}
+
+	//	Returns "" if empty.
+	public: std::string_view first1() const { return first(1); }
+	public: std::string_view first() const { return first(1); }
+
+	//	Returned string can be "" or shorter than chars if there aren't enough chars.
+	public: std::string_view first(size_t chars) const {
+		QUARK_ASSERT(check_invariant());
+
+		return _text.substr(_pos, chars);
+	}
+
+	public: text_cursor_t rest1() const { return rest(1); }
+	public: text_cursor_t rest() const { return rest(1); }
+
+	//	Skips n characters. Limited to size().
+	public: text_cursor_t rest(size_t count) const {
+		QUARK_ASSERT(check_invariant());
+
+		return text_cursor_t(_text, std::min(_text.size(), _pos + count));
+	}
+
+	public: text_cursor_t back(size_t count) const {
+		QUARK_ASSERT(check_invariant());
+
+		return text_cursor_t(_text, _pos - std::min(_pos, count));
+	}
+
+
+	//	What's left to consume, as a view. No copy.
+	public: std::string_view view() const {
+		QUARK_ASSERT(check_invariant());
+
+		return _text.substr(_pos);
+	}
+
+	//	Copies what's left to consume.
+	public: std::string get_s() const { return str(); }
+	public: std::string str() const { return std::string(view()); }
+
+	public: std::size_t size() const {
+		QUARK_ASSERT(check_invariant());
+
+		return _text.size() - _pos;
+	}
+	public: std::size_t pos() const {
+		QUARK_ASSERT(check_invariant());
+
+		return _pos;
+	}
+
+	//	If true, there are no more characters.
+	public: bool empty() const {
+		QUARK_ASSERT(check_invariant());
+
+		return _pos == _text.size();
+	}
+
+	//	Returns true if both are cursors into the same text.
+	public: static bool related(const text_cursor_t& a, const text_cursor_t& b){
+		return a._text.data() == b._text.data() && a._text.size() == b._text.size();
+	}
+
+	//	Compares what's left to consume, like seq_t.
+	public: bool operator==(const text_cursor_t& other) const {
+		return view() == other.view();
+	}
+	public: bool operator!=(const text_cursor_t& other) const { return !(*this == other); }
+
+
+	private: text_cursor_t(std::string_view text, std::size_t pos) :
+		_text(text),
+		_pos(pos)
+	{
+		update_debug();
+		QUARK_ASSERT(check_invariant());
+	}
+
+	private: void update_debug(){
+#if DEBUG
+		FIRST_debug = _text.substr(_pos, 100);
+#endif
+	}
+
+
+	/////////////		STATE
+#if DEBUG
+	private: std::string_view FIRST_debug;
+#endif
+	private: std::string_view _text;
+	private: std::size_t _pos;
+};
+
+text_cursor_t skip(const text_cursor_t& p1, const std::string& chars);
+text_cursor_t skip_until(const text_cursor_t& p1, const std::string& chars);
+
+std::pair<std::string, text_cursor_t> read_while(const text_cursor_t& p1, const std::string& chars);
+std::pair<std::string, text_cursor_t> read_until(const text_cursor_t& p1, const std::string& chars);
+
+std::pair<std::string, text_cursor_t> split_at(const text_cursor_t& p1, const std::string& str);
+
+std::pair<bool, text_cursor_t> if_first(const text_cursor_t& p, const std::string& wanted_string);
+bool is_first(const text_cursor_t& p, const std::string& wanted_string);
+
+//	b must be a later position of the same text as a.
+std::string get_range(const text_cursor_t& a, const text_cursor_t& b);
+
+std::pair<char, text_cursor_t> read_char(const text_cursor_t& s);
+text_cursor_t read_required_char(const text_cursor_t& s, char ch);
+text_cursor_t read_required(const text_cursor_t& s, const std::string& req);
+std::pair<bool, text_cursor_t> read_optional_char(const text_cursor_t& s, char ch);
+
+std::pair<std::string, text_cursor_t> read_balanced2(const text_cursor_t& s, const std::string& open_close_pairs);
+
+
 #endif /* text_parser_hpp */
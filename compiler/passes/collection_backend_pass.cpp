@@ -0,0 +1,304 @@
+//
+//  collection_backend_pass.cpp
+//  Floyd
+//
+//  Created by Marcus Zetterquist on 2026-10-18.
+//  Copyright © 2026 Marcus Zetterquist. All rights reserved.
+//
+
+#include "collection_backend_pass.h"
+
+#include "semantic_ast.h"
+#include "statement.h"
+#include "compiler_basics.h"
+#include "compiler_helpers.h"
+
+#include <set>
+#include <algorithm>
+#include <vector>
+
+
+namespace floyd {
+
+
+struct backend_selection_t {
+	const types_t& types;
+	const intrinsic_signatures_t& intrinsic_signatures;
+
+	//	Each entry holds vector types that must share their backend.
+	std::vector<std::vector<type_t>> vector_links;
+
+	std::set<type_t> updated_vectors;
+	std::set<type_t> updated_dicts;
+};
+
+static void select_body(backend_selection_t& acc, const body_t& body);
+
+
+static void add_if_vector(const types_t& types, std::vector<type_t>& acc, const type_t& type){
+	if(peek2(types, type).is_vector()){
+		acc.push_back(peek0(types, type));
+	}
+}
+
+static void select_expression(backend_selection_t& acc, const expression_t& expression);
+
+static void select_intrinsic(backend_selection_t& acc, const expression_t& expression, const expression_t::intrinsic_t& e){
+	const auto& types = acc.types;
+
+	std::vector<type_t> vectors;
+	for(const auto& a: e.args){
+		select_expression(acc, a);
+		add_if_vector(types, vectors, a.get_output_type());
+	}
+	add_if_vector(types, vectors, expression.get_output_type());
+	if(vectors.size() > 1){
+		acc.vector_links.push_back(vectors);
+	}
+
+	const auto is_update = e.call_name == get_intrinsic_opcode(acc.intrinsic_signatures.update);
+	const auto is_erase = e.call_name == get_intrinsic_opcode(acc.intrinsic_signatures.erase);
+	if((is_update || is_erase) && e.args.empty() == false){
+		const auto coll_type = e.args[0].get_output_type();
+		const auto coll_peek = peek2(types, coll_type);
+		if(is_update && coll_peek.is_vector()){
+			acc.updated_vectors.insert(peek0(types, coll_type));
+		}
+		else if(coll_peek.is_dict()){
+			acc.updated_dicts.insert(peek0(types, coll_type));
+		}
+	}
+}
+
+static void select_expression(backend_selection_t& acc, const expression_t& expression){
+	struct visitor_t {
+		backend_selection_t& acc;
+		const expression_t& expression;
+
+
+		void operator()(const expression_t::literal_exp_t& e) const{
+		}
+		void operator()(const expression_t::arithmetic_t& e) const{
+			select_expression(acc, *e.lhs);
+			select_expression(acc, *e.rhs);
+		}
+		void operator()(const expression_t::comparison_t& e) const{
+			select_expression(acc, *e.lhs);
+			select_expression(acc, *e.rhs);
+		}
+		void operator()(const expression_t::unary_minus_t& e) const{
+			select_expression(acc, *e.expr);
+		}
+		void operator()(const expression_t::conditional_t& e) const{
+			select_expression(acc, *e.condition);
+			select_expression(acc, *e.a);
+			select_expression(acc, *e.b);
+		}
+
+		void operator()(const expression_t::call_t& e) const{
+			select_expression(acc, *e.callee);
+			for(const auto& a: e.args){
+				select_expression(acc, a);
+			}
+		}
+		void operator()(const expression_t::intrinsic_t& e) const{
+			select_intrinsic(acc, expression, e);
+		}
+
+
+		void operator()(const expression_t::struct_definition_expr_t& e) const{
+		}
+		void operator()(const expression_t::function_definition_expr_t& e) const{
+		}
+		void operator()(const expression_t::load_t& e) const{
+		}
+		void operator()(const expression_t::load2_t& e) const{
+		}
+
+		void operator()(const expression_t::resolve_member_t& e) const{
+			select_expression(acc, *e.parent_address);
+		}
+		void operator()(const expression_t::update_member_t& e) const{
+			select_expression(acc, *e.parent_address);
+			select_expression(acc, *e.new_value);
+		}
+		void operator()(const expression_t::lookup_t& e) const{
+			select_expression(acc, *e.parent_address);
+			select_expression(acc, *e.lookup_key);
+		}
+		void operator()(const expression_t::value_constructor_t& e) const{
+			for(const auto& a: e.elements){
+				select_expression(acc, a);
+			}
+		}
+		void operator()(const expression_t::benchmark_expr_t& e) const{
+			select_body(acc, *e.body);
+		}
+	};
+	std::visit(visitor_t{ acc, expression }, expression._expression_variant);
+}
+
+static void select_statement(backend_selection_t& acc, const statement_t& statement){
+	QUARK_ASSERT(statement.check_invariant());
+
+	struct visitor_t {
+		backend_selection_t& acc;
+		const statement_t& statement;
+
+
+		void operator()(const statement_t::return_statement_t& s) const{
+			select_expression(acc, s._expression);
+		}
+
+		void operator()(const statement_t::bind_local_t& s) const{
+			select_expression(acc, s._expression);
+		}
+		void operator()(const statement_t::assign_t& s) const{
+			select_expression(acc, s._expression);
+		}
+		void operator()(const statement_t::assign2_t& s) const{
+			select_expression(acc, s._expression);
+		}
+		void operator()(const statement_t::init2_t& s) const{
+			select_expression(acc, s._expression);
+		}
+		void operator()(const statement_t::block_statement_t& s) const{
+			select_body(acc, s._body);
+		}
+
+		void operator()(const statement_t::ifelse_statement_t& s) const{
+			select_expression(acc, s._condition);
+			select_body(acc, s._then_body);
+			select_body(acc, s._else_body);
+		}
+		void operator()(const statement_t::for_statement_t& s) const{
+			select_expression(acc, s._start_expression);
+			select_expression(acc, s._end_expression);
+			select_body(acc, s._body);
+		}
+		void operator()(const statement_t::while_statement_t& s) const{
+			select_expression(acc, s._condition);
+			select_body(acc, s._body);
+		}
+
+		void operator()(const statement_t::expression_statement_t& s) const{
+			select_expression(acc, s._expression);
+		}
+		void operator()(const statement_t::software_system_statement_t& s) const{
+		}
+		void operator()(const statement_t::container_def_statement_t& s) const{
+		}
+		void operator()(const statement_t::benchmark_def_statement_t& s) const{
+			select_body(acc, s._body);
+		}
+	};
+
+	std::visit(visitor_t{ acc, statement }, statement._contents);
+}
+
+static void select_body(backend_selection_t& acc, const body_t& body){
+	for(const auto& s: body._statements){
+		select_statement(acc, s);
+	}
+}
+
+//	Spreads HAMT to all vector types linked to an updated vector type, until nothing changes.
+static std::set<type_t> spread_hamt_vectors(const backend_selection_t& acc){
+	auto result = acc.updated_vectors;
+	bool changed = true;
+	while(changed){
+		changed = false;
+		for(const auto& link: acc.vector_links){
+			const auto any_hamt = std::find_if(link.begin(), link.end(), [&](const type_t& t){ return result.count(t) > 0; }) != link.end();
+			if(any_hamt){
+				for(const auto& t: link){
+					changed = result.insert(t).second || changed;
+				}
+			}
+		}
+	}
+	return result;
+}
+
+void select_collection_backends(semantic_ast_t& ast){
+	auto& tree = ast._tree;
+
+	backend_selection_t acc { tree._types, ast.intrinsic_signatures, {}, {}, {} };
+	select_body(acc, tree._globals);
+	for(const auto& f: tree._function_defs){
+		if(f._optional_body){
+			select_body(acc, *f._optional_body);
+		}
+	}
+
+	const auto hamt_vectors = spread_hamt_vectors(acc);
+
+	auto& types = tree._types;
+	for(type_lookup_index_t i = 0 ; i < types.nodes.size() ; i++){
+		const auto bt = types.nodes[i].bt;
+		if(bt == base_type::k_vector || bt == base_type::k_dict){
+			const auto type = lookup_type_from_index(types, i);
+			if(bt == base_type::k_vector){
+				set_collection_backend(types, type, hamt_vectors.count(type) > 0 ? collection_backend::k_hamt : collection_backend::k_carray);
+			}
+			else{
+				set_collection_backend(types, type, acc.updated_dicts.count(type) > 0 ? collection_backend::k_hamt : collection_backend::k_hashtable);
+			}
+		}
+	}
+}
+
+
+
+QUARK_TEST("", "select_collection_backends()", "vector that is only appended to and read", "carray"){
+	const auto sem_ast = compile_to_sematic_ast__errors(make_compilation_unit_nolib(
+		R"(
+
+			mutable a = [ 1, 2 ]
+			a = push_back(a, 3)
+			print(a[2])
+
+		)",
+		""
+	));
+	const auto& types = sem_ast._tree._types;
+	QUARK_VERIFY(get_collection_backend(types, make_vector(types, type_t::make_int())) == collection_backend::k_carray);
+}
+
+QUARK_TEST("", "select_collection_backends()", "updated vector, mapped to vector of strings", "both use HAMT"){
+	const auto sem_ast = compile_to_sematic_ast__errors(make_compilation_unit_nolib(
+		R"(
+
+			func string f(int e, int c){ return to_string(e) }
+
+			let a = update([ 1, 2 ], 0, 3)
+			let b = map(a, f, 0)
+			let c = [ 1.5 ]
+
+		)",
+		""
+	));
+	const auto& types = sem_ast._tree._types;
+	QUARK_VERIFY(get_collection_backend(types, make_vector(types, type_t::make_int())) == collection_backend::k_hamt);
+	QUARK_VERIFY(get_collection_backend(types, make_vector(types, type_t::make_string())) == collection_backend::k_hamt);
+	QUARK_VERIFY(get_collection_backend(types, make_vector(types, type_t::make_double())) == collection_backend::k_carray);
+}
+
+QUARK_TEST("", "select_collection_backends()", "dicts", "updated dict uses HAMT, read-only dict uses hashtable"){
+	const auto sem_ast = compile_to_sematic_ast__errors(make_compilation_unit_nolib(
+		R"(
+
+			let a = update({ "one": 1 }, "two", 2)
+			let b = { "one": 1.5 }
+			print(b["one"])
+
+		)",
+		""
+	));
+	const auto& types = sem_ast._tree._types;
+	QUARK_VERIFY(get_collection_backend(types, make_dict(types, type_t::make_int())) == collection_backend::k_hamt);
+	QUARK_VERIFY(get_collection_backend(types, make_dict(types, type_t::make_double())) == collection_backend::k_hashtable);
+}
+
+
+}	// floyd
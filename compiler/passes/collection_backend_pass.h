@@ -0,0 +1,37 @@
+//
+//  collection_backend_pass.h
+//  Floyd
+//
+//  Created by Marcus Zetterquist on 2026-10-18.
+//  Copyright © 2026 Marcus Zetterquist. All rights reserved.
+//
+
+#ifndef collection_backend_pass_hpp
+#define collection_backend_pass_hpp
+
+namespace floyd {
+
+struct semantic_ast_t;
+
+
+/*
+	Picks a runtime representation for every vector and dict type of the program and records it in its
+	type node, see collection_backend. Only used when config_t asks for vector_backend::per_type /
+	dict_backend::per_type.
+
+	The choice is per type, not per value, so values never need converting: every value of vector[int]
+	uses the same representation.
+
+	- Vectors that are updated with update() use HAMT: they are persistently updated and HAMT shares
+		the untouched parts between versions. All other vectors use carray: they are built once
+		(push_back() appends in place) and then read, which is where the flat array shines.
+	- Dicts that are updated with update() or erase() use HAMT, all other dicts use the hashtable.
+	- Vector types that meet in one intrinsic call, like map() from [int] to [string], get the same
+		backend since the intrinsic's implementation is picked from one of them.
+*/
+void select_collection_backends(semantic_ast_t& ast);
+
+
+}	// floyd
+
+#endif /* collection_backend_pass_hpp */
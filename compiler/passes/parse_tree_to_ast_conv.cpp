@@ -14,13 +14,187 @@
 
 namespace floyd {
 
-//	NOTICE: Implementation rigth now works because parse-tree JSON uses same scheme as
-//	AST tree = shaky. Better to manually create a unchecked_ast_t from the parse tree JSON.
+using namespace parser;
+
+
+static std::vector<statement_t> parse_node_list_to_statements(types_t& types, const parse_tree_t& tree, const parse_node_list_t& list);
+
+static expression_type parse_node_opcode_to_expression_type(parse_node_opcode opcode){
+	switch(opcode){
+		case parse_node_opcode::k_arithmetic_add: return expression_type::k_arithmetic_add;
+		case parse_node_opcode::k_arithmetic_subtract: return expression_type::k_arithmetic_subtract;
+		case parse_node_opcode::k_arithmetic_multiply: return expression_type::k_arithmetic_multiply;
+		case parse_node_opcode::k_arithmetic_divide: return expression_type::k_arithmetic_divide;
+		case parse_node_opcode::k_arithmetic_remainder: return expression_type::k_arithmetic_remainder;
+
+		case parse_node_opcode::k_logical_and: return expression_type::k_logical_and;
+		case parse_node_opcode::k_logical_or: return expression_type::k_logical_or;
+
+		case parse_node_opcode::k_comparison_smaller_or_equal: return expression_type::k_comparison_smaller_or_equal;
+		case parse_node_opcode::k_comparison_smaller: return expression_type::k_comparison_smaller;
+		case parse_node_opcode::k_comparison_larger_or_equal: return expression_type::k_comparison_larger_or_equal;
+		case parse_node_opcode::k_comparison_larger: return expression_type::k_comparison_larger;
+
+		case parse_node_opcode::k_logical_equal: return expression_type::k_logical_equal;
+		case parse_node_opcode::k_logical_nonequal: return expression_type::k_logical_nonequal;
+
+		default:
+			QUARK_ASSERT(false);
+			throw std::exception();
+	}
+}
+
+static std::vector<expression_t> parse_node_list_to_expressions(types_t& types, const parse_tree_t& tree, const parse_node_list_t& list);
+
+static expression_t parse_node_to_expression(types_t& types, const parse_tree_t& tree, parse_node_index_t index){
+	const auto& node = get_node(tree, index);
+
+	switch(node.opcode){
+		case parse_node_opcode::k_literal:
+			return expression_t::make_literal(tree.literals[node.payload]);
+		case parse_node_opcode::k_load:
+			return expression_t::make_load(node.name, make_undefined());
+		case parse_node_opcode::k_call: {
+			const auto callee = parse_node_to_expression(types, tree, node.a);
+			return expression_t::make_call(callee, parse_node_list_to_expressions(types, tree, node.list), make_undefined());
+		}
+		case parse_node_opcode::k_resolve_member:
+			return expression_t::make_resolve_member(parse_node_to_expression(types, tree, node.a), node.name, make_undefined());
+		case parse_node_opcode::k_lookup_element: {
+			const auto parent = parse_node_to_expression(types, tree, node.a);
+			const auto key = parse_node_to_expression(types, tree, node.b);
+			return expression_t::make_lookup(parent, key, make_undefined());
+		}
+		case parse_node_opcode::k_arithmetic_unary_minus:
+			return expression_t::make_unary_minus(parse_node_to_expression(types, tree, node.a), make_undefined());
+		case parse_node_opcode::k_conditional_operator: {
+			const auto condition = parse_node_to_expression(types, tree, node.a);
+			const auto a = parse_node_to_expression(types, tree, node.b);
+			const auto b = parse_node_to_expression(types, tree, node.c);
+			return expression_t::make_conditional_operator(condition, a, b, make_undefined());
+		}
+		case parse_node_opcode::k_struct_def: {
+			const auto def = std::make_shared<struct_type_desc_t>(tree.members[node.payload]);
+			return expression_t::make_struct_definition(types, node.name, def);
+		}
+		case parse_node_opcode::k_function_def: {
+			//	No body: this is a declaration only.
+			const auto body = node.flag
+				? std::make_shared<body_t>(body_t(parse_node_list_to_statements(types, tree, node.list), symbol_table_t{}))
+				: std::shared_ptr<body_t>();
+			const auto def = function_definition_t::make_func(
+				k_no_location,
+				node.name,
+				peek2(types, node.type),
+				tree.members[node.payload],
+				body
+			);
+			return expression_t::make_function_definition(def);
+		}
+		case parse_node_opcode::k_value_constructor:
+			return expression_t::make_construct_value_expr(node.type, parse_node_list_to_expressions(types, tree, node.list));
+		case parse_node_opcode::k_benchmark:
+			return expression_t::make_benchmark_expr(body_t{ parse_node_list_to_statements(types, tree, node.list) });
+
+		case parse_node_opcode::k_arithmetic_add:
+		case parse_node_opcode::k_arithmetic_subtract:
+		case parse_node_opcode::k_arithmetic_multiply:
+		case parse_node_opcode::k_arithmetic_divide:
+		case parse_node_opcode::k_arithmetic_remainder:
+		case parse_node_opcode::k_logical_and:
+		case parse_node_opcode::k_logical_or: {
+			const auto lhs = parse_node_to_expression(types, tree, node.a);
+			const auto rhs = parse_node_to_expression(types, tree, node.b);
+			return expression_t::make_arithmetic(parse_node_opcode_to_expression_type(node.opcode), lhs, rhs, make_undefined());
+		}
+
+		case parse_node_opcode::k_comparison_smaller_or_equal:
+		case parse_node_opcode::k_comparison_smaller:
+		case parse_node_opcode::k_comparison_larger_or_equal:
+		case parse_node_opcode::k_comparison_larger:
+		case parse_node_opcode::k_logical_equal:
+		case parse_node_opcode::k_logical_nonequal: {
+			const auto lhs = parse_node_to_expression(types, tree, node.a);
+			const auto rhs = parse_node_to_expression(types, tree, node.b);
+			return expression_t::make_comparison(parse_node_opcode_to_expression_type(node.opcode), lhs, rhs, make_undefined());
+		}
+
+		default:
+			quark::throw_runtime_error("Illegal expression.");
+	}
+}
+
+static std::vector<expression_t> parse_node_list_to_expressions(types_t& types, const parse_tree_t& tree, const parse_node_list_t& list){
+	std::vector<expression_t> result;
+	result.reserve(list.count);
+	for(uint32_t i = 0 ; i < list.count ; i++){
+		result.push_back(parse_node_to_expression(types, tree, get_list_node(tree, list, i)));
+	}
+	return result;
+}
+
+static statement_t parse_node_to_statement(types_t& types, const parse_tree_t& tree, parse_node_index_t index){
+	const auto& node = get_node(tree, index);
+	const auto loc = node.location;
+
+	switch(node.opcode){
+		case parse_node_opcode::k_return:
+			return statement_t::make__return_statement(loc, parse_node_to_expression(types, tree, node.a));
+		case parse_node_opcode::k_init_local: {
+			const auto expr = parse_node_to_expression(types, tree, node.a);
+			const auto mutable_mode = node.flag ? statement_t::bind_local_t::k_mutable : statement_t::bind_local_t::k_immutable;
+			return statement_t::make__bind_local(loc, node.name, node.type, expr, mutable_mode);
+		}
+		case parse_node_opcode::k_assign:
+			return statement_t::make__assign(loc, node.name, parse_node_to_expression(types, tree, node.a));
+		case parse_node_opcode::k_block:
+			return statement_t::make__block_statement(loc, body_t(parse_node_list_to_statements(types, tree, node.list)));
+		case parse_node_opcode::k_if: {
+			const auto condition = parse_node_to_expression(types, tree, node.a);
+			const auto then_statements = parse_node_list_to_statements(types, tree, node.list);
+			const auto else_statements = node.flag ? parse_node_list_to_statements(types, tree, node.list2) : std::vector<statement_t>();
+			return statement_t::make__ifelse_statement(loc, condition, body_t{ then_statements }, body_t{ else_statements });
+		}
+		case parse_node_opcode::k_for: {
+			const auto start = parse_node_to_expression(types, tree, node.a);
+			const auto end = parse_node_to_expression(types, tree, node.b);
+			const auto body = parse_node_list_to_statements(types, tree, node.list);
+			const auto range_type = node.flag ? statement_t::for_statement_t::k_open_range : statement_t::for_statement_t::k_closed_range;
+			return statement_t::make__for_statement(loc, node.name, start, end, body_t{ body }, range_type);
+		}
+		case parse_node_opcode::k_while: {
+			const auto condition = parse_node_to_expression(types, tree, node.a);
+			return statement_t::make__while_statement(loc, condition, body_t{ parse_node_list_to_statements(types, tree, node.list) });
+		}
+		case parse_node_opcode::k_expression_statement:
+			return statement_t::make__expression_statement(loc, parse_node_to_expression(types, tree, node.a));
+		case parse_node_opcode::k_software_system_def:
+			return statement_t::make__software_system_statement(loc, tree.json_data[node.payload]);
+		case parse_node_opcode::k_container_def:
+			return statement_t::make__container_def_statement(loc, tree.json_data[node.payload]);
+		case parse_node_opcode::k_benchmark_def:
+			return statement_t::make__benchmark_def_statement(loc, node.name, body_t { parse_node_list_to_statements(types, tree, node.list) });
+
+		default:
+			quark::throw_runtime_error("Illegal statement.");
+	}
+}
+
+static std::vector<statement_t> parse_node_list_to_statements(types_t& types, const parse_tree_t& tree, const parse_node_list_t& list){
+	std::vector<statement_t> result;
+	result.reserve(list.count);
+	for(uint32_t i = 0 ; i < list.count ; i++){
+		result.push_back(parse_node_to_statement(types, tree, get_list_node(tree, list, i)));
+	}
+	return result;
+}
+
+//	The parse tree's types become the AST's types, so all type_t in the nodes can be used as-is.
 unchecked_ast_t parse_tree_to_ast(const parser::parse_tree_t& parse_tree){
-	//	Parse tree contains an array of statements, with hierachical functions and types.
-	QUARK_ASSERT(parse_tree._value.is_array());
-	types_t types;
-	const auto program_body = ast_json_to_statements(types, parse_tree._value);
+	QUARK_ASSERT(parse_tree.check_invariant());
+
+	types_t types = parse_tree.types;
+	const auto program_body = parse_node_list_to_statements(types, parse_tree, parse_tree.statements);
 	const auto gp_ast = general_purpose_ast_t{
 		body_t{ program_body },
 		{},
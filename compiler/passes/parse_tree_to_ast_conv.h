@@ -19,8 +19,6 @@ namespace parser {
 	struct parse_tree_t;
 }
 
-struct parse_tree_t;
-
 unchecked_ast_t parse_tree_to_ast(const parser::parse_tree_t& parse_tree);
 
 }	//	floyd
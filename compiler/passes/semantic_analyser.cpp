@@ -17,7 +17,11 @@
 #include "text_parser.h"
 #include "floyd_syntax.h"
 #include "collect_used_types.h"
+#include "collection_backend_pass.h"
 #include "semantic_ast.h"
+#include "ast_cache_json.h"
+
+#include <unordered_map>
 
 
 namespace floyd {
@@ -44,13 +48,51 @@ struct analyzer_imm_t {
 /*
 	Value object (MUTABLE!).
 	Represents a node in the lexical scope tree.
+
+	symbols keeps the order of the symbols, their index is their slot in codegen. symbol_index maps each name
+	to that index so lookups don't scan the scope -- the global scope holds all of corelib.
+	Only change symbols using add_symbol() and pop_symbol().
 */
 
 struct lexical_scope_t {
 	symbol_table_t symbols;
 	epure pure;
+	std::unordered_map<std::string, int> symbol_index;
 };
 
+static lexical_scope_t make_lexical_scope(const symbol_table_t& symbols, epure pure){
+	auto result = lexical_scope_t{ symbols, pure, {} };
+	for(int i = 0 ; i < symbols._symbols.size() ; i++){
+		result.symbol_index.insert({ symbols._symbols[i].first, i });
+	}
+	return result;
+}
+
+//	Returns the index of the new symbol.
+static int add_symbol(lexical_scope_t& scope, const std::string& name, const symbol_t& symbol){
+	const auto index = static_cast<int>(scope.symbols._symbols.size());
+	scope.symbols._symbols.push_back({ name, symbol });
+	scope.symbol_index.insert({ name, index });
+	return index;
+}
+
+static void pop_symbol(lexical_scope_t& scope){
+	QUARK_ASSERT(scope.symbols._symbols.empty() == false);
+
+	const auto& name = scope.symbols._symbols.back().first;
+	const auto it = scope.symbol_index.find(name);
+	if(it != scope.symbol_index.end() && it->second == scope.symbols._symbols.size() - 1){
+		scope.symbol_index.erase(it);
+	}
+	scope.symbols._symbols.pop_back();
+}
+
+//	Returns -1 if not found.
+static int find_symbol_index(const lexical_scope_t& scope, const std::string& name){
+	const auto it = scope.symbol_index.find(name);
+	return it == scope.symbol_index.end() ? -1 : it->second;
+}
+
 
 
 //////////////////////////////////////		analyser_t
@@ -159,16 +201,11 @@ static std::pair<const symbol_t*, symbol_pos_t> find_symbol_deep(const analyser_
 	QUARK_ASSERT(depth >= 0 && depth < a._lexical_scope_stack.size());
 	QUARK_ASSERT(s.size() > 0);
 
-    const auto it = std::find_if(
-    	a._lexical_scope_stack[depth].symbols._symbols.begin(),
-    	a._lexical_scope_stack[depth].symbols._symbols.end(),
-    	[&s](const std::pair<std::string, symbol_t>& e) { return e.first == s; }
-	);
-
-	if(it != a._lexical_scope_stack[depth].symbols._symbols.end()){
+	const auto& scope = a._lexical_scope_stack[depth];
+	const auto variable_index = find_symbol_index(scope, s);
+	if(variable_index != -1){
 		const auto parent_index = depth == 0 ? -1 : (int)(a._lexical_scope_stack.size() - depth - 1);
-		const auto variable_index = (int)(it - a._lexical_scope_stack[depth].symbols._symbols.begin());
-		return { &it->second, symbol_pos_t::make_stack_pos(parent_index, variable_index) };
+		return { &scope.symbols._symbols[variable_index].second, symbol_pos_t::make_stack_pos(parent_index, variable_index) };
 	}
 	else if(depth > 0){
 		return find_symbol_deep(a, depth - 1, s);
@@ -186,12 +223,7 @@ static std::pair<const symbol_t*, symbol_pos_t> find_symbol_by_name(const analys
 }
 
 static bool does_symbol_exist_shallow(const analyser_t& a, const std::string& s){
-    const auto it = std::find_if(
-    	a._lexical_scope_stack.back().symbols._symbols.begin(),
-    	a._lexical_scope_stack.back().symbols._symbols.end(),
-    	[&s](const std::pair<std::string, symbol_t>& e) { return e.first == s; }
-	);
-	return it != a._lexical_scope_stack.back().symbols._symbols.end();
+	return find_symbol_index(a._lexical_scope_stack.back(), s) != -1;
 }
 
 
@@ -491,7 +523,7 @@ std::pair<analyser_t, body_t> analyse_body(const analyser_t& a, const body_t& bo
 	auto a_acc = a;
 
 	auto new_environment = symbol_table_t{ body._symbol_table };
-	const auto lexical_scope = lexical_scope_t{ new_environment, pure };
+	const auto lexical_scope = make_lexical_scope(new_environment, pure);
 	a_acc._lexical_scope_stack.push_back(lexical_scope);
 
 	const auto result = analyse_statements(a_acc, body._statements, return_type);
@@ -585,8 +617,7 @@ std::pair<analyser_t, std::shared_ptr<statement_t>> analyse_bind_local_statement
 	//	This logic should be available for inferred binds too, in analyse_assign_statement().
 
 	const auto temp_symbol = mutable_flag ? symbol_t::make_mutable(lhs_itype) : symbol_t::make_immutable_reserve(lhs_itype);
-	a_acc._lexical_scope_stack.back().symbols._symbols.push_back({ new_local_name, temp_symbol });
-	const auto local_name_index = a_acc._lexical_scope_stack.back().symbols._symbols.size() - 1;
+	const auto local_name_index = add_symbol(a_acc._lexical_scope_stack.back(), new_local_name, temp_symbol);
 
 	try {
 		const auto rhs_expr_pair = lhs_itype.is_undefined()
@@ -611,13 +642,13 @@ std::pair<analyser_t, std::shared_ptr<statement_t>> analyse_bind_local_statement
 			//	??? Better to always initialise it, even if it's a complex value. Codegen then decides if to translate to a reserve + init. BUT PROBLEM: we lose info *when* to init the value.
 			if(is_preinitliteral(peek2(a_acc._types, lhs_itype2)) && mutable_flag == false && get_expression_type(rhs_expr_pair.second) == expression_type::k_literal){
 				const auto symbol2 = symbol_t::make_immutable_precalc(lhs_itype2, rhs_expr_pair.second.get_literal());
-				a_acc._lexical_scope_stack.back().symbols._symbols[local_name_index] = { new_local_name, symbol2 };
+				a_acc._lexical_scope_stack.back().symbols._symbols[local_name_index].second = symbol2;
 				analyze_expr_output_type(a_acc, rhs_expr_pair.second);
 				return { a_acc, {} };
 			}
 			else{
 				const auto symbol2 = mutable_flag ? symbol_t::make_mutable(lhs_itype2) : symbol_t::make_immutable_reserve(lhs_itype2);
-				a_acc._lexical_scope_stack.back().symbols._symbols[local_name_index] = { new_local_name, symbol2 };
+				a_acc._lexical_scope_stack.back().symbols._symbols[local_name_index].second = symbol2;
 				analyze_expr_output_type(a_acc, rhs_expr_pair.second);
 
 				return {
@@ -636,7 +667,7 @@ std::pair<analyser_t, std::shared_ptr<statement_t>> analyse_bind_local_statement
 	catch(...){
 
 		//	Erase temporary symbol.
-		a_acc._lexical_scope_stack.back().symbols._symbols.pop_back();
+		pop_symbol(a_acc._lexical_scope_stack.back());
 
 		throw;
 	}
@@ -1803,6 +1834,9 @@ std::pair<analyser_t, expression_t> analyse_benchmark_expression(const analyser_
 	const auto body_pair = analyse_body(acc, *details.body, epure::impure, type_t::make_void());
 	acc = body_pair.first;
 
+	//	The bytecode backend collects the samples in an [int].
+	make_vector(acc._types, type_t::make_int());
+
 	const auto e2 = expression_t::make_benchmark_expr(body_pair.second);
 	return { acc, e2 };
 }
@@ -2340,7 +2374,7 @@ static std::pair<analyser_t, expression_t> analyse_struct_definition_expression(
 	const auto named_type = make_named_type(a_acc._types, name, make_undefined());
 
 	const auto type_name_symbol = symbol_t::make_named_type(named_type);
-	a_acc._lexical_scope_stack.back().symbols._symbols.push_back({ identifier, type_name_symbol });
+	add_symbol(a_acc._lexical_scope_stack.back(), identifier, type_name_symbol);
 
 
 	std::vector<member_t> members2;
@@ -2690,42 +2724,43 @@ static std::vector<std::pair<std::string, symbol_t>> generate_builtins(analyser_
 	/*
 		Create built-in global symbol map: built in data types, built-in functions (intrinsics).
 	*/
-	auto& symbol_map = a._lexical_scope_stack.back().symbols._symbols;
-	symbol_map.push_back( make_builtin_type(a._types, type_t::make_void()) );
-	symbol_map.push_back( make_builtin_type(a._types, type_t::make_bool()) );
-	symbol_map.push_back( make_builtin_type(a._types, type_t::make_int()) );
-	symbol_map.push_back( make_builtin_type(a._types, type_t::make_double()) );
-	symbol_map.push_back( make_builtin_type(a._types, type_t::make_string()) );
-	symbol_map.push_back( make_builtin_type(a._types, type_desc_t::make_typeid()) );
-	symbol_map.push_back( make_builtin_type(a._types, type_t::make_json()) );
+	auto& scope = a._lexical_scope_stack.back();
+	const auto add = [&](const std::pair<std::string, symbol_t>& e){ add_symbol(scope, e.first, e.second); };
+	add( make_builtin_type(a._types, type_t::make_void()) );
+	add( make_builtin_type(a._types, type_t::make_bool()) );
+	add( make_builtin_type(a._types, type_t::make_int()) );
+	add( make_builtin_type(a._types, type_t::make_double()) );
+	add( make_builtin_type(a._types, type_t::make_string()) );
+	add( make_builtin_type(a._types, type_desc_t::make_typeid()) );
+	add( make_builtin_type(a._types, type_t::make_json()) );
 
 	//	"null" is equivalent to json::null
-	symbol_map.push_back( { "null", symbol_t::make_immutable_precalc(type_t::make_json(), value_t::make_json(json_t())) });
+	add( { "null", symbol_t::make_immutable_precalc(type_t::make_json(), value_t::make_json(json_t())) });
 
-	symbol_map.push_back( { "json_object", symbol_t::make_immutable_precalc(type_t::make_int(), value_t::make_int(1)) });
-	symbol_map.push_back( { "json_array", symbol_t::make_immutable_precalc(type_t::make_int(), value_t::make_int(2)) });
-	symbol_map.push_back( { "json_string", symbol_t::make_immutable_precalc(type_t::make_int(), value_t::make_int(3)) });
-	symbol_map.push_back( { "json_number", symbol_t::make_immutable_precalc(type_t::make_int(), value_t::make_int(4)) });
-	symbol_map.push_back( { "json_true", symbol_t::make_immutable_precalc(type_t::make_int(), value_t::make_int(5)) });
-	symbol_map.push_back( { "json_false", symbol_t::make_immutable_precalc(type_t::make_int(), value_t::make_int(6)) });
-	symbol_map.push_back( { "json_null", symbol_t::make_immutable_precalc(type_t::make_int(), value_t::make_int(7)) });
+	add( { "json_object", symbol_t::make_immutable_precalc(type_t::make_int(), value_t::make_int(1)) });
+	add( { "json_array", symbol_t::make_immutable_precalc(type_t::make_int(), value_t::make_int(2)) });
+	add( { "json_string", symbol_t::make_immutable_precalc(type_t::make_int(), value_t::make_int(3)) });
+	add( { "json_number", symbol_t::make_immutable_precalc(type_t::make_int(), value_t::make_int(4)) });
+	add( { "json_true", symbol_t::make_immutable_precalc(type_t::make_int(), value_t::make_int(5)) });
+	add( { "json_false", symbol_t::make_immutable_precalc(type_t::make_int(), value_t::make_int(6)) });
+	add( { "json_null", symbol_t::make_immutable_precalc(type_t::make_int(), value_t::make_int(7)) });
 
 
 	const auto benchmark_result_itype = resolve_symbols(a, k_no_location, make_benchmark_result_t(a._types));
 	const auto benchmark_result_itype2 = make_named_type(a._types, generate_type_name(a, "benchmark_result_t"), benchmark_result_itype);
-	symbol_map.push_back( { "benchmark_result_t", symbol_t::make_named_type(benchmark_result_itype2) } );
+	add( { "benchmark_result_t", symbol_t::make_named_type(benchmark_result_itype2) } );
 
 	const auto benchmark_def_itype = resolve_symbols(a, k_no_location, make_benchmark_def_t(a._types));
 	const auto benchmark_def_itype2 = make_named_type(a._types, generate_type_name(a, "benchmark_def_t"), benchmark_def_itype);
-	symbol_map.push_back( { "benchmark_def_t", symbol_t::make_named_type(benchmark_def_itype2)} );
+	add( { "benchmark_def_t", symbol_t::make_named_type(benchmark_def_itype2)} );
 
 	const auto benchmark_result_vec_type = resolve_symbols(a, k_no_location, make_vector(a._types, make_symbol_ref(a._types, "benchmark_result_t")));
-	symbol_map.push_back( { "benchmark_result_vec_t", symbol_t::make_named_type(benchmark_result_vec_type)} );
+	add( { "benchmark_result_vec_t", symbol_t::make_named_type(benchmark_result_vec_type)} );
 
 	//	Reserve a symbol table entry for benchmark_registry instance.
 	{
 		const auto benchmark_registry_type = make_vector(a._types, make_symbol_ref(a._types, "benchmark_def_t"));
-		symbol_map.push_back( {
+		add( {
 			k_global_benchmark_registry,
 			symbol_t::make_immutable_reserve(
 				resolve_symbols(a, k_no_location, benchmark_registry_type)
@@ -2733,20 +2768,18 @@ static std::vector<std::pair<std::string, symbol_t>> generate_builtins(analyser_
 		} );
 	}
 
-	return symbol_map;
+	return scope.symbols._symbols;
 }
 
 
 
 //	Create built-in global symbol map: built in data types and intrinsics.
-//	Analyze global namespace, including all Floyd functions defined there.
-const body_t make_global_body(analyser_t& a){
+//	Pushes the global scope, analyse the global statements into it and finish with make_global_body().
+static void begin_global_scope(analyser_t& a){
 	QUARK_ASSERT(a.check_invariant());
 
-	auto global_body = body_t(a._imm->_ast._tree._globals._statements, symbol_table_t{ });
-
-	auto new_environment = symbol_table_t{ global_body._symbol_table };
-	const auto lexical_scope = lexical_scope_t{ new_environment, epure::impure };
+	auto new_environment = symbol_table_t{ };
+	const auto lexical_scope = make_lexical_scope(new_environment, epure::impure);
 	a._lexical_scope_stack.push_back(lexical_scope);
 
 	const auto builtin_symbols = generate_builtins(a, *a._imm);
@@ -2755,11 +2788,14 @@ const body_t make_global_body(analyser_t& a){
 	}
 
 	if(false) trace_analyser(a);
+}
 
-	const auto result = analyse_statements(a, global_body._statements, type_t::make_void());
-	a = result.first;
+//	statements are all analysed global statements. Pops the global scope.
+static const body_t make_global_body(analyser_t& a, const std::vector<statement_t>& statements){
+	QUARK_ASSERT(a.check_invariant());
+	QUARK_ASSERT(a._lexical_scope_stack.size() == 1);
 
-	const auto body2 = body_t(result.second, result.first._lexical_scope_stack.back().symbols);
+	const auto body2 = body_t(statements, a._lexical_scope_stack.back().symbols);
 
 	if(false) trace_analyser(a);
 
@@ -2821,11 +2857,8 @@ bool analyser_t::check_invariant() const {
 //////////////////////////////////////		run_semantic_analysis()
 
 
-static semantic_ast_t run_semantic_analysis0(const unchecked_ast_t& ast){
-	QUARK_ASSERT(ast.check_invariant());
-
-	analyser_t a(ast);
-	const auto global_body3 = make_global_body(a);
+static semantic_ast_t make_semantic_ast(analyser_t& a, const std::vector<statement_t>& global_statements){
+	const auto global_body3 = make_global_body(a, global_statements);
 
 	std::vector<floyd::function_definition_t> function_defs_vec;
 	for(const auto& e: a._function_defs){
@@ -2839,7 +2872,8 @@ static semantic_ast_t run_semantic_analysis0(const unchecked_ast_t& ast){
 		._software_system = a._software_system,
 		._container_def = a._container_def
 	};
-	const auto ast3 = semantic_ast_t(ast2, a._imm->intrinsic_signatures);
+	auto ast3 = semantic_ast_t(ast2, a._imm->intrinsic_signatures);
+	select_collection_backends(ast3);
 
 	if(false){
 		{
@@ -2859,6 +2893,16 @@ static semantic_ast_t run_semantic_analysis0(const unchecked_ast_t& ast){
 	return ast3;
 }
 
+static semantic_ast_t run_semantic_analysis0(const unchecked_ast_t& ast){
+	QUARK_ASSERT(ast.check_invariant());
+
+	analyser_t a(ast);
+	begin_global_scope(a);
+	const auto result = analyse_statements(a, ast._tree._globals._statements, type_t::make_void());
+	a = result.first;
+	return make_semantic_ast(a, result.second);
+}
+
 semantic_ast_t run_semantic_analysis(const unchecked_ast_t& ast){
 	QUARK_ASSERT(ast.check_invariant());
 
@@ -2899,5 +2943,119 @@ semantic_ast_t run_semantic_analysis(const unchecked_ast_t& ast){
 
 
 
+//////////////////////////////////////		analysed_prefix_t
+
+
+//	The analyser stopped after the prefix's global statements, with the global scope still open.
+struct analysed_prefix_t {
+	analyser_t a;
+	std::vector<statement_t> global_statements;
+};
+
+std::shared_ptr<const analysed_prefix_t> analyse_prefix(const unchecked_ast_t& prefix_ast){
+	QUARK_ASSERT(prefix_ast.check_invariant());
+
+	try {
+		analyser_t a(prefix_ast);
+		begin_global_scope(a);
+		const auto result = analyse_statements(a, prefix_ast._tree._globals._statements, type_t::make_void());
+		return std::make_shared<analysed_prefix_t>(analysed_prefix_t{ result.first, result.second });
+	}
+	catch(const compiler_error& e){
+		const auto what = e.what();
+		const auto what2 = std::string("[Semantics] ") + what;
+		throw compiler_error(e.location, e.location2, what2);
+	}
+}
+
+const types_t& get_prefix_types(const analysed_prefix_t& prefix){
+	return prefix.a._types;
+}
+
+semantic_ast_t run_semantic_analysis(const analysed_prefix_t& prefix, const unchecked_ast_t& ast){
+	QUARK_ASSERT(ast.check_invariant());
+	QUARK_ASSERT(ast._tree._types.nodes.size() >= prefix.a._types.nodes.size());
+
+	try {
+		//	The program's types extend the prefix's types, so all types in the prefix are still valid.
+		auto a = prefix.a;
+		a._types = ast._tree._types;
+		a._imm = std::make_shared<analyzer_imm_t>(analyzer_imm_t{ ast, prefix.a._imm->intrinsic_signatures });
+
+		const auto result = analyse_statements(a, ast._tree._globals._statements, type_t::make_void());
+		a = result.first;
+
+		auto global_statements = prefix.global_statements;
+		global_statements.insert(global_statements.end(), result.second.begin(), result.second.end());
+		return make_semantic_ast(a, global_statements);
+	}
+	catch(const compiler_error& e){
+		const auto what = e.what();
+		const auto what2 = std::string("[Semantics] ") + what;
+		throw compiler_error(e.location, e.location2, what2);
+	}
+}
+
+json_t analysed_prefix_to_json(const analysed_prefix_t& prefix){
+	const auto& a = prefix.a;
+	QUARK_ASSERT(a.check_invariant());
+	QUARK_ASSERT(a._lexical_scope_stack.size() == 1);
+
+	//	The analyser keeps the parsed software-system and container-def but not their JSON.
+	if(a._software_system._name.empty() == false || a._container_def._name.empty() == false){
+		throw std::runtime_error("Can't store a prefix with a software-system or container-def.");
+	}
+
+	std::vector<json_t> function_defs;
+	for(const auto& e: a._function_defs){
+		function_defs.push_back(json_t::make_array({ e.first.name, function_def_to_cache_json(e.second) }));
+	}
+	std::vector<json_t> benchmark_defs;
+	for(const auto& e: a.benchmark_defs){
+		benchmark_defs.push_back(expression_to_cache_json(e));
+	}
+
+	const auto& global_scope = a._lexical_scope_stack.front();
+	return json_t::make_object({
+		{ "types", types_to_json(a._types) },
+		{ "global_symbols", symbols_to_cache_json(global_scope.symbols) },
+		{ "global_pure", json_t(global_scope.pure == epure::pure) },
+		{ "function_defs", json_t::make_array(function_defs) },
+		{ "benchmark_defs", json_t::make_array(benchmark_defs) },
+		{ "scope_id_generator", json_t(a.scope_id_generator) },
+		{ "global_statements", statements_to_cache_json(prefix.global_statements) }
+	});
+}
+
+std::shared_ptr<const analysed_prefix_t> analysed_prefix_from_json(const json_t& json){
+	const auto types = types_from_json(json.get_object_element("types"));
+
+	//	run_semantic_analysis() replaces the prefix's unchecked AST with the program's, so only its types are needed.
+	//	The analyser makes the intrinsics' types, which must already be in the saved types.
+	analyser_t a(unchecked_ast_t{ general_purpose_ast_t{ body_t(), {}, types, {}, {} } });
+	if(a._types.nodes.size() != types.nodes.size()){
+		throw std::runtime_error("Prefix JSON is missing intrinsic types.");
+	}
+
+	const auto symbols = symbols_from_cache_json(a._types, json.get_object_element("global_symbols"));
+	const auto pure = json.get_object_element("global_pure").is_true() ? epure::pure : epure::impure;
+	a._lexical_scope_stack.push_back(make_lexical_scope(symbols, pure));
+
+	for(const auto& e: json.get_object_element("function_defs").get_array()){
+		const auto def = function_def_from_cache_json(a._types, e.get_array_n(1));
+		a._function_defs.insert({ function_id_t { e.get_array_n(0).get_string() }, def });
+	}
+	for(const auto& e: json.get_object_element("benchmark_defs").get_array()){
+		a.benchmark_defs.push_back(expression_from_cache_json(a._types, e));
+	}
+	a.scope_id_generator = static_cast<int>(json.get_object_element("scope_id_generator").get_number());
+
+	const auto global_statements = statements_from_cache_json(a._types, json.get_object_element("global_statements"));
+	QUARK_ASSERT(a._types.nodes.size() == types.nodes.size());
+	QUARK_ASSERT(a.check_invariant());
+	return std::make_shared<analysed_prefix_t>(analysed_prefix_t{ a, global_statements });
+}
+
+
 
 }	//	floyd
@@ -28,13 +28,40 @@
 	Output is a program that is correct with no type/semantic errors.
 */
 
+#include <memory>
+
+struct json_t;
+
 namespace floyd {
 
 struct semantic_ast_t;
 struct unchecked_ast_t;
+struct types_t;
 
 semantic_ast_t run_semantic_analysis(const unchecked_ast_t& ast);
 
+
+/*
+	A prefix is source code that many programs start with, like corelib. Analyse it once and reuse the
+	result for each program instead of analysing the prefix again.
+
+	1. analyse_prefix() the prefix's AST.
+	2. Parse the program (without the prefix) into a copy of get_prefix_types(), so its types extend them.
+	3. run_semantic_analysis(prefix, program_ast).
+
+	The result is the same program as analysing prefix + program together. An analysed_prefix_t is immutable.
+*/
+struct analysed_prefix_t;
+
+std::shared_ptr<const analysed_prefix_t> analyse_prefix(const unchecked_ast_t& prefix_ast);
+const types_t& get_prefix_types(const analysed_prefix_t& prefix);
+semantic_ast_t run_semantic_analysis(const analysed_prefix_t& prefix, const unchecked_ast_t& ast);
+
+//	Exact JSON of an analysed prefix, used to cache it on disk. The loaded prefix analyses programs exactly
+//	like the saved one. Throws if the prefix has a software-system or container-def: those can't be stored.
+json_t analysed_prefix_to_json(const analysed_prefix_t& prefix);
+std::shared_ptr<const analysed_prefix_t> analysed_prefix_from_json(const json_t& json);
+
 }	// Floyd
 
 #endif /* semantic_analyser_hpp */
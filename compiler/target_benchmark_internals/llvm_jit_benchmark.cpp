@@ -0,0 +1,60 @@
+//
+//  llvm_jit_benchmark.cpp
+//  Floyd
+//
+//  Created by Marcus Zetterquist on 2026-10-18.
+//  Copyright © 2026 Marcus Zetterquist. All rights reserved.
+//
+
+#include "benchmark/benchmark.h"
+
+#include "floyd_llvm.h"
+#include "floyd_llvm_runtime.h"
+#include "compiler_basics.h"
+#include "file_handling.h"
+#include "utils.h"
+
+#include <string>
+#include <vector>
+
+#include "quark.h"
+
+using namespace floyd;
+
+
+
+////////////////////////////////		BENCHMARK -- JIT optimization levels
+
+
+/*
+	Runs every benchmark-def in examples/benchmarks.floyd through the JIT, once per optimization level:
+	0 = -g, 1 = -O1, 2 = -O2, 3 = -O3.
+
+	Uses manual time = the sum of the durations Floyd measured itself, so parsing, codegen and JIT time
+	is not included, only the generated code.
+*/
+static void BM_jit_optimization_level(benchmark::State& state) {
+	const auto level = static_cast<eoptimization_level>(state.range(0));
+	const auto settings = compiler_settings_t { make_default_config(), level };
+
+	const auto path = get_working_dir() + "/examples/benchmarks.floyd";
+	const auto program_source = read_text_file(path);
+
+	const auto b = collect_benchmarks(program_source, path, compilation_unit_mode::k_include_core_lib, settings);
+	const auto tests = mapf<std::string>(b, [](const bench_t& e){ return e.benchmark_id.test; });
+
+	for (auto _ : state) {
+		(void)_;
+
+		const auto results = run_benchmarks(program_source, path, compilation_unit_mode::k_include_core_lib, settings, tests);
+
+		int64_t sum_ns = 0;
+		for(const auto& e: results){
+			sum_ns = sum_ns + e.result.dur;
+		}
+		state.SetIterationTime(static_cast<double>(sum_ns) / 1000000000.0);
+	}
+
+	state.counters["benchmark-defs"] = static_cast<double>(tests.size());
+}
+BENCHMARK(BM_jit_optimization_level)->DenseRange(0, 3)->UseManualTime()->Unit(benchmark::kMillisecond);
@@ -0,0 +1,95 @@
+//
+//  parser_benchmark.cpp
+//  Floyd
+//
+//  Created by Marcus Zetterquist on 2026-10-18.
+//  Copyright © 2026 Marcus Zetterquist. All rights reserved.
+//
+
+#include "benchmark/benchmark.h"
+
+#include "floyd_parser.h"
+#include "parser_primitives.h"
+#include "text_parser.h"
+#include "floyd_corelib.h"
+#include "file_handling.h"
+
+#include <string>
+
+#include "quark.h"
+
+using namespace floyd;
+
+
+
+////////////////////////////////		BENCHMARK -- parser throughput
+
+
+static void parse_source(benchmark::State& state, const std::string& source){
+	for (auto _ : state) {
+		(void)_;
+
+		const auto result = parser::parse_program2(source);
+		benchmark::DoNotOptimize(result);
+	}
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(source.size()));
+}
+
+static void BM_parse_corelib(benchmark::State& state) {
+	parse_source(state, k_corelib_builtin_types_and_constants);
+}
+BENCHMARK(BM_parse_corelib);
+
+static void BM_parse_benchmarks_floyd(benchmark::State& state) {
+	const auto path = get_working_dir() + "/examples/benchmarks.floyd";
+	parse_source(state, read_text_file(path));
+}
+BENCHMARK(BM_parse_benchmarks_floyd);
+
+
+
+////////////////////////////////		BENCHMARK -- cursor
+
+
+/*
+	Walks a text one character at a time, like the parser primitives do. Compares seq_t, that copies a
+	shared_ptr and a debug string per step, against text_cursor_t.
+*/
+
+static std::string make_walk_text(int64_t count){
+	std::string s;
+	for(int64_t i = 0 ; i < count ; i++){
+		s.push_back((i % 17) == 16 ? '\n' : 'a');
+	}
+	return s;
+}
+
+static void BM_walk_seq_t(benchmark::State& state) {
+	const auto text = make_walk_text(state.range(0));
+	for (auto _ : state) {
+		(void)_;
+
+		auto pos = seq_t(text);
+		while(pos.empty() == false){
+			pos = pos.rest1();
+		}
+		benchmark::DoNotOptimize(pos);
+	}
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_walk_seq_t)->Arg(1000)->Arg(100000);
+
+static void BM_walk_text_cursor_t(benchmark::State& state) {
+	const auto text = make_walk_text(state.range(0));
+	for (auto _ : state) {
+		(void)_;
+
+		auto pos = text_cursor_t(text);
+		while(pos.empty() == false){
+			pos = pos.rest1();
+		}
+		benchmark::DoNotOptimize(pos);
+	}
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_walk_text_cursor_t)->Arg(1000)->Arg(100000);
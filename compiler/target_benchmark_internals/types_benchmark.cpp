@@ -0,0 +1,79 @@
+//
+//  types_benchmark.cpp
+//  Floyd
+//
+//  Created by Marcus Zetterquist on 2026-10-18.
+//  Copyright © 2026 Marcus Zetterquist. All rights reserved.
+//
+
+#include "benchmark/benchmark.h"
+
+#include "types.h"
+#include "compiler_helpers.h"
+#include "semantic_ast.h"
+
+#include <string>
+
+#include "quark.h"
+
+using namespace floyd;
+
+
+
+////////////////////////////////		BENCHMARK -- interning
+
+
+/*
+	Interns state.range(0) unique struct types, each with a vector and a function type using it, then
+	looks all of them up again. Time per type should stay flat as the number of types grows.
+*/
+
+static void BM_intern_struct_types(benchmark::State& state) {
+	const auto count = state.range(0);
+	for (auto _ : state) {
+		(void)_;
+
+		types_t types;
+		for(int64_t i = 0 ; i < count ; i++){
+			const auto s = make_struct(types, struct_type_desc_t({ member_t(type_t::make_int(), "m" + std::to_string(i)) }));
+			const auto v = make_vector(types, s);
+			make_function(types, v, { s }, epure::pure);
+		}
+		for(int64_t i = 0 ; i < count ; i++){
+			const auto s = make_struct(types, struct_type_desc_t({ member_t(type_t::make_int(), "m" + std::to_string(i)) }));
+			benchmark::DoNotOptimize(make_vector(types, s));
+		}
+		benchmark::DoNotOptimize(types);
+	}
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * count);
+}
+BENCHMARK(BM_intern_struct_types)->Arg(100)->Arg(1000)->Arg(10000);
+
+
+
+////////////////////////////////		BENCHMARK -- compile
+
+
+//	Generates a program with one struct and one function using it per count, like protocol bindings.
+static std::string make_struct_types_program(int64_t count){
+	std::string s;
+	for(int64_t i = 0 ; i < count ; i++){
+		const auto n = std::to_string(i);
+		s += "struct s" + n + " { int a" + n + " string b" + n + " }\n";
+		s += "func [s" + n + "] f" + n + "(s" + n + " x){ return [x] }\n";
+	}
+	return s;
+}
+
+static void BM_compile_struct_types(benchmark::State& state) {
+	const auto count = state.range(0);
+	const auto cu = make_compilation_unit_nolib(make_struct_types_program(count), "");
+	for (auto _ : state) {
+		(void)_;
+
+		const auto result = compile_to_sematic_ast__errors(cu);
+		benchmark::DoNotOptimize(result);
+	}
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * count);
+}
+BENCHMARK(BM_compile_struct_types)->Arg(100)->Arg(1000)->Unit(benchmark::kMillisecond);
@@ -49,9 +49,12 @@ USAGE
 |compile  | floyd compile mygame.floyd         | compile the floyd program "mygame.floyd" to a native object file, output to stdout
 |compile  | floyd compile game.floyd myl.floyd | compile the floyd program "game.floyd" and "myl.floyd" to one native object file, output to stdout
 |compile  | floyd compile game.floyd -o test.o | compile the floyd program "game.floyd" to a native object file .o, called "test.o"
+|compile  | floyd compile -t game.floyd        | also prints the time spent in each compiler phase
 |bench    | floyd bench mygame.floyd           | Runs all benchmarks, as defined by benchmark-def statements in Floyd program
 |bench    | floyd bench game.floyd rle game_lp | Runs specified benchmarks: "rle" and "game_lp"
 |bench    | floyd bench -l mygame.floyd        | Returns list of benchmarks
+|bench    | floyd bench -fjson mygame.floyd    | Runs all benchmarks, outputs results and hardware info as JSON
+|bench    | floyd bench -c old.json new.json   | Compares two JSON benchmark outputs, fails on significant regressions
 |hwcaps   | floyd hwcaps                       | Outputs hardware capabilities
 |runtests | floyd runtests                     | Runs Floyd built internal unit tests
 
@@ -67,10 +70,18 @@ FLAGS
 | -O2      | Enable default optimizations
 | -O3      | Enable expensive optimizations
 | -l       | floyd bench returns a list of all benchmarks
+| -fjson   | floyd bench outputs JSON
+| -fcsv    | floyd bench outputs CSV
+| -c       | floyd bench compares two JSON outputs
 | -vcarray | Force vectors to use carray backend
 | -vhamt   | Force vectors to use HAMT backend (this is default)
+| -vpertype| Pick carray or HAMT for each vector type, depending on how the program uses it
 | -dcppmap | Force dictionaries to use c++ map as backend
 | -dhamt   | Force dictionaries to use HAMT backend (this is default)
+| -dhashtable | Force dictionaries to use an open-addressing hash table as backend
+| -dpertype| Pick HAMT or hash table for each dictionary type, depending on how the program uses it
+| -spool   | Run Floyd processes on a fixed pool of worker threads, exit when no messages are left (this is default)
+| -sthreads| Run each clock bus of Floyd processes on its own OS thread, exit when every process got "stop"
 
 MORE EXAMPLES
 
@@ -230,7 +241,7 @@ eoutput_type get_output_type(const command_line_args_t& args){
 }
 
 
-const std::string k_flags = "tlpaiogO:v:d:";
+const std::string k_flags = "tlpaiogcO:v:d:s:f:";
 
 
 struct compile_more_t {
@@ -273,6 +284,9 @@ static vector_backend get_vector_backend(const std::map<std::string, flag_info_t
 		else if(it->second == flag_info_t { flag_info_t::etype::flag_with_parameter, "carray"} ){
 			return vector_backend::carray;
 		}
+		else if(it->second == flag_info_t { flag_info_t::etype::flag_with_parameter, "pertype"} ){
+			return vector_backend::per_type;
+		}
 		else{
 			throw std::exception();
 		}
@@ -290,6 +304,12 @@ static dict_backend get_dict_backend(const std::map<std::string, flag_info_t>& f
 		else if(it->second == flag_info_t { flag_info_t::etype::flag_with_parameter, "cppmap"} ){
 			return dict_backend::cppmap;
 		}
+		else if(it->second == flag_info_t { flag_info_t::etype::flag_with_parameter, "hashtable"} ){
+			return dict_backend::hashtable;
+		}
+		else if(it->second == flag_info_t { flag_info_t::etype::flag_with_parameter, "pertype"} ){
+			return dict_backend::per_type;
+		}
 		else{
 			throw std::exception();
 		}
@@ -299,12 +319,49 @@ static dict_backend get_dict_backend(const std::map<std::string, flag_info_t>& f
 	}
 }
 
+static process_scheduling get_process_scheduling(const std::map<std::string, flag_info_t>& flags){
+	const auto it = flags.find("s");
+	if(it != flags.end()){
+		if(it->second == flag_info_t { flag_info_t::etype::flag_with_parameter, "pool"} ){
+			return process_scheduling::worker_pool;
+		}
+		else if(it->second == flag_info_t { flag_info_t::etype::flag_with_parameter, "threads"} ){
+			return process_scheduling::thread_per_clock_bus;
+		}
+		else{
+			throw std::exception();
+		}
+	}
+	else{
+		return process_scheduling::worker_pool;
+	}
+}
+
+static command_t::user_benchmarks_t::output_format get_benchmark_output_format(const std::map<std::string, flag_info_t>& flags){
+	const auto it = flags.find("f");
+	if(it != flags.end()){
+		if(it->second == flag_info_t { flag_info_t::etype::flag_with_parameter, "json"} ){
+			return command_t::user_benchmarks_t::output_format::json;
+		}
+		else if(it->second == flag_info_t { flag_info_t::etype::flag_with_parameter, "csv"} ){
+			return command_t::user_benchmarks_t::output_format::csv;
+		}
+		else{
+			throw std::runtime_error("Unknown output format \"" + it->second.parameter + "\".");
+		}
+	}
+	else{
+		return command_t::user_benchmarks_t::output_format::text;
+	}
+}
+
 static compiler_settings_t get_compiler_settings(const std::map<std::string, flag_info_t>& flags){
 	const auto optimization_level = get_optimization_level(flags);
 	const auto vector_backend = get_vector_backend(flags);
 	const auto dict_backend = get_dict_backend(flags);
+	const auto process_scheduling = get_process_scheduling(flags);
 
-	return compiler_settings_t { { vector_backend, dict_backend, false }, optimization_level }; 
+	return compiler_settings_t { { vector_backend, dict_backend, false, process_scheduling }, optimization_level }; 
 }
 
 compile_more_t parse_floyd_compile_command_more(const command_line_args_t& command_line_args){
@@ -364,7 +421,9 @@ command_t parse_floyd_command_line(const std::vector<std::string>& args){
 	const auto command_line_args = parse_command_line_args_subcommand(args, k_flags);
 	const auto path_parts = SplitPath(command_line_args.command);
 
+#if DEBUG && 0
 	std::cout << "name " << path_parts.fName << std::endl;
+#endif
 
 	// WINDOWS TODO fix QUARK_ASSERT(path_parts.fName == "floyd" || path_parts.fName == ".\floyd.exe"	|| path_parts.fName == "floydut");
 	const bool trace_on = command_line_args.flags.find("t") != command_line_args.flags.end();
@@ -406,17 +465,25 @@ command_t parse_floyd_command_line(const std::vector<std::string>& args){
 		const std::vector<std::string> args2(floyd_args.begin() + 1, floyd_args.end());
 
 		const auto compiler_settings = get_compiler_settings(command_line_args.flags);
+		const auto format = get_benchmark_output_format(command_line_args.flags);
 
 		const bool list_mode = command_line_args.flags.find("l") != command_line_args.flags.end();
+		const bool compare_mode = command_line_args.flags.find("c") != command_line_args.flags.end();
 		if(list_mode){
-			return command_t { command_t::user_benchmarks_t { command_t::user_benchmarks_t::mode::list, source_path, args2, backend, compiler_settings, trace_on } };
+			return command_t { command_t::user_benchmarks_t { command_t::user_benchmarks_t::mode::list, source_path, args2, backend, compiler_settings, trace_on, format } };
+		}
+		else if(compare_mode){
+			if(args2.size() != 1){
+				throw std::runtime_error("Compare requires two benchmark JSON files.");
+			}
+			return command_t { command_t::user_benchmarks_t { command_t::user_benchmarks_t::mode::compare, source_path, args2, backend, compiler_settings, trace_on, format } };
 		}
 		else{
 			if(args2.size() == 0){
-				return command_t { command_t::user_benchmarks_t { command_t::user_benchmarks_t::mode::run_all, source_path, {}, backend, compiler_settings, trace_on } };
+				return command_t { command_t::user_benchmarks_t { command_t::user_benchmarks_t::mode::run_all, source_path, {}, backend, compiler_settings, trace_on, format } };
 			}
 			else{
-				return command_t { command_t::user_benchmarks_t { command_t::user_benchmarks_t::mode::run_specified, source_path, args2, backend, compiler_settings, trace_on } };
+				return command_t { command_t::user_benchmarks_t { command_t::user_benchmarks_t::mode::run_specified, source_path, args2, backend, compiler_settings, trace_on, format } };
 			}
 		}
 	}
@@ -469,6 +536,14 @@ QUARK_TEST("", "parse_floyd_command_line()", "floyd run", ""){
 	QUARK_VERIFY(r2.backend == ebackend::bytecode);
 	QUARK_VERIFY(r2.trace == false);
 }
+QUARK_TEST("", "parse_floyd_command_line()", "floyd run", ""){
+	const auto r = parse_floyd_command_line(string_to_args("floyd run -sthreads mygame.floyd"));
+	const auto& r2 = std::get<command_t::compile_and_run_t>(r._contents);
+	QUARK_VERIFY(r2.source_path == "mygame.floyd");
+	QUARK_VERIFY(r2.backend == ebackend::llvm);
+	QUARK_VERIFY(r2.compiler_settings.config.process_scheduling_mode == process_scheduling::thread_per_clock_bus);
+	QUARK_VERIFY(r2.trace == false);
+}
 
 
 
@@ -498,7 +573,7 @@ QUARK_TEST("", "parse_floyd_command_line()", "floyd compile", ""){
 	QUARK_VERIFY(r2.dest_path == "");
 	QUARK_VERIFY(r2.output_type == eoutput_type::object_file);
 	QUARK_VERIFY(r2.backend == ebackend::llvm);
-	QUARK_VERIFY(r2.compiler_settings == (compiler_settings_t { config_t{ vector_backend::hamt, dict_backend::hamt, false }, eoptimization_level::O2_enable_default_optimizations }));
+	QUARK_VERIFY(r2.compiler_settings == (compiler_settings_t { config_t{ vector_backend::hamt, dict_backend::hamt, false, process_scheduling::worker_pool }, eoptimization_level::O2_enable_default_optimizations }));
 	QUARK_VERIFY(r2.trace == false);
 }
 QUARK_TEST("", "parse_floyd_command_line()", "floyd compile", ""){
@@ -508,7 +583,7 @@ QUARK_TEST("", "parse_floyd_command_line()", "floyd compile", ""){
 	QUARK_VERIFY(r2.dest_path == "");
 	QUARK_VERIFY(r2.output_type == eoutput_type::object_file);
 	QUARK_VERIFY(r2.backend == ebackend::llvm);
-	QUARK_VERIFY(r2.compiler_settings == (compiler_settings_t { config_t{ vector_backend::hamt, dict_backend::hamt, false }, eoptimization_level::O2_enable_default_optimizations }));
+	QUARK_VERIFY(r2.compiler_settings == (compiler_settings_t { config_t{ vector_backend::hamt, dict_backend::hamt, false, process_scheduling::worker_pool }, eoptimization_level::O2_enable_default_optimizations }));
 	QUARK_VERIFY(r2.trace == true);
 }
 
@@ -519,7 +594,7 @@ QUARK_TEST("", "parse_floyd_command_line()", "floyd compile", ""){
 	QUARK_VERIFY(r2.dest_path == "");
 	QUARK_VERIFY(r2.output_type == eoutput_type::parse_tree);
 	QUARK_VERIFY(r2.backend == ebackend::llvm);
-	QUARK_VERIFY(r2.compiler_settings == (compiler_settings_t { config_t{ vector_backend::hamt, dict_backend::hamt, false }, eoptimization_level::O2_enable_default_optimizations }));
+	QUARK_VERIFY(r2.compiler_settings == (compiler_settings_t { config_t{ vector_backend::hamt, dict_backend::hamt, false, process_scheduling::worker_pool }, eoptimization_level::O2_enable_default_optimizations }));
 	QUARK_VERIFY(r2.trace == false);
 }
 
@@ -530,7 +605,7 @@ QUARK_TEST("", "parse_floyd_command_line()", "floyd compile", ""){
 	QUARK_VERIFY(r2.dest_path == "");
 	QUARK_VERIFY(r2.output_type == eoutput_type::ast);
 	QUARK_VERIFY(r2.backend == ebackend::llvm);
-	QUARK_VERIFY(r2.compiler_settings == (compiler_settings_t { config_t{ vector_backend::hamt, dict_backend::hamt, false }, eoptimization_level::O2_enable_default_optimizations }));
+	QUARK_VERIFY(r2.compiler_settings == (compiler_settings_t { config_t{ vector_backend::hamt, dict_backend::hamt, false, process_scheduling::worker_pool }, eoptimization_level::O2_enable_default_optimizations }));
 	QUARK_VERIFY(r2.trace == false);
 }
 QUARK_TEST("", "parse_floyd_command_line()", "floyd compile", ""){
@@ -540,7 +615,7 @@ QUARK_TEST("", "parse_floyd_command_line()", "floyd compile", ""){
 	QUARK_VERIFY(r2.dest_path == "");
 	QUARK_VERIFY(r2.output_type == eoutput_type::ir);
 	QUARK_VERIFY(r2.backend == ebackend::llvm);
-	QUARK_VERIFY(r2.compiler_settings == (compiler_settings_t { config_t{ vector_backend::hamt, dict_backend::hamt, false }, eoptimization_level::O2_enable_default_optimizations }));
+	QUARK_VERIFY(r2.compiler_settings == (compiler_settings_t { config_t{ vector_backend::hamt, dict_backend::hamt, false, process_scheduling::worker_pool }, eoptimization_level::O2_enable_default_optimizations }));
 	QUARK_VERIFY(r2.trace == false);
 }
 QUARK_TEST("", "parse_floyd_command_line()", "floyd compile", ""){
@@ -550,7 +625,7 @@ QUARK_TEST("", "parse_floyd_command_line()", "floyd compile", ""){
 	QUARK_VERIFY(r2.dest_path == "");
 	QUARK_VERIFY(r2.output_type == eoutput_type::parse_tree);
 	QUARK_VERIFY(r2.backend == ebackend::llvm);
-	QUARK_VERIFY(r2.compiler_settings == (compiler_settings_t { config_t{ vector_backend::hamt, dict_backend::hamt, false }, eoptimization_level::O2_enable_default_optimizations }));
+	QUARK_VERIFY(r2.compiler_settings == (compiler_settings_t { config_t{ vector_backend::hamt, dict_backend::hamt, false, process_scheduling::worker_pool }, eoptimization_level::O2_enable_default_optimizations }));
 	QUARK_VERIFY(r2.trace == true);
 }
 
@@ -561,7 +636,7 @@ QUARK_TEST("", "parse_floyd_command_line()", "floyd compile", ""){
 	QUARK_VERIFY(r2.dest_path == "")
 	QUARK_VERIFY(r2.output_type == eoutput_type::object_file);
 	QUARK_VERIFY(r2.backend == ebackend::llvm);
-	QUARK_VERIFY(r2.compiler_settings == (compiler_settings_t { config_t{ vector_backend::hamt, dict_backend::hamt, false }, eoptimization_level::O2_enable_default_optimizations }));
+	QUARK_VERIFY(r2.compiler_settings == (compiler_settings_t { config_t{ vector_backend::hamt, dict_backend::hamt, false, process_scheduling::worker_pool }, eoptimization_level::O2_enable_default_optimizations }));
 	QUARK_VERIFY(r2.trace == false);
 }
 
@@ -572,7 +647,7 @@ QUARK_TEST("", "parse_floyd_command_line()", "floyd compile", ""){
 	QUARK_VERIFY(r2.dest_path == "outdir/outfile")
 	QUARK_VERIFY(r2.output_type == eoutput_type::object_file);
 	QUARK_VERIFY(r2.backend == ebackend::llvm);
-	QUARK_VERIFY(r2.compiler_settings == (compiler_settings_t { config_t{ vector_backend::hamt, dict_backend::hamt, false }, eoptimization_level::O2_enable_default_optimizations }));
+	QUARK_VERIFY(r2.compiler_settings == (compiler_settings_t { config_t{ vector_backend::hamt, dict_backend::hamt, false, process_scheduling::worker_pool }, eoptimization_level::O2_enable_default_optimizations }));
 	QUARK_VERIFY(r2.trace == false);
 }
 
@@ -583,7 +658,7 @@ QUARK_TEST("", "parse_floyd_command_line()", "floyd compile", ""){
 	QUARK_VERIFY(r2.dest_path == "");
 	QUARK_VERIFY(r2.output_type == eoutput_type::ir);
 	QUARK_VERIFY(r2.backend == ebackend::llvm);
-	QUARK_VERIFY(r2.compiler_settings == (compiler_settings_t { config_t{ vector_backend::hamt, dict_backend::hamt, false }, eoptimization_level::g_no_optimizations_enable_debugging }));
+	QUARK_VERIFY(r2.compiler_settings == (compiler_settings_t { config_t{ vector_backend::hamt, dict_backend::hamt, false, process_scheduling::worker_pool }, eoptimization_level::g_no_optimizations_enable_debugging }));
 	QUARK_VERIFY(r2.trace == false);
 }
 
@@ -594,7 +669,7 @@ QUARK_TEST("", "parse_floyd_command_line()", "floyd compile", ""){
 	QUARK_VERIFY(r2.dest_path == "");
 	QUARK_VERIFY(r2.output_type == eoutput_type::ir);
 	QUARK_VERIFY(r2.backend == ebackend::llvm);
-	QUARK_VERIFY(r2.compiler_settings == (compiler_settings_t { config_t{ vector_backend::hamt, dict_backend::hamt, false }, eoptimization_level::O1_enable_trivial_optimizations }));
+	QUARK_VERIFY(r2.compiler_settings == (compiler_settings_t { config_t{ vector_backend::hamt, dict_backend::hamt, false, process_scheduling::worker_pool }, eoptimization_level::O1_enable_trivial_optimizations }));
 	QUARK_VERIFY(r2.trace == false);
 }
 
@@ -605,7 +680,7 @@ QUARK_TEST("", "parse_floyd_command_line()", "floyd compile", ""){
 	QUARK_VERIFY(r2.dest_path == "");
 	QUARK_VERIFY(r2.output_type == eoutput_type::ir);
 	QUARK_VERIFY(r2.backend == ebackend::llvm);
-	QUARK_VERIFY(r2.compiler_settings == (compiler_settings_t { config_t{ vector_backend::hamt, dict_backend::hamt, false }, eoptimization_level::O2_enable_default_optimizations }));
+	QUARK_VERIFY(r2.compiler_settings == (compiler_settings_t { config_t{ vector_backend::hamt, dict_backend::hamt, false, process_scheduling::worker_pool }, eoptimization_level::O2_enable_default_optimizations }));
 	QUARK_VERIFY(r2.trace == false);
 }
 
@@ -616,7 +691,7 @@ QUARK_TEST("", "parse_floyd_command_line()", "floyd compile", ""){
 	QUARK_VERIFY(r2.dest_path == "");
 	QUARK_VERIFY(r2.output_type == eoutput_type::ir);
 	QUARK_VERIFY(r2.backend == ebackend::llvm);
-	QUARK_VERIFY(r2.compiler_settings == (compiler_settings_t { config_t{ vector_backend::hamt, dict_backend::hamt, false }, eoptimization_level::O3_enable_expensive_optimizations }));
+	QUARK_VERIFY(r2.compiler_settings == (compiler_settings_t { config_t{ vector_backend::hamt, dict_backend::hamt, false, process_scheduling::worker_pool }, eoptimization_level::O3_enable_expensive_optimizations }));
 	QUARK_VERIFY(r2.trace == false);
 }
 
@@ -627,7 +702,7 @@ QUARK_TEST("", "parse_floyd_command_line()", "floyd compile", ""){
 	QUARK_VERIFY(r2.dest_path == "c.txt");
 	QUARK_VERIFY(r2.output_type == eoutput_type::ir);
 	QUARK_VERIFY(r2.backend == ebackend::llvm);
-	QUARK_VERIFY(r2.compiler_settings == (compiler_settings_t { config_t{ vector_backend::hamt, dict_backend::hamt, false }, eoptimization_level::O3_enable_expensive_optimizations }));
+	QUARK_VERIFY(r2.compiler_settings == (compiler_settings_t { config_t{ vector_backend::hamt, dict_backend::hamt, false, process_scheduling::worker_pool }, eoptimization_level::O3_enable_expensive_optimizations }));
 	QUARK_VERIFY(r2.trace == false);
 }
 
@@ -640,10 +715,22 @@ QUARK_TEST("", "parse_floyd_command_line()", "floyd compile", ""){
 	QUARK_VERIFY(r2.dest_path == "");
 	QUARK_VERIFY(r2.output_type == eoutput_type::object_file);
 	QUARK_VERIFY(r2.backend == ebackend::llvm);
-	QUARK_VERIFY(r2.compiler_settings == (compiler_settings_t { config_t{ vector_backend::carray, dict_backend::cppmap, false }, eoptimization_level::O2_enable_default_optimizations }));
+	QUARK_VERIFY(r2.compiler_settings == (compiler_settings_t { config_t{ vector_backend::carray, dict_backend::cppmap, false, process_scheduling::worker_pool }, eoptimization_level::O2_enable_default_optimizations }));
 	QUARK_VERIFY(r2.trace == false);
 }
 
+QUARK_TEST("", "parse_floyd_command_line()", "floyd compile -dhashtable", ""){
+	const auto r = parse_floyd_command_line(string_to_args("floyd compile -dhashtable mygame.floyd"));
+	const auto& r2 = std::get<command_t::compile_t>(r._contents);
+	QUARK_VERIFY(r2.compiler_settings == (compiler_settings_t { config_t{ vector_backend::hamt, dict_backend::hashtable, false, process_scheduling::worker_pool }, eoptimization_level::O2_enable_default_optimizations }));
+}
+
+QUARK_TEST("", "parse_floyd_command_line()", "floyd compile -vpertype -dpertype", ""){
+	const auto r = parse_floyd_command_line(string_to_args("floyd compile -vpertype -dpertype mygame.floyd"));
+	const auto& r2 = std::get<command_t::compile_t>(r._contents);
+	QUARK_VERIFY(r2.compiler_settings == (compiler_settings_t { config_t{ vector_backend::per_type, dict_backend::per_type, false, process_scheduling::worker_pool }, eoptimization_level::O2_enable_default_optimizations }));
+}
+
 
 
 
@@ -696,6 +783,22 @@ QUARK_TEST("", "parse_floyd_command_line()", "floyd bench -tl mygame.floyd", "")
 	QUARK_VERIFY(r2.trace == true);
 }
 
+QUARK_TEST("", "parse_floyd_command_line()", "floyd bench -fjson mygame.floyd", ""){
+	const auto r = parse_floyd_command_line(string_to_args("floyd bench -fjson mygame.floyd"));
+	const auto& r2 = std::get<command_t::user_benchmarks_t>(r._contents);
+	QUARK_VERIFY(r2.mode == command_t::user_benchmarks_t::mode::run_all);
+	QUARK_VERIFY(r2.source_path == "mygame.floyd");
+	QUARK_VERIFY(r2.format == command_t::user_benchmarks_t::output_format::json);
+}
+
+QUARK_TEST("", "parse_floyd_command_line()", "floyd bench -c old.json new.json", ""){
+	const auto r = parse_floyd_command_line(string_to_args("floyd bench -c old.json new.json"));
+	const auto& r2 = std::get<command_t::user_benchmarks_t>(r._contents);
+	QUARK_VERIFY(r2.mode == command_t::user_benchmarks_t::mode::compare);
+	QUARK_VERIFY(r2.source_path == "old.json");
+	QUARK_VERIFY(r2.optional_benchmark_keys == (std::vector<std::string>{ "new.json" }));
+}
+
 
 
 
@@ -66,7 +66,16 @@ struct command_t {
 		enum class mode {
 			run_all,
 			run_specified,
-			list
+			list,
+
+			//	Diffs two saved JSON reports: source_path is the baseline, optional_benchmark_keys[0] the current.
+			compare
+		};
+
+		enum class output_format {
+			text,
+			json,
+			csv
 		};
 
 		mode mode;
@@ -75,6 +84,7 @@ struct command_t {
 		ebackend backend;
 		compiler_settings_t compiler_settings;
 		bool trace;
+		output_format format;
 	};
 
 	struct hwcaps_t {
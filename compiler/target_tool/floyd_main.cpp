@@ -210,17 +210,25 @@ static int do_compile_command(const command_t& command, const command_t::compile
 	const auto source = read_text_file(source_path);
 	const auto cu = floyd::make_compilation_unit_lib(source, source_path);
 
+	std::vector<phase_time_t> phase_times;
+
 	if(command2.output_type == eoutput_type::parse_tree){
-		const auto parse_tree = parse_program__errors(cu);
-		const auto out = json_to_pretty_string(parse_tree._value);
+		const auto parse_tree = time_phase(phase_times, "parse", [&](){ return parse_program__errors(cu); });
+		const auto out = json_to_pretty_string(parser::parse_tree_to_json(parse_tree));
 		output_result(command2.dest_path, out);
+		if(command2.trace){
+			trace_phase_times(phase_times);
+		}
 		return EXIT_SUCCESS;
 	}
 	if(command2.output_type == eoutput_type::ast){
-		const auto ast = floyd::compile_to_sematic_ast__errors(cu);
+		const auto ast = floyd::compile_to_sematic_ast__errors(cu, phase_times);
 		const auto json = semantic_ast_to_json(ast);
 		const auto out = json_to_pretty_string(json);
 		output_result(command2.dest_path, out);
+		if(command2.trace){
+			trace_phase_times(phase_times);
+		}
 		return EXIT_SUCCESS;
 	}
 	if(command2.output_type == eoutput_type::ir){
@@ -228,10 +236,16 @@ static int do_compile_command(const command_t& command, const command_t::compile
 			throw std::runtime_error("Operation not implemented for byte code interpreter.");
 		}
 		else if(command2.backend == ebackend::llvm){
-			const auto ast = floyd::compile_to_sematic_ast__errors(cu);
+			const auto ast = floyd::compile_to_sematic_ast__errors(cu, phase_times);
 			llvm_instance_t llvm_instance;
-			std::unique_ptr<llvm_ir_program_t> llvm_program = generate_llvm_ir_program(llvm_instance, ast, "", command2.compiler_settings);
-			const auto ir_code = write_ir_file(*llvm_program, llvm_instance.target);
+			std::unique_ptr<llvm_ir_program_t> llvm_program = time_phase(phase_times, "LLVM codegen", [&](){
+				return generate_llvm_ir_program(llvm_instance, ast, "", command2.compiler_settings);
+			});
+			const auto ir_code = time_phase(phase_times, "write IR", [&](){ return write_ir_file(*llvm_program, llvm_instance.target); });
+			if(command2.trace){
+				trace_rc_elision_stats(llvm_program->rc_elision_stats);
+				trace_phase_times(phase_times);
+			}
 			output_result(command2.dest_path, ir_code);
 			return EXIT_SUCCESS;
 		}
@@ -245,10 +259,16 @@ static int do_compile_command(const command_t& command, const command_t::compile
 			throw std::runtime_error("Operation not implemented for byte code interpreter.");
 		}
 		else if(command2.backend == ebackend::llvm){
-			const auto ast = floyd::compile_to_sematic_ast__errors(cu);
+			const auto ast = floyd::compile_to_sematic_ast__errors(cu, phase_times);
 			llvm_instance_t llvm_instance;
-			std::unique_ptr<llvm_ir_program_t> llvm_program = generate_llvm_ir_program(llvm_instance, ast, "", command2.compiler_settings);
-			const auto object_file = write_object_file(*llvm_program, llvm_instance.target);
+			std::unique_ptr<llvm_ir_program_t> llvm_program = time_phase(phase_times, "LLVM codegen", [&](){
+				return generate_llvm_ir_program(llvm_instance, ast, "", command2.compiler_settings);
+			});
+			const auto object_file = time_phase(phase_times, "write object file", [&](){ return write_object_file(*llvm_program, llvm_instance.target); });
+			if(command2.trace){
+				trace_rc_elision_stats(llvm_program->rc_elision_stats);
+				trace_phase_times(phase_times);
+			}
 	
 
 			const auto path = command2.dest_path == "" ? (base_path + "out.o") : command2.dest_path;
@@ -307,12 +327,25 @@ static int do_run(const command_t& command, const command_t::compile_and_run_t&
 
 //??? Only compile once!
 
-static std::string do_user_benchmarks_run_all(const std::string& program_source, const std::string& source_path, const compiler_settings_t& compiler_settings){
+//	Bytecode backend: compiles once, runs global code and then the benchmark-defs, all or the specified ones.
+static std::vector<benchmark_result2_t> run_user_benchmarks_bc(const std::string& program_source, const std::string& source_path, const std::vector<std::string>& tests, bool all){
+	const auto cu = floyd::make_compilation_unit_lib(program_source, source_path);
+	auto program = floyd::compile_to_bytecode(cu);
+	auto interpreter = floyd::interpreter_t(program);
+
+	const auto b = collect_benchmarks_bc(interpreter);
+	const auto b2 = all ? mapf<std::string>(b, [](const benchmark_id_t& e){ return e.test; }) : tests;
+	return run_benchmarks_bc(interpreter, b2);
+}
+
+static std::vector<benchmark_result2_t> do_user_benchmarks_run_all(const std::string& program_source, const std::string& source_path, ebackend backend, const compiler_settings_t& compiler_settings){
+	if(backend == ebackend::bytecode){
+		return run_user_benchmarks_bc(program_source, source_path, {}, true);
+	}
+
 	const auto b = collect_benchmarks(program_source, source_path, compilation_unit_mode::k_include_core_lib, compiler_settings);
 	const auto b2 = mapf<std::string>(b, [](const bench_t& e){ return e.benchmark_id.test; });
-	const auto results = run_benchmarks(program_source, source_path, compilation_unit_mode::k_include_core_lib, compiler_settings, b2);
-
-	return make_benchmark_report(results);
+	return run_benchmarks(program_source, source_path, compilation_unit_mode::k_include_core_lib, compiler_settings, b2);
 }
 
 QUARK_TEST("", "do_user_benchmarks_run_all()", "", ""){
@@ -338,7 +371,7 @@ QUARK_TEST("", "do_user_benchmarks_run_all()", "", ""){
 
 	)";
 
-	const auto result = do_user_benchmarks_run_all(program_source, "", make_default_compiler_settings());
+	const auto result = make_benchmark_report(do_user_benchmarks_run_all(program_source, "", ebackend::llvm, make_default_compiler_settings()));
 	std::cout << result;
 
 	std::stringstream expected;
@@ -359,13 +392,15 @@ QUARK_TEST("", "do_user_benchmarks_run_all()", "", ""){
 ////////////////////////////////	do_user_benchmarks_run_specified()
 
 
-static std::string do_user_benchmarks_run_specified(const std::string& program_source, const std::string& source_path, const compiler_settings_t& compiler_settings, const std::vector<std::string>& tests){
+static std::vector<benchmark_result2_t> do_user_benchmarks_run_specified(const std::string& program_source, const std::string& source_path, ebackend backend, const compiler_settings_t& compiler_settings, const std::vector<std::string>& tests){
+	if(backend == ebackend::bytecode){
+		return run_user_benchmarks_bc(program_source, source_path, tests, false);
+	}
+
 	const auto b = collect_benchmarks(program_source, source_path, compilation_unit_mode::k_include_core_lib, compiler_settings);
 	const auto c = filter_benchmarks(b, tests);
 	const auto b2 = mapf<std::string>(c, [](const bench_t& e){ return e.benchmark_id.test; });
-	const auto results = run_benchmarks(program_source, source_path, compilation_unit_mode::k_include_core_lib, compiler_settings, b2);
-
-	return make_benchmark_report(results);
+	return run_benchmarks(program_source, source_path, compilation_unit_mode::k_include_core_lib, compiler_settings, b2);
 }
 
 /*
@@ -392,7 +427,7 @@ QUARK_TEST("", "do_user_benchmarks_run_specified()", "", ""){
 
 	)";
 
-	const auto result = do_user_benchmarks_run_specified(program_source, "", { "abc", "def", "g" });
+	const auto result = do_user_benchmarks_run_specified(program_source, "", ebackend::llvm, make_default_compiler_settings(), { "abc", "def", "g" });
 
 	QUARK_VERIFY(result.size() == 5);
 	QUARK_VERIFY(result[0] == (benchmark_result2_t { benchmark_id_t{ "", "abc" }, benchmark_result_t { 200, json_t("0 elements") } }));
@@ -404,14 +439,25 @@ QUARK_TEST("", "do_user_benchmarks_run_specified()", "", ""){
 */
 
 
-static std::string do_user_benchmarks_list(const std::string& program_source, const std::string& source_path){
-	const auto b = collect_benchmarks(program_source, source_path, compilation_unit_mode::k_include_core_lib, make_default_compiler_settings());
+static std::string do_user_benchmarks_list(const std::string& program_source, const std::string& source_path, ebackend backend){
+	const auto b = [&](){
+		if(backend == ebackend::bytecode){
+			const auto cu = floyd::make_compilation_unit_lib(program_source, source_path);
+			auto program = floyd::compile_to_bytecode(cu);
+			auto interpreter = floyd::interpreter_t(program);
+			return collect_benchmarks_bc(interpreter);
+		}
+		else{
+			const auto b2 = collect_benchmarks(program_source, source_path, compilation_unit_mode::k_include_core_lib, make_default_compiler_settings());
+			return mapf<benchmark_id_t>(b2, [](const bench_t& e){ return e.benchmark_id; });
+		}
+	}();
 
 	std::stringstream ss;
 
 	ss << "Benchmarks registry:" << std::endl;
 	for(const auto& e: b){
-		ss << e.benchmark_id.test << std::endl;
+		ss << e.test << std::endl;
 	}
 	return ss.str();
 }
@@ -435,7 +481,7 @@ QUARK_TEST("", "do_user_benchmarks_list()", "", ""){
 
 	)";
 
-	const auto result = do_user_benchmarks_list(program_source, "module1");
+	const auto result = do_user_benchmarks_list(program_source, "module1", ebackend::llvm);
 	std::cout << result;
 }
 
@@ -459,58 +505,91 @@ QUARK_TEST("", "do_user_benchmarks_list()", "", ""){
 
 	)";
 
-	const auto result = do_user_benchmarks_list(program_source, "module1");
+	const auto result = do_user_benchmarks_list(program_source, "module1", ebackend::llvm);
 	std::cout << result;
 //	ut_verify(QUARK_POS, result, "\"\": \"abc\"\n\"\": \"def\"\n\"\": \"g\"\n");
 	ut_verify(QUARK_POS, result, "Benchmarks registry:\n" "abc\n" "def\n" "g\n");
 }
 
+QUARK_TEST("", "do_user_benchmarks_list()", "bytecode", ""){
+	g_trace_on = true;
+	const auto program_source =
+	R"(
 
+		benchmark-def "abc" {
+			return [ benchmark_result_t(200, json("0 elements")) ]
+		}
 
+		benchmark-def "def" {
+			return [ benchmark_result_t(benchmark { let a = [ 1, 2, 3 ] }, json("3 elements")) ]
+		}
 
+	)";
 
-static int do_user_benchmarks(const command_t& command, const command_t::user_benchmarks_t& command2){
-	g_trace_on = command2.trace;
+	const auto result = do_user_benchmarks_list(program_source, "module1", ebackend::bytecode);
+	ut_verify(QUARK_POS, result, "Benchmarks registry:\n" "abc\n" "def\n");
+}
 
-	if(command2.backend != ebackend::llvm){
-		throw std::runtime_error("Command requires LLVM backend.");
-	}
 
-	const auto program_source = read_text_file(command2.source_path);
 
-	if(command2.mode == command_t::user_benchmarks_t::mode::run_all){
+
+
+static void output_benchmark_results(const std::vector<benchmark_result2_t>& results, command_t::user_benchmarks_t::output_format format){
+	if(format == command_t::user_benchmarks_t::output_format::json){
+		std::cout << make_benchmark_report_json(results, corelib_detect_hardware_caps());
+	}
+	else if(format == command_t::user_benchmarks_t::output_format::csv){
+		std::cout << make_benchmark_report_csv(results);
+	}
+	else{
 		if(DEBUG){
 			std::cout << "DEBUG build: WARNING: benchmarking a debug build" << std::endl;
 		}
 		else{
 			std::cout << "RELEASE build" << std::endl;
 		}
-
-		const auto s = do_user_benchmarks_run_all(program_source, command2.source_path, command2.compiler_settings);
 		std::cout << get_current_date_and_time_string() << std::endl;
 		std::cout << corelib_make_hardware_caps_report_brief(corelib_detect_hardware_caps()) << std::endl;
-		std::cout << s;
+		std::cout << make_benchmark_report(results);
+	}
+}
+
+//	Regressions larger than this, that are also statistically significant, fail the compare.
+static const double k_benchmark_regression_threshold = 0.05;
+
+static int do_user_benchmarks(const command_t& command, const command_t::user_benchmarks_t& command2){
+	g_trace_on = command2.trace;
+
+	const auto program_source = read_text_file(command2.source_path);
+
+	if(command2.mode == command_t::user_benchmarks_t::mode::run_all){
+		const auto results = do_user_benchmarks_run_all(program_source, command2.source_path, command2.backend, command2.compiler_settings);
+		output_benchmark_results(results, command2.format);
 		return EXIT_SUCCESS;
 	}
 	else if(command2.mode == command_t::user_benchmarks_t::mode::run_specified){
-		if(DEBUG){
-			std::cout << "DEBUG build: WARNING: benchmarking a debug build" << std::endl;
-		}
-		else{
-			std::cout << "RELEASE build" << std::endl;
-		}
-
-		const auto s = do_user_benchmarks_run_specified(program_source, command2.source_path, command2.compiler_settings, command2.optional_benchmark_keys);
-		std::cout << get_current_date_and_time_string() << std::endl;
-		std::cout << corelib_make_hardware_caps_report_brief(corelib_detect_hardware_caps()) << std::endl;
-		std::cout << s;
+		const auto results = do_user_benchmarks_run_specified(program_source, command2.source_path, command2.backend, command2.compiler_settings, command2.optional_benchmark_keys);
+		output_benchmark_results(results, command2.format);
 		return EXIT_SUCCESS;
 	}
 	else if(command2.mode == command_t::user_benchmarks_t::mode::list){
-		const auto s = do_user_benchmarks_list(program_source, command2.source_path);
+		const auto s = do_user_benchmarks_list(program_source, command2.source_path, command2.backend);
 		std::cout << s;
 		return EXIT_SUCCESS;
 	}
+	else if(command2.mode == command_t::user_benchmarks_t::mode::compare){
+		QUARK_ASSERT(command2.optional_benchmark_keys.size() == 1);
+
+		const auto baseline = parse_benchmark_report_json(program_source);
+		const auto current = parse_benchmark_report_json(read_text_file(command2.optional_benchmark_keys[0]));
+		const auto r = compare_benchmark_results(baseline, current, k_benchmark_regression_threshold);
+		std::cout << r.report;
+		if(r.regression_count > 0){
+			std::cout << r.regression_count << " significant regression(s)" << std::endl;
+			return EXIT_FAILURE;
+		}
+		return EXIT_SUCCESS;
+	}
 	else{
 		QUARK_ASSERT(false);
 	}